@@ -0,0 +1,77 @@
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+ * Application specific definitions.
+ *
+ * These definitions should be adjusted for your particular hardware and
+ * application requirements.
+ *
+ * THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+ * FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE. 
+ *
+ * The values below mirror those used by the PIC32 build of the Microchip demo
+ * so the scheduling behaviour observed on the host is representative.
+ *----------------------------------------------------------*/
+
+#define configUSE_PREEMPTION			1
+#define configUSE_IDLE_HOOK				0
+#define configUSE_TICK_HOOK				1
+#define configTICK_RATE_HZ				( ( portTickType ) 200 )
+#define configCPU_CLOCK_HZ				( 80000000UL )
+#define configUSE_16_BIT_TICKS			0
+#define configMINIMAL_STACK_SIZE		( 240 )
+#ifndef configMAX_PRIORITIES
+	#define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 6 )
+#endif
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 128 * 1024 ) )
+#define configMAX_TASK_NAME_LEN			( 8 )
+#define configUSE_TRACE_FACILITY		0
+#define configIDLE_SHOULD_YIELD			1
+#define configUSE_MUTEXES				1
+#define configUSE_TASK_NOTIFICATIONS	1
+#define configCHECK_FOR_STACK_OVERFLOW	2
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* Binary trace recorder definitions.  The run time stats counter counts
+microseconds. */
+#define configUSE_TRACE_RECORDER		1
+#define configTRACE_TIMESTAMP_HZ		( 1000000UL )
+#define configTRACE_BUFFER_RECORDS		( 16384 )
+#define configQUEUE_REGISTRY_SIZE		( 8 )
+
+/* The bitmap based task selection is chosen from the Makefile with
+SELECTION=1, and the number of priorities with PRIORITIES=N. */
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION	0
+#endif
+
+/* Tickless idle is selected from the Makefile with TICKLESS=1. */
+#ifndef configUSE_TICKLESS_IDLE
+	#define configUSE_TICKLESS_IDLE		0
+#endif
+
+/* Software timer definitions. */
+#define configUSE_TIMERS				1
+#define configTIMER_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH		( 5 )
+#define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE )
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES 		0
+#define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+
+#define INCLUDE_vTaskPrioritySet				1
+#define INCLUDE_uxTaskPriorityGet				0
+#define INCLUDE_vTaskDelete						0
+#define INCLUDE_vTaskCleanUpResources			0
+#define INCLUDE_vTaskSuspend					1
+#define INCLUDE_vTaskDelayUntil					0
+#define INCLUDE_vTaskDelay						1
+#define INCLUDE_uxTaskGetStackHighWaterMark		1
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,1558 @@
+
+/*
+ * Host build of the Microchip/FreeRTOS demo, for use with the GCC/Linux port.
+ *
+ * The application tasks in src/ drive PIC peripherals directly so cannot be
+ * linked on a PC.  Instead this file recreates the same task graph - the same
+ * task names, priorities, queue depths, message sizes and synchronisation
+ * objects as MainDemo.c - with each task doing a token amount of work in place
+ * of touching the hardware.  The interrupts that feed the real tasks are
+ * simulated from the tick hook, which runs in the tick signal handler.
+ *
+ * This allows kernel changes to be exercised and timed without a target:
+ *
+ *		make run ARGS=10
+ *
+ * runs the demo for ten seconds then ends the scheduler and prints how many
+ * times each task did its work.
+ *
+ * "UART" task - blocks on the receive stream buffer that is written to, one
+ * character at a time, by the simulated receive interrupt.  The task is only
+ * woken once mainUART_RX_TRIGGER characters have arrived, or when
+ * mainUART_RX_TIMEOUT passes with fewer waiting, so the number of wake ups per
+ * kilobyte received is printed alongside the character count.
+ *
+ * "METER" task - blocks on the meter queue that the "TEMP" software timer
+ * posts to every two seconds, exactly as the timer in MainDemo.c does.
+ *
+ * "MIWI" task - waits for a notification from the simulated radio
+ * interrupt.
+ *
+ * "TOUCH" task - periodically samples the "touch screen" and forwards the
+ * result to the graphics task.
+ *
+ * "GRAPH" task - the gatekeeper for the "display".  Receives messages from the
+ * QVGA queue and draws them while holding the QVGA mutex.
+ *
+ * "TCPIP" task - polls the "stack" every 50ms, holding the SPI2 mutex while
+ * it does so as the flash and the Ethernet controller share the bus.
+ *
+ * "CTRL" task - sleeps for the requested run time, takes a snapshot of the run
+ * time statistics, then ends the scheduler.  The share of the CPU used by each
+ * task is printed on exit.
+ *
+ * Two further software timers check that timers expire on time while the
+ * tasks above are loading the system.  The auto-reload "CHECK" timer expects
+ * to run every mainCHECK_TIMER_PERIOD ticks, and the one-shot "ISR" timer is
+ * restarted from the tick hook and expects to run mainISR_TIMER_PERIOD ticks
+ * later.  The demo exits with a failure status if either is ever late by
+ * more than mainTIMER_MAX_LATENESS ticks.
+ *
+ * The binary trace recorder runs throughout.  If a file name is given after
+ * the run time the CTRL task stops the recorder just before ending the
+ * scheduler, and the buffer is written to the file for tracedecode:
+ *
+ *		./RTOSDemo 3 trace.bin
+ *
+ * Building with "make TICKLESS=1" selects the tickless idle mode.  The tick
+ * hook then only runs on the ticks that are actually generated, so the
+ * simulated interrupts are clocked by the real tick interrupts rather than by
+ * the tick count.
+ *
+ * "./RTOSDemo bench" creates none of the tasks above.  A single "BENCH" task
+ * times the kernel instead and prints the results:
+ *
+ *		switch - two tasks of equal priority taskYIELD() to each other.
+ *		queue  - a task sends four byte items through a queue to a task of
+ *				 equal priority.
+ *		tick   - the tick interrupt is raised back to back, with the tick hook
+ *				 doing nothing, so its cost is the kernel's and the port's.
+ *		priority - a task just below BENCH suspends itself and a task at
+ *				 priority one resumes it.  Each suspension has the scheduler
+ *				 find the next task across the priorities in between, which
+ *				 the scan in vTaskSwitchContext() walks one by one and the
+ *				 bitmap of configUSE_PORT_OPTIMISED_TASK_SELECTION does not.
+ *				 "make bench-priorities" runs it for several values of
+ *				 configMAX_PRIORITIES, with and without the bitmap.  The
+ *				 time vTaskSwitchContext() takes is also given on its own,
+ *				 as the port's switch costs far more than the search.
+ *		notify - a task gives to a task of higher priority, which takes and
+ *				 blocks again, first with a direct to task notification and
+ *				 then with a binary semaphore.
+ *		reference - as queue, for items of 4 to 256 bytes, first copied into
+ *				 and out of the queue and then passed by reference, as
+ *				 pointers to blocks from a pool, then times taking a block
+ *				 from a pool and releasing it on its own.  A pool links its
+ *				 free blocks through the blocks themselves, so taking or
+ *				 releasing one is a critical section rather than a queue
+ *				 operation.  On this port a critical section is two
+ *				 sigprocmask() calls, which cost more than copying even
+ *				 1 KB, so passing by reference only pays where a critical
+ *				 section is cheap next to the copy.
+ *
+ * Naming benchmarks after "bench" runs only those, as in "./RTOSDemo bench
+ * tick".  "make bench" builds the demo and runs them all.
+ *
+ * "./RTOSDemo replay [tracefile]" replays a trace of allocations and frees
+ * against the heap the demo was linked with, then prints the time taken by
+ * pvPortMalloc() and vPortFree(), how many allocations failed, and how much of
+ * the free space lay outside the largest free block, as vPortGetHeapStats()
+ * reports it.  Each line of a trace is "a <block> <size>" or "f <block>",
+ * with blocks numbered from 0 to 4095.  Without a trace a fixed pseudo random
+ * one is used, mixing message sized blocks with packet buffers and the odd
+ * task stack.  "make replay" runs it with heap_2 and with heap_4, and
+ * "make replay TRACE=file" replays a recorded trace instead.
+ */
+
+/* Standard includes. */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "stream_buffer.h"
+#include "pool.h"
+
+/* Task priorities, as used by MainDemo.c. */
+#define mainUART_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define mainMETER_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define mainMIWI_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define mainTCPIP_PRIORITY				( tskIDLE_PRIORITY + 2 )
+#define mainGRAPH_PRIORITY				( tskIDLE_PRIORITY + 3 )
+#define mainTOUCH_PRIORITY				( tskIDLE_PRIORITY + 4 )
+#define mainCTRL_PRIORITY				( configMAX_PRIORITIES - 1 )
+
+/* Stack sizes.  The tasks actually run on host stacks of portHOST_STACK_SIZE
+bytes, so these only have to satisfy the kernel. */
+#define mainTASK_STACK_SIZE				( configMINIMAL_STACK_SIZE )
+
+/* Queue depths and message sizes, as used by the application tasks. */
+#define mainUART_RX_BUFFER_SIZE			( 64 )
+#define mainUART_RX_TRIGGER				( 8 )
+#define mainMETER_QUEUE_SIZE			( 4 )
+#define mainQVGA_QUEUE_SIZE				( 6 )
+#define mainMETER_MSG_SIZE				( 24 )
+#define mainGRAPHICS_MSG_SIZE			( 20 )
+
+/* How often the simulated interrupts fire, in ticks. */
+#define mainUART_RX_RATE				( ( portTickType ) 1 )
+#define mainMIWI_RX_RATE				( ( portTickType ) 20 )
+#define mainMETER_RATE					( ( portTickType ) 2000 / portTICK_RATE_MS )
+
+/* The timer accuracy check.  The periods are chosen not to be multiples of
+the other periods in the demo. */
+#define mainCHECK_TIMER_PERIOD			( ( portTickType ) 7 )
+#define mainISR_TIMER_PERIOD			( ( portTickType ) 13 )
+#define mainISR_TIMER_RATE				( ( portTickType ) 100 )
+#define mainTIMER_MAX_LATENESS			( ( portTickType ) 1 )
+
+/* Periods of the tasks that poll. */
+#define mainTOUCH_PERIOD				( ( portTickType ) 20 / portTICK_RATE_MS )
+#define mainTCPIP_PERIOD				( ( portTickType ) 50 / portTICK_RATE_MS )
+#define mainMIWI_BLOCK_TIME				( ( portTickType ) 1000 / portTICK_RATE_MS )
+#define mainUART_RX_TIMEOUT				( ( portTickType ) 100 / portTICK_RATE_MS )
+
+/* The most tasks the run time statistics snapshot can hold.  The demo
+creates nine, including the idle and timer tasks. */
+#define mainMAX_TASKS					( 12 )
+
+/* The run time used when none is given on the command line, in seconds. */
+#define mainDEFAULT_RUN_TIME			( 10 )
+
+/* The benchmarks.  The BENCH task runs above the tasks it times, so it only
+runs again once they have all finished. */
+#define mainBENCH_PRIORITY				( configMAX_PRIORITIES - 1 )
+#define mainBENCH_WORKER_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define mainBENCH_SWITCHES				( 200000UL )
+#define mainBENCH_ITEMS					( 200000UL )
+#define mainBENCH_QUEUE_LENGTH			( 8 )
+#define mainBENCH_ITEM_SIZE				( 4 )
+#define mainBENCH_MAX_ITEM_SIZE			( 256 )
+#define mainBENCH_TICKS					( 100000UL )
+
+/* The heap replay.  The generated trace keeps up to mainREPLAY_LIVE_BLOCKS
+blocks allocated at once.  The fragmentation is measured every
+mainREPLAY_PROBE_INTERVAL operations, outside of the timing. */
+#define mainREPLAY_BLOCKS				( 4096 )
+#define mainREPLAY_OPERATIONS			( 200000UL )
+#define mainREPLAY_LIVE_BLOCKS			( 96 )
+#define mainREPLAY_PROBE_INTERVAL		( 100UL )
+
+/* One operation of a heap trace. */
+typedef struct
+{
+	char cOperation;				/* 'a' to allocate or 'f' to free. */
+	unsigned portSHORT usBlock;
+	size_t xSize;
+} xHeapOperation;
+
+/* Stand-ins for the message structures in homeMeter.h and taskGraphics.h. */
+typedef struct
+{
+	unsigned portCHAR ucData[ mainMETER_MSG_SIZE ];
+} xMeterMessage;
+
+typedef struct
+{
+	unsigned portSHORT usCommand;
+	unsigned portCHAR ucData[ mainGRAPHICS_MSG_SIZE - sizeof( unsigned portSHORT ) ];
+} xGraphicsMessage;
+
+/* The commands understood by the GRAPH task. */
+#define mainCMD_TOUCH					( 1 )
+#define mainCMD_METER					( 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks as described at the top of this file.
+ */
+static void prvUARTTask( void *pvParameters );
+static void prvMeterTask( void *pvParameters );
+static void prvMiWiTask( void *pvParameters );
+static void prvTouchTask( void *pvParameters );
+static void prvGraphicsTask( void *pvParameters );
+static void prvTCPIPTask( void *pvParameters );
+static void prvControlTask( void *pvParameters );
+
+/*
+ * The BENCH task, and the tasks it times, as described at the top of this
+ * file.
+ */
+static void prvBenchTask( void *pvParameters );
+static void prvYieldTask( void *pvParameters );
+static void prvQueueSendTask( void *pvParameters );
+static void prvQueueReceiveTask( void *pvParameters );
+static void prvSuspendTask( void *pvParameters );
+static void prvResumeTask( void *pvParameters );
+static void prvGiveTask( void *pvParameters );
+static void prvTakeTask( void *pvParameters );
+
+/*
+ * The benchmarks run by the BENCH task.  Each prints its result and returns
+ * pdFAIL if it could not run.
+ */
+static portBASE_TYPE prvBenchSwitch( void );
+static portBASE_TYPE prvBenchQueue( void );
+static portBASE_TYPE prvBenchTick( void );
+static portBASE_TYPE prvBenchPriority( void );
+static portBASE_TYPE prvBenchNotify( void );
+static portBASE_TYPE prvBenchReference( void );
+
+/*
+ * Time mainBENCH_ITEMS items of uxItemSize bytes sent between the QSEND and
+ * QRECV tasks, copied if xPool is NULL or else as pointers to blocks from
+ * xPool.  Returns the time in nanoseconds, or zero if the queue or the tasks
+ * could not be created.
+ */
+static unsigned long long prvTimeQueue( unsigned portBASE_TYPE uxItemSize, xPoolHandle xPool );
+
+/*
+ * Time mainBENCH_SWITCHES give and take round trips between the GIVE and TAKE
+ * tasks, through xSemaphore or through a notification if it is NULL.  Returns
+ * the time in nanoseconds, or zero if the tasks could not be created.
+ */
+static unsigned long long prvTimeGiveTake( xSemaphoreHandle xSemaphore );
+
+/*
+ * Tell the BENCH task a timed task has finished, then stop.
+ */
+static void prvBenchTaskDone( void );
+
+/*
+ * Stands in for vTaskSwitchContext() when the port calls it, timing the calls
+ * made during the priority benchmark.
+ */
+void __wrap_vTaskSwitchContext( void );
+
+/*
+ * Replay the named heap trace, or a generated one if pcTraceFile is NULL, and
+ * print the results.  Returns the program's exit status.
+ */
+static int prvReplayHeap( const char *pcTraceFile );
+
+/*
+ * Read a heap trace, or generate one, into memory from the host's heap.
+ * Return NULL if the trace could not be read.
+ */
+static xHeapOperation *prvReadHeapTrace( const char *pcTraceFile, unsigned long *pulOperations );
+static xHeapOperation *prvGenerateHeapTrace( unsigned long *pulOperations );
+
+/*
+ * The host's monotonic clock, in nanoseconds.
+ */
+static unsigned long long prvNanoseconds( void );
+
+/*
+ * The software timer callbacks.
+ */
+static void prvMeterTimerCallback( xTimerHandle xTimer );
+static void prvCheckTimerCallback( xTimerHandle xTimer );
+static void prvISRTimerCallback( xTimerHandle xTimer );
+
+/*
+ * Record how late a timer callback ran compared to the expected tick.
+ */
+static void prvRecordTimerLateness( portTickType xExpected );
+
+/*
+ * Print the CPU load of each task recorded by the CTRL task.
+ */
+static void prvPrintRunTimeStats( void );
+
+/*
+ * Write the trace buffer to pcTraceFile.
+ */
+static void prvWriteTrace( void );
+
+/*
+ * Burn some time to represent the work done by a task.
+ */
+static void prvDoWork( unsigned portLONG ulIterations );
+
+/*-----------------------------------------------------------*/
+
+/* The communication objects, named as in the application. */
+static xStreamBufferHandle hUARTRxStream;
+static xQueueHandle hMETERQueue;
+static xQueueHandle hQVGAQueue;
+static xTaskHandle hMIWITask;
+static xSemaphoreHandle SPI2Semaphore;
+static xSemaphoreHandle QVGASemaphore;
+static xTimerHandle hISRTimer;
+
+/* How many times each task has done its work. */
+static volatile unsigned portLONG ulUARTCount = 0UL;
+static volatile unsigned portLONG ulUARTWakeups = 0UL;
+static volatile unsigned portLONG ulMeterCount = 0UL;
+static volatile unsigned portLONG ulMiWiCount = 0UL;
+static volatile unsigned portLONG ulMiWiTimeouts = 0UL;
+static volatile unsigned portLONG ulTouchCount = 0UL;
+static volatile unsigned portLONG ulGraphicsCount = 0UL;
+static volatile unsigned portLONG ulTCPIPCount = 0UL;
+
+/* Items the simulated interrupts could not post because a queue or buffer was
+full. */
+static volatile unsigned portLONG ulISROverruns = 0UL;
+
+/* How many tick interrupts actually occurred.  Fewer than the number of ticks
+the scheduler ran for when configUSE_TICKLESS_IDLE is set and the processor
+was able to sleep. */
+static volatile unsigned portLONG ulTickInterrupts = 0UL;
+
+/* The timer accuracy check results. */
+static volatile unsigned portLONG ulTimerCount = 0UL;
+static volatile portTickType xTimerMaxLateness = 0;
+
+/* The tick at which the "ISR" timer was last started from the tick hook. */
+static volatile portTickType xISRTimerStartTime = 0;
+
+/* The number of ticks the scheduler is to run for. */
+static portTickType xRunTime;
+
+/* The file the trace is written to, if any. */
+static const char *pcTraceFile = NULL;
+
+/* The run time statistics, captured just before the scheduler is ended. */
+static xTaskRunTimeStatus xRunTimeStats[ mainMAX_TASKS ];
+static unsigned portBASE_TYPE uxRunTimeStatsCount = 0;
+static unsigned long long ullTotalRunTime = 0ULL;
+
+/* The benchmarks, by the names given on the command line. */
+typedef struct
+{
+	const char *pcName;
+	portBASE_TYPE ( *pxFunction )( void );
+} xBenchmark;
+
+static const xBenchmark xBenchmarks[] =
+{
+	{ "switch", prvBenchSwitch },
+	{ "queue", prvBenchQueue },
+	{ "tick", prvBenchTick },
+	{ "priority", prvBenchPriority },
+	{ "notify", prvBenchNotify },
+	{ "reference", prvBenchReference }
+};
+
+#define mainBENCHMARKS					( sizeof( xBenchmarks ) / sizeof( xBenchmarks[ 0 ] ) )
+
+/* Set when "bench" is given, in place of the run time. */
+static portBASE_TYPE xRunBenchmarks = pdFALSE;
+
+/* The benchmarks named after "bench", or all of them if none were. */
+static char **ppcBenchNames = NULL;
+static int iBenchNames = 0;
+
+/* The BENCH task, which the timed tasks notify as they finish. */
+static xTaskHandle hBenchTask;
+
+/* Set while the priority benchmark times vTaskSwitchContext(), and the time
+and number of the calls it timed. */
+static volatile portBASE_TYPE xTimeSelection = pdFALSE;
+static unsigned long long ullSelectionTime;
+static unsigned long ulSelections;
+
+/* The semaphore the GIVE and TAKE tasks use, or NULL while they use
+notifications, and the TAKE task they notify. */
+static xSemaphoreHandle xGiveTakeSemaphore = NULL;
+static xTaskHandle hTakeTask;
+
+/* The size of the items the QSEND and QRECV tasks pass, and the pool the
+items come from when they are passed by reference or NULL when they are
+copied. */
+static unsigned portBASE_TYPE uxBenchItemSize;
+static xPoolHandle xBenchPool = NULL;
+
+/* Cleared by a benchmark that could not run. */
+static portBASE_TYPE xBenchResult = pdPASS;
+
+/* The blocks allocated by the heap replay, by number. */
+static void *pvReplayBlocks[ mainREPLAY_BLOCKS ];
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+long lSeconds = mainDEFAULT_RUN_TIME;
+portTickType xStartTime;
+xTimerHandle hMeterTimer, hCheckTimer;
+
+	if( ( argc > 1 ) && ( strcmp( argv[ 1 ], "bench" ) == 0 ) )
+	{
+		xRunBenchmarks = pdTRUE;
+		ppcBenchNames = &argv[ 2 ];
+		iBenchNames = argc - 2;
+
+		xTaskCreate( prvBenchTask, ( signed portCHAR * ) "BENCH", mainTASK_STACK_SIZE, NULL, mainBENCH_PRIORITY, &hBenchTask );
+		vTaskStartScheduler();
+
+		return ( xBenchResult == pdPASS ) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/* The heap can be used before the scheduler is started, so the replay
+	needs no tasks. */
+	if( ( argc > 1 ) && ( strcmp( argv[ 1 ], "replay" ) == 0 ) )
+	{
+		return prvReplayHeap( ( argc > 2 ) ? argv[ 2 ] : NULL );
+	}
+
+	if( argc > 1 )
+	{
+		lSeconds = strtol( argv[ 1 ], NULL, 10 );
+		if( lSeconds <= 0 )
+		{
+			fprintf( stderr, "usage: %s [seconds [tracefile]] | bench [name ...] | replay [tracefile]\n", argv[ 0 ] );
+			return EXIT_FAILURE;
+		}
+	}
+	if( argc > 2 )
+	{
+		pcTraceFile = argv[ 2 ];
+	}
+	xRunTime = ( portTickType ) lSeconds * configTICK_RATE_HZ;
+
+	hUARTRxStream = xStreamBufferCreate( mainUART_RX_BUFFER_SIZE, mainUART_RX_TRIGGER );
+	hMETERQueue = xQueueCreate( mainMETER_QUEUE_SIZE, sizeof( xMeterMessage ) );
+	hQVGAQueue = xQueueCreate( mainQVGA_QUEUE_SIZE, sizeof( xGraphicsMessage ) );
+	SPI2Semaphore = xSemaphoreCreateMutex();
+	QVGASemaphore = xSemaphoreCreateMutex();
+	hMeterTimer = xTimerCreate( ( signed portCHAR * ) "TEMP", mainMETER_RATE, pdTRUE, NULL, prvMeterTimerCallback );
+	hCheckTimer = xTimerCreate( ( signed portCHAR * ) "CHECK", mainCHECK_TIMER_PERIOD, pdTRUE, NULL, prvCheckTimerCallback );
+	hISRTimer = xTimerCreate( ( signed portCHAR * ) "ISR", mainISR_TIMER_PERIOD, pdFALSE, NULL, prvISRTimerCallback );
+
+	if( ( hUARTRxStream == NULL ) || ( hMETERQueue == NULL ) || ( hQVGAQueue == NULL ) ||
+		( SPI2Semaphore == NULL ) || ( QVGASemaphore == NULL ) ||
+		( hMeterTimer == NULL ) || ( hCheckTimer == NULL ) || ( hISRTimer == NULL ) )
+	{
+		fprintf( stderr, "Could not create the queues, semaphores and timers.\n" );
+		return EXIT_FAILURE;
+	}
+
+	/* Name the objects in the trace. */
+	vQueueAddToRegistry( hMETERQueue, ( signed portCHAR * ) "METER" );
+	vQueueAddToRegistry( hQVGAQueue, ( signed portCHAR * ) "QVGA" );
+	vQueueAddToRegistry( SPI2Semaphore, ( signed portCHAR * ) "SPI2" );
+	vQueueAddToRegistry( QVGASemaphore, ( signed portCHAR * ) "QVGAMtx" );
+
+	/* The timers start running when the scheduler starts. */
+	xTimerStart( hMeterTimer, 0 );
+	xTimerStart( hCheckTimer, 0 );
+
+	xTaskCreate( prvUARTTask, ( signed portCHAR * ) "UART", mainTASK_STACK_SIZE, NULL, mainUART_PRIORITY, NULL );
+	xTaskCreate( prvMeterTask, ( signed portCHAR * ) "METER", mainTASK_STACK_SIZE, NULL, mainMETER_PRIORITY, NULL );
+	xTaskCreate( prvMiWiTask, ( signed portCHAR * ) "MIWI", mainTASK_STACK_SIZE, NULL, mainMIWI_PRIORITY, &hMIWITask );
+	xTaskCreate( prvTouchTask, ( signed portCHAR * ) "TOUCH", mainTASK_STACK_SIZE, NULL, mainTOUCH_PRIORITY, NULL );
+	xTaskCreate( prvGraphicsTask, ( signed portCHAR * ) "GRAPH", mainTASK_STACK_SIZE, NULL, mainGRAPH_PRIORITY, NULL );
+	xTaskCreate( prvTCPIPTask, ( signed portCHAR * ) "TCPIP", mainTASK_STACK_SIZE, NULL, mainTCPIP_PRIORITY, NULL );
+	xTaskCreate( prvControlTask, ( signed portCHAR * ) "CTRL", mainTASK_STACK_SIZE, NULL, mainCTRL_PRIORITY, NULL );
+
+	/* Returns once the CTRL task has ended the scheduler. */
+	xStartTime = xTaskGetTickCount();
+	vTaskStartScheduler();
+
+	printf( "Ran for %lu ticks (%ld s at %lu Hz)\n", ( unsigned long ) ( xTaskGetTickCount() - xStartTime ), lSeconds, ( unsigned long ) configTICK_RATE_HZ );
+	printf( "  UART   %10lu chars, %lu wake ups (%lu per KB)\n", ( unsigned long ) ulUARTCount, ( unsigned long ) ulUARTWakeups,
+			( unsigned long ) ( ( ulUARTCount > 0UL ) ? ( ulUARTWakeups * 1024UL ) / ulUARTCount : 0UL ) );
+	printf( "  METER  %10lu messages\n", ( unsigned long ) ulMeterCount );
+	printf( "  MIWI   %10lu packets, %lu timeouts\n", ( unsigned long ) ulMiWiCount, ( unsigned long ) ulMiWiTimeouts );
+	printf( "  TOUCH  %10lu samples\n", ( unsigned long ) ulTouchCount );
+	printf( "  GRAPH  %10lu redraws\n", ( unsigned long ) ulGraphicsCount );
+	printf( "  TCPIP  %10lu polls\n", ( unsigned long ) ulTCPIPCount );
+	printf( "  ISR    %10lu overruns\n", ( unsigned long ) ulISROverruns );
+	printf( "  TICK   %10lu interrupts\n", ( unsigned long ) ulTickInterrupts );
+	printf( "  TIMER  %10lu expiries, at most %lu ticks late\n", ( unsigned long ) ulTimerCount, ( unsigned long ) xTimerMaxLateness );
+	prvPrintRunTimeStats();
+	prvWriteTrace();
+
+	if( xTimerMaxLateness > mainTIMER_MAX_LATENESS )
+	{
+		fprintf( stderr, "Software timers ran more than %lu ticks late.\n", ( unsigned long ) mainTIMER_MAX_LATENESS );
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUARTTask( void *pvParameters )
+{
+portCHAR cRxBuffer[ mainUART_RX_BUFFER_SIZE ];
+size_t xReceived;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xReceived = xStreamBufferReceive( hUARTRxStream, cRxBuffer, sizeof( cRxBuffer ), mainUART_RX_TIMEOUT );
+		if( xReceived > ( size_t ) 0 )
+		{
+			ulUARTCount += ( unsigned portLONG ) xReceived;
+			ulUARTWakeups++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeterTask( void *pvParameters )
+{
+xMeterMessage xMessage;
+xGraphicsMessage xDisplay;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xQueueReceive( hMETERQueue, &xMessage, portMAX_DELAY ) == pdPASS )
+		{
+			ulMeterCount++;
+
+			/* Pass the reading on to be displayed. */
+			xDisplay.usCommand = mainCMD_METER;
+			memcpy( xDisplay.ucData, xMessage.ucData, sizeof( xDisplay.ucData ) );
+			xQueueSend( hQVGAQueue, &xDisplay, portMAX_DELAY );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMiWiTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( ulTaskNotifyTake( pdTRUE, mainMIWI_BLOCK_TIME ) != 0UL )
+		{
+			/* Process the "packet" while holding the shared SPI bus. */
+			xSemaphoreTake( SPI2Semaphore, portMAX_DELAY );
+			{
+				prvDoWork( 200UL );
+			}
+			xSemaphoreGive( SPI2Semaphore );
+			ulMiWiCount++;
+		}
+		else
+		{
+			ulMiWiTimeouts++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTouchTask( void *pvParameters )
+{
+xGraphicsMessage xMessage;
+
+	( void ) pvParameters;
+
+	memset( &xMessage, 0, sizeof( xMessage ) );
+	xMessage.usCommand = mainCMD_TOUCH;
+
+	for( ;; )
+	{
+		vTaskDelay( mainTOUCH_PERIOD );
+
+		prvDoWork( 100UL );
+		ulTouchCount++;
+		xMessage.ucData[ 0 ] = ( unsigned portCHAR ) ulTouchCount;
+
+		/* Drop the sample rather than hold up the touch screen if the
+		display is falling behind. */
+		xQueueSend( hQVGAQueue, &xMessage, 0 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvGraphicsTask( void *pvParameters )
+{
+xGraphicsMessage xMessage;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xQueueReceive( hQVGAQueue, &xMessage, portMAX_DELAY ) == pdPASS )
+		{
+			xSemaphoreTake( QVGASemaphore, portMAX_DELAY );
+			{
+				prvDoWork( ( xMessage.usCommand == mainCMD_METER ) ? 2000UL : 500UL );
+			}
+			xSemaphoreGive( QVGASemaphore );
+			ulGraphicsCount++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTCPIPTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskDelay( mainTCPIP_PERIOD );
+
+		xSemaphoreTake( SPI2Semaphore, portMAX_DELAY );
+		{
+			prvDoWork( 1000UL );
+		}
+		xSemaphoreGive( SPI2Semaphore );
+		ulTCPIPCount++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	vTaskDelay( xRunTime );
+
+	/* The snapshot must be taken while the scheduler is still running. */
+	uxRunTimeStatsCount = uxTaskGetRunTimeSnapshot( xRunTimeStats, mainMAX_TASKS, &ullTotalRunTime );
+	if( pcTraceFile != NULL )
+	{
+		vTraceStop();
+	}
+	vTaskEndScheduler();
+
+	/* Should not get here. */
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchTask( void *pvParameters )
+{
+unsigned portBASE_TYPE x;
+int iName;
+portBASE_TYPE xFound;
+
+	( void ) pvParameters;
+
+	for( iName = 0; iName < iBenchNames; iName++ )
+	{
+		xFound = pdFALSE;
+		for( x = 0; x < mainBENCHMARKS; x++ )
+		{
+			if( strcmp( ppcBenchNames[ iName ], xBenchmarks[ x ].pcName ) == 0 )
+			{
+				xFound = pdTRUE;
+			}
+		}
+
+		if( xFound == pdFALSE )
+		{
+			fprintf( stderr, "No benchmark named %s\n", ppcBenchNames[ iName ] );
+			xBenchResult = pdFAIL;
+		}
+	}
+
+	if( xBenchResult == pdPASS )
+	{
+		printf( "Benchmarks at %lu Hz with %lu priorities, %s task selection\n", ( unsigned long ) configTICK_RATE_HZ,
+				( unsigned long ) configMAX_PRIORITIES, ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) ? "bitmap" : "scanned" );
+	}
+
+	for( x = 0; ( x < mainBENCHMARKS ) && ( xBenchResult == pdPASS ); x++ )
+	{
+		xFound = ( iBenchNames == 0 ) ? pdTRUE : pdFALSE;
+		for( iName = 0; iName < iBenchNames; iName++ )
+		{
+			if( strcmp( ppcBenchNames[ iName ], xBenchmarks[ x ].pcName ) == 0 )
+			{
+				xFound = pdTRUE;
+			}
+		}
+
+		if( xFound != pdFALSE )
+		{
+			xBenchResult = xBenchmarks[ x ].pxFunction();
+		}
+	}
+
+	vTaskEndScheduler();
+
+	/* Should not get here. */
+	for( ;; )
+	{
+		vTaskDelay( portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchSwitch( void )
+{
+unsigned long long ullStart, ullTime;
+
+	/* Each task yields mainBENCH_SWITCHES times, and every yield switches to
+	the other. */
+	ullStart = prvNanoseconds();
+	if( ( xTaskCreate( prvYieldTask, ( signed portCHAR * ) "YIELD1", mainTASK_STACK_SIZE, NULL, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) ||
+		( xTaskCreate( prvYieldTask, ( signed portCHAR * ) "YIELD2", mainTASK_STACK_SIZE, NULL, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) )
+	{
+		return pdFAIL;
+	}
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ullTime = prvNanoseconds() - ullStart;
+
+	printf( "  SWITCH %10.3f us per taskYIELD() between two tasks\n", ( double ) ullTime / ( 2000.0 * ( double ) mainBENCH_SWITCHES ) );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchQueue( void )
+{
+unsigned long long ullTime;
+
+	ullTime = prvTimeQueue( mainBENCH_ITEM_SIZE, NULL );
+	if( ullTime == 0ULL )
+	{
+		return pdFAIL;
+	}
+
+	printf( "  QUEUE  %10.0f items/s, %.3f us per item sent and received, %u byte items %u deep\n",
+			( double ) mainBENCH_ITEMS * 1e9 / ( double ) ullTime, ( double ) ullTime / ( 1000.0 * ( double ) mainBENCH_ITEMS ),
+			( unsigned ) mainBENCH_ITEM_SIZE, ( unsigned ) mainBENCH_QUEUE_LENGTH );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchReference( void )
+{
+unsigned portBASE_TYPE uxItemSize;
+xPoolHandle xPool;
+xQueueHandle xPointers;
+void *pvBlock;
+unsigned long x;
+unsigned long long ullCopy, ullReference, ullStart, ullPool, ullPointers;
+
+	for( uxItemSize = 4; uxItemSize <= mainBENCH_MAX_ITEM_SIZE; uxItemSize *= 4 )
+	{
+		/* Pools cannot be deleted, so each size has its own.  The sender and
+		the receiver can each hold a block as well as those in the queue. */
+		xPool = xPoolCreate( mainBENCH_QUEUE_LENGTH + 2, uxItemSize );
+		if( xPool == NULL )
+		{
+			return pdFAIL;
+		}
+
+		ullCopy = prvTimeQueue( uxItemSize, NULL );
+		ullReference = prvTimeQueue( uxItemSize, xPool );
+		if( ( ullCopy == 0ULL ) || ( ullReference == 0ULL ) )
+		{
+			return pdFAIL;
+		}
+
+		printf( "  BYREF  %10.0f items/s copied, %.0f items/s by reference, %u byte items\n",
+				( double ) mainBENCH_ITEMS * 1e9 / ( double ) ullCopy, ( double ) mainBENCH_ITEMS * 1e9 / ( double ) ullReference,
+				( unsigned ) uxItemSize );
+	}
+
+	/* The pool on its own, a block taken and released with nothing else
+	running, beside a queue of pointers as the pool used to keep its free
+	blocks in. */
+	xPool = xPoolCreate( 1, mainBENCH_ITEM_SIZE );
+	xPointers = xQueueCreate( 1, sizeof( void * ) );
+	if( ( xPool == NULL ) || ( xPointers == NULL ) )
+	{
+		return pdFAIL;
+	}
+
+	ullStart = prvNanoseconds();
+	for( x = 0; x < mainBENCH_ITEMS; x++ )
+	{
+		pvBlock = pvPoolAllocate( xPool, 0 );
+		vPoolRelease( pvBlock );
+	}
+	ullPool = prvNanoseconds() - ullStart;
+
+	ullStart = prvNanoseconds();
+	for( x = 0; x < mainBENCH_ITEMS; x++ )
+	{
+		xQueueSend( xPointers, &pvBlock, 0 );
+		xQueueReceive( xPointers, &pvBlock, 0 );
+	}
+	ullPointers = prvNanoseconds() - ullStart;
+
+	printf( "  POOL   %10.1f ns per block taken and released, %.1f ns through a queue of pointers\n",
+			( double ) ullPool / ( double ) mainBENCH_ITEMS, ( double ) ullPointers / ( double ) mainBENCH_ITEMS );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long long prvTimeQueue( unsigned portBASE_TYPE uxItemSize, xPoolHandle xPool )
+{
+xQueueHandle xQueue;
+unsigned long long ullStart, ullTime;
+
+	if( xPool == NULL )
+	{
+		xQueue = xQueueCreate( mainBENCH_QUEUE_LENGTH, uxItemSize );
+	}
+	else
+	{
+		xQueue = xQueueCreateByReference( mainBENCH_QUEUE_LENGTH );
+	}
+
+	if( xQueue == NULL )
+	{
+		return 0ULL;
+	}
+
+	uxBenchItemSize = uxItemSize;
+	xBenchPool = xPool;
+	ullStart = prvNanoseconds();
+	if( ( xTaskCreate( prvQueueSendTask, ( signed portCHAR * ) "QSEND", mainTASK_STACK_SIZE, ( void * ) xQueue, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) ||
+		( xTaskCreate( prvQueueReceiveTask, ( signed portCHAR * ) "QRECV", mainTASK_STACK_SIZE, ( void * ) xQueue, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) )
+	{
+		return 0ULL;
+	}
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ullTime = prvNanoseconds() - ullStart;
+
+	vQueueDelete( xQueue );
+
+	return ullTime;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchTick( void )
+{
+unsigned long x;
+unsigned long long ullStart, ullTime;
+double dTickUs;
+
+	/* Each raise() runs the tick handler before it returns, exactly as the
+	interval timer's signal does.  The tick count moves on by
+	mainBENCH_TICKS, which nothing in the benchmarks depends on. */
+	ullStart = prvNanoseconds();
+	for( x = 0; x < mainBENCH_TICKS; x++ )
+	{
+		raise( SIGALRM );
+	}
+	ullTime = prvNanoseconds() - ullStart;
+
+	dTickUs = ( double ) ullTime / ( 1000.0 * ( double ) mainBENCH_TICKS );
+	printf( "  TICK   %10.3f us per tick, %.3f%% of the CPU at %lu Hz\n", dTickUs,
+			dTickUs * ( double ) configTICK_RATE_HZ / 10000.0, ( unsigned long ) configTICK_RATE_HZ );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchPriority( void )
+{
+xTaskHandle hSuspendTask;
+unsigned long x;
+unsigned long long ullStart, ullTime, ullClock;
+
+	ullSelectionTime = 0ULL;
+	ulSelections = 0UL;
+	xTimeSelection = pdTRUE;
+	ullStart = prvNanoseconds();
+	if( ( xTaskCreate( prvSuspendTask, ( signed portCHAR * ) "SUSPEND", mainTASK_STACK_SIZE, NULL, mainBENCH_PRIORITY - 1, &hSuspendTask ) != pdPASS ) ||
+		( xTaskCreate( prvResumeTask, ( signed portCHAR * ) "RESUME", mainTASK_STACK_SIZE, ( void * ) hSuspendTask, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) )
+	{
+		return pdFAIL;
+	}
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ullTime = prvNanoseconds() - ullStart;
+	xTimeSelection = pdFALSE;
+
+	/* Take off the time of reading the clock, which the wrapper does twice
+	for each call. */
+	ullStart = prvNanoseconds();
+	for( x = 0; x < ulSelections; x++ )
+	{
+		( void ) prvNanoseconds();
+	}
+	ullClock = prvNanoseconds() - ullStart;
+	ullSelectionTime = ( ullSelectionTime > ullClock ) ? ullSelectionTime - ullClock : 0ULL;
+
+	printf( "  PRIO   %10.3f us per switch between priorities %lu and %lu, %.1f ns of it selecting the task\n",
+			( double ) ullTime / ( 2000.0 * ( double ) mainBENCH_SWITCHES ), ( unsigned long ) mainBENCH_WORKER_PRIORITY,
+			( unsigned long ) ( mainBENCH_PRIORITY - 1 ), ( double ) ullSelectionTime / ( double ) ulSelections );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvBenchNotify( void )
+{
+xSemaphoreHandle xSemaphore;
+unsigned long long ullNotify, ullSemaphore;
+
+	/* The semaphore is created available, so is taken before it is timed. */
+	vSemaphoreCreateBinary( xSemaphore );
+	if( ( xSemaphore == NULL ) || ( xSemaphoreTake( xSemaphore, 0 ) != pdPASS ) )
+	{
+		return pdFAIL;
+	}
+
+	ullNotify = prvTimeGiveTake( NULL );
+	ullSemaphore = prvTimeGiveTake( xSemaphore );
+	if( ( ullNotify == 0ULL ) || ( ullSemaphore == 0ULL ) )
+	{
+		return pdFAIL;
+	}
+
+	printf( "  NOTIFY %10.3f us per give and take round trip, %.3f us through a binary semaphore\n",
+			( double ) ullNotify / ( 1000.0 * ( double ) mainBENCH_SWITCHES ), ( double ) ullSemaphore / ( 1000.0 * ( double ) mainBENCH_SWITCHES ) );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long long prvTimeGiveTake( xSemaphoreHandle xSemaphore )
+{
+unsigned long long ullStart;
+
+	/* TAKE is created first and, being above GIVE, blocks before GIVE runs.
+	Each give then switches up to TAKE and each take switches back down. */
+	xGiveTakeSemaphore = xSemaphore;
+	ullStart = prvNanoseconds();
+	if( ( xTaskCreate( prvTakeTask, ( signed portCHAR * ) "TAKE", mainTASK_STACK_SIZE, NULL, mainBENCH_PRIORITY - 1, &hTakeTask ) != pdPASS ) ||
+		( xTaskCreate( prvGiveTask, ( signed portCHAR * ) "GIVE", mainTASK_STACK_SIZE, NULL, mainBENCH_WORKER_PRIORITY, NULL ) != pdPASS ) )
+	{
+		return 0ULL;
+	}
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+	ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+	return prvNanoseconds() - ullStart;
+}
+/*-----------------------------------------------------------*/
+
+static void prvYieldTask( void *pvParameters )
+{
+unsigned long x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < mainBENCH_SWITCHES; x++ )
+	{
+		taskYIELD();
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueSendTask( void *pvParameters )
+{
+xQueueHandle xQueue = ( xQueueHandle ) pvParameters;
+unsigned portCHAR ucItem[ mainBENCH_MAX_ITEM_SIZE ];
+void *pvBlock;
+unsigned long x;
+
+	/* Only the first byte of each item is written, whether it is copied or
+	passed by reference. */
+	memset( ucItem, 0, sizeof( ucItem ) );
+	for( x = 0; x < mainBENCH_ITEMS; x++ )
+	{
+		if( xBenchPool == NULL )
+		{
+			ucItem[ 0 ] = ( unsigned portCHAR ) x;
+			xQueueSend( xQueue, ucItem, portMAX_DELAY );
+		}
+		else
+		{
+			pvBlock = pvPoolAllocate( xBenchPool, portMAX_DELAY );
+			*( ( unsigned portCHAR * ) pvBlock ) = ( unsigned portCHAR ) x;
+			xQueueSendReference( xQueue, pvBlock, portMAX_DELAY );
+		}
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueReceiveTask( void *pvParameters )
+{
+xQueueHandle xQueue = ( xQueueHandle ) pvParameters;
+unsigned portCHAR ucItem[ mainBENCH_MAX_ITEM_SIZE ];
+void *pvBlock;
+unsigned long x;
+
+	for( x = 0; x < mainBENCH_ITEMS; x++ )
+	{
+		if( xBenchPool == NULL )
+		{
+			if( ( xQueueReceive( xQueue, ucItem, portMAX_DELAY ) != pdPASS ) || ( ucItem[ 0 ] != ( unsigned portCHAR ) x ) )
+			{
+				xBenchResult = pdFAIL;
+			}
+		}
+		else
+		{
+			if( ( xQueueReceiveReference( xQueue, &pvBlock, portMAX_DELAY ) != pdPASS ) || ( *( ( unsigned portCHAR * ) pvBlock ) != ( unsigned portCHAR ) x ) )
+			{
+				xBenchResult = pdFAIL;
+			}
+			vPoolRelease( pvBlock );
+		}
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendTask( void *pvParameters )
+{
+unsigned long x;
+
+	( void ) pvParameters;
+
+	/* Each suspension switches down to the RESUME task. */
+	for( x = 0; x < mainBENCH_SWITCHES; x++ )
+	{
+		vTaskSuspend( NULL );
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeTask( void *pvParameters )
+{
+xTaskHandle hSuspendTask = ( xTaskHandle ) pvParameters;
+unsigned long x;
+
+	/* Each resumption switches straight back up to the SUSPEND task. */
+	for( x = 0; x < mainBENCH_SWITCHES; x++ )
+	{
+		vTaskResume( hSuspendTask );
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveTask( void *pvParameters )
+{
+unsigned long x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < mainBENCH_SWITCHES; x++ )
+	{
+		if( xGiveTakeSemaphore == NULL )
+		{
+			xTaskNotifyGive( hTakeTask );
+		}
+		else
+		{
+			xSemaphoreGive( xGiveTakeSemaphore );
+		}
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeTask( void *pvParameters )
+{
+unsigned long x;
+portBASE_TYPE xTaken;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < mainBENCH_SWITCHES; x++ )
+	{
+		if( xGiveTakeSemaphore == NULL )
+		{
+			xTaken = ( ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) == 1UL ) ? pdPASS : pdFAIL;
+		}
+		else
+		{
+			xTaken = xSemaphoreTake( xGiveTakeSemaphore, portMAX_DELAY );
+		}
+
+		if( xTaken != pdPASS )
+		{
+			xBenchResult = pdFAIL;
+		}
+	}
+
+	prvBenchTaskDone();
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchTaskDone( void )
+{
+	xTaskNotifyGive( hBenchTask );
+
+	/* The task is not deleted, as INCLUDE_vTaskDelete is 0. */
+	for( ;; )
+	{
+		vTaskSuspend( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int prvReplayHeap( const char *pcTraceFile )
+{
+xHeapOperation *pxTrace, *pxOperation;
+unsigned long x, ulOperations, ulMallocs = 0UL, ulFrees = 0UL, ulFailures = 0UL;
+unsigned long long ullStart, ullClock, ullMallocTime = 0ULL, ullFreeTime = 0ULL;
+xHeapStats xStats;
+double dFragmentation = 0.0, dWorst = 0.0;
+
+	pxTrace = ( pcTraceFile != NULL ) ? prvReadHeapTrace( pcTraceFile, &ulOperations ) : prvGenerateHeapTrace( &ulOperations );
+	if( pxTrace == NULL )
+	{
+		return EXIT_FAILURE;
+	}
+
+	/* Each call is timed on its own, so the cost of reading the clock is
+	taken off. */
+	ullStart = prvNanoseconds();
+	for( x = 0; x < 1000UL; x++ )
+	{
+		( void ) prvNanoseconds();
+	}
+	ullClock = ( prvNanoseconds() - ullStart ) / 1000ULL;
+
+	for( x = 0; x <= ulOperations; x++ )
+	{
+		if( ( ( x % mainREPLAY_PROBE_INTERVAL ) == 0UL ) || ( x == ulOperations ) )
+		{
+			vPortGetHeapStats( &xStats );
+			dFragmentation = 0.0;
+			if( xStats.xAvailableHeapSpaceInBytes > xStats.xSizeOfLargestFreeBlockInBytes )
+			{
+				dFragmentation = 100.0 * ( double ) ( xStats.xAvailableHeapSpaceInBytes - xStats.xSizeOfLargestFreeBlockInBytes ) /
+								 ( double ) xStats.xAvailableHeapSpaceInBytes;
+			}
+			if( dFragmentation > dWorst )
+			{
+				dWorst = dFragmentation;
+			}
+		}
+
+		if( x == ulOperations )
+		{
+			break;
+		}
+
+		pxOperation = &pxTrace[ x ];
+		if( pxOperation->cOperation == 'a' )
+		{
+			/* A block allocated again without being freed is freed first,
+			outside of the timing. */
+			vPortFree( pvReplayBlocks[ pxOperation->usBlock ] );
+
+			ullStart = prvNanoseconds();
+			pvReplayBlocks[ pxOperation->usBlock ] = pvPortMalloc( pxOperation->xSize );
+			ullMallocTime += prvNanoseconds() - ullStart;
+			ulMallocs++;
+
+			if( pvReplayBlocks[ pxOperation->usBlock ] == NULL )
+			{
+				ulFailures++;
+			}
+		}
+		else if( pvReplayBlocks[ pxOperation->usBlock ] != NULL )
+		{
+			/* Frees of blocks whose allocation failed are skipped. */
+			ullStart = prvNanoseconds();
+			vPortFree( pvReplayBlocks[ pxOperation->usBlock ] );
+			ullFreeTime += prvNanoseconds() - ullStart;
+			ulFrees++;
+
+			pvReplayBlocks[ pxOperation->usBlock ] = NULL;
+		}
+	}
+
+	ullMallocTime = ( ullMallocTime > ulMallocs * ullClock ) ? ullMallocTime - ulMallocs * ullClock : 0ULL;
+	ullFreeTime = ( ullFreeTime > ulFrees * ullClock ) ? ullFreeTime - ulFrees * ullClock : 0ULL;
+
+	printf( "Replayed %lu operations from %s\n", ulOperations, ( pcTraceFile != NULL ) ? pcTraceFile : "the generated trace" );
+	printf( "  MALLOC %10.3f us per pvPortMalloc(), %lu of %lu failed\n",
+			( ulMallocs != 0UL ) ? ( double ) ullMallocTime / ( 1000.0 * ( double ) ulMallocs ) : 0.0, ulFailures, ulMallocs );
+	printf( "  FREE   %10.3f us per vPortFree()\n", ( ulFrees != 0UL ) ? ( double ) ullFreeTime / ( 1000.0 * ( double ) ulFrees ) : 0.0 );
+	printf( "  FRAG   %10.1f%% of the free space outside the largest block at the end, %.1f%% at worst\n", dFragmentation, dWorst );
+	printf( "  HEAP   %10lu bytes free at the end in %lu blocks, the largest %lu, %lu at the least\n",
+			( unsigned long ) xStats.xAvailableHeapSpaceInBytes, ( unsigned long ) xStats.xNumberOfFreeBlocks,
+			( unsigned long ) xStats.xSizeOfLargestFreeBlockInBytes, ( unsigned long ) xStats.xMinimumEverFreeBytesRemaining );
+
+	for( x = 0; x < mainREPLAY_BLOCKS; x++ )
+	{
+		vPortFree( pvReplayBlocks[ x ] );
+		pvReplayBlocks[ x ] = NULL;
+	}
+	free( pxTrace );
+
+	return EXIT_SUCCESS;
+}
+/*-----------------------------------------------------------*/
+
+static xHeapOperation *prvReadHeapTrace( const char *pcTraceFile, unsigned long *pulOperations )
+{
+FILE *pxFile;
+xHeapOperation *pxTrace = NULL, *pxGrown;
+unsigned long ulAllocated = 0UL, ulLine = 0UL, ulBlock, ulSize;
+char cLine[ 80 ], cOperation;
+int iFields;
+
+	pxFile = fopen( pcTraceFile, "r" );
+	if( pxFile == NULL )
+	{
+		perror( pcTraceFile );
+		return NULL;
+	}
+
+	*pulOperations = 0UL;
+	while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+	{
+		ulLine++;
+		iFields = sscanf( cLine, " %c %lu %lu", &cOperation, &ulBlock, &ulSize );
+		if( ( iFields <= 0 ) || ( cOperation == '#' ) )
+		{
+			continue;
+		}
+
+		if( ( ulBlock >= mainREPLAY_BLOCKS ) || !( ( ( cOperation == 'a' ) && ( iFields == 3 ) ) || ( ( cOperation == 'f' ) && ( iFields == 2 ) ) ) )
+		{
+			fprintf( stderr, "%s:%lu: expected \"a <block> <size>\" or \"f <block>\", blocks below %u\n", pcTraceFile, ulLine, ( unsigned ) mainREPLAY_BLOCKS );
+			free( pxTrace );
+			fclose( pxFile );
+			return NULL;
+		}
+
+		if( *pulOperations == ulAllocated )
+		{
+			ulAllocated = ( ulAllocated == 0UL ) ? 1024UL : ulAllocated * 2UL;
+			pxGrown = realloc( pxTrace, ulAllocated * sizeof( xHeapOperation ) );
+			if( pxGrown == NULL )
+			{
+				free( pxTrace );
+				fclose( pxFile );
+				return NULL;
+			}
+			pxTrace = pxGrown;
+		}
+
+		pxTrace[ *pulOperations ].cOperation = cOperation;
+		pxTrace[ *pulOperations ].usBlock = ( unsigned portSHORT ) ulBlock;
+		pxTrace[ *pulOperations ].xSize = ( cOperation == 'a' ) ? ( size_t ) ulSize : 0;
+		( *pulOperations )++;
+	}
+
+	fclose( pxFile );
+
+	if( pxTrace == NULL )
+	{
+		fprintf( stderr, "%s: no operations\n", pcTraceFile );
+	}
+
+	return pxTrace;
+}
+/*-----------------------------------------------------------*/
+
+static xHeapOperation *prvGenerateHeapTrace( unsigned long *pulOperations )
+{
+xHeapOperation *pxTrace;
+unsigned portCHAR ucLive[ mainREPLAY_LIVE_BLOCKS ];
+unsigned long x, ulSeed = 1UL, ulBlock, ulKind;
+
+	pxTrace = malloc( mainREPLAY_OPERATIONS * sizeof( xHeapOperation ) );
+	if( pxTrace == NULL )
+	{
+		return NULL;
+	}
+	memset( ucLive, 0, sizeof( ucLive ) );
+
+	/* The same trace every time, so the heaps see the same requests. */
+	#define mainREPLAY_RANDOM()	( ulSeed = ( ulSeed * 1103515245UL + 12345UL ) & 0x7fffffffUL, ulSeed >> 8 )
+
+	for( x = 0; x < mainREPLAY_OPERATIONS; x++ )
+	{
+		ulBlock = mainREPLAY_RANDOM() % mainREPLAY_LIVE_BLOCKS;
+		pxTrace[ x ].usBlock = ( unsigned portSHORT ) ulBlock;
+
+		if( ucLive[ ulBlock ] != 0 )
+		{
+			pxTrace[ x ].cOperation = 'f';
+			pxTrace[ x ].xSize = 0;
+			ucLive[ ulBlock ] = 0;
+		}
+		else
+		{
+			/* Mostly messages, a quarter packet buffers, and a few stacks. */
+			ulKind = mainREPLAY_RANDOM() % 100UL;
+			if( ulKind < 70UL )
+			{
+				pxTrace[ x ].xSize = ( size_t ) ( 16UL + mainREPLAY_RANDOM() % 113UL );
+			}
+			else if( ulKind < 95UL )
+			{
+				pxTrace[ x ].xSize = ( size_t ) ( 256UL + mainREPLAY_RANDOM() % 1281UL );
+			}
+			else
+			{
+				pxTrace[ x ].xSize = ( size_t ) ( 2048UL + mainREPLAY_RANDOM() % 2049UL );
+			}
+			pxTrace[ x ].cOperation = 'a';
+			ucLive[ ulBlock ] = 1;
+		}
+	}
+
+	#undef mainREPLAY_RANDOM
+
+	*pulOperations = mainREPLAY_OPERATIONS;
+	return pxTrace;
+}
+/*-----------------------------------------------------------*/
+
+extern void __real_vTaskSwitchContext( void );
+
+void __wrap_vTaskSwitchContext( void )
+{
+unsigned long long ullStart;
+
+	/* The Makefile links the port's calls to vTaskSwitchContext() to here,
+	so the priority benchmark can tell the kernel's choice of the next task
+	apart from the port's switch to it.  Interrupts are blocked. */
+	if( xTimeSelection == pdFALSE )
+	{
+		__real_vTaskSwitchContext();
+	}
+	else
+	{
+		ullStart = prvNanoseconds();
+		__real_vTaskSwitchContext();
+		ullSelectionTime += prvNanoseconds() - ullStart;
+		ulSelections++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static unsigned long long prvNanoseconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( ( unsigned long long ) xNow.tv_sec * 1000000000ULL ) + ( unsigned long long ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeterTimerCallback( xTimerHandle xTimer )
+{
+static xMeterMessage xMeter;
+
+	( void ) xTimer;
+
+	/* The periodic meter update sent by MainDemo.c.  Timer callbacks must not
+	block. */
+	xMeter.ucData[ 0 ]++;
+	if( xQueueSend( hMETERQueue, &xMeter, 0 ) != pdPASS )
+	{
+		ulISROverruns++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTimerCallback( xTimerHandle xTimer )
+{
+static portTickType xExpected = mainCHECK_TIMER_PERIOD;
+
+	( void ) xTimer;
+
+	/* The timer was started with a tick count of 0, so should run on every
+	multiple of its period. */
+	prvRecordTimerLateness( xExpected );
+	xExpected += mainCHECK_TIMER_PERIOD;
+}
+/*-----------------------------------------------------------*/
+
+static void prvISRTimerCallback( xTimerHandle xTimer )
+{
+	( void ) xTimer;
+
+	prvRecordTimerLateness( xISRTimerStartTime + mainISR_TIMER_PERIOD );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordTimerLateness( portTickType xExpected )
+{
+portTickType xLateness;
+
+	/* Only the timer service task calls this, so no protection is needed. */
+	xLateness = xTaskGetTickCount() - xExpected;
+	if( xLateness > xTimerMaxLateness )
+	{
+		xTimerMaxLateness = xLateness;
+	}
+	ulTimerCount++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintRunTimeStats( void )
+{
+unsigned portBASE_TYPE x;
+
+	if( ullTotalRunTime == 0ULL )
+	{
+		return;
+	}
+
+	printf( "CPU time by task (%llu us in total)\n", ullTotalRunTime );
+	for( x = 0; x < uxRunTimeStatsCount; x++ )
+	{
+		printf( "  %-6s %9.2f%% %10lu switches\n", ( const char * ) xRunTimeStats[ x ].pcTaskName,
+				( 100.0 * ( double ) xRunTimeStats[ x ].ullRunTimeCounter ) / ( double ) ullTotalRunTime,
+				( unsigned long ) xRunTimeStats[ x ].ulSwitchInCount );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteTrace( void )
+{
+FILE *pxFile;
+
+	if( pcTraceFile == NULL )
+	{
+		return;
+	}
+
+	pxFile = fopen( pcTraceFile, "wb" );
+	if( ( pxFile == NULL ) || ( fwrite( pvTraceGetBuffer(), ( size_t ) ulTraceGetBufferSize(), 1, pxFile ) != 1 ) )
+	{
+		perror( pcTraceFile );
+	}
+	else
+	{
+		printf( "Trace written to %s\n", pcTraceFile );
+	}
+
+	if( pxFile != NULL )
+	{
+		fclose( pxFile );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoWork( unsigned portLONG ulIterations )
+{
+volatile unsigned portLONG ulCount;
+
+	for( ulCount = 0UL; ulCount < ulIterations; ulCount++ )
+	{
+		portNOP();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook( void )
+{
+static portTickType xTicks = 0;
+static portCHAR cRxChar = 'A';
+portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	/* The benchmarks time the tick with nothing in the hook. */
+	if( xRunBenchmarks != pdFALSE )
+	{
+		return;
+	}
+
+	xTicks++;
+	ulTickInterrupts++;
+
+	/* The UART receive interrupt. */
+	if( ( xTicks % mainUART_RX_RATE ) == 0 )
+	{
+		if( xStreamBufferSendFromISR( hUARTRxStream, &cRxChar, sizeof( cRxChar ), &xHigherPriorityTaskWoken ) == ( size_t ) 0 )
+		{
+			ulISROverruns++;
+		}
+		cRxChar = ( cRxChar == 'Z' ) ? 'A' : cRxChar + 1;
+	}
+
+	/* The MRF24J40 interrupt. */
+	if( ( xTicks % mainMIWI_RX_RATE ) == 0 )
+	{
+		xTaskNotifyFromISR( hMIWITask, &xHigherPriorityTaskWoken );
+	}
+
+	/* Restart the one-shot timer that checks timers started from an ISR
+	expire on time. */
+	if( ( xTicks % mainISR_TIMER_RATE ) == 0 )
+	{
+		xISRTimerStartTime = xTaskGetTickCountFromISR();
+		xTimerStartFromISR( hISRTimer, &xHigherPriorityTaskWoken );
+	}
+
+	portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationStackOverflowHook( xTaskHandle *pxTask, signed portCHAR *pcTaskName )
+{
+	( void ) pxTask;
+
+	/* Only the one word at the top of each kernel stack is ever used, so
+	this indicates memory corruption rather than a genuine overflow. */
+	fprintf( stderr, "Stack overflow detected in task %s\n", ( char * ) pcTaskName );
+	abort();
+}
+/*-----------------------------------------------------------*/
+
@@ -0,0 +1,281 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#ifndef INC_FREERTOS_H
+	#error "#include FreeRTOS.h" must appear in source files before "#include pool.h"
+#endif
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed size block pools, and passing blocks between tasks by reference.
+ *
+ * Queues normally copy each item into the queue storage when it is sent and
+ * out again when it is received, which for large messages costs two copies of
+ * the whole message.  Instead a task can allocate a block from a pool, fill
+ * it in, and send just the pointer to the block on a queue created with
+ * xQueueCreateByReference().  The receiving task then owns the block and
+ * returns it to the pool with vPoolRelease() once it has finished with it.
+ *
+ * Every block records which pool it came from, so vPoolRelease() only needs
+ * the pointer to the block.  A task allocating from an empty pool can block
+ * until another task releases a block.
+ */
+typedef void * xPoolHandle;
+
+/**
+ * pool. h
+ * <pre>
+ xPoolHandle xPoolCreate(
+                            unsigned portBASE_TYPE uxNumberOfBlocks,
+                            unsigned portBASE_TYPE uxBlockSize
+                        );
+ * </pre>
+ *
+ * Creates a pool of uxNumberOfBlocks blocks, each able to hold uxBlockSize
+ * bytes.  All the memory for the pool is obtained from pvPortMalloc() in one
+ * allocation when the pool is created.  Pools cannot be deleted.
+ *
+ * @param uxNumberOfBlocks The number of blocks in the pool.
+ *
+ * @param uxBlockSize The number of bytes each block can hold.
+ *
+ * @return A handle to the created pool, or NULL if the pool could not be
+ * created.
+ *
+ * \page xPoolCreate xPoolCreate
+ * \ingroup Pools
+ */
+xPoolHandle xPoolCreate( unsigned portBASE_TYPE uxNumberOfBlocks, unsigned portBASE_TYPE uxBlockSize );
+
+/**
+ * pool. h
+ * <pre>
+ void *pvPoolAllocate(
+                         xPoolHandle xPool,
+                         portTickType xTicksToWait
+                     );
+ * </pre>
+ *
+ * Take a block from a pool.
+ *
+ * @param xPool The pool to take the block from.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a block to be released if the pool is empty.
+ *
+ * @return A pointer to the block, or NULL if no block became available
+ * within xTicksToWait.
+ *
+ * \page pvPoolAllocate pvPoolAllocate
+ * \ingroup Pools
+ */
+void *pvPoolAllocate( xPoolHandle xPool, portTickType xTicksToWait );
+
+/**
+ * pool. h
+ * <pre>
+ void *pvPoolAllocateFromISR( xPoolHandle xPool );
+ * </pre>
+ *
+ * A version of pvPoolAllocate() that can be called from an ISR.  Never
+ * blocks.
+ *
+ * \page pvPoolAllocateFromISR pvPoolAllocateFromISR
+ * \ingroup Pools
+ */
+void *pvPoolAllocateFromISR( xPoolHandle xPool );
+
+/**
+ * pool. h
+ * <pre>
+ void vPoolRelease( void *pvBlock );
+ * </pre>
+ *
+ * Return a block to the pool it was allocated from, unblocking a task that
+ * is waiting in pvPoolAllocate() if there is one.
+ *
+ * @param pvBlock A pointer previously returned by pvPoolAllocate() or
+ * pvPoolAllocateFromISR().
+ *
+ * \page vPoolRelease vPoolRelease
+ * \ingroup Pools
+ */
+void vPoolRelease( void *pvBlock );
+
+/**
+ * pool. h
+ * <pre>
+ void vPoolReleaseFromISR(
+                             void *pvBlock,
+                             signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                         );
+ * </pre>
+ *
+ * A version of vPoolRelease() that can be called from an ISR.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the block
+ * unblocked a task with a priority higher than the running task.
+ *
+ * \page vPoolReleaseFromISR vPoolReleaseFromISR
+ * \ingroup Pools
+ */
+void vPoolReleaseFromISR( void *pvBlock, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+
+/**
+ * pool. h
+ * <pre>
+ unsigned portBASE_TYPE uxPoolBlocksAvailable( xPoolHandle xPool );
+ * </pre>
+ *
+ * @return The number of blocks that are currently free in the pool.
+ *
+ * \page uxPoolBlocksAvailable uxPoolBlocksAvailable
+ * \ingroup Pools
+ */
+unsigned portBASE_TYPE uxPoolBlocksAvailable( xPoolHandle xPool );
+
+/**
+ * pool. h
+ * <pre>xQueueHandle xQueueCreateByReference( unsigned portBASE_TYPE uxQueueLength )</pre>
+ *
+ * Creates a queue that holds pointers to blocks rather than copies of the
+ * data, so sending or receiving a message of any size copies a single
+ * pointer.  Ownership of the block passes from the sender to the receiver.
+ *
+ * Use xQueueSendReference() and xQueueReceiveReference() to access the
+ * queue.  The other queue functions can also be used provided the address of
+ * the block pointer is passed in, as with any other queue item.
+ *
+ * Example usage:
+   <pre>
+ xQueueHandle xQueue;
+ xPoolHandle xPool;
+
+ void vSender( void *pvParameters )
+ {
+ xMessage *pxMessage;
+
+    for( ;; )
+    {
+        pxMessage = ( xMessage * ) pvPoolAllocate( xPool, portMAX_DELAY );
+
+        // Fill in *pxMessage here, then hand it to the receiver.  The
+        // sender must not access the block after this.
+        xQueueSendReference( xQueue, pxMessage, portMAX_DELAY );
+    }
+ }
+
+ void vReceiver( void *pvParameters )
+ {
+ xMessage *pxMessage;
+
+    for( ;; )
+    {
+        if( xQueueReceiveReference( xQueue, &pxMessage, portMAX_DELAY ) == pdPASS )
+        {
+            // Use *pxMessage, then give the block back to its pool.
+            vPoolRelease( pxMessage );
+        }
+    }
+ }
+   </pre>
+ * \page xQueueCreateByReference xQueueCreateByReference
+ * \ingroup Pools
+ */
+#define xQueueCreateByReference( uxQueueLength ) xQueueCreate( ( uxQueueLength ), sizeof( void * ) )
+
+/**
+ * pool. h
+ * <pre>portBASE_TYPE xQueueSendReference( xQueueHandle xQueue, void *pvBlock, portTickType xTicksToWait );</pre>
+ *
+ * Post a pointer to a block to the back of a queue created with
+ * xQueueCreateByReference().  If the post fails the caller still owns the
+ * block, and should normally release it.
+ *
+ * \page xQueueSendReference xQueueSendReference
+ * \ingroup Pools
+ */
+#define xQueueSendReference( xQueue, pvBlock, xTicksToWait ) xQueueGenericSend( ( xQueue ), ( const void * ) &( pvBlock ), ( xTicksToWait ), queueSEND_TO_BACK )
+
+/**
+ * pool. h
+ * <pre>portBASE_TYPE xQueueSendReferenceFromISR( xQueueHandle xQueue, void *pvBlock, portBASE_TYPE *pxHigherPriorityTaskWoken );</pre>
+ *
+ * A version of xQueueSendReference() that can be called from an ISR.
+ *
+ * \page xQueueSendReferenceFromISR xQueueSendReferenceFromISR
+ * \ingroup Pools
+ */
+#define xQueueSendReferenceFromISR( xQueue, pvBlock, pxHigherPriorityTaskWoken ) xQueueGenericSendFromISR( ( xQueue ), ( const void * ) &( pvBlock ), ( pxHigherPriorityTaskWoken ), queueSEND_TO_BACK )
+
+/**
+ * pool. h
+ * <pre>portBASE_TYPE xQueueReceiveReference( xQueueHandle xQueue, void **ppvBlock, portTickType xTicksToWait );</pre>
+ *
+ * Receive a pointer to a block from a queue created with
+ * xQueueCreateByReference().  The receiver then owns the block.
+ *
+ * \page xQueueReceiveReference xQueueReceiveReference
+ * \ingroup Pools
+ */
+#define xQueueReceiveReference( xQueue, ppvBlock, xTicksToWait ) xQueueGenericReceive( ( xQueue ), ( void * ) ( ppvBlock ), ( xTicksToWait ), pdFALSE )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H */
+
@@ -68,6 +68,10 @@
 	#include "../portable/GCC/ATMega323/portmacro.h"
 #endif
 
+#ifdef GCC_LINUX_PORT
+	#include "../portable/GCC/Linux/portmacro.h"
+#endif
+
 #ifdef IAR_MEGA_AVR
 	#include "../portable/IAR/ATMega323/portmacro.h"
 #endif
@@ -320,6 +324,30 @@ void *pvPortMalloc( size_t xSize );
 void vPortFree( void *pv );
 void vPortInitialiseBlocks( void );
 
+/*
+ * Statistics on the use of the heap.  Only available when heap_2.c or heap_4.c
+ * is used.
+ *
+ * xPortGetFreeHeapSize() returns the number of bytes not currently allocated,
+ * and xPortGetMinimumEverFreeHeapSize() the lowest that value has been since
+ * the heap was initialised.  vPortGetHeapStats() fills in an xHeapStats
+ * structure, which also shows how fragmented the free space is.
+ */
+typedef struct xHEAP_STATS
+{
+	size_t xAvailableHeapSpaceInBytes;		/*< The total free space - the sum of all the free blocks. */
+	size_t xSizeOfLargestFreeBlockInBytes;	/*< The largest allocation that could succeed (plus the block header). */
+	size_t xSizeOfSmallestFreeBlockInBytes;	/*< The smallest free block. */
+	size_t xNumberOfFreeBlocks;				/*< The number of free blocks the free space is split between. */
+	size_t xMinimumEverFreeBytesRemaining;	/*< As returned by xPortGetMinimumEverFreeHeapSize(). */
+	size_t xNumberOfSuccessfulAllocations;	/*< The number of calls to pvPortMalloc() that returned a block. */
+	size_t xNumberOfSuccessfulFrees;		/*< The number of calls to vPortFree() that freed a block. */
+} xHeapStats;
+
+size_t xPortGetFreeHeapSize( void );
+size_t xPortGetMinimumEverFreeHeapSize( void );
+void vPortGetHeapStats( xHeapStats *pxHeapStats );
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
@@ -1214,6 +1214,16 @@ xQueueHandle xQueueCreateCountingSemaphore( unsigned portBASE_TYPE uxCountValue,
 portBASE_TYPE xQueueTakeMutexRecursive( xQueueHandle xMutex, portTickType xBlockTime );
 portBASE_TYPE xQueueGiveMutexRecursive( xQueueHandle xMutex );
 
+/*
+ * For internal use only.  Used by the timer service task to block on its
+ * command queue until either a command arrives or the next timer expires.
+ * Must be called with the scheduler suspended, and only ever blocks once -
+ * the caller is expected to re-evaluate its block time each time it runs.
+ */
+#if ( configUSE_TIMERS == 1 )
+	void vQueueWaitForMessageRestricted( xQueueHandle pxQueue, portTickType xTicksToWait );
+#endif
+
 /*
  * The registry is provided as a means for kernel aware debuggers to
  * locate queues, semaphores and mutexes.  Call vQueueAddToRegistry() add
@@ -0,0 +1,410 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#ifndef INC_FREERTOS_H
+	#error "#include FreeRTOS.h" must appear in source files before "#include stream_buffer.h"
+#endif
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Stream buffers and message buffers.
+ *
+ * A queue copies one fixed size item per call and wakes the receiving task
+ * for every item, which is a poor fit for byte oriented data such as the
+ * characters received by a UART.  A stream buffer is a circular buffer of
+ * bytes: the writer adds as many bytes as it has in one call, and the reader
+ * takes as many as it wants in one call.  A reader blocked on an empty stream
+ * buffer is only woken once the number of bytes in the buffer reaches the
+ * trigger level, so data arriving a byte at a time can be handled a burst at
+ * a time.
+ *
+ * A message buffer is a stream buffer that stores each write as one variable
+ * length message, preceded by its length.  A read returns exactly one
+ * message.
+ *
+ * Stream and message buffers assume there is only one writer and only one
+ * reader - for example an interrupt and a task.  The writer only ever moves
+ * the head of the buffer and the reader only ever moves the tail, so data is
+ * copied without entering a critical section.  If several tasks write to (or
+ * read from) the same buffer the calls must be serialised, for example with a
+ * mutex.
+ *
+ * A blocked reader or writer is woken with a task notification, so
+ * configUSE_TASK_NOTIFICATIONS must be set to 1.  A task should not wait for
+ * other notifications while it is using a stream buffer, as it may be woken
+ * early by the stream buffer.
+ */
+typedef void * xStreamBufferHandle;
+typedef void * xMessageBufferHandle;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ xStreamBufferHandle xStreamBufferCreate(
+                                            size_t xBufferSizeBytes,
+                                            size_t xTriggerLevelBytes
+                                        );
+ * </pre>
+ *
+ * Creates a stream buffer.  The storage is obtained from pvPortMalloc() in
+ * the same allocation as the stream buffer structure.  Stream buffers cannot
+ * be deleted.
+ *
+ * @param xBufferSizeBytes The number of bytes the buffer can hold.
+ *
+ * @param xTriggerLevelBytes The number of bytes that must be in the buffer
+ * before a reader blocked on the empty buffer is woken.  Values of 0 and 1
+ * both wake the reader as soon as there is any data.  See
+ * xStreamBufferSetTriggerLevel().
+ *
+ * @return A handle to the created stream buffer, or NULL if there was not
+ * enough heap.
+ *
+ * \page xStreamBufferCreate xStreamBufferCreate
+ * \ingroup StreamBuffers
+ */
+#define xStreamBufferCreate( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( ( xBufferSizeBytes ), ( xTriggerLevelBytes ), pdFALSE )
+
+/**
+ * stream_buffer. h
+ * <pre>xMessageBufferHandle xMessageBufferCreate( size_t xBufferSizeBytes );</pre>
+ *
+ * Creates a message buffer.  Each message occupies its length plus
+ * sizeof( size_t ) bytes of the buffer.  A reader blocked on an empty message
+ * buffer is woken as soon as a message is written.
+ *
+ * @return A handle to the created message buffer, or NULL if there was not
+ * enough heap.
+ *
+ * \page xMessageBufferCreate xMessageBufferCreate
+ * \ingroup StreamBuffers
+ */
+#define xMessageBufferCreate( xBufferSizeBytes ) ( xMessageBufferHandle ) xStreamBufferGenericCreate( ( xBufferSizeBytes ), ( size_t ) 1, pdTRUE )
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferSend(
+                             xStreamBufferHandle xStreamBuffer,
+                             const void *pvTxData,
+                             size_t xDataLengthBytes,
+                             portTickType xTicksToWait
+                         );
+ * </pre>
+ *
+ * Copy bytes into a stream buffer.  If there is not room for all of them the
+ * calling task blocks, for at most xTicksToWait, until there is.  The task is
+ * woken once, when enough space has been freed, rather than each time the
+ * reader removes some bytes.
+ *
+ * @param xStreamBuffer The stream buffer to write to.
+ *
+ * @param pvTxData The bytes to copy.
+ *
+ * @param xDataLengthBytes The number of bytes to copy.
+ *
+ * @param xTicksToWait The maximum time to wait for space.  If the block time
+ * expires as many bytes as fit are written.
+ *
+ * @return The number of bytes written.
+ *
+ * \page xStreamBufferSend xStreamBufferSend
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferSend( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, portTickType xTicksToWait );
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferSendFromISR(
+                                    xStreamBufferHandle xStreamBuffer,
+                                    const void *pvTxData,
+                                    size_t xDataLengthBytes,
+                                    signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                );
+ * </pre>
+ *
+ * A version of xStreamBufferSend() that can be called from an interrupt
+ * service routine.  Writes as many bytes as fit and never blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the write woke a reader
+ * with a priority equal to or higher than the interrupted task, in which
+ * case a context switch should be requested before the interrupt exits.
+ *
+ * @return The number of bytes written.
+ *
+ * Example usage:
+   <pre>
+ void vUARTRxISR( void )
+ {
+ unsigned portCHAR ucBytes[ 8 ];
+ size_t xCount = 0;
+ signed portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+     // Empty the receive FIFO, then pass everything on in one call.
+     while( prvRxDataAvailable() && ( xCount < sizeof( ucBytes ) ) )
+     {
+         ucBytes[ xCount++ ] = prvRxByte();
+     }
+
+     xStreamBufferSendFromISR( xRxStream, ucBytes, xCount, &xHigherPriorityTaskWoken );
+
+     portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
+ }
+   </pre>
+ * \page xStreamBufferSendFromISR xStreamBufferSendFromISR
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferSendFromISR( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferReceive(
+                                xStreamBufferHandle xStreamBuffer,
+                                void *pvRxData,
+                                size_t xBufferLengthBytes,
+                                portTickType xTicksToWait
+                            );
+ * </pre>
+ *
+ * Copy bytes out of a stream buffer.  If the buffer is empty the calling
+ * task blocks, for at most xTicksToWait, until the number of bytes in the
+ * buffer reaches the trigger level.  Whatever is in the buffer, up to
+ * xBufferLengthBytes, is then returned - so a read after the block time
+ * expires can return fewer bytes than the trigger level.
+ *
+ * @param xStreamBuffer The stream buffer to read from.
+ *
+ * @param pvRxData Where to copy the bytes to.
+ *
+ * @param xBufferLengthBytes The most bytes to copy.
+ *
+ * @param xTicksToWait The maximum time to wait for data.
+ *
+ * @return The number of bytes read, zero if the block time expired with the
+ * buffer still empty.
+ *
+ * \page xStreamBufferReceive xStreamBufferReceive
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferReceive( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, portTickType xTicksToWait );
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferReceiveFromISR(
+                                       xStreamBufferHandle xStreamBuffer,
+                                       void *pvRxData,
+                                       size_t xBufferLengthBytes,
+                                       signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                   );
+ * </pre>
+ *
+ * A version of xStreamBufferReceive() that can be called from an interrupt
+ * service routine, for example to feed a transmit FIFO.  Never blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the read made enough
+ * space to wake a writer with a priority equal to or higher than the
+ * interrupted task.
+ *
+ * @return The number of bytes read.
+ *
+ * \page xStreamBufferReceiveFromISR xStreamBufferReceiveFromISR
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferReceiveFromISR( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+
+/**
+ * stream_buffer. h
+ * <pre>
+ portBASE_TYPE xStreamBufferSetTriggerLevel(
+                                               xStreamBufferHandle xStreamBuffer,
+                                               size_t xTriggerLevelBytes
+                                           );
+ * </pre>
+ *
+ * Change the number of bytes that must be in the buffer before a blocked
+ * reader is woken.  A high trigger level means fewer wake ups, but data can
+ * wait in the buffer for up to the reader's block time, so the reader should
+ * use a block time no longer than the latency it can accept.
+ *
+ * @return pdPASS, or pdFAIL if the trigger level is larger than the buffer.
+ *
+ * \page xStreamBufferSetTriggerLevel xStreamBufferSetTriggerLevel
+ * \ingroup StreamBuffers
+ */
+portBASE_TYPE xStreamBufferSetTriggerLevel( xStreamBufferHandle xStreamBuffer, size_t xTriggerLevelBytes );
+
+/**
+ * stream_buffer. h
+ * <pre>size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer );</pre>
+ *
+ * @return The number of bytes that can be read from the buffer.  For a
+ * message buffer this includes the length stored with each message.
+ *
+ * \page xStreamBufferBytesAvailable xStreamBufferBytesAvailable
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer );
+
+/**
+ * stream_buffer. h
+ * <pre>size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer );</pre>
+ *
+ * @return The number of bytes that can be written to the buffer.  For a
+ * message buffer the longest message that can be written is
+ * sizeof( size_t ) bytes shorter.
+ *
+ * \page xStreamBufferSpacesAvailable xStreamBufferSpacesAvailable
+ * \ingroup StreamBuffers
+ */
+size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer );
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xMessageBufferSend(
+                              xMessageBufferHandle xMessageBuffer,
+                              const void *pvTxData,
+                              size_t xDataLengthBytes,
+                              portTickType xTicksToWait
+                          );
+ * </pre>
+ *
+ * Write one message.  The message is written whole or not at all.  Zero
+ * length messages are not written.
+ *
+ * @return xDataLengthBytes if the message was written, otherwise 0.
+ *
+ * \page xMessageBufferSend xMessageBufferSend
+ * \ingroup StreamBuffers
+ */
+#define xMessageBufferSend( xMessageBuffer, pvTxData, xDataLengthBytes, xTicksToWait ) xStreamBufferSend( ( xStreamBufferHandle ) ( xMessageBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( xTicksToWait ) )
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xMessageBufferSendFromISR(
+                                     xMessageBufferHandle xMessageBuffer,
+                                     const void *pvTxData,
+                                     size_t xDataLengthBytes,
+                                     signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                 );
+ * </pre>
+ *
+ * A version of xMessageBufferSend() that can be called from an interrupt
+ * service routine.
+ *
+ * \page xMessageBufferSendFromISR xMessageBufferSendFromISR
+ * \ingroup StreamBuffers
+ */
+#define xMessageBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferSendFromISR( ( xStreamBufferHandle ) ( xMessageBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxHigherPriorityTaskWoken ) )
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xMessageBufferReceive(
+                                 xMessageBufferHandle xMessageBuffer,
+                                 void *pvRxData,
+                                 size_t xBufferLengthBytes,
+                                 portTickType xTicksToWait
+                             );
+ * </pre>
+ *
+ * Read the oldest message, blocking for at most xTicksToWait if there are
+ * none.
+ *
+ * @return The length of the message, or 0 if there was no message or the
+ * message is longer than xBufferLengthBytes.  In the latter case the message
+ * is left in the buffer.
+ *
+ * \page xMessageBufferReceive xMessageBufferReceive
+ * \ingroup StreamBuffers
+ */
+#define xMessageBufferReceive( xMessageBuffer, pvRxData, xBufferLengthBytes, xTicksToWait ) xStreamBufferReceive( ( xStreamBufferHandle ) ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( xTicksToWait ) )
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xMessageBufferReceiveFromISR(
+                                        xMessageBufferHandle xMessageBuffer,
+                                        void *pvRxData,
+                                        size_t xBufferLengthBytes,
+                                        signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                    );
+ * </pre>
+ *
+ * A version of xMessageBufferReceive() that can be called from an interrupt
+ * service routine.
+ *
+ * \page xMessageBufferReceiveFromISR xMessageBufferReceiveFromISR
+ * \ingroup StreamBuffers
+ */
+#define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveFromISR( ( xStreamBufferHandle ) ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxHigherPriorityTaskWoken ) )
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the macros above only.
+ */
+xStreamBufferHandle xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, portBASE_TYPE xIsMessageBuffer );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_BUFFER_H */
+
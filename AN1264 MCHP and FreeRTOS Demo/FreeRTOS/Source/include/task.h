@@ -89,6 +89,25 @@ typedef struct xTIME_OUT
     portTickType  xTimeOnEntering;
 } xTimeOutType;
 
+/**
+ * task. h
+ *
+ * One entry of the snapshot returned by uxTaskGetRunTimeSnapshot().  The run
+ * time is in units of the run time counter and is held in 64 bits, so for
+ * practical purposes it cannot overflow.
+ *
+ * \page xTaskRunTimeStatus xTaskRunTimeStatus
+ * \ingroup TaskUtils
+ */
+typedef struct xTASK_RUN_TIME_STATUS
+{
+	xTaskHandle xHandle;						/*< The task the entry describes. */
+	const signed portCHAR *pcTaskName;			/*< The name of the task.  Only valid while the task exists. */
+	unsigned portBASE_TYPE uxCurrentPriority;	/*< The priority of the task, including any inherited priority. */
+	unsigned long long ullRunTimeCounter;		/*< The total time the task has spent in the Running state. */
+	unsigned portLONG ulSwitchInCount;			/*< The number of times the task has been switched in. */
+} xTaskRunTimeStatus;
+
 /*
  * Defines the priority used by the idle task.  This must not be modified.
  *
@@ -816,6 +835,19 @@ signed portBASE_TYPE xTaskIsTaskSuspended( xTaskHandle xTask );
  */
 portTickType xTaskGetTickCount( void );
 
+/**
+ * task. h
+ * <PRE>portTickType xTaskGetTickCountFromISR( void );</PRE>
+ *
+ * A version of xTaskGetTickCount() that can be called from an ISR.
+ *
+ * @return The count of ticks since vTaskStartScheduler was called.
+ *
+ * \page xTaskGetTickCountFromISR xTaskGetTickCountFromISR
+ * \ingroup TaskUtils
+ */
+portTickType xTaskGetTickCountFromISR( void );
+
 /**
  * task. h
  * <PRE>unsigned portSHORT uxTaskGetNumberOfTasks( void );</PRE>
@@ -865,7 +897,10 @@ void vTaskList( signed portCHAR *pcWriteBuffer );
  * for portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() and
  * portGET_RUN_TIME_COUNTER_VALUE to configure a peripheral timer/counter
  * and return the timers current count value respectively.  The counter
- * should be at least 10 times the frequency of the tick count.
+ * should be at least 10 times the frequency of the tick count.  It must be
+ * free running and as wide as an unsigned portLONG, as the time each task runs
+ * for is found by subtracting successive counter values and the result
+ * accumulated into a 64 bit total.
  *
  * NOTE: This function will disable interrupts for its duration.  It is
  * not intended for normal application runtime use but as a debug aid.
@@ -888,6 +923,56 @@ void vTaskList( signed portCHAR *pcWriteBuffer );
  */
 void vTaskGetRunTimeStats( signed portCHAR *pcWriteBuffer );
 
+/**
+ * task. h
+ * <PRE>unsigned portBASE_TYPE uxTaskGetRunTimeSnapshot( xTaskRunTimeStatus *pxTaskStatusArray, unsigned portBASE_TYPE uxArraySize, unsigned long long *pullTotalRunTime );</PRE>
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1 for this function
+ * to be available.
+ *
+ * Fills pxTaskStatusArray with the accumulated run time and the number of
+ * times each task has been switched in.  Unlike vTaskGetRunTimeStats() no
+ * text is generated, and the scheduler is only suspended (interrupts are not
+ * disabled) while the array is filled, so the function is suitable for use
+ * at run time.
+ *
+ * The CPU load of a task over an interval is found by taking two snapshots
+ * and dividing the difference in the task's ullRunTimeCounter by the
+ * difference in the total run time.
+ *
+ * @param pxTaskStatusArray Array to receive one entry per task.
+ *
+ * @param uxArraySize The number of entries in pxTaskStatusArray.  Tasks that
+ * do not fit are not reported.  uxTaskGetNumberOfTasks() returns the number
+ * needed.
+ *
+ * @param pullTotalRunTime If not NULL, set to the run time accumulated by
+ * all tasks, in the same units as the per task values.
+ *
+ * @return The number of entries written to pxTaskStatusArray.
+ *
+ * Example usage:
+   <pre>
+ void vDisplayLoad( void )
+ {
+ xTaskRunTimeStatus xStatus[ 10 ];
+ unsigned long long ullTotal;
+ unsigned portBASE_TYPE x, uxTasks;
+
+	uxTasks = uxTaskGetRunTimeSnapshot( xStatus, 10, &ullTotal );
+
+	for( x = 0; x < uxTasks; x++ )
+	{
+		// Percentage of the CPU used by the task since the scheduler started.
+		vDisplay( xStatus[ x ].pcTaskName, ( xStatus[ x ].ullRunTimeCounter * 100 ) / ullTotal );
+	}
+ }
+   </pre>
+ * \page uxTaskGetRunTimeSnapshot uxTaskGetRunTimeSnapshot
+ * \ingroup TaskUtils
+ */
+unsigned portBASE_TYPE uxTaskGetRunTimeSnapshot( xTaskRunTimeStatus *pxTaskStatusArray, unsigned portBASE_TYPE uxArraySize, unsigned long long *pullTotalRunTime );
+
 /**
  * task. h
  * <PRE>void vTaskStartTrace( portCHAR * pcBuffer, unsigned portBASE_TYPE uxBufferSize );</PRE>
@@ -972,6 +1057,93 @@ pdTASK_HOOK_CODE xTaskGetApplicationTaskTag( xTaskHandle xTask );
  */
 portBASE_TYPE xTaskCallApplicationTaskHook( xTaskHandle xTask, void *pvParameter );
 
+/**
+ * task. h
+ * <pre>signed portBASE_TYPE xTaskNotifyGive( xTaskHandle xTaskToNotify );</pre>
+ *
+ * configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Each task has a notification count that is zero when the task is created.
+ * xTaskNotifyGive() increments the count of xTaskToNotify, unblocking the task
+ * if it was waiting in ulTaskNotifyTake().  Used in this way a notification is
+ * a lighter weight alternative to giving a binary or counting semaphore that
+ * only one task ever takes - no queue needs to be created, and no data is
+ * copied or event list manipulated to send it.
+ *
+ * Must not be called from an interrupt.  See xTaskNotifyFromISR().
+ *
+ * @param xTaskToNotify The handle of the task being notified.
+ *
+ * @return pdPASS.
+ *
+ * \page xTaskNotifyGive xTaskNotifyGive
+ * \ingroup TaskNotifications
+ */
+signed portBASE_TYPE xTaskNotifyGive( xTaskHandle xTaskToNotify );
+
+/**
+ * task. h
+ * <pre>signed portBASE_TYPE xTaskNotifyFromISR( xTaskHandle xTaskToNotify, signed portBASE_TYPE *pxHigherPriorityTaskWoken );</pre>
+ *
+ * A version of xTaskNotifyGive() that can be called from an interrupt service
+ * routine.
+ *
+ * @param xTaskToNotify The handle of the task being notified.
+ *
+ * @param pxHigherPriorityTaskWoken xTaskNotifyFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if notifying the task caused it to
+ * unblock, and the unblocked task has a priority higher than the currently
+ * running task.  If xTaskNotifyFromISR() sets this value to pdTRUE
+ * then a context switch should be requested before the interrupt is exited.
+ *
+ * @return pdPASS.
+ *
+ * Example usage:
+   <pre>
+ void vRadioISR( void )
+ {
+ portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+     // Clear the interrupt source then tell the task there is data to read.
+     xTaskNotifyFromISR( xRadioTask, &xHigherPriorityTaskWoken );
+
+     portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
+ }
+   </pre>
+ * \page xTaskNotifyFromISR xTaskNotifyFromISR
+ * \ingroup TaskNotifications
+ */
+signed portBASE_TYPE xTaskNotifyFromISR( xTaskHandle xTaskToNotify, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+
+/**
+ * task. h
+ * <pre>unsigned portLONG ulTaskNotifyTake( portBASE_TYPE xClearCountOnExit, portTickType xTicksToWait );</pre>
+ *
+ * configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Wait for the notification count of the calling task to become non-zero,
+ * then either clear it or decrement it before returning.  Clearing the count
+ * gives the behaviour of a binary semaphore, decrementing it that of a
+ * counting semaphore.
+ *
+ * @param xClearCountOnExit If pdTRUE the count is cleared to zero on exit,
+ * otherwise it is decremented.
+ *
+ * @param xTicksToWait The maximum time to block waiting for the count to
+ * become non-zero.  The constant portTICK_RATE_MS can be used to convert a
+ * time in milliseconds.  If INCLUDE_vTaskSuspend is set to 1 a block time of
+ * portMAX_DELAY waits indefinitely.
+ *
+ * @return The count before it was cleared or decremented.  Zero means the
+ * block time expired before a notification was received.
+ *
+ * \page ulTaskNotifyTake ulTaskNotifyTake
+ * \ingroup TaskNotifications
+ */
+unsigned portLONG ulTaskNotifyTake( portBASE_TYPE xClearCountOnExit, portTickType xTicksToWait );
+
 
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
@@ -1092,6 +1264,35 @@ void vTaskPriorityInherit( xTaskHandle * const pxMutexHolder );
  */
 void vTaskPriorityDisinherit( xTaskHandle * const pxMutexHolder );
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
+ * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
+ * AN INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * configUSE_TICKLESS_IDLE must be set to 1 for this function to be available.
+ *
+ * Called from portSUPPRESS_TICKS_AND_SLEEP() once the processor wakes, to
+ * account for the tick interrupts that were suppressed while it slept.
+ * xTicksToJump must be less than the idle time that was passed into
+ * portSUPPRESS_TICKS_AND_SLEEP(), so the tick that unblocks the next task is
+ * still processed by vTaskIncrementTick().
+ */
+void vTaskStepTick( portTickType xTicksToJump );
+
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
+ * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
+ * AN INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * configUSE_TICKLESS_IDLE must be set to 1 for this function to be available.
+ *
+ * Called from portSUPPRESS_TICKS_AND_SLEEP() with interrupts disabled, just
+ * before the processor is put to sleep.  Returns pdFALSE if a task was readied,
+ * a yield was requested or a tick was missed after the idle task decided to
+ * sleep, in which case the port must abandon the sleep and return at once.
+ */
+portBASE_TYPE xTaskConfirmSleepModeStatus( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,426 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#ifndef INC_FREERTOS_H
+	#error "#include FreeRTOS.h" must appear in source files before "#include timers.h"
+#endif
+
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Software timers.  Timers are not processed in the tick interrupt.  Instead
+ * a single timer service task (the "daemon") keeps the active timers in a
+ * list sorted by expiry time, blocks until either the first of them expires
+ * or a command arrives on its command queue, and then runs the callback
+ * functions of the timers that have expired.  The functions below do nothing
+ * more than post a command to that queue.
+ *
+ * Timer callback functions execute in the context of the timer service task
+ * so must never block - for example they must not call vTaskDelay() or use a
+ * non zero block time when accessing a queue.
+ *
+ * The timer service task is created automatically by vTaskStartScheduler()
+ * when configUSE_TIMERS is set to 1.  Its priority, stack size and the length
+ * of its command queue are set by configTIMER_TASK_PRIORITY,
+ * configTIMER_TASK_STACK_DEPTH and configTIMER_QUEUE_LENGTH respectively.
+ */
+
+/* IDs for the commands that can be sent to the timer service task. */
+#define tmrCOMMAND_START					0
+#define tmrCOMMAND_STOP						1
+#define tmrCOMMAND_CHANGE_PERIOD			2
+#define tmrCOMMAND_DELETE					3
+
+/*-----------------------------------------------------------
+ * MACROS AND DEFINITIONS
+ *----------------------------------------------------------*/
+
+/**
+ * Type by which software timers are referenced.  For example, a call to
+ * xTimerCreate() returns an xTimerHandle variable that can then be used to
+ * reference the subject timer in calls to other software timer API functions
+ * (for example, xTimerStart(), xTimerReset(), etc.).
+ */
+typedef void * xTimerHandle;
+
+/* Define the prototype to which timer callback functions must conform. */
+typedef void (*tmrTIMER_CALLBACK)( xTimerHandle xTimer );
+
+/*-----------------------------------------------------------
+ * TIMER CREATION API
+ *----------------------------------------------------------*/
+
+/**
+ * timers. h
+ * <pre>
+ xTimerHandle xTimerCreate(
+                              const signed portCHAR *pcTimerName,
+                              portTickType xTimerPeriodInTicks,
+                              unsigned portBASE_TYPE uxAutoReload,
+                              void * pvTimerID,
+                              tmrTIMER_CALLBACK pxCallbackFunction
+                          );
+ * </pre>
+ *
+ * Creates a new software timer and returns a handle by which the timer can be
+ * referenced.  The timer is created in the dormant state - it does not run
+ * until xTimerStart() (or one of the other functions that start a timer) is
+ * called.
+ *
+ * @param pcTimerName A text name assigned to the timer.  Facilitates
+ * debugging only - the kernel does not use it.
+ *
+ * @param xTimerPeriodInTicks The timer period in ticks.  The constant
+ * portTICK_RATE_MS can be used to convert a time specified in milliseconds.
+ * Must be greater than 0.
+ *
+ * @param uxAutoReload If set to pdTRUE the timer will expire repeatedly with
+ * a frequency set by xTimerPeriodInTicks.  If set to pdFALSE the timer is a
+ * one-shot timer and enters the dormant state after it expires.
+ *
+ * @param pvTimerID An identifier assigned to the timer, which can be
+ * retrieved with pvTimerGetTimerID().  Allows the same callback function to
+ * be assigned to more than one timer.
+ *
+ * @param pxCallbackFunction The function to call when the timer expires.
+ *
+ * @return A handle to the created timer, or NULL if the timer could not be
+ * created because there was insufficient heap.
+ *
+ * Example usage:
+   <pre>
+ #define NUM_TIMERS 5
+
+ // An array to hold handles to the created timers.
+ xTimerHandle xTimers[ NUM_TIMERS ];
+
+ // Define a callback function that will be used by multiple timer instances.
+ void vTimerCallback( xTimerHandle pxTimer )
+ {
+ unsigned portBASE_TYPE uxWhichTimer;
+
+    // Which timer expired?
+    uxWhichTimer = ( unsigned portBASE_TYPE ) pvTimerGetTimerID( pxTimer );
+
+    // Do something for that timer - without blocking.
+ }
+
+ void main( void )
+ {
+ unsigned portBASE_TYPE ux;
+
+    // Create then start some timers.  Starting the timers before the scheduler
+    // has been started means the timers will start running immediately that
+    // the scheduler starts.
+    for( ux = 0; ux < NUM_TIMERS; ux++ )
+    {
+        xTimers[ ux ] = xTimerCreate( "Timer", ( 100 * ux ) + 100, pdTRUE, ( void * ) ux, vTimerCallback );
+
+        if( xTimers[ ux ] != NULL )
+        {
+            // The command queue is never full at this point, and a block
+            // time would be ignored before the scheduler is started anyway.
+            xTimerStart( xTimers[ ux ], 0 );
+        }
+    }
+
+    // Starting the scheduler will start the timers running as they have
+    // already been set into the active state.
+    vTaskStartScheduler();
+ }
+   </pre>
+ * \page xTimerCreate xTimerCreate
+ * \ingroup Timers
+ */
+xTimerHandle xTimerCreate( const signed portCHAR *pcTimerName, portTickType xTimerPeriodInTicks, unsigned portBASE_TYPE uxAutoReload, void * pvTimerID, tmrTIMER_CALLBACK pxCallbackFunction );
+
+/**
+ * timers. h
+ * <pre>void *pvTimerGetTimerID( xTimerHandle xTimer );</pre>
+ *
+ * @return The identifier that was assigned to the timer when it was created.
+ *
+ * \page pvTimerGetTimerID pvTimerGetTimerID
+ * \ingroup Timers
+ */
+void *pvTimerGetTimerID( xTimerHandle xTimer );
+
+/**
+ * timers. h
+ * <pre>portBASE_TYPE xTimerIsTimerActive( xTimerHandle xTimer );</pre>
+ *
+ * Queries a timer to see if it is active or dormant.  A timer is dormant if
+ * it has never been started, it has been stopped, or it is a one-shot timer
+ * that has expired and not been restarted.
+ *
+ * Commands are processed by the timer service task, so a timer will not show
+ * as active until the timer service task has processed the command that
+ * started it.
+ *
+ * @return pdFALSE if the timer is dormant, otherwise pdTRUE.
+ *
+ * \page xTimerIsTimerActive xTimerIsTimerActive
+ * \ingroup Timers
+ */
+portBASE_TYPE xTimerIsTimerActive( xTimerHandle xTimer );
+
+/*-----------------------------------------------------------
+ * TIMER CONTROL API
+ *----------------------------------------------------------*/
+
+/**
+ * timers. h
+ * <pre>portBASE_TYPE xTimerStart( xTimerHandle xTimer, portTickType xBlockTime );</pre>
+ *
+ * Starts a dormant timer, or restarts an active timer.  The timer will expire
+ * xTimerPeriodInTicks ticks after xTimerStart() was called - not after the
+ * timer service task processed the command.  If the timer expires without
+ * being stopped or reset then its callback function is called.
+ *
+ * xTimerStart() can be called before the scheduler is started, in which case
+ * the timer starts running when the scheduler starts.
+ *
+ * @param xTimer The handle of the timer being started/restarted.
+ *
+ * @param xBlockTime The time, in ticks, that the calling task should wait for
+ * space in the timer command queue should it already be full.  Ignored if
+ * called before the scheduler is started.
+ *
+ * @return pdFAIL if the command could not be sent to the timer command queue
+ * within xBlockTime ticks, otherwise pdPASS.
+ *
+ * \page xTimerStart xTimerStart
+ * \ingroup Timers
+ */
+#define xTimerStart( xTimer, xBlockTime ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_START, ( xTaskGetTickCount() ), NULL, ( xBlockTime ) )
+
+/**
+ * timers. h
+ * <pre>portBASE_TYPE xTimerStop( xTimerHandle xTimer, portTickType xBlockTime );</pre>
+ *
+ * Stops a timer that was previously started.  The timer enters the dormant
+ * state and its callback is not called.
+ *
+ * @param xTimer The handle of the timer being stopped.
+ *
+ * @param xBlockTime As xTimerStart().
+ *
+ * @return As xTimerStart().
+ *
+ * \page xTimerStop xTimerStop
+ * \ingroup Timers
+ */
+#define xTimerStop( xTimer, xBlockTime ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_STOP, 0U, NULL, ( xBlockTime ) )
+
+/**
+ * timers. h
+ * <pre>
+ portBASE_TYPE xTimerChangePeriod(
+                                     xTimerHandle xTimer,
+                                     portTickType xNewPeriod,
+                                     portTickType xBlockTime
+                                 );
+ * </pre>
+ *
+ * Changes the period of a timer.  If the timer is dormant it is also started,
+ * and in either case the new period is measured from the time the timer
+ * service task processes the command.
+ *
+ * @param xTimer The handle of the timer whose period is being changed.
+ *
+ * @param xNewPeriod The new period, in ticks.  Must be greater than 0.
+ *
+ * @param xBlockTime As xTimerStart().
+ *
+ * @return As xTimerStart().
+ *
+ * \page xTimerChangePeriod xTimerChangePeriod
+ * \ingroup Timers
+ */
+#define xTimerChangePeriod( xTimer, xNewPeriod, xBlockTime ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_CHANGE_PERIOD, ( xNewPeriod ), NULL, ( xBlockTime ) )
+
+/**
+ * timers. h
+ * <pre>portBASE_TYPE xTimerDelete( xTimerHandle xTimer, portTickType xBlockTime );</pre>
+ *
+ * Deletes a timer, freeing the memory that was allocated to it by
+ * xTimerCreate().  The handle must not be used once the command has been
+ * sent.
+ *
+ * @param xTimer The handle of the timer being deleted.
+ *
+ * @param xBlockTime As xTimerStart().
+ *
+ * @return As xTimerStart().
+ *
+ * \page xTimerDelete xTimerDelete
+ * \ingroup Timers
+ */
+#define xTimerDelete( xTimer, xBlockTime ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_DELETE, 0U, NULL, ( xBlockTime ) )
+
+/**
+ * timers. h
+ * <pre>portBASE_TYPE xTimerReset( xTimerHandle xTimer, portTickType xBlockTime );</pre>
+ *
+ * Re-starts a timer so it next expires xTimerPeriodInTicks ticks from now.
+ * Equivalent to xTimerStart(), but clearer when used to hold off a timeout -
+ * for example a back light that should only turn off once no key has been
+ * pressed for 5 seconds.
+ *
+ * \page xTimerReset xTimerReset
+ * \ingroup Timers
+ */
+#define xTimerReset( xTimer, xBlockTime ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_START, ( xTaskGetTickCount() ), NULL, ( xBlockTime ) )
+
+/**
+ * timers. h
+ * <pre>
+ portBASE_TYPE xTimerStartFromISR(
+                                     xTimerHandle xTimer,
+                                     signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                 );
+ * </pre>
+ *
+ * A version of xTimerStart() that can be called from an interrupt service
+ * routine.  The expiry time is measured from the tick at which the interrupt
+ * called xTimerStartFromISR().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the command
+ * unblocked the timer service task and the timer service task has a priority
+ * higher than the interrupted task, in which case a context switch should be
+ * requested before the interrupt exits.
+ *
+ * \page xTimerStartFromISR xTimerStartFromISR
+ * \ingroup Timers
+ */
+#define xTimerStartFromISR( xTimer, pxHigherPriorityTaskWoken ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_START, ( xTaskGetTickCountFromISR() ), ( pxHigherPriorityTaskWoken ), 0U )
+
+/**
+ * timers. h
+ * <pre>
+ portBASE_TYPE xTimerStopFromISR(
+                                    xTimerHandle xTimer,
+                                    signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                );
+ * </pre>
+ *
+ * A version of xTimerStop() that can be called from an interrupt service
+ * routine.  See xTimerStartFromISR() for pxHigherPriorityTaskWoken.
+ *
+ * \page xTimerStopFromISR xTimerStopFromISR
+ * \ingroup Timers
+ */
+#define xTimerStopFromISR( xTimer, pxHigherPriorityTaskWoken ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_STOP, 0U, ( pxHigherPriorityTaskWoken ), 0U )
+
+/**
+ * timers. h
+ * <pre>
+ portBASE_TYPE xTimerChangePeriodFromISR(
+                                            xTimerHandle xTimer,
+                                            portTickType xNewPeriod,
+                                            signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                        );
+ * </pre>
+ *
+ * A version of xTimerChangePeriod() that can be called from an interrupt
+ * service routine.  See xTimerStartFromISR() for pxHigherPriorityTaskWoken.
+ *
+ * \page xTimerChangePeriodFromISR xTimerChangePeriodFromISR
+ * \ingroup Timers
+ */
+#define xTimerChangePeriodFromISR( xTimer, xNewPeriod, pxHigherPriorityTaskWoken ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_CHANGE_PERIOD, ( xNewPeriod ), ( pxHigherPriorityTaskWoken ), 0U )
+
+/**
+ * timers. h
+ * <pre>
+ portBASE_TYPE xTimerResetFromISR(
+                                     xTimerHandle xTimer,
+                                     signed portBASE_TYPE *pxHigherPriorityTaskWoken
+                                 );
+ * </pre>
+ *
+ * A version of xTimerReset() that can be called from an interrupt service
+ * routine.  See xTimerStartFromISR() for pxHigherPriorityTaskWoken.
+ *
+ * \page xTimerResetFromISR xTimerResetFromISR
+ * \ingroup Timers
+ */
+#define xTimerResetFromISR( xTimer, pxHigherPriorityTaskWoken ) xTimerGenericCommand( ( xTimer ), tmrCOMMAND_START, ( xTaskGetTickCountFromISR() ), ( pxHigherPriorityTaskWoken ), 0U )
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the kernel only.
+ */
+
+/*
+ * Creates the timer service task and its command queue.  Called by
+ * vTaskStartScheduler() when configUSE_TIMERS is set to 1.
+ */
+portBASE_TYPE xTimerCreateTimerTask( void );
+
+/*
+ * Sends a command to the timer service task.  Use the macros above rather
+ * than calling this directly.  If pxHigherPriorityTaskWoken is NULL the
+ * command is sent from a task, otherwise it is sent from an ISR and
+ * xBlockTime is ignored.
+ */
+portBASE_TYPE xTimerGenericCommand( xTimerHandle xTimer, portBASE_TYPE xCommandID, portTickType xOptionalValue, signed portBASE_TYPE *pxHigherPriorityTaskWoken, portTickType xBlockTime );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMERS_H */
+
@@ -0,0 +1,326 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#ifndef INC_FREERTOS_H
+	#error "#include FreeRTOS.h" must appear in source files before "#include trace.h"
+#endif
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The binary trace recorder.
+ *
+ * When configUSE_TRACE_RECORDER is set to 1 in FreeRTOSConfig.h this header
+ * is included by FreeRTOS.h and defines the kernel trace macros so that
+ * context switches, queue, semaphore and mutex activity (including that from
+ * interrupts), delays and priority inheritance are written into a ring buffer
+ * in RAM.  Each event is one fixed size eight byte record holding a
+ * timestamp, an event code, the running task and the object the event
+ * relates to.  Writing a record takes a few tens of instructions so the
+ * recorder can be left running in the field.
+ *
+ * Recording starts as soon as the program starts.  The buffer is a single
+ * structure, xTraceRecorderBuffer, that describes itself.  To look at a
+ * trace, copy the structure to a file - using the debugger, by
+ * calling pvTraceGetBuffer() and ulTraceGetBufferSize(), or over whatever
+ * link the application has - then convert it with the tracedecode utility in
+ * the TraceCon directory.  tracedecode produces a Chrome trace event file
+ * that shows when each task ran, what it was blocked on and where it
+ * inherited a priority.
+ *
+ * Tasks are named in the trace by their task name.  Queues, semaphores and
+ * mutexes are named by the name given to vQueueAddToRegistry(), so
+ * configQUEUE_REGISTRY_SIZE should be non zero.
+ *
+ * The following must be defined in FreeRTOSConfig.h:
+ *
+ * configTRACE_TIMESTAMP_HZ - the frequency of the timestamp counter.
+ *
+ * The following are optional:
+ *
+ * configTRACE_TIMESTAMP() - returns the timestamp of an event.  Defaults to
+ * portGET_RUN_TIME_COUNTER_VALUE(), in which case configGENERATE_RUN_TIME_STATS
+ * must also be set.  Only the low 32 bits are recorded.
+ *
+ * configTRACE_BUFFER_RECORDS - the number of records the ring buffer holds.
+ * Once full the oldest records are overwritten.
+ *
+ * configTRACE_MAX_TASKS, configTRACE_MAX_QUEUES - how many task and queue
+ * names are kept.  Objects numbered beyond these are traced unnamed.
+ */
+
+#ifndef configTRACE_TIMESTAMP_HZ
+	#error configTRACE_TIMESTAMP_HZ must be defined when configUSE_TRACE_RECORDER is 1.  It is the frequency of the counter returned by configTRACE_TIMESTAMP().
+#endif
+
+#ifndef configTRACE_TIMESTAMP
+	#if ( configGENERATE_RUN_TIME_STATS != 1 )
+		#error configTRACE_TIMESTAMP() defaults to the run time stats counter, so either define configTRACE_TIMESTAMP() or set configGENERATE_RUN_TIME_STATS to 1.
+	#endif
+	#define configTRACE_TIMESTAMP() portGET_RUN_TIME_COUNTER_VALUE()
+#endif
+
+#ifndef configTRACE_BUFFER_RECORDS
+	#define configTRACE_BUFFER_RECORDS 256
+#endif
+
+#ifndef configTRACE_MAX_TASKS
+	#define configTRACE_MAX_TASKS 16
+#endif
+
+#ifndef configTRACE_MAX_QUEUES
+	#define configTRACE_MAX_QUEUES 16
+#endif
+
+#if ( configTRACE_MAX_TASKS > 255 ) || ( configTRACE_MAX_QUEUES > 255 )
+	#error configTRACE_MAX_TASKS and configTRACE_MAX_QUEUES cannot be more than 255.
+#endif
+
+/* Identifies the buffer, and shows the byte order of the target. */
+#define traceMAGIC							( 0x52545246UL )	/* "FRTR" when little endian. */
+#define traceVERSION						( 1 )
+
+/* The task number recorded before the scheduler has selected a task. */
+#define traceNO_TASK						( ( uint8_t ) 0xff )
+
+/* The kinds of object a queue number can refer to. */
+#define traceQUEUE_TYPE_QUEUE				( 1 )
+#define traceQUEUE_TYPE_SEMAPHORE			( 2 )
+#define traceQUEUE_TYPE_MUTEX				( 3 )
+
+/* The event codes.  ucTask is the task that was running when the event
+occurred.  The meaning of usObject depends on the event:
+
+traceEVENT_SWITCH - ucTask has been switched in, usObject is the task that
+was switched out.
+
+Task events - usObject is the number of the task acted upon in the low byte
+and, for the priority events, its new priority in the high byte.
+
+Queue events - usObject is the queue number. */
+#define traceEVENT_SWITCH					( 0x01 )
+#define traceEVENT_TASK_CREATE				( 0x02 )
+#define traceEVENT_TASK_DELETE				( 0x03 )
+#define traceEVENT_TASK_DELAY				( 0x04 )
+#define traceEVENT_TASK_DELAY_UNTIL			( 0x05 )
+#define traceEVENT_TASK_SUSPEND				( 0x06 )
+#define traceEVENT_TASK_RESUME				( 0x07 )
+#define traceEVENT_TASK_RESUME_FROM_ISR		( 0x08 )
+#define traceEVENT_TASK_PRIORITY_SET		( 0x09 )
+#define traceEVENT_TASK_PRIORITY_INHERIT	( 0x0a )
+#define traceEVENT_TASK_PRIORITY_DISINHERIT	( 0x0b )
+
+#define traceEVENT_QUEUE_SEND				( 0x10 )
+#define traceEVENT_QUEUE_SEND_FAILED		( 0x11 )
+#define traceEVENT_QUEUE_RECEIVE			( 0x12 )
+#define traceEVENT_QUEUE_RECEIVE_FAILED		( 0x13 )
+#define traceEVENT_QUEUE_PEEK				( 0x14 )
+#define traceEVENT_BLOCKING_ON_QUEUE_SEND	( 0x15 )
+#define traceEVENT_BLOCKING_ON_QUEUE_RECEIVE	( 0x16 )
+#define traceEVENT_QUEUE_SEND_FROM_ISR		( 0x17 )
+#define traceEVENT_QUEUE_SEND_FROM_ISR_FAILED	( 0x18 )
+#define traceEVENT_QUEUE_RECEIVE_FROM_ISR	( 0x19 )
+#define traceEVENT_QUEUE_RECEIVE_FROM_ISR_FAILED	( 0x1a )
+
+/* One event.  Eight bytes on every port. */
+typedef struct xTRACE_RECORD
+{
+	uint32_t ulTimestamp;					/*< The low 32 bits of configTRACE_TIMESTAMP(). */
+	uint8_t ucEvent;						/*< One of the traceEVENT_ codes. */
+	uint8_t ucTask;							/*< The task running when the event occurred. */
+	uint16_t usObject;						/*< Depends on ucEvent, see above. */
+} xTraceRecord;
+
+/* The start of the buffer.  The records follow, then the task names, the
+queue names and the queue types. */
+typedef struct xTRACE_HEADER
+{
+	uint32_t ulMagic;						/*< traceMAGIC. */
+	uint16_t usVersion;						/*< traceVERSION. */
+	uint16_t usRecordSize;					/*< sizeof( xTraceRecord ). */
+	uint32_t ulTimestampHz;					/*< configTRACE_TIMESTAMP_HZ. */
+	uint32_t ulRecords;						/*< configTRACE_BUFFER_RECORDS. */
+	uint32_t ulNextRecord;					/*< The index the next record will be written to. */
+	uint32_t ulRecordsWritten;				/*< The number of records written since recording started.  Greater than ulRecords once the buffer has wrapped. */
+	uint8_t ucMaxTasks;						/*< configTRACE_MAX_TASKS. */
+	uint8_t ucMaxQueues;					/*< configTRACE_MAX_QUEUES. */
+	uint8_t ucNameLength;					/*< configMAX_TASK_NAME_LEN. */
+	uint8_t ucRecording;					/*< Non zero while events are being recorded. */
+} xTraceHeader;
+
+typedef struct xTRACE_BUFFER
+{
+	xTraceHeader xHeader;
+	xTraceRecord xRecords[ configTRACE_BUFFER_RECORDS ];
+	char cTaskNames[ configTRACE_MAX_TASKS ][ configMAX_TASK_NAME_LEN ];
+	char cQueueNames[ configTRACE_MAX_QUEUES ][ configMAX_TASK_NAME_LEN ];
+	uint8_t ucQueueTypes[ configTRACE_MAX_QUEUES ];
+} xTraceBuffer;
+
+/**
+ * trace. h
+ * <pre>void vTraceStart( void );</pre>
+ *
+ * Empty the buffer and start recording again after vTraceStop().  Task and
+ * queue names are kept.
+ *
+ * \page vTraceStart vTraceStart
+ * \ingroup TraceRecorder
+ */
+void vTraceStart( void );
+
+/**
+ * trace. h
+ * <pre>void vTraceStop( void );</pre>
+ *
+ * Stop recording, leaving the buffer holding the events that led up to the
+ * call.  Call this when a fault is detected so the events that caused it are
+ * not overwritten before the buffer is read.
+ *
+ * \page vTraceStop vTraceStop
+ * \ingroup TraceRecorder
+ */
+void vTraceStop( void );
+
+/**
+ * trace. h
+ * <pre>void *pvTraceGetBuffer( void );</pre>
+ *
+ * @return The address of the trace buffer.  Copy ulTraceGetBufferSize()
+ * bytes from this address to obtain a file that tracedecode can read.
+ * Recording should be stopped first.
+ *
+ * \page pvTraceGetBuffer pvTraceGetBuffer
+ * \ingroup TraceRecorder
+ */
+void *pvTraceGetBuffer( void );
+
+/**
+ * trace. h
+ * <pre>unsigned portLONG ulTraceGetBufferSize( void );</pre>
+ *
+ * @return The size of the trace buffer in bytes.
+ *
+ * \page ulTraceGetBufferSize ulTraceGetBufferSize
+ * \ingroup TraceRecorder
+ */
+unsigned portLONG ulTraceGetBufferSize( void );
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the kernel trace macros only.
+ */
+void vTraceTaskSwitchedIn( uint8_t ucTask );
+void vTraceTaskCreated( uint8_t ucTask, const signed portCHAR *pcName );
+uint8_t ucTraceQueueCreated( uint8_t ucType );
+void vTraceSetQueueName( uint8_t ucQueue, const signed portCHAR *pcName );
+void vTraceRecordEvent( uint8_t ucEvent, uint16_t usObject );
+
+/* The task the most recent switch record switched in. */
+extern volatile uint8_t ucTraceCurrentTask;
+
+/*
+ * The kernel trace macros.  These are expanded inside tasks.c and queue.c so
+ * can access the TCB and queue structures.
+ */
+#define traceTASK_NUMBER( pxTCB )			( ( uint8_t ) ( pxTCB )->uxTCBNumber )
+
+/* The switch record written when a different task is switched in names both
+tasks, so nothing needs to be recorded when the old task is switched out.
+Nothing is recorded at all when the scheduler selects the task that was
+already running. */
+#define traceTASK_SWITCHED_IN()																		\
+	if( traceTASK_NUMBER( pxCurrentTCB ) != ucTraceCurrentTask )									\
+	{																								\
+		vTraceTaskSwitchedIn( traceTASK_NUMBER( pxCurrentTCB ) );									\
+	}
+
+#define traceTASK_CREATE( pxNewTCB )			vTraceTaskCreated( traceTASK_NUMBER( pxNewTCB ), ( pxNewTCB )->pcTaskName )
+#define traceTASK_DELETE( pxTaskToDelete )		vTraceRecordEvent( traceEVENT_TASK_DELETE, traceTASK_NUMBER( pxTaskToDelete ) )
+#define traceTASK_DELAY()						vTraceRecordEvent( traceEVENT_TASK_DELAY, traceTASK_NUMBER( pxCurrentTCB ) )
+#define traceTASK_DELAY_UNTIL()					vTraceRecordEvent( traceEVENT_TASK_DELAY_UNTIL, traceTASK_NUMBER( pxCurrentTCB ) )
+#define traceTASK_SUSPEND( pxTaskToSuspend )	vTraceRecordEvent( traceEVENT_TASK_SUSPEND, traceTASK_NUMBER( pxTaskToSuspend ) )
+#define traceTASK_RESUME( pxTaskToResume )		vTraceRecordEvent( traceEVENT_TASK_RESUME, traceTASK_NUMBER( pxTaskToResume ) )
+#define traceTASK_RESUME_FROM_ISR( pxTaskToResume )	vTraceRecordEvent( traceEVENT_TASK_RESUME_FROM_ISR, traceTASK_NUMBER( pxTaskToResume ) )
+
+#define traceTASK_PRIORITY( pxTCB, uxPriority )	( ( uint16_t ) ( traceTASK_NUMBER( pxTCB ) | ( ( uint16_t ) ( uxPriority ) << 8 ) ) )
+#define traceTASK_PRIORITY_SET( pxTask, uxNewPriority )			vTraceRecordEvent( traceEVENT_TASK_PRIORITY_SET, traceTASK_PRIORITY( prvGetTCBFromHandle( pxTask ), uxNewPriority ) )
+#define traceTASK_PRIORITY_INHERIT( pxTCB, uxInheritedPriority )	vTraceRecordEvent( traceEVENT_TASK_PRIORITY_INHERIT, traceTASK_PRIORITY( pxTCB, uxInheritedPriority ) )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxBasePriority )		vTraceRecordEvent( traceEVENT_TASK_PRIORITY_DISINHERIT, traceTASK_PRIORITY( pxTCB, uxBasePriority ) )
+
+/* Queues are numbered as they are created.  Item size 0 distinguishes a
+semaphore from a queue. */
+#define traceQUEUE_CREATE( pxNewQueue )		( pxNewQueue )->ucQueueNumber = ucTraceQueueCreated( ( ( pxNewQueue )->uxItemSize == 0 ) ? traceQUEUE_TYPE_SEMAPHORE : traceQUEUE_TYPE_QUEUE )
+#define traceCREATE_MUTEX( pxNewQueue )		( pxNewQueue )->ucQueueNumber = ucTraceQueueCreated( traceQUEUE_TYPE_MUTEX )
+#define traceQUEUE_REGISTRY_ADD( pxQueue, pcQueueName )	vTraceSetQueueName( ( pxQueue )->ucQueueNumber, ( pcQueueName ) )
+
+#define traceQUEUE_SEND( pxQueue )							vTraceRecordEvent( traceEVENT_QUEUE_SEND, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_SEND_FAILED( pxQueue )					vTraceRecordEvent( traceEVENT_QUEUE_SEND_FAILED, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_RECEIVE( pxQueue )						vTraceRecordEvent( traceEVENT_QUEUE_RECEIVE, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )				vTraceRecordEvent( traceEVENT_QUEUE_RECEIVE_FAILED, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_PEEK( pxQueue )							vTraceRecordEvent( traceEVENT_QUEUE_PEEK, ( pxQueue )->ucQueueNumber )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )				vTraceRecordEvent( traceEVENT_BLOCKING_ON_QUEUE_SEND, ( pxQueue )->ucQueueNumber )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )			vTraceRecordEvent( traceEVENT_BLOCKING_ON_QUEUE_RECEIVE, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )					vTraceRecordEvent( traceEVENT_QUEUE_SEND_FROM_ISR, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )			vTraceRecordEvent( traceEVENT_QUEUE_SEND_FROM_ISR_FAILED, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )				vTraceRecordEvent( traceEVENT_QUEUE_RECEIVE_FROM_ISR, ( pxQueue )->ucQueueNumber )
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )		vTraceRecordEvent( traceEVENT_QUEUE_RECEIVE_FROM_ISR_FAILED, ( pxQueue )->ucQueueNumber )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
+
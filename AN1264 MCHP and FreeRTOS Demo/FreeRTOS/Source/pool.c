@@ -0,0 +1,326 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "pool.h"
+
+/*-----------------------------------------------------------
+ * PUBLIC POOL API documented in pool.h
+ *----------------------------------------------------------*/
+
+/* Each block is preceded by a header that records the pool the block belongs
+to.  The header is padded so the application part of the block keeps the
+alignment required by the port. */
+typedef union xPOOL_BLOCK_HEADER
+{
+	struct xPOOL *pxPool;
+	#if portBYTE_ALIGNMENT == 8
+		portDOUBLE dDummy;
+	#else
+		unsigned portLONG ulDummy;
+	#endif
+} xPoolBlockHeader;
+
+#define poolHEADER_SIZE		( ( ( sizeof( xPoolBlockHeader ) + portBYTE_ALIGNMENT - 1 ) / portBYTE_ALIGNMENT ) * portBYTE_ALIGNMENT )
+
+/* A free block holds the pointer to the next free block at its start. */
+#define poolNEXT_FREE( pvBlock )	( *( ( void ** ) ( pvBlock ) ) )
+
+/*
+ * Definition of a pool.  The free blocks are linked through their own memory,
+ * so taking or returning a block is a few pointer moves in a critical
+ * section.  Tasks only use the semaphore when the pool is empty: it is given
+ * when a block is released while a task is waiting, and the task that takes
+ * it wakes the next waiter if blocks remain.
+ */
+typedef struct xPOOL
+{
+	void * volatile pvFreeList;						/*< The first free block, or NULL if the pool is empty. */
+	volatile unsigned portBASE_TYPE uxFreeBlocks;	/*< The number of blocks in the free list. */
+	volatile unsigned portBASE_TYPE uxWaiting;		/*< The number of tasks waiting in pvPoolAllocate(). */
+	xSemaphoreHandle xBlockReleased;				/*< Given when a block is released while a task waits. */
+	unsigned portBASE_TYPE uxBlockSize;				/*< The size of each block including its header. */
+	unsigned portCHAR *pucBlocks;					/*< The memory the blocks are carved from. */
+} xPOOL;
+
+/*
+ * Take the first block from the free list, or return NULL if the list is
+ * empty.  Called from a critical section or with interrupts masked.
+ */
+static void *prvPoolTake( xPOOL *pxPool );
+
+/*
+ * Put a block at the front of the free list and return the number of tasks
+ * waiting for one.  Called from a critical section or with interrupts masked.
+ */
+static unsigned portBASE_TYPE prvPoolPut( xPOOL *pxPool, void *pvBlock );
+
+/*-----------------------------------------------------------*/
+
+xPoolHandle xPoolCreate( unsigned portBASE_TYPE uxNumberOfBlocks, unsigned portBASE_TYPE uxBlockSize )
+{
+xPOOL *pxNewPool = NULL;
+unsigned portBASE_TYPE ux;
+
+	if( ( uxNumberOfBlocks > ( unsigned portBASE_TYPE ) 0 ) && ( uxBlockSize > ( unsigned portBASE_TYPE ) 0 ) )
+	{
+		pxNewPool = ( xPOOL * ) pvPortMalloc( sizeof( xPOOL ) );
+		if( pxNewPool != NULL )
+		{
+			/* A free block holds the next pointer, so must be big enough for
+			one.  Round the block size up so every block starts on an aligned
+			address, then add the header. */
+			if( uxBlockSize < sizeof( void * ) )
+			{
+				uxBlockSize = sizeof( void * );
+			}
+			uxBlockSize = ( ( uxBlockSize + portBYTE_ALIGNMENT - 1 ) / portBYTE_ALIGNMENT ) * portBYTE_ALIGNMENT;
+			pxNewPool->uxBlockSize = uxBlockSize + poolHEADER_SIZE;
+
+			pxNewPool->pucBlocks = ( unsigned portCHAR * ) pvPortMalloc( ( size_t ) uxNumberOfBlocks * ( size_t ) pxNewPool->uxBlockSize );
+			if( pxNewPool->pucBlocks != NULL )
+			{
+				vSemaphoreCreateBinary( pxNewPool->xBlockReleased );
+				if( pxNewPool->xBlockReleased != NULL )
+				{
+					/* The semaphore is created given, but no block has been
+					released yet. */
+					xSemaphoreTake( pxNewPool->xBlockReleased, 0 );
+					pxNewPool->uxWaiting = 0;
+
+					/* Initially every block is free, linked in address
+					order. */
+					pxNewPool->pvFreeList = NULL;
+					pxNewPool->uxFreeBlocks = 0;
+					for( ux = uxNumberOfBlocks; ux > 0; ux-- )
+					{
+						( ( xPoolBlockHeader * ) ( pxNewPool->pucBlocks + ( ( ux - 1 ) * pxNewPool->uxBlockSize ) ) )->pxPool = pxNewPool;
+						prvPoolPut( pxNewPool, ( void * ) ( pxNewPool->pucBlocks + ( ( ux - 1 ) * pxNewPool->uxBlockSize ) + poolHEADER_SIZE ) );
+					}
+				}
+				else
+				{
+					vPortFree( pxNewPool->pucBlocks );
+					vPortFree( pxNewPool );
+					pxNewPool = NULL;
+				}
+			}
+			else
+			{
+				vPortFree( pxNewPool );
+				pxNewPool = NULL;
+			}
+		}
+	}
+
+	return ( xPoolHandle ) pxNewPool;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPoolAllocate( xPoolHandle xPool, portTickType xTicksToWait )
+{
+xPOOL *pxPool = ( xPOOL * ) xPool;
+void *pvBlock;
+xTimeOutType xTimeOut;
+portBASE_TYPE xEntryTimeSet = pdFALSE, xWakeNext;
+
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			pvBlock = prvPoolTake( pxPool );
+			if( ( pvBlock == NULL ) && ( xTicksToWait != ( portTickType ) 0 ) )
+			{
+				( pxPool->uxWaiting )++;
+			}
+
+			/* Only one waiter is woken per release, so a woken task that
+			finds blocks left passes the wake on. */
+			xWakeNext = ( ( xEntryTimeSet != pdFALSE ) && ( pvBlock != NULL ) && ( pxPool->pvFreeList != NULL ) && ( pxPool->uxWaiting > ( unsigned portBASE_TYPE ) 0 ) );
+		}
+		taskEXIT_CRITICAL();
+
+		if( xWakeNext != pdFALSE )
+		{
+			xSemaphoreGive( pxPool->xBlockReleased );
+		}
+
+		if( ( pvBlock != NULL ) || ( xTicksToWait == ( portTickType ) 0 ) )
+		{
+			break;
+		}
+
+		/* The pool is empty, so wait for a block to be released.  Another
+		task may still take it first, in which case this one waits again for
+		the rest of its time. */
+		if( xEntryTimeSet == pdFALSE )
+		{
+			vTaskSetTimeOutState( &xTimeOut );
+			xEntryTimeSet = pdTRUE;
+		}
+		xSemaphoreTake( pxPool->xBlockReleased, xTicksToWait );
+
+		taskENTER_CRITICAL();
+		{
+			( pxPool->uxWaiting )--;
+		}
+		taskEXIT_CRITICAL();
+
+		/* Try once more without blocking once the time is up. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+		{
+			xTicksToWait = 0;
+		}
+	}
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPoolAllocateFromISR( xPoolHandle xPool )
+{
+xPOOL *pxPool = ( xPOOL * ) xPool;
+void *pvBlock;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	/* Taking a block cannot unblock a task, as tasks only ever wait for the
+	pool to become non-empty. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		pvBlock = prvPoolTake( pxPool );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vPoolRelease( void *pvBlock )
+{
+xPOOL *pxPool;
+unsigned portBASE_TYPE uxWaiting;
+
+	if( pvBlock != NULL )
+	{
+		pxPool = ( ( xPoolBlockHeader * ) ( ( ( unsigned portCHAR * ) pvBlock ) - poolHEADER_SIZE ) )->pxPool;
+
+		taskENTER_CRITICAL();
+		{
+			uxWaiting = prvPoolPut( pxPool, pvBlock );
+		}
+		taskEXIT_CRITICAL();
+
+		/* The semaphore is only touched when a task is waiting.  If it has
+		already been given the give fails, which does not matter as the task
+		it wakes passes the wake on. */
+		if( uxWaiting > ( unsigned portBASE_TYPE ) 0 )
+		{
+			xSemaphoreGive( pxPool->xBlockReleased );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPoolReleaseFromISR( void *pvBlock, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xPOOL *pxPool;
+unsigned portBASE_TYPE uxSavedInterruptStatus, uxWaiting;
+
+	if( pvBlock != NULL )
+	{
+		pxPool = ( ( xPoolBlockHeader * ) ( ( ( unsigned portCHAR * ) pvBlock ) - poolHEADER_SIZE ) )->pxPool;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			uxWaiting = prvPoolPut( pxPool, pvBlock );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		if( uxWaiting > ( unsigned portBASE_TYPE ) 0 )
+		{
+			xSemaphoreGiveFromISR( pxPool->xBlockReleased, pxHigherPriorityTaskWoken );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+unsigned portBASE_TYPE uxPoolBlocksAvailable( xPoolHandle xPool )
+{
+	return ( ( xPOOL * ) xPool )->uxFreeBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvPoolTake( xPOOL *pxPool )
+{
+void *pvBlock;
+
+	pvBlock = pxPool->pvFreeList;
+	if( pvBlock != NULL )
+	{
+		pxPool->pvFreeList = poolNEXT_FREE( pvBlock );
+		( pxPool->uxFreeBlocks )--;
+	}
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+static unsigned portBASE_TYPE prvPoolPut( xPOOL *pxPool, void *pvBlock )
+{
+	poolNEXT_FREE( pvBlock ) = pxPool->pvFreeList;
+	pxPool->pvFreeList = pvBlock;
+	( pxPool->uxFreeBlocks )++;
+
+	return pxPool->uxWaiting;
+}
+/*-----------------------------------------------------------*/
+
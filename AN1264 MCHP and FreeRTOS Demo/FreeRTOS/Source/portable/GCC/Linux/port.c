@@ -0,0 +1,521 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the Linux simulator
+ * port.
+ *
+ * Every task runs on its own host stack and is switched with the ucontext
+ * primitives.  The tick is generated by an interval timer delivering SIGALRM,
+ * and the signal handler plays the part of the tick interrupt.  SIGIO plays
+ * the part of a peripheral interrupt, running the handler installed with
+ * vPortSetIOInterruptHandler().  Masking both signals is the equivalent of
+ * disabling interrupts on the real hardware.
+ *----------------------------------------------------------*/
+
+/* Standard includes. */
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The signal used to generate the tick. */
+#define portTICK_SIGNAL				SIGALRM
+
+/* The signal used for the simulated peripheral interrupt. */
+#define portIO_SIGNAL				SIGIO
+
+/* The interval between ticks, in microseconds. */
+#define portTICK_PERIOD_US			( 1000000UL / configTICK_RATE_HZ )
+
+/* The longest a tickless sleep is allowed to last, in ticks.  This keeps the
+reprogrammed timer value well within the range of a struct timeval. */
+#define portMAX_SUPPRESSED_TICKS	( ( portTickType ) 0x7fff )
+
+/* Everything needed to resume a task.  A pointer to one of these structures
+is stored at the top of the stack allocated by the kernel. */
+typedef struct xPORT_TASK_CONTEXT
+{
+	ucontext_t xContext;			/*< Register and signal mask state of the task. */
+	pdTASK_CODE pxCode;				/*< The function implementing the task. */
+	void *pvParameters;				/*< The parameter passed to pxCode. */
+	void *pvHostStack;				/*< The stack the task actually runs on. */
+} xPortTaskContext;
+
+/* Obtain the context of a task from its TCB.  The first member of the TCB is
+always pxTopOfStack, which points to the context pointer. */
+#define portTCB_CONTEXT( pxTCB )	( ( xPortTaskContext * ) ( **( portSTACK_TYPE ** ) ( pxTCB ) ) )
+
+/* The context of main(), returned to when the scheduler is ended. */
+static ucontext_t xSchedulerContext;
+
+/* The signal dispositions that were in place before the scheduler started. */
+static struct sigaction xOldTickAction;
+static struct sigaction xOldIOAction;
+
+/* The handler run by the simulated peripheral interrupt, if any. */
+static void ( * volatile pxIOInterruptHandler )( void ) = NULL;
+
+/* Set by vPortYieldFromISR() so the tick handler knows to select a new task
+before returning. */
+static volatile portBASE_TYPE xYieldPending = pdFALSE;
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+	/* Set by the tick handler so a tickless sleep can tell whether it ran
+	its full length or was ended early by the I/O interrupt. */
+	static volatile portBASE_TYPE xTickDelivered = pdFALSE;
+
+#endif
+
+extern void * volatile pxCurrentTCB;
+
+/*
+ * The tick interrupt.  Increments the tick then, if the preemptive scheduler
+ * is used or an ISR requested it, selects the next task to execute.
+ */
+static void prvTickSignalHandler( int iSignal );
+
+/*
+ * The simulated peripheral interrupt.  Runs pxIOInterruptHandler then, if it
+ * woke a higher priority task, selects the next task to execute.
+ */
+static void prvIOSignalHandler( int iSignal );
+
+/*
+ * Start executing a task the first time it is switched in.
+ */
+static void prvTaskEntryPoint( void );
+
+/*
+ * Select the task to run next and switch to it if it is not the task that is
+ * already running.  Must be called with interrupts blocked.
+ */
+static void prvSwitchContext( void );
+
+/*
+ * Block the tick and I/O signals, optionally returning the previous signal
+ * mask.
+ */
+static void prvBlockInterrupts( sigset_t *pxOldMask );
+
+/*
+ * Return non-zero if the tick signal is blocked and waiting to be delivered.
+ */
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+	static int prvTickSignalPending( void );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+portSTACK_TYPE *pxPortInitialiseStack( portSTACK_TYPE *pxTopOfStack, pdTASK_CODE pxCode, void *pvParameters )
+{
+xPortTaskContext *pxContext;
+sigset_t xOldMask;
+
+	/* The host allocator is not reentrant, so make sure a tick cannot switch
+	to another task that might also be using it. */
+	prvBlockInterrupts( &xOldMask );
+	{
+		pxContext = ( xPortTaskContext * ) malloc( sizeof( xPortTaskContext ) );
+		if( pxContext != NULL )
+		{
+			pxContext->pvHostStack = malloc( portHOST_STACK_SIZE );
+		}
+	}
+	sigprocmask( SIG_SETMASK, &xOldMask, NULL );
+
+	if( ( pxContext == NULL ) || ( pxContext->pvHostStack == NULL ) )
+	{
+		/* There is no way of reporting the failure to the kernel. */
+		abort();
+	}
+
+	pxContext->pxCode = pxCode;
+	pxContext->pvParameters = pvParameters;
+
+	getcontext( &( pxContext->xContext ) );
+	pxContext->xContext.uc_stack.ss_sp = pxContext->pvHostStack;
+	pxContext->xContext.uc_stack.ss_size = portHOST_STACK_SIZE;
+	pxContext->xContext.uc_link = NULL;
+
+	/* Tasks start with interrupts enabled. */
+	sigdelset( &( pxContext->xContext.uc_sigmask ), portTICK_SIGNAL );
+	sigdelset( &( pxContext->xContext.uc_sigmask ), portIO_SIGNAL );
+	makecontext( &( pxContext->xContext ), prvTaskEntryPoint, 0 );
+
+	*pxTopOfStack = ( portSTACK_TYPE ) pxContext;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortStartScheduler( void )
+{
+struct sigaction xTickAction, xIOAction;
+struct itimerval xTimer;
+
+	/* Interrupts will have been disabled by the time we get here, so the
+	first tick cannot occur before the first task is running.  Neither
+	handler can interrupt the other. */
+	xTickAction.sa_handler = prvTickSignalHandler;
+	xTickAction.sa_flags = SA_RESTART;
+	sigemptyset( &( xTickAction.sa_mask ) );
+	sigaddset( &( xTickAction.sa_mask ), portTICK_SIGNAL );
+	sigaddset( &( xTickAction.sa_mask ), portIO_SIGNAL );
+	sigaction( portTICK_SIGNAL, &xTickAction, &xOldTickAction );
+
+	xIOAction = xTickAction;
+	xIOAction.sa_handler = prvIOSignalHandler;
+	sigaction( portIO_SIGNAL, &xIOAction, &xOldIOAction );
+
+	xTimer.it_interval.tv_sec = 0;
+	xTimer.it_interval.tv_usec = portTICK_PERIOD_US;
+	xTimer.it_value = xTimer.it_interval;
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+
+	/* Kick off the highest priority task that has been created so far. */
+	swapcontext( &xSchedulerContext, &( portTCB_CONTEXT( pxCurrentTCB )->xContext ) );
+
+	/* Only reach here once vPortEndScheduler() has been called.  Ignoring the
+	signal discards any tick that is still pending before the original
+	disposition is put back. */
+	xTickAction.sa_handler = SIG_IGN;
+	sigaction( portTICK_SIGNAL, &xTickAction, NULL );
+	sigaction( portTICK_SIGNAL, &xOldTickAction, NULL );
+	sigaction( portIO_SIGNAL, &xTickAction, NULL );
+	sigaction( portIO_SIGNAL, &xOldIOAction, NULL );
+	vPortEnableInterrupts();
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+struct itimerval xTimer = { { 0, 0 }, { 0, 0 } };
+
+	/* Stop the tick then return to the context that called
+	xPortStartScheduler(). */
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+	setcontext( &xSchedulerContext );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+sigset_t xOldMask;
+
+	prvBlockInterrupts( &xOldMask );
+	prvSwitchContext();
+
+	/* The task continues from here when it is next selected to run. */
+	sigprocmask( SIG_SETMASK, &xOldMask, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+	xYieldPending = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	prvBlockInterrupts( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+sigset_t xSignals;
+
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portTICK_SIGNAL );
+	sigaddset( &xSignals, portIO_SIGNAL );
+	sigprocmask( SIG_UNBLOCK, &xSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetIOInterruptHandler( void ( *pxHandler )( void ) )
+{
+	pxIOInterruptHandler = pxHandler;
+}
+/*-----------------------------------------------------------*/
+
+unsigned portBASE_TYPE uxPortSetInterruptMaskFromISR( void )
+{
+sigset_t xOldMask;
+
+	prvBlockInterrupts( &xOldMask );
+
+	return ( unsigned portBASE_TYPE ) sigismember( &xOldMask, portTICK_SIGNAL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMaskFromISR( unsigned portBASE_TYPE uxSavedStatusRegister )
+{
+	if( uxSavedStatusRegister == ( unsigned portBASE_TYPE ) 0 )
+	{
+		vPortEnableInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+	void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime )
+	{
+	struct itimerval xTimer;
+	sigset_t xOldMask, xSleepMask;
+	unsigned long long ullTimeToWakeUs, ullTicksLeft;
+
+		/* Called by the idle task with the scheduler suspended.  A tick that
+		arrives from here on is counted as a missed tick and is processed
+		when the scheduler is resumed. */
+		if( xExpectedIdleTime > portMAX_SUPPRESSED_TICKS )
+		{
+			xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
+		}
+
+		prvBlockInterrupts( &xOldMask );
+
+		/* A tick that has expired but not yet been delivered makes the idle
+		time calculation invalid, as does anything an earlier tick did while
+		the scheduler was suspended. */
+		if( ( prvTickSignalPending() != 0 ) || ( xTaskConfirmSleepModeStatus() == pdFALSE ) )
+		{
+			sigprocmask( SIG_SETMASK, &xOldMask, NULL );
+			return;
+		}
+
+		/* The application can veto or shorten the sleep by altering
+		xExpectedIdleTime. */
+		configPRE_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		if( xExpectedIdleTime > ( portTickType ) 0 )
+		{
+			/* Stretch the current tick period so the next signal arrives at
+			the tick on which the first delayed task is due.  The interval is
+			left alone, so the timer carries on at the tick rate afterwards. */
+			getitimer( ITIMER_REAL, &xTimer );
+			ullTimeToWakeUs = ( ( unsigned long long ) xTimer.it_value.tv_sec * 1000000ULL ) + ( unsigned long long ) xTimer.it_value.tv_usec;
+			ullTimeToWakeUs += ( unsigned long long ) ( xExpectedIdleTime - 1 ) * portTICK_PERIOD_US;
+			xTimer.it_value.tv_sec = ( time_t ) ( ullTimeToWakeUs / 1000000ULL );
+			xTimer.it_value.tv_usec = ( suseconds_t ) ( ullTimeToWakeUs % 1000000ULL );
+			setitimer( ITIMER_REAL, &xTimer, NULL );
+
+			/* The sleep ends with the tick signal or, earlier, with the I/O
+			signal.  Either handler runs before sigsuspend() returns and, as
+			the scheduler is suspended, a tick it processes is held as a
+			missed tick and a task it readies is held as pending. */
+			xSleepMask = xOldMask;
+			sigdelset( &xSleepMask, portTICK_SIGNAL );
+			sigdelset( &xSleepMask, portIO_SIGNAL );
+			xTickDelivered = pdFALSE;
+			sigsuspend( &xSleepMask );
+
+			if( ( xTickDelivered != pdFALSE ) || ( prvTickSignalPending() != 0 ) )
+			{
+				/* Account for the ticks that were never generated.  The
+				final tick was, or is about to be, delivered normally. */
+				vTaskStepTick( xExpectedIdleTime - 1 );
+			}
+			else
+			{
+				/* Woken early.  Count the tick periods that have passed and
+				leave the timer to expire at the end of the current one. */
+				getitimer( ITIMER_REAL, &xTimer );
+				ullTimeToWakeUs = ( ( unsigned long long ) xTimer.it_value.tv_sec * 1000000ULL ) + ( unsigned long long ) xTimer.it_value.tv_usec;
+				ullTicksLeft = ( ullTimeToWakeUs - 1ULL ) / portTICK_PERIOD_US;
+				ullTimeToWakeUs -= ullTicksLeft * portTICK_PERIOD_US;
+				xTimer.it_value.tv_sec = ( time_t ) ( ullTimeToWakeUs / 1000000ULL );
+				xTimer.it_value.tv_usec = ( suseconds_t ) ( ullTimeToWakeUs % 1000000ULL );
+				setitimer( ITIMER_REAL, &xTimer, NULL );
+
+				if( ullTicksLeft < ( unsigned long long ) ( xExpectedIdleTime - 1 ) )
+				{
+					vTaskStepTick( ( xExpectedIdleTime - 1 ) - ( portTickType ) ullTicksLeft );
+				}
+			}
+		}
+
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		sigprocmask( SIG_SETMASK, &xOldMask, NULL );
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	unsigned long ulPortGetRunTimeCounterValue( void )
+	{
+	struct timespec xNow;
+
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+		return ( ( unsigned long ) xNow.tv_sec * 1000000UL ) + ( ( unsigned long ) xNow.tv_nsec / 1000UL );
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	/* Interrupts are blocked for the duration of the handler. */
+	vTaskIncrementTick();
+
+	#if ( configUSE_TICKLESS_IDLE == 1 )
+		xTickDelivered = pdTRUE;
+	#endif
+
+	#if configUSE_PREEMPTION == 1
+		xYieldPending = pdTRUE;
+	#endif
+
+	if( xYieldPending != pdFALSE )
+	{
+		xYieldPending = pdFALSE;
+		prvSwitchContext();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvIOSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	/* Interrupts are blocked for the duration of the handler. */
+	if( pxIOInterruptHandler != NULL )
+	{
+		pxIOInterruptHandler();
+	}
+
+	if( xYieldPending != pdFALSE )
+	{
+		xYieldPending = pdFALSE;
+		prvSwitchContext();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+void *pvPreviousTCB;
+
+	pvPreviousTCB = pxCurrentTCB;
+	vTaskSwitchContext();
+
+	if( pvPreviousTCB != pxCurrentTCB )
+	{
+		swapcontext( &( portTCB_CONTEXT( pvPreviousTCB )->xContext ), &( portTCB_CONTEXT( pxCurrentTCB )->xContext ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntryPoint( void )
+{
+xPortTaskContext *pxContext = portTCB_CONTEXT( pxCurrentTCB );
+
+	pxContext->pxCode( pxContext->pvParameters );
+
+	/* Task functions must never return.  If one does it is removed rather
+	than allowed to run off the end of its stack. */
+	#if ( INCLUDE_vTaskDelete == 1 )
+	{
+		vTaskDelete( NULL );
+	}
+	#endif
+
+	for( ;; )
+	{
+		pause();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockInterrupts( sigset_t *pxOldMask )
+{
+sigset_t xSignals;
+
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portTICK_SIGNAL );
+	sigaddset( &xSignals, portIO_SIGNAL );
+	sigprocmask( SIG_BLOCK, &xSignals, pxOldMask );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+	static int prvTickSignalPending( void )
+	{
+	sigset_t xPending;
+
+		sigpending( &xPending );
+
+		return sigismember( &xPending, portTICK_SIGNAL );
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
@@ -0,0 +1,192 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * The settings in this file configure FreeRTOS correctly for the
+ * given hardware and compiler.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	unsigned long
+#define portBASE_TYPE	long
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef unsigned portSHORT portTickType;
+	#define portMAX_DELAY ( portTickType ) 0xffff
+#else
+	typedef unsigned portLONG portTickType;
+	#define portMAX_DELAY ( portTickType ) ~( ( portTickType ) 0 )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+#define portBYTE_ALIGNMENT			8
+#define portSTACK_GROWTH			-1
+#define portTICK_RATE_MS			( ( portTickType ) 1000 / configTICK_RATE_HZ )
+
+/* Each task runs on a host stack of this many bytes.  The stack allocated by
+the kernel only holds the pointer to the task context, so the high water mark
+reported by uxTaskGetStackHighWaterMark() is not meaningful on this port. */
+#ifndef portHOST_STACK_SIZE
+	#define portHOST_STACK_SIZE		( 64 * 1024 )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Critical section management.  The tick is generated by SIGALRM and the
+simulated peripheral interrupt by SIGIO, so "interrupts" are masked by
+blocking those signals. */
+extern void vPortDisableInterrupts( void );
+extern void vPortEnableInterrupts( void );
+#define portDISABLE_INTERRUPTS()	vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()		vPortEnableInterrupts()
+
+extern void vTaskEnterCritical( void );
+extern void vTaskExitCritical( void );
+#define portCRITICAL_NESTING_IN_TCB	1
+#define portENTER_CRITICAL()		vTaskEnterCritical()
+#define portEXIT_CRITICAL()			vTaskExitCritical()
+
+extern unsigned portBASE_TYPE uxPortSetInterruptMaskFromISR( void );
+extern void vPortClearInterruptMaskFromISR( unsigned portBASE_TYPE );
+#define portSET_INTERRUPT_MASK_FROM_ISR() uxPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedStatusRegister ) vPortClearInterruptMaskFromISR( uxSavedStatusRegister )
+/*-----------------------------------------------------------*/
+
+/* Task utilities. */
+extern void vPortYield( void );
+extern void vPortYieldFromISR( void );
+#define portYIELD()					vPortYield()
+#define portNOP()					__asm volatile ( "nop" )
+
+/* Stops the compiler moving memory accesses across this point.  Used by the
+lock free stream buffers.  All the tasks and the simulated interrupts run on
+the one host thread so nothing more is needed. */
+#define portMEMORY_BARRIER()		__asm volatile ( "" ::: "memory" )
+
+/* Installs the handler run, as an interrupt service routine, each time the
+process receives SIGIO.  Arrange for SIGIO with O_ASYNC and F_SETOWN on the
+descriptors of interest.  The handler may use the FromISR API functions
+followed by portEND_SWITCHING_ISR(). */
+extern void vPortSetIOInterruptHandler( void ( *pxHandler )( void ) );
+
+#define portEND_SWITCHING_ISR( xSwitchRequired )	if( xSwitchRequired )		\
+													{							\
+														vPortYieldFromISR();	\
+													}
+/*-----------------------------------------------------------*/
+
+/* Tickless idle.  The tick timer is reprogrammed to expire once at the end of
+the idle period, so the process is not woken by signals it has nothing to do
+with. */
+#if configUSE_TICKLESS_IDLE == 1
+
+	extern void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics use the host's monotonic clock, in microseconds.  An
+unsigned long is 64 bits on the hosts this port targets so the count never
+wraps. */
+#if configGENERATE_RUN_TIME_STATS == 1
+
+	extern unsigned long ulPortGetRunTimeCounterValue( void );
+	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+		#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+	#endif
+	#ifndef portGET_RUN_TIME_COUNTER_VALUE
+		#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounterValue()
+	#endif
+
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisation of the selection of the next task to
+run, using the host's count leading zeros instruction.  configMAX_PRIORITIES
+must not exceed the number of bits in an unsigned long when this is used. */
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( ( sizeof( unsigned long ) * 8 ) - 1 - __builtin_clzl( ( uxReadyPriorities ) ) )
+
+	#if configMAX_PRIORITIES > ( __SIZEOF_LONG__ * 8 )
+		#error configMAX_PRIORITIES cannot exceed the bits in an unsigned long when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+	#endif
+
+#endif
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters ) __attribute__((noreturn))
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
+
@@ -67,6 +67,12 @@
 #define portSTACK_TYPE	unsigned char
 #define portBASE_TYPE	char
 
+/* The ready priority bitmap used when configUSE_PORT_OPTIMISED_TASK_SELECTION
+is 1 is an unsigned portBASE_TYPE, one bit per priority. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) && ( configMAX_PRIORITIES > 8 )
+	#error configMAX_PRIORITIES cannot exceed 8 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+#endif
+
 #if( configUSE_16_BIT_TICKS == 1 )
 	typedef unsigned portSHORT portTickType;
 	#define portMAX_DELAY ( portTickType ) 0xffff
@@ -71,6 +71,12 @@ extern "C" {
 #define portSTACK_TYPE	unsigned short
 #define portBASE_TYPE	short
 
+/* The ready priority bitmap used when configUSE_PORT_OPTIMISED_TASK_SELECTION
+is 1 is an unsigned portBASE_TYPE, one bit per priority. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) && ( configMAX_PRIORITIES > 16 )
+	#error configMAX_PRIORITIES cannot exceed 16 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+#endif
+
 #if( configUSE_16_BIT_TICKS == 1 )
 	typedef unsigned portSHORT portTickType;
 	#define portMAX_DELAY ( portTickType ) 0xffff
@@ -124,6 +130,11 @@ extern void vPortYield( void );
 
 #define portNOP()				asm volatile ( "NOP" )
 
+/* Stops the compiler moving memory accesses across this point.  Used by the
+lock free stream buffers.  The processor is single core so nothing more is
+needed. */
+#define portMEMORY_BARRIER()	asm volatile ( "" ::: "memory" )
+
 #ifdef __cplusplus
 }
 #endif
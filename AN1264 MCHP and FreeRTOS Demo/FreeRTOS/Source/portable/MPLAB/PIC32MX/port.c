@@ -53,8 +53,22 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
-/* Hardware specifics. */
-#define portTIMER_PRESCALE 8
+/* Hardware specifics.  The tickless idle mode needs a slower timer clock so
+that a useful number of tick periods fit within the 16 bit timer. */
+#if configUSE_TICKLESS_IDLE == 1
+	#define portTIMER_PRESCALE 64
+	#define portTIMER_PRESCALE_BITS T5_PS_1_64
+#else
+	#define portTIMER_PRESCALE 8
+	#define portTIMER_PRESCALE_BITS T5_PS_1_8
+#endif
+
+/* The number of timer counts that make up one tick period. */
+#define portTIMER_COUNTS_PER_TICK	( ( configPERIPHERAL_CLOCK_HZ / portTIMER_PRESCALE ) / configTICK_RATE_HZ )
+
+/* The largest number of ticks the tickless idle mode can suppress at once,
+limited by the 16 bit period register. */
+#define portMAX_SUPPRESSED_TICKS	( ( portTickType ) ( 0xffffUL / portTIMER_COUNTS_PER_TICK ) )
 
 /* Bits within various registers. */
 #define portIE_BIT					( 0x00000001 )
@@ -79,6 +93,12 @@ portSTACK_TYPE xISRStack[ configISR_STACK_SIZE ] = { 0 };
 the callers stack, as some functions seem to want to do this. */
 const portBASE_TYPE * const xISRStackTop = &( xISRStack[ configISR_STACK_SIZE - 7 ] );
 
+/* Set by the tick interrupt so vPortSuppressTicksAndSleep() knows whether the
+processor was woken by the end of the sleep period or by another interrupt. */
+#if configUSE_TICKLESS_IDLE == 1
+	static volatile portBASE_TYPE xTickInterruptOccurred = pdFALSE;
+#endif
+
 /* Place the prototype here to ensure the interrupt vector is correctly installed. */
 extern void __attribute__( (interrupt(ipl1), vector(_TIMER_5_VECTOR))) vT5InterruptHandler( void );
 
@@ -127,9 +147,9 @@ portSTACK_TYPE *pxPortInitialiseStack( portSTACK_TYPE *pxTopOfStack, pdTASK_CODE
  */
 void prvSetupTimerInterrupt( void )
 {
-const unsigned portLONG ulCompareMatch = ( (configPERIPHERAL_CLOCK_HZ / portTIMER_PRESCALE) / configTICK_RATE_HZ ) - 1;
+const unsigned portLONG ulCompareMatch = portTIMER_COUNTS_PER_TICK - 1;
 
-	OpenTimer5( ( T5_ON | T5_PS_1_8 | T5_SOURCE_INT ), ulCompareMatch );
+	OpenTimer5( ( T5_ON | portTIMER_PRESCALE_BITS | T5_SOURCE_INT ), ulCompareMatch );
 	ConfigIntTimer5( T5_INT_ON | configKERNEL_INTERRUPT_PRIORITY );
 }
 /*-----------------------------------------------------------*/
@@ -179,11 +199,95 @@ unsigned portBASE_TYPE uxSavedStatus;
 		SetCoreSW0();
 	#endif /* configUSE_PREEMPTION */
 
+	#if configUSE_TICKLESS_IDLE == 1
+		xTickInterruptOccurred = pdTRUE;
+	#endif
+
 	/* Clear timer 0 interrupt. */
 	mT5ClearIntFlag();
 }
 /*-----------------------------------------------------------*/
 
+#if configUSE_TICKLESS_IDLE == 1
+
+	void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime )
+	{
+	unsigned portLONG ulCount, ulCompleteTickPeriods;
+
+		if( xExpectedIdleTime > portMAX_SUPPRESSED_TICKS )
+		{
+			xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
+		}
+
+		/* Stop the tick timer while it is reprogrammed.  The time it spends
+		stopped is lost, which makes the tick drift slightly each time the
+		processor sleeps. */
+		portDISABLE_INTERRUPTS();
+		T5CONCLR = T5_ON;
+
+		/* A pending tick, or anything done while the scheduler was suspended,
+		means the idle time calculation is no longer valid. */
+		if( ( mT5GetIntFlag() != 0 ) || ( xTaskConfirmSleepModeStatus() == pdFALSE ) )
+		{
+			T5CONSET = T5_ON;
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		/* Let the timer run on from the count already reached in the current
+		tick period until the end of the last tick period to be suppressed. */
+		WritePeriod5( ( portTIMER_COUNTS_PER_TICK * ( unsigned portLONG ) xExpectedIdleTime ) - 1UL );
+		xTickInterruptOccurred = pdFALSE;
+		T5CONSET = T5_ON;
+
+		/* The application can veto the sleep by setting xExpectedIdleTime to
+		zero. */
+		configPRE_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		if( xExpectedIdleTime > ( portTickType ) 0 )
+		{
+			/* An interrupt that occurs between enabling interrupts and the
+			wait instruction is serviced before the sleep, so at worst the
+			processor sleeps until the timer wakes it. */
+			portENABLE_INTERRUPTS();
+			asm volatile ( "wait" );
+			portDISABLE_INTERRUPTS();
+		}
+
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		T5CONCLR = T5_ON;
+		ulCount = ReadTimer5();
+
+		if( xTickInterruptOccurred != pdFALSE )
+		{
+			/* The whole period passed and the tick interrupt has already
+			been processed as a missed tick.  The timer has restarted from
+			zero, so what it holds now is part of the next tick period. */
+			ulCompleteTickPeriods = ( unsigned portLONG ) xExpectedIdleTime - 1UL;
+		}
+		else
+		{
+			/* Another interrupt ended the sleep early.  The count holds the
+			time since the start of the last tick period that was not
+			suppressed. */
+			ulCompleteTickPeriods = ulCount / portTIMER_COUNTS_PER_TICK;
+		}
+
+		/* Keep the part of a tick period that has already elapsed, then go
+		back to a regular tick. */
+		WriteTimer5( ulCount % portTIMER_COUNTS_PER_TICK );
+		WritePeriod5( portTIMER_COUNTS_PER_TICK - 1UL );
+		T5CONSET = T5_ON;
+
+		vTaskStepTick( ( portTickType ) ulCompleteTickPeriods );
+
+		portENABLE_INTERRUPTS();
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
 unsigned portBASE_TYPE uxPortSetInterruptMaskFromISR( void )
 {
 unsigned portBASE_TYPE uxSavedStatusRegister;
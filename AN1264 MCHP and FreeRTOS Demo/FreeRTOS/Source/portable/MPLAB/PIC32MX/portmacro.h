@@ -143,6 +143,52 @@ unsigned portLONG ulStatus;						\
 
 #define portNOP()	asm volatile ( 	"nop" )
 
+/* Stops the compiler moving memory accesses across this point.  Used by the
+lock free stream buffers.  The processor is single core so nothing more is
+needed. */
+#define portMEMORY_BARRIER()	asm volatile ( "" ::: "memory" )
+
+/*-----------------------------------------------------------*/
+
+/* Tickless idle.  The period of the tick timer is lengthened so the processor
+is not woken until the next task is due to unblock. */
+#if configUSE_TICKLESS_IDLE == 1
+
+	extern void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics use the core timer, which increments at half the CPU
+clock and is not otherwise used by the port.  It is 32 bits wide, the same as
+an unsigned portLONG, so the kernel handles it wrapping. */
+#if configGENERATE_RUN_TIME_STATS == 1
+
+	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+		#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+	#endif
+	#ifndef portGET_RUN_TIME_COUNTER_VALUE
+		#define portGET_RUN_TIME_COUNTER_VALUE() ( ( unsigned portLONG ) _CP0_GET_COUNT() )
+	#endif
+
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisation of the selection of the next task to
+run.  The clz instruction locates the highest priority ready task in one
+instruction.  configMAX_PRIORITIES must not exceed 32 when this is used. */
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31 - __builtin_clz( ( uxReadyPriorities ) ) )
+
+	#if configMAX_PRIORITIES > 32
+		#error configMAX_PRIORITIES cannot exceed 32 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+	#endif
+
+#endif
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site. */
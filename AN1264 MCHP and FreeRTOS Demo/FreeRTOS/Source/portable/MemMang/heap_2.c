@@ -50,6 +50,10 @@
  * allocated blocks to be freed, but does not combine adjacent free blocks
  * into a single larger block.
  *
+ * Keeps the same statistics as heap_4.c, returned by xPortGetFreeHeapSize(),
+ * xPortGetMinimumEverFreeHeapSize() and vPortGetHeapStats(), so that the two
+ * can be compared on the same application.
+ *
  * See heap_1.c and heap_3.c for alternative implementations, and the memory
  * management pages of http://www.FreeRTOS.org for more information.
  */
@@ -107,6 +111,12 @@ static const unsigned portSHORT  heapSTRUCT_SIZE	= ( sizeof( xBlockLink ) + port
 /* Create a couple of list links to mark the start and end of the list. */
 static xBlockLink xStart, xEnd;
 
+/* Statistics on the use of the heap. */
+static size_t xFreeBytesRemaining = configTOTAL_HEAP_SIZE;
+static size_t xMinimumEverFreeBytesRemaining = configTOTAL_HEAP_SIZE;
+static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0;
+static size_t xNumberOfSuccessfulFrees = ( size_t ) 0;
+
 /* STATIC FUNCTIONS ARE DEFINED AS MACROS TO MINIMIZE THE FUNCTION CALL DEPTH. */
 
 /*
@@ -225,6 +235,15 @@ void *pvReturn = NULL;
 					/* Insert the new block into the list of free blocks. */
 					prvInsertBlockIntoFreeList( ( pxNewBlockLink ) );
 				}
+
+				xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+
+				xNumberOfSuccessfulAllocations++;
 			}
 		}
 	}
@@ -262,9 +281,65 @@ xBlockLink *pxLink;
 		{				
 			/* Add this block to the list of free blocks. */
 			prvInsertBlockIntoFreeList( ( ( xBlockLink * ) pxLink ) );
+			xFreeBytesRemaining += pxLink->xBlockSize;
+			xNumberOfSuccessfulFrees++;
 		}
 		xTaskResumeAll();
 	}
 }
 /*-----------------------------------------------------------*/
 
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( xHeapStats *pxHeapStats )
+{
+xBlockLink *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0;
+
+	vTaskSuspendAll();
+	{
+		pxBlock = xStart.pxNextFreeBlock;
+
+		/* pxBlock will be NULL if the heap has not been initialised, when it
+		is still a single block.  The list is in size order, so the first block
+		is the smallest and the last the largest. */
+		if( pxBlock == NULL )
+		{
+			xBlocks = 1;
+			xMinSize = configTOTAL_HEAP_SIZE;
+			xMaxSize = configTOTAL_HEAP_SIZE;
+		}
+		else
+		{
+			xMinSize = pxBlock->xBlockSize;
+
+			while( pxBlock != &xEnd )
+			{
+				xBlocks++;
+				xMaxSize = pxBlock->xBlockSize;
+				pxBlock = pxBlock->pxNextFreeBlock;
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks != 0 ) ? xMinSize : 0;
+		pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+	}
+	xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
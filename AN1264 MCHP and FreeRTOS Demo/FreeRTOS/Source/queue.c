@@ -99,6 +99,10 @@ typedef struct QueueDefinition
 	signed portBASE_TYPE xRxLock;			/*< Stores the number of items received from the queue (removed from the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 	signed portBASE_TYPE xTxLock;			/*< Stores the number of items transmitted to the queue (added to the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 
+	#if ( configUSE_TRACE_RECORDER == 1 )
+		unsigned portCHAR ucQueueNumber;	/*< Identifies the queue in the binary trace. */
+	#endif
+
 } xQUEUE;
 /*-----------------------------------------------------------*/
 
@@ -131,6 +135,14 @@ signed portBASE_TYPE xQueueIsQueueEmptyFromISR( const xQueueHandle pxQueue );
 signed portBASE_TYPE xQueueIsQueueFullFromISR( const xQueueHandle pxQueue );
 unsigned portBASE_TYPE uxQueueMessagesWaitingFromISR( const xQueueHandle pxQueue );
 
+/*
+ * The timer service task needs to block on its command queue for a time that
+ * is calculated with the scheduler suspended.
+ */
+#if configUSE_TIMERS == 1
+	void vQueueWaitForMessageRestricted( xQueueHandle pxQueue, portTickType xTicksToWait );
+#endif
+
 /*
  * Co-routine queue functions differ from task queue functions.  Co-routines are
  * an optional component.
@@ -313,10 +325,12 @@ size_t xQueueSizeInBytes;
 			vListInitialise( &( pxNewQueue->xTasksWaitingToSend ) );
 			vListInitialise( &( pxNewQueue->xTasksWaitingToReceive ) );
 
+			/* Traced before the mutex is given so the give is attributed to
+			the new mutex. */
+			traceCREATE_MUTEX( pxNewQueue );
+
 			/* Start with the semaphore in the expected state. */
 			xQueueGenericSend( pxNewQueue, NULL, 0, queueSEND_TO_BACK );
-
-			traceCREATE_MUTEX( pxNewQueue );
 		}
 		else
 		{
@@ -1403,6 +1417,8 @@ signed portBASE_TYPE xReturn;
 	{
 	unsigned portBASE_TYPE ux;
 
+		traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName );
+
 		/* See if there is an empty space in the registry.  A NULL name denotes
 		a free slot. */
 		for( ux = 0; ux < configQUEUE_REGISTRY_SIZE; ux++ )
@@ -1440,4 +1456,31 @@ signed portBASE_TYPE xReturn;
 	}
 
 #endif
+/*-----------------------------------------------------------*/
+
+#if configUSE_TIMERS == 1
+
+	void vQueueWaitForMessageRestricted( xQueueHandle pxQueue, portTickType xTicksToWait )
+	{
+		/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.
+
+		Unlike xQueueGenericReceive() the calling task is placed on the event
+		list directly, without the block time being re-evaluated against the
+		tick count, so a block time calculated with the scheduler suspended
+		remains accurate.  Only the timer service task uses this - and it only
+		ever calls it from a loop that re-checks the queue each time it runs,
+		so it does not matter if the task is unblocked for some other reason.
+
+		The queue is locked so an ISR posting to it while the task is being
+		placed on the event list will be noticed by prvUnlockQueue(). */
+		prvLockQueue( pxQueue );
+		if( pxQueue->uxMessagesWaiting == ( unsigned portBASE_TYPE ) 0U )
+		{
+			/* There is nothing in the queue, block for the specified period. */
+			vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+		}
+		prvUnlockQueue( pxQueue );
+	}
+
+#endif
 
@@ -0,0 +1,554 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+
+#if ( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to use stream buffers.
+#endif
+
+#if ( INCLUDE_xTaskGetCurrentTaskHandle != 1 )
+	#error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to use stream buffers.
+#endif
+
+/*-----------------------------------------------------------
+ * PUBLIC STREAM BUFFER API documented in stream_buffer.h
+ *----------------------------------------------------------*/
+
+/* The length written in front of each message in a message buffer. */
+#define sbBYTES_TO_STORE_MESSAGE_LENGTH		( sizeof( size_t ) )
+
+/* Bits in ucFlags. */
+#define sbFLAGS_IS_MESSAGE_BUFFER			( ( unsigned portCHAR ) 1 )
+
+/*
+ * Definition of a stream buffer.  The bytes in the buffer run from xTail up
+ * to, but not including, xHead.  The storage area is one byte longer than
+ * the capacity so that a full buffer (xHead one behind xTail) can be told
+ * apart from an empty one (xHead equal to xTail).
+ *
+ * Only the writer changes xHead and only the reader changes xTail.  Each
+ * side copies its data first and then publishes it by moving its index, so
+ * the other side never sees a partly copied message.
+ */
+typedef struct xSTREAM_BUFFER
+{
+	volatile size_t xTail;								/*< Index of the next byte to be read. */
+	volatile size_t xHead;								/*< Index of the next byte to be written. */
+	size_t xLength;										/*< The size of the storage area. */
+	volatile size_t xTriggerLevelBytes;					/*< Bytes needed in the buffer to wake a blocked reader. */
+	volatile size_t xSpaceWantedBySender;				/*< Free space needed to wake a blocked writer. */
+	volatile xTaskHandle xTaskWaitingToReceive;			/*< The reader, while it is blocked. */
+	volatile xTaskHandle xTaskWaitingToSend;			/*< The writer, while it is blocked. */
+	unsigned portCHAR *pucBuffer;						/*< The storage area. */
+	unsigned portCHAR ucFlags;
+} xSTREAM_BUFFER;
+
+/*
+ * The number of bytes in the buffer, and the number that can be added.
+ */
+static size_t prvBytesInBuffer( const xSTREAM_BUFFER *pxStreamBuffer );
+static size_t prvSpacesInBuffer( const xSTREAM_BUFFER *pxStreamBuffer );
+
+/*
+ * Copy bytes into or out of the storage area starting at xIndex, wrapping at
+ * the end.  Returns the index following the last byte copied.  Neither
+ * function moves xHead or xTail.
+ */
+static size_t prvCopyIn( xSTREAM_BUFFER *pxStreamBuffer, size_t xIndex, const unsigned portCHAR *pucData, size_t xCount );
+static size_t prvCopyOut( const xSTREAM_BUFFER *pxStreamBuffer, size_t xIndex, unsigned portCHAR *pucData, size_t xCount );
+
+/*
+ * Write or read as much as the space or data available allows, honouring
+ * the message boundaries of a message buffer.  Used by the task and the
+ * interrupt versions of the API alike.
+ */
+static size_t prvWrite( xSTREAM_BUFFER *pxStreamBuffer, const void *pvTxData, size_t xDataLengthBytes );
+static size_t prvRead( xSTREAM_BUFFER *pxStreamBuffer, void *pvRxData, size_t xBufferLengthBytes );
+
+/*
+ * The amount of free space that must be available before xDataLengthBytes
+ * can be written.
+ */
+static size_t prvSpaceRequired( const xSTREAM_BUFFER *pxStreamBuffer, size_t xDataLengthBytes );
+
+/*-----------------------------------------------------------*/
+
+xStreamBufferHandle xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, portBASE_TYPE xIsMessageBuffer )
+{
+xSTREAM_BUFFER *pxNewStreamBuffer = NULL;
+
+	/* A message buffer must at least be able to hold one empty message. */
+	if( ( xBufferSizeBytes > ( size_t ) 0 ) && ( ( xIsMessageBuffer == pdFALSE ) || ( xBufferSizeBytes > sbBYTES_TO_STORE_MESSAGE_LENGTH ) ) )
+	{
+		/* The structure and the storage area are allocated together. */
+		pxNewStreamBuffer = ( xSTREAM_BUFFER * ) pvPortMalloc( sizeof( xSTREAM_BUFFER ) + xBufferSizeBytes + ( size_t ) 1 );
+		if( pxNewStreamBuffer != NULL )
+		{
+			pxNewStreamBuffer->xTail = ( size_t ) 0;
+			pxNewStreamBuffer->xHead = ( size_t ) 0;
+			pxNewStreamBuffer->xLength = xBufferSizeBytes + ( size_t ) 1;
+			pxNewStreamBuffer->xSpaceWantedBySender = ( size_t ) 0;
+			pxNewStreamBuffer->xTaskWaitingToReceive = NULL;
+			pxNewStreamBuffer->xTaskWaitingToSend = NULL;
+			pxNewStreamBuffer->pucBuffer = ( unsigned portCHAR * ) pxNewStreamBuffer + sizeof( xSTREAM_BUFFER );
+			pxNewStreamBuffer->ucFlags = ( xIsMessageBuffer != pdFALSE ) ? sbFLAGS_IS_MESSAGE_BUFFER : ( unsigned portCHAR ) 0;
+
+			if( xTriggerLevelBytes == ( size_t ) 0 )
+			{
+				xTriggerLevelBytes = ( size_t ) 1;
+			}
+			else if( xTriggerLevelBytes > xBufferSizeBytes )
+			{
+				xTriggerLevelBytes = xBufferSizeBytes;
+			}
+			pxNewStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+		}
+	}
+
+	return ( xStreamBufferHandle ) pxNewStreamBuffer;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSend( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+xTimeOutType xTimeOut;
+size_t xSpaceRequired, xWritten;
+xTaskHandle xTaskToNotify;
+portBASE_TYPE xWait;
+
+	xSpaceRequired = prvSpaceRequired( pxStreamBuffer, xDataLengthBytes );
+	vTaskSetTimeOutState( &xTimeOut );
+
+	/* There is no point waiting to write nothing. */
+	if( xDataLengthBytes == ( size_t ) 0 )
+	{
+		xTicksToWait = ( portTickType ) 0;
+	}
+
+	for( ;; )
+	{
+		if( ( prvSpacesInBuffer( pxStreamBuffer ) >= xSpaceRequired ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+		{
+			break;
+		}
+
+		/* Ask the reader to wake this task once enough space has been freed.
+		The space is checked again with interrupts masked in case the reader
+		made the space since the check above, in which case it will not have
+		known to wake this task. */
+		xWait = pdFALSE;
+		taskENTER_CRITICAL();
+		{
+			if( prvSpacesInBuffer( pxStreamBuffer ) < xSpaceRequired )
+			{
+				pxStreamBuffer->xSpaceWantedBySender = xSpaceRequired;
+				pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				xWait = pdTRUE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xWait != pdFALSE )
+		{
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+		}
+	}
+
+	xWritten = prvWrite( pxStreamBuffer, pvTxData, xDataLengthBytes );
+
+	if( xWritten > ( size_t ) 0 )
+	{
+		/* Wake the reader if it is waiting and there is now enough data.  The
+		reader is forgotten before it is notified as it may run, and wait
+		again, before xTaskNotifyGive() returns. */
+		taskENTER_CRITICAL();
+		{
+			if( ( pxStreamBuffer->xTaskWaitingToReceive != NULL ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
+			{
+				xTaskToNotify = pxStreamBuffer->xTaskWaitingToReceive;
+				pxStreamBuffer->xTaskWaitingToReceive = NULL;
+				( void ) xTaskNotifyGive( xTaskToNotify );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return xWritten;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendFromISR( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xWritten;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+xTaskHandle xTaskToNotify;
+
+	xWritten = prvWrite( pxStreamBuffer, pvTxData, xDataLengthBytes );
+
+	if( xWritten > ( size_t ) 0 )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( ( pxStreamBuffer->xTaskWaitingToReceive != NULL ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
+			{
+				xTaskToNotify = pxStreamBuffer->xTaskWaitingToReceive;
+				pxStreamBuffer->xTaskWaitingToReceive = NULL;
+				( void ) xTaskNotifyFromISR( xTaskToNotify, pxHigherPriorityTaskWoken );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+
+	return xWritten;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceive( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+xTimeOutType xTimeOut;
+size_t xReceived;
+portBASE_TYPE xWait;
+xTaskHandle xTaskToNotify;
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		if( ( prvBytesInBuffer( pxStreamBuffer ) > ( size_t ) 0 ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+		{
+			break;
+		}
+
+		/* As in xStreamBufferSend(), check again with interrupts masked
+		before asking the writer to wake this task. */
+		xWait = pdFALSE;
+		taskENTER_CRITICAL();
+		{
+			if( prvBytesInBuffer( pxStreamBuffer ) == ( size_t ) 0 )
+			{
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+				xWait = pdTRUE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xWait != pdFALSE )
+		{
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+		}
+	}
+
+	xReceived = prvRead( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+
+	if( xReceived > ( size_t ) 0 )
+	{
+		/* Wake the writer if it is waiting and there is now enough space. */
+		taskENTER_CRITICAL();
+		{
+			if( ( pxStreamBuffer->xTaskWaitingToSend != NULL ) && ( prvSpacesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xSpaceWantedBySender ) )
+			{
+				xTaskToNotify = pxStreamBuffer->xTaskWaitingToSend;
+				pxStreamBuffer->xTaskWaitingToSend = NULL;
+				( void ) xTaskNotifyGive( xTaskToNotify );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveFromISR( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xReceived;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+xTaskHandle xTaskToNotify;
+
+	xReceived = prvRead( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+
+	if( xReceived > ( size_t ) 0 )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( ( pxStreamBuffer->xTaskWaitingToSend != NULL ) && ( prvSpacesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xSpaceWantedBySender ) )
+			{
+				xTaskToNotify = pxStreamBuffer->xTaskWaitingToSend;
+				pxStreamBuffer->xTaskWaitingToSend = NULL;
+				( void ) xTaskNotifyFromISR( xTaskToNotify, pxHigherPriorityTaskWoken );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+
+	return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xStreamBufferSetTriggerLevel( xStreamBufferHandle xStreamBuffer, size_t xTriggerLevelBytes )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+portBASE_TYPE xReturn;
+
+	if( xTriggerLevelBytes == ( size_t ) 0 )
+	{
+		xTriggerLevelBytes = ( size_t ) 1;
+	}
+
+	if( xTriggerLevelBytes < pxStreamBuffer->xLength )
+	{
+		pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer )
+{
+	return prvBytesInBuffer( ( xSTREAM_BUFFER * ) xStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer )
+{
+	return prvSpacesInBuffer( ( xSTREAM_BUFFER * ) xStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBytesInBuffer( const xSTREAM_BUFFER *pxStreamBuffer )
+{
+size_t xCount;
+
+	xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
+	xCount -= pxStreamBuffer->xTail;
+	if( xCount >= pxStreamBuffer->xLength )
+	{
+		xCount -= pxStreamBuffer->xLength;
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvSpacesInBuffer( const xSTREAM_BUFFER *pxStreamBuffer )
+{
+	return ( pxStreamBuffer->xLength - ( size_t ) 1 ) - prvBytesInBuffer( pxStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvSpaceRequired( const xSTREAM_BUFFER *pxStreamBuffer, size_t xDataLengthBytes )
+{
+size_t xRequired;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( unsigned portCHAR ) 0 )
+	{
+		xRequired = xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		/* A stream longer than the buffer is written in parts, so wait for
+		the buffer to empty at most. */
+		xRequired = xDataLengthBytes;
+		if( xRequired > pxStreamBuffer->xLength - ( size_t ) 1 )
+		{
+			xRequired = pxStreamBuffer->xLength - ( size_t ) 1;
+		}
+	}
+
+	return xRequired;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyIn( xSTREAM_BUFFER *pxStreamBuffer, size_t xIndex, const unsigned portCHAR *pucData, size_t xCount )
+{
+size_t xFirst;
+
+	/* Copy up to the end of the storage area, then wrap to the start. */
+	xFirst = pxStreamBuffer->xLength - xIndex;
+	if( xFirst > xCount )
+	{
+		xFirst = xCount;
+	}
+	memcpy( ( void * ) &( pxStreamBuffer->pucBuffer[ xIndex ] ), ( const void * ) pucData, xFirst );
+	memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirst ] ), xCount - xFirst );
+
+	xIndex += xCount;
+	if( xIndex >= pxStreamBuffer->xLength )
+	{
+		xIndex -= pxStreamBuffer->xLength;
+	}
+
+	return xIndex;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyOut( const xSTREAM_BUFFER *pxStreamBuffer, size_t xIndex, unsigned portCHAR *pucData, size_t xCount )
+{
+size_t xFirst;
+
+	xFirst = pxStreamBuffer->xLength - xIndex;
+	if( xFirst > xCount )
+	{
+		xFirst = xCount;
+	}
+	memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xIndex ] ), xFirst );
+	memcpy( ( void * ) &( pucData[ xFirst ] ), ( const void * ) pxStreamBuffer->pucBuffer, xCount - xFirst );
+
+	xIndex += xCount;
+	if( xIndex >= pxStreamBuffer->xLength )
+	{
+		xIndex -= pxStreamBuffer->xLength;
+	}
+
+	return xIndex;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWrite( xSTREAM_BUFFER *pxStreamBuffer, const void *pvTxData, size_t xDataLengthBytes )
+{
+size_t xSpace, xHead;
+
+	xSpace = prvSpacesInBuffer( pxStreamBuffer );
+	xHead = pxStreamBuffer->xHead;
+
+	/* Zero length messages are not stored, as they could not be told apart
+	from a failed receive. */
+	if( xDataLengthBytes == ( size_t ) 0 )
+	{
+		return ( size_t ) 0;
+	}
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( unsigned portCHAR ) 0 )
+	{
+		/* A message is written whole or not at all. */
+		if( xSpace < xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			return ( size_t ) 0;
+		}
+
+		xHead = prvCopyIn( pxStreamBuffer, xHead, ( const unsigned portCHAR * ) &xDataLengthBytes, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+	}
+	else
+	{
+		if( xDataLengthBytes > xSpace )
+		{
+			xDataLengthBytes = xSpace;
+		}
+
+	}
+
+	xHead = prvCopyIn( pxStreamBuffer, xHead, ( const unsigned portCHAR * ) pvTxData, xDataLengthBytes );
+
+	/* Only now can the reader see the data. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xHead = xHead;
+
+	return xDataLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvRead( xSTREAM_BUFFER *pxStreamBuffer, void *pvRxData, size_t xBufferLengthBytes )
+{
+size_t xAvailable, xTail, xCount;
+
+	xAvailable = prvBytesInBuffer( pxStreamBuffer );
+	xTail = pxStreamBuffer->xTail;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( unsigned portCHAR ) 0 )
+	{
+		/* The writer publishes the length and the message together, so if
+		anything is available a whole message is. */
+		if( xAvailable < sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			return ( size_t ) 0;
+		}
+
+		xTail = prvCopyOut( pxStreamBuffer, xTail, ( unsigned portCHAR * ) &xCount, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+
+		/* Leave a message that will not fit where it is. */
+		if( xCount > xBufferLengthBytes )
+		{
+			return ( size_t ) 0;
+		}
+	}
+	else
+	{
+		xCount = ( xAvailable < xBufferLengthBytes ) ? xAvailable : xBufferLengthBytes;
+
+		if( xCount == ( size_t ) 0 )
+		{
+			return ( size_t ) 0;
+		}
+	}
+
+	xTail = prvCopyOut( pxStreamBuffer, xTail, ( unsigned portCHAR * ) pvRxData, xCount );
+
+	/* The data must be copied out before the writer can reuse the space. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xTail = xTail;
+
+	return xCount;
+}
+
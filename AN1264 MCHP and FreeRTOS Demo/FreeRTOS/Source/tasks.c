@@ -52,6 +52,7 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "timers.h"
 #include "StackMacros.h"
 
 /*
@@ -80,7 +81,7 @@ typedef struct tskTaskControlBlock
 		unsigned portBASE_TYPE uxCriticalNesting;
 	#endif
 
-	#if ( configUSE_TRACE_FACILITY == 1 )
+	#if ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_TRACE_RECORDER == 1 )
 		unsigned portBASE_TYPE	uxTCBNumber;	/*< This is used for tracing the scheduler and making debugging easier only. */
 	#endif
 
@@ -93,7 +94,13 @@ typedef struct tskTaskControlBlock
 	#endif
 
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
-		unsigned portLONG ulRunTimeCounter;	 		/*< Used for calculating how much CPU time each task is utilising. */
+		unsigned long long ullRunTimeCounter;		/*< Used for calculating how much CPU time each task is utilising.  64 bits so it does not overflow. */
+		unsigned portLONG ulSwitchInCount;			/*< The number of times the task has been switched in. */
+	#endif
+
+	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+		volatile unsigned portLONG ulNotifiedValue;	/*< Count of notifications not yet taken by the task. */
+		volatile unsigned portCHAR ucNotifyState;	/*< One of the tskNOTIFY_ states below. */
 	#endif
 
 } tskTCB;
@@ -136,7 +143,7 @@ static xList xPendingReadyList;							/*< Tasks that have been readied while the
 static volatile unsigned portBASE_TYPE uxCurrentNumberOfTasks	= ( unsigned portBASE_TYPE ) 0;
 static volatile portTickType xTickCount							= ( portTickType ) 0;
 static unsigned portBASE_TYPE uxTopUsedPriority					= tskIDLE_PRIORITY;
-static volatile unsigned portBASE_TYPE uxTopReadyPriority		= tskIDLE_PRIORITY;
+static volatile unsigned portBASE_TYPE uxTopReadyPriority		= tskIDLE_PRIORITY;	/*< The highest ready priority, or a bitmap of ready priorities when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1. */
 static volatile signed portBASE_TYPE xSchedulerRunning			= pdFALSE;
 static volatile unsigned portBASE_TYPE uxSchedulerSuspended		= ( unsigned portBASE_TYPE ) pdFALSE;
 static volatile unsigned portBASE_TYPE uxMissedTicks			= ( unsigned portBASE_TYPE ) 0;
@@ -148,7 +155,11 @@ static unsigned portBASE_TYPE uxTaskNumber 						= ( unsigned portBASE_TYPE ) 0;
 
 	static portCHAR pcStatsString[ 50 ];
 	static unsigned portLONG ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
-	static void prvGenerateRunTimeStatsForTasksInList( const signed portCHAR *pcWriteBuffer, xList *pxList, unsigned portLONG ulTotalRunTime );
+	static unsigned long long ullRunTimeTotal = 0ULL;		/*< The run time accumulated by all tasks. */
+	static void prvGenerateRunTimeStatsForTasksInList( const signed portCHAR *pcWriteBuffer, xList *pxList, unsigned long long ullTotalRunTime );
+	static unsigned portBASE_TYPE prvListRunTimeStatusWithinSingleList( xTaskRunTimeStatus *pxTaskStatusArray, unsigned portBASE_TYPE uxArraySize, xList *pxList );
+	static void prvAccumulateRunTime( void );
+	static portCHAR *prvWriteUnsigned64( portCHAR *pcBuffer, unsigned long long ullValue );
 
 #endif
 
@@ -160,6 +171,13 @@ static unsigned portBASE_TYPE uxTaskNumber 						= ( unsigned portBASE_TYPE ) 0;
  */
 #define tskSTACK_FILL_BYTE	( 0xa5 )
 
+/*
+ * Values that can be held in the ucNotifyState member of the TCB.
+ */
+#define tskNOT_WAITING_NOTIFICATION		( ( unsigned portCHAR ) 0 )
+#define tskWAITING_NOTIFICATION			( ( unsigned portCHAR ) 1 )
+#define tskNOTIFICATION_RECEIVED		( ( unsigned portCHAR ) 2 )
+
 /*
  * Macros used by vListTask to indicate which state a task is in.
  */
@@ -222,6 +240,91 @@ static unsigned portBASE_TYPE uxTaskNumber 						= ( unsigned portBASE_TYPE ) 0;
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+
+	/* uxTopReadyPriority holds the priority of the highest priority ready
+	state task.  It is only ever raised when a task is made ready, so the
+	search for the next task walks down from it until a non-empty ready list
+	is found. */
+
+	#define taskRECORD_READY_PRIORITY( uxPriority )															\
+	{																										\
+		if( ( uxPriority ) > uxTopReadyPriority )															\
+		{																									\
+			uxTopReadyPriority = ( uxPriority );															\
+		}																									\
+	}
+
+	#define taskSELECT_HIGHEST_PRIORITY_TASK()																\
+	{																										\
+		/* Find the highest priority queue that contains ready tasks. */									\
+		while( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxTopReadyPriority ] ) ) )							\
+		{																									\
+			--uxTopReadyPriority;																			\
+		}																									\
+																											\
+		/* listGET_OWNER_OF_NEXT_ENTRY walks through the list, so the tasks of the							\
+		same priority get an equal share of the processor time. */											\
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopReadyPriority ] ) );			\
+	}
+
+	/* Nothing to do - uxTopReadyPriority is corrected by the search. */
+	#define taskRESET_READY_PRIORITY( uxPriority )
+
+#else
+
+	/* uxTopReadyPriority holds a bitmap with one bit set for each priority
+	that has at least one ready state task.  The highest set bit is found with
+	portGET_HIGHEST_PRIORITY(), so selecting the next task takes the same time
+	however many priorities are in use.  Ports that have a count leading zeros
+	instruction define portGET_HIGHEST_PRIORITY() in portmacro.h, otherwise
+	the table based prvGetHighestReadyPriority() is used. */
+
+	#ifndef portRECORD_READY_PRIORITY
+		#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( ( ( unsigned portBASE_TYPE ) 1 ) << ( uxPriority ) )
+	#endif
+
+	#ifndef portRESET_READY_PRIORITY
+		#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( ( ( unsigned portBASE_TYPE ) 1 ) << ( uxPriority ) )
+	#endif
+
+	#ifndef portGET_HIGHEST_PRIORITY
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = prvGetHighestReadyPriority( uxReadyPriorities )
+		#define tskUSE_GENERIC_HIGHEST_PRIORITY 1
+
+		/* prvGetHighestReadyPriority() searches at most 32 bits.  The port
+		checks configMAX_PRIORITIES against the width of its own
+		unsigned portBASE_TYPE. */
+		#if configMAX_PRIORITIES > 32
+			#error configMAX_PRIORITIES cannot exceed 32 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+		#endif
+	#endif
+
+	#define taskRECORD_READY_PRIORITY( uxPriority )	portRECORD_READY_PRIORITY( ( uxPriority ), uxTopReadyPriority )
+
+	#define taskSELECT_HIGHEST_PRIORITY_TASK()																\
+	{																										\
+	unsigned portBASE_TYPE uxTopPriority;																	\
+																											\
+		/* The idle task is always ready so at least one bit is set. */										\
+		portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );										\
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );				\
+	}
+
+	/* Must be called each time a task is removed from a list while it might
+	be in the ready list for uxPriority.  The bit is only cleared if no other
+	tasks of that priority remain ready. */
+	#define taskRESET_READY_PRIORITY( uxPriority )															\
+	{																										\
+		if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) )									\
+		{																									\
+			portRESET_READY_PRIORITY( ( uxPriority ), uxTopReadyPriority );									\
+		}																									\
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
 /*
  * Place the task represented by pxTCB into the appropriate ready queue for
  * the task.  It is inserted at the end of the list.  One quirk of this is
@@ -231,10 +334,7 @@ static unsigned portBASE_TYPE uxTaskNumber 						= ( unsigned portBASE_TYPE ) 0;
  */
 #define prvAddTaskToReadyQueue( pxTCB )																			\
 {																												\
-	if( pxTCB->uxPriority > uxTopReadyPriority )																\
-	{																											\
-		uxTopReadyPriority = pxTCB->uxPriority;																	\
-	}																											\
+	taskRECORD_READY_PRIORITY( pxTCB->uxPriority );																\
 	vListInsertEnd( ( xList * ) &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xGenericListItem ) );	\
 }
 /*-----------------------------------------------------------*/
@@ -330,6 +430,38 @@ static void prvCheckTasksWaitingTermination( void );
  */
 static tskTCB *prvAllocateTCBAndStack( unsigned portSHORT usStackDepth );
 
+/*
+ * Move the calling task from the ready list to the list of tasks blocked for
+ * xTicksToWait ticks.  If xTicksToWait is portMAX_DELAY and vTaskSuspend() is
+ * available the task is blocked indefinitely.  Must be called with
+ * interrupts disabled or the scheduler suspended.
+ */
+static void prvAddCurrentTaskToDelayedList( portTickType xTicksToWait );
+
+/*
+ * Used by the idle task when configUSE_TICKLESS_IDLE is set.  Returns the
+ * number of ticks until the next task leaves the delayed list, or zero if a
+ * task other than the idle task is ready to run.  The value is never allowed
+ * to reach past the next tick count overflow so the delayed lists are always
+ * swapped by vTaskIncrementTick().
+ */
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	static portTickType prvGetExpectedIdleTime( void );
+
+#endif
+
+/*
+ * Returns the number of the most significant bit set in uxReadyPriorities.
+ * Used to select the next task when configUSE_PORT_OPTIMISED_TASK_SELECTION
+ * is 1 but the port does not provide its own portGET_HIGHEST_PRIORITY().
+ */
+#ifdef tskUSE_GENERIC_HIGHEST_PRIORITY
+
+	static unsigned portBASE_TYPE prvGetHighestReadyPriority( unsigned portBASE_TYPE uxReadyPriorities );
+
+#endif
+
 /*
  * Called from vTaskList.  vListTasks details all the tasks currently under
  * control of the scheduler.  The tasks may be in one of a number of lists.
@@ -442,7 +574,7 @@ tskTCB * pxNewTCB;
 				uxTopUsedPriority = pxNewTCB->uxPriority;
 			}
 
-			#if ( configUSE_TRACE_FACILITY == 1 )
+			#if ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_TRACE_RECORDER == 1 )
 			{
 				/* Add a counter into the TCB for tracing only. */
 				pxNewTCB->uxTCBNumber = uxTaskNumber;
@@ -511,6 +643,7 @@ tskTCB * pxNewTCB;
 			the termination list and free up any memory allocated by the
 			scheduler for the TCB and stack. */
 			vListRemove( &( pxTCB->xGenericListItem ) );
+			taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 
 			/* Is the task waiting on an event also? */
 			if( pxTCB->xEventListItem.pvContainer )
@@ -600,6 +733,7 @@ tskTCB * pxNewTCB;
 				ourselves to the blocked list as the same list item is used for
 				both lists. */
 				vListRemove( ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+				taskRESET_READY_PRIORITY( pxCurrentTCB->uxPriority );
 
 				/* The list item will be inserted in wake time order. */
 				listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
@@ -661,6 +795,7 @@ tskTCB * pxNewTCB;
 				ourselves to the blocked list as the same list item is used for
 				both lists. */
 				vListRemove( ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+				taskRESET_READY_PRIORITY( pxCurrentTCB->uxPriority );
 
 				/* The list item will be inserted in wake time order. */
 				listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
@@ -804,6 +939,7 @@ tskTCB * pxNewTCB;
 					it to it's new ready list.  As we are in a critical section we
 					can do this even if the scheduler is suspended. */
 					vListRemove( &( pxTCB->xGenericListItem ) );
+					taskRESET_READY_PRIORITY( uxCurrentPriority );
 					prvAddTaskToReadyQueue( pxTCB );
 				}
 
@@ -841,6 +977,7 @@ tskTCB * pxNewTCB;
 
 			/* Remove task from the ready/delayed list and place in the	suspended list. */
 			vListRemove( &( pxTCB->xGenericListItem ) );
+			taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 
 			/* Is the task waiting on an event also? */
 			if( pxTCB->xEventListItem.pvContainer )
@@ -983,6 +1120,16 @@ portBASE_TYPE xReturn;
 	/* Add the idle task at the lowest priority. */
 	xReturn = xTaskCreate( prvIdleTask, ( signed portCHAR * ) "IDLE", tskIDLE_STACK_SIZE, ( void * ) NULL, tskIDLE_PRIORITY, ( xTaskHandle * ) NULL );
 
+	#if ( configUSE_TIMERS == 1 )
+	{
+		/* Add the timer service task, which runs the timer callbacks. */
+		if( xReturn == pdPASS )
+		{
+			xReturn = xTimerCreateTimerTask();
+		}
+	}
+	#endif
+
 	if( xReturn == pdPASS )
 	{
 		/* Interrupts are turned off here, to ensure a tick does not occur
@@ -1003,6 +1150,13 @@ portBASE_TYPE xReturn;
 		the run time counter time base. */
 		portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
 
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			/* Time is only accumulated from when the scheduler starts. */
+			ulTaskSwitchedInTime = portGET_RUN_TIME_COUNTER_VALUE();
+		}
+		#endif
+
 		/* Setting up the timer tick is hardware specific and thus in the
 		portable interface. */
 		if( xPortStartScheduler() )
@@ -1134,6 +1288,22 @@ portTickType xTicks;
 }
 /*-----------------------------------------------------------*/
 
+portTickType xTaskGetTickCountFromISR( void )
+{
+portTickType xTicks;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	/* As xTaskGetTickCount(), but an ISR cannot use a critical section. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		xTicks = xTickCount;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xTicks;
+}
+/*-----------------------------------------------------------*/
+
 unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 {
 	/* A critical section is not required because the variables are of type
@@ -1210,13 +1380,18 @@ unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 	void vTaskGetRunTimeStats( signed portCHAR *pcWriteBuffer )
 	{
 	unsigned portBASE_TYPE uxQueue;
-	unsigned portLONG ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+	unsigned long long ullTotalRunTime;
 
 		/* This is a VERY costly function that should be used for debug only.
 		It leaves interrupts disabled for a LONG time. */
 
         vTaskSuspendAll();
 		{
+			/* Include the time the calling task has run for since it was
+			last switched in. */
+			prvAccumulateRunTime();
+			ullTotalRunTime = ullRunTimeTotal;
+
 			/* Run through all the lists that could potentially contain a TCB,
 			generating a table of run timer percentages in the provided
 			buffer. */
@@ -1232,25 +1407,25 @@ unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 
 				if( !listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxQueue ] ) ) )
 				{
-					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &( pxReadyTasksLists[ uxQueue ] ), ulTotalRunTime );
+					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &( pxReadyTasksLists[ uxQueue ] ), ullTotalRunTime );
 				}
 			}while( uxQueue > ( unsigned portSHORT ) tskIDLE_PRIORITY );
 
 			if( !listLIST_IS_EMPTY( pxDelayedTaskList ) )
 			{
-				prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) pxDelayedTaskList, ulTotalRunTime );
+				prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) pxDelayedTaskList, ullTotalRunTime );
 			}
 
 			if( !listLIST_IS_EMPTY( pxOverflowDelayedTaskList ) )
 			{
-				prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) pxOverflowDelayedTaskList, ulTotalRunTime );
+				prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) pxOverflowDelayedTaskList, ullTotalRunTime );
 			}
 
 			#if ( INCLUDE_vTaskDelete == 1 )
 			{
 				if( !listLIST_IS_EMPTY( &xTasksWaitingTermination ) )
 				{
-					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &xTasksWaitingTermination, ulTotalRunTime );
+					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &xTasksWaitingTermination, ullTotalRunTime );
 				}
 			}
 			#endif
@@ -1259,7 +1434,7 @@ unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 			{
 				if( !listLIST_IS_EMPTY( &xSuspendedTaskList ) )
 				{
-					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &xSuspendedTaskList, ulTotalRunTime );
+					prvGenerateRunTimeStatsForTasksInList( pcWriteBuffer, ( xList * ) &xSuspendedTaskList, ullTotalRunTime );
 				}
 			}
 			#endif
@@ -1270,6 +1445,72 @@ unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 #endif
 /*----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	unsigned portBASE_TYPE uxTaskGetRunTimeSnapshot( xTaskRunTimeStatus *pxTaskStatusArray, unsigned portBASE_TYPE uxArraySize, unsigned long long *pullTotalRunTime )
+	{
+	unsigned portBASE_TYPE uxQueue, uxTask = 0;
+
+		/* The run time counters are only updated by vTaskSwitchContext(),
+		which does nothing while the scheduler is suspended, so suspending the
+		scheduler is enough to obtain a consistent snapshot. */
+		vTaskSuspendAll();
+		{
+			prvAccumulateRunTime();
+
+			if( pullTotalRunTime != NULL )
+			{
+				*pullTotalRunTime = ullRunTimeTotal;
+			}
+
+			uxQueue = uxTopUsedPriority + 1;
+
+			do
+			{
+				uxQueue--;
+
+				if( !listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxQueue ] ) ) )
+				{
+					uxTask += prvListRunTimeStatusWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), uxArraySize - uxTask, ( xList * ) &( pxReadyTasksLists[ uxQueue ] ) );
+				}
+			}while( uxQueue > ( unsigned portSHORT ) tskIDLE_PRIORITY );
+
+			if( !listLIST_IS_EMPTY( pxDelayedTaskList ) )
+			{
+				uxTask += prvListRunTimeStatusWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), uxArraySize - uxTask, ( xList * ) pxDelayedTaskList );
+			}
+
+			if( !listLIST_IS_EMPTY( pxOverflowDelayedTaskList ) )
+			{
+				uxTask += prvListRunTimeStatusWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), uxArraySize - uxTask, ( xList * ) pxOverflowDelayedTaskList );
+			}
+
+			#if ( INCLUDE_vTaskDelete == 1 )
+			{
+				if( !listLIST_IS_EMPTY( &xTasksWaitingTermination ) )
+				{
+					uxTask += prvListRunTimeStatusWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), uxArraySize - uxTask, ( xList * ) &xTasksWaitingTermination );
+				}
+			}
+			#endif
+
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				if( !listLIST_IS_EMPTY( &xSuspendedTaskList ) )
+				{
+					uxTask += prvListRunTimeStatusWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), uxArraySize - uxTask, ( xList * ) &xSuspendedTaskList );
+				}
+			}
+			#endif
+		}
+		xTaskResumeAll();
+
+		return uxTask;
+	}
+
+#endif
+/*----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
 	void vTaskStartTrace( signed portCHAR * pcBuffer, unsigned portLONG ulBufferSize )
@@ -1306,6 +1547,141 @@ unsigned portBASE_TYPE uxTaskGetNumberOfTasks( void )
 
 
 
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	unsigned portLONG ulTaskNotifyTake( portBASE_TYPE xClearCountOnExit, portTickType xTicksToWait )
+	{
+	unsigned portLONG ulReturn;
+
+		taskENTER_CRITICAL();
+		{
+			/* Only block if the notification count is not already non-zero. */
+			if( ( pxCurrentTCB->ulNotifiedValue == 0UL ) && ( xTicksToWait > ( portTickType ) 0 ) )
+			{
+				/* The task is not placed on an event list - the notifying task
+				or ISR goes straight to the TCB to unblock it. */
+				pxCurrentTCB->ucNotifyState = tskWAITING_NOTIFICATION;
+				prvAddCurrentTaskToDelayedList( xTicksToWait );
+
+				/* Depending on the port the switch may not occur until the
+				critical section is exited. */
+				taskYIELD();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		taskENTER_CRITICAL();
+		{
+			ulReturn = pxCurrentTCB->ulNotifiedValue;
+
+			if( ulReturn != 0UL )
+			{
+				if( xClearCountOnExit != pdFALSE )
+				{
+					pxCurrentTCB->ulNotifiedValue = 0UL;
+				}
+				else
+				{
+					pxCurrentTCB->ulNotifiedValue = ulReturn - 1UL;
+				}
+			}
+
+			pxCurrentTCB->ucNotifyState = tskNOT_WAITING_NOTIFICATION;
+		}
+		taskEXIT_CRITICAL();
+
+		return ulReturn;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	signed portBASE_TYPE xTaskNotifyGive( xTaskHandle xTaskToNotify )
+	{
+	tskTCB *pxTCB;
+	unsigned portCHAR ucOriginalNotifyState;
+
+		pxTCB = ( tskTCB * ) xTaskToNotify;
+
+		taskENTER_CRITICAL();
+		{
+			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			pxTCB->ucNotifyState = tskNOTIFICATION_RECEIVED;
+			( pxTCB->ulNotifiedValue )++;
+
+			/* If the task was blocked waiting for a notification then it is
+			in either a delayed or the suspended list, never an event list. */
+			if( ucOriginalNotifyState == tskWAITING_NOTIFICATION )
+			{
+				vListRemove( &( pxTCB->xGenericListItem ) );
+				prvAddTaskToReadyQueue( pxTCB );
+
+				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				{
+					/* The notified task has a priority above the currently
+					executing task so a yield is required. */
+					taskYIELD();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return pdPASS;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	signed portBASE_TYPE xTaskNotifyFromISR( xTaskHandle xTaskToNotify, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+	{
+	tskTCB *pxTCB;
+	unsigned portCHAR ucOriginalNotifyState;
+	unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+		pxTCB = ( tskTCB * ) xTaskToNotify;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			pxTCB->ucNotifyState = tskNOTIFICATION_RECEIVED;
+			( pxTCB->ulNotifiedValue )++;
+
+			if( ucOriginalNotifyState == tskWAITING_NOTIFICATION )
+			{
+				if( uxSchedulerSuspended == ( unsigned portBASE_TYPE ) pdFALSE )
+				{
+					vListRemove( &( pxTCB->xGenericListItem ) );
+					prvAddTaskToReadyQueue( pxTCB );
+				}
+				else
+				{
+					/* The delayed and ready lists cannot be accessed, so hold
+					the task pending until the scheduler is resumed.  The event
+					list item is free as the task is not waiting on a queue. */
+					vListInsertEnd( ( xList * ) &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+				}
+
+				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				{
+					/* As xTaskNotifyGive(), only ask for a switch when the
+					notified task is above the interrupted one. */
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return pdPASS;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
  * documented in task.h
@@ -1368,6 +1744,70 @@ void vTaskIncrementTick( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	void vTaskStepTick( portTickType xTicksToJump )
+	{
+		/* Called by the port on waking from a tickless sleep.  The sleep was
+		limited by prvGetExpectedIdleTime() so the jump cannot move the tick
+		count past the time at which a delayed task must be unblocked, or past
+		the point at which the delayed lists must be swapped. */
+		xTickCount += xTicksToJump;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	portBASE_TYPE xTaskConfirmSleepModeStatus( void )
+	{
+	portBASE_TYPE xReturn = pdTRUE;
+	#if ( configUSE_PREEMPTION == 0 )
+		unsigned portBASE_TYPE uxQueue;
+	#endif
+
+		/* Called with interrupts disabled, so nothing can change while the
+		lists and flags below are inspected. */
+		if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != ( unsigned portBASE_TYPE ) 0 )
+		{
+			/* An interrupt readied a task while the scheduler was suspended. */
+			xReturn = pdFALSE;
+		}
+		else if( xMissedYield != pdFALSE )
+		{
+			/* A context switch was requested while the scheduler was
+			suspended. */
+			xReturn = pdFALSE;
+		}
+		else if( uxMissedTicks != ( unsigned portBASE_TYPE ) 0 )
+		{
+			/* A tick occurred after the expected idle time was calculated, so
+			the calculation is no longer valid. */
+			xReturn = pdFALSE;
+		}
+
+		#if ( configUSE_PREEMPTION == 0 )
+		{
+			/* Without preemption a task readied by an interrupt does not run
+			until the idle task next yields, so the idle task must not sleep
+			while any task above the idle priority is ready. */
+			for( uxQueue = uxTopUsedPriority; uxQueue > tskIDLE_PRIORITY; uxQueue-- )
+			{
+				if( !listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxQueue ] ) ) )
+				{
+					xReturn = pdFALSE;
+				}
+			}
+		}
+		#endif
+
+		return xReturn;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_vTaskCleanUpResources == 1 ) && ( INCLUDE_vTaskSuspend == 1 ) )
 
 	void vTaskCleanUpResources( void )
@@ -1510,6 +1950,10 @@ void vTaskIncrementTick( void )
 
 void vTaskSwitchContext( void )
 {
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+	tskTCB *pxPreviousTCB;
+#endif
+
 	if( uxSchedulerSuspended != ( unsigned portBASE_TYPE ) pdFALSE )
 	{
 		/* The scheduler is currently suspended - do not allow a context
@@ -1522,30 +1966,26 @@ void vTaskSwitchContext( void )
 
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
-		unsigned portLONG ulTempCounter = portGET_RUN_TIME_COUNTER_VALUE();
-
-			/* Add the amount of time the task has been running to the accumulated
-			time so far.  The time the task started running was stored in
-			ulTaskSwitchedInTime.  Note that there is no overflow protection here
-			so count values are only valid until the timer overflows.  Generally
-			this will be about 1 hour assuming a 1uS timer increment. */
-			pxCurrentTCB->ulRunTimeCounter += ( ulTempCounter - ulTaskSwitchedInTime );
-			ulTaskSwitchedInTime = ulTempCounter;
+		/* Add the amount of time the task has been running to the accumulated
+		time so far. */
+		prvAccumulateRunTime();
+		pxPreviousTCB = pxCurrentTCB;
 	}
 	#endif
 
 	taskFIRST_CHECK_FOR_STACK_OVERFLOW();
 	taskSECOND_CHECK_FOR_STACK_OVERFLOW();
 
-	/* Find the highest priority queue that contains ready tasks. */
-	while( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxTopReadyPriority ] ) ) )
+	taskSELECT_HIGHEST_PRIORITY_TASK();
+
+	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
-		--uxTopReadyPriority;
+		if( pxCurrentTCB != pxPreviousTCB )
+		{
+			pxCurrentTCB->ulSwitchInCount++;
+		}
 	}
-
-	/* listGET_OWNER_OF_NEXT_ENTRY walks through the list, so the tasks of the
-	same priority get an equal share of the processor time. */
-	listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopReadyPriority ] ) );
+	#endif
 
 	traceTASK_SWITCHED_IN();
 	vWriteTraceToBuffer();
@@ -1554,8 +1994,6 @@ void vTaskSwitchContext( void )
 
 void vTaskPlaceOnEventList( const xList * const pxEventList, portTickType xTicksToWait )
 {
-portTickType xTimeToWake;
-
 	/* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED OR THE
 	SCHEDULER SUSPENDED. */
 
@@ -1564,61 +2002,7 @@ portTickType xTimeToWake;
 	is the first to be woken by the event. */
 	vListInsert( ( xList * ) pxEventList, ( xListItem * ) &( pxCurrentTCB->xEventListItem ) );
 
-	/* We must remove ourselves from the ready list before adding ourselves
-	to the blocked list as the same list item is used for both lists.  We have
-	exclusive access to the ready lists as the scheduler is locked. */
-	vListRemove( ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-
-
-	#if ( INCLUDE_vTaskSuspend == 1 )
-	{
-		if( xTicksToWait == portMAX_DELAY )
-		{
-			/* Add ourselves to the suspended task list instead of a delayed task
-			list to ensure we are not woken by a timing event.  We will block
-			indefinitely. */
-			vListInsertEnd( ( xList * ) &xSuspendedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-		}
-		else
-		{
-			/* Calculate the time at which the task should be woken if the event does
-			not occur.  This may overflow but this doesn't matter. */
-			xTimeToWake = xTickCount + xTicksToWait;
-
-			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
-
-			if( xTimeToWake < xTickCount )
-			{
-				/* Wake time has overflowed.  Place this item in the overflow list. */
-				vListInsert( ( xList * ) pxOverflowDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-			}
-			else
-			{
-				/* The wake time has not overflowed, so we can use the current block list. */
-				vListInsert( ( xList * ) pxDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-			}
-		}
-	}
-	#else
-	{
-			/* Calculate the time at which the task should be woken if the event does
-			not occur.  This may overflow but this doesn't matter. */
-			xTimeToWake = xTickCount + xTicksToWait;
-
-			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
-
-			if( xTimeToWake < xTickCount )
-			{
-				/* Wake time has overflowed.  Place this item in the overflow list. */
-				vListInsert( ( xList * ) pxOverflowDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-			}
-			else
-			{
-				/* The wake time has not overflowed, so we can use the current block list. */
-				vListInsert( ( xList * ) pxDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
-			}
-	}
-	#endif
+	prvAddCurrentTaskToDelayedList( xTicksToWait );
 }
 /*-----------------------------------------------------------*/
 
@@ -1785,6 +2169,39 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 			vApplicationIdleHook();
 		}
 		#endif
+
+		#if ( configUSE_TICKLESS_IDLE != 0 )
+		{
+		portTickType xExpectedIdleTime;
+
+			/* It is not desirable to suspend then resume the scheduler on
+			each iteration of the idle task, so a first estimate of the idle
+			time is made without the scheduler suspended.  The result may be
+			stale by the time it is used. */
+			xExpectedIdleTime = prvGetExpectedIdleTime();
+
+			if( xExpectedIdleTime >= ( portTickType ) configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+			{
+				vTaskSuspendAll();
+				{
+					/* Now the scheduler is suspended the delayed lists cannot
+					change, so the expected idle time can be sampled again and
+					this time the value can be used. */
+					xExpectedIdleTime = prvGetExpectedIdleTime();
+
+					if( xExpectedIdleTime >= ( portTickType ) configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+					{
+						/* The port stops the tick, sleeps until either an
+						interrupt occurs or xExpectedIdleTime ticks have
+						passed, then calls vTaskStepTick() to correct the
+						tick count. */
+						portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime );
+					}
+				}
+				xTaskResumeAll();
+			}
+		}
+		#endif
 	}
 } /*lint !e715 pvParameters is not accessed but all task functions require the same prototype. */
 
@@ -1800,6 +2217,53 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
 
 
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	static portTickType prvGetExpectedIdleTime( void )
+	{
+	portTickType xReturn, xTicksToOverflow;
+
+		/* The delayed lists are only swapped by vTaskIncrementTick(), so the
+		tick at which the count overflows must never be skipped. */
+		xTicksToOverflow = ( portTickType ) 0 - xTickCount;
+		if( xTicksToOverflow == ( portTickType ) 0 )
+		{
+			xTicksToOverflow = portMAX_DELAY;
+		}
+
+		if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
+		{
+			/* The idle task is running with an inherited priority, or a
+			higher priority task is about to run. */
+			xReturn = ( portTickType ) 0;
+		}
+		else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( unsigned portBASE_TYPE ) 1 )
+		{
+			/* Other tasks share the idle priority and are ready, so the
+			processor must not sleep if time slicing is to be maintained. */
+			xReturn = ( portTickType ) 0;
+		}
+		else if( !listLIST_IS_EMPTY( pxDelayedTaskList ) )
+		{
+			/* The delayed list is ordered by wake time so the head entry
+			holds the next time at which a task must be unblocked. */
+			xReturn = listGET_LIST_ITEM_VALUE( ( pxDelayedTaskList )->xListEnd.pxNext ) - xTickCount;
+		}
+		else
+		{
+			/* Nothing is blocked with a wake time before the next overflow,
+			although tasks may be on the overflow list. */
+			xReturn = xTicksToOverflow;
+		}
+
+		return xReturn;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+
+
 static void prvInitialiseTCBVariables( tskTCB *pxTCB, const signed portCHAR * const pcName, unsigned portBASE_TYPE uxPriority )
 {
 	/* Store the function name in the TCB. */
@@ -1849,7 +2313,15 @@ static void prvInitialiseTCBVariables( tskTCB *pxTCB, const signed portCHAR * co
 
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
-		pxTCB->ulRunTimeCounter = 0UL;
+		pxTCB->ullRunTimeCounter = 0ULL;
+		pxTCB->ulSwitchInCount = 0UL;
+	}
+	#endif
+
+	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+	{
+		pxTCB->ulNotifiedValue = 0UL;
+		pxTCB->ucNotifyState = tskNOT_WAITING_NOTIFICATION;
 	}
 	#endif
 }
@@ -1922,6 +2394,69 @@ static void prvCheckTasksWaitingTermination( void )
 }
 /*-----------------------------------------------------------*/
 
+static void prvAddCurrentTaskToDelayedList( portTickType xTicksToWait )
+{
+portTickType xTimeToWake;
+
+	/* We must remove ourselves from the ready list before adding ourselves
+	to the blocked list as the same list item is used for both lists.  We have
+	exclusive access to the ready lists as the scheduler or interrupts are
+	locked. */
+	vListRemove( ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+	taskRESET_READY_PRIORITY( pxCurrentTCB->uxPriority );
+
+	#if ( INCLUDE_vTaskSuspend == 1 )
+	{
+		if( xTicksToWait == portMAX_DELAY )
+		{
+			/* Add ourselves to the suspended task list instead of a delayed task
+			list to ensure we are not woken by a timing event.  We will block
+			indefinitely. */
+			vListInsertEnd( ( xList * ) &xSuspendedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+		}
+		else
+		{
+			/* Calculate the time at which the task should be woken if the event does
+			not occur.  This may overflow but this doesn't matter. */
+			xTimeToWake = xTickCount + xTicksToWait;
+
+			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
+
+			if( xTimeToWake < xTickCount )
+			{
+				/* Wake time has overflowed.  Place this item in the overflow list. */
+				vListInsert( ( xList * ) pxOverflowDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+			}
+			else
+			{
+				/* The wake time has not overflowed, so we can use the current block list. */
+				vListInsert( ( xList * ) pxDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+			}
+		}
+	}
+	#else
+	{
+			/* Calculate the time at which the task should be woken if the event does
+			not occur.  This may overflow but this doesn't matter. */
+			xTimeToWake = xTickCount + xTicksToWait;
+
+			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xGenericListItem ), xTimeToWake );
+
+			if( xTimeToWake < xTickCount )
+			{
+				/* Wake time has overflowed.  Place this item in the overflow list. */
+				vListInsert( ( xList * ) pxOverflowDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+			}
+			else
+			{
+				/* The wake time has not overflowed, so we can use the current block list. */
+				vListInsert( ( xList * ) pxDelayedTaskList, ( xListItem * ) &( pxCurrentTCB->xGenericListItem ) );
+			}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
 static tskTCB *prvAllocateTCBAndStack( unsigned portSHORT usStackDepth )
 {
 tskTCB *pxNewTCB;
@@ -1978,10 +2513,11 @@ tskTCB *pxNewTCB;
 
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
-	static void prvGenerateRunTimeStatsForTasksInList( const signed portCHAR *pcWriteBuffer, xList *pxList, unsigned portLONG ulTotalRunTime )
+	static void prvGenerateRunTimeStatsForTasksInList( const signed portCHAR *pcWriteBuffer, xList *pxList, unsigned long long ullTotalRunTime )
 	{
 	volatile tskTCB *pxNextTCB, *pxFirstTCB;
 	unsigned portLONG ulStatsAsPercentage;
+	portCHAR *pcNext;
 
 		/* Write the run time stats of all the TCB's in pxList into the buffer. */
 		listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );
@@ -1991,30 +2527,26 @@ tskTCB *pxNewTCB;
 			listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
 
 			/* Divide by zero check. */
-			if( ulTotalRunTime > 0UL )
+			if( ullTotalRunTime > 0ULL )
 			{
-				/* Has the task run at all? */
-				if( pxNextTCB->ulRunTimeCounter == 0 )
+				/* The run time is 64 bits, which not all printf
+				implementations can format, so it is written separately. */
+				sprintf( pcStatsString, ( portCHAR * ) "%s\t\t", pxNextTCB->pcTaskName );
+				pcNext = prvWriteUnsigned64( pcStatsString + strlen( pcStatsString ), pxNextTCB->ullRunTimeCounter );
+
+				/* What percentage of the total run time as the task used?
+				This will always be rounded down to the nearest integer. */
+				ulStatsAsPercentage = ( unsigned portLONG ) ( ( 100ULL * pxNextTCB->ullRunTimeCounter ) / ullTotalRunTime );
+
+				if( ( ulStatsAsPercentage > 0UL ) || ( pxNextTCB->ullRunTimeCounter == 0ULL ) )
 				{
-					/* The task has used no CPU time at all. */
-					sprintf( pcStatsString, ( portCHAR * ) "%s\t\t0\t\t0%%\r\n", pxNextTCB->pcTaskName );
+					sprintf( pcNext, ( portCHAR * ) "\t\t%u%%\r\n", ( unsigned int ) ulStatsAsPercentage );
 				}
 				else
 				{
-					/* What percentage of the total run time as the task used?
-					This will always be rounded down to the nearest integer. */
-					ulStatsAsPercentage = ( 100UL * pxNextTCB->ulRunTimeCounter ) / ulTotalRunTime;
-
-					if( ulStatsAsPercentage > 0UL )
-					{
-						sprintf( pcStatsString, ( portCHAR * ) "%s\t\t%u\t\t%u%%\r\n", pxNextTCB->pcTaskName, ( unsigned int ) pxNextTCB->ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage );
-					}
-					else
-					{
-						/* If the percentage is zero here then the task has
-						consumed less than 1% of the total run time. */
-						sprintf( pcStatsString, ( portCHAR * ) "%s\t\t%u\t\t<1%%\r\n", pxNextTCB->pcTaskName, ( unsigned int ) pxNextTCB->ulRunTimeCounter );
-					}
+					/* If the percentage is zero here then the task has
+					consumed less than 1% of the total run time. */
+					sprintf( pcNext, ( portCHAR * ) "\t\t<1%%\r\n" );
 				}
 
 				strcat( ( portCHAR * ) pcWriteBuffer, ( portCHAR * ) pcStatsString );
@@ -2026,6 +2558,84 @@ tskTCB *pxNewTCB;
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	static unsigned portBASE_TYPE prvListRunTimeStatusWithinSingleList( xTaskRunTimeStatus *pxTaskStatusArray, unsigned portBASE_TYPE uxArraySize, xList *pxList )
+	{
+	volatile tskTCB *pxNextTCB, *pxFirstTCB;
+	unsigned portBASE_TYPE uxTask = 0;
+
+		listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );
+		do
+		{
+			listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
+
+			if( uxTask < uxArraySize )
+			{
+				pxTaskStatusArray[ uxTask ].xHandle = ( xTaskHandle ) pxNextTCB;
+				pxTaskStatusArray[ uxTask ].pcTaskName = ( const signed portCHAR * ) pxNextTCB->pcTaskName;
+				pxTaskStatusArray[ uxTask ].uxCurrentPriority = pxNextTCB->uxPriority;
+				pxTaskStatusArray[ uxTask ].ullRunTimeCounter = pxNextTCB->ullRunTimeCounter;
+				pxTaskStatusArray[ uxTask ].ulSwitchInCount = pxNextTCB->ulSwitchInCount;
+				uxTask++;
+			}
+
+		} while( pxNextTCB != pxFirstTCB );
+
+		return uxTask;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	static void prvAccumulateRunTime( void )
+	{
+	unsigned portLONG ulTempCounter, ulElapsed;
+
+		/* Called either from vTaskSwitchContext() or with the scheduler
+		suspended.  The subtraction is performed at the width of the counter,
+		so gives the right answer when the counter wraps provided no task runs
+		for an entire counter period without being switched out.  The result
+		is accumulated into 64 bits so the totals themselves never wrap. */
+		ulTempCounter = portGET_RUN_TIME_COUNTER_VALUE();
+		ulElapsed = ulTempCounter - ulTaskSwitchedInTime;
+		ulTaskSwitchedInTime = ulTempCounter;
+
+		pxCurrentTCB->ullRunTimeCounter += ulElapsed;
+		ullRunTimeTotal += ulElapsed;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	static portCHAR *prvWriteUnsigned64( portCHAR *pcBuffer, unsigned long long ullValue )
+	{
+	portCHAR cDigits[ 20 ];
+	unsigned portBASE_TYPE uxDigits = 0;
+
+		/* Generate the digits least significant first. */
+		do
+		{
+			cDigits[ uxDigits++ ] = ( portCHAR ) ( '0' + ( portCHAR ) ( ullValue % 10ULL ) );
+			ullValue /= 10ULL;
+		} while( ullValue != 0ULL );
+
+		while( uxDigits > 0 )
+		{
+			*pcBuffer++ = cDigits[ --uxDigits ];
+		}
+		*pcBuffer = 0x00;
+
+		return pcBuffer;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
 
 	unsigned portSHORT usTaskCheckFreeStackSpace( const unsigned portCHAR * pucStackByte )
@@ -2136,6 +2746,8 @@ tskTCB *pxNewTCB;
 
 		if( pxTCB->uxPriority < pxCurrentTCB->uxPriority )
 		{
+			traceTASK_PRIORITY_INHERIT( pxTCB, pxCurrentTCB->uxPriority );
+
 			/* Adjust the mutex holder state to account for its new priority. */
 			listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), configMAX_PRIORITIES - ( portTickType ) pxCurrentTCB->uxPriority );
 
@@ -2144,6 +2756,7 @@ tskTCB *pxNewTCB;
 			if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xGenericListItem ) ) )
 			{
 				vListRemove( &( pxTCB->xGenericListItem ) );
+				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 
 				/* Inherit the priority before being moved into the new list. */
 				pxTCB->uxPriority = pxCurrentTCB->uxPriority;
@@ -2170,9 +2783,12 @@ tskTCB *pxNewTCB;
 		{
 			if( pxTCB->uxPriority != pxTCB->uxBasePriority )
 			{
+				traceTASK_PRIORITY_DISINHERIT( pxTCB, pxTCB->uxBasePriority );
+
 				/* We must be the running task to be able to give the mutex back.
 				Remove ourselves from the ready list we currently appear in. */
 				vListRemove( &( pxTCB->xGenericListItem ) );
+				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 
 				/* Disinherit the priority before adding ourselves into the new
 				ready list. */
@@ -2222,6 +2838,48 @@ void vTaskExitCritical( void )
 #endif
 /*-----------------------------------------------------------*/
 
+#ifdef tskUSE_GENERIC_HIGHEST_PRIORITY
 
+	static unsigned portBASE_TYPE prvGetHighestReadyPriority( unsigned portBASE_TYPE uxReadyPriorities )
+	{
+	/* The most significant bit set in each of the values 0 to 15. */
+	static const unsigned portCHAR ucHighestBit[ 16 ] = { 0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3 };
+	unsigned portLONG ulBits = ( unsigned portLONG ) uxReadyPriorities;
+	unsigned portBASE_TYPE uxTopPriority = 0;
+
+		/* Narrow the search down to four bits, then look the answer up.  The
+		tests only depend on configMAX_PRIORITIES so the compiler removes those
+		that are not needed, and the time taken does not depend on which
+		priorities are ready. */
+		if( configMAX_PRIORITIES > 16 )
+		{
+			if( ( ulBits >> 16 ) != 0UL )
+			{
+				ulBits >>= 16;
+				uxTopPriority += 16;
+			}
+		}
+
+		if( configMAX_PRIORITIES > 8 )
+		{
+			if( ( ulBits >> 8 ) != 0UL )
+			{
+				ulBits >>= 8;
+				uxTopPriority += 8;
+			}
+		}
+
+		if( configMAX_PRIORITIES > 4 )
+		{
+			if( ( ulBits >> 4 ) != 0UL )
+			{
+				ulBits >>= 4;
+				uxTopPriority += 4;
+			}
+		}
 
+		return uxTopPriority + ( unsigned portBASE_TYPE ) ucHighestBit[ ulBits & 0x0fUL ];
+	}
 
+#endif
+/*-----------------------------------------------------------*/
@@ -0,0 +1,242 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+/*-----------------------------------------------------------
+ * PUBLIC TRACE RECORDER API documented in trace.h
+ *----------------------------------------------------------*/
+
+/* The buffer the events are written to.  Not static so it can be located
+and saved by the debugger.  The header is valid from reset, so the buffer can
+be decoded whenever it is read. */
+xTraceBuffer xTraceRecorderBuffer =
+{
+	{
+		traceMAGIC,
+		traceVERSION,
+		sizeof( xTraceRecord ),
+		configTRACE_TIMESTAMP_HZ,
+		configTRACE_BUFFER_RECORDS,
+		0UL,
+		0UL,
+		configTRACE_MAX_TASKS,
+		configTRACE_MAX_QUEUES,
+		configMAX_TASK_NAME_LEN,
+		1
+	},
+	{ { 0UL, 0, 0, 0 } },
+	{ { 0 } },
+	{ { 0 } },
+	{ 0 }
+};
+
+volatile uint8_t ucTraceCurrentTask = traceNO_TASK;
+
+/* The number given to the next queue created. */
+static uint8_t ucNextQueueNumber = 0;
+
+/*
+ * Write one record to the buffer, overwriting the oldest record if the
+ * buffer is full.  Called from tasks and interrupts alike.
+ */
+static void prvWriteRecord( uint8_t ucEvent, uint8_t ucTask, uint16_t usObject );
+
+/*
+ * Copy a name into one of the name tables, truncating or padding it to the
+ * table width.
+ */
+static void prvCopyName( char *pcDestination, const signed portCHAR *pcName );
+
+/*-----------------------------------------------------------*/
+
+static void prvWriteRecord( uint8_t ucEvent, uint8_t ucTask, uint16_t usObject )
+{
+xTraceRecord *pxRecord;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( xTraceRecorderBuffer.xHeader.ucRecording != 0 )
+		{
+			pxRecord = &( xTraceRecorderBuffer.xRecords[ xTraceRecorderBuffer.xHeader.ulNextRecord ] );
+			pxRecord->ulTimestamp = ( uint32_t ) configTRACE_TIMESTAMP();
+			pxRecord->ucEvent = ucEvent;
+			pxRecord->ucTask = ucTask;
+			pxRecord->usObject = usObject;
+
+			xTraceRecorderBuffer.xHeader.ulNextRecord++;
+			if( xTraceRecorderBuffer.xHeader.ulNextRecord >= ( uint32_t ) configTRACE_BUFFER_RECORDS )
+			{
+				xTraceRecorderBuffer.xHeader.ulNextRecord = 0UL;
+			}
+			xTraceRecorderBuffer.xHeader.ulRecordsWritten++;
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyName( char *pcDestination, const signed portCHAR *pcName )
+{
+unsigned portBASE_TYPE x;
+
+	for( x = 0; x < ( unsigned portBASE_TYPE ) configMAX_TASK_NAME_LEN; x++ )
+	{
+		pcDestination[ x ] = ( char ) pcName[ x ];
+		if( pcName[ x ] == 0x00 )
+		{
+			break;
+		}
+	}
+
+	/* Pad the rest of the entry so the decoder never sees stale characters. */
+	for( ; x < ( unsigned portBASE_TYPE ) configMAX_TASK_NAME_LEN; x++ )
+	{
+		pcDestination[ x ] = 0x00;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTraceStart( void )
+{
+	portENTER_CRITICAL();
+	{
+		xTraceRecorderBuffer.xHeader.ulNextRecord = 0UL;
+		xTraceRecorderBuffer.xHeader.ulRecordsWritten = 0UL;
+		xTraceRecorderBuffer.xHeader.ucRecording = 1;
+
+		/* Record the running task so the trace does not start with an
+		unattributed gap. */
+		prvWriteRecord( traceEVENT_SWITCH, ucTraceCurrentTask, traceNO_TASK );
+	}
+	portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTraceStop( void )
+{
+	xTraceRecorderBuffer.xHeader.ucRecording = 0;
+}
+/*-----------------------------------------------------------*/
+
+void *pvTraceGetBuffer( void )
+{
+	return ( void * ) &xTraceRecorderBuffer;
+}
+/*-----------------------------------------------------------*/
+
+unsigned portLONG ulTraceGetBufferSize( void )
+{
+	return ( unsigned portLONG ) sizeof( xTraceRecorderBuffer );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceTaskSwitchedIn( uint8_t ucTask )
+{
+	/* Called from within the scheduler so interrupts are already masked or
+	the scheduler is suspended. */
+	prvWriteRecord( traceEVENT_SWITCH, ucTask, ( uint16_t ) ucTraceCurrentTask );
+	ucTraceCurrentTask = ucTask;
+}
+/*-----------------------------------------------------------*/
+
+void vTraceTaskCreated( uint8_t ucTask, const signed portCHAR *pcName )
+{
+	if( ucTask < ( uint8_t ) configTRACE_MAX_TASKS )
+	{
+		prvCopyName( xTraceRecorderBuffer.cTaskNames[ ucTask ], pcName );
+	}
+
+	prvWriteRecord( traceEVENT_TASK_CREATE, ucTraceCurrentTask, ( uint16_t ) ucTask );
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucTraceQueueCreated( uint8_t ucType )
+{
+uint8_t ucQueue;
+
+	portENTER_CRITICAL();
+	{
+		ucQueue = ucNextQueueNumber;
+		if( ucNextQueueNumber < ( uint8_t ) 0xff )
+		{
+			ucNextQueueNumber++;
+		}
+	}
+	portEXIT_CRITICAL();
+
+	if( ucQueue < ( uint8_t ) configTRACE_MAX_QUEUES )
+	{
+		xTraceRecorderBuffer.ucQueueTypes[ ucQueue ] = ucType;
+	}
+
+	return ucQueue;
+}
+/*-----------------------------------------------------------*/
+
+void vTraceSetQueueName( uint8_t ucQueue, const signed portCHAR *pcName )
+{
+	if( ucQueue < ( uint8_t ) configTRACE_MAX_QUEUES )
+	{
+		prvCopyName( xTraceRecorderBuffer.cQueueNames[ ucQueue ], pcName );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRecordEvent( uint8_t ucEvent, uint16_t usObject )
+{
+	prvWriteRecord( ucEvent, ucTraceCurrentTask, usObject );
+}
+
+#endif /* configUSE_TRACE_RECORDER */
+
@@ -0,0 +1,586 @@
+/*
+	FreeRTOS V5.4.2 - Copyright (C) 2009 Real Time Engineers Ltd.
+
+	This file is part of the FreeRTOS distribution.
+
+	FreeRTOS is free software; you can redistribute it and/or modify it	under 
+	the terms of the GNU General Public License (version 2) as published by the 
+	Free Software Foundation and modified by the FreeRTOS exception.
+	**NOTE** The exception to the GPL is included to allow you to distribute a
+	combined work that includes FreeRTOS without being obliged to provide the 
+	source code for proprietary components outside of the FreeRTOS kernel.  
+	Alternative commercial license and support terms are also available upon 
+	request.  See the licensing section of http://www.FreeRTOS.org for full 
+	license details.
+
+	FreeRTOS is distributed in the hope that it will be useful,	but WITHOUT
+	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+	FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+	more details.
+
+	You should have received a copy of the GNU General Public License along
+	with FreeRTOS; if not, write to the Free Software Foundation, Inc., 59
+	Temple Place, Suite 330, Boston, MA  02111-1307  USA.
+
+
+	***************************************************************************
+	*                                                                         *
+	* Looking for a quick start?  Then check out the FreeRTOS eBook!          *
+	* See http://www.FreeRTOS.org/Documentation for details                   *
+	*                                                                         *
+	***************************************************************************
+
+	1 tab == 4 spaces!
+
+	Please ensure to read the configuration and relevant port sections of the
+	online documentation.
+
+	http://www.FreeRTOS.org - Documentation, latest information, license and
+	contact details.
+
+	http://www.SafeRTOS.com - A version that is certified for use in safety
+	critical systems.
+
+	http://www.OpenRTOS.com - Commercial support, development, porting,
+	licensing and training services.
+*/
+
+
+/*
+ * Converts a buffer captured by the binary trace recorder (trace.c) into the
+ * Chrome trace event format, which can be opened with chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ *		tracedecode [-o trace.json] trace.bin
+ *
+ * trace.bin is a copy of the xTraceRecorderBuffer structure, as saved by the
+ * debugger or written by the application using pvTraceGetBuffer() and
+ * ulTraceGetBufferSize().  The JSON is written to standard output unless -o
+ * is given.
+ *
+ * The trace shows two processes:
+ *
+ * "Running" - one row per task, with a slice for every period the task was
+ * running.  Queue, semaphore and mutex operations are marked on the row of
+ * the task that made them, and operations made from interrupts on the "ISR"
+ * row.  Priority inheritance is marked across all the rows.
+ *
+ * "Blocked" - one row per task, with a slice from the moment the task
+ * blocked on a queue, semaphore or mutex, or delayed itself, until it next
+ * ran.  A long "take" slice on a task whose mutex holder is being held off
+ * by a medium priority task is the signature of a priority inversion.
+ *
+ * Only little endian targets are supported, which covers the PIC24, dsPIC,
+ * PIC32 and x86 ports.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Must match trace.h. */
+#define traceMAGIC							( 0x52545246UL )
+#define traceVERSION						( 1 )
+#define traceNO_TASK						( 0xff )
+#define traceHEADER_SIZE					( 28 )
+#define traceRECORD_SIZE					( 8 )
+
+#define traceQUEUE_TYPE_QUEUE				( 1 )
+#define traceQUEUE_TYPE_SEMAPHORE			( 2 )
+#define traceQUEUE_TYPE_MUTEX				( 3 )
+
+#define traceEVENT_SWITCH					( 0x01 )
+#define traceEVENT_TASK_CREATE				( 0x02 )
+#define traceEVENT_TASK_DELETE				( 0x03 )
+#define traceEVENT_TASK_DELAY				( 0x04 )
+#define traceEVENT_TASK_DELAY_UNTIL			( 0x05 )
+#define traceEVENT_TASK_SUSPEND				( 0x06 )
+#define traceEVENT_TASK_RESUME				( 0x07 )
+#define traceEVENT_TASK_RESUME_FROM_ISR		( 0x08 )
+#define traceEVENT_TASK_PRIORITY_SET		( 0x09 )
+#define traceEVENT_TASK_PRIORITY_INHERIT	( 0x0a )
+#define traceEVENT_TASK_PRIORITY_DISINHERIT	( 0x0b )
+
+#define traceEVENT_QUEUE_SEND				( 0x10 )
+#define traceEVENT_QUEUE_SEND_FAILED		( 0x11 )
+#define traceEVENT_QUEUE_RECEIVE			( 0x12 )
+#define traceEVENT_QUEUE_RECEIVE_FAILED		( 0x13 )
+#define traceEVENT_QUEUE_PEEK				( 0x14 )
+#define traceEVENT_BLOCKING_ON_QUEUE_SEND	( 0x15 )
+#define traceEVENT_BLOCKING_ON_QUEUE_RECEIVE	( 0x16 )
+#define traceEVENT_QUEUE_SEND_FROM_ISR		( 0x17 )
+#define traceEVENT_QUEUE_SEND_FROM_ISR_FAILED	( 0x18 )
+#define traceEVENT_QUEUE_RECEIVE_FROM_ISR	( 0x19 )
+#define traceEVENT_QUEUE_RECEIVE_FROM_ISR_FAILED	( 0x1a )
+
+/* The process and row identifiers used in the JSON. */
+#define decodePID_RUNNING					( 1 )
+#define decodePID_BLOCKED					( 2 )
+#define decodeTID_ISR						( 1000 )
+
+#define decodeMAX_NAME_LEN					( 32 )
+
+/* The decoded header. */
+static uint32_t ulTimestampHz;
+static uint32_t ulRecords;
+static uint32_t ulNextRecord;
+static uint32_t ulRecordsWritten;
+static unsigned uxMaxTasks;
+static unsigned uxMaxQueues;
+static unsigned uxNameLength;
+
+/* Pointers into the file for the records and name tables. */
+static const uint8_t *pucRecords;
+static const uint8_t *pucTaskNames;
+static const uint8_t *pucQueueNames;
+static const uint8_t *pucQueueTypes;
+
+/* The state tracked while decoding. */
+static unsigned uxRunningTask = traceNO_TASK;
+static unsigned char ucBlocked[ 256 ];
+static unsigned char ucTaskSeen[ 256 ];
+static int xFirstEvent = 1;
+
+static FILE *pxOut;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRead32( const uint8_t *pucData )
+{
+	return ( uint32_t ) pucData[ 0 ] | ( ( uint32_t ) pucData[ 1 ] << 8 ) | ( ( uint32_t ) pucData[ 2 ] << 16 ) | ( ( uint32_t ) pucData[ 3 ] << 24 );
+}
+/*-----------------------------------------------------------*/
+
+static uint16_t prvRead16( const uint8_t *pucData )
+{
+	return ( uint16_t ) ( pucData[ 0 ] | ( pucData[ 1 ] << 8 ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyTableName( char *pcName, const uint8_t *pucTable, unsigned uxIndex )
+{
+unsigned x;
+const uint8_t *pucEntry = pucTable + ( uxIndex * uxNameLength );
+
+	/* Names are not terminated if they fill the entry.  Quotes and control
+	characters are dropped so the name can be placed straight into the JSON. */
+	for( x = 0; ( x < uxNameLength ) && ( x < decodeMAX_NAME_LEN - 1 ) && ( pucEntry[ x ] != 0x00 ); x++ )
+	{
+		pcName[ x ] = ( ( pucEntry[ x ] < 0x20 ) || ( pucEntry[ x ] > 0x7e ) || ( pucEntry[ x ] == '"' ) || ( pucEntry[ x ] == '\\' ) ) ? '?' : ( char ) pucEntry[ x ];
+	}
+	pcName[ x ] = 0x00;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvTaskName( unsigned uxTask )
+{
+static char cNames[ 2 ][ decodeMAX_NAME_LEN ];
+static unsigned uxNext = 0;
+char *pcName = cNames[ uxNext ];
+
+	/* Two buffers so two names can be used in one printf(). */
+	uxNext ^= 1;
+
+	if( uxTask < uxMaxTasks )
+	{
+		prvCopyTableName( pcName, pucTaskNames, uxTask );
+	}
+	else
+	{
+		pcName[ 0 ] = 0x00;
+	}
+
+	if( pcName[ 0 ] == 0x00 )
+	{
+		snprintf( pcName, decodeMAX_NAME_LEN, "task %u", uxTask );
+	}
+
+	return pcName;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvQueueName( unsigned uxQueue )
+{
+static char cName[ decodeMAX_NAME_LEN ];
+
+	if( uxQueue < uxMaxQueues )
+	{
+		prvCopyTableName( cName, pucQueueNames, uxQueue );
+	}
+	else
+	{
+		cName[ 0 ] = 0x00;
+	}
+
+	if( cName[ 0 ] == 0x00 )
+	{
+		snprintf( cName, sizeof( cName ), "queue %u", uxQueue );
+	}
+
+	return cName;
+}
+/*-----------------------------------------------------------*/
+
+static unsigned prvQueueType( unsigned uxQueue )
+{
+	if( uxQueue < uxMaxQueues )
+	{
+		return pucQueueTypes[ uxQueue ];
+	}
+
+	return traceQUEUE_TYPE_QUEUE;
+}
+/*-----------------------------------------------------------*/
+
+static const char *prvOperation( unsigned uxEvent, unsigned uxQueue )
+{
+int xMutex = ( prvQueueType( uxQueue ) == traceQUEUE_TYPE_MUTEX );
+int xSemaphore = ( prvQueueType( uxQueue ) == traceQUEUE_TYPE_SEMAPHORE );
+
+	/* Name the operation as the application would have written it. */
+	switch( uxEvent )
+	{
+		case traceEVENT_QUEUE_SEND					:
+		case traceEVENT_QUEUE_SEND_FROM_ISR			:	return ( xMutex || xSemaphore ) ? "give" : "send";
+		case traceEVENT_QUEUE_SEND_FAILED			:
+		case traceEVENT_QUEUE_SEND_FROM_ISR_FAILED	:	return ( xMutex || xSemaphore ) ? "give failed" : "send failed";
+		case traceEVENT_QUEUE_RECEIVE				:
+		case traceEVENT_QUEUE_RECEIVE_FROM_ISR		:	return ( xMutex || xSemaphore ) ? "take" : "receive";
+		case traceEVENT_QUEUE_RECEIVE_FAILED		:
+		case traceEVENT_QUEUE_RECEIVE_FROM_ISR_FAILED	:	return ( xMutex || xSemaphore ) ? "take failed" : "receive failed";
+		case traceEVENT_QUEUE_PEEK					:	return "peek";
+		case traceEVENT_BLOCKING_ON_QUEUE_SEND		:	return ( xMutex || xSemaphore ) ? "give" : "send";
+		case traceEVENT_BLOCKING_ON_QUEUE_RECEIVE	:	return ( xMutex || xSemaphore ) ? "take" : "receive";
+		default										:	return "?";
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartEvent( void )
+{
+	fputs( xFirstEvent ? "\n" : ",\n", pxOut );
+	xFirstEvent = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSlice( char cPhase, unsigned uxPid, unsigned uxTid, double dTime, const char *pcName )
+{
+	prvStartEvent();
+	fprintf( pxOut, "{\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"name\":\"%s\"}", cPhase, uxPid, uxTid, dTime, pcName );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInstant( unsigned uxTid, double dTime, const char *pcScope, const char *pcName )
+{
+	prvStartEvent();
+	fprintf( pxOut, "{\"ph\":\"i\",\"s\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"name\":\"%s\"}", pcScope, decodePID_RUNNING, uxTid, dTime, pcName );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMetadata( const char *pcKind, unsigned uxPid, unsigned uxTid, const char *pcName )
+{
+	prvStartEvent();
+	fprintf( pxOut, "{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"args\":{\"name\":\"%s\"}}", uxPid, uxTid, pcKind, pcName );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchTo( unsigned uxTask, double dTime )
+{
+	if( uxRunningTask != traceNO_TASK )
+	{
+		prvSlice( 'E', decodePID_RUNNING, uxRunningTask, dTime, prvTaskName( uxRunningTask ) );
+	}
+
+	uxRunningTask = uxTask;
+
+	if( uxTask != traceNO_TASK )
+	{
+		ucTaskSeen[ uxTask ] = 1;
+
+		/* Whatever the task was waiting for has arrived. */
+		if( ucBlocked[ uxTask ] != 0 )
+		{
+			prvSlice( 'E', decodePID_BLOCKED, uxTask, dTime, "" );
+			ucBlocked[ uxTask ] = 0;
+		}
+
+		prvSlice( 'B', decodePID_RUNNING, uxTask, dTime, prvTaskName( uxTask ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlock( unsigned uxTask, double dTime, const char *pcWaitingFor )
+{
+	if( ( uxTask != traceNO_TASK ) && ( ucBlocked[ uxTask ] == 0 ) )
+	{
+		ucTaskSeen[ uxTask ] = 1;
+		ucBlocked[ uxTask ] = 1;
+		prvSlice( 'B', decodePID_BLOCKED, uxTask, dTime, pcWaitingFor );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDecodeRecord( const uint8_t *pucRecord, double dTime )
+{
+unsigned uxEvent = pucRecord[ 4 ];
+unsigned uxTask = pucRecord[ 5 ];
+unsigned uxObject = prvRead16( pucRecord + 6 );
+unsigned uxTid = ( uxTask == traceNO_TASK ) ? decodeTID_ISR : uxTask;
+char cText[ 3 * decodeMAX_NAME_LEN ];
+
+	/* A trace that starts part way through a task's time slice. */
+	if( ( uxRunningTask == traceNO_TASK ) && ( uxTask != traceNO_TASK ) && ( uxEvent != traceEVENT_SWITCH ) )
+	{
+		prvSwitchTo( uxTask, dTime );
+	}
+
+	switch( uxEvent )
+	{
+		case traceEVENT_SWITCH :
+			prvSwitchTo( uxTask, dTime );
+			break;
+
+		case traceEVENT_TASK_CREATE :
+			snprintf( cText, sizeof( cText ), "create %s", prvTaskName( uxObject & 0xff ) );
+			prvInstant( uxTid, dTime, "t", cText );
+			break;
+
+		case traceEVENT_TASK_DELETE :
+			snprintf( cText, sizeof( cText ), "delete %s", prvTaskName( uxObject & 0xff ) );
+			prvInstant( uxTid, dTime, "t", cText );
+			break;
+
+		case traceEVENT_TASK_DELAY :
+		case traceEVENT_TASK_DELAY_UNTIL :
+			prvBlock( uxObject & 0xff, dTime, "delay" );
+			break;
+
+		case traceEVENT_TASK_SUSPEND :
+			snprintf( cText, sizeof( cText ), "suspend %s", prvTaskName( uxObject & 0xff ) );
+			prvInstant( uxTid, dTime, "t", cText );
+			prvBlock( uxObject & 0xff, dTime, "suspended" );
+			break;
+
+		case traceEVENT_TASK_RESUME :
+		case traceEVENT_TASK_RESUME_FROM_ISR :
+			snprintf( cText, sizeof( cText ), "resume %s", prvTaskName( uxObject & 0xff ) );
+			prvInstant( ( uxEvent == traceEVENT_TASK_RESUME ) ? uxTid : decodeTID_ISR, dTime, "t", cText );
+			break;
+
+		case traceEVENT_TASK_PRIORITY_SET :
+			snprintf( cText, sizeof( cText ), "%s priority %u", prvTaskName( uxObject & 0xff ), uxObject >> 8 );
+			prvInstant( uxTid, dTime, "t", cText );
+			break;
+
+		case traceEVENT_TASK_PRIORITY_INHERIT :
+			snprintf( cText, sizeof( cText ), "%s raises %s to priority %u", prvTaskName( uxTask ), prvTaskName( uxObject & 0xff ), uxObject >> 8 );
+			prvInstant( uxTid, dTime, "p", cText );
+			break;
+
+		case traceEVENT_TASK_PRIORITY_DISINHERIT :
+			snprintf( cText, sizeof( cText ), "%s back to priority %u", prvTaskName( uxObject & 0xff ), uxObject >> 8 );
+			prvInstant( uxTid, dTime, "p", cText );
+			break;
+
+		case traceEVENT_BLOCKING_ON_QUEUE_SEND :
+		case traceEVENT_BLOCKING_ON_QUEUE_RECEIVE :
+			snprintf( cText, sizeof( cText ), "%s %s", prvOperation( uxEvent, uxObject ), prvQueueName( uxObject ) );
+			prvBlock( uxTask, dTime, cText );
+			break;
+
+		case traceEVENT_QUEUE_SEND :
+		case traceEVENT_QUEUE_SEND_FAILED :
+		case traceEVENT_QUEUE_RECEIVE :
+		case traceEVENT_QUEUE_RECEIVE_FAILED :
+		case traceEVENT_QUEUE_PEEK :
+			snprintf( cText, sizeof( cText ), "%s %s", prvOperation( uxEvent, uxObject ), prvQueueName( uxObject ) );
+			prvInstant( uxTid, dTime, "t", cText );
+			break;
+
+		case traceEVENT_QUEUE_SEND_FROM_ISR :
+		case traceEVENT_QUEUE_SEND_FROM_ISR_FAILED :
+		case traceEVENT_QUEUE_RECEIVE_FROM_ISR :
+		case traceEVENT_QUEUE_RECEIVE_FROM_ISR_FAILED :
+			snprintf( cText, sizeof( cText ), "%s %s", prvOperation( uxEvent, uxObject ), prvQueueName( uxObject ) );
+			prvInstant( decodeTID_ISR, dTime, "t", cText );
+			break;
+
+		default :
+			fprintf( stderr, "tracedecode: unknown event 0x%02x ignored\n", uxEvent );
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+FILE *pxIn;
+const char *pcInput = NULL, *pcOutput = NULL;
+uint8_t *pucFile;
+long lFileSize;
+size_t xExpected;
+uint32_t ulFirst, ulCount, ul, ulPrevious = 0;
+uint64_t ullTime = 0;
+double dTime = 0.0;
+unsigned x;
+int i;
+
+	for( i = 1; i < argc; i++ )
+	{
+		if( ( strcmp( argv[ i ], "-o" ) == 0 ) && ( i + 1 < argc ) )
+		{
+			pcOutput = argv[ ++i ];
+		}
+		else if( pcInput == NULL )
+		{
+			pcInput = argv[ i ];
+		}
+		else
+		{
+			pcInput = NULL;
+			break;
+		}
+	}
+
+	if( pcInput == NULL )
+	{
+		fprintf( stderr, "usage: %s [-o trace.json] trace.bin\n", argv[ 0 ] );
+		return EXIT_FAILURE;
+	}
+
+	pxIn = fopen( pcInput, "rb" );
+	if( pxIn == NULL )
+	{
+		perror( pcInput );
+		return EXIT_FAILURE;
+	}
+
+	fseek( pxIn, 0L, SEEK_END );
+	lFileSize = ftell( pxIn );
+	rewind( pxIn );
+
+	pucFile = ( uint8_t * ) malloc( ( lFileSize > 0 ) ? ( size_t ) lFileSize : 1 );
+	if( ( pucFile == NULL ) || ( lFileSize < traceHEADER_SIZE ) || ( fread( pucFile, 1, ( size_t ) lFileSize, pxIn ) != ( size_t ) lFileSize ) )
+	{
+		fprintf( stderr, "%s: could not read the trace header\n", pcInput );
+		return EXIT_FAILURE;
+	}
+	fclose( pxIn );
+
+	if( prvRead32( pucFile ) != traceMAGIC )
+	{
+		fprintf( stderr, "%s: not a little endian trace buffer\n", pcInput );
+		return EXIT_FAILURE;
+	}
+
+	if( ( prvRead16( pucFile + 4 ) != traceVERSION ) || ( prvRead16( pucFile + 6 ) != traceRECORD_SIZE ) )
+	{
+		fprintf( stderr, "%s: trace version %u with %u byte records is not supported\n", pcInput, prvRead16( pucFile + 4 ), prvRead16( pucFile + 6 ) );
+		return EXIT_FAILURE;
+	}
+
+	ulTimestampHz = prvRead32( pucFile + 8 );
+	ulRecords = prvRead32( pucFile + 12 );
+	ulNextRecord = prvRead32( pucFile + 16 );
+	ulRecordsWritten = prvRead32( pucFile + 20 );
+	uxMaxTasks = pucFile[ 24 ];
+	uxMaxQueues = pucFile[ 25 ];
+	uxNameLength = pucFile[ 26 ];
+
+	/* The layout of xTraceBuffer.  The trailing padding the compiler may have
+	added is not needed. */
+	xExpected = traceHEADER_SIZE + ( ( size_t ) ulRecords * traceRECORD_SIZE ) + ( ( uxMaxTasks + uxMaxQueues ) * uxNameLength ) + uxMaxQueues;
+	if( ( ulTimestampHz == 0UL ) || ( ulNextRecord >= ulRecords ) || ( ( size_t ) lFileSize < xExpected ) )
+	{
+		fprintf( stderr, "%s: %ld bytes is too short, or the header is corrupt\n", pcInput, lFileSize );
+		return EXIT_FAILURE;
+	}
+
+	pucRecords = pucFile + traceHEADER_SIZE;
+	pucTaskNames = pucRecords + ( ( size_t ) ulRecords * traceRECORD_SIZE );
+	pucQueueNames = pucTaskNames + ( uxMaxTasks * uxNameLength );
+	pucQueueTypes = pucQueueNames + ( uxMaxQueues * uxNameLength );
+
+	/* Once the buffer has wrapped the oldest record is the one that would be
+	overwritten next. */
+	if( ulRecordsWritten > ulRecords )
+	{
+		ulFirst = ulNextRecord;
+		ulCount = ulRecords;
+	}
+	else
+	{
+		ulFirst = 0UL;
+		ulCount = ulRecordsWritten;
+	}
+
+	if( pcOutput != NULL )
+	{
+		pxOut = fopen( pcOutput, "w" );
+		if( pxOut == NULL )
+		{
+			perror( pcOutput );
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		pxOut = stdout;
+	}
+
+	fputs( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", pxOut );
+
+	for( ul = 0; ul < ulCount; ul++ )
+	{
+	const uint8_t *pucRecord = pucRecords + ( ( size_t ) ( ( ulFirst + ul ) % ulRecords ) * traceRECORD_SIZE );
+	uint32_t ulTimestamp = prvRead32( pucRecord );
+
+		/* Timestamps are relative to the first record.  The recorded counter
+		wraps, so accumulate the differences between consecutive records. */
+		if( ul != 0UL )
+		{
+			ullTime += ( uint32_t ) ( ulTimestamp - ulPrevious );
+		}
+		ulPrevious = ulTimestamp;
+		dTime = ( ( double ) ullTime * 1000000.0 ) / ( double ) ulTimestampHz;
+
+		prvDecodeRecord( pucRecord, dTime );
+	}
+
+	/* Close any slices still open at the end of the trace. */
+	prvSwitchTo( traceNO_TASK, dTime );
+	for( x = 0; x < 256; x++ )
+	{
+		if( ucBlocked[ x ] != 0 )
+		{
+			prvSlice( 'E', decodePID_BLOCKED, x, dTime, "" );
+		}
+	}
+
+	prvMetadata( "process_name", decodePID_RUNNING, 0, "Running" );
+	prvMetadata( "process_name", decodePID_BLOCKED, 0, "Blocked" );
+	prvMetadata( "thread_name", decodePID_RUNNING, decodeTID_ISR, "ISR" );
+	for( x = 0; x < 256; x++ )
+	{
+		if( ucTaskSeen[ x ] != 0 )
+		{
+			prvMetadata( "thread_name", decodePID_RUNNING, x, prvTaskName( x ) );
+			prvMetadata( "thread_name", decodePID_BLOCKED, x, prvTaskName( x ) );
+		}
+	}
+
+	fputs( "\n]}\n", pxOut );
+
+	if( pxOut != stdout )
+	{
+		fclose( pxOut );
+	}
+
+	fprintf( stderr, "%lu records covering %.3f ms%s\n", ( unsigned long ) ulCount, dTime / 1000.0,
+			 ( ulRecordsWritten > ulRecords ) ? ", older records were overwritten" : "" );
+
+	free( pucFile );
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,59 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+ * Application specific definitions.
+ *
+ * These definitions should be adjusted for your particular hardware and
+ * application requirements.
+ *
+ * THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+ * FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE. 
+ *
+ * The host build of the TCP/IP stack, using the GCC/Linux port.  The tick
+ * is faster than on the boards so that the TCPIP task can poll the host MAC
+ * at a millisecond without holding up the other tasks.
+ *----------------------------------------------------------*/
+
+#define configUSE_PREEMPTION			1
+#define configUSE_IDLE_HOOK				0
+#define configUSE_TICK_HOOK				0
+#define configTICK_RATE_HZ				( ( portTickType ) 1000 )
+#define configCPU_CLOCK_HZ				( 80000000UL )
+#define configUSE_16_BIT_TICKS			0
+#define configMINIMAL_STACK_SIZE		( 240 )
+#define configMAX_PRIORITIES			( ( unsigned portBASE_TYPE ) 6 )
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 128 * 1024 ) )
+#define configMAX_TASK_NAME_LEN			( 8 )
+#define configUSE_TRACE_FACILITY		0
+#define configIDLE_SHOULD_YIELD			1
+#define configUSE_MUTEXES				1
+#define configUSE_TASK_NOTIFICATIONS	1
+#define configCHECK_FOR_STACK_OVERFLOW	2
+#define configGENERATE_RUN_TIME_STATS	1
+#define configUSE_TRACE_RECORDER		0
+#define configUSE_TICKLESS_IDLE			0
+
+/* Software timer definitions. */
+#define configUSE_TIMERS				1
+#define configTIMER_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH		( 5 )
+#define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE )
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES 		0
+#define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+
+#define INCLUDE_vTaskPrioritySet				1
+#define INCLUDE_uxTaskPriorityGet				0
+#define INCLUDE_vTaskDelete						0
+#define INCLUDE_vTaskCleanUpResources			0
+#define INCLUDE_vTaskSuspend					1
+#define INCLUDE_vTaskDelayUntil					0
+#define INCLUDE_vTaskDelay						1
+#define INCLUDE_uxTaskGetStackHighWaterMark		1
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,37 @@
+/*********************************************************************
+ *
+ *	Hardware specific definitions for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HardwareProfile.h
+ * Dependencies:    None
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Found ahead of include\HardwareProfile.h by the Makefile.  The
+ * "board" is the HostMAC.c virtual Ethernet controller, the tick in
+ * HostTick.c and the SPI flash image in HostFlash.c; the clocks are the
+ * PIC32 ones so that the stack's timeouts come out the same.
+ ********************************************************************/
+#ifndef __HARDWARE_PROFILE_H
+#define __HARDWARE_PROFILE_H
+
+// Use the host virtual Ethernet controller
+#define HOST_MAC
+
+// MPFS2 and the configuration are kept in an SST25VF016 image
+#define GRAPHICS_PICTAIL_VERSION	3
+
+// This value is used to calculate Tick Counter value
+#define GetSystemClock()		(80000000ul)      // Hz
+#define GetInstructionClock()	(GetSystemClock()/1)
+#define GetPeripheralClock()	(GetInstructionClock()/2)
+#define CLOCK_FREQ              (80000000ul)
+
+// STACK_USE_UART output goes to stdout
+#define BusyUART()				(0)
+#define putcUART(a)				putchar(a)
+#define putsUART(a)				fputs((const char*)(a), stdout)
+#define putrsUART(a)			putsUART(a)
+
+#endif
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *
+ * ARCFOUR for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostARCFOUR.c
+ * Dependencies:    ARCFOUR.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * The ARCFOUR (RC4) stream cipher behind ARCFOUR.h, standing in for the
+ * Data Encryption Routines (SW300052) that ARCFOUR.c leaves out, so that
+ * "make SSL=1" builds an HTTPS server and its test client.  It is for
+ * benchmarks only and is not part of the board's build.
+ *****************************************************************************/
+#include "TCPIP Stack/TCPIP.h"
+
+#if defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)
+
+/************************************************************************
+* Function: void ARCFOURInitialize(ARCFOUR_CTX* ctx, BYTE* key, WORD len)
+*                                                                       
+* Overview: run the key schedule into the context's S-box
+*                                                                       
+* Input: the context, with Sbox pointing to 256 bytes, and the key
+*                                                                       
+************************************************************************/
+void ARCFOURInitialize(ARCFOUR_CTX* ctx, BYTE* key, WORD len)
+{
+	BYTE i, j, temp;
+	WORD w;
+
+	for (w = 0; w < 256u; w++)
+		ctx->Sbox[w] = (BYTE)w;
+
+	j = 0;
+	for (w = 0; w < 256u; w++) {
+		i = (BYTE)w;
+		j += ctx->Sbox[i] + key[w % len];
+		temp = ctx->Sbox[i];
+		ctx->Sbox[i] = ctx->Sbox[j];
+		ctx->Sbox[j] = temp;
+	}
+
+	ctx->i = 0;
+	ctx->j = 0;
+}
+
+/************************************************************************
+* Function: void ARCFOURCrypt(ARCFOUR_CTX* ctx, BYTE* data, WORD len)
+*                                                                       
+* Overview: encrypt or decrypt data in place, continuing the key stream
+*                                                                       
+* Input: the context and the data
+*                                                                       
+************************************************************************/
+void ARCFOURCrypt(ARCFOUR_CTX* ctx, BYTE* data, WORD len)
+{
+	BYTE i, j, temp;
+	BYTE* Sbox;
+
+	i = ctx->i;
+	j = ctx->j;
+	Sbox = ctx->Sbox;
+	while (len--) {
+		i++;
+		j += Sbox[i];
+		temp = Sbox[i];
+		Sbox[i] = Sbox[j];
+		Sbox[j] = temp;
+		*data++ ^= Sbox[(BYTE)(Sbox[i] + Sbox[j])];
+	}
+	ctx->i = i;
+	ctx->j = j;
+}
+
+#endif
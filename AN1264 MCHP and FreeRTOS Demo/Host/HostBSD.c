@@ -0,0 +1,204 @@
+/*********************************************************************
+ *
+ *	Berkeley socket client tasks for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostBSD.c
+ * Dependencies:    HostBSD.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Application tasks using the Berkeley API the way a Modbus/TCP or
+ * other request/response protocol would: blocking connect(), send()
+ * and recv() from their own tasks, with the calls carried out by the
+ * TCPIP task.  The far end is HostEchoPeer() in a child process.
+ ********************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "HostBSD.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// what each task did
+typedef struct
+{
+	IP_ADDR			PeerIP;
+	WORD			wPort;
+	DWORD			dwMessages;		// to exchange
+	DWORD			dwEchoed;		// exchanged and checked
+	DWORD			dwErrors;		// failed calls and wrong echoes
+	double			dMinRTT;		// in microseconds
+	double			dMaxRTT;
+	double			dTotalRTT;
+	struct timespec	tStart;
+	struct timespec	tEnd;
+	BOOL			bDone;
+	BYTE			Request[HOST_BSD_MESSAGE_LEN];
+	BYTE			Reply[HOST_BSD_MESSAGE_LEN];
+} HOST_BSD_CLIENT;
+
+static HOST_BSD_CLIENT Clients[HOST_BSD_TASKS];
+
+static void taskBSDClient(void* pvParameter);
+static double MicrosecondsBetween(struct timespec* pStart, struct timespec* pEnd);
+
+void HostBSDStart(IP_ADDR PeerIP, WORD wPort, DWORD dwMessages)
+{
+	signed char szName[configMAX_TASK_NAME_LEN];
+	BYTE i;
+
+	for (i = 0; i < HOST_BSD_TASKS; i++) {
+		memset(&Clients[i], 0, sizeof(Clients[i]));
+		Clients[i].PeerIP = PeerIP;
+		Clients[i].wPort = wPort;
+		Clients[i].dwMessages = dwMessages;
+
+		snprintf((char*)szName, sizeof(szName), "BSD%u", (unsigned)i);
+		xTaskCreate(taskBSDClient, szName, configMINIMAL_STACK_SIZE,
+			&Clients[i], tskIDLE_PRIORITY + 1, NULL);
+	}
+}
+
+/*********************************************************************
+ * Function:        static void taskBSDClient(void* pvParameter)
+ *
+ * PreCondition:    None
+ *
+ * Input:           the task's HOST_BSD_CLIENT
+ *
+ * Output:          Does not return
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Connect, exchange the messages and close, blocking
+ *					in the Berkeley calls throughout
+ *
+ * Note:            Each message carries the task and message number,
+ *					so an echo meant for another task or an old
+ *					message is caught
+ ********************************************************************/
+static void taskBSDClient(void* pvParameter)
+{
+	HOST_BSD_CLIENT* pClient = (HOST_BSD_CLIENT*)pvParameter;
+	struct sockaddr_in Addr;
+	struct timespec tSent, tEchoed;
+	DWORD dwTimeout = HOST_BSD_TIMEOUT;
+	DWORD dw;
+	double dRTT;
+	SOCKET s;
+	int iReceived, iResult;
+	WORD w;
+
+	clock_gettime(CLOCK_MONOTONIC, &pClient->tStart);
+
+	s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (s == INVALID_SOCKET) {
+		pClient->dwErrors++;
+		goto done;
+	}
+	setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&dwTimeout, sizeof(dwTimeout));
+	setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&dwTimeout, sizeof(dwTimeout));
+
+	memset(&Addr, 0, sizeof(Addr));
+	Addr.sin_family = AF_INET;
+	Addr.sin_port = pClient->wPort;
+	Addr.sin_addr.s_addr = pClient->PeerIP.Val;
+	if (connect(s, (struct sockaddr*)&Addr, sizeof(Addr)) != 0) {
+		pClient->dwErrors++;
+		closesocket(s);
+		goto done;
+	}
+
+	for (dw = 0; dw < pClient->dwMessages; dw++) {
+		pClient->Request[0] = (BYTE)(pClient - Clients);
+		memcpy(&pClient->Request[1], &dw, sizeof(dw));
+		for (w = 1 + sizeof(dw); w < HOST_BSD_MESSAGE_LEN; w++)
+			pClient->Request[w] = (BYTE)(w + dw);
+
+		clock_gettime(CLOCK_MONOTONIC, &tSent);
+		if (send(s, (const char*)pClient->Request, HOST_BSD_MESSAGE_LEN, 0) != HOST_BSD_MESSAGE_LEN) {
+			pClient->dwErrors++;
+			break;
+		}
+
+		// the echo may come back in more than one segment
+		for (iReceived = 0; iReceived < HOST_BSD_MESSAGE_LEN; iReceived += iResult) {
+			iResult = recv(s, (char*)pClient->Reply + iReceived, HOST_BSD_MESSAGE_LEN - iReceived, 0);
+			if (iResult <= 0)
+				break;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &tEchoed);
+
+		if (iReceived != HOST_BSD_MESSAGE_LEN) {
+			pClient->dwErrors++;
+			break;
+		}
+		if (memcmp(pClient->Request, pClient->Reply, HOST_BSD_MESSAGE_LEN) != 0) {
+			pClient->dwErrors++;
+			continue;
+		}
+
+		dRTT = MicrosecondsBetween(&tSent, &tEchoed);
+		if (pClient->dwEchoed == 0 || dRTT < pClient->dMinRTT)
+			pClient->dMinRTT = dRTT;
+		if (dRTT > pClient->dMaxRTT)
+			pClient->dMaxRTT = dRTT;
+		pClient->dTotalRTT += dRTT;
+		pClient->dwEchoed++;
+	}
+
+	closesocket(s);
+
+done:
+	clock_gettime(CLOCK_MONOTONIC, &pClient->tEnd);
+	pClient->bDone = TRUE;
+
+	while (1)
+		vTaskDelay(portMAX_DELAY);
+}
+
+BOOL HostBSDPrintResults(void)
+{
+	struct timespec tFirst, tLast;
+	DWORD dwEchoed = 0;
+	double dSeconds, dTotalRTT = 0.0;
+	BOOL bOK = TRUE;
+	BYTE i;
+
+	tFirst = Clients[0].tStart;
+	tLast = Clients[0].tEnd;
+	printf("Berkeley clients, %u bytes per message\n", HOST_BSD_MESSAGE_LEN);
+	for (i = 0; i < HOST_BSD_TASKS; i++) {
+		printf("  BSD%u   %10lu echoed, %lu errors, RTT %.1f/%.1f/%.1f us min/avg/max%s\n",
+			(unsigned)i, (unsigned long)Clients[i].dwEchoed, (unsigned long)Clients[i].dwErrors,
+			Clients[i].dMinRTT,
+			(Clients[i].dwEchoed > 0) ? Clients[i].dTotalRTT / (double)Clients[i].dwEchoed : 0.0,
+			Clients[i].dMaxRTT, Clients[i].bDone ? "" : ", unfinished");
+
+		if (!Clients[i].bDone || Clients[i].dwErrors != 0 || Clients[i].dwEchoed != Clients[i].dwMessages)
+			bOK = FALSE;
+		if (MicrosecondsBetween(&Clients[i].tStart, &tFirst) > 0.0)
+			tFirst = Clients[i].tStart;
+		if (MicrosecondsBetween(&tLast, &Clients[i].tEnd) > 0.0)
+			tLast = Clients[i].tEnd;
+		dwEchoed += Clients[i].dwEchoed;
+		dTotalRTT += Clients[i].dTotalRTT;
+	}
+
+	dSeconds = MicrosecondsBetween(&tFirst, &tLast) / 1e6;
+	printf("  ALL    %10lu echoed in %.2f s, %.0f messages/s, %.1f us average RTT\n",
+		(unsigned long)dwEchoed, dSeconds,
+		(dSeconds > 0.0) ? (double)dwEchoed / dSeconds : 0.0,
+		(dwEchoed > 0) ? dTotalRTT / (double)dwEchoed : 0.0);
+
+	return bOK;
+}
+
+static double MicrosecondsBetween(struct timespec* pStart, struct timespec* pEnd)
+{
+	return (double)(pEnd->tv_sec - pStart->tv_sec) * 1e6 + (double)(pEnd->tv_nsec - pStart->tv_nsec) / 1e3;
+}
@@ -0,0 +1,65 @@
+/*********************************************************************
+ *
+ *	Berkeley socket client tasks for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostBSD.h
+ * Dependencies:    TCPIP.h, BerkeleyAPI.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_BSD_H
+#define __HOST_BSD_H
+
+#include "TCPIP Stack/TCPIP.h"
+
+// the port HostEchoPeer() answers on, the echo service's
+#define HOST_BSD_PORT			(7u)
+
+// bytes in each request, about a Modbus/TCP read response
+#define HOST_BSD_MESSAGE_LEN	(128u)
+
+// SO_SNDTIMEO and SO_RCVTIMEO of the client sockets, in milliseconds
+#define HOST_BSD_TIMEOUT		(2000u)
+
+/*********************************************************************
+ * Function:        void HostBSDStart(IP_ADDR PeerIP, WORD wPort,
+ *						DWORD dwMessages)
+ *
+ * PreCondition:    StackInit() has been called
+ *                  
+ * Input:           the echo server's address and port and the number
+ *					of messages each task exchanges
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Creates HOST_BSD_TASKS tasks
+ *
+ * Overview:        Start the client tasks.  Each connects to the echo
+ *					server with blocking Berkeley calls, then sends a
+ *					message and waits for its echo dwMessages times
+ *					before closing the connection.
+ *
+ * Note:            
+ ********************************************************************/
+void HostBSDStart(IP_ADDR PeerIP, WORD wPort, DWORD dwMessages);
+
+/*********************************************************************
+ * Function:        BOOL HostBSDPrintResults(void)
+ *
+ * PreCondition:    The scheduler has ended
+ *                  
+ * Input:           None
+ *                  
+ * Output:          TRUE if every task exchanged all its messages
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Print each task's message count, errors and round
+ *					trip times, and the rate of all of them together
+ *
+ * Note:            
+ ********************************************************************/
+BOOL HostBSDPrintResults(void);
+
+#endif
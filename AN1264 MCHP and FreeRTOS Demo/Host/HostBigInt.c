@@ -0,0 +1,169 @@
+/*****************************************************************************
+ *
+ * BigInt helpers for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostBigInt.c
+ * Dependencies:    BigInt.c
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * C versions of the assembly helpers in BigInt_helper_C32.S, working on
+ * the same _iA/_xA/_iB/_xB/_iR/_wC pointers with 32 bit words, so that
+ * BigInt.c and RSA.c run unchanged on the host.
+ *****************************************************************************/
+#include "TCPIP Stack/TCPIP.h"
+
+#if (defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)) && !defined(ENC100_INTERFACE_MODE)
+
+// the start (LSB) and end (MSB) words of A and B, the result's LSB, and
+// the word _masBI() multiplies by
+BIGINT_DATA_TYPE *_iA, *_xA, *_iB, *_xB, *_iR, _wC;
+
+/************************************************************************
+* Function: void _addBI(void)
+*                                                                       
+* Overview: A = A + B, the carry running up to _xA
+*
+************************************************************************/
+void _addBI(void)
+{
+	BIGINT_DATA_TYPE *a, *b;
+	BIGINT_DATA_TYPE_2 t = 0;
+
+	for(a = _iA, b = _iB; b <= _xB; a++, b++)
+	{
+		t = (BIGINT_DATA_TYPE_2)*a + *b + (t >> BIGINT_DATA_SIZE);
+		*a = (BIGINT_DATA_TYPE)t;
+	}
+	for(t >>= BIGINT_DATA_SIZE; t != 0u && a <= _xA; a++)
+		t = (++*a == 0u);
+}
+
+/************************************************************************
+* Function: void _subBI(void)
+*                                                                       
+* Overview: A = A - B, the borrow running up to _xA
+*
+************************************************************************/
+void _subBI(void)
+{
+	BIGINT_DATA_TYPE *a, *b;
+	BIGINT_DATA_TYPE_2 t;
+	BIGINT_DATA_TYPE borrow = 0;
+
+	for(a = _iA, b = _iB; b <= _xB; a++, b++)
+	{
+		t = (BIGINT_DATA_TYPE_2)*a - *b - borrow;
+		*a = (BIGINT_DATA_TYPE)t;
+		borrow = (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE) & 1u;
+	}
+	for(; borrow != 0u && a <= _xA; a++)
+		borrow = ((*a)-- == 0u);
+}
+
+/************************************************************************
+* Function: void _zeroBI(void)
+*                                                                       
+* Overview: zeroes _iA to _xA
+*
+************************************************************************/
+void _zeroBI(void)
+{
+	BIGINT_DATA_TYPE *a;
+
+	for(a = _iA; a <= _xA; a++)
+		*a = 0;
+}
+
+/************************************************************************
+* Function: void _msbBI(void)
+*                                                                       
+* Overview: moves _xA down to the most significant non-zero word,
+*           stopping at _iA
+*
+************************************************************************/
+void _msbBI(void)
+{
+	while(*_xA == 0u && _xA != _iA)
+		_xA--;
+}
+
+/************************************************************************
+* Function: void _mulBI(void)
+*                                                                       
+* Overview: R = A * B, where R is zeroed and has room for both
+*
+************************************************************************/
+void _mulBI(void)
+{
+	BIGINT_DATA_TYPE *a, *b, *r;
+	BIGINT_DATA_TYPE_2 t;
+
+	for(b = _iB; b <= _xB; b++)
+	{
+		if(*b == 0u)
+			continue;
+
+		t = 0;
+		r = _iR + (b - _iB);
+		for(a = _iA; a <= _xA; a++, r++)
+		{
+			t = (BIGINT_DATA_TYPE_2)*a * *b + *r + (t >> BIGINT_DATA_SIZE);
+			*r = (BIGINT_DATA_TYPE)t;
+		}
+		*r = (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE);
+	}
+}
+
+/************************************************************************
+* Function: void _sqrBI(void)
+*                                                                       
+* Overview: R = A * A
+*
+************************************************************************/
+void _sqrBI(void)
+{
+	_iB = _iA;
+	_xB = _xA;
+	_mulBI();
+}
+
+/************************************************************************
+* Function: void _masBI(void)
+*                                                                       
+* Overview: R = R - B * _wC, over one word more than B; a final borrow
+*           is dropped, as BigIntMod() corrects for it
+*
+************************************************************************/
+void _masBI(void)
+{
+	BIGINT_DATA_TYPE *b, *r;
+	BIGINT_DATA_TYPE_2 t, p = 0;
+	BIGINT_DATA_TYPE borrow = 0;
+
+	for(b = _iB, r = _iR; b <= _xB; b++, r++)
+	{
+		p = (BIGINT_DATA_TYPE_2)*b * _wC + (p >> BIGINT_DATA_SIZE);
+		t = (BIGINT_DATA_TYPE_2)*r - (BIGINT_DATA_TYPE)p - borrow;
+		*r = (BIGINT_DATA_TYPE)t;
+		borrow = (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE) & 1u;
+	}
+	*r -= (BIGINT_DATA_TYPE)(p >> BIGINT_DATA_SIZE) + borrow;
+}
+
+/************************************************************************
+* Function: void _copyBI(void)
+*                                                                       
+* Overview: A = B, zero filling A above B's _xB
+*
+************************************************************************/
+void _copyBI(void)
+{
+	BIGINT_DATA_TYPE *a, *b;
+
+	for(a = _iA, b = _iB; a <= _xA; a++)
+		*a = (b <= _xB) ? *b++ : 0u;
+}
+
+#endif
@@ -0,0 +1,438 @@
+/*****************************************************************************
+ *
+ * SST25VF016 stand-in for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostFlash.c
+ * Dependencies:    HostFlash.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Replaces src\SST25VF016.c with a RAM array that behaves like the
+ * flash: it reads back 0xFF when erased and a write can only clear bits.
+ * Nothing is kept between runs.
+ *
+ * The commands the driver would send are timed on a simulated clock,
+ * from the bytes clocked over SPI2 and the flash's program and erase
+ * times, so HostFlashBenchmark() can compare ways of writing it.  The
+ * writes follow src\SST25VF016.c: arrays are programmed in auto address
+ * increment mode, leaving the last word busy for the next command.
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TCPIP Stack/TCPIP.h"
+#include "HostFlash.h"
+
+// the flash contents, erased at start up
+static BYTE vFlash[HOST_FLASH_SIZE];
+
+// Internal pointer to address being written
+static DWORD dwWriteAddr;
+
+// the file loaded by HostFlashLoad(), for HostFlashBenchmark()
+static DWORD dwImageAddr, dwImageLen;
+
+// the simulated time in microseconds and when the flash stops being busy
+static double dNow, dBusyUntil;
+
+// auto address increment mode, taking the next word for dwAAIAddr
+static BOOL bAAI;
+static DWORD dwAAIAddr;
+
+// the reads counted for HostFlashGetStats() and the writes for
+// SST25GetWriteStats()
+static HOST_FLASH_STATS FlashStats;
+static SST25_WRITE_STATS WriteStats;
+
+static void HostSPI(DWORD dwBytes);
+static void HostWaitBusy(void);
+static void HostEndAAI(void);
+static void HostProgram(DWORD address, BYTE* pData, WORD nCount);
+static void HostByteConfig(const BYTE* pConfig, WORD wLen);
+static void HostByteImage(const BYTE* pImage, DWORD dwLen);
+static BOOL HostVerify(DWORD address, const BYTE* pData, DWORD dwLen);
+
+/************************************************************************
+* Function: BOOL HostFlashLoad(const char* szFile, DWORD address)
+*                                                                       
+* Overview: copy a file into the flash
+*                                                                       
+* Input: file name and flash address
+*                                                                       
+* Output: TRUE if the whole file was loaded
+*                                                                       
+************************************************************************/
+BOOL HostFlashLoad(const char* szFile, DWORD address)
+{
+	FILE* pFile;
+	size_t nRead;
+
+	SST25Init();
+	if (address >= HOST_FLASH_SIZE)
+		return FALSE;
+
+	pFile = fopen(szFile, "rb");
+	if (pFile == NULL)
+		return FALSE;
+
+	nRead = fread(&vFlash[address], 1, HOST_FLASH_SIZE - address, pFile);
+	fclose(pFile);
+	SST25CacheInvalidate(SST25_CACHE_ALL);
+	dwImageAddr = address;
+	dwImageLen = nRead;
+
+	return nRead > 0;
+}
+
+void SST25Init()
+{
+	static BOOL bErased = FALSE;
+
+	// the flash is only erased once, MPFSInit() calls this again after
+	// HostFlashLoad() has filled it
+	if (!bErased) {
+		memset(vFlash, 0xFF, sizeof(vFlash));
+		bErased = TRUE;
+	}
+	SST25CacheInit();
+}
+
+// a command and status byte
+BYTE SST25IsWriteBusy()
+{
+	HostSPI(2);
+	return dNow < dBusyUntil;
+}
+
+void SST25WriteEnable()
+{
+	HostEndAAI();
+	HostSPI(1);
+}
+
+// two commands, one with the status register
+void SST25ResetWriteProtection()
+{
+	HostEndAAI();
+	HostSPI(3);
+}
+
+// a command, three address bytes and the data
+void SST25WriteByte(DWORD address, BYTE data)
+{
+	SST25WriteEnable();
+	HostSPI(5);
+	if (address < HOST_FLASH_SIZE)
+		vFlash[address] &= data;
+	dBusyUntil = dNow + HOST_FLASH_PROGRAM_US;
+	WriteStats.dwBytes++;
+	WriteStats.dwCommands++;
+
+	while (SST25IsWriteBusy());
+	SST25CacheInvalidate(address);
+}
+
+void SST25WriteWord(DWORD address, WORD data)
+{
+    SST25WriteByte(address, ((WORD_VAL)data).v[0]);
+    SST25WriteByte(address + 1, ((WORD_VAL)data).v[1]);
+}
+
+BYTE SST25WriteArray(DWORD address, BYTE* pData, WORD nCount)
+{
+	HostProgram(address, pData, nCount);
+	SST25EndWrite();
+
+	// VERIFY
+	return HostVerify(address, pData, nCount);
+}
+
+void SST25ReadBlock(DWORD address, BYTE* pData, WORD nCount)
+{
+	HostEndAAI();
+	HostSPI(HOST_FLASH_READ_CMD + nCount);
+	FlashStats.dwReads++;
+	FlashStats.dwReadBytes += nCount;
+	while (nCount--) {
+		*pData++ = (address < HOST_FLASH_SIZE) ? vFlash[address] : 0xFF;
+		address++;
+	}
+}
+
+void HostFlashGetStats(HOST_FLASH_STATS* pStats)
+{
+	*pStats = FlashStats;
+	pStats->dMicros = dNow;
+}
+
+void SST25GetWriteStats(SST25_WRITE_STATS* pStats)
+{
+	*pStats = WriteStats;
+}
+
+void SST25ChipErase(void)
+{
+	SST25WriteEnable();
+	HostSPI(1);
+	memset(vFlash, 0xFF, sizeof(vFlash));
+	dBusyUntil = dNow + HOST_FLASH_CHIP_US;
+	while (SST25IsWriteBusy());
+	WriteStats.dwErases++;
+	SST25CacheInvalidate(SST25_CACHE_ALL);
+}
+
+// a command and three address bytes
+void SST25SectorErase(DWORD address)
+{
+	SST25WriteEnable();
+	HostSPI(4);
+	address &= ~SST25_FLASH_SECTOR_MASK;
+	if (address < HOST_FLASH_SIZE)
+		memset(&vFlash[address], 0xFF, SST25_FLASH_SECTOR_SIZE);
+	dBusyUntil = dNow + HOST_FLASH_SECTOR_US;
+	while (SST25IsWriteBusy());
+	WriteStats.dwErases++;
+	SST25CacheInvalidate(address);
+}
+
+void SST25BeginWrite(DWORD dwAddr)
+{
+    dwWriteAddr = dwAddr;
+}
+
+void SST25WriteIncrementalArray(BYTE* vData, WORD wLen)
+{
+	WORD wChunk;
+
+	while (wLen > 0) {
+		// clear the sector if on a sector boundary
+		if ((dwWriteAddr & SST25_FLASH_SECTOR_MASK) == 0)
+			SST25SectorErase(dwWriteAddr);
+
+		// program up to the end of the sector
+		wChunk = SST25_FLASH_SECTOR_SIZE - (dwWriteAddr & SST25_FLASH_SECTOR_MASK);
+		if (wChunk > wLen)
+			wChunk = wLen;
+		HostProgram(dwWriteAddr, vData, wChunk);
+
+		dwWriteAddr += wChunk;
+		vData += wChunk;
+		wLen -= wChunk;
+	}
+}
+
+void SST25EndWrite(void)
+{
+	HostEndAAI();
+}
+
+BOOL HostFlashBenchmark(DWORD dwRepeats)
+{
+	BYTE vConfig[sizeof(APP_CONFIG) + 1];
+	HOST_FLASH_STATS Start, End;
+	SST25_WRITE_STATS WStart, WEnd;
+	MPFS_HANDLE hMPFS;
+	BYTE* pImage;
+	double dByte, dBulk, dErase;
+	DWORD i, dwOffset;
+	WORD wChunk;
+	BOOL bOK;
+
+	if (dwImageLen == 0 || dwRepeats == 0)
+		return FALSE;
+	pImage = malloc(dwImageLen);
+	if (pImage == NULL)
+		return FALSE;
+	memcpy(pImage, &vFlash[dwImageAddr], dwImageLen);
+	vConfig[0] = 0x60;
+	memcpy(&vConfig[1], &AppConfig, sizeof(AppConfig));
+	bOK = TRUE;
+
+	// the configuration, as SaveAppConfig() wrote it and writes it now;
+	// the reads verifying each write are not timed
+	dByte = dBulk = 0.0;
+	for (i = 0; i < dwRepeats; i++) {
+		HostFlashGetStats(&Start);
+		HostByteConfig(vConfig, sizeof(vConfig));
+		HostFlashGetStats(&End);
+		dByte += End.dMicros - Start.dMicros;
+		bOK &= HostVerify(MPFS_RESERVE_BASE, vConfig, sizeof(vConfig));
+	}
+
+	SST25GetWriteStats(&WStart);
+	for (i = 0; i < dwRepeats; i++) {
+		HostFlashGetStats(&Start);
+		SST25BeginWrite(MPFS_RESERVE_BASE);
+		SST25WriteIncrementalArray(vConfig, 1);
+		SST25WriteIncrementalArray(&vConfig[1], sizeof(AppConfig));
+		SST25EndWrite();
+		HostFlashGetStats(&End);
+		dBulk += End.dMicros - Start.dMicros;
+		bOK &= HostVerify(MPFS_RESERVE_BASE, vConfig, sizeof(vConfig));
+	}
+	SST25GetWriteStats(&WEnd);
+	dByte /= dwRepeats;
+	dBulk /= dwRepeats;
+
+	// both erase the same sectors, which take most of the time
+	dErase = (double)(WEnd.dwErases - WStart.dwErases) * HOST_FLASH_SECTOR_US / dwRepeats;
+	printf("FLASH: config save of %u bytes, %.2f ms a byte at a time, %.2f ms in words, "
+		"%.2f ms of each erasing (%.1fx programming), %.1f commands and %.1f busy polls per save\n",
+		(unsigned)sizeof(vConfig), dByte / 1e3, dBulk / 1e3, dErase / 1e3,
+		(dByte - dErase) / (dBulk - dErase),
+		(double)(WEnd.dwCommands - WStart.dwCommands) / dwRepeats,
+		(double)(WEnd.dwBusyPolls - WStart.dwBusyPolls) / dwRepeats);
+
+	// the image, uploaded 16 bytes at a time as HTTPMPFSUpload() does;
+	// both end with MPFSPutEnd() reading the new image's file table
+	dByte = dBulk = 0.0;
+	for (i = 0; i < dwRepeats; i++) {
+		HostFlashGetStats(&Start);
+		HostByteImage(pImage, dwImageLen);
+		MPFSPutEnd(TRUE);
+		HostFlashGetStats(&End);
+		dByte += End.dMicros - Start.dMicros;
+		bOK &= HostVerify(dwImageAddr, pImage, dwImageLen);
+	}
+
+	SST25GetWriteStats(&WStart);
+	for (i = 0; i < dwRepeats; i++) {
+		HostFlashGetStats(&Start);
+		hMPFS = MPFSFormat();
+		for (dwOffset = 0; dwOffset < dwImageLen; dwOffset += wChunk) {
+			wChunk = (dwImageLen - dwOffset < 16u) ? (WORD)(dwImageLen - dwOffset) : 16u;
+			MPFSPutArray(hMPFS, &pImage[dwOffset], wChunk);
+		}
+		MPFSPutEnd(TRUE);
+		HostFlashGetStats(&End);
+		dBulk += End.dMicros - Start.dMicros;
+		bOK &= HostVerify(dwImageAddr, pImage, dwImageLen);
+	}
+	SST25GetWriteStats(&WEnd);
+	dByte /= dwRepeats;
+	dBulk /= dwRepeats;
+
+	dErase = (double)(WEnd.dwErases - WStart.dwErases) * HOST_FLASH_SECTOR_US / dwRepeats;
+	printf("FLASH: upload of %lu bytes, %.1f ms a byte at a time, %.1f ms in words, "
+		"%.1f ms of each erasing (%.1fx programming, %.0f KB/s), %.0f commands and "
+		"%.0f busy polls per upload\n",
+		(unsigned long)dwImageLen, dByte / 1e3, dBulk / 1e3, dErase / 1e3,
+		(dByte - dErase) / (dBulk - dErase), (double)dwImageLen * 1e6 / 1024.0 / dBulk,
+		(double)(WEnd.dwCommands - WStart.dwCommands) / dwRepeats,
+		(double)(WEnd.dwBusyPolls - WStart.dwBusyPolls) / dwRepeats);
+
+	free(pImage);
+	if (!bOK)
+		fprintf(stderr, "FLASH: the data read back differs\n");
+	return bOK;
+}
+
+// the time to clock bytes over SPI2
+static void HostSPI(DWORD dwBytes)
+{
+	dNow += (double)dwBytes * 8e6 / HOST_FLASH_SPI_HZ;
+}
+
+// status reads until the program or erase in progress ends
+static void HostWaitBusy(void)
+{
+	do {
+		HostSPI(2);
+		WriteStats.dwBusyPolls++;
+	} while (dNow < dBusyUntil);
+}
+
+// leave auto address increment mode once the last word is programmed
+static void HostEndAAI(void)
+{
+	if (!bAAI)
+		return;
+
+	HostWaitBusy();
+	HostSPI(1);
+	bAAI = FALSE;
+}
+
+// SST25Program() in src\SST25VF016.c; the first word takes a write
+// enable, the command and three address bytes, the rest the command
+static void HostProgram(DWORD address, BYTE* pData, WORD nCount)
+{
+	DWORD dwStart = address;
+
+	while (nCount > 0) {
+		if ((address & 1) || nCount == 1) {
+			SST25WriteByte(address, *pData++);
+			address++;
+			nCount--;
+			continue;
+		}
+
+		if (bAAI && dwAAIAddr == address) {
+			HostWaitBusy();
+			HostSPI(1 + 2);
+		} else {
+			HostEndAAI();
+			HostSPI(1);
+			HostSPI(4 + 2);
+			bAAI = TRUE;
+		}
+		if (address + 1 < HOST_FLASH_SIZE) {
+			vFlash[address] &= pData[0];
+			vFlash[address + 1] &= pData[1];
+		}
+		dBusyUntil = dNow + HOST_FLASH_PROGRAM_US;
+
+		WriteStats.dwBytes += 2;
+		WriteStats.dwCommands++;
+		address += 2;
+		pData += 2;
+		nCount -= 2;
+		dwAAIAddr = address;
+	}
+
+	for (dwStart &= ~SST25_FLASH_SECTOR_MASK; dwStart < address; dwStart += SST25_FLASH_SECTOR_SIZE)
+		SST25CacheInvalidate(dwStart);
+}
+
+// SaveAppConfig() before the writes were batched
+static void HostByteConfig(const BYTE* pConfig, WORD wLen)
+{
+	DWORD d;
+
+	SST25SectorErase(MPFS_RESERVE_BASE);
+	for (d = MPFS_RESERVE_BASE; wLen > 0; wLen--)
+		SST25WriteByte(d++, *pConfig++);
+}
+
+// SST25WriteIncrementalArray() before the writes were batched
+static void HostByteImage(const BYTE* pImage, DWORD dwLen)
+{
+	DWORD d;
+
+	for (d = dwImageAddr; dwLen > 0; dwLen--) {
+		while (SST25IsWriteBusy());
+		if ((d & SST25_FLASH_SECTOR_MASK) == 0)
+			SST25SectorErase(d);
+		SST25WriteByte(d++, *pImage++);
+	}
+}
+
+// read back through the cache as the driver's verify does
+static BOOL HostVerify(DWORD address, const BYTE* pData, DWORD dwLen)
+{
+	BYTE vVerify[16];
+	WORD wLen;
+
+	while (dwLen) {
+		wLen = (dwLen < sizeof(vVerify)) ? dwLen : sizeof(vVerify);
+		SST25ReadArray(address, vVerify, wLen);
+		if (memcmp(vVerify, pData, wLen) != 0)
+			return FALSE;
+		pData += wLen;
+		address += wLen;
+		dwLen -= wLen;
+	}
+	return TRUE;
+}
@@ -0,0 +1,82 @@
+/*********************************************************************
+ *
+ *	SST25VF016 stand-in for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostFlash.h
+ * Dependencies:    SST25VF016.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_FLASH_H
+#define __HOST_FLASH_H
+
+#include "SST25VF016.h"
+
+// size of the SST25VF016 (16 Mbit)
+#define HOST_FLASH_SIZE		(2ul*1024ul*1024ul)
+
+/************************************************************************
+* Function: BOOL HostFlashLoad(const char* szFile, DWORD address)
+*                                                                       
+* Overview: copy a file into the flash, typically the MPFS2 image at
+*           MPFS_RESERVE_BLOCK
+*                                                                       
+* Input: file name and flash address
+*                                                                       
+* Output: TRUE if the whole file was loaded
+*                                                                       
+************************************************************************/
+BOOL HostFlashLoad(const char* szFile, DWORD address);
+
+// the board's SPI2 clock, for the time the reads would take on the bus:
+// a command and three address bytes, then the data
+#define HOST_FLASH_SPI_HZ	(10000000ul)
+#define HOST_FLASH_READ_CMD	(4u)
+
+// the SST25VF016B's longest times, in microseconds, to program a byte or
+// an auto address increment word and to erase a sector or the chip; the
+// flash is busy for these after the command and is polled until ready
+#define HOST_FLASH_PROGRAM_US	(10.0)
+#define HOST_FLASH_SECTOR_US	(25000.0)
+#define HOST_FLASH_CHIP_US		(50000.0)
+
+// read commands sent to the flash by SST25ReadBlock() since start up,
+// past the read cache; each is one SPI transaction on the board.
+// dMicros is the simulated time of every command sent, the bus time at
+// HOST_FLASH_SPI_HZ plus the waits while the flash is busy.
+typedef struct
+{
+	DWORD	dwReads;
+	DWORD	dwReadBytes;
+	double	dMicros;
+} HOST_FLASH_STATS;
+
+/************************************************************************
+* Function: void HostFlashGetStats(HOST_FLASH_STATS* pStats)
+*                                                                       
+* Overview: copy the read counters
+*                                                                       
+* Input: where to copy them
+*                                                                       
+* Output: None
+*                                                                       
+************************************************************************/
+void HostFlashGetStats(HOST_FLASH_STATS* pStats);
+
+/************************************************************************
+* Function: BOOL HostFlashBenchmark(DWORD dwRepeats)
+*                                                                       
+* Overview: save the configuration and upload the loaded MPFS2 image
+*           dwRepeats times each, first a byte at a time as the driver
+*           once did and then through SST25WriteIncrementalArray(), and
+*           print the simulated time each took on the board
+*                                                                       
+* Input: how many times to write each
+*                                                                       
+* Output: TRUE if every write read back correctly
+*                                                                       
+************************************************************************/
+BOOL HostFlashBenchmark(DWORD dwRepeats);
+
+#endif //__HOST_FLASH_H
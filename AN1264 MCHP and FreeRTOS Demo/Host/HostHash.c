@@ -0,0 +1,164 @@
+/*****************************************************************************
+ *
+ * Hash benchmark for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostHash.c
+ * Dependencies:    Hashes.c
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Checks and times the hashes SSL.c and Random.c use, through the same
+ * HASH_SUM calls they make.
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "TCPIP Stack/TCPIP.h"
+#include "HostHash.h"
+
+// bytes added per call for the bulk rate, a full TCP segment's data,
+// from one byte into the buffer so no block lies aligned
+#define HOST_HASH_SEGMENT	(1460u)
+
+// the byte at a time rate is timed over this share of the data
+#define HOST_HASH_BYTE_SHARE	(16u)
+
+// one algorithm's calls, as SSL.c and Random.c use them
+typedef struct
+{
+	ROM char* szName;
+	void (*Initialize)(HASH_SUM* theSum);
+	void (*AddData)(HASH_SUM* theSum, BYTE* data, WORD len);
+	void (*Calculate)(HASH_SUM* theSum, BYTE* result);
+	BYTE vLength;
+	ROM char* szABC;		// digest of "abc"
+	ROM char* szTwoBlocks;	// digest of the 56 byte FIPS 180 message
+	ROM char* szMillion;	// digest of a million 'a's
+} HOST_HASH;
+
+static ROM HOST_HASH Hashes[] = {
+	{"MD5", MD5Initialize, MD5AddData, MD5Calculate, 16u,
+		"900150983cd24fb0d6963f7d28e17f72",
+		"8215ef0796a20bcaaae116d3876c664a",
+		"7707d6ae4e027c70eea2a935c2296f21"},
+	{"SHA-1", SHA1Initialize, SHA1AddData, SHA1Calculate, 20u,
+		"a9993e364706816aba3e25717850c26c9cd0d89d",
+		"84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+		"34aa973cd4c4daa4f61eeb2bdbad27316534016f"},
+	#if defined(STACK_USE_SHA256)
+	{"SHA-256", SHA256Initialize, SHA256AddData, SHA256Calculate, 32u,
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+	#endif
+};
+#define HOST_HASHES		(sizeof(Hashes) / sizeof(Hashes[0]))
+
+static BYTE vData[1u + HOST_HASH_SEGMENT];
+
+static double HostSeconds(void);
+static BOOL HostHashCheck(ROM HOST_HASH* pHash, ROM char* szMessage, DWORD dwRepeat, ROM char* szDigest);
+
+/************************************************************************
+* Function: BOOL HostHashBenchmark(DWORD dwMegabytes)
+*                                                                       
+* Overview: check each hash's known answers, then time it in segments
+*           and a byte at a time
+*                                                                       
+* Input: how many megabytes to hash with each algorithm
+*                                                                       
+* Output: TRUE if every digest was correct
+*                                                                       
+************************************************************************/
+BOOL HostHashBenchmark(DWORD dwMegabytes)
+{
+	ROM HOST_HASH* pHash;
+	HASH_SUM Sum;
+	BYTE vResult[32];
+	DWORD dwBytes, dwDone, i;
+	double dStart, dBulk, dBytes;
+	BYTE h;
+	BOOL bOK;
+
+	if (dwMegabytes == 0)
+		return FALSE;
+	dwBytes = dwMegabytes * 1000000ul;
+	for (i = 0; i < sizeof(vData); i++)
+		vData[i] = (BYTE)(i * 7u);
+
+	bOK = TRUE;
+	for (h = 0; h < HOST_HASHES; h++) {
+		pHash = &Hashes[h];
+		bOK &= HostHashCheck(pHash, "abc", 1, pHash->szABC);
+		bOK &= HostHashCheck(pHash, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+			pHash->szTwoBlocks);
+		bOK &= HostHashCheck(pHash, "a", 1000000ul, pHash->szMillion);
+
+		// whole segments, as SSL.c hashes records
+		pHash->Initialize(&Sum);
+		dStart = HostSeconds();
+		for (dwDone = 0; dwDone < dwBytes; dwDone += HOST_HASH_SEGMENT)
+			pHash->AddData(&Sum, vData + 1, HOST_HASH_SEGMENT);
+		pHash->Calculate(&Sum, vResult);
+		dBulk = HostSeconds() - dStart;
+
+		// a byte at a time, as Random.c adds entropy
+		pHash->Initialize(&Sum);
+		dStart = HostSeconds();
+		for (i = 0; i < dwBytes / HOST_HASH_BYTE_SHARE; i++)
+			pHash->AddData(&Sum, vData + (i & 0xFFu), 1);
+		pHash->Calculate(&Sum, vResult);
+		dBytes = HostSeconds() - dStart;
+
+		printf("HASH: %-7s %8.1f MB/s in %u byte segments, %6.1f MB/s a byte at a time\n",
+			pHash->szName, dwDone / dBulk / 1e6, HOST_HASH_SEGMENT,
+			dwBytes / HOST_HASH_BYTE_SHARE / dBytes / 1e6);
+	}
+
+	return bOK;
+}
+
+// the monotonic clock in seconds
+static double HostSeconds(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+// hash szMessage dwRepeat times over, in pieces of every length from 1
+// to 127 bytes so the partial block is filled from each offset, and
+// compare the digest with szDigest
+static BOOL HostHashCheck(ROM HOST_HASH* pHash, ROM char* szMessage, DWORD dwRepeat, ROM char* szDigest)
+{
+	BYTE vMessage[128], vResult[32];
+	char szResult[65];
+	HASH_SUM Sum;
+	DWORD dwLeft, dwLength;
+	WORD wPiece, wFill, w;
+	BYTE i;
+
+	dwLength = strlen(szMessage);
+	dwLeft = dwLength * dwRepeat;
+	pHash->Initialize(&Sum);
+	for (wPiece = 1; dwLeft > 0; wPiece = (wPiece % sizeof(vMessage)) + 1) {
+		wFill = (dwLeft < wPiece) ? (WORD)dwLeft : wPiece;
+		for (w = 0; w < wFill; w++)
+			vMessage[w] = szMessage[(dwLength * dwRepeat - dwLeft + w) % dwLength];
+		pHash->AddData(&Sum, vMessage, wFill);
+		dwLeft -= wFill;
+	}
+	pHash->Calculate(&Sum, vResult);
+
+	for (i = 0; i < pHash->vLength; i++)
+		sprintf(szResult + 2 * i, "%02x", vResult[i]);
+	if (strcmp(szResult, szDigest) == 0)
+		return TRUE;
+
+	fprintf(stderr, "HASH: %s of %lu x \"%.16s\" gave %s\n", pHash->szName,
+		(unsigned long)dwRepeat, szMessage, szResult);
+	return FALSE;
+}
@@ -0,0 +1,29 @@
+/*********************************************************************
+ *
+ *	Hash benchmark for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostHash.h
+ * Dependencies:    Hashes.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_HASH_H
+#define __HOST_HASH_H
+
+/************************************************************************
+* Function: BOOL HostHashBenchmark(DWORD dwMegabytes)
+*                                                                       
+* Overview: check MD5, SHA-1 and SHA-256 against the FIPS 180 and
+*           RFC 1321 test vectors, then hash dwMegabytes of data with
+*           each in 1460 byte segments and a byte at a time, as the
+*           stack's callers add data, and print the MB/s of each
+*                                                                       
+* Input: how many megabytes to hash with each algorithm
+*                                                                       
+* Output: TRUE if every digest was correct
+*                                                                       
+************************************************************************/
+BOOL HostHashBenchmark(DWORD dwMegabytes);
+
+#endif //__HOST_HASH_H
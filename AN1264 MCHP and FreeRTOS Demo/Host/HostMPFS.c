@@ -0,0 +1,147 @@
+/*********************************************************************
+ *
+ *	MPFS2 file open benchmark for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostMPFS.c
+ * Dependencies:    HostMPFS.h, HostFlash.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Times MPFSOpen() by name, as the HTTP server calls it for each
+ * request, on the loaded image or on a generated one of any size.
+ ********************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "HostMPFS.h"
+#include "HostFlash.h"
+
+// the names of the image's files, read by HostMPFSBenchmark()
+static BYTE Names[HOST_MPFS_MAX_NAMES][64];
+
+static void PutWord(BYTE* p, WORD w);
+static void PutLong(BYTE* p, DWORD dw);
+
+BOOL HostMPFSBuild(WORD wFiles)
+{
+	MPFS_HANDLE hMPFS;
+	BYTE Record[22];
+	BYTE Name[16];
+	DWORD dwString, dwData;
+	WORD i, wHash;
+	BYTE* p;
+
+	hMPFS = MPFSFormat();
+	if (hMPFS == MPFS_INVALID_HANDLE)
+		return FALSE;
+
+	// "MPFS", version 2.1 and the number of files
+	memcpy(Record, "MPFS\x02\x01", 6);
+	PutWord(&Record[6], wFiles);
+	MPFSPutArray(hMPFS, Record, 8);
+
+	// the name hashes, computed as MPFSOpen() does
+	for (i = 0; i < wFiles; i++) {
+		snprintf((char*)Name, sizeof(Name), "files/%04u.htm", (unsigned)i);
+		for (wHash = 0, p = Name; *p != '\0'; p++) {
+			wHash += *p;
+			wHash <<= 1;
+		}
+		PutWord(Record, wHash);
+		MPFSPutArray(hMPFS, Record, 2);
+	}
+
+	// the FAT records; each name is 15 bytes with its null, and each
+	// file holds its own name without it
+	dwString = 8ul + wFiles * (2ul + 22ul);
+	dwData = dwString + wFiles * 15ul;
+	for (i = 0; i < wFiles; i++) {
+		PutLong(&Record[0], dwString + i * 15ul);
+		PutLong(&Record[4], dwData + i * 14ul);
+		PutLong(&Record[8], 14ul);
+		PutLong(&Record[12], 0x4A000000ul);
+		PutLong(&Record[16], 0ul);
+		PutWord(&Record[20], 0u);
+		MPFSPutArray(hMPFS, Record, 22);
+	}
+
+	for (i = 0; i < wFiles; i++) {
+		snprintf((char*)Name, sizeof(Name), "files/%04u.htm", (unsigned)i);
+		MPFSPutArray(hMPFS, Name, 15);
+	}
+	for (i = 0; i < wFiles; i++) {
+		snprintf((char*)Name, sizeof(Name), "files/%04u.htm", (unsigned)i);
+		MPFSPutArray(hMPFS, Name, 14);
+	}
+	MPFSPutEnd(TRUE);
+
+	// the image is read back with the new number of files
+	hMPFS = MPFSOpen(Name);
+	if (hMPFS == MPFS_INVALID_HANDLE)
+		return FALSE;
+	MPFSClose(hMPFS);
+	return TRUE;
+}
+
+BOOL HostMPFSBenchmark(DWORD dwOpens)
+{
+	HOST_FLASH_STATS Start, End;
+	struct timespec tStart, tEnd;
+	MPFS_HANDLE hMPFS;
+	DWORD dwFound, i;
+	WORD wNames, wID;
+	double dSeconds;
+
+	// the named files; index files have no name
+	wNames = 0;
+	for (wID = 0; wNames < HOST_MPFS_MAX_NAMES; wID++) {
+		hMPFS = MPFSOpenID(wID);
+		if (hMPFS == MPFS_INVALID_HANDLE)
+			break;
+		memset(Names[wNames], 0, sizeof(Names[wNames]));
+		MPFSGetFilename(hMPFS, Names[wNames], sizeof(Names[wNames]) - 1);
+		MPFSClose(hMPFS);
+		if (Names[wNames][0] != '\0')
+			wNames++;
+	}
+	if (wNames == 0) {
+		fprintf(stderr, "MPFS: no files in the image\n");
+		return FALSE;
+	}
+
+	HostFlashGetStats(&Start);
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+	for (i = 0, dwFound = 0; i < dwOpens; i++) {
+		hMPFS = MPFSOpen(Names[i % wNames]);
+		if (hMPFS != MPFS_INVALID_HANDLE) {
+			dwFound++;
+			MPFSClose(hMPFS);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+	HostFlashGetStats(&End);
+
+	dSeconds = (double)(tEnd.tv_sec - tStart.tv_sec) +
+		(double)(tEnd.tv_nsec - tStart.tv_nsec) / 1e9;
+	printf("MPFS: %lu opens, %lu found, of %u files (%u named) in %.3f s, "
+		"%.0f opens/s, %.1f flash reads and %.1f bytes per open\n",
+		(unsigned long)dwOpens, (unsigned long)dwFound, (unsigned)wID, (unsigned)wNames, dSeconds,
+		dSeconds > 0.0 ? (double)dwOpens / dSeconds : 0.0,
+		dwOpens ? (double)(End.dwReads - Start.dwReads) / dwOpens : 0.0,
+		dwOpens ? (double)(End.dwReadBytes - Start.dwReadBytes) / dwOpens : 0.0);
+	return dwFound == dwOpens;
+}
+
+static void PutWord(BYTE* p, WORD w)
+{
+	p[0] = (BYTE)w;
+	p[1] = (BYTE)(w >> 8);
+}
+
+static void PutLong(BYTE* p, DWORD dw)
+{
+	PutWord(p, (WORD)dw);
+	PutWord(p + 2, (WORD)(dw >> 16));
+}
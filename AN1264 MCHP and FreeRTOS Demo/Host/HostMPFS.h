@@ -0,0 +1,60 @@
+/*********************************************************************
+ *
+ *	MPFS2 file open benchmark for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostMPFS.h
+ * Dependencies:    TCPIP.h, MPFS2.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_MPFS_H
+#define __HOST_MPFS_H
+
+#include "TCPIP Stack/TCPIP.h"
+
+// the most files HostMPFSBenchmark() opens by name
+#define HOST_MPFS_MAX_NAMES		(4096u)
+
+/*********************************************************************
+ * Function:        BOOL HostMPFSBuild(WORD wFiles)
+ *
+ * PreCondition:    MPFSInit() has been called
+ *                  
+ * Input:           the number of files
+ *                  
+ * Output:          TRUE if the image was written and validated
+ *
+ * Side Effects:    Replaces the MPFS2 image in the flash
+ *
+ * Overview:        Write an image of wFiles small files named
+ *					"files/NNNN.htm" with MPFSFormat(), MPFSPutArray()
+ *					and MPFSPutEnd(), as an upload through the web
+ *					server would
+ *
+ * Note:            
+ ********************************************************************/
+BOOL HostMPFSBuild(WORD wFiles);
+
+/*********************************************************************
+ * Function:        BOOL HostMPFSBenchmark(DWORD dwOpens)
+ *
+ * PreCondition:    MPFSInit() has been called
+ *                  
+ * Input:           the number of files to open
+ *                  
+ * Output:          TRUE if every open found its file
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Read the names of the image's files, then open and
+ *					close them by name in turn dwOpens times.  Prints
+ *					the opens per second and the flash reads for each
+ *					open.
+ *
+ * Note:            The names are read once beforehand, so the flash
+ *					reads counted are those of MPFSOpen() alone
+ ********************************************************************/
+BOOL HostMPFSBenchmark(DWORD dwOpens);
+
+#endif
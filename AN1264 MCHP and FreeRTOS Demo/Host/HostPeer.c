@@ -0,0 +1,2336 @@
+/*********************************************************************
+ *
+ *	Traffic generator for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostPeer.c
+ * Dependencies:    HostPeer.h, HostRSA.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * A minimal host on the other end of an AF_UNIX socketpair, so the
+ * stack can be benchmarked without a TAP interface or root.  Frames are
+ * built by hand; nothing here uses the stack itself, save the hashes,
+ * ARCFOUR and HostRSAEncrypt() the SSL client borrows.
+ ********************************************************************/
+// the C library's sockets are used here, not the Berkeley API's
+#define HOST_LIBC_SOCKETS
+
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "HostPeer.h"
+#include "HostRSA.h"
+
+// size of the echo request payload, as sent by the Linux ping
+#define PING_DATA_LEN		(56u)
+
+// the identifier used in the echo requests
+#define PING_ID				(0x4850u)
+
+// an echo request or reply as it appears on the wire
+typedef struct __attribute__((packed, aligned(2)))
+{
+	ETHER_HEADER	Ether;
+	IP_HEADER		IP;
+	BYTE			Type;
+	BYTE			Code;
+	WORD			Checksum;
+	WORD			Identifier;
+	WORD			Sequence;
+	BYTE			Data[PING_DATA_LEN];
+} PING_FRAME;
+
+// a TCP segment without options as it appears on the wire
+typedef struct __attribute__((packed, aligned(2)))
+{
+	ETHER_HEADER	Ether;
+	IP_HEADER		IP;
+	WORD			SourcePort;
+	WORD			DestPort;
+	DWORD			SeqNumber;
+	DWORD			AckNumber;
+	BYTE			DataOffset;
+	BYTE			Flags;
+	WORD			Window;
+	WORD			Checksum;
+	WORD			UrgentPointer;
+} TCP_FRAME;
+
+#define TCP_HEADER_LEN		(20u)
+#define TCP_FLAG_FIN		(0x01u)
+#define TCP_FLAG_SYN		(0x02u)
+#define TCP_FLAG_RST		(0x04u)
+#define TCP_FLAG_PSH		(0x08u)
+#define TCP_FLAG_ACK		(0x10u)
+
+// the first source port HostSynPeer() connects from
+#define SYN_PEER_PORT		(1024u)
+
+// the initial sequence number used from each source port
+#define SYN_PEER_ISS(port)	((DWORD)(port) << 16)
+
+// the locally administered address the peer uses
+static ROM BYTE PeerMACAddress[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+// how many connections HostEchoPeer() serves at once
+#define ECHO_PEER_CONNECTIONS	(8u)
+
+// bytes each connection buffers between receiving and echoing
+#define ECHO_PEER_BUFFER		(2048u)
+
+// the largest segment HostEchoPeer() sends
+#define ECHO_PEER_MSS			(536u)
+
+// ms before unacknowledged data is sent again
+#define ECHO_PEER_RTO			(200u)
+
+// ms without a frame before HostEchoPeer() gives up
+#define ECHO_PEER_IDLE_TIMEOUT	(5u * HOST_PEER_TIMEOUT)
+
+// the initial sequence number used towards each stack port
+#define ECHO_PEER_ISS(port)		(0x80000000ul ^ ((DWORD)(port) << 16))
+
+// an ARP request or reply as it appears on the wire
+typedef struct __attribute__((packed, aligned(2)))
+{
+	ETHER_HEADER	Ether;
+	ARP_PACKET		ARP;
+} ARP_FRAME;
+
+// a TCP segment with room for the largest IP datagram
+typedef struct __attribute__((packed, aligned(2)))
+{
+	TCP_FRAME		TCP;
+	BYTE			Data[1500u - sizeof(IP_HEADER) - TCP_HEADER_LEN];
+} ECHO_FRAME;
+
+typedef enum
+{
+	ECHO_FREE = 0u,
+	ECHO_SYN_SENT,
+	ECHO_SYN_RECEIVED,
+	ECHO_ESTABLISHED,
+	ECHO_LAST_ACK
+} ECHO_STATE;
+
+// one connection to the echo port, or from the HTTP client; data waits in
+// Buffer from wHead until it has been sent and acknowledged
+typedef struct
+{
+	ECHO_STATE		vState;
+	WORD			wPeerPort;
+	WORD			wStackPort;
+	DWORD			dwRcvNext;
+	DWORD			dwSndUna;
+	DWORD			dwSndNext;
+	WORD			wSndWindow;
+	WORD			wHead;
+	WORD			wCount;
+	BOOL			bFinReceived;
+	BOOL			bAckNeeded;
+	DWORD			dwBytes;
+	struct timespec	tSent;
+	BYTE			Buffer[ECHO_PEER_BUFFER];
+} ECHO_CONNECTION;
+
+// how many requests HostHTTPPeer() sends ahead of the responses when
+// pipelining
+#define HTTP_PEER_PIPELINE		(4u)
+
+// the first source port HostHTTPPeer() connects from
+#define HTTP_PEER_PORT			(2048u)
+
+// the longest response line HostHTTPPeer() looks at
+#define HTTP_PEER_LINE			(128u)
+
+// the longest request HostHTTPPeer() sends
+#define HTTP_PEER_REQUEST		(2u * HTTP_PEER_LINE + 64u)
+
+// how often HTTP_PEER_WATCH asks for status.xml, as monitor.htm did
+// before status.sse, in milliseconds
+#define HTTP_PEER_WATCH_PERIOD	(500u)
+
+// the static files of index.htm and monitor.htm, which HTTP_PEER_PAGE asks
+// for in turn
+static ROM char* HTTPPeerFiles[] = {"meter.css", "mchp.gif", "mchp.js", "mchpmeter.gif"};
+#define HTTP_PEER_FILES			(sizeof(HTTPPeerFiles) / sizeof(HTTPPeerFiles[0]))
+
+// the validators last received for each file, kept as a browser's cache
+// would to revalidate it
+static char HTTPPeerETags[HTTP_PEER_FILES][HTTP_PEER_LINE];
+static char HTTPPeerDates[HTTP_PEER_FILES][HTTP_PEER_LINE];
+
+typedef enum
+{
+	HTTP_PEER_STATUS = 0u,
+	HTTP_PEER_HEADERS,
+	HTTP_PEER_BODY,
+	HTTP_PEER_CHUNK_SIZE,
+	HTTP_PEER_CHUNK_DATA,
+	HTTP_PEER_CHUNK_END,
+	HTTP_PEER_TRAILER,
+	HTTP_PEER_UNTIL_CLOSE
+} HTTP_PEER_PARSE;
+
+// one HTTP client connection; the response being received is parsed as
+// it arrives, keeping only the current line
+typedef struct
+{
+	ECHO_CONNECTION	TCP;
+	HTTP_PEER_PARSE	vParse;
+	WORD			wStatus;
+	BOOL			bChunked;
+	BOOL			bClose;
+	BOOL			bEvents;
+	BYTE			vLastByte;
+	DWORD			dwLength;
+	BYTE			vOutstanding;
+	BYTE			vPendingHead;
+	BYTE			Pending[HTTP_PEER_PIPELINE];
+	DWORD			dwAnswered;
+	DWORD			dwOK;
+	DWORD			dwNotModified;
+	DWORD			dwEvents;
+	struct timespec	tRequested;
+	WORD			wLine;
+	char			Line[HTTP_PEER_LINE];
+	char			ETag[HTTP_PEER_LINE];
+	char			Date[HTTP_PEER_LINE];
+} HTTP_PEER_CONNECTION;
+
+/*********************************************************************
+ * Function:        static void SendEchoRequest(int iSocket, 
+ *						PING_FRAME* pFrame, WORD wSequence)
+ *
+ * PreCondition:    pFrame is filled in apart from the sequence number
+ *					and the checksums
+ *
+ * Input:           the socket, the frame and the sequence number
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Number and send one echo request
+ *
+ * Note:            
+ ********************************************************************/
+static void SendEchoRequest(int iSocket, PING_FRAME* pFrame, WORD wSequence)
+{
+	pFrame->IP.Identification = swaps(wSequence);
+	pFrame->IP.HeaderChecksum = 0;
+	pFrame->IP.HeaderChecksum = CalcIPChecksum((BYTE*)&pFrame->IP, sizeof(IP_HEADER));
+
+	pFrame->Sequence = swaps(wSequence);
+	pFrame->Checksum = 0;
+	pFrame->Checksum = CalcIPChecksum(&pFrame->Type, sizeof(PING_FRAME) - sizeof(ETHER_HEADER) - sizeof(IP_HEADER));
+
+	if (send(iSocket, pFrame, sizeof(PING_FRAME), 0) != (ssize_t)sizeof(PING_FRAME))
+		perror("PEER: send");
+}
+
+/*********************************************************************
+ * Function:        static void InitEchoRequest(PING_FRAME* pFrame,
+ *						MAC_ADDR* pStackMAC, IP_ADDR StackIP, 
+ *						IP_ADDR PeerIP)
+ *
+ * PreCondition:    None
+ *
+ * Input:           the frame and the stack's and peer's addresses
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Fill in the parts of an echo request that are the
+ *					same for every one sent
+ *
+ * Note:            
+ ********************************************************************/
+static void InitEchoRequest(PING_FRAME* pFrame, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP)
+{
+	WORD w;
+
+	memset(pFrame, 0, sizeof(*pFrame));
+	memcpy(&pFrame->Ether.DestMACAddr, pStackMAC, sizeof(MAC_ADDR));
+	memcpy(&pFrame->Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	pFrame->Ether.Type.Val = swaps(0x0800);
+	pFrame->IP.VersionIHL = 0x45;	// IPv4, no options
+	pFrame->IP.TotalLength = swaps(sizeof(PING_FRAME) - sizeof(ETHER_HEADER));
+	pFrame->IP.TimeToLive = 64;
+	pFrame->IP.Protocol = IP_PROT_ICMP;
+	pFrame->IP.SourceAddress = PeerIP;
+	pFrame->IP.DestAddress = StackIP;
+	pFrame->Type = 8;
+	pFrame->Identifier = swaps(PING_ID);
+	for (w = 0; w < PING_DATA_LEN; w++)
+		pFrame->Data[w] = (BYTE)w;
+}
+
+// Whether a received frame is the reply to one of our echo requests;
+// anything else (ARP, NetBIOS name service, DHCP) is ignored
+static BOOL IsEchoReply(PING_FRAME* pReply, ssize_t iLength, PING_FRAME* pRequest)
+{
+	return iLength == (ssize_t)sizeof(PING_FRAME) &&
+		pReply->Ether.Type.Val == swaps(0x0800) &&
+		pReply->IP.Protocol == IP_PROT_ICMP &&
+		pReply->Type == 0 &&
+		pReply->Identifier == swaps(PING_ID) &&
+		memcmp(pReply->Data, pRequest->Data, PING_DATA_LEN) == 0;
+}
+
+BOOL HostPingPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+{
+	PING_FRAME Request, Reply;
+	struct pollfd Poll;
+	struct timespec tStart, tEnd;
+	DWORD dwSent, dwReplies, dwLost;
+	double dSeconds;
+	ssize_t iLength;
+
+	InitEchoRequest(&Request, pStackMAC, StackIP, PeerIP);
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	dwSent = 0;
+	dwReplies = 0;
+	dwLost = 0;
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+
+	while (dwReplies + dwLost < dwCount) {
+		// keep the window full
+		while (dwSent < dwCount && dwSent - dwReplies - dwLost < HOST_PEER_WINDOW) {
+			SendEchoRequest(iSocket, &Request, (WORD)dwSent);
+			dwSent++;
+		}
+
+		if (poll(&Poll, 1, HOST_PEER_TIMEOUT) <= 0) {
+			// give up on whatever is outstanding
+			dwLost = dwSent - dwReplies;
+			continue;
+		}
+
+		iLength = recv(iSocket, &Reply, sizeof(Reply), 0);
+		if (iLength <= 0)
+			break;
+
+		if (IsEchoReply(&Reply, iLength, &Request))
+			dwReplies++;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+	dSeconds = (double)(tEnd.tv_sec - tStart.tv_sec) + (double)(tEnd.tv_nsec - tStart.tv_nsec) / 1e9;
+
+	printf("PEER: %lu echo requests, %lu replies in %.2f s (%.0f per second)\n",
+		(unsigned long)dwSent, (unsigned long)dwReplies, dSeconds,
+		(dSeconds > 0.0) ? (double)dwReplies / dSeconds : 0.0);
+	fflush(stdout);
+
+	close(iSocket);
+	return dwReplies == dwCount;
+}
+
+/*********************************************************************
+ * Function:        static void SendSegment(int iSocket,
+ *						TCP_FRAME* pFrame, WORD wPort, BYTE vFlags)
+ *
+ * PreCondition:    pFrame is filled in apart from the ports, the
+ *					sequence number, the flags and the checksums
+ *
+ * Input:           the socket, the frame, the source port and the flags
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Send a SYN or RST from wPort.  The sequence number is
+ *					the port's initial one, plus one after the SYN.
+ *
+ * Note:            
+ ********************************************************************/
+static void SendSegment(int iSocket, TCP_FRAME* pFrame, WORD wPort, BYTE vFlags)
+{
+	struct __attribute__((packed, aligned(2)))
+	{
+		IP_ADDR		SourceAddress;
+		IP_ADDR		DestAddress;
+		BYTE		Zero;
+		BYTE		Protocol;
+		WORD		Length;
+		BYTE		Segment[TCP_HEADER_LEN];
+	} PseudoHeader;
+
+	pFrame->IP.Identification = swaps(wPort);
+	pFrame->IP.HeaderChecksum = 0;
+	pFrame->IP.HeaderChecksum = CalcIPChecksum((BYTE*)&pFrame->IP, sizeof(IP_HEADER));
+
+	pFrame->SourcePort = swaps(wPort);
+	pFrame->SeqNumber = swapl(SYN_PEER_ISS(wPort) + ((vFlags & TCP_FLAG_SYN) ? 0 : 1));
+	pFrame->Flags = vFlags;
+	pFrame->Checksum = 0;
+
+	PseudoHeader.SourceAddress = pFrame->IP.SourceAddress;
+	PseudoHeader.DestAddress = pFrame->IP.DestAddress;
+	PseudoHeader.Zero = 0;
+	PseudoHeader.Protocol = IP_PROT_TCP;
+	PseudoHeader.Length = swaps(TCP_HEADER_LEN);
+	memcpy(PseudoHeader.Segment, &pFrame->SourcePort, TCP_HEADER_LEN);
+	pFrame->Checksum = CalcIPChecksum((BYTE*)&PseudoHeader, sizeof(PseudoHeader));
+
+	if (send(iSocket, pFrame, sizeof(TCP_FRAME), 0) != (ssize_t)sizeof(TCP_FRAME))
+		perror("PEER: send");
+}
+
+BOOL HostSynPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, WORD wStackPort, DWORD dwCount)
+{
+	TCP_FRAME Segment, Reply;
+	struct pollfd Poll;
+	struct timespec tStart, tEnd;
+	DWORD dwSent, dwAccepted, dwLost;
+	double dSeconds;
+	ssize_t iLength;
+	WORD wPort;
+
+	memset(&Segment, 0, sizeof(Segment));
+	memcpy(&Segment.Ether.DestMACAddr, pStackMAC, sizeof(MAC_ADDR));
+	memcpy(&Segment.Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Segment.Ether.Type.Val = swaps(0x0800);
+	Segment.IP.VersionIHL = 0x45;	// IPv4, no options
+	Segment.IP.TotalLength = swaps(sizeof(TCP_FRAME) - sizeof(ETHER_HEADER));
+	Segment.IP.TimeToLive = 64;
+	Segment.IP.Protocol = IP_PROT_TCP;
+	Segment.IP.SourceAddress = PeerIP;
+	Segment.IP.DestAddress = StackIP;
+	Segment.DestPort = swaps(wStackPort);
+	Segment.DataOffset = (TCP_HEADER_LEN / 4) << 4;
+	Segment.Window = swaps(1024);
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	dwSent = 0;
+	dwAccepted = 0;
+	dwLost = 0;
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+
+	while (dwAccepted + dwLost < dwCount) {
+		// keep the window full, each connection from a new port
+		while (dwSent < dwCount && dwSent - dwAccepted - dwLost < HOST_PEER_WINDOW) {
+			SendSegment(iSocket, &Segment, SYN_PEER_PORT + (WORD)(dwSent % 60000u), TCP_FLAG_SYN);
+			dwSent++;
+		}
+
+		if (poll(&Poll, 1, HOST_PEER_TIMEOUT) <= 0) {
+			// give up on whatever is outstanding
+			dwLost = dwSent - dwAccepted;
+			continue;
+		}
+
+		iLength = recv(iSocket, &Reply, sizeof(Reply), 0);
+		if (iLength <= 0)
+			break;
+
+		// a SYN+ACK for one of our SYNs is answered with a reset, which
+		// returns the stack's socket to listening
+		if (iLength >= (ssize_t)sizeof(Reply) &&
+			Reply.Ether.Type.Val == swaps(0x0800) &&
+			Reply.IP.Protocol == IP_PROT_TCP &&
+			Reply.Flags == (TCP_FLAG_SYN | TCP_FLAG_ACK))
+		{
+			wPort = swaps(Reply.DestPort);
+			if (Reply.AckNumber == swapl(SYN_PEER_ISS(wPort) + 1)) {
+				SendSegment(iSocket, &Segment, wPort, TCP_FLAG_RST);
+				dwAccepted++;
+			}
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+	dSeconds = (double)(tEnd.tv_sec - tStart.tv_sec) + (double)(tEnd.tv_nsec - tStart.tv_nsec) / 1e9;
+
+	printf("PEER: %lu connection requests, %lu accepted in %.2f s (%.0f per second)\n",
+		(unsigned long)dwSent, (unsigned long)dwAccepted, dSeconds,
+		(dSeconds > 0.0) ? (double)dwAccepted / dSeconds : 0.0);
+	fflush(stdout);
+
+	close(iSocket);
+	return dwAccepted == dwCount;
+}
+
+static double MicrosecondsSince(struct timespec* pStart)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (double)(tNow.tv_sec - pStart->tv_sec) * 1e6 + (double)(tNow.tv_nsec - pStart->tv_nsec) / 1e3;
+}
+
+BOOL HostLatencyPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+{
+	PING_FRAME Request, Reply;
+	struct pollfd Poll;
+	struct timespec tSent, tGap;
+	DWORD dwSent, dwReplies;
+	double dRTT, dMin, dMax, dTotal;
+	ssize_t iLength;
+	int iWait;
+
+	InitEchoRequest(&Request, pStackMAC, StackIP, PeerIP);
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	tGap.tv_sec = HOST_PEER_LATENCY_GAP / 1000;
+	tGap.tv_nsec = (HOST_PEER_LATENCY_GAP % 1000) * 1000000L;
+
+	dwReplies = 0;
+	dMin = 0.0;
+	dMax = 0.0;
+	dTotal = 0.0;
+
+	for (dwSent = 0; dwSent < dwCount; dwSent++) {
+		nanosleep(&tGap, NULL);
+
+		clock_gettime(CLOCK_MONOTONIC, &tSent);
+		SendEchoRequest(iSocket, &Request, (WORD)dwSent);
+
+		// wait for this request's reply, skipping anything else
+		while (1) {
+			iWait = HOST_PEER_TIMEOUT - (int)(MicrosecondsSince(&tSent) / 1e3);
+			if (iWait <= 0 || poll(&Poll, 1, iWait) <= 0)
+				break;
+
+			iLength = recv(iSocket, &Reply, sizeof(Reply), 0);
+			if (iLength <= 0)
+				break;
+
+			if (IsEchoReply(&Reply, iLength, &Request) && Reply.Sequence == swaps((WORD)dwSent)) {
+				dRTT = MicrosecondsSince(&tSent);
+				if (dwReplies == 0 || dRTT < dMin)
+					dMin = dRTT;
+				if (dRTT > dMax)
+					dMax = dRTT;
+				dTotal += dRTT;
+				dwReplies++;
+				break;
+			}
+		}
+	}
+
+	printf("PEER: %lu echo requests, %lu replies, round trip min/avg/max %.0f/%.0f/%.0f us\n",
+		(unsigned long)dwSent, (unsigned long)dwReplies, dMin,
+		(dwReplies > 0) ? dTotal / (double)dwReplies : 0.0, dMax);
+	fflush(stdout);
+
+	close(iSocket);
+	return dwReplies == dwCount;
+}
+
+/*********************************************************************
+ * Function:        static void SendEchoSegment(int iSocket,
+ *						TCP_FRAME* pTemplate, ECHO_CONNECTION* pConn,
+ *						DWORD dwSeq, BYTE vFlags, WORD wLength)
+ *
+ * PreCondition:    pTemplate has the addresses and the echo port filled
+ *					in
+ *                  
+ * Input:           the socket, the template, the connection, the
+ *					sequence number, the flags and how many bytes of
+ *					the connection's buffer to send from dwSeq
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Clears the connection's bAckNeeded
+ *
+ * Overview:        Send one segment to the stack, acknowledging
+ *					everything received and offering the buffer space
+ *					left as the window
+ *
+ * Note:            
+ ********************************************************************/
+static void SendEchoSegment(int iSocket, TCP_FRAME* pTemplate, ECHO_CONNECTION* pConn,
+	DWORD dwSeq, BYTE vFlags, WORD wLength)
+{
+	static WORD wIdentification = 0;
+	ECHO_FRAME Frame;
+	struct __attribute__((packed, aligned(2)))
+	{
+		IP_ADDR		SourceAddress;
+		IP_ADDR		DestAddress;
+		BYTE		Zero;
+		BYTE		Protocol;
+		WORD		Length;
+		BYTE		Segment[TCP_HEADER_LEN + ECHO_PEER_MSS];
+	} PseudoHeader;
+	WORD wOffset, w;
+
+	// the data starts dwSeq - dwSndUna bytes into the buffer
+	wOffset = (WORD)(pConn->wHead + (dwSeq - pConn->dwSndUna)) % ECHO_PEER_BUFFER;
+	for (w = 0; w < wLength; w++)
+		Frame.Data[w] = pConn->Buffer[(wOffset + w) % ECHO_PEER_BUFFER];
+
+	Frame.TCP = *pTemplate;
+	Frame.TCP.IP.TotalLength = swaps(sizeof(IP_HEADER) + TCP_HEADER_LEN + wLength);
+	Frame.TCP.IP.Identification = swaps(wIdentification++);
+	Frame.TCP.IP.HeaderChecksum = 0;
+	Frame.TCP.IP.HeaderChecksum = CalcIPChecksum((BYTE*)&Frame.TCP.IP, sizeof(IP_HEADER));
+
+	Frame.TCP.SourcePort = swaps(pConn->wPeerPort);
+	Frame.TCP.DestPort = swaps(pConn->wStackPort);
+	Frame.TCP.SeqNumber = swapl(dwSeq);
+	Frame.TCP.AckNumber = swapl(pConn->dwRcvNext);
+	Frame.TCP.Flags = vFlags;
+	Frame.TCP.Window = swaps(ECHO_PEER_BUFFER - pConn->wCount);
+	Frame.TCP.Checksum = 0;
+
+	PseudoHeader.SourceAddress = Frame.TCP.IP.SourceAddress;
+	PseudoHeader.DestAddress = Frame.TCP.IP.DestAddress;
+	PseudoHeader.Zero = 0;
+	PseudoHeader.Protocol = IP_PROT_TCP;
+	PseudoHeader.Length = swaps(TCP_HEADER_LEN + wLength);
+	memcpy(PseudoHeader.Segment, &Frame.TCP.SourcePort, TCP_HEADER_LEN + wLength);
+	Frame.TCP.Checksum = CalcIPChecksum((BYTE*)&PseudoHeader,
+		sizeof(PseudoHeader) - ECHO_PEER_MSS + wLength);
+
+	if (send(iSocket, &Frame, sizeof(TCP_FRAME) + wLength, 0) != (ssize_t)(sizeof(TCP_FRAME) + wLength))
+		perror("PEER: send");
+
+	pConn->bAckNeeded = FALSE;
+}
+
+/*********************************************************************
+ * Function:        static void EchoOutput(int iSocket,
+ *						TCP_FRAME* pTemplate, ECHO_CONNECTION* pConn)
+ *
+ * PreCondition:    None
+ *                  
+ * Input:           the socket, the segment template and the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Send as much buffered data as the stack's window
+ *					allows, then the FIN once the stack's FIN has been
+ *					received and everything echoed, and otherwise an
+ *					ACK if one is owed
+ *
+ * Note:            
+ ********************************************************************/
+static void EchoOutput(int iSocket, TCP_FRAME* pTemplate, ECHO_CONNECTION* pConn)
+{
+	DWORD dwUnsent, dwInFlight, dwLength;
+
+	if (pConn->vState == ECHO_ESTABLISHED) {
+		dwUnsent = pConn->dwSndUna + pConn->wCount - pConn->dwSndNext;
+		dwInFlight = pConn->dwSndNext - pConn->dwSndUna;
+		while (dwUnsent > 0 && dwInFlight < pConn->wSndWindow) {
+			dwLength = pConn->wSndWindow - dwInFlight;
+			if (dwLength > dwUnsent)
+				dwLength = dwUnsent;
+			if (dwLength > ECHO_PEER_MSS)
+				dwLength = ECHO_PEER_MSS;
+
+			SendEchoSegment(iSocket, pTemplate, pConn, pConn->dwSndNext,
+				TCP_FLAG_ACK | TCP_FLAG_PSH, (WORD)dwLength);
+			if (pConn->dwSndNext == pConn->dwSndUna)
+				clock_gettime(CLOCK_MONOTONIC, &pConn->tSent);
+			pConn->dwSndNext += dwLength;
+			dwUnsent -= dwLength;
+			dwInFlight += dwLength;
+		}
+
+		if (pConn->bFinReceived && pConn->wCount == 0) {
+			SendEchoSegment(iSocket, pTemplate, pConn, pConn->dwSndNext, TCP_FLAG_FIN | TCP_FLAG_ACK, 0);
+			clock_gettime(CLOCK_MONOTONIC, &pConn->tSent);
+			pConn->dwSndNext++;
+			pConn->vState = ECHO_LAST_ACK;
+		}
+	}
+
+	if (pConn->bAckNeeded)
+		SendEchoSegment(iSocket, pTemplate, pConn, pConn->dwSndNext, TCP_FLAG_ACK, 0);
+}
+
+/*********************************************************************
+ * Function:        static BOOL EchoAcknowledge(ECHO_CONNECTION* pConn,
+ *						TCP_FRAME* pSegment)
+ *
+ * PreCondition:    pConn is in use and pSegment is for it
+ *                  
+ * Input:           the connection and the segment
+ *                  
+ * Output:          TRUE once the connection has closed
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take the acknowledgement and window from a segment,
+ *					freeing the acknowledged part of the buffer
+ *
+ * Note:            
+ ********************************************************************/
+static BOOL EchoAcknowledge(ECHO_CONNECTION* pConn, TCP_FRAME* pSegment)
+{
+	DWORD dwAck, dwAcked;
+
+	dwAck = swapl(pSegment->AckNumber);
+
+	if (pSegment->Flags & TCP_FLAG_ACK) {
+		dwAcked = dwAck - pConn->dwSndUna;
+		if (pConn->vState == ECHO_SYN_RECEIVED) {
+			if (dwAcked != 1)
+				return FALSE;
+			// the SYN takes the first sequence number, data the rest
+			pConn->dwSndUna = dwAck;
+			pConn->dwSndNext = dwAck;
+			pConn->vState = ECHO_ESTABLISHED;
+		} else if (dwAcked > 0 && dwAcked <= pConn->dwSndNext - pConn->dwSndUna) {
+			if (pConn->vState == ECHO_LAST_ACK && dwAck == pConn->dwSndNext)
+				return TRUE;
+			pConn->wHead = (WORD)((pConn->wHead + dwAcked) % ECHO_PEER_BUFFER);
+			pConn->wCount -= (WORD)dwAcked;
+			pConn->dwSndUna = dwAck;
+			clock_gettime(CLOCK_MONOTONIC, &pConn->tSent);
+		}
+		pConn->wSndWindow = swaps(pSegment->Window);
+	}
+
+	return FALSE;
+}
+
+/*********************************************************************
+ * Function:        static BOOL EchoInput(ECHO_CONNECTION* pConn,
+ *						TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+ *
+ * PreCondition:    pConn is in use and pSegment is for it
+ *                  
+ * Input:           the connection, the segment and its data
+ *                  
+ * Output:          TRUE once the connection has closed
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take the acknowledgement, window, in order data and
+ *					FIN from a segment
+ *
+ * Note:            
+ ********************************************************************/
+static BOOL EchoInput(ECHO_CONNECTION* pConn, TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+{
+	DWORD dwSeq;
+	WORD wTaken, wTail, w;
+
+	if (EchoAcknowledge(pConn, pSegment))
+		return TRUE;
+	dwSeq = swapl(pSegment->SeqNumber);
+
+	// data and FINs are taken in order only, anything else is answered
+	// with an ACK for what is expected next
+	if (wLength > 0 || (pSegment->Flags & TCP_FLAG_FIN))
+		pConn->bAckNeeded = TRUE;
+	if (dwSeq != pConn->dwRcvNext || pConn->bFinReceived)
+		return FALSE;
+
+	wTaken = ECHO_PEER_BUFFER - pConn->wCount;
+	if (wTaken > wLength)
+		wTaken = wLength;
+	wTail = (pConn->wHead + pConn->wCount) % ECHO_PEER_BUFFER;
+	for (w = 0; w < wTaken; w++)
+		pConn->Buffer[(wTail + w) % ECHO_PEER_BUFFER] = pData[w];
+	pConn->wCount += wTaken;
+	pConn->dwRcvNext += wTaken;
+	pConn->dwBytes += wTaken;
+
+	if ((pSegment->Flags & TCP_FLAG_FIN) && wTaken == wLength) {
+		pConn->dwRcvNext++;
+		pConn->bFinReceived = TRUE;
+	}
+
+	return FALSE;
+}
+
+/*********************************************************************
+ * Function:        static void SendARPReply(int iSocket,
+ *						ARP_FRAME* pRequest, IP_ADDR PeerIP)
+ *
+ * PreCondition:    pRequest is an ARP request for PeerIP
+ *                  
+ * Input:           the socket, the request and the peer's address
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Answer the stack's ARP request for the peer
+ *
+ * Note:            
+ ********************************************************************/
+static void SendARPReply(int iSocket, ARP_FRAME* pRequest, IP_ADDR PeerIP)
+{
+	ARP_FRAME Reply;
+
+	Reply = *pRequest;
+	memcpy(&Reply.Ether.DestMACAddr, &pRequest->Ether.SourceMACAddr, sizeof(MAC_ADDR));
+	memcpy(&Reply.Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Reply.ARP.Operation = swaps(ARP_OPERATION_RESP);
+	memcpy(&Reply.ARP.SenderMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Reply.ARP.SenderIPAddr = PeerIP;
+	Reply.ARP.TargetMACAddr = pRequest->ARP.SenderMACAddr;
+	Reply.ARP.TargetIPAddr = pRequest->ARP.SenderIPAddr;
+
+	if (send(iSocket, &Reply, sizeof(Reply), 0) != (ssize_t)sizeof(Reply))
+		perror("PEER: send");
+}
+
+BOOL HostEchoPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, WORD wPort, DWORD dwCount)
+{
+	static ECHO_CONNECTION Connections[ECHO_PEER_CONNECTIONS];
+	ECHO_CONNECTION* pConn;
+	ECHO_FRAME Received;
+	TCP_FRAME Template;
+	struct pollfd Poll;
+	struct timespec tStart, tEnd, tLastFrame;
+	DWORD dwClosed, dwReset, dwBytes;
+	double dSeconds;
+	ssize_t iLength;
+	WORD wStackPort, wData, wHeaders;
+	BYTE i;
+
+	memset(Connections, 0, sizeof(Connections));
+	memset(&Template, 0, sizeof(Template));
+	memcpy(&Template.Ether.DestMACAddr, pStackMAC, sizeof(MAC_ADDR));
+	memcpy(&Template.Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Template.Ether.Type.Val = swaps(0x0800);
+	Template.IP.VersionIHL = 0x45;	// IPv4, no options
+	Template.IP.TimeToLive = 64;
+	Template.IP.Protocol = IP_PROT_TCP;
+	Template.IP.SourceAddress = PeerIP;
+	Template.IP.DestAddress = StackIP;
+	Template.SourcePort = swaps(wPort);
+	Template.DataOffset = (TCP_HEADER_LEN / 4) << 4;
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	dwClosed = 0;
+	dwReset = 0;
+	dwBytes = 0;
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+	tLastFrame = tStart;
+
+	while (dwClosed + dwReset < dwCount) {
+		if (poll(&Poll, 1, ECHO_PEER_RTO) <= 0) {
+			if (MicrosecondsSince(&tLastFrame) / 1e3 > ECHO_PEER_IDLE_TIMEOUT)
+				break;
+		} else {
+			iLength = recv(iSocket, &Received, sizeof(Received), 0);
+			if (iLength <= 0)
+				break;
+			clock_gettime(CLOCK_MONOTONIC, &tLastFrame);
+
+			if (iLength >= (ssize_t)sizeof(ARP_FRAME) &&
+				Received.TCP.Ether.Type.Val == swaps(0x0806))
+			{
+				if (((ARP_FRAME*)&Received)->ARP.Operation == swaps(ARP_OPERATION_REQ) &&
+					((ARP_FRAME*)&Received)->ARP.TargetIPAddr.Val == PeerIP.Val)
+					SendARPReply(iSocket, (ARP_FRAME*)&Received, PeerIP);
+				continue;
+			}
+
+			// only option-free IP headers and segments for the echo port
+			if (iLength < (ssize_t)sizeof(TCP_FRAME) ||
+				Received.TCP.Ether.Type.Val != swaps(0x0800) ||
+				Received.TCP.IP.VersionIHL != 0x45 ||
+				Received.TCP.IP.Protocol != IP_PROT_TCP ||
+				Received.TCP.IP.DestAddress.Val != PeerIP.Val ||
+				Received.TCP.DestPort != swaps(wPort))
+				continue;
+
+			wHeaders = sizeof(IP_HEADER) + (Received.TCP.DataOffset >> 4) * 4;
+			if (swaps(Received.TCP.IP.TotalLength) < wHeaders ||
+				sizeof(ETHER_HEADER) + swaps(Received.TCP.IP.TotalLength) > (size_t)iLength)
+				continue;
+			wData = swaps(Received.TCP.IP.TotalLength) - wHeaders;
+
+			wStackPort = swaps(Received.TCP.SourcePort);
+			pConn = NULL;
+			for (i = 0; i < ECHO_PEER_CONNECTIONS; i++) {
+				if (Connections[i].vState != ECHO_FREE && Connections[i].wStackPort == wStackPort) {
+					pConn = &Connections[i];
+					break;
+				}
+			}
+
+			if (Received.TCP.Flags & TCP_FLAG_RST) {
+				if (pConn != NULL) {
+					dwBytes += pConn->dwBytes;
+					pConn->vState = ECHO_FREE;
+					dwReset++;
+				}
+				continue;
+			}
+
+			if (Received.TCP.Flags & TCP_FLAG_SYN) {
+				// a new connection, or the stack resending its SYN
+				if (pConn == NULL) {
+					for (i = 0; i < ECHO_PEER_CONNECTIONS && pConn == NULL; i++) {
+						if (Connections[i].vState == ECHO_FREE)
+							pConn = &Connections[i];
+					}
+					if (pConn == NULL)
+						continue;
+
+					memset(pConn, 0, sizeof(*pConn));
+					pConn->vState = ECHO_SYN_RECEIVED;
+					pConn->wPeerPort = wPort;
+					pConn->wStackPort = wStackPort;
+					pConn->dwRcvNext = swapl(Received.TCP.SeqNumber) + 1;
+					pConn->dwSndUna = ECHO_PEER_ISS(wStackPort);
+					pConn->dwSndNext = pConn->dwSndUna + 1;
+				}
+				if (pConn->vState == ECHO_SYN_RECEIVED) {
+					SendEchoSegment(iSocket, &Template, pConn, pConn->dwSndUna, TCP_FLAG_SYN | TCP_FLAG_ACK, 0);
+					clock_gettime(CLOCK_MONOTONIC, &pConn->tSent);
+				}
+				continue;
+			}
+
+			if (pConn == NULL)
+				continue;
+
+			if (EchoInput(pConn, &Received.TCP, Received.Data + wHeaders - sizeof(IP_HEADER) - TCP_HEADER_LEN, wData)) {
+				dwBytes += pConn->dwBytes;
+				pConn->vState = ECHO_FREE;
+				dwClosed++;
+				continue;
+			}
+			EchoOutput(iSocket, &Template, pConn);
+		}
+
+		// resend whatever has waited too long for its acknowledgement
+		for (i = 0; i < ECHO_PEER_CONNECTIONS; i++) {
+			pConn = &Connections[i];
+			if (pConn->vState == ECHO_FREE || pConn->dwSndNext == pConn->dwSndUna ||
+				MicrosecondsSince(&pConn->tSent) / 1e3 < ECHO_PEER_RTO)
+				continue;
+
+			clock_gettime(CLOCK_MONOTONIC, &pConn->tSent);
+			if (pConn->vState == ECHO_SYN_RECEIVED) {
+				SendEchoSegment(iSocket, &Template, pConn, pConn->dwSndUna, TCP_FLAG_SYN | TCP_FLAG_ACK, 0);
+			} else if (pConn->vState == ECHO_LAST_ACK) {
+				SendEchoSegment(iSocket, &Template, pConn, pConn->dwSndNext - 1, TCP_FLAG_FIN | TCP_FLAG_ACK, 0);
+			} else {
+				pConn->dwSndNext = pConn->dwSndUna;
+				EchoOutput(iSocket, &Template, pConn);
+			}
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+	dSeconds = (double)(tEnd.tv_sec - tStart.tv_sec) + (double)(tEnd.tv_nsec - tStart.tv_nsec) / 1e9;
+
+	printf("PEER: %lu connections closed, %lu reset, %lu bytes echoed in %.2f s\n",
+		(unsigned long)dwClosed, (unsigned long)dwReset, (unsigned long)dwBytes, dSeconds);
+	fflush(stdout);
+
+	close(iSocket);
+	return dwClosed == dwCount;
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerLine(HTTP_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    pConn->Line holds a complete line without its CRLF
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take the status line, a header, a chunk size or the
+ *					end of a chunk or of the trailer
+ *
+ * Note:            
+ ********************************************************************/
+static void HTTPPeerLine(HTTP_PEER_CONNECTION* pConn)
+{
+	char* pValue;
+	WORD w;
+
+	switch (pConn->vParse) {
+		case HTTP_PEER_STATUS:
+			if (pConn->wLine == 0)
+				break;
+			pConn->wStatus = (pConn->wLine > 9) ? (WORD)atoi(pConn->Line + 9) : 0;
+			pConn->bChunked = FALSE;
+			pConn->bClose = FALSE;
+			pConn->bEvents = FALSE;
+			pConn->dwLength = 0xfffffffful;
+			pConn->ETag[0] = '\0';
+			pConn->Date[0] = '\0';
+			pConn->vParse = HTTP_PEER_HEADERS;
+			break;
+
+		case HTTP_PEER_HEADERS:
+			if (pConn->wLine == 0) {
+				// a 304 has no body, others are chunked, have a length or
+				// end with the connection
+				if (pConn->wStatus == 304)
+					pConn->vParse = HTTP_PEER_STATUS;
+				else if (pConn->bChunked)
+					pConn->vParse = HTTP_PEER_CHUNK_SIZE;
+				else if (pConn->dwLength != 0xfffffffful)
+					pConn->vParse = HTTP_PEER_BODY;
+				else
+					pConn->vParse = HTTP_PEER_UNTIL_CLOSE;
+				break;
+			}
+			// header names are compared in lower case, values kept as sent
+			for (w = 0; w < pConn->wLine && pConn->Line[w] != ':'; w++) {
+				if (pConn->Line[w] >= 'A' && pConn->Line[w] <= 'Z')
+					pConn->Line[w] += 'a' - 'A';
+			}
+			pValue = pConn->Line + w + (w < pConn->wLine);
+			while (*pValue == ' ')
+				pValue++;
+			if (strncmp(pConn->Line, "content-length:", 15) == 0)
+				pConn->dwLength = strtoul(pConn->Line + 15, NULL, 10);
+			else if (strncmp(pConn->Line, "transfer-encoding:", 18) == 0)
+				pConn->bChunked = strstr(pConn->Line, "chunked") != NULL;
+			else if (strncmp(pConn->Line, "connection:", 11) == 0)
+				pConn->bClose = strstr(pConn->Line, "close") != NULL;
+			else if (strncmp(pConn->Line, "content-type:", 13) == 0)
+				pConn->bEvents = strcmp(pValue, "text/event-stream") == 0;
+			else if (strncmp(pConn->Line, "etag:", 5) == 0)
+				strcpy(pConn->ETag, pValue);
+			else if (strncmp(pConn->Line, "last-modified:", 14) == 0)
+				strcpy(pConn->Date, pValue);
+			break;
+
+		case HTTP_PEER_CHUNK_SIZE:
+			pConn->dwLength = strtoul(pConn->Line, NULL, 16);
+			pConn->vParse = pConn->dwLength ? HTTP_PEER_CHUNK_DATA : HTTP_PEER_TRAILER;
+			break;
+
+		case HTTP_PEER_CHUNK_END:
+			pConn->vParse = HTTP_PEER_CHUNK_SIZE;
+			break;
+
+		case HTTP_PEER_TRAILER:
+			if (pConn->wLine == 0)
+				pConn->vParse = HTTP_PEER_STATUS;
+			break;
+
+		default:
+			break;
+	}
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerAnswered(HTTP_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    A response has just ended
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Count the response against the oldest request on
+ *					the connection, and keep the validators of a file
+ *					sent in full
+ *
+ * Note:            
+ ********************************************************************/
+static void HTTPPeerAnswered(HTTP_PEER_CONNECTION* pConn)
+{
+	BYTE vFile;
+
+	vFile = pConn->Pending[pConn->vPendingHead];
+	pConn->vPendingHead = (pConn->vPendingHead + 1) % HTTP_PEER_PIPELINE;
+	if (pConn->vOutstanding > 0)
+		pConn->vOutstanding--;
+	pConn->dwAnswered++;
+
+	if (pConn->wStatus == 200) {
+		pConn->dwOK++;
+		if (vFile < HTTP_PEER_FILES) {
+			strcpy(HTTPPeerETags[vFile], pConn->ETag);
+			strcpy(HTTPPeerDates[vFile], pConn->Date);
+		}
+	} else if (pConn->wStatus == 304) {
+		pConn->dwOK++;
+		pConn->dwNotModified++;
+	}
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerEvents(HTTP_PEER_CONNECTION* pConn,
+ *						BYTE* pData, WORD wLength)
+ *
+ * PreCondition:    The response body is an event stream
+ *                  
+ * Input:           the connection and the next part of the body
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Count the events in the body, each ending with a
+ *					blank line
+ *
+ * Note:            
+ ********************************************************************/
+static void HTTPPeerEvents(HTTP_PEER_CONNECTION* pConn, BYTE* pData, WORD wLength)
+{
+	WORD w;
+
+	for (w = 0; w < wLength; w++) {
+		if (pData[w] == '\r')
+			continue;
+		if (pData[w] == '\n' && pConn->vLastByte == '\n')
+			pConn->dwEvents++;
+		pConn->vLastByte = pData[w];
+	}
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerParse(HTTP_PEER_CONNECTION* pConn,
+ *						BYTE* pData, WORD wLength)
+ *
+ * PreCondition:    None
+ *                  
+ * Input:           the connection and the data received in order
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Follow the responses through their headers and
+ *					bodies, counting each one that ends
+ *
+ * Note:            A body that ends with the connection is counted by
+ *					HTTPPeerInput() when the FIN arrives
+ ********************************************************************/
+static void HTTPPeerParse(HTTP_PEER_CONNECTION* pConn, BYTE* pData, WORD wLength)
+{
+	HTTP_PEER_PARSE vBefore;
+	DWORD dwSkip;
+
+	while (wLength > 0) {
+		vBefore = pConn->vParse;
+
+		if (pConn->vParse == HTTP_PEER_UNTIL_CLOSE)
+			return;
+
+		if (pConn->vParse == HTTP_PEER_BODY || pConn->vParse == HTTP_PEER_CHUNK_DATA) {
+			dwSkip = (pConn->dwLength < wLength) ? pConn->dwLength : wLength;
+			if (pConn->bEvents)
+				HTTPPeerEvents(pConn, pData, (WORD)dwSkip);
+			pData += dwSkip;
+			wLength -= (WORD)dwSkip;
+			pConn->dwLength -= dwSkip;
+			if (pConn->dwLength == 0)
+				pConn->vParse = (pConn->vParse == HTTP_PEER_BODY) ? HTTP_PEER_STATUS : HTTP_PEER_CHUNK_END;
+		} else {
+			if (*pData == '\n') {
+				pConn->Line[pConn->wLine] = '\0';
+				HTTPPeerLine(pConn);
+				pConn->wLine = 0;
+			} else if (*pData != '\r' && pConn->wLine < HTTP_PEER_LINE - 1) {
+				pConn->Line[pConn->wLine++] = *pData;
+			}
+			pData++;
+			wLength--;
+		}
+
+		// a response ends when parsing returns to the status line
+		if (pConn->vParse == HTTP_PEER_STATUS && vBefore != HTTP_PEER_STATUS)
+			HTTPPeerAnswered(pConn);
+	}
+}
+
+/*********************************************************************
+ * Function:        static BOOL HTTPPeerInput(HTTP_PEER_CONNECTION* pConn,
+ *						TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+ *
+ * PreCondition:    pConn is established or closing and pSegment is
+ *					for it
+ *                  
+ * Input:           the connection, the segment and its data
+ *                  
+ * Output:          TRUE once the connection has closed
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take the acknowledgement, window, in order data and
+ *					FIN from a segment, parsing the data as responses
+ *
+ * Note:            
+ ********************************************************************/
+static BOOL HTTPPeerInput(HTTP_PEER_CONNECTION* pConn, TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+{
+	if (EchoAcknowledge(&pConn->TCP, pSegment))
+		return TRUE;
+
+	if (wLength > 0 || (pSegment->Flags & TCP_FLAG_FIN))
+		pConn->TCP.bAckNeeded = TRUE;
+	if (swapl(pSegment->SeqNumber) != pConn->TCP.dwRcvNext || pConn->TCP.bFinReceived)
+		return FALSE;
+
+	HTTPPeerParse(pConn, pData, wLength);
+	pConn->TCP.dwRcvNext += wLength;
+	pConn->TCP.dwBytes += wLength;
+
+	if (pSegment->Flags & TCP_FLAG_FIN) {
+		pConn->TCP.dwRcvNext++;
+		pConn->TCP.bFinReceived = TRUE;
+		if (pConn->vParse == HTTP_PEER_UNTIL_CLOSE) {
+			pConn->vParse = HTTP_PEER_STATUS;
+			HTTPPeerAnswered(pConn);
+		}
+	}
+
+	return FALSE;
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerQueue(HTTP_PEER_CONNECTION* pConn,
+ *						HTTP_PEER_MODE vMode, DWORD dwCount,
+ *						DWORD* pdwRequested)
+ *
+ * PreCondition:    None
+ *                  
+ * Input:           the connection, what to request, the number of
+ *					requests to send in all and the number sent so far
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Adds the requests queued to *pdwRequested
+ *
+ * Overview:        Queue requests on an open connection until it has
+ *					as many unanswered as vMode allows or all have been
+ *					sent.  HTTP_PEER_PAGE asks for the next file in
+ *					turn, with the validators received for it,
+ *					HTTP_PEER_WATCH for status.xml once each
+ *					HTTP_PEER_WATCH_PERIOD and HTTP_PEER_EVENTS for
+ *					status.sse, whose response never ends.
+ *
+ * Note:            Nothing more is sent once the stack has said it
+ *					will close the connection
+ ********************************************************************/
+static void HTTPPeerQueue(HTTP_PEER_CONNECTION* pConn, HTTP_PEER_MODE vMode, DWORD dwCount, DWORD* pdwRequested)
+{
+	static BYTE vNextFile = 0;
+	ECHO_CONNECTION* pTCP;
+	char Request[HTTP_PEER_REQUEST];
+	WORD wTail, wLength, w;
+	BYTE vFile;
+
+	pTCP = &pConn->TCP;
+	while (pTCP->vState == ECHO_ESTABLISHED && !pTCP->bFinReceived && !pConn->bClose &&
+		pConn->vOutstanding < ((vMode == HTTP_PEER_PIPELINED) ? HTTP_PEER_PIPELINE : 1) &&
+		*pdwRequested < dwCount)
+	{
+		if (vMode == HTTP_PEER_WATCH && *pdwRequested > 0 &&
+			MicrosecondsSince(&pConn->tRequested) / 1e3 < HTTP_PEER_WATCH_PERIOD)
+			break;
+
+		if (vMode == HTTP_PEER_PAGE) {
+			vFile = vNextFile;
+			wLength = sprintf(Request, "GET /%s HTTP/1.1\r\nHost: meter\r\n", HTTPPeerFiles[vFile]);
+			if (HTTPPeerETags[vFile][0] != '\0')
+				wLength += sprintf(Request + wLength, "If-None-Match: %s\r\n", HTTPPeerETags[vFile]);
+			if (HTTPPeerDates[vFile][0] != '\0')
+				wLength += sprintf(Request + wLength, "If-Modified-Since: %s\r\n", HTTPPeerDates[vFile]);
+			wLength += sprintf(Request + wLength, "\r\n");
+		} else {
+			vFile = HTTP_PEER_FILES;
+			wLength = sprintf(Request, "GET /%s HTTP/1.1\r\nHost: meter\r\n\r\n",
+				(vMode == HTTP_PEER_EVENTS) ? "status.sse" : "status.xml");
+		}
+		if (pTCP->wCount + wLength > ECHO_PEER_BUFFER)
+			break;
+		if (vMode == HTTP_PEER_PAGE)
+			vNextFile = (vNextFile + 1) % HTTP_PEER_FILES;
+
+		wTail = (pTCP->wHead + pTCP->wCount) % ECHO_PEER_BUFFER;
+		for (w = 0; w < wLength; w++)
+			pTCP->Buffer[(wTail + w) % ECHO_PEER_BUFFER] = Request[w];
+		pTCP->wCount += wLength;
+		pConn->Pending[(pConn->vPendingHead + pConn->vOutstanding) % HTTP_PEER_PIPELINE] = vFile;
+		pConn->vOutstanding++;
+		clock_gettime(CLOCK_MONOTONIC, &pConn->tRequested);
+		(*pdwRequested)++;
+	}
+}
+
+/*********************************************************************
+ * Function:        static void HTTPPeerOpen(int iSocket,
+ *						TCP_FRAME* pTemplate, HTTP_PEER_CONNECTION* pConn,
+ *						WORD wPort)
+ *
+ * PreCondition:    pConn is free
+ *                  
+ * Input:           the socket, the segment template, the connection
+ *					and the source port to use
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Send a SYN to the stack's HTTP port from wPort
+ *
+ * Note:            
+ ********************************************************************/
+static void HTTPPeerOpen(int iSocket, TCP_FRAME* pTemplate, HTTP_PEER_CONNECTION* pConn, WORD wPort)
+{
+	memset(pConn, 0, sizeof(*pConn));
+	pConn->TCP.vState = ECHO_SYN_SENT;
+	pConn->TCP.wPeerPort = wPort;
+	pConn->TCP.wStackPort = HTTP_PORT;
+	pConn->TCP.dwSndUna = ECHO_PEER_ISS(wPort);
+	pConn->TCP.dwSndNext = pConn->TCP.dwSndUna + 1;
+
+	SendEchoSegment(iSocket, pTemplate, &pConn->TCP, pConn->TCP.dwSndUna, TCP_FLAG_SYN, 0);
+	clock_gettime(CLOCK_MONOTONIC, &pConn->TCP.tSent);
+}
+
+BOOL HostHTTPPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount, HTTP_PEER_MODE vMode)
+{
+	static HTTP_PEER_CONNECTION Connections[MAX_HTTP_CONNECTIONS];
+	HTTP_PEER_CONNECTION* pConn;
+	ECHO_FRAME Received;
+	TCP_FRAME Template;
+	struct pollfd Poll;
+	struct timespec tStart, tEnd, tLastFrame;
+	DWORD dwRequested, dwAnswered, dwOK, dwNotModified, dwEvents, dwBytes, dwConnections, dwReset;
+	double dSeconds;
+	ssize_t iLength;
+	WORD wPort, wData, wHeaders;
+	BYTE i, vConnections;
+	BOOL bClosed;
+	int iWait;
+
+	memset(Connections, 0, sizeof(Connections));
+	memset(&Template, 0, sizeof(Template));
+	memcpy(&Template.Ether.DestMACAddr, pStackMAC, sizeof(MAC_ADDR));
+	memcpy(&Template.Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Template.Ether.Type.Val = swaps(0x0800);
+	Template.IP.VersionIHL = 0x45;	// IPv4, no options
+	Template.IP.TimeToLive = 64;
+	Template.IP.Protocol = IP_PROT_TCP;
+	Template.IP.SourceAddress = PeerIP;
+	Template.IP.DestAddress = StackIP;
+	Template.DataOffset = (TCP_HEADER_LEN / 4) << 4;
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	dwRequested = 0;
+	dwAnswered = 0;
+	dwOK = 0;
+	dwNotModified = 0;
+	dwEvents = 0;
+	dwBytes = 0;
+	dwConnections = 0;
+	dwReset = 0;
+	wPort = HTTP_PEER_PORT;
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+	tLastFrame = tStart;
+
+	// a page watching the meter has one connection, a browser loading
+	// pages as many as the stack serves
+	vConnections = (vMode == HTTP_PEER_WATCH || vMode == HTTP_PEER_EVENTS) ? 1 : MAX_HTTP_CONNECTIONS;
+
+	while (dwAnswered + dwEvents < dwCount) {
+		// keep every connection open while requests remain to be sent
+		for (i = 0; i < vConnections; i++) {
+			if (Connections[i].TCP.vState == ECHO_FREE && dwRequested < dwCount) {
+				HTTPPeerOpen(iSocket, &Template, &Connections[i], wPort);
+				if (++wPort == 0)
+					wPort = HTTP_PEER_PORT;
+				dwConnections++;
+			}
+		}
+
+		// wake for the next status.xml request when watching
+		iWait = ECHO_PEER_RTO;
+		if (vMode == HTTP_PEER_WATCH && Connections[0].TCP.vState == ECHO_ESTABLISHED) {
+			iWait = HTTP_PEER_WATCH_PERIOD - (int)(MicrosecondsSince(&Connections[0].tRequested) / 1e3);
+			if (iWait < 1)
+				iWait = 1;
+			else if (iWait > ECHO_PEER_RTO)
+				iWait = ECHO_PEER_RTO;
+		}
+
+		if (poll(&Poll, 1, iWait) <= 0) {
+			if (MicrosecondsSince(&tLastFrame) / 1e3 > ECHO_PEER_IDLE_TIMEOUT)
+				break;
+		} else {
+			iLength = recv(iSocket, &Received, sizeof(Received), 0);
+			if (iLength <= 0)
+				break;
+			clock_gettime(CLOCK_MONOTONIC, &tLastFrame);
+
+			if (iLength >= (ssize_t)sizeof(ARP_FRAME) &&
+				Received.TCP.Ether.Type.Val == swaps(0x0806))
+			{
+				if (((ARP_FRAME*)&Received)->ARP.Operation == swaps(ARP_OPERATION_REQ) &&
+					((ARP_FRAME*)&Received)->ARP.TargetIPAddr.Val == PeerIP.Val)
+					SendARPReply(iSocket, (ARP_FRAME*)&Received, PeerIP);
+				continue;
+			}
+
+			// only option-free IP headers and segments from the HTTP port
+			if (iLength < (ssize_t)sizeof(TCP_FRAME) ||
+				Received.TCP.Ether.Type.Val != swaps(0x0800) ||
+				Received.TCP.IP.VersionIHL != 0x45 ||
+				Received.TCP.IP.Protocol != IP_PROT_TCP ||
+				Received.TCP.IP.DestAddress.Val != PeerIP.Val ||
+				Received.TCP.SourcePort != swaps(HTTP_PORT))
+				continue;
+
+			wHeaders = sizeof(IP_HEADER) + (Received.TCP.DataOffset >> 4) * 4;
+			if (swaps(Received.TCP.IP.TotalLength) < wHeaders ||
+				sizeof(ETHER_HEADER) + swaps(Received.TCP.IP.TotalLength) > (size_t)iLength)
+				continue;
+			wData = swaps(Received.TCP.IP.TotalLength) - wHeaders;
+
+			pConn = NULL;
+			for (i = 0; i < vConnections; i++) {
+				if (Connections[i].TCP.vState != ECHO_FREE &&
+					Connections[i].TCP.wPeerPort == swaps(Received.TCP.DestPort))
+				{
+					pConn = &Connections[i];
+					break;
+				}
+			}
+			if (pConn == NULL)
+				continue;
+
+			bClosed = FALSE;
+			if (Received.TCP.Flags & TCP_FLAG_RST) {
+				bClosed = TRUE;
+				dwReset++;
+			} else if (pConn->TCP.vState == ECHO_SYN_SENT) {
+				// the stack's SYN+ACK for the SYN sent
+				if ((Received.TCP.Flags & (TCP_FLAG_SYN | TCP_FLAG_ACK)) != (TCP_FLAG_SYN | TCP_FLAG_ACK) ||
+					swapl(Received.TCP.AckNumber) != pConn->TCP.dwSndNext)
+					continue;
+				pConn->TCP.dwRcvNext = swapl(Received.TCP.SeqNumber) + 1;
+				pConn->TCP.dwSndUna = pConn->TCP.dwSndNext;
+				pConn->TCP.wSndWindow = swaps(Received.TCP.Window);
+				pConn->TCP.vState = ECHO_ESTABLISHED;
+				pConn->TCP.bAckNeeded = TRUE;
+			} else {
+				bClosed = HTTPPeerInput(pConn, &Received.TCP,
+					Received.Data + wHeaders - sizeof(IP_HEADER) - TCP_HEADER_LEN, wData);
+			}
+
+			if (bClosed) {
+				// requests left unanswered go on another connection
+				dwRequested -= pConn->vOutstanding;
+				dwAnswered += pConn->dwAnswered;
+				dwOK += pConn->dwOK;
+				dwNotModified += pConn->dwNotModified;
+				dwEvents += pConn->dwEvents;
+				dwBytes += pConn->TCP.dwBytes;
+				pConn->TCP.vState = ECHO_FREE;
+				continue;
+			}
+
+			HTTPPeerQueue(pConn, vMode, dwCount, &dwRequested);
+			EchoOutput(iSocket, &Template, &pConn->TCP);
+		}
+
+		// resend whatever has waited too long for its acknowledgement,
+		// and send the requests that were waiting for their time
+		for (i = 0; i < vConnections; i++) {
+			pConn = &Connections[i];
+			if (vMode == HTTP_PEER_WATCH && pConn->TCP.wCount == 0) {
+				HTTPPeerQueue(pConn, vMode, dwCount, &dwRequested);
+				EchoOutput(iSocket, &Template, &pConn->TCP);
+			}
+			if (pConn->TCP.vState == ECHO_FREE || pConn->TCP.dwSndNext == pConn->TCP.dwSndUna ||
+				MicrosecondsSince(&pConn->TCP.tSent) / 1e3 < ECHO_PEER_RTO)
+				continue;
+
+			clock_gettime(CLOCK_MONOTONIC, &pConn->TCP.tSent);
+			if (pConn->TCP.vState == ECHO_SYN_SENT) {
+				SendEchoSegment(iSocket, &Template, &pConn->TCP, pConn->TCP.dwSndUna, TCP_FLAG_SYN, 0);
+			} else if (pConn->TCP.vState == ECHO_LAST_ACK) {
+				SendEchoSegment(iSocket, &Template, &pConn->TCP, pConn->TCP.dwSndNext - 1, TCP_FLAG_FIN | TCP_FLAG_ACK, 0);
+			} else {
+				pConn->TCP.dwSndNext = pConn->TCP.dwSndUna;
+				EchoOutput(iSocket, &Template, &pConn->TCP);
+			}
+		}
+
+		// count the responses and events on connections still open
+		if (dwAnswered + dwEvents < dwCount) {
+			DWORD dwOpen = 0;
+
+			for (i = 0; i < vConnections; i++) {
+				if (Connections[i].TCP.vState != ECHO_FREE)
+					dwOpen += Connections[i].dwAnswered + Connections[i].dwEvents;
+			}
+			if (dwAnswered + dwEvents + dwOpen >= dwCount)
+				break;
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+	dSeconds = (double)(tEnd.tv_sec - tStart.tv_sec) + (double)(tEnd.tv_nsec - tStart.tv_nsec) / 1e9;
+
+	// reset the connections still open so the stack's sockets listen again
+	for (i = 0; i < vConnections; i++) {
+		pConn = &Connections[i];
+		if (pConn->TCP.vState == ECHO_FREE)
+			continue;
+		dwAnswered += pConn->dwAnswered;
+		dwOK += pConn->dwOK;
+		dwNotModified += pConn->dwNotModified;
+		dwEvents += pConn->dwEvents;
+		dwBytes += pConn->TCP.dwBytes;
+		SendEchoSegment(iSocket, &Template, &pConn->TCP, pConn->TCP.dwSndNext, TCP_FLAG_RST | TCP_FLAG_ACK, 0);
+	}
+
+	printf("PEER: %lu responses, %lu OK (%lu not modified), %lu events, %lu bytes, on %lu connections "
+		"(%lu reset) in %.2f s, %.0f requests/s\n",
+		(unsigned long)dwAnswered, (unsigned long)dwOK, (unsigned long)dwNotModified,
+		(unsigned long)dwEvents, (unsigned long)dwBytes, (unsigned long)dwConnections,
+		(unsigned long)dwReset, dSeconds, dSeconds > 0 ? dwAnswered / dSeconds : 0.0);
+	fflush(stdout);
+
+	close(iSocket);
+	return dwOK + dwEvents >= dwCount;
+}
+
+#if defined(STACK_USE_SSL_SERVER)
+/*********************************************************************
+ * The SSL client
+ ********************************************************************/
+
+// the first source port HostSSLPeer() connects from
+#define SSL_PEER_PORT			(4096u)
+
+// how many browsers HostSSLPeer() handshakes for in turn, each keeping
+// the session it was last given, as many as the stack caches
+#define SSL_PEER_BROWSERS		(MAX_SSL_SESSIONS)
+
+// the largest record HostSSLPeer() takes, and the most handshake bytes
+// it holds while a message arrives
+#define SSL_PEER_RECORD			(2048u)
+
+// ms HostSSLPeer() waits for the stack to save its sessions and then to
+// restart SSL before the third round of handshakes
+#define SSL_PEER_SAVE_WAIT		((DWORD)(SSL_SESSION_SAVE_PERIOD * 1000ull / TICK_SECOND) + 500u)
+#define SSL_PEER_RESTART_WAIT	(500u)
+
+#define SSL_PEER_HEADER			(5u)
+#define SSL_PEER_MAC			(16u)
+
+// a session a browser would offer to resume
+typedef struct
+{
+	BOOL			bValid;
+	BYTE			SessionID[32];
+	BYTE			MasterSecret[48];
+} SSL_PEER_SESSION;
+
+// one connection to the HTTPS port, SSL 3.0 with RSA_WITH_RC4_128_MD5
+// as SSL.c speaks it; records are taken whole, handshake messages once
+// complete
+typedef struct
+{
+	ECHO_CONNECTION	TCP;
+	SSL_PEER_SESSION* pSession;
+	BOOL			bResuming;
+	BOOL			bResumed;
+	BOOL			bClientCCS;
+	BOOL			bServerCCS;
+	BOOL			bDone;
+	BOOL			bFailed;
+	WORD			wRecord;
+	WORD			wHandshake;
+	BYTE			Record[SSL_PEER_HEADER + SSL_PEER_RECORD];
+	BYTE			Handshake[SSL_PEER_RECORD];
+	BYTE			ClientRandom[32];
+	BYTE			ServerRandom[32];
+	BYTE			MasterSecret[48];
+	HASH_SUM		MD5;
+	HASH_SUM		SHA1;
+	BYTE			ClientMAC[16];
+	BYTE			ServerMAC[16];
+	DWORD			dwClientSeq;
+	DWORD			dwServerSeq;
+	ARCFOUR_CTX		ClientCipher;
+	ARCFOUR_CTX		ServerCipher;
+	BYTE			ClientSbox[256];
+	BYTE			ServerSbox[256];
+} SSL_PEER_CONNECTION;
+
+static SSL_PEER_SESSION SSLPeerSessions[SSL_PEER_BROWSERS];
+
+/*********************************************************************
+ * Function:        static void SSLPeerHashRounds(BYTE* vSecret,
+ *						BYTE* vRandom1, BYTE* vRandom2, BYTE* vResult,
+ *						BYTE vRounds)
+ *
+ * PreCondition:    None
+ *                  
+ * Input:           the 48 byte secret, the two randoms in the order
+ *					hashed, 16 bytes a round for the result and the
+ *					number of rounds
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        SSL 3.0's MD5(secret + SHA('A'.. + secret +
+ *					randoms)) rounds, giving the master secret from
+ *					the premaster secret or the key block from it
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerHashRounds(BYTE* vSecret, BYTE* vRandom1, BYTE* vRandom2, BYTE* vResult, BYTE vRounds)
+{
+	HASH_SUM Hash;
+	BYTE vSHA[20], vLabel[8];
+	BYTE i;
+
+	for (i = 0; i < vRounds; i++) {
+		memset(vLabel, 'A' + i, i + 1);
+		SHA1Initialize(&Hash);
+		SHA1AddData(&Hash, vLabel, i + 1);
+		SHA1AddData(&Hash, vSecret, 48);
+		SHA1AddData(&Hash, vRandom1, 32);
+		SHA1AddData(&Hash, vRandom2, 32);
+		SHA1Calculate(&Hash, vSHA);
+
+		MD5Initialize(&Hash);
+		MD5AddData(&Hash, vSecret, 48);
+		MD5AddData(&Hash, vSHA, 20);
+		MD5Calculate(&Hash, vResult + 16u * i);
+	}
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerKeys(SSL_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    the master secret and both randoms are known
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Derive the MAC secrets and ARCFOUR keys of each
+ *					direction from the key block
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerKeys(SSL_PEER_CONNECTION* pConn)
+{
+	BYTE vBlock[64];
+
+	SSLPeerHashRounds(pConn->MasterSecret, pConn->ServerRandom, pConn->ClientRandom, vBlock, 4);
+	memcpy(pConn->ClientMAC, vBlock, 16);
+	memcpy(pConn->ServerMAC, vBlock + 16, 16);
+	pConn->ClientCipher.Sbox = pConn->ClientSbox;
+	ARCFOURInitialize(&pConn->ClientCipher, vBlock + 32, 16);
+	pConn->ServerCipher.Sbox = pConn->ServerSbox;
+	ARCFOURInitialize(&pConn->ServerCipher, vBlock + 48, 16);
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerMAC(BYTE* vSecret, DWORD dwSeq,
+ *						BYTE vType, BYTE* vData, WORD wLength,
+ *						BYTE* vResult)
+ *
+ * PreCondition:    None
+ *                  
+ * Input:           the MAC secret, the record's sequence number, type
+ *					and data, and 16 bytes for the MAC
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        SSL 3.0's MD5 record MAC
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerMAC(BYTE* vSecret, DWORD dwSeq, BYTE vType, BYTE* vData, WORD wLength, BYTE* vResult)
+{
+	HASH_SUM Hash;
+	BYTE vPad[48], vHeader[11];
+
+	memset(vHeader, 0, 4);
+	vHeader[4] = (BYTE)(dwSeq >> 24);
+	vHeader[5] = (BYTE)(dwSeq >> 16);
+	vHeader[6] = (BYTE)(dwSeq >> 8);
+	vHeader[7] = (BYTE)dwSeq;
+	vHeader[8] = vType;
+	vHeader[9] = (BYTE)(wLength >> 8);
+	vHeader[10] = (BYTE)wLength;
+
+	memset(vPad, 0x36, sizeof(vPad));
+	MD5Initialize(&Hash);
+	MD5AddData(&Hash, vSecret, 16);
+	MD5AddData(&Hash, vPad, sizeof(vPad));
+	MD5AddData(&Hash, vHeader, sizeof(vHeader));
+	MD5AddData(&Hash, vData, wLength);
+	MD5Calculate(&Hash, vResult);
+
+	memset(vPad, 0x5c, sizeof(vPad));
+	MD5Initialize(&Hash);
+	MD5AddData(&Hash, vSecret, 16);
+	MD5AddData(&Hash, vPad, sizeof(vPad));
+	MD5AddData(&Hash, vResult, 16);
+	MD5Calculate(&Hash, vResult);
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerFinished(SSL_PEER_CONNECTION* pConn,
+ *						BOOL bClient, BYTE* vResult)
+ *
+ * PreCondition:    the handshake hashes hold the messages before the
+ *					Finished
+ *                  
+ * Input:           the connection, TRUE for the client's Finished or
+ *					FALSE for the server's, and 36 bytes for the result
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        SSL 3.0's Finished hashes, MD5 then SHA-1
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerFinished(SSL_PEER_CONNECTION* pConn, BOOL bClient, BYTE* vResult)
+{
+	HASH_SUM Hash;
+	BYTE vPad[48], vInner[20];
+
+	Hash = pConn->MD5;
+	MD5AddData(&Hash, (BYTE*)(bClient ? "CLNT" : "SRVR"), 4);
+	MD5AddData(&Hash, pConn->MasterSecret, 48);
+	memset(vPad, 0x36, 48);
+	MD5AddData(&Hash, vPad, 48);
+	MD5Calculate(&Hash, vInner);
+	MD5Initialize(&Hash);
+	MD5AddData(&Hash, pConn->MasterSecret, 48);
+	memset(vPad, 0x5c, 48);
+	MD5AddData(&Hash, vPad, 48);
+	MD5AddData(&Hash, vInner, 16);
+	MD5Calculate(&Hash, vResult);
+
+	Hash = pConn->SHA1;
+	SHA1AddData(&Hash, (BYTE*)(bClient ? "CLNT" : "SRVR"), 4);
+	SHA1AddData(&Hash, pConn->MasterSecret, 48);
+	memset(vPad, 0x36, 40);
+	SHA1AddData(&Hash, vPad, 40);
+	SHA1Calculate(&Hash, vInner);
+	SHA1Initialize(&Hash);
+	SHA1AddData(&Hash, pConn->MasterSecret, 48);
+	memset(vPad, 0x5c, 40);
+	SHA1AddData(&Hash, vPad, 40);
+	SHA1AddData(&Hash, vInner, 20);
+	SHA1Calculate(&Hash, vResult + 16);
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerSend(SSL_PEER_CONNECTION* pConn,
+ *						BYTE vType, BYTE* vData, WORD wLength)
+ *
+ * PreCondition:    the data fits in the connection's buffer
+ *                  
+ * Input:           the connection, the record's type and its data
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Handshake messages are added to the handshake
+ *					hashes
+ *
+ * Overview:        Queue one record for the stack, with a MAC and
+ *					encrypted once the client's ChangeCipherSpec has
+ *					been sent
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerSend(SSL_PEER_CONNECTION* pConn, BYTE vType, BYTE* vData, WORD wLength)
+{
+	BYTE vRecord[SSL_PEER_HEADER + 128u + SSL_PEER_MAC];
+	ECHO_CONNECTION* pTCP;
+	WORD wTail, w;
+
+	if (vType == SSL_HANDSHAKE) {
+		MD5AddData(&pConn->MD5, vData, wLength);
+		SHA1AddData(&pConn->SHA1, vData, wLength);
+	}
+
+	memcpy(vRecord + SSL_PEER_HEADER, vData, wLength);
+	if (pConn->bClientCCS) {
+		SSLPeerMAC(pConn->ClientMAC, pConn->dwClientSeq++, vType, vData, wLength,
+			vRecord + SSL_PEER_HEADER + wLength);
+		wLength += SSL_PEER_MAC;
+		ARCFOURCrypt(&pConn->ClientCipher, vRecord + SSL_PEER_HEADER, wLength);
+	}
+	vRecord[0] = vType;
+	vRecord[1] = SSL_VERSION_HI;
+	vRecord[2] = SSL_VERSION_LO;
+	vRecord[3] = (BYTE)(wLength >> 8);
+	vRecord[4] = (BYTE)wLength;
+
+	pTCP = &pConn->TCP;
+	wTail = (pTCP->wHead + pTCP->wCount) % ECHO_PEER_BUFFER;
+	for (w = 0; w < SSL_PEER_HEADER + wLength; w++)
+		pTCP->Buffer[(wTail + w) % ECHO_PEER_BUFFER] = vRecord[w];
+	pTCP->wCount += SSL_PEER_HEADER + wLength;
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerHello(SSL_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    the connection has just been established
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Queue the ClientHello, offering the browser's
+ *					session if it is resuming
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerHello(SSL_PEER_CONNECTION* pConn)
+{
+	BYTE vHello[4 + 2 + 32 + 1 + 32 + 4 + 2];
+	WORD wLength, w;
+
+	for (w = 0; w < sizeof(pConn->ClientRandom); w++)
+		pConn->ClientRandom[w] = (BYTE)rand();
+
+	wLength = 4;
+	vHello[wLength++] = SSL_VERSION_HI;
+	vHello[wLength++] = SSL_VERSION_LO;
+	memcpy(vHello + wLength, pConn->ClientRandom, 32);
+	wLength += 32;
+	if (pConn->bResuming) {
+		vHello[wLength++] = 32;
+		memcpy(vHello + wLength, pConn->pSession->SessionID, 32);
+		wLength += 32;
+	} else {
+		vHello[wLength++] = 0;
+	}
+	vHello[wLength++] = 0x00;	// one cipher suite, RSA_WITH_RC4_128_MD5
+	vHello[wLength++] = 0x02;
+	vHello[wLength++] = 0x00;
+	vHello[wLength++] = 0x04;
+	vHello[wLength++] = 0x01;	// null compression
+	vHello[wLength++] = 0x00;
+
+	vHello[0] = SSL_CLIENT_HELLO;
+	vHello[1] = 0;
+	vHello[2] = 0;
+	vHello[3] = (BYTE)(wLength - 4);
+	SSLPeerSend(pConn, SSL_HANDSHAKE, vHello, wLength);
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerChangeCipher(SSL_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    the keys have been derived
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Queue the client's ChangeCipherSpec, then its
+ *					Finished under the new keys
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerChangeCipher(SSL_PEER_CONNECTION* pConn)
+{
+	BYTE vMessage[4 + 36];
+
+	vMessage[0] = 1;
+	SSLPeerSend(pConn, SSL_CHANGE_CIPHER_SPEC, vMessage, 1);
+	pConn->bClientCCS = TRUE;
+	pConn->dwClientSeq = 0;
+
+	vMessage[0] = SSL_FINISHED;
+	vMessage[1] = 0;
+	vMessage[2] = 0;
+	vMessage[3] = 36;
+	SSLPeerFinished(pConn, TRUE, vMessage + 4);
+	SSLPeerSend(pConn, SSL_HANDSHAKE, vMessage, sizeof(vMessage));
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerMessage(SSL_PEER_CONNECTION* pConn,
+ *						BYTE* vMessage, WORD wLength)
+ *
+ * PreCondition:    vMessage is a whole handshake message, header and
+ *					all
+ *                  
+ * Input:           the connection and the message
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Sets bDone once the handshake is over, or bFailed
+ *
+ * Overview:        Take a handshake message from the stack: note the
+ *					server's random and whether the session was
+ *					resumed from the ServerHello, answer the
+ *					ServerHelloDone with the ClientKeyExchange,
+ *					ChangeCipherSpec and Finished, and check the
+ *					server's Finished, answering it when resuming
+ *
+ * Note:            The certificate is not looked at, as the key in it
+ *					is HostRSA.c's test key
+ ********************************************************************/
+static void SSLPeerMessage(SSL_PEER_CONNECTION* pConn, BYTE* vMessage, WORD wLength)
+{
+	BYTE vPremaster[48], vExchange[4 + SSL_RSA_KEY_SIZE / 8], vExpected[36];
+	BYTE vIDLength;
+	WORD w;
+
+	switch (vMessage[0]) {
+		case SSL_SERVER_HELLO:
+			// version, random and session ID
+			vIDLength = vMessage[4 + 2 + 32];
+			if (wLength < 4 + 2 + 32 + 1 + vIDLength + 3 || vIDLength > 32) {
+				pConn->bFailed = TRUE;
+				return;
+			}
+			memcpy(pConn->ServerRandom, vMessage + 4 + 2, 32);
+			pConn->bResumed = pConn->bResuming && vIDLength == 32 &&
+				memcmp(vMessage + 4 + 2 + 32 + 1, pConn->pSession->SessionID, 32) == 0;
+			pConn->pSession->bValid = FALSE;
+			if (vIDLength == 32)
+				memcpy(pConn->pSession->SessionID, vMessage + 4 + 2 + 32 + 1, 32);
+			if (pConn->bResumed) {
+				memcpy(pConn->MasterSecret, pConn->pSession->MasterSecret, 48);
+				SSLPeerKeys(pConn);
+			}
+			break;
+
+		case SSL_SERVER_HELLO_DONE:
+			MD5AddData(&pConn->MD5, vMessage, wLength);
+			SHA1AddData(&pConn->SHA1, vMessage, wLength);
+
+			// the premaster secret, to the certificate's key
+			vPremaster[0] = SSL_VERSION_HI;
+			vPremaster[1] = SSL_VERSION_LO;
+			for (w = 2; w < sizeof(vPremaster); w++)
+				vPremaster[w] = (BYTE)rand();
+			if (!HostRSAEncrypt(vPremaster, sizeof(vPremaster), vExchange + 4)) {
+				pConn->bFailed = TRUE;
+				return;
+			}
+			vExchange[0] = SSL_CLIENT_KEY_EXCHANGE;
+			vExchange[1] = 0;
+			vExchange[2] = (BYTE)((SSL_RSA_KEY_SIZE / 8) >> 8);
+			vExchange[3] = (BYTE)(SSL_RSA_KEY_SIZE / 8);
+			SSLPeerSend(pConn, SSL_HANDSHAKE, vExchange, sizeof(vExchange));
+
+			SSLPeerHashRounds(vPremaster, pConn->ClientRandom, pConn->ServerRandom, pConn->MasterSecret, 3);
+			SSLPeerKeys(pConn);
+			SSLPeerChangeCipher(pConn);
+			return;
+
+		case SSL_FINISHED:
+			SSLPeerFinished(pConn, FALSE, vExpected);
+			if (!pConn->bServerCCS || wLength != 4 + 36 ||
+				memcmp(vMessage + 4, vExpected, 36) != 0) {
+				pConn->bFailed = TRUE;
+				return;
+			}
+			MD5AddData(&pConn->MD5, vMessage, wLength);
+			SHA1AddData(&pConn->SHA1, vMessage, wLength);
+			if (pConn->bResumed)
+				SSLPeerChangeCipher(pConn);
+
+			// the browser keeps the session to offer next time
+			memcpy(pConn->pSession->MasterSecret, pConn->MasterSecret, 48);
+			pConn->pSession->bValid = TRUE;
+			pConn->bDone = TRUE;
+			return;
+
+		default:
+			break;
+	}
+
+	MD5AddData(&pConn->MD5, vMessage, wLength);
+	SHA1AddData(&pConn->SHA1, vMessage, wLength);
+}
+
+/*********************************************************************
+ * Function:        static void SSLPeerRecord(SSL_PEER_CONNECTION* pConn)
+ *
+ * PreCondition:    Record holds a whole record
+ *                  
+ * Input:           the connection
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Sets bFailed if the record cannot be taken
+ *
+ * Overview:        Decrypt and check a record once the server's
+ *					ChangeCipherSpec has arrived, then pass on the
+ *					handshake messages it completes
+ *
+ * Note:            
+ ********************************************************************/
+static void SSLPeerRecord(SSL_PEER_CONNECTION* pConn)
+{
+	BYTE* pBody;
+	BYTE vMAC[SSL_PEER_MAC];
+	WORD wBody, wMessage;
+
+	pBody = pConn->Record + SSL_PEER_HEADER;
+	wBody = pConn->wRecord - SSL_PEER_HEADER;
+	if (pConn->bServerCCS) {
+		ARCFOURCrypt(&pConn->ServerCipher, pBody, wBody);
+		if (wBody < SSL_PEER_MAC) {
+			pConn->bFailed = TRUE;
+			return;
+		}
+		wBody -= SSL_PEER_MAC;
+		SSLPeerMAC(pConn->ServerMAC, pConn->dwServerSeq++, pConn->Record[0], pBody, wBody, vMAC);
+		if (memcmp(vMAC, pBody + wBody, SSL_PEER_MAC) != 0) {
+			pConn->bFailed = TRUE;
+			return;
+		}
+	}
+
+	switch (pConn->Record[0]) {
+		case SSL_CHANGE_CIPHER_SPEC:
+			if (!pConn->bResumed && !pConn->bClientCCS) {
+				pConn->bFailed = TRUE;
+				return;
+			}
+			pConn->bServerCCS = TRUE;
+			pConn->dwServerSeq = 0;
+			break;
+
+		case SSL_HANDSHAKE:
+			if (pConn->wHandshake + wBody > sizeof(pConn->Handshake)) {
+				pConn->bFailed = TRUE;
+				return;
+			}
+			memcpy(pConn->Handshake + pConn->wHandshake, pBody, wBody);
+			pConn->wHandshake += wBody;
+			while (pConn->wHandshake >= 4 && !pConn->bFailed) {
+				wMessage = 4 + ((WORD)pConn->Handshake[2] << 8) + pConn->Handshake[3];
+				if (pConn->Handshake[1] != 0 || wMessage > sizeof(pConn->Handshake)) {
+					pConn->bFailed = TRUE;
+					return;
+				}
+				if (pConn->wHandshake < wMessage)
+					break;
+				SSLPeerMessage(pConn, pConn->Handshake, wMessage);
+				pConn->wHandshake -= wMessage;
+				memmove(pConn->Handshake, pConn->Handshake + wMessage, pConn->wHandshake);
+			}
+			break;
+
+		case SSL_ALERT:
+			if (!pConn->bDone)
+				pConn->bFailed = TRUE;
+			break;
+
+		default:
+			break;
+	}
+}
+
+/*********************************************************************
+ * Function:        static BOOL SSLPeerInput(SSL_PEER_CONNECTION* pConn,
+ *						TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+ *
+ * PreCondition:    pConn is in use and pSegment is for it
+ *                  
+ * Input:           the connection, the segment and its data
+ *                  
+ * Output:          TRUE once the connection has closed
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take the acknowledgement, window, in order data and
+ *					FIN from a segment, gathering the data into records
+ *
+ * Note:            
+ ********************************************************************/
+static BOOL SSLPeerInput(SSL_PEER_CONNECTION* pConn, TCP_FRAME* pSegment, BYTE* pData, WORD wLength)
+{
+	WORD wNeeded, wTaken;
+
+	if (EchoAcknowledge(&pConn->TCP, pSegment))
+		return TRUE;
+
+	if (wLength > 0 || (pSegment->Flags & TCP_FLAG_FIN))
+		pConn->TCP.bAckNeeded = TRUE;
+	if (swapl(pSegment->SeqNumber) != pConn->TCP.dwRcvNext || pConn->TCP.bFinReceived)
+		return FALSE;
+	pConn->TCP.dwRcvNext += wLength;
+	pConn->TCP.dwBytes += wLength;
+	if (pSegment->Flags & TCP_FLAG_FIN) {
+		pConn->TCP.dwRcvNext++;
+		pConn->TCP.bFinReceived = TRUE;
+	}
+
+	while (wLength > 0 && !pConn->bFailed) {
+		if (pConn->wRecord < SSL_PEER_HEADER)
+			wNeeded = SSL_PEER_HEADER - pConn->wRecord;
+		else
+			wNeeded = SSL_PEER_HEADER + ((WORD)pConn->Record[3] << 8) + pConn->Record[4] - pConn->wRecord;
+		wTaken = (wLength < wNeeded) ? wLength : wNeeded;
+		memcpy(pConn->Record + pConn->wRecord, pData, wTaken);
+		pConn->wRecord += wTaken;
+		pData += wTaken;
+		wLength -= wTaken;
+
+		if (pConn->wRecord == SSL_PEER_HEADER &&
+			((WORD)pConn->Record[3] << 8) + pConn->Record[4] > SSL_PEER_RECORD)
+			pConn->bFailed = TRUE;
+		else if (pConn->wRecord > SSL_PEER_HEADER && wTaken == wNeeded) {
+			SSLPeerRecord(pConn);
+			pConn->wRecord = 0;
+		}
+	}
+
+	return FALSE;
+}
+
+/*********************************************************************
+ * Function:        static BOOL SSLPeerHandshake(int iSocket,
+ *						TCP_FRAME* pTemplate, IP_ADDR PeerIP,
+ *						SSL_PEER_CONNECTION* pConn, WORD wPort,
+ *						double* pdMilliseconds)
+ *
+ * PreCondition:    pConn is set up with the browser's session and
+ *					whether to offer it
+ *                  
+ * Input:           the socket, the segment template, the peer's
+ *					address, the connection, the source port to use
+ *					and where to put the handshake's time
+ *                  
+ * Output:          TRUE if the handshake completed
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Connect to the stack's HTTPS port, handshake, then
+ *					send a close_notify and reset the connection once
+ *					it has been acknowledged.  The time is from the
+ *					SYN to the server's Finished being checked.
+ *
+ * Note:            
+ ********************************************************************/
+static BOOL SSLPeerHandshake(int iSocket, TCP_FRAME* pTemplate, IP_ADDR PeerIP,
+	SSL_PEER_CONNECTION* pConn, WORD wPort, double* pdMilliseconds)
+{
+	ECHO_FRAME Received;
+	struct pollfd Poll;
+	struct timespec tStart, tLastFrame;
+	ssize_t iLength;
+	WORD wData, wHeaders;
+	BYTE vAlert[2];
+
+	pConn->TCP.vState = ECHO_SYN_SENT;
+	pConn->TCP.wPeerPort = wPort;
+	pConn->TCP.wStackPort = HTTPS_PORT;
+	pConn->TCP.dwSndUna = ECHO_PEER_ISS(wPort);
+	pConn->TCP.dwSndNext = pConn->TCP.dwSndUna + 1;
+	MD5Initialize(&pConn->MD5);
+	SHA1Initialize(&pConn->SHA1);
+
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+	tLastFrame = tStart;
+	SendEchoSegment(iSocket, pTemplate, &pConn->TCP, pConn->TCP.dwSndUna, TCP_FLAG_SYN, 0);
+	pConn->TCP.tSent = tStart;
+
+	Poll.fd = iSocket;
+	Poll.events = POLLIN;
+
+	// until the close_notify has been acknowledged
+	while (!pConn->bFailed && !(pConn->bDone && pConn->TCP.wCount == 0)) {
+		if (poll(&Poll, 1, ECHO_PEER_RTO) <= 0) {
+			if (MicrosecondsSince(&tLastFrame) / 1e3 > ECHO_PEER_IDLE_TIMEOUT)
+				pConn->bFailed = TRUE;
+		} else {
+			iLength = recv(iSocket, &Received, sizeof(Received), 0);
+			if (iLength <= 0) {
+				pConn->bFailed = TRUE;
+				break;
+			}
+			clock_gettime(CLOCK_MONOTONIC, &tLastFrame);
+
+			if (iLength >= (ssize_t)sizeof(ARP_FRAME) &&
+				Received.TCP.Ether.Type.Val == swaps(0x0806))
+			{
+				if (((ARP_FRAME*)&Received)->ARP.Operation == swaps(ARP_OPERATION_REQ) &&
+					((ARP_FRAME*)&Received)->ARP.TargetIPAddr.Val == PeerIP.Val)
+					SendARPReply(iSocket, (ARP_FRAME*)&Received, PeerIP);
+				continue;
+			}
+
+			// only option-free IP headers and segments for this connection
+			if (iLength < (ssize_t)sizeof(TCP_FRAME) ||
+				Received.TCP.Ether.Type.Val != swaps(0x0800) ||
+				Received.TCP.IP.VersionIHL != 0x45 ||
+				Received.TCP.IP.Protocol != IP_PROT_TCP ||
+				Received.TCP.IP.DestAddress.Val != PeerIP.Val ||
+				Received.TCP.SourcePort != swaps(HTTPS_PORT) ||
+				Received.TCP.DestPort != swaps(wPort))
+				continue;
+
+			wHeaders = sizeof(IP_HEADER) + (Received.TCP.DataOffset >> 4) * 4;
+			if (swaps(Received.TCP.IP.TotalLength) < wHeaders ||
+				sizeof(ETHER_HEADER) + swaps(Received.TCP.IP.TotalLength) > (size_t)iLength)
+				continue;
+			wData = swaps(Received.TCP.IP.TotalLength) - wHeaders;
+
+			if (Received.TCP.Flags & TCP_FLAG_RST) {
+				pConn->bFailed = TRUE;
+				break;
+			} else if (pConn->TCP.vState == ECHO_SYN_SENT) {
+				// the stack's SYN+ACK for the SYN sent
+				if ((Received.TCP.Flags & (TCP_FLAG_SYN | TCP_FLAG_ACK)) != (TCP_FLAG_SYN | TCP_FLAG_ACK) ||
+					swapl(Received.TCP.AckNumber) != pConn->TCP.dwSndNext)
+					continue;
+				pConn->TCP.dwRcvNext = swapl(Received.TCP.SeqNumber) + 1;
+				pConn->TCP.dwSndUna = pConn->TCP.dwSndNext;
+				pConn->TCP.wSndWindow = swaps(Received.TCP.Window);
+				pConn->TCP.vState = ECHO_ESTABLISHED;
+				SSLPeerHello(pConn);
+			} else if (SSLPeerInput(pConn, &Received.TCP,
+				Received.Data + wHeaders - sizeof(IP_HEADER) - TCP_HEADER_LEN, wData)) {
+				pConn->bFailed = TRUE;
+				break;
+			}
+
+			if (pConn->bDone && *pdMilliseconds == 0.0) {
+				*pdMilliseconds = MicrosecondsSince(&tStart) / 1e3;
+				vAlert[0] = SSL_ALERT_WARNING;
+				vAlert[1] = SSL_ALERT_CLOSE_NOTIFY & 0x7F;
+				SSLPeerSend(pConn, SSL_ALERT, vAlert, sizeof(vAlert));
+			}
+			EchoOutput(iSocket, pTemplate, &pConn->TCP);
+		}
+
+		// resend whatever has waited too long for its acknowledgement
+		if (pConn->TCP.dwSndNext != pConn->TCP.dwSndUna &&
+			MicrosecondsSince(&pConn->TCP.tSent) / 1e3 >= ECHO_PEER_RTO) {
+			clock_gettime(CLOCK_MONOTONIC, &pConn->TCP.tSent);
+			if (pConn->TCP.vState == ECHO_SYN_SENT) {
+				SendEchoSegment(iSocket, pTemplate, &pConn->TCP, pConn->TCP.dwSndUna, TCP_FLAG_SYN, 0);
+			} else {
+				pConn->TCP.dwSndNext = pConn->TCP.dwSndUna;
+				EchoOutput(iSocket, pTemplate, &pConn->TCP);
+			}
+		}
+	}
+
+	// the stack's socket listens again
+	if (pConn->TCP.vState != ECHO_SYN_SENT)
+		SendEchoSegment(iSocket, pTemplate, &pConn->TCP, pConn->TCP.dwSndNext, TCP_FLAG_RST | TCP_FLAG_ACK, 0);
+	return !pConn->bFailed;
+}
+
+BOOL HostSSLPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+{
+	static SSL_PEER_CONNECTION Conn;
+	static ROM char* szRounds[] = {"full", "resumed", "restarted"};
+	TCP_FRAME Template;
+	struct timespec tStart;
+	DWORD i, dwHandshakes, dwResumed;
+	double dSeconds, dMilliseconds, dTotal;
+	WORD wPort;
+	BYTE vRound;
+	BOOL bOK;
+
+	memset(&Template, 0, sizeof(Template));
+	memcpy(&Template.Ether.DestMACAddr, pStackMAC, sizeof(MAC_ADDR));
+	memcpy(&Template.Ether.SourceMACAddr, PeerMACAddress, sizeof(MAC_ADDR));
+	Template.Ether.Type.Val = swaps(0x0800);
+	Template.IP.VersionIHL = 0x45;	// IPv4, no options
+	Template.IP.TimeToLive = 64;
+	Template.IP.Protocol = IP_PROT_TCP;
+	Template.IP.SourceAddress = PeerIP;
+	Template.IP.DestAddress = StackIP;
+	Template.DataOffset = (TCP_HEADER_LEN / 4) << 4;
+
+	memset(SSLPeerSessions, 0, sizeof(SSLPeerSessions));
+	srand(1);
+
+	// HostRSAEncrypt() pads with RSA.c, which reads Random.c
+	RandomInit();
+	wPort = SSL_PEER_PORT;
+	bOK = TRUE;
+
+	for (vRound = 0; vRound < 3 && bOK; vRound++) {
+		// let the stack save its sessions, then have it restart SSL as
+		// a reset would, keeping only what it saved
+		if (vRound == 2) {
+			usleep(SSL_PEER_SAVE_WAIT * 1000u);
+			kill(getppid(), SIGUSR1);
+			usleep(SSL_PEER_RESTART_WAIT * 1000u);
+		}
+
+		dwHandshakes = 0;
+		dwResumed = 0;
+		dTotal = 0.0;
+		clock_gettime(CLOCK_MONOTONIC, &tStart);
+		for (i = 0; i < dwCount; i++) {
+			memset(&Conn, 0, sizeof(Conn));
+			Conn.pSession = &SSLPeerSessions[i % SSL_PEER_BROWSERS];
+			Conn.bResuming = (vRound > 0) && Conn.pSession->bValid;
+			dMilliseconds = 0.0;
+			if (!SSLPeerHandshake(iSocket, &Template, PeerIP, &Conn, wPort, &dMilliseconds)) {
+				bOK = FALSE;
+				break;
+			}
+			if (++wPort == 0)
+				wPort = SSL_PEER_PORT;
+			dwHandshakes++;
+			if (Conn.bResumed)
+				dwResumed++;
+			dTotal += dMilliseconds;
+		}
+		dSeconds = MicrosecondsSince(&tStart) / 1e6;
+
+		printf("PEER: %-9s %lu handshakes, %lu resumed, at %.1f/s (%.3f ms each)\n",
+			szRounds[vRound], (unsigned long)dwHandshakes, (unsigned long)dwResumed,
+			dSeconds > 0 ? dwHandshakes / dSeconds : 0.0,
+			dwHandshakes > 0 ? dTotal / dwHandshakes : 0.0);
+		// every session is resumed after the first round
+		if (vRound > 0 && dwResumed != dwHandshakes)
+			bOK = FALSE;
+	}
+	fflush(stdout);
+
+	close(iSocket);
+	return bOK;
+}
+#endif
@@ -0,0 +1,208 @@
+/*********************************************************************
+ *
+ *	Traffic generator for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostPeer.h
+ * Dependencies:    TCPIP.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_PEER_H
+#define __HOST_PEER_H
+
+#include "TCPIP Stack/TCPIP.h"
+
+// requests kept outstanding by HostPingPeer() and HostSynPeer()
+#define HOST_PEER_WINDOW		(4u)
+
+// how long the peers wait for a reply before counting the
+// outstanding requests as lost, in milliseconds
+#define HOST_PEER_TIMEOUT		(1000)
+
+// the pause between HostLatencyPeer()'s echo requests, in milliseconds,
+// long enough for the stack's task to go back to sleep
+#define HOST_PEER_LATENCY_GAP	(20)
+
+// what HostHTTPPeer() asks for
+typedef enum
+{
+	HTTP_PEER_POLL = 0u,	// status.xml, one request at a time
+	HTTP_PEER_PIPELINED,	// status.xml, HTTP_PEER_PIPELINE requests ahead
+	HTTP_PEER_PAGE,			// the pages' static files, revalidating the
+							// copies it already has
+	HTTP_PEER_WATCH,		// status.xml every HTTP_PEER_WATCH_PERIOD
+	HTTP_PEER_EVENTS		// the status.sse event stream
+} HTTP_PEER_MODE;
+
+/*********************************************************************
+ * Function:        BOOL HostPingPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N")
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses and the number of echo requests to send
+ *                  
+ * Output:          TRUE if every request was answered
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        Pings the stack as fast as it answers, keeping
+ *					HOST_PEER_WINDOW requests outstanding, and prints
+ *					the rate achieved.  Runs in a child process.
+ *
+ * Note:            
+ ********************************************************************/
+BOOL HostPingPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount);
+
+/*********************************************************************
+ * Function:        BOOL HostSynPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, WORD wStackPort,
+ *						DWORD dwCount)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N")
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses, the port to connect to and the number of
+ *					connections to request
+ *                  
+ * Output:          TRUE if every connection request was accepted
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        Sends SYNs to wStackPort, each from a new source
+ *					port, and resets each connection as soon as the
+ *					SYN+ACK arrives, keeping HOST_PEER_WINDOW requests
+ *					outstanding.  Every segment the stack receives has
+ *					to be matched to a socket, so this measures socket
+ *					lookup against the number of listening sockets.
+ *
+ * Note:            
+ ********************************************************************/
+BOOL HostSynPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, WORD wStackPort, DWORD dwCount);
+
+/*********************************************************************
+ * Function:        BOOL HostLatencyPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N")
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses and the number of echo requests to send
+ *                  
+ * Output:          TRUE if every request was answered
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        Sends one echo request at a time, HOST_PEER_LATENCY_GAP
+ *					apart so that each finds the stack idle, and prints
+ *					the minimum, mean and maximum round trip time.  This
+ *					measures how quickly the stack's task wakes for a
+ *					frame rather than how many it can handle.
+ *
+ * Note:            
+ ********************************************************************/
+BOOL HostLatencyPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount);
+
+/*********************************************************************
+ * Function:        BOOL HostEchoPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, WORD wPort,
+ *						DWORD dwCount)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N")
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses, the port it listens on and the number of
+ *					connections to serve
+ *                  
+ * Output:          TRUE if every connection was closed by the stack
+ *					rather than reset
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        A TCP echo server on wPort for the stack's client
+ *					sockets.  It answers ARP requests for PeerIP, sends
+ *					back whatever each connection receives and returns
+ *					once dwCount connections have been closed, or when
+ *					the stack falls silent.
+ *
+ * Note:            Enough TCP for a lossless link: data is accepted in
+ *					order only and resent from the oldest unacknowledged
+ *					byte when an acknowledgement is overdue
+ ********************************************************************/
+BOOL HostEchoPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, WORD wPort, DWORD dwCount);
+
+/*********************************************************************
+ * Function:        BOOL HostHTTPPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount,
+ *						HTTP_PEER_MODE vMode)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N")
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses, the number of requests to make and
+ *					what to request
+ *                  
+ * Output:          TRUE if every request was answered with 200 OK
+ *					or 304 Not Modified, or every event received
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        An HTTP client polling status.xml, or loading the
+ *					pages' static files as a browser revalidating its
+ *					cache, over MAX_HTTP_CONNECTIONS connections at
+ *					once.  Each connection is used for as many requests
+ *					as the stack allows, one at a time or up to
+ *					HTTP_PEER_PIPELINE ahead, and opened again when the
+ *					stack closes it.  Watching the meter as a web page
+ *					does, by polling status.xml or receiving dwCount
+ *					events from status.sse, uses one connection.  Responses may be
+ *					framed by Content-Length, chunks or the end of the
+ *					connection.  Prints the requests answered per
+ *					second.
+ *
+ * Note:            Requests still unanswered when a connection closes
+ *					are sent again on the next one
+ ********************************************************************/
+BOOL HostHTTPPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount, HTTP_PEER_MODE vMode);
+
+#if defined(STACK_USE_SSL_SERVER)
+/*********************************************************************
+ * Function:        BOOL HostSSLPeer(int iSocket, MAC_ADDR* pStackMAC,
+ *						IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount)
+ *
+ * PreCondition:    iSocket is the far end of the socket the stack was
+ *					given with MACHostOpen("fd:N"), and the parent
+ *					process runs the stack
+ *
+ * Input:           the socket, the stack's addresses, the address the
+ *					peer uses and the number of handshakes each round
+ *                  
+ * Output:          TRUE if every handshake completed and every one
+ *					after the first round resumed a session
+ *
+ * Side Effects:    Closes iSocket, which ends the stack's run
+ *
+ * Overview:        An SSL 3.0 client handshaking with the HTTPS port
+ *					as MAX_SSL_SESSIONS browsers in turn, one
+ *					connection at a time.  The first round makes
+ *					dwCount full handshakes, the second offers each
+ *					browser's session back, and the third does so
+ *					again after the stack has had time to save its
+ *					sessions and been sent SIGUSR1 to restart SSL.
+ *					Prints the handshakes per second of each round.
+ *
+ * Note:            The premaster secret is encrypted with
+ *					HostRSAEncrypt(), so the stack must use HostRSA.c's
+ *					key
+ ********************************************************************/
+BOOL HostSSLPeer(int iSocket, MAC_ADDR* pStackMAC, IP_ADDR StackIP, IP_ADDR PeerIP, DWORD dwCount);
+#endif
+
+#endif //__HOST_PEER_H
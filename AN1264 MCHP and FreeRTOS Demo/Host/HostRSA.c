@@ -0,0 +1,494 @@
+/*****************************************************************************
+ *
+ * RSA benchmark for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostRSA.c
+ * Dependencies:    RSA.c, BigInt.c, HostBigInt.c
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Holds test keys of 512 and 1024 bits, with a self-signed certificate
+ * for each, in place of the board's CustomSSLCert.c, and times the SSL
+ * server's RSA decryption on them.
+ * The keys were generated for this test only: e = 65537, and the CRT
+ * values are little-endian as RSA.c reads them.
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "TCPIP Stack/TCPIP.h"
+#include "HostRSA.h"
+
+#define HOST_RSA_BYTES		(SSL_RSA_KEY_SIZE/8)
+#define HOST_RSA_WORDS		(SSL_RSA_KEY_SIZE/BIGINT_DATA_SIZE)
+
+// The private key's CRT values, the modulus, the private exponent for the
+// plain exponentiation, a PKCS #1 block holding a premaster secret with
+// its encryption, both big-endian as on the wire, and the certificate the
+// SSL server sends
+#if SSL_RSA_KEY_SIZE == 512u
+ROM BYTE SSL_P[32] = {
+	0x11, 0x61, 0xE0, 0x77, 0xD1, 0xE0, 0xB1, 0x79, 0x24, 0x8F, 0x98, 0xEF,
+	0x2C, 0xFF, 0x8E, 0x62, 0xB9, 0xDC, 0x0F, 0x52, 0x04, 0x8C, 0x72, 0xC4,
+	0xFE, 0x8B, 0x33, 0x53, 0x54, 0xB5, 0x84, 0xDB
+};
+ROM BYTE SSL_Q[32] = {
+	0x7F, 0x9B, 0xBC, 0x7E, 0xE3, 0x58, 0x5B, 0xE6, 0x88, 0xC5, 0x62, 0xF8,
+	0xDC, 0xA8, 0x11, 0x61, 0xD3, 0x29, 0x81, 0xC4, 0x6E, 0xBA, 0x04, 0x2A,
+	0xBB, 0xDC, 0x99, 0x3D, 0xCC, 0x4D, 0xE0, 0xCE
+};
+ROM BYTE SSL_dP[32] = {
+	0xD1, 0xEA, 0xA3, 0xAD, 0x82, 0x6A, 0x92, 0xCA, 0xF4, 0x42, 0x0F, 0xCB,
+	0x39, 0xF9, 0x70, 0x49, 0xC4, 0x81, 0x94, 0x54, 0xB9, 0xA0, 0x85, 0x3E,
+	0x1E, 0x72, 0xB8, 0x1B, 0xBA, 0x24, 0x40, 0xD0
+};
+ROM BYTE SSL_dQ[32] = {
+	0x75, 0x80, 0x13, 0xEE, 0x7C, 0xE6, 0xA0, 0x79, 0xC8, 0x0E, 0x89, 0x04,
+	0x05, 0x5E, 0x8F, 0x24, 0x88, 0xA2, 0x06, 0xB0, 0x0C, 0x8A, 0xEA, 0x59,
+	0x99, 0x0C, 0x90, 0xED, 0x90, 0x0F, 0x46, 0x69
+};
+ROM BYTE SSL_qInv[32] = {
+	0x02, 0x3F, 0x7E, 0x0F, 0xB8, 0xB2, 0x10, 0x3B, 0x48, 0x0D, 0x2B, 0x0C,
+	0xDD, 0xE3, 0x75, 0x62, 0xC2, 0xD0, 0x0E, 0xE9, 0xD3, 0xF3, 0xF6, 0x8F,
+	0x1F, 0x6F, 0x6E, 0x58, 0x18, 0x81, 0x6E, 0xAE
+};
+ROM BYTE SSL_N[64] = {
+	0xB1, 0x65, 0x20, 0xBE, 0x91, 0xD9, 0xB2, 0xC6, 0x50, 0x35, 0x02, 0xF4,
+	0x82, 0x7B, 0xA6, 0x63, 0xC1, 0x9C, 0xAB, 0xDA, 0x2E, 0xB4, 0x57, 0xA0,
+	0x10, 0x3A, 0xDD, 0x4B, 0x29, 0x96, 0x61, 0x91, 0x00, 0xF2, 0x74, 0xE1,
+	0x25, 0x57, 0x69, 0x1C, 0x40, 0xEC, 0x4A, 0x87, 0x60, 0xBF, 0xD8, 0x93,
+	0x35, 0x9F, 0xD5, 0x4E, 0x72, 0x9C, 0x39, 0x01, 0x79, 0x90, 0xBE, 0x1F,
+	0xF9, 0x91, 0x72, 0x6F
+};
+static ROM BYTE vD[64] = {
+	0xE1, 0xC0, 0x30, 0xF0, 0x73, 0xFA, 0xDA, 0x96, 0x3D, 0x44, 0x12, 0x51,
+	0x6A, 0x08, 0xD3, 0x86, 0xD6, 0x92, 0xB0, 0xFE, 0x70, 0xDB, 0xC1, 0x89,
+	0xE2, 0xDD, 0x8A, 0xE6, 0x35, 0x8F, 0xDD, 0x32, 0x75, 0xED, 0x52, 0x34,
+	0xF7, 0xF2, 0x0A, 0x8C, 0x59, 0x2A, 0xCF, 0x2E, 0xB9, 0x48, 0x0A, 0x87,
+	0x0D, 0xAE, 0xCA, 0x07, 0xF9, 0xB3, 0x05, 0x14, 0xBA, 0xA7, 0xAD, 0x3C,
+	0x79, 0x8B, 0x7A, 0x96
+};
+static ROM BYTE vCipher[64] = {
+	0x66, 0xA7, 0x83, 0xB4, 0x86, 0xB4, 0x01, 0x6C, 0x39, 0x88, 0xD9, 0xBE,
+	0xDC, 0x9F, 0x8C, 0xD4, 0x43, 0xF6, 0x1B, 0x2C, 0x30, 0x3D, 0x07, 0x5D,
+	0x40, 0xC1, 0xA4, 0xF6, 0xCA, 0xC4, 0x18, 0xA5, 0x2A, 0x4C, 0x54, 0x6A,
+	0x9D, 0x8C, 0xCB, 0x52, 0xD5, 0x17, 0x29, 0x3A, 0xDB, 0x29, 0x54, 0x40,
+	0x80, 0x3D, 0x2C, 0x71, 0x3D, 0xD7, 0xF9, 0x20, 0xF0, 0x87, 0x11, 0xBA,
+	0x9E, 0x33, 0x1B, 0xF7
+};
+static ROM BYTE vPlain[64] = {
+	0x00, 0x02, 0x75, 0xB2, 0x52, 0x83, 0xF9, 0x96, 0x23, 0x47, 0x60, 0x80,
+	0xD3, 0xCA, 0x58, 0x00, 0x03, 0x00, 0x5F, 0x88, 0x5E, 0x24, 0xED, 0xA2,
+	0xA2, 0x09, 0x9A, 0x27, 0x38, 0x7B, 0xC1, 0x58, 0xAC, 0x6B, 0x46, 0xC2,
+	0x18, 0x0F, 0xB1, 0xBD, 0x1E, 0x3D, 0xAE, 0xF6, 0x31, 0xB8, 0xD4, 0xC4,
+	0xD7, 0x1B, 0x71, 0x5E, 0x56, 0xEE, 0xBD, 0x53, 0x0A, 0xD9, 0xC9, 0x30,
+	0xC7, 0xFB, 0xFC, 0xEE
+};
+ROM BYTE SSL_CERT[440] = {
+	0x30, 0x82, 0x01, 0xB4, 0x30, 0x82, 0x01, 0x5E, 0xA0, 0x03, 0x02, 0x01,
+	0x02, 0x02, 0x01, 0x01, 0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86,
+	0xF7, 0x0D, 0x01, 0x01, 0x05, 0x05, 0x00, 0x30, 0x38, 0x31, 0x22, 0x30,
+	0x20, 0x06, 0x03, 0x55, 0x04, 0x0A, 0x0C, 0x19, 0x4D, 0x69, 0x63, 0x72,
+	0x6F, 0x63, 0x68, 0x69, 0x70, 0x20, 0x54, 0x65, 0x63, 0x68, 0x6E, 0x6F,
+	0x6C, 0x6F, 0x67, 0x79, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x31, 0x12, 0x30,
+	0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0C, 0x09, 0x6D, 0x63, 0x68, 0x70,
+	0x62, 0x6F, 0x61, 0x72, 0x64, 0x30, 0x1E, 0x17, 0x0D, 0x32, 0x36, 0x31,
+	0x30, 0x31, 0x37, 0x31, 0x38, 0x33, 0x33, 0x34, 0x33, 0x5A, 0x17, 0x0D,
+	0x34, 0x36, 0x31, 0x30, 0x31, 0x32, 0x31, 0x38, 0x33, 0x33, 0x34, 0x33,
+	0x5A, 0x30, 0x38, 0x31, 0x22, 0x30, 0x20, 0x06, 0x03, 0x55, 0x04, 0x0A,
+	0x0C, 0x19, 0x4D, 0x69, 0x63, 0x72, 0x6F, 0x63, 0x68, 0x69, 0x70, 0x20,
+	0x54, 0x65, 0x63, 0x68, 0x6E, 0x6F, 0x6C, 0x6F, 0x67, 0x79, 0x20, 0x49,
+	0x6E, 0x63, 0x2E, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0C, 0x09, 0x6D, 0x63, 0x68, 0x70, 0x62, 0x6F, 0x61, 0x72, 0x64, 0x30,
+	0x5C, 0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01,
+	0x01, 0x01, 0x05, 0x00, 0x03, 0x4B, 0x00, 0x30, 0x48, 0x02, 0x41, 0x00,
+	0xB1, 0x65, 0x20, 0xBE, 0x91, 0xD9, 0xB2, 0xC6, 0x50, 0x35, 0x02, 0xF4,
+	0x82, 0x7B, 0xA6, 0x63, 0xC1, 0x9C, 0xAB, 0xDA, 0x2E, 0xB4, 0x57, 0xA0,
+	0x10, 0x3A, 0xDD, 0x4B, 0x29, 0x96, 0x61, 0x91, 0x00, 0xF2, 0x74, 0xE1,
+	0x25, 0x57, 0x69, 0x1C, 0x40, 0xEC, 0x4A, 0x87, 0x60, 0xBF, 0xD8, 0x93,
+	0x35, 0x9F, 0xD5, 0x4E, 0x72, 0x9C, 0x39, 0x01, 0x79, 0x90, 0xBE, 0x1F,
+	0xF9, 0x91, 0x72, 0x6F, 0x02, 0x03, 0x01, 0x00, 0x01, 0xA3, 0x53, 0x30,
+	0x51, 0x30, 0x1D, 0x06, 0x03, 0x55, 0x1D, 0x0E, 0x04, 0x16, 0x04, 0x14,
+	0xC8, 0xBF, 0xDD, 0xC2, 0x80, 0xF9, 0xCF, 0x8A, 0x0B, 0x95, 0x7F, 0xE9,
+	0xCA, 0x40, 0xC4, 0xC3, 0x13, 0xAA, 0x8C, 0x06, 0x30, 0x1F, 0x06, 0x03,
+	0x55, 0x1D, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0xC8, 0xBF, 0xDD,
+	0xC2, 0x80, 0xF9, 0xCF, 0x8A, 0x0B, 0x95, 0x7F, 0xE9, 0xCA, 0x40, 0xC4,
+	0xC3, 0x13, 0xAA, 0x8C, 0x06, 0x30, 0x0F, 0x06, 0x03, 0x55, 0x1D, 0x13,
+	0x01, 0x01, 0xFF, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xFF, 0x30, 0x0D,
+	0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x05, 0x05,
+	0x00, 0x03, 0x41, 0x00, 0xAA, 0x32, 0x48, 0xE2, 0x49, 0x94, 0xE7, 0x1C,
+	0xE6, 0x58, 0xF5, 0xBF, 0x4E, 0x79, 0xED, 0x06, 0x57, 0x8E, 0xEE, 0xD8,
+	0x9E, 0x49, 0x34, 0x30, 0x42, 0x46, 0x9C, 0x6F, 0xE0, 0x0A, 0x59, 0x2E,
+	0x96, 0x4A, 0x1F, 0xA7, 0x0B, 0x02, 0x71, 0xCD, 0x9F, 0xAC, 0xAE, 0x0B,
+	0xF0, 0x81, 0x5F, 0x93, 0x55, 0x7F, 0xE8, 0x08, 0x43, 0x4D, 0xF1, 0xE7,
+	0xD2, 0x38, 0xEE, 0x5F, 0xAE, 0x5F, 0x84, 0xDB
+};
+#elif SSL_RSA_KEY_SIZE == 1024u
+ROM BYTE SSL_P[64] = {
+	0x91, 0x78, 0x2F, 0x27, 0x52, 0xEF, 0xA6, 0xF0, 0xB2, 0xD8, 0x67, 0x46,
+	0x6A, 0x45, 0xC8, 0x6C, 0x93, 0x1F, 0xF6, 0xAD, 0x39, 0x9C, 0xA7, 0xF7,
+	0x77, 0x7F, 0x93, 0x05, 0x30, 0x59, 0x82, 0xD8, 0x0A, 0xBB, 0xBE, 0xBA,
+	0xDD, 0xCE, 0x6D, 0xCA, 0xFF, 0x2A, 0xB1, 0xAE, 0x6A, 0x10, 0xC5, 0x8D,
+	0xF7, 0xAE, 0x8C, 0xAD, 0x53, 0x0F, 0x66, 0xE2, 0x93, 0x58, 0x18, 0x1D,
+	0xC6, 0x00, 0x9A, 0xF1
+};
+ROM BYTE SSL_Q[64] = {
+	0x41, 0xAB, 0x7F, 0xE0, 0x4D, 0x87, 0x63, 0xC6, 0x57, 0xF7, 0x17, 0x66,
+	0x83, 0xDB, 0x3E, 0x5E, 0x28, 0x7A, 0xDF, 0x71, 0x1D, 0x8B, 0x22, 0x96,
+	0x4D, 0x17, 0x1A, 0xEC, 0x67, 0xC3, 0x8C, 0xC2, 0x85, 0xEC, 0x51, 0x47,
+	0xB8, 0x57, 0x34, 0xFB, 0xF5, 0x56, 0x15, 0xF4, 0x3E, 0x64, 0x2A, 0x4B,
+	0x38, 0xD2, 0xFA, 0x36, 0x54, 0xE5, 0x5A, 0x81, 0x61, 0x80, 0xCC, 0xF5,
+	0x6A, 0xF3, 0xD7, 0xCA
+};
+ROM BYTE SSL_dP[64] = {
+	0xB1, 0x41, 0x07, 0x8D, 0x00, 0xFC, 0xCD, 0x72, 0x3B, 0x87, 0xD2, 0x47,
+	0x0A, 0x01, 0x1D, 0x2A, 0x23, 0x5A, 0x96, 0x9A, 0xF3, 0x6D, 0x5C, 0x23,
+	0x37, 0x08, 0x54, 0x3D, 0xCC, 0x9A, 0xB7, 0x9A, 0x97, 0xF6, 0xB5, 0x4F,
+	0x36, 0x91, 0xDD, 0xAA, 0x4A, 0x2A, 0x79, 0xDE, 0xBC, 0xA0, 0x81, 0xCD,
+	0xE9, 0xD5, 0xEB, 0xD3, 0x95, 0x54, 0x27, 0xD8, 0x5A, 0x37, 0x6B, 0x8C,
+	0xB6, 0x96, 0xB9, 0xC5
+};
+ROM BYTE SSL_dQ[64] = {
+	0x41, 0x00, 0x2B, 0xC6, 0xB8, 0x3D, 0xF5, 0x23, 0xCC, 0x35, 0x2B, 0xFF,
+	0xDC, 0xFE, 0x43, 0x48, 0x88, 0x58, 0x3B, 0x37, 0x2F, 0x30, 0x15, 0x75,
+	0x21, 0x38, 0xBF, 0x75, 0xEF, 0xC5, 0xED, 0x79, 0x7A, 0x33, 0x3E, 0xAB,
+	0x71, 0xBF, 0xB1, 0xC0, 0x5D, 0x9C, 0xE5, 0xC0, 0x02, 0x71, 0x32, 0x72,
+	0xFD, 0x2E, 0x7A, 0x12, 0x42, 0xD3, 0x05, 0x18, 0x46, 0x1E, 0xFB, 0xA6,
+	0x2D, 0x19, 0x7F, 0x69
+};
+ROM BYTE SSL_qInv[64] = {
+	0x01, 0x48, 0x81, 0x00, 0x9C, 0x26, 0xD6, 0xC2, 0xFB, 0xFB, 0x72, 0xF7,
+	0x7B, 0x0D, 0xED, 0xDD, 0xFF, 0xEE, 0x17, 0x26, 0x6F, 0xF5, 0xFE, 0xF4,
+	0x25, 0x8A, 0xDA, 0xED, 0xFC, 0x08, 0x85, 0x01, 0xC8, 0x9F, 0x01, 0xAA,
+	0x87, 0x35, 0x5B, 0x63, 0x58, 0xE6, 0xC1, 0xA8, 0x93, 0x5C, 0x16, 0x6C,
+	0x32, 0x8B, 0x4E, 0x91, 0x70, 0x5C, 0xF8, 0x55, 0x6D, 0xCD, 0x70, 0xD7,
+	0xE9, 0x2D, 0x83, 0x5A
+};
+ROM BYTE SSL_N[128] = {
+	0xBF, 0x6F, 0x52, 0xAD, 0x19, 0xD1, 0x67, 0x9C, 0x7A, 0x89, 0xF1, 0xB1,
+	0x2C, 0x7A, 0x4C, 0x01, 0xC7, 0x61, 0x4D, 0xFB, 0x13, 0x91, 0xB7, 0x2C,
+	0xFA, 0xF6, 0x47, 0x49, 0xFC, 0xB6, 0xFF, 0x3E, 0x71, 0x6C, 0x37, 0x35,
+	0x59, 0xB3, 0x9B, 0x4D, 0x0D, 0xFA, 0x05, 0x4E, 0x12, 0xA2, 0x97, 0xE4,
+	0x17, 0x48, 0x6E, 0x0C, 0x4C, 0x28, 0xB0, 0xBB, 0xF1, 0x0A, 0x70, 0x14,
+	0x88, 0x26, 0x31, 0xDF, 0x06, 0x89, 0x15, 0x36, 0x1D, 0xA3, 0xFE, 0xF0,
+	0x84, 0xFC, 0x11, 0x25, 0xF6, 0x5D, 0x0A, 0xBA, 0x9E, 0x8D, 0x13, 0x9E,
+	0x51, 0xA0, 0xF6, 0xB1, 0xFF, 0x89, 0xF4, 0x6D, 0xDD, 0x54, 0xC4, 0x3D,
+	0x11, 0x54, 0x5D, 0xBC, 0x13, 0xC5, 0xB3, 0x4F, 0x12, 0x85, 0x75, 0x63,
+	0x59, 0x42, 0x32, 0x62, 0x26, 0x90, 0xE5, 0xC1, 0x8C, 0x70, 0x0D, 0xA9,
+	0xD0, 0x38, 0x58, 0xB1, 0x58, 0x85, 0x77, 0xD1
+};
+static ROM BYTE vD[128] = {
+	0x01, 0xA0, 0xE9, 0x51, 0x93, 0x3B, 0x49, 0x7F, 0xD9, 0x19, 0xF4, 0x8A,
+	0xE9, 0xD0, 0x4E, 0xE2, 0xC1, 0x2E, 0xC1, 0xF1, 0x8F, 0x8B, 0xFF, 0xB2,
+	0xB4, 0x02, 0x80, 0x20, 0x8F, 0x03, 0x34, 0xA2, 0x59, 0x15, 0x3E, 0x9F,
+	0x58, 0x5C, 0x96, 0x5E, 0x45, 0x74, 0x96, 0xC8, 0x15, 0x36, 0x80, 0x82,
+	0xD1, 0xB6, 0xAC, 0x31, 0xCC, 0x87, 0x7F, 0x96, 0x34, 0x2E, 0x08, 0x95,
+	0x0C, 0xE2, 0x82, 0x6B, 0xC5, 0x27, 0xB5, 0x61, 0xA2, 0xE2, 0x52, 0x8B,
+	0x43, 0x21, 0x32, 0xBF, 0xBB, 0xBF, 0xFC, 0x33, 0x24, 0x25, 0xFE, 0x68,
+	0x0C, 0x77, 0x38, 0x75, 0x63, 0x04, 0x92, 0x38, 0xCE, 0x16, 0x52, 0xC1,
+	0x60, 0x96, 0x46, 0x09, 0xC1, 0x8C, 0x11, 0x75, 0xE7, 0x21, 0x64, 0x00,
+	0x23, 0x03, 0x9B, 0x94, 0x95, 0xF2, 0xC4, 0xF3, 0x96, 0xD3, 0x7D, 0xDB,
+	0xED, 0xD3, 0x84, 0xF9, 0x1B, 0x7C, 0x79, 0x10
+};
+static ROM BYTE vCipher[128] = {
+	0x1F, 0x31, 0xB5, 0xE1, 0x04, 0xFB, 0x99, 0xD7, 0x13, 0xCF, 0x52, 0x23,
+	0x87, 0x21, 0x3A, 0x99, 0x43, 0x7B, 0x64, 0x3C, 0x10, 0xB7, 0x08, 0xFF,
+	0xC2, 0xF4, 0x56, 0xB5, 0x8C, 0xCC, 0x72, 0x17, 0xF9, 0xDF, 0x57, 0x52,
+	0xD8, 0x22, 0xD8, 0xF3, 0xEF, 0x02, 0x07, 0x81, 0x36, 0x81, 0x20, 0xCF,
+	0xD9, 0xC3, 0x61, 0x52, 0xA4, 0xA1, 0xF9, 0xA5, 0xD3, 0x4D, 0x7A, 0x01,
+	0x01, 0xFF, 0x86, 0xE8, 0xBC, 0x41, 0xEA, 0xF7, 0x61, 0xC8, 0x5B, 0xB8,
+	0xA0, 0x2B, 0x06, 0x24, 0x14, 0x7D, 0xFC, 0x62, 0x58, 0xDB, 0x7B, 0x9A,
+	0x9C, 0xD8, 0x0F, 0x63, 0xCD, 0xD2, 0x87, 0x85, 0xEF, 0xAC, 0x4E, 0xDF,
+	0x3B, 0x20, 0x1F, 0x80, 0x2B, 0x18, 0x68, 0xF9, 0x1D, 0x96, 0xAD, 0x55,
+	0x3B, 0xBD, 0x3C, 0x82, 0xA5, 0x81, 0x69, 0xE8, 0x0E, 0xA1, 0x15, 0x58,
+	0x3C, 0x17, 0x1A, 0x8A, 0x07, 0x15, 0xD8, 0x9D
+};
+static ROM BYTE vPlain[128] = {
+	0x00, 0x02, 0xB0, 0x16, 0xE2, 0x59, 0x05, 0xC1, 0xEE, 0x8C, 0x84, 0xE7,
+	0x1B, 0x24, 0xE2, 0xF2, 0x0A, 0xC6, 0x81, 0x9C, 0xC7, 0xF0, 0xFF, 0x19,
+	0x91, 0xDA, 0xB6, 0xD9, 0x13, 0xB7, 0x45, 0x3C, 0x5A, 0x67, 0x80, 0x2A,
+	0xAF, 0x3F, 0x9E, 0xE2, 0x19, 0x67, 0x09, 0xA5, 0x03, 0x6D, 0xFF, 0xCA,
+	0x6E, 0x61, 0xDA, 0x20, 0xE3, 0x5F, 0x6E, 0x85, 0xF6, 0x61, 0xAE, 0x52,
+	0xB6, 0xED, 0xF0, 0xB3, 0x74, 0xFF, 0x66, 0xFC, 0x39, 0x0F, 0xC1, 0x65,
+	0x61, 0x27, 0xD4, 0x5F, 0x2A, 0x41, 0x87, 0x00, 0x03, 0x00, 0x20, 0x2D,
+	0x02, 0x39, 0xE8, 0x8E, 0xED, 0xC4, 0x68, 0xA6, 0xF2, 0xDC, 0xFD, 0xBB,
+	0xFD, 0x3B, 0x8C, 0x0C, 0x9B, 0x64, 0x5B, 0xBB, 0xC0, 0x4B, 0x96, 0x72,
+	0xA9, 0x10, 0xEA, 0xF9, 0x75, 0xC7, 0x74, 0xC9, 0x77, 0x7D, 0xBA, 0x19,
+	0x8E, 0x69, 0xBF, 0xD9, 0x72, 0x7E, 0x68, 0x68
+};
+ROM BYTE SSL_CERT[573] = {
+	0x30, 0x82, 0x02, 0x39, 0x30, 0x82, 0x01, 0xA2, 0xA0, 0x03, 0x02, 0x01,
+	0x02, 0x02, 0x01, 0x01, 0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86,
+	0xF7, 0x0D, 0x01, 0x01, 0x0B, 0x05, 0x00, 0x30, 0x38, 0x31, 0x22, 0x30,
+	0x20, 0x06, 0x03, 0x55, 0x04, 0x0A, 0x0C, 0x19, 0x4D, 0x69, 0x63, 0x72,
+	0x6F, 0x63, 0x68, 0x69, 0x70, 0x20, 0x54, 0x65, 0x63, 0x68, 0x6E, 0x6F,
+	0x6C, 0x6F, 0x67, 0x79, 0x20, 0x49, 0x6E, 0x63, 0x2E, 0x31, 0x12, 0x30,
+	0x10, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0C, 0x09, 0x6D, 0x63, 0x68, 0x70,
+	0x62, 0x6F, 0x61, 0x72, 0x64, 0x30, 0x1E, 0x17, 0x0D, 0x32, 0x36, 0x31,
+	0x30, 0x31, 0x37, 0x31, 0x38, 0x33, 0x33, 0x34, 0x33, 0x5A, 0x17, 0x0D,
+	0x34, 0x36, 0x31, 0x30, 0x31, 0x32, 0x31, 0x38, 0x33, 0x33, 0x34, 0x33,
+	0x5A, 0x30, 0x38, 0x31, 0x22, 0x30, 0x20, 0x06, 0x03, 0x55, 0x04, 0x0A,
+	0x0C, 0x19, 0x4D, 0x69, 0x63, 0x72, 0x6F, 0x63, 0x68, 0x69, 0x70, 0x20,
+	0x54, 0x65, 0x63, 0x68, 0x6E, 0x6F, 0x6C, 0x6F, 0x67, 0x79, 0x20, 0x49,
+	0x6E, 0x63, 0x2E, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03, 0x55, 0x04, 0x03,
+	0x0C, 0x09, 0x6D, 0x63, 0x68, 0x70, 0x62, 0x6F, 0x61, 0x72, 0x64, 0x30,
+	0x81, 0x9F, 0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D,
+	0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x81, 0x8D, 0x00, 0x30, 0x81, 0x89,
+	0x02, 0x81, 0x81, 0x00, 0xBF, 0x6F, 0x52, 0xAD, 0x19, 0xD1, 0x67, 0x9C,
+	0x7A, 0x89, 0xF1, 0xB1, 0x2C, 0x7A, 0x4C, 0x01, 0xC7, 0x61, 0x4D, 0xFB,
+	0x13, 0x91, 0xB7, 0x2C, 0xFA, 0xF6, 0x47, 0x49, 0xFC, 0xB6, 0xFF, 0x3E,
+	0x71, 0x6C, 0x37, 0x35, 0x59, 0xB3, 0x9B, 0x4D, 0x0D, 0xFA, 0x05, 0x4E,
+	0x12, 0xA2, 0x97, 0xE4, 0x17, 0x48, 0x6E, 0x0C, 0x4C, 0x28, 0xB0, 0xBB,
+	0xF1, 0x0A, 0x70, 0x14, 0x88, 0x26, 0x31, 0xDF, 0x06, 0x89, 0x15, 0x36,
+	0x1D, 0xA3, 0xFE, 0xF0, 0x84, 0xFC, 0x11, 0x25, 0xF6, 0x5D, 0x0A, 0xBA,
+	0x9E, 0x8D, 0x13, 0x9E, 0x51, 0xA0, 0xF6, 0xB1, 0xFF, 0x89, 0xF4, 0x6D,
+	0xDD, 0x54, 0xC4, 0x3D, 0x11, 0x54, 0x5D, 0xBC, 0x13, 0xC5, 0xB3, 0x4F,
+	0x12, 0x85, 0x75, 0x63, 0x59, 0x42, 0x32, 0x62, 0x26, 0x90, 0xE5, 0xC1,
+	0x8C, 0x70, 0x0D, 0xA9, 0xD0, 0x38, 0x58, 0xB1, 0x58, 0x85, 0x77, 0xD1,
+	0x02, 0x03, 0x01, 0x00, 0x01, 0xA3, 0x53, 0x30, 0x51, 0x30, 0x1D, 0x06,
+	0x03, 0x55, 0x1D, 0x0E, 0x04, 0x16, 0x04, 0x14, 0xCC, 0x5F, 0x43, 0x54,
+	0x90, 0x0F, 0xCE, 0x3A, 0x32, 0xA8, 0xF7, 0xD9, 0x11, 0x27, 0xF4, 0x76,
+	0x98, 0x5C, 0xA3, 0x35, 0x30, 0x1F, 0x06, 0x03, 0x55, 0x1D, 0x23, 0x04,
+	0x18, 0x30, 0x16, 0x80, 0x14, 0xCC, 0x5F, 0x43, 0x54, 0x90, 0x0F, 0xCE,
+	0x3A, 0x32, 0xA8, 0xF7, 0xD9, 0x11, 0x27, 0xF4, 0x76, 0x98, 0x5C, 0xA3,
+	0x35, 0x30, 0x0F, 0x06, 0x03, 0x55, 0x1D, 0x13, 0x01, 0x01, 0xFF, 0x04,
+	0x05, 0x30, 0x03, 0x01, 0x01, 0xFF, 0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86,
+	0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x0B, 0x05, 0x00, 0x03, 0x81, 0x81,
+	0x00, 0x1C, 0x8E, 0x6A, 0xF8, 0x0B, 0xCA, 0xAE, 0x92, 0x4B, 0x04, 0xBA,
+	0xAC, 0xD6, 0xC9, 0xE1, 0x8F, 0x1C, 0x3A, 0x3F, 0xB2, 0xC4, 0xB6, 0x9C,
+	0x15, 0x72, 0xEF, 0x6A, 0xF0, 0x9F, 0x20, 0x74, 0x3E, 0xB1, 0x4D, 0xCB,
+	0xAF, 0x75, 0xC8, 0xE1, 0x7C, 0x85, 0x49, 0x74, 0x4B, 0xE5, 0xCA, 0xD4,
+	0xE5, 0xC4, 0x80, 0xA7, 0xC8, 0xC0, 0xBD, 0x84, 0x0D, 0x16, 0x2A, 0xA0,
+	0x6E, 0x02, 0x02, 0x7D, 0xFD, 0xE8, 0x0A, 0x9B, 0xA5, 0x3A, 0x83, 0xC0,
+	0x0B, 0x3B, 0xBB, 0x5D, 0x3E, 0x00, 0xE9, 0xB7, 0x37, 0x25, 0xF5, 0x7D,
+	0xE3, 0x58, 0x68, 0xB2, 0x64, 0x5F, 0x60, 0x7C, 0x17, 0x2B, 0xD3, 0x16,
+	0x60, 0xAA, 0x8E, 0x8C, 0x98, 0xA7, 0xF7, 0xA5, 0x68, 0xC5, 0xDD, 0xD4,
+	0x0A, 0xC6, 0x34, 0x33, 0x89, 0x22, 0x8F, 0x08, 0xF0, 0xDB, 0xDB, 0x93,
+	0x78, 0x2D, 0x95, 0x87, 0x02, 0xC9, 0x40, 0x5F, 0x2A
+};
+#else
+	#error The host build has test keys of 512 and 1024 bits
+#endif
+ROM WORD SSL_CERT_LEN = sizeof(SSL_CERT);
+
+static ROM BYTE vE[3] = {0x01, 0x00, 0x01};
+
+// the most RSAStep() calls timed in a decryption
+#define HOST_RSA_MAX_STEPS	(2048u)
+
+// the quickest time of each RSAStep() call over the timed decryptions,
+// which all do the same work, so that the longest is not the host's noise
+static double vStepTime[HOST_RSA_MAX_STEPS];
+
+static double HostSeconds(void);
+static BOOL HostDecrypt(BYTE* vData, DWORD* pdwSteps, BOOL bTimeSteps);
+static void HostPlainDecrypt(BYTE* vData);
+
+/************************************************************************
+* Function: BOOL HostRSABenchmark(DWORD dwRepeats)
+*                                                                       
+* Overview: check and time RSAStep() decryptions, then the plain 
+*           exponentiation
+*                                                                       
+* Input: how many times to decrypt
+*                                                                       
+* Output: TRUE if every result was correct
+*                                                                       
+************************************************************************/
+BOOL HostRSABenchmark(DWORD dwRepeats)
+{
+	BYTE vData[HOST_RSA_BYTES], vResult[HOST_RSA_BYTES];
+	BYTE vSecret[48];
+	DWORD i, dwSteps, dwOpSteps, dwPlain;
+	double dStart, dRSA, dPlain, dEncrypt, dLongest;
+	BOOL bOK;
+
+	if (dwRepeats == 0)
+		return FALSE;
+	RandomInit();
+	RSAInit();
+
+	// the known answer
+	memcpy(vData, vCipher, sizeof(vData));
+	bOK = HostDecrypt(vData, &dwOpSteps, FALSE) && memcmp(vData, vPlain, sizeof(vData)) == 0;
+	if (!bOK)
+		fprintf(stderr, "RSA: the known ciphertext decrypted wrongly\n");
+
+	// a premaster secret encrypted as SSL.c's client does, then decrypted
+	for (i = 0; i < sizeof(vSecret); i++)
+		vSecret[i] = RandomGet();
+	dStart = HostSeconds();
+	for (i = 0; i < dwRepeats; i++) {
+		if (!HostRSAEncrypt(vSecret, sizeof(vSecret), vResult))
+			return FALSE;
+	}
+	dEncrypt = HostSeconds() - dStart;
+	if (!HostDecrypt(vResult, &dwSteps, FALSE) || vResult[0] != 0x00u || vResult[1] != 0x02u ||
+		memcmp(&vResult[HOST_RSA_BYTES - sizeof(vSecret)], vSecret, sizeof(vSecret)) != 0) {
+		fprintf(stderr, "RSA: the encrypted premaster secret did not round trip\n");
+		bOK = FALSE;
+	}
+
+	// RSAStep() decryptions, as SSL.c's server runs them, then again with
+	// each step timed
+	dStart = HostSeconds();
+	for (i = 0; i < dwRepeats; i++) {
+		memcpy(vData, vCipher, sizeof(vData));
+		bOK &= HostDecrypt(vData, &dwSteps, FALSE);
+	}
+	dRSA = HostSeconds() - dStart;
+	bOK &= memcmp(vData, vPlain, sizeof(vData)) == 0;
+
+	for (i = 0; i < HOST_RSA_MAX_STEPS; i++)
+		vStepTime[i] = 1e9;
+	for (i = 0; i < dwRepeats; i++) {
+		memcpy(vData, vCipher, sizeof(vData));
+		bOK &= HostDecrypt(vData, &dwSteps, TRUE);
+	}
+	dLongest = 0.0;
+	for (i = 0; i < dwOpSteps && i < HOST_RSA_MAX_STEPS; i++) {
+		if (vStepTime[i] > dLongest)
+			dLongest = vStepTime[i];
+	}
+
+	// the plain exponentiation is slower, so fewer are timed
+	dwPlain = (dwRepeats + 7u) / 8u;
+	dStart = HostSeconds();
+	for (i = 0; i < dwPlain; i++) {
+		memcpy(vData, vCipher, sizeof(vData));
+		HostPlainDecrypt(vData);
+	}
+	dPlain = HostSeconds() - dStart;
+	if (memcmp(vData, vPlain, sizeof(vData)) != 0) {
+		fprintf(stderr, "RSA: the plain exponentiation decrypted wrongly\n");
+		bOK = FALSE;
+	}
+
+	printf("RSA: %u bit key, %lu decryptions at %.1f/s (%.3f ms each), %lu RSAStep() calls "
+		"each, the longest %.1f us\n",
+		(unsigned)SSL_RSA_KEY_SIZE, (unsigned long)dwRepeats, dwRepeats / dRSA, dRSA * 1e3 / dwRepeats,
+		(unsigned long)dwOpSteps, dLongest * 1e6);
+	printf("RSA: %lu plain square and multiply decryptions at %.1f/s (%.1fx slower), "
+		"%lu encryptions at %.1f/s\n",
+		(unsigned long)dwPlain, dwPlain / dPlain, (dPlain / dwPlain) / (dRSA / dwRepeats),
+		(unsigned long)dwRepeats, dwRepeats / dEncrypt);
+	return bOK;
+}
+
+/************************************************************************
+* Function: BOOL HostRSAEncrypt(BYTE* vData, WORD wLength, BYTE* vResult)
+*                                                                       
+* Overview: PKCS #1 encrypt vData to the test key's public half, as
+*           SSL.c's client encrypts a premaster secret
+*                                                                       
+* Input: the data, its length, and HOST_RSA_BYTES for the big-endian
+*        result
+*                                                                       
+* Output: FALSE if the RSA engine was busy
+*                                                                       
+************************************************************************/
+BOOL HostRSAEncrypt(BYTE* vData, WORD wLength, BYTE* vResult)
+{
+	BYTE vN[HOST_RSA_BYTES];
+
+	if (!RSABeginEncrypt(HOST_RSA_BYTES))
+		return FALSE;
+	memcpy(vN, SSL_N, sizeof(vN));
+	RSASetData(vData, wLength, RSA_BIG_ENDIAN);
+	RSASetN(vN, RSA_BIG_ENDIAN);
+	RSASetResult(vResult, RSA_BIG_ENDIAN);
+	RSASetE((BYTE*)vE, sizeof(vE), RSA_BIG_ENDIAN);
+	while (RSAStep() != RSA_DONE)
+		;
+	RSAEndUsage();
+	return TRUE;
+}
+
+// the monotonic clock in seconds
+static double HostSeconds(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+// decrypt vData in place through RSAStep(), counting the steps and 
+// keeping each one's quickest time in vStepTime if bTimeSteps; FALSE if
+// the CRT stages were not reported
+static BOOL HostDecrypt(BYTE* vData, DWORD* pdwSteps, BOOL bTimeSteps)
+{
+	RSA_STATUS Status;
+	BYTE bStages;
+	double dStep, dNow;
+
+	if (!RSABeginDecrypt())
+		return FALSE;
+	RSASetData(vData, HOST_RSA_BYTES, RSA_BIG_ENDIAN);
+
+	*pdwSteps = 0;
+	bStages = 0;
+	dStep = HostSeconds();
+	do {
+		Status = RSAStep();
+		if (bTimeSteps && *pdwSteps < HOST_RSA_MAX_STEPS) {
+			dNow = HostSeconds();
+			if (dNow - dStep < vStepTime[*pdwSteps])
+				vStepTime[*pdwSteps] = dNow - dStep;
+			dStep = dNow;
+		}
+		(*pdwSteps)++;
+		if (Status == RSA_FINISHED_M1 || Status == RSA_FINISHED_M2)
+			bStages++;
+	} while (Status != RSA_DONE);
+	RSAEndUsage();
+
+	return bStages == 2u;
+}
+
+// vData^d mod n, a bit at a time with BigIntSquare(), BigIntMultiply() 
+// and BigIntMod() over the whole modulus
+static void HostPlainDecrypt(BYTE* vData)
+{
+	BIGINT_DATA_TYPE vX[HOST_RSA_WORDS], vY[HOST_RSA_WORDS], vM[HOST_RSA_WORDS];
+	BIGINT_DATA_TYPE vWide[2*HOST_RSA_WORDS];
+	BIGINT X, Y, M, Wide;
+	BYTE* pD;
+	SHORT iBit;
+	BOOL bStarted;
+
+	memcpy(vM, SSL_N, sizeof(vM));
+	BigInt(&M, vM, HOST_RSA_WORDS);
+	BigIntSwapEndianness(&M);
+	memcpy(vX, vData, sizeof(vX));
+	BigInt(&X, vX, HOST_RSA_WORDS);
+	BigIntSwapEndianness(&X);
+	BigInt(&Y, vY, HOST_RSA_WORDS);
+	BigInt(&Wide, vWide, 2*HOST_RSA_WORDS);
+
+	pD = (BYTE*)vD;
+	bStarted = FALSE;
+	for (iBit = SSL_RSA_KEY_SIZE - 1; iBit >= 0; iBit--) {
+		if (bStarted) {
+			BigIntSquare(&Y, &Wide);
+			BigIntMod(&Wide, &M);
+			BigIntCopy(&Y, &Wide);
+		}
+		if (pD[iBit / 8] & (1u << (iBit % 8))) {
+			if (bStarted) {
+				BigIntMultiply(&Y, &X, &Wide);
+				BigIntMod(&Wide, &M);
+				BigIntCopy(&Y, &Wide);
+			}
+			else
+				BigIntCopy(&Y, &X);
+			bStarted = TRUE;
+		}
+	}
+
+	memcpy(vData, vY, sizeof(vY));
+	BigInt(&Y, (BIGINT_DATA_TYPE*)vData, HOST_RSA_WORDS);
+	BigIntSwapEndianness(&Y);
+}
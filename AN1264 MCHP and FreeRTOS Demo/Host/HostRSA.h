@@ -0,0 +1,46 @@
+/*********************************************************************
+ *
+ *	RSA benchmark for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostRSA.h
+ * Dependencies:    RSA.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_RSA_H
+#define __HOST_RSA_H
+
+/************************************************************************
+* Function: BOOL HostRSABenchmark(DWORD dwRepeats)
+*                                                                       
+* Overview: decrypt a known ciphertext with the SSL_RSA_KEY_SIZE test
+*           key, round trip a premaster secret through RSA encryption,
+*           then time dwRepeats decryptions through RSAStep() and print
+*           the operations per second, the steps each took and the
+*           longest step, beside those of a plain square and multiply
+*           with BigIntMod() and no CRT
+*                                                                       
+* Input: how many times to decrypt
+*                                                                       
+* Output: TRUE if every result was correct
+*                                                                       
+************************************************************************/
+BOOL HostRSABenchmark(DWORD dwRepeats);
+
+/************************************************************************
+* Function: BOOL HostRSAEncrypt(BYTE* vData, WORD wLength, BYTE* vResult)
+*                                                                       
+* Overview: PKCS #1 encrypt wLength bytes of vData to the public half of
+*           the SSL_RSA_KEY_SIZE test key, which the SSL server's
+*           certificate carries
+*                                                                       
+* Input: the data, its length, and SSL_RSA_KEY_SIZE/8 bytes for the
+*        big-endian result
+*                                                                       
+* Output: FALSE if the RSA engine was busy
+*                                                                       
+************************************************************************/
+BOOL HostRSAEncrypt(BYTE* vData, WORD wLength, BYTE* vResult);
+
+#endif //__HOST_RSA_H
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ *
+ * Random number generator benchmark for the Linux host build
+ *
+ *****************************************************************************
+ * FileName:        HostRandom.c
+ * Dependencies:    Random.c
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Times Random.c's pool and SHA-1 counter generator against the
+ * generator it replaced, which hashed two bytes into SHA-1 for every
+ * packet and calculated a SHA-1 hash sum for every 20 bytes of output.
+ * The counter generator also replaces its key once per read.
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "TCPIP Stack/TCPIP.h"
+#include "HostRandom.h"
+#include "HostTick.h"
+
+// random bytes read for the output rates and the byte counts
+#define HOST_RANDOM_BYTES	(1000000ul)
+
+// bytes per read, as SSL.c reads its randoms
+#define HOST_RANDOM_READ	(32u)
+
+// bytes per read for the bulk output rate
+#define HOST_RANDOM_BULK	(4096u)
+
+// chi-squared limit for the byte counts, six standard deviations above
+// the 255 expected
+#define HOST_RANDOM_CHI2	(390.0)
+
+static HASH_SUM OldHash;
+static BYTE vOldOutput[20];
+static BYTE bOldCount;
+
+static double HostSeconds(void);
+static void OldRandomAdd(BYTE data);
+static BYTE OldRandomGet(void);
+
+/************************************************************************
+* Function: BOOL HostRandomBenchmark(DWORD dwPackets)
+*                                                                       
+* Overview: time adding entropy per packet and reading random bytes,
+*           both ways, and count the output's byte values
+*                                                                       
+* Input: how many packets' entropy to add
+*                                                                       
+* Output: TRUE if the output's bytes were evenly spread
+*                                                                       
+************************************************************************/
+BOOL HostRandomBenchmark(DWORD dwPackets)
+{
+	static BYTE vOutput[HOST_RANDOM_BYTES];
+	DWORD dwCounts[256];
+	volatile DWORD dwTime;
+	DWORD i;
+	double dStart, dTick, dOldAdd, dAdd, dOldGet, dGet, dGetArray, dGetBulk, dChi2, dExpected;
+
+	if (dwPackets == 0)
+		return FALSE;
+
+	// both read the timer once per packet, which on the host is a
+	// clock_gettime() call costing more than the rest of the pool's
+	// work, so the adds are timed with TickGet() counting its calls
+	dStart = HostSeconds();
+	for (i = 0; i < dwPackets; i++)
+		dwTime = TickGet();
+	dTick = HostSeconds() - dStart;
+	HostTickCount(TRUE);
+
+	// a SHA-1 hash of two bytes per packet, as Random.c did
+	SHA1Initialize(&OldHash);
+	bOldCount = 20;
+	dStart = HostSeconds();
+	for (i = 0; i < dwPackets; i++)
+		OldRandomAdd((BYTE)i);
+	dOldAdd = HostSeconds() - dStart;
+
+	// the pool, with StackApplications() after every packet
+	RandomInit();
+	dStart = HostSeconds();
+	for (i = 0; i < dwPackets; i++) {
+		RandomAdd((BYTE)i);
+		RandomTask();
+	}
+	dAdd = HostSeconds() - dStart;
+	HostTickCount(FALSE);
+
+	// a byte at a time, as SSL.c read its randoms
+	dStart = HostSeconds();
+	for (i = 0; i < HOST_RANDOM_BYTES; i++)
+		vOutput[i] = OldRandomGet();
+	dOldGet = HostSeconds() - dStart;
+	dStart = HostSeconds();
+	for (i = 0; i < HOST_RANDOM_BYTES; i++)
+		vOutput[i] = RandomGet();
+	dGet = HostSeconds() - dStart;
+
+	// and in arrays, as SSL.c reads them now
+	dStart = HostSeconds();
+	for (i = 0; i + HOST_RANDOM_READ <= HOST_RANDOM_BYTES; i += HOST_RANDOM_READ)
+		RandomGetArray(&vOutput[i], HOST_RANDOM_READ);
+	dGetArray = HostSeconds() - dStart;
+
+	// and in bulk, where the key is replaced once per HOST_RANDOM_BULK bytes
+	dStart = HostSeconds();
+	for (i = 0; i + HOST_RANDOM_BULK <= HOST_RANDOM_BYTES; i += HOST_RANDOM_BULK)
+		RandomGetArray(&vOutput[i], HOST_RANDOM_BULK);
+	dGetBulk = HostSeconds() - dStart;
+
+	printf("RANDOM: %lu packets at %.1f ns each, %.1f ns with SHA-1 per packet, with TickGet() counting calls; "
+		"it takes %.1f ns on the host clock\n",
+		(unsigned long)dwPackets, dAdd * 1e9 / dwPackets, dOldAdd * 1e9 / dwPackets, dTick * 1e9 / dwPackets);
+	printf("RANDOM: %.1f MB/s in %u byte reads, %.1f MB/s in %u byte reads, %.1f MB/s a byte at a time, "
+		"%.1f MB/s from the former generator\n",
+		HOST_RANDOM_BYTES / dGetArray / 1e6, HOST_RANDOM_READ, i / dGetBulk / 1e6, HOST_RANDOM_BULK,
+		HOST_RANDOM_BYTES / dGet / 1e6, HOST_RANDOM_BYTES / dOldGet / 1e6);
+
+	// the byte values of the array reads should be evenly spread, the
+	// bulk reads having left the end from the 32 byte ones
+	memset(dwCounts, 0, sizeof(dwCounts));
+	for (i = 0; i < HOST_RANDOM_BYTES; i++)
+		dwCounts[vOutput[i]]++;
+	dExpected = HOST_RANDOM_BYTES / 256.0;
+	dChi2 = 0;
+	for (i = 0; i < 256u; i++)
+		dChi2 += (dwCounts[i] - dExpected) * (dwCounts[i] - dExpected) / dExpected;
+	if (dChi2 > HOST_RANDOM_CHI2) {
+		fprintf(stderr, "RANDOM: chi-squared of %.1f over the output's byte values\n", dChi2);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+// the monotonic clock in seconds
+static double HostSeconds(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+// Random.c's former RandomAdd(), which hashed the byte and a timer byte
+// and discarded any output left
+static void OldRandomAdd(BYTE data)
+{
+	DWORD dTemp;
+
+	SHA1AddData(&OldHash, &data, 1);
+	dTemp = TickGet();
+	SHA1AddData(&OldHash, (BYTE*)&dTemp, 1);
+
+	bOldCount = 20;
+}
+
+// Random.c's former RandomGet(), which calculated a hash sum for every
+// 20 bytes and added its first byte back
+static BYTE OldRandomGet(void)
+{
+	if (bOldCount >= 20u) {
+		SHA1Calculate(&OldHash, vOldOutput);
+		OldRandomAdd(vOldOutput[0]);
+		bOldCount = 0;
+	}
+
+	return vOldOutput[bOldCount++];
+}
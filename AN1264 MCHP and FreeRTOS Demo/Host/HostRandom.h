@@ -0,0 +1,29 @@
+/*********************************************************************
+ *
+ *	Random number generator benchmark for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostRandom.h
+ * Dependencies:    Random.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_RANDOM_H
+#define __HOST_RANDOM_H
+
+/************************************************************************
+* Function: BOOL HostRandomBenchmark(DWORD dwPackets)
+*                                                                       
+* Overview: time the entropy StackTask() and StackApplications() add
+*           for dwPackets received packets, and the random bytes SSL
+*           reads, against Random.c's former SHA-1 per packet path,
+*           then check the output's byte counts
+*                                                                       
+* Input: how many packets' entropy to add
+*                                                                       
+* Output: TRUE if the output's bytes were evenly spread
+*                                                                       
+************************************************************************/
+BOOL HostRandomBenchmark(DWORD dwPackets);
+
+#endif //__HOST_RANDOM_H
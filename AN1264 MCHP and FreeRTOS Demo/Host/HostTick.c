@@ -0,0 +1,117 @@
+/*********************************************************************
+ *
+ *	Tick counter for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostTick.c
+ * Dependencies:    TCPIP.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Replaces src\Tick.c.  The count is derived from the host's monotonic
+ * clock at the rate the PIC32 Timer 2/3 pair counts at, TICKS_PER_SECOND,
+ * so TCP retransmission and the other stack timeouts behave as on the
+ * board.
+ ********************************************************************/
+#include <time.h>
+
+#include "TCPIP Stack/TCPIP.h"
+#include "HostTick.h"
+
+// the host time TickInit() was called, in nanoseconds
+static unsigned long long ullStartTime;
+
+// while set by HostTickCount(), TickGet() returns dwTickCalls
+static BOOL bTickCount;
+static DWORD dwTickCalls;
+
+/*********************************************************************
+ * Function:        static unsigned long long GetTick48(void)
+ *
+ * PreCondition:    TickInit() called
+ *
+ * Input:           None
+ *                  
+ * Output:          48bit TICK value
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Return the ticks counted since TickInit(), as the
+ *					48 bits the hardware counter and wInternalTicks
+ *					form on the board
+ *
+ * Note:            
+ ********************************************************************/
+static unsigned long long GetTick48(void)
+{
+	struct timespec ts;
+	unsigned long long ullNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ullNow = (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+
+	return ((ullNow - ullStartTime) * TICKS_PER_SECOND / 1000000000ull) & 0xFFFFFFFFFFFFull;
+}
+
+/*********************************************************************
+ * Function:        void TickInit(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Start counting from zero
+ *
+ * Note:            
+ ********************************************************************/
+void TickInit(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ullStartTime = (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+void TickUpdate(void)
+{
+	// Nothing to do, the count is read from the host clock
+}
+
+void HostTickCount(BOOL bCount)
+{
+	bTickCount = bCount;
+}
+
+DWORD TickGet(void)
+{
+	if (bTickCount)
+		return dwTickCalls++;
+	return (DWORD)GetTick48();
+}
+
+DWORD TickGetDiv256(void)
+{
+	return (DWORD)(GetTick48() >> 8);
+}
+
+DWORD TickGetDiv64K(void)
+{
+	return (DWORD)(GetTick48() >> 16);
+}
+
+DWORD TickConvertToMilliseconds(DWORD dwTickValue)
+{
+	return (DWORD)(((unsigned long long)dwTickValue * 1000ull) / TICKS_PER_SECOND);
+}
+
+MIWITICK MiWiTickGet(void)
+{
+	MIWITICK res;
+
+	res.Val = (DWORD)GetTick48();
+	return res;
+}
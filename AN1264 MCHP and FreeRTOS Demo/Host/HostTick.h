@@ -0,0 +1,29 @@
+/*********************************************************************
+ *
+ *	Tick counter for the Linux host build
+ *
+ *********************************************************************
+ * FileName:        HostTick.h
+ * Dependencies:    Tick.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ ********************************************************************/
+#ifndef __HOST_TICK_H
+#define __HOST_TICK_H
+
+/************************************************************************
+* Function: void HostTickCount(BOOL bCount)
+*                                                                       
+* Overview: have TickGet() count its calls instead of reading the
+*           host clock, so a benchmark can time code that reads the
+*           tick without timing clock_gettime() as well.  The board
+*           reads a timer register, which costs next to nothing
+*                                                                       
+* Input: TRUE to count, FALSE to read the clock again
+*                                                                       
+* Output: None
+*                                                                       
+************************************************************************/
+void HostTickCount(BOOL bCount);
+
+#endif //__HOST_TICK_H
@@ -0,0 +1,892 @@
+/*********************************************************************
+ *
+ *	TCP/IP stack host build
+ *
+ *********************************************************************
+ * FileName:        main.c
+ * Dependencies:    TCPIP.h, FreeRTOS
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * Runs the demo's TCP/IP task - StackTask(), StackApplications(), the
+ * HTTP2 server with MeterHTTPApp.c and the MPFS2 web pages - on the
+ * GCC/Linux FreeRTOS port, with frames carried by HostMAC.c.  The
+ * graphics, touch screen, MiWi and UART tasks are left out; a meter
+ * task keeps the web pages' data up to date as on the board.
+ *
+ *	TCPIPHost [-t seconds] [-a a.b.c.d] [-d] [-f image] [-p ms] backend
+ *
+ *	-t	run time, 10 s by default or long enough for ssl:N's
+ *		handshakes; the run also ends when a pcap replay or the
+ *		peer finishes
+ *	-a	the stack's IP address instead of MY_DEFAULT_IP_ADDR
+ *	-d	enable the DHCP client
+ *	-f	the MPFS2 image, ../src/MPFSImg2.bin by default
+ *	-p	poll the MAC with this period, as the board does without a
+ *		MAC interrupt, instead of sleeping until a frame arrives
+ *
+ * The backend is any HostMAC.h backend, or "ping:N", "syn:N" or
+ * "rtt:N" to have a child process send N echo requests, N connection
+ * requests to the HTTP port or N spaced out echo requests for the
+ * round trip time over a socketpair.  "http:N" and "pipe:N" have it
+ * make N requests for status.xml, one at a time on each connection or
+ * pipelined, and "page:N" N conditional requests for the pages' static
+ * files, as a browser with them cached.  "watch:N" polls status.xml N
+ * times as the monitor page did and "events:N" waits for N events from
+ * status.sse as it does now.  "bsd:N" instead runs
+ * HOST_BSD_TASKS Berkeley client tasks which each exchange N messages
+ * with an echo server in the child process.  "open:N" opens the
+ * image's files by name N times and prints the opens per second,
+ * without starting the scheduler; "open:N:F" does so on a generated
+ * image of F files written over the loaded one.  "flash:N" saves the
+ * configuration and uploads the image N times, a byte at a time and
+ * then in words, and prints the time each would take on the board's
+ * flash, also without the scheduler.  "rsa:N" times N decryptions of
+ * an SSL premaster secret, the server's share of a handshake, with
+ * the SSL_RSA_KEY_SIZE test key in HostRSA.c, "hash:N" hashes N MB
+ * with MD5, SHA-1 and SHA-256 and prints the MB/s, and "random:N"
+ * times adding N packets' entropy to Random.c and reading random bytes
+ * back.  "ssl:N", in a build
+ * made with SSL=1, has the child make N full SSL handshakes with the
+ * HTTPS server, N resumed ones, then N more after SIGUSR1 has had the
+ * stack restart SSL from the sessions it saved.  At the end the
+ * frame counts, frames per second and host CPU time per frame are
+ * printed, followed by the CPU time of each task.
+ ********************************************************************/
+// the C library's sockets are used here, not the Berkeley API's
+#define HOST_LIBC_SOCKETS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "TCPIP Stack/TCPIP.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+// local includes
+#include "homeMeter.h"
+#include "HostFlash.h"
+#include "HostPeer.h"
+#include "HostBSD.h"
+#include "HostMPFS.h"
+#include "HostRSA.h"
+#include "HostHash.h"
+#include "HostRandom.h"
+
+///////////////////////////////////////////////////////////////////
+// Semaphores and queues shared with the application modules
+xSemaphoreHandle FLASHSemaphore;
+xSemaphoreHandle QVGASemaphore;
+xSemaphoreHandle METERSemaphore;
+xQueueHandle hMETERQueue;
+xTaskHandle hMETERTask;
+
+// global meter object
+structMeter gMeter;
+
+// Declare AppConfig structure to store information on the tcpip configuration
+APP_CONFIG AppConfig;
+
+///////////////////////////////////////////////////////////////////
+// Forward references in this module
+static void InitAppConfig(void);
+static void taskTCPIP(void* pvParameter);
+static void taskControl(void* pvParameter);
+static portTickType TCPIPGetSleepTime(void);
+static void MACInterruptHandler(void);
+static void TemperatureTimerCallback(xTimerHandle xTimer);
+static double Seconds(clockid_t clock);
+static void PrintResults(double dWall, double dCPU);
+static void SSLRestartHandler(int iSignal);
+
+///////////////////////////////////////////////////////////////////
+// local variables and constants
+
+// run time used when none is given, in seconds
+#define DEFAULT_RUN_TIME			10
+
+// run time added for each of ssl:N's 3N handshakes when none is given,
+// in milliseconds, several times what a full one takes on the host
+#define SSL_HANDSHAKE_RUN_TIME		250
+
+// the most tasks the run time statistics snapshot holds
+#define MAX_TASKS					16
+
+// period of the temperature update, as in MainDemo.c
+#define TEMPERATURE_UPDATE_RATE		(2000 / portTICK_RATE_MS)
+
+// how often the control task checks whether the run is over
+#define CONTROL_PERIOD				(10 / portTICK_RATE_MS)
+
+// longest the TCPIP task sleeps with no frame or TCP timer to wake it,
+// as in taskTCPIP.c
+#define TCPIP_IDLE_PERIOD			(250 / portTICK_RATE_MS)
+
+static long lRunTime = DEFAULT_RUN_TIME;
+static volatile BOOL bTrafficDone = FALSE;
+
+// set by SIGUSR1 for the TCPIP task to restart SSL as a reset would
+static volatile BOOL bSSLRestart = FALSE;
+static xTaskHandle hTCPIPTask;
+
+// the -p polling period, 0 to sleep until a frame arrives
+static portTickType xPollPeriod = 0;
+
+// messages for each Berkeley client task to exchange with "bsd:N",
+// 0 to run none, and the address of their echo server
+static DWORD dwBSDMessages = 0;
+static IP_ADDR BSDPeerIP;
+
+// the run time statistics, captured just before the scheduler is ended
+static xTaskRunTimeStatus xRunTimeStats[MAX_TASKS];
+static unsigned portBASE_TYPE uxRunTimeStatsCount = 0;
+static unsigned long long ullTotalRunTime = 0;
+
+/*********************************************************************
+ * Function:        int main(int argc, char* argv[])
+ *
+ * PreCondition:    None
+ *
+ * Input:           command line, see the top of this file
+ *
+ * Output:          EXIT_SUCCESS unless the backend could not be opened
+ *					or the ping peer lost replies
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Application main entry point
+ *
+ * Note:
+ ********************************************************************/
+int main(int argc, char* argv[])
+{
+	const char* szImage = "../src/MPFSImg2.bin";
+	const char* szBackend;
+	char szSpec[16];
+	struct in_addr Address;
+	IP_ADDR PeerIP;
+	xTimerHandle hTEMPTimer;
+	pid_t Peer = -1;
+	int iSockets[2];
+	int iStatus = EXIT_SUCCESS;
+	int iOption;
+	BOOL bRunTimeGiven = FALSE;
+	struct sigaction Restart;
+	BOOL bDHCP = FALSE;
+	BOOL bPeerOK;
+	double dWall, dCPU;
+
+	// default configuration, the same as the board's
+	InitAppConfig();
+
+	while ((iOption = getopt(argc, argv, "t:a:df:p:")) != -1) {
+		switch (iOption) {
+			case 't':
+				lRunTime = strtol(optarg, NULL, 10);
+				bRunTimeGiven = TRUE;
+				break;
+			case 'a':
+				if (inet_aton(optarg, &Address) == 0)
+					lRunTime = 0;
+				AppConfig.MyIPAddr.Val = Address.s_addr;
+				AppConfig.DefaultIPAddr.Val = Address.s_addr;
+				break;
+			case 'd':
+				bDHCP = TRUE;
+				break;
+			case 'f':
+				szImage = optarg;
+				break;
+			case 'p':
+				xPollPeriod = (portTickType)strtoul(optarg, NULL, 10) / portTICK_RATE_MS;
+				if (xPollPeriod == 0)
+					lRunTime = 0;
+				break;
+			default:
+				lRunTime = 0;
+				break;
+		}
+	}
+	if (lRunTime <= 0 || optind != argc - 1) {
+		fprintf(stderr, "usage: %s [-t seconds] [-a a.b.c.d] [-d] [-f image] [-p ms] "
+			"tap:NAME | fd:N | pcap:FILE | ping:N | syn:N | rtt:N | http:N | pipe:N | page:N | watch:N | events:N | bsd:N | ssl:N | open:N[:F] | flash:N | rsa:N | hash:N | random:N\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	szBackend = argv[optind];
+	if (!bRunTimeGiven && strncmp(szBackend, "ssl:", 4) == 0)
+		lRunTime += (long)(3ul * strtoul(szBackend + 4, NULL, 10) * SSL_HANDSHAKE_RUN_TIME / 1000ul);
+	AppConfig.Flags.bIsDHCPEnabled = bDHCP;
+	AppConfig.Flags.bInConfigMode = bDHCP;
+
+	// the web pages are read from the flash as on the board
+	if (!HostFlashLoad(szImage, MPFS_RESERVE_BLOCK)) {
+		perror(szImage);
+		return EXIT_FAILURE;
+	}
+
+	// the file open benchmark needs neither the stack nor the scheduler
+	if (strncmp(szBackend, "open:", 5) == 0) {
+		char* pEnd;
+		DWORD dwOpens;
+
+		dwOpens = strtoul(szBackend + 5, &pEnd, 10);
+		MPFSInit();
+		if (*pEnd == ':' && !HostMPFSBuild((WORD)strtoul(pEnd + 1, NULL, 10))) {
+			fprintf(stderr, "Could not write the MPFS2 image.\n");
+			return EXIT_FAILURE;
+		}
+		return HostMPFSBenchmark(dwOpens) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (strncmp(szBackend, "flash:", 6) == 0) {
+		MPFSInit();
+		return HostFlashBenchmark(strtoul(szBackend + 6, NULL, 10)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (strncmp(szBackend, "rsa:", 4) == 0)
+		return HostRSABenchmark(strtoul(szBackend + 4, NULL, 10)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	if (strncmp(szBackend, "hash:", 5) == 0)
+		return HostHashBenchmark(strtoul(szBackend + 5, NULL, 10)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	if (strncmp(szBackend, "random:", 7) == 0)
+		return HostRandomBenchmark(strtoul(szBackend + 7, NULL, 10)) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	#if defined(HOST_TCP_SOCKETS)
+	// the TCP sockets are all HTTP ones, none is left for the clients
+	if (strncmp(szBackend, "bsd:", 4) == 0) {
+		fprintf(stderr, "bsd:N needs a build without SOCKETS\n");
+		return EXIT_FAILURE;
+	}
+	#endif
+	#if !defined(STACK_USE_SSL_SERVER)
+	if (strncmp(szBackend, "ssl:", 4) == 0) {
+		fprintf(stderr, "ssl:N needs a build with SSL=1\n");
+		return EXIT_FAILURE;
+	}
+	#endif
+
+	// the SSL peer's SIGUSR1 must not end the process, and may come
+	// while a task is in a system call
+	memset(&Restart, 0, sizeof(Restart));
+	Restart.sa_handler = SSLRestartHandler;
+	Restart.sa_flags = SA_RESTART;
+	sigemptyset(&Restart.sa_mask);
+	sigaction(SIGUSR1, &Restart, NULL);
+
+	// a ping, SYN, latency, HTTP, echo or SSL peer runs in a child process on
+	// the far end of a socketpair, started before the scheduler owns the
+	// signals
+	if (strncmp(szBackend, "ping:", 5) == 0 || strncmp(szBackend, "syn:", 4) == 0 ||
+		strncmp(szBackend, "rtt:", 4) == 0 || strncmp(szBackend, "http:", 5) == 0 ||
+		strncmp(szBackend, "pipe:", 5) == 0 || strncmp(szBackend, "page:", 5) == 0 ||
+		strncmp(szBackend, "watch:", 6) == 0 || strncmp(szBackend, "events:", 7) == 0 ||
+		strncmp(szBackend, "bsd:", 4) == 0 || strncmp(szBackend, "ssl:", 4) == 0) {
+		if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, iSockets) != 0) {
+			perror("socketpair");
+			return EXIT_FAILURE;
+		}
+		PeerIP.Val = (AppConfig.MyIPAddr.Val & AppConfig.MyMask.Val) |
+			(~AppConfig.MyMask.Val & (AppConfig.MyIPAddr.Val ^ 0x01000000ul));
+		if (szBackend[0] == 'b') {
+			dwBSDMessages = strtoul(szBackend + 4, NULL, 10);
+			BSDPeerIP = PeerIP;
+		}
+
+		fflush(stdout);
+		Peer = fork();
+		if (Peer == 0) {
+			close(iSockets[0]);
+			if (szBackend[0] == 'h')
+				bPeerOK = HostHTTPPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 5, NULL, 10), HTTP_PEER_POLL);
+			else if (strncmp(szBackend, "pipe:", 5) == 0)
+				bPeerOK = HostHTTPPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 5, NULL, 10), HTTP_PEER_PIPELINED);
+			else if (strncmp(szBackend, "page:", 5) == 0)
+				bPeerOK = HostHTTPPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 5, NULL, 10), HTTP_PEER_PAGE);
+			else if (szBackend[0] == 'w')
+				bPeerOK = HostHTTPPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 6, NULL, 10), HTTP_PEER_WATCH);
+			else if (szBackend[0] == 'e')
+				bPeerOK = HostHTTPPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 7, NULL, 10), HTTP_PEER_EVENTS);
+			else if (szBackend[0] == 'p')
+				bPeerOK = HostPingPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 5, NULL, 10));
+			else if (szBackend[0] == 'r')
+				bPeerOK = HostLatencyPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 4, NULL, 10));
+			else if (szBackend[0] == 'b')
+				bPeerOK = HostEchoPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, HOST_BSD_PORT, HOST_BSD_TASKS);
+			#if defined(STACK_USE_SSL_SERVER)
+			else if (strncmp(szBackend, "ssl:", 4) == 0)
+				bPeerOK = HostSSLPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, strtoul(szBackend + 4, NULL, 10));
+			#endif
+			else
+				bPeerOK = HostSynPeer(iSockets[1], &AppConfig.MyMACAddr, AppConfig.MyIPAddr,
+					PeerIP, HTTP_PORT, strtoul(szBackend + 4, NULL, 10));
+			exit(bPeerOK ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+		close(iSockets[1]);
+		snprintf(szSpec, sizeof(szSpec), "fd:%d", iSockets[0]);
+		szBackend = szSpec;
+	}
+
+	if (!MACHostOpen(szBackend)) {
+		perror(szBackend);
+		return EXIT_FAILURE;
+	}
+
+	FLASHSemaphore = xSemaphoreCreateMutex();
+	QVGASemaphore = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(METERSemaphore);
+	hMETERQueue = xQueueCreate(METER_QUEUE_SIZE, sizeof(METER_MSG));
+	hTEMPTimer = xTimerCreate((signed char*) "TEMP", TEMPERATURE_UPDATE_RATE,
+		pdTRUE, NULL, TemperatureTimerCallback);
+	if (FLASHSemaphore == NULL || QVGASemaphore == NULL || METERSemaphore == NULL ||
+		hMETERQueue == NULL || hTEMPTimer == NULL) {
+		fprintf(stderr, "Could not create the queues, semaphores and timers.\n");
+		return EXIT_FAILURE;
+	}
+	xTimerStart(hTEMPTimer, 0);
+
+	xTaskCreate(taskMeter, (signed char*) "METER", STACK_SIZE_METER,
+		NULL, tskIDLE_PRIORITY + 1, &hMETERTask);
+	xTaskCreate(taskTCPIP, (signed char*) "TCPIP", configMINIMAL_STACK_SIZE,
+		NULL, tskIDLE_PRIORITY + 2, &hTCPIPTask);
+	xTaskCreate(taskControl, (signed char*) "CTRL", configMINIMAL_STACK_SIZE,
+		NULL, configMAX_PRIORITIES - 1, NULL);
+
+	// the scheduler takes SIGIO for the MAC interrupt while it runs;
+	// outside it frames arriving must not end the process
+	signal(SIGIO, SIG_IGN);
+	vPortSetIOInterruptHandler(MACInterruptHandler);
+
+	// returns once the control task has ended the scheduler
+	dWall = Seconds(CLOCK_MONOTONIC);
+	dCPU = Seconds(CLOCK_PROCESS_CPUTIME_ID);
+	vTaskStartScheduler();
+	dWall = Seconds(CLOCK_MONOTONIC) - dWall;
+	dCPU = Seconds(CLOCK_PROCESS_CPUTIME_ID) - dCPU;
+
+	if (Peer > 0) {
+		// the peer has finished if the run ended early
+		if (!bTrafficDone)
+			MACHostClose();
+		if (waitpid(Peer, &iStatus, 0) != Peer || !WIFEXITED(iStatus) ||
+			WEXITSTATUS(iStatus) != 0)
+			iStatus = EXIT_FAILURE;
+	}
+
+	PrintResults(dWall, dCPU);
+	if (dwBSDMessages != 0 && !HostBSDPrintResults())
+		iStatus = EXIT_FAILURE;
+	MACHostClose();
+	return iStatus;
+}
+
+/*********************************************************************
+ * Function:        static void InitAppConfig(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Initialize the TCPIP data structures with the
+ *					defaults from TCPIPConfig.h.  Unlike the board
+ *					nothing is read from or saved to the flash.
+ *
+ * Note:
+ ********************************************************************/
+static ROM BYTE SerializedMACAddress[6] = {
+	MY_DEFAULT_MAC_BYTE1, MY_DEFAULT_MAC_BYTE2,
+	MY_DEFAULT_MAC_BYTE3, MY_DEFAULT_MAC_BYTE4,
+	MY_DEFAULT_MAC_BYTE5, MY_DEFAULT_MAC_BYTE6
+};
+
+static void InitAppConfig(void)
+{
+	memset((void*)&AppConfig, 0x00, sizeof(AppConfig));
+	memcpypgm2ram((void*)&AppConfig.MyMACAddr, (ROM void*) SerializedMACAddress,
+		sizeof(AppConfig.MyMACAddr));
+
+	AppConfig.MyIPAddr.Val = 	MY_DEFAULT_IP_ADDR_BYTE1 |
+								MY_DEFAULT_IP_ADDR_BYTE2 << 8ul |
+								MY_DEFAULT_IP_ADDR_BYTE3 << 16ul |
+								MY_DEFAULT_IP_ADDR_BYTE4 << 24ul;
+	AppConfig.DefaultIPAddr.Val = AppConfig.MyIPAddr.Val;
+	AppConfig.MyMask.Val = 		MY_DEFAULT_MASK_BYTE1 |
+								MY_DEFAULT_MASK_BYTE2 << 8ul |
+								MY_DEFAULT_MASK_BYTE3 << 16ul |
+								MY_DEFAULT_MASK_BYTE4 << 24ul;
+	AppConfig.DefaultMask.Val = AppConfig.MyMask.Val;
+	AppConfig.MyGateway.Val = 	MY_DEFAULT_GATE_BYTE1 |
+								MY_DEFAULT_GATE_BYTE2 << 8ul |
+								MY_DEFAULT_GATE_BYTE3 << 16ul |
+								MY_DEFAULT_GATE_BYTE4 << 24ul;
+	AppConfig.PrimaryDNSServer.Val = 	MY_DEFAULT_PRIMARY_DNS_BYTE1 |
+										MY_DEFAULT_PRIMARY_DNS_BYTE2 << 8ul  |
+										MY_DEFAULT_PRIMARY_DNS_BYTE3 << 16ul  |
+										MY_DEFAULT_PRIMARY_DNS_BYTE4 << 24ul;
+	AppConfig.SecondaryDNSServer.Val = 	MY_DEFAULT_SECONDARY_DNS_BYTE1 |
+										MY_DEFAULT_SECONDARY_DNS_BYTE2 << 8ul  |
+										MY_DEFAULT_SECONDARY_DNS_BYTE3 << 16ul  |
+										MY_DEFAULT_SECONDARY_DNS_BYTE4 << 24ul;
+
+	// Load the default NetBIOS Host Name, which is shorter than the field
+	strncpy((char*)AppConfig.NetBIOSName, MY_DEFAULT_HOST_NAME, sizeof(AppConfig.NetBIOSName));
+	FormatNetBIOSName(AppConfig.NetBIOSName);
+}
+
+/*********************************************************************
+ * Function:        void SaveAppConfig(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The configuration is not kept between runs
+ *
+ * Note:
+ ********************************************************************/
+void SaveAppConfig(void)
+{
+}
+
+/*********************************************************************
+ * Function:        static void taskTCPIP(void* pvParameter)
+ *
+ * PreCondition:    None
+ *
+ * Input:           Pointer to optional parameter
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        As the board's TCPIP task: sleeps until SIGIO
+ *					reports a frame, a Berkeley call arrives or the
+ *					next TCP timer is due, or with -p polls at a fixed
+ *					period.  Starts the Berkeley client tasks for
+ *					"bsd:N", and restarts SSL after SIGUSR1.
+ *
+ * Note:            A pcap replay has no descriptor to raise SIGIO, so
+ *					the task then sleeps for one tick whenever no
+ *					frame is waiting
+ ********************************************************************/
+static void taskTCPIP(void* pvParameter)
+{
+	BOOL bInterrupt;
+	portTickType xSleep;
+
+	// Initialize the MPFS2 file system
+	MPFSInit();
+
+	// Initialize the core stack layers
+	StackInit();
+
+	// the clients' calls are taken by this task from here on
+	if (dwBSDMessages != 0)
+		HostBSDStart(BSDPeerIP, HOST_BSD_PORT, dwBSDMessages);
+
+	// a pcap replay has no descriptor to raise SIGIO
+	bInterrupt = (xPollPeriod == 0) && MACHostEnableInterrupt(FALSE);
+
+	while (1) {
+		#if defined(STACK_USE_SSL)
+		// as after a reset, only the sessions saved to the flash remain
+		if (bSSLRestart) {
+			bSSLRestart = FALSE;
+			SSLInit();
+		}
+		#endif
+
+		// perform normal stack tasks including checking for incoming
+		// packets and calling appropriate handlers
+		StackTask();
+
+		// call the stack related applications (including HTTP server)
+		StackApplications();
+
+		if (MACHostIsDone())
+			bTrafficDone = TRUE;
+
+		if (xPollPeriod != 0) {
+			// a Berkeley call ends the wait early
+			ulTaskNotifyTake(pdTRUE, xPollPeriod);
+		} else if (bInterrupt) {
+			// SIGIO is only taken while the task sleeps, and a frame
+			// arriving before it is enabled must still be seen
+			xSleep = TCPIPGetSleepTime();
+			if (xSleep != 0) {
+				MACHostEnableInterrupt(TRUE);
+				if (!MACHostRxPending())
+					ulTaskNotifyTake(pdTRUE, xSleep);
+				MACHostEnableInterrupt(FALSE);
+			}
+		} else if (!MACHostRxPending()) {
+			vTaskDelay(1);
+		}
+	}
+}
+
+/*********************************************************************
+ * Function:        static portTickType TCPIPGetSleepTime(void)
+ *
+ * PreCondition:    StackInit() has been called
+ *
+ * Input:           None
+ *
+ * Output:          Number of RTOS ticks the TCPIP task may sleep
+ *
+ * Side Effects:    None
+ *
+ * Overview:        As in taskTCPIP.c, with the host MAC's RX buffer
+ *					standing in for the controller's INT pin
+ *
+ * Note:
+ ********************************************************************/
+static portTickType TCPIPGetSleepTime(void)
+{
+	DWORD dwTicks;
+	QWORD qwSleep;
+
+	if (MACHostRxPending())
+		return 0;
+
+	dwTicks = TCPGetNextEvent();
+	#if defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	if (BerkeleyGetNextEvent() < dwTicks)
+		dwTicks = BerkeleyGetNextEvent();
+	#endif
+	if (dwTicks == 0)
+		return 0;
+
+	qwSleep = ((QWORD)dwTicks * configTICK_RATE_HZ + TICK_SECOND - 1) / TICK_SECOND;
+	if (qwSleep > TCPIP_IDLE_PERIOD)
+		return TCPIP_IDLE_PERIOD;
+
+	return (portTickType)qwSleep;
+}
+
+/*********************************************************************
+ * Function:        static void MACInterruptHandler(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        SIGIO handler standing in for the board's MAC
+ *					interrupt, wakes the TCPIP task
+ *
+ * Note:            SIGIO is also raised when the peer goes away,
+ *					which the task notices as MACHostIsDone()
+ ********************************************************************/
+static void MACInterruptHandler(void)
+{
+	signed portBASE_TYPE xTaskWoken = pdFALSE;
+
+	xTaskNotifyFromISR(hTCPIPTask, &xTaskWoken);
+	portEND_SWITCHING_ISR(xTaskWoken);
+}
+
+/*********************************************************************
+ * Function:        void taskMeter(void* pvParameter)
+ *
+ * PreCondition:    None
+ *
+ * Input:           void* pvParameter, any parameter from the creator
+ *
+ * Output:          Does not return
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The meter task from homeMeter.c without the
+ *					display updates
+ *
+ * Note:
+ ********************************************************************/
+void taskMeter(void* pvParameter)
+{
+	static METER_MSG msg;
+
+	// initialise the meter object
+	xSemaphoreTake(METERSemaphore, portMAX_DELAY);
+	gMeter.setpoint = 190;		// 19.0 celsius
+	gMeter.electric_cost = 12;	// 12 cents per unit
+	gMeter.electric_units = 0;
+	gMeter.electric_total = 0;
+	gMeter.electric_on = 1;
+	gMeter.gas_cost = 37;		// 37 cents per unit
+	gMeter.gas_units = 0;
+	gMeter.gas_total = 0;
+	gMeter.gas_on = 1;
+	gMeter.temperature = 0;
+	MeterChanged();
+	xSemaphoreGive(METERSemaphore);
+
+	while (1) {
+		// wait for an incoming message
+		xQueueReceive(hMETERQueue, &msg, portMAX_DELAY);
+
+		// take control of the meter information structure
+		xSemaphoreTake(METERSemaphore, portMAX_DELAY);
+		switch(msg.cmd) {
+			case MSG_METER_UPDATE_TEMPERATURE:
+				gMeter.temperature = msg.data.wVal[0];
+				MeterChanged();
+				break;
+			case MSG_METER_UPDATE_ELECTRIC:
+				if (gMeter.electric_on == 1) {
+					gMeter.electric_units++;
+					gMeter.electric_total += gMeter.electric_cost;
+					MeterChanged();
+				}
+				break;
+			case MSG_METER_UPDATE_GAS:
+				if (gMeter.gas_on == 1) {
+					gMeter.gas_units++;
+					gMeter.gas_total += gMeter.gas_cost;
+					MeterChanged();
+				}
+				break;
+			case MSG_METER_UPDATE_ELECTRIC_COST:
+				gMeter.electric_cost = msg.data.wVal[0];
+				MeterChanged();
+				break;
+			case MSG_METER_UPDATE_GAS_COST:
+				gMeter.gas_cost = msg.data.wVal[0];
+				MeterChanged();
+				break;
+			default:
+				break;
+		}
+		// release the data
+		xSemaphoreGive(METERSemaphore);
+	}
+}
+
+/*********************************************************************
+ * Function:        void MeterChanged(void)
+ *
+ * PreCondition:    METERSemaphore is held and gMeter has just been
+ *					changed
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        As in homeMeter.c, give gMeter a new version and
+ *					wake the TCPIP task to stream the change
+ *
+ * Note:
+ ********************************************************************/
+void MeterChanged(void)
+{
+	gMeter.version++;
+	if (hTCPIPTask != NULL)
+		xTaskNotifyGive(hTCPIPTask);
+}
+
+/*********************************************************************
+ * Function:        static void TemperatureTimerCallback(xTimerHandle xTimer)
+ *
+ * PreCondition:    None
+ *
+ * Input:           the timer that expired
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Stands in for the temperature sensor, which the
+ *					board reads on the same period
+ *
+ * Note:
+ ********************************************************************/
+static void TemperatureTimerCallback(xTimerHandle xTimer)
+{
+	static WORD wTemperature = 200;
+	METER_MSG msg;
+
+	wTemperature = (wTemperature >= 250) ? 200 : wTemperature + 1;
+	msg.cmd = MSG_METER_UPDATE_TEMPERATURE;
+	msg.data.wVal[0] = wTemperature;
+	xQueueSend(hMETERQueue, &msg, 0);
+}
+
+/*********************************************************************
+ * Function:        static void taskControl(void* pvParameter)
+ *
+ * PreCondition:    None
+ *
+ * Input:           Pointer to optional parameter
+ *
+ * Output:          None
+ *
+ * Side Effects:    Ends the scheduler
+ *
+ * Overview:        Waits for the run time to pass or the traffic to
+ *					finish, then captures the task statistics and
+ *					returns to main()
+ *
+ * Note:
+ ********************************************************************/
+static void taskControl(void* pvParameter)
+{
+	portTickType xEnd;
+
+	xEnd = xTaskGetTickCount() + (portTickType)lRunTime * configTICK_RATE_HZ;
+	while (!bTrafficDone && (long)(xEnd - xTaskGetTickCount()) > 0)
+		vTaskDelay(CONTROL_PERIOD);
+
+	// the snapshot must be taken while the scheduler is still running
+	uxRunTimeStatsCount = uxTaskGetRunTimeSnapshot(xRunTimeStats, MAX_TASKS, &ullTotalRunTime);
+	vTaskEndScheduler();
+
+	// should not get here
+	while (1)
+		vTaskDelay(portMAX_DELAY);
+}
+
+/*********************************************************************
+ * Function:        static void SSLRestartHandler(int iSignal)
+ *
+ * PreCondition:    None
+ *
+ * Input:           the signal, SIGUSR1
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Has the TCPIP task restart SSL, for "ssl:N" to
+ *					resume the sessions saved before a reset
+ *
+ * Note:            SSLInit() is left to the task, which owns the
+ *					stack
+ ********************************************************************/
+static void SSLRestartHandler(int iSignal)
+{
+	bSSLRestart = TRUE;
+}
+
+static double Seconds(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/*********************************************************************
+ * Function:        static void PrintResults(double dWall, double dCPU)
+ *
+ * PreCondition:    The scheduler has ended
+ *
+ * Input:           elapsed and CPU time of the run in seconds
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Print the frame counts, the rates and the CPU time
+ *					used by each task
+ *
+ * Note:            The CPU time per frame covers the whole process,
+ *					driver and kernel included, divided by the frames
+ *					received and sent
+ *
+ ********************************************************************/
+static void PrintResults(double dWall, double dCPU)
+{
+	HOST_MAC_STATS Stats;
+	ARP_CACHE_STATS ARPStats;
+	HOST_FLASH_STATS FlashStats;
+	SST25_CACHE_STATS CacheStats;
+	#if defined(STACK_USE_SSL)
+	SSL_SESSION_STATS SessionStats;
+	#endif
+	unsigned portBASE_TYPE x;
+	DWORD dwFrames;
+
+	MACHostGetStats(&Stats);
+	ARPGetStats(&ARPStats);
+	HostFlashGetStats(&FlashStats);
+	SST25CacheGetStats(&CacheStats);
+	dwFrames = Stats.dwRxFrames + Stats.dwTxFrames;
+
+	printf("Ran for %.2f s using %.2f s of CPU\n", dWall, dCPU);
+	printf("  RX     %10lu frames, %lu bytes, %lu filtered, %lu dropped\n",
+		(unsigned long)Stats.dwRxFrames, (unsigned long)Stats.dwRxBytes,
+		(unsigned long)Stats.dwRxFiltered, (unsigned long)Stats.dwRxDropped);
+	printf("  TX     %10lu frames, %lu bytes\n",
+		(unsigned long)Stats.dwTxFrames, (unsigned long)Stats.dwTxBytes);
+	printf("  RATE   %10.0f frames/s, %.2f us CPU per frame\n",
+		(dWall > 0.0) ? (double)dwFrames / dWall : 0.0,
+		(dwFrames > 0) ? dCPU * 1e6 / (double)dwFrames : 0.0);
+	printf("  ARP    %10lu hits, %lu misses, %lu requests, %lu learned, %lu evicted, %lu expired\n",
+		(unsigned long)ARPStats.dwHits, (unsigned long)ARPStats.dwMisses,
+		(unsigned long)ARPStats.dwRequests, (unsigned long)ARPStats.dwLearned,
+		(unsigned long)ARPStats.dwEvictions, (unsigned long)ARPStats.dwExpired);
+	printf("  FLASH  %10lu reads, %lu bytes, %.1f ms of SPI bus\n",
+		(unsigned long)FlashStats.dwReads, (unsigned long)FlashStats.dwReadBytes,
+		((double)FlashStats.dwReads * HOST_FLASH_READ_CMD + (double)FlashStats.dwReadBytes) *
+		8e3 / HOST_FLASH_SPI_HZ);
+	printf("  CACHE  %10lu hits, %lu misses (%.1f%% hit), %lu direct\n",
+		(unsigned long)CacheStats.dwHits, (unsigned long)CacheStats.dwMisses,
+		(CacheStats.dwHits + CacheStats.dwMisses > 0) ? 100.0 * (double)CacheStats.dwHits /
+		(double)(CacheStats.dwHits + CacheStats.dwMisses) : 0.0,
+		(unsigned long)CacheStats.dwDirect);
+	#if defined(STACK_USE_SSL)
+	SSLGetSessionStats(&SessionStats);
+	printf("  SSL    %10lu hits, %lu misses, %lu new, %lu evicted, %lu refused, %lu saved, %lu restored\n",
+		(unsigned long)SessionStats.dwHits, (unsigned long)SessionStats.dwMisses,
+		(unsigned long)SessionStats.dwNew, (unsigned long)SessionStats.dwEvicted,
+		(unsigned long)SessionStats.dwRefused, (unsigned long)SessionStats.dwSaved,
+		(unsigned long)SessionStats.dwRestored);
+	#endif
+
+	if (ullTotalRunTime == 0)
+		return;
+
+	printf("CPU time by task (%llu us in total)\n", ullTotalRunTime);
+	for (x = 0; x < uxRunTimeStatsCount; x++) {
+		printf("  %-6s %9.2f%% %10lu switches\n", (const char*) xRunTimeStats[x].pcTaskName,
+			(100.0 * (double) xRunTimeStats[x].ullRunTimeCounter) / (double) ullTotalRunTime,
+			(unsigned long) xRunTimeStats[x].ulSwitchInCount);
+	}
+}
+
+void vApplicationStackOverflowHook(xTaskHandle *pxTask, signed char *pcTaskName)
+{
+	// tasks run on host stacks, so this indicates memory corruption
+	fprintf(stderr, "Stack overflow detected in task %s\n", (char*) pcTaskName);
+	abort();
+}
@@ -129,8 +129,9 @@
     /* SYMBOLS_TO_TICKS to only be used with input (a) as a constant, otherwise you will blow up the code */
     #define SYMBOLS_TO_TICKS(a) (((DWORD)CLOCK_FREQ/10000 * a ) / ((DWORD)SYMBOL_TO_TICK_RATE / 10000))
 
-#elif defined(__PIC32MX__)
+#elif defined(__PIC32MX__) || defined(__linux__)
     /* this section is based on the Timer 2/3 module of the PIC32MX family */
+    /* host builds count the same prescaled clock, see Host\HostTick.c */
     #if(INSTR_FREQ <= 125000)
         #define CLOCK_DIVIDER 1
         #define CLOCK_DIVIDER_SETTING 0x0000 /* no prescalar */
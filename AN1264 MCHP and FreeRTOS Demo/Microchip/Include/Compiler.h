@@ -79,6 +79,8 @@
 	#endif
 	#include <p32xxxx.h>
 	#include <plib.h>
+#elif defined(__linux__)	// GCC host build, see Host\Makefile
+	// No device header; the stack runs against the HostMAC.c driver
 #else
 	#error Unknown processor or compiler.  See Compiler.h
 #endif
@@ -92,6 +94,9 @@
 #if defined(__PIC32MX__)
 	#define PTR_BASE		DWORD
 	#define ROM_PTR_BASE	DWORD
+#elif defined(__linux__)
+	#define PTR_BASE		unsigned long
+	#define ROM_PTR_BASE	unsigned long
 #elif defined(__C30__)
 	#define PTR_BASE		WORD
 	#define ROM_PTR_BASE	WORD
@@ -166,6 +171,16 @@
 			#define Nop()				asm("nop")
 		#endif
 	#endif
+
+	// GCC host build
+	#if defined(__linux__)
+		#define persistent
+		#define far
+		#define FAR
+		#define Reset()				exit(0)
+		#define ClrWdt()
+		#define Nop()
+	#endif
 #endif
 
 
@@ -55,10 +55,42 @@
 #ifndef __ARP_H
 #define __ARP_H
 
+// Number of IP to MAC address translations kept by the ARP cache.  Each
+// entry costs about 20 bytes of RAM.  Override in TCPIPConfig.h.
+#if !defined(ARP_CACHE_ENTRIES)
+	#define ARP_CACHE_ENTRIES		(4u)
+#endif
+
+// How long a resolved entry may be used before it must be resolved again.
+// Override in TCPIPConfig.h.
+#if !defined(ARP_CACHE_TIMEOUT)
+	#define ARP_CACHE_TIMEOUT		((DWORD)(5*60*TICK_SECOND))
+#endif
+
+// How long an entry waits for the response to an ARPResolve() request
+// before its slot may be reused.  Override in TCPIPConfig.h.
+#if !defined(ARP_PENDING_TIMEOUT)
+	#define ARP_PENDING_TIMEOUT		((DWORD)(2*TICK_SECOND))
+#endif
+
+// ARP cache counters kept since ARPInit()
+typedef struct
+{
+	DWORD dwHits;			// ARPIsResolved() calls answered from the cache
+	DWORD dwMisses;			// ARPIsResolved() calls that found no resolved entry
+	DWORD dwRequests;		// ARP requests transmitted by ARPResolve()
+	DWORD dwLearned;		// Translations added or pending entries resolved, not refreshes
+	DWORD dwEvictions;		// Resolved entries displaced to make room
+	DWORD dwExpired;		// Entries dropped by ARP_CACHE_TIMEOUT
+} ARP_CACHE_STATS;
+
 #ifdef STACK_CLIENT_MODE
 	void ARPInit(void);
+	void ARPLearn(NODE_INFO* Node);
+	void ARPGetStats(ARP_CACHE_STATS* Stats);
 #else
 	#define ARPInit()
+	#define ARPLearn(a)
 #endif
 
 #define ARP_OPERATION_REQ       0x0001u		// Operation code indicating an ARP Request
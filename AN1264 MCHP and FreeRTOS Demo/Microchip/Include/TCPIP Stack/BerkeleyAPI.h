@@ -68,6 +68,11 @@ typedef BYTE SOCKET;   //Socket descriptor
 #define SOCKET_ERROR            (-1) //Socket error
 #define SOCKET_CNXN_IN_PROGRESS (-2) //Socket connection state.
 #define SOCKET_DISCONNECTED     (-3) //Socket disconnected
+#define SOCKET_TIMEOUT          (-4) //Blocking call timed out (BSD_USE_RTOS only)
+
+#define SOL_SOCKET      0xffff      // Socket level options for setsockopt()
+#define SO_SNDTIMEO     0x1005      // send() and sendto() timeout, a DWORD in milliseconds
+#define SO_RCVTIMEO     0x1006      // recv(), recvfrom(), accept() and connect() timeout, a DWORD in milliseconds
 
 typedef enum
 {
@@ -91,6 +96,10 @@ struct BSDSocket
     int            backlog; // maximum number or client connection
     BOOL           isServer; // server/client check
     TCP_SOCKET     SocketID; // Socket ID
+#if defined(BSD_USE_RTOS)
+    DWORD          sendTimeout; // SO_SNDTIMEO, in ticks, 0 to wait forever
+    DWORD          recvTimeout; // SO_RCVTIMEO, in ticks, 0 to wait forever
+#endif
 }; // Berkeley Socket structure
 
 #define INVALID_TCP_PORT   (0L)  //Invalide TCP port
@@ -129,7 +138,29 @@ struct __attribute__((__packed__)) sockaddr_in
 typedef struct sockaddr_in SOCKADDR_IN; //In the Internet address family
 typedef struct sockaddr SOCKADDR;  // generic address structure for all address families
 
+#if defined(__linux__)
+	// Host builds link with the C library, whose socket functions 
+	// have the same names
+	#define socket		BSDsocket
+	#define bind		BSDbind
+	#define listen		BSDlisten
+	#define accept		BSDaccept
+	#define connect		BSDconnect
+	#define send		BSDsend
+	#define sendto		BSDsendto
+	#define recv		BSDrecv
+	#define recvfrom	BSDrecvfrom
+	#define gethostname	BSDgethostname
+	#define setsockopt	BSDsetsockopt
+	#define closesocket	BSDclosesocket
+#endif
+
 void BerkeleySocketInit(void);
+#if defined(BSD_USE_RTOS)
+void BerkeleySocketTask(void);
+DWORD BerkeleyGetNextEvent(void);
+int setsockopt( SOCKET s, int level, int optname, const char* optval, int optlen );
+#endif
 SOCKET socket( int af, int type, int protocol );
 int bind( SOCKET s, const struct sockaddr* name, int namelen );
 int listen( SOCKET s, int backlog );
@@ -71,6 +71,11 @@
 	#define BIGINT_DATA_TYPE	DWORD
 	#define BIGINT_DATA_MAX		0xFFFFFFFFu
 	#define BIGINT_DATA_TYPE_2	QWORD
+#elif defined(__linux__)	// GCC host build, helpers in Host\HostBigInt.c
+	#define BIGINT_DATA_SIZE	32ul	//bits
+	#define BIGINT_DATA_TYPE	DWORD
+	#define BIGINT_DATA_MAX		0xFFFFFFFFu
+	#define BIGINT_DATA_TYPE_2	QWORD
 #endif
 
 typedef struct _BIGINT
@@ -110,6 +115,9 @@ WORD BigIntMagnitude(BIGINT *n);
 
 void BigIntSwapEndianness(BIGINT *a);
 
+BIGINT_DATA_TYPE BigIntMontgomeryInverse(BIGINT *m);
+void BigIntMontgomeryMultiply(BIGINT *a, BIGINT *b, BIGINT *m, BIGINT_DATA_TYPE mInv, BIGINT *res);
+
 void BigIntPrint(const BIGINT *a);
 
 
@@ -68,6 +68,8 @@
 	#define HTTP_MIN_CALLBACK_FREE	(16u)	// Min bytes free in TX FIFO before callbacks execute
 	#define HTTP_CACHE_LEN			("600")	// Max lifetime (sec) of static responses as string
 	#define HTTP_TIMEOUT			(45u)	// Max time (sec) to await more data before
+	#define HTTP_KEEPALIVE_TIMEOUT	(5u)	// Max time (sec) an idle persistent connection is kept open
+	#define HTTP_KEEPALIVE_FIFO		(128u)	// FIFO bytes kept for the idle direction on persistent connections
 
 	// Authentication requires Base64 decoding
 	#if defined(HTTP_USE_AUTHENTICATION)
@@ -99,7 +101,8 @@
 		HTTP_MPFS_ERROR,				// An MPFS Upload was not a valid image
 		#endif
 		HTTP_REDIRECT,					// 302 Redirect will be returned
-		HTTP_SSL_REQUIRED				// 403 Forbidden is returned, indicating SSL is required
+		HTTP_SSL_REQUIRED,				// 403 Forbidden is returned, indicating SSL is required
+		HTTP_NOT_MODIFIED				// 304 Not Modified is returned for a static file the client has
 	} HTTP_STATUS;
 	
 /****************************************************************************
@@ -121,7 +124,8 @@
 		SM_HTTP_SERVE_COOKIES,			// Adds any cookies to the response
 		SM_HTTP_SERVE_BODY,				// Serves the actual content
 		SM_HTTP_SEND_FROM_CALLBACK,		// Invokes a dynamic variable callback
-		SM_HTTP_DISCONNECT				// Disconnects the server and closes all files
+		SM_HTTP_DISCONNECT,				// Disconnects the server and closes all files
+		SM_HTTP_KEEPALIVE				// Awaits the next request on a persistent connection
 	} SM_HTTP2;
 	
 	// Result states for execution callbacks
@@ -154,6 +158,7 @@
 		HTTP_JPG,			// File is JPG image (extension .jpg)
 		HTTP_JAVA,			// File is java (extension .java)
 		HTTP_WAV,			// File is audio (extension .wav)
+		HTTP_SSE,			// File is an event stream (extension .sse)
 		HTTP_UNKNOWN		// File type is unknown
 	} HTTP_FILE_TYPE;
 
@@ -184,6 +189,16 @@
 		BYTE isAuthorized;					// 0x00-0x79 on fail, 0x80-0xff on pass
 		HTTP_STATUS httpStatus;				// Request method/status
 	    HTTP_FILE_TYPE fileType;			// File type to return with Content-Type
+		struct
+		{
+			unsigned char bKeepAlive : 1;	// Connection stays open for another request
+			unsigned char bHTTP10 : 1;		// Request was HTTP/1.0, which cannot take chunks
+			unsigned char bChunked : 1;		// Body is sent with chunked transfer coding
+			unsigned char bChunkSent : 1;	// A chunk has been sent and needs its CRLF
+			unsigned char bNoneMatch : 1;	// Request had If-None-Match, which overrides If-Modified-Since
+			unsigned char bNotModified : 1;	// Request's validators match the file
+			unsigned char filler : 2;
+		} flags;
 		BYTE data[HTTP_MAX_DATA_LEN];		// General purpose data buffer
 		#if defined(HTTP_USE_POST)
 		BYTE smPost;						// POST state machine variable
@@ -0,0 +1,53 @@
+/*********************************************************************
+ *
+ *	Host (Linux) virtual Ethernet controller
+ *
+ *********************************************************************
+ * FileName:        HostMAC.h
+ * Dependencies:    None
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * The MAC.h API implemented over a RAM array laid out like the
+ * ENCX24J600's, so the stack runs unmodified on a Linux host.  Frames
+ * are exchanged with one of the backends below, chosen by
+ * MACHostOpen() before StackInit() is called:
+ *
+ *	"tap:NAME"	A Linux TAP interface (needs CAP_NET_ADMIN).
+ *	"fd:N"		An inherited AF_UNIX SOCK_SEQPACKET or SOCK_DGRAM
+ *				socket, one frame per message; usually one end of a
+ *				socketpair().
+ *	"pcap:FILE"	Replay of a libpcap capture file as fast as the RX
+ *				buffer accepts it.  Transmitted frames are counted
+ *				and discarded.
+ ********************************************************************/
+#ifndef __HOSTMAC_H
+#define __HOSTMAC_H
+
+#include "GenericTypeDefs.h"
+#include "HardwareProfile.h"
+
+#if !defined(__linux__)
+	#error HostMAC.c is only for Linux host builds
+#endif
+
+// Frame counters kept since MACHostOpen()
+typedef struct
+{
+	DWORD dwRxFrames;		// Frames placed in the RX buffer
+	DWORD dwRxBytes;
+	DWORD dwRxFiltered;		// Frames not for this MAC address
+	DWORD dwRxDropped;		// Frames lost because the RX buffer was full
+	DWORD dwTxFrames;
+	DWORD dwTxBytes;
+} HOST_MAC_STATS;
+
+BOOL	MACHostOpen(const char *szSpec);
+void	MACHostClose(void);
+BOOL	MACHostRxPending(void);
+BOOL	MACHostIsDone(void);
+BOOL	MACHostEnableInterrupt(BOOL bEnable);
+int		MACHostGetFD(void);
+void	MACHostGetStats(HOST_MAC_STATS *pStats);
+
+#endif
@@ -84,6 +84,9 @@
 #elif defined(ENC100_INTERFACE_MODE)
 	#include "TCPIP Stack/ENCX24J600.h"
 	#define PHYREG WORD
+#elif defined(HOST_MAC)
+	#include "TCPIP Stack/HostMAC.h"
+	#define PHYREG WORD
 #else
 	#error No Ethernet/WiFi controller defined in HardwareProfile.h.  Defines for an ENC28J60, ENC424J600/624J600, or ZeroG ZG2100 must be present.
 #endif
@@ -131,6 +134,16 @@ typedef struct  __attribute__((aligned(2), packed))
 	#define BASE_HTTPB_ADDR (BASE_TCB_ADDR + TCP_ETH_RAM_SIZE)
 	#define BASE_SSLB_ADDR	(BASE_HTTPB_ADDR + RESERVED_HTTP_MEMORY)
 	#define BASE_CRYPTOB_ADDR	(BASE_SSLB_ADDR + RESERVED_SSL_MEMORY)
+#elif defined(HOST_MAC)	// Same layout as the ENCX24J600, less the crypto area
+	#define RAMSIZE			(24*1024ul)
+	#define TXSTART 		(0x0000ul)
+	#define RXSTART 		((TXSTART + 1518ul + TCP_ETH_RAM_SIZE + RESERVED_HTTP_MEMORY + RESERVED_SSL_MEMORY + 1ul) & 0xFFFE)
+	#define	RXSTOP			(RAMSIZE-1ul)
+	#define RXSIZE			(RXSTOP-RXSTART+1ul)
+	#define BASE_TX_ADDR	(TXSTART)
+	#define BASE_TCB_ADDR	(BASE_TX_ADDR + 1518ul)
+	#define BASE_HTTPB_ADDR (BASE_TCB_ADDR + TCP_ETH_RAM_SIZE)
+	#define BASE_SSLB_ADDR	(BASE_HTTPB_ADDR + RESERVED_HTTP_MEMORY)
 #elif defined(ZG_CS_TRIS)
     #define RAMSIZE			14170ul
     #define TXSTART			(RAMSIZE - ((4ul + MAX_PACKET_SIZE + 4ul)*2) - TCP_ETH_RAM_SIZE - RESERVED_HTTP_MEMORY - RESERVED_SSL_MEMORY)
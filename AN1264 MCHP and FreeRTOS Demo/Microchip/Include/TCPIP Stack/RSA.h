@@ -143,6 +143,7 @@ RSA_STATUS RSAStep(void);
 	#define BI_USE_MULTIPLY
 	#define BI_USE_SQUARE
 	#define BI_USE_COPY
+	#define BI_USE_MONTGOMERY
 #endif
 
 #if defined(STACK_USE_RSA_DECRYPT)
@@ -156,19 +157,11 @@ RSA_STATUS RSAStep(void);
 	#define BI_USE_ADD
 	#define BI_USE_SUBTRACT
 	#define BI_USE_COPY
+	#define BI_USE_MONTGOMERY
 
-	#if defined(__18CXX)
-		#define BI_USE_CONSTRUCTOR_ROM
-		#define BI_USE_COPY_ROM
-		#define BI_USE_MOD_ROM
-		#define BI_USE_COMPARE_ROM
-		#define BI_USE_MAG_DIFF_ROM
-		#define BI_USE_MAG_ROM
-		#define BI_USE_MULTIPLY_ROM
-	#else
-		#define BI_USE_MAG_DIFF
-		#define BI_USE_MOD
-	#endif
+	// the key is copied to RAM, so the ROM functions are not needed
+	#define BI_USE_MAG_DIFF
+	#define BI_USE_MOD
 #endif
 
 #endif
@@ -58,19 +58,21 @@
 
 //Entropy is generated as follows:
 //	1. 	For every packet received, the last byte of the remote 
-//		MAC address and the four bytes of TickGet() are added
-//		to a SHA-1 Hash (the seed)
-//	2.	Every time a random byte is requested, the hash is
-//		calculated and the hash sum is hashed into the seed.
-//	3.	Up to 20 bytes are returned from this hash sum before
-//		a new hash is calculated.
-//	4.	Every time new entropy is added, the remaining random
-//		output is discarded and new random bytes will be 
-//		generated upon future calls to RandomGet().
+//		MAC address and the low byte of TickGet() are folded
+//		into a small pool with XOR.  Nothing is hashed per packet.
+//	2.	At most once a second, and only when packets have
+//		arrived, RandomTask() hashes the pool into a SHA-1 hash
+//		(the seed) and hashes the seed's hash sum into the key.
+//	3.	Random bytes are read in 20 byte blocks, each the SHA-1
+//		hash of the key and a block counter.  The key is replaced
+//		once at the end of each read that made a block, and is
+//		set on first use if RandomTask() has not yet done so.
 
 void RandomInit(void);
 BYTE RandomGet(void);
+void RandomGetArray(BYTE* data, WORD len);
 void RandomAdd(BYTE data);
+void RandomTask(void);
 
 #endif
 
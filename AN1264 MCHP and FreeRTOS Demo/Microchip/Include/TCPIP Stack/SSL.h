@@ -63,13 +63,32 @@
 	
 	#define SSL_INVALID_ID			(0xFFu)		// Identifier for invalid SSL allocations
 	
-	// Minimum lifetime for SSL Sessions
-	// Sessions cannot be reallocated until this much time has elapsed
-	#define SSL_MIN_SESSION_LIFETIME	(1*TICK_SECOND)
+	// Lifetime of SSL Sessions
+	// Sessions are not resumed once this long has passed since their full
+	// handshake, and are the first to be reallocated
+	#if !defined(SSL_SESSION_LIFETIME)
+		#define SSL_SESSION_LIFETIME		(24ull*TICK_HOUR)
+	#endif
 	
-	// Lifetime extension for RSA operations
-	// Sessions lifetime is extended by this amount when an RSA calculation is made
-	#define SSL_RSA_LIFETIME_EXTENSION	(8*TICK_SECOND)
+	// Sessions are written to SPI Flash no more often than this, so that
+	// a busy server does not wear out the sector (SSL_SESSION_PERSIST)
+	#if !defined(SSL_SESSION_SAVE_PERIOD)
+		#define SSL_SESSION_SAVE_PERIOD		(600ull*TICK_SECOND)
+	#endif
+	
+	// Address of the SPI Flash sector holding the saved sessions
+	#if !defined(SSL_SESSION_FLASH_ADDR)
+		#define SSL_SESSION_FLASH_ADDR		(0x1FF000ul)
+	#endif
+	
+	// Saved sessions are sealed with keys hashed from the server's RSA key
+	#if defined(SSL_SESSION_PERSIST) && !defined(STACK_USE_SSL_SERVER)
+		#undef SSL_SESSION_PERSIST
+	#endif
+	
+	#if MAX_SSL_SESSIONS >= SSL_INVALID_ID
+		#error MAX_SSL_SESSIONS must be less than 255
+	#endif
 	
 	
 /****************************************************************************
@@ -241,16 +260,31 @@
 	// remote node, either by matching to a remote IP address when we are
 	// the client or the first 3 bytes of the session ID when we are the host.
 	// When a session is free/expired, the tag is 0x00000000.  The lastUsed
-	// value is the Tick count when the session was last used so that 
-	// older sessions may be overwritten first.
+	// value orders the sessions by when they were last used so that the
+	// least recently used may be overwritten first, and created is the
+	// TickGetDiv64K() count of the full handshake, for the lifetime.
 	typedef struct
 	{
 		DWORD_VAL tag;						// Identifying tag for connection
 											// When we're a client, this is the remote IP
 											// When we're a host, this is 0x00 followed by first 3 bytes of session ID
+											// (0x01 until its handshake completes)
 											// When this stub is free/expired, this is 0x00
-		DWORD lastUsed;						// Tick count when session was last used
+		DWORD lastUsed;						// Use count when session was last used
+		DWORD created;						// TickGetDiv64K() when the session was negotiated
 	} SSL_SESSION_STUB;
+	
+	// Session cache statistics, from SSLGetSessionStats()
+	typedef struct
+	{
+		DWORD dwHits;						// Sessions resumed
+		DWORD dwMisses;						// Session IDs offered but not found or expired
+		DWORD dwNew;						// Sessions allocated for full handshakes
+		DWORD dwEvicted;					// Cached sessions overwritten by new ones
+		DWORD dwRefused;					// Full handshakes with every session in use
+		DWORD dwRestored;					// Sessions read back from SPI Flash
+		DWORD dwSaved;						// Times the sessions were written to SPI Flash
+	} SSL_SESSION_STATS;
 
 	
 	#define SSL_STUB_SIZE		((DWORD)sizeof(SSL_STUB))				// Amount of space needed by a single SSL stub
@@ -274,10 +308,15 @@
   ***************************************************************************/
 
 void SSLInit(void);
+void SSLGetSessionStats(SSL_SESSION_STATS* pStats);
+#if defined(SSL_SESSION_PERSIST)
+	void SSLSessionSaveTask(void);
+#endif
 
 BYTE SSLStartSession(TCP_SOCKET hTCP);
 void SSLTerminate(BYTE sslStubId);
 void SSLPeriodic(TCP_SOCKET hTCP, BYTE sslStubID);
+BOOL SSLRSAPending(void);
 WORD SSLRxRecord(TCP_SOCKET hTCP, BYTE sslStubID);
 void SSLRxHandshake(TCP_SOCKET hTCP);
 void SSLTxRecord(TCP_SOCKET hTCP, BYTE sslStubID, BYTE txProtocol);
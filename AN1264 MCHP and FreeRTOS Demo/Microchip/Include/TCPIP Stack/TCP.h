@@ -137,7 +137,8 @@ typedef struct
 		unsigned char bTXFIN : 1;					// FIN needs to be transmitted
 		unsigned char bSocketReset : 1;				// Socket has been reset (self-clearing semaphore)
 		unsigned char bSSLHandshaking : 1;			// Socket is in an SSL handshake
-		unsigned char filler : 2;					// Future expansion
+		unsigned char bTxHold : 1;					// A header is reserved, so data is held back
+		unsigned char bTxHoldFlush : 1;				// A flush was deferred while data was held back
     } Flags;
 	WORD_VAL remoteHash;	// Consists of remoteIP, remotePort, localPort for connected sockets.  It is a localPort number only for listening server sockets.
 
@@ -221,8 +222,12 @@ WORD TCPFindArrayEx(TCP_SOCKET hTCP, BYTE* cFindArray, WORD wLen, WORD wStart, W
 void TCPDiscard(TCP_SOCKET hTCP);
 BOOL TCPProcess(NODE_INFO* remote, IP_ADDR* localIP, WORD len);
 void TCPTick(void);
+DWORD TCPGetNextEvent(void);
 void TCPFlush(TCP_SOCKET hTCP);
 
+// TCPGetNextEvent() result when no TCP timer is running
+#define TCP_NO_EVENT		(0xFFFFFFFFul)
+
 // Create a server socket and ignore dwRemoteHost.
 #define TCP_OPEN_SERVER		0u
 #if defined(STACK_CLIENT_MODE)
@@ -276,6 +281,8 @@ TCP_SOCKET TCPOpen(DWORD dwRemoteHost, BYTE vRemoteHostType, WORD wPort, BYTE vS
 #endif
 
 WORD TCPGetTxFIFOFull(TCP_SOCKET hTCP);
+BOOL TCPReserveHeader(TCP_SOCKET hTCP, WORD wLen);
+void TCPPutHeader(TCP_SOCKET hTCP, BYTE* hdr, WORD wLen, WORD wDataLen);
 // Alias to TCPIsGetReady provided for API completeness
 #define TCPGetRxFIFOFull(a)					TCPIsGetReady(a)
 // Alias to TCPIsPutReady provided for API completeness
@@ -282,6 +282,13 @@
 // modified for FreeRTOS Demo
 //#include "TCPIP Stack/Tick.h"
 #include "Common/SymbolTime.h"
+// Tick.c, declared here as TCPIP Stack/Tick.h clashes with SymbolTime.h
+void TickInit(void);
+DWORD TickGet(void);
+DWORD TickGetDiv256(void);
+DWORD TickGetDiv64K(void);
+DWORD TickConvertToMilliseconds(DWORD dwTickValue);
+void TickUpdate(void);
 #include "TCPIP Stack/MAC.h"
 #include "TCPIP Stack/IP.h"
 #include "TCPIP Stack/ARP.h"
@@ -306,7 +313,7 @@
 	#include "TCPIP Stack/Random.h"
 #endif
 
-#if defined(STACK_USE_MD5) || defined(STACK_USE_SHA1)
+#if defined(STACK_USE_MD5) || defined(STACK_USE_SHA1) || defined(STACK_USE_SHA256)
 	#include "TCPIP Stack/Hashes.h"
 #endif
 
@@ -322,8 +329,14 @@
 	#include "TCPIP Stack/TCP.h"
 #endif
 
-#if defined(STACK_USE_BERKELEY_API)
+// Host modules that use the C library's sockets define HOST_LIBC_SOCKETS, 
+// as its declarations clash with the Berkeley API's
+#if defined(STACK_USE_BERKELEY_API) && !defined(HOST_LIBC_SOCKETS)
 	#include "TCPIP Stack/BerkeleyAPI.h"
+#elif defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	// still needed by a host TCPIP task
+	void BerkeleySocketTask(void);
+	DWORD BerkeleyGetNextEvent(void);
 #endif
 
 #if defined(USE_LCD)
@@ -69,7 +69,25 @@
   ***************************************************************************/
 
 #ifdef STACK_CLIENT_MODE
-static NODE_INFO Cache;						// Cache for one ARP response
+// States of an ARP cache entry
+typedef enum
+{
+	ARP_ENTRY_FREE = 0u,		// Slot is unused
+	ARP_ENTRY_PENDING,			// ARPResolve() sent a request, no response yet
+	ARP_ENTRY_RESOLVED			// Node holds a valid IP to MAC translation
+} ARP_ENTRY_STATE;
+
+// One IP to MAC address translation
+typedef struct
+{
+	NODE_INFO Node;				// IP address and, once resolved, its MAC address
+	DWORD dwUpdated;			// Tick when the request was sent or the MAC last confirmed
+	DWORD dwLastUsed;			// Tick when last created or returned by ARPIsResolved()
+	BYTE vState;				// ARP_ENTRY_STATE
+} ARP_CACHE_ENTRY;
+
+static ARP_CACHE_ENTRY Cache[ARP_CACHE_ENTRIES];	// Cache of ARP translations
+static ARP_CACHE_STATS CacheStats;					// Counters for ARPGetStats()
 #endif
 
 
@@ -81,6 +99,12 @@ static NODE_INFO Cache;						// Cache for one ARP response
 
 static BOOL ARPPut(ARP_PACKET* packet);
 
+#ifdef STACK_CLIENT_MODE
+static ARP_CACHE_ENTRY* ARPFindEntry(DWORD dwIPAddr);
+static ARP_CACHE_ENTRY* ARPAllocEntry(BOOL bEvict);
+static void ARPUpdateEntry(NODE_INFO* Node, BOOL bCreate);
+#endif
+
 
 /****************************************************************************
   Section:
@@ -128,6 +152,154 @@ static BOOL ARPPut(ARP_PACKET* packet)
 	return TRUE;
 }
 
+#ifdef STACK_CLIENT_MODE
+/*****************************************************************************
+  Function:
+	static ARP_CACHE_ENTRY* ARPFindEntry(DWORD dwIPAddr)
+
+  Description:
+	Searches the ARP cache for the entry holding an IP address.  A resolved
+	entry older than ARP_CACHE_TIMEOUT is freed instead of being returned.
+
+  Precondition:
+	None
+
+  Parameters:
+	dwIPAddr - The IP address to look up
+
+  Returns:
+  	The pending or resolved entry for dwIPAddr, or NULL if there is none.
+  ***************************************************************************/
+static ARP_CACHE_ENTRY* ARPFindEntry(DWORD dwIPAddr)
+{
+	ARP_CACHE_ENTRY* p;
+
+	for(p = Cache; p < Cache + ARP_CACHE_ENTRIES; p++)
+	{
+		if(p->vState == ARP_ENTRY_FREE || p->Node.IPAddr.Val != dwIPAddr)
+			continue;
+
+		if(p->vState == ARP_ENTRY_RESOLVED && TickGet() - p->dwUpdated > ARP_CACHE_TIMEOUT)
+		{
+			p->vState = ARP_ENTRY_FREE;
+			CacheStats.dwExpired++;
+			return NULL;
+		}
+
+		return p;
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************
+  Function:
+	static ARP_CACHE_ENTRY* ARPAllocEntry(BOOL bEvict)
+
+  Description:
+	Finds a slot for a new ARP cache entry.  Free slots are used first, then
+	resolved entries past ARP_CACHE_TIMEOUT and pending entries past
+	ARP_PENDING_TIMEOUT.  If none of those exist and bEvict is set, the
+	least recently used entry is displaced.
+
+  Precondition:
+	The IP address to be stored is not already in the cache.
+
+  Parameters:
+	bEvict - TRUE to displace a live entry when the cache is full
+
+  Returns:
+  	The slot to fill in, or NULL if the cache is full and bEvict is FALSE.
+  ***************************************************************************/
+static ARP_CACHE_ENTRY* ARPAllocEntry(BOOL bEvict)
+{
+	ARP_CACHE_ENTRY* p;
+	ARP_CACHE_ENTRY* pOldest;
+	DWORD dwNow;
+
+	dwNow = TickGet();
+	pOldest = NULL;
+	for(p = Cache; p < Cache + ARP_CACHE_ENTRIES; p++)
+	{
+		if(p->vState == ARP_ENTRY_FREE)
+			return p;
+
+		if(p->vState == ARP_ENTRY_PENDING)
+		{
+			if(dwNow - p->dwUpdated > ARP_PENDING_TIMEOUT)
+				return p;
+		}
+		else if(dwNow - p->dwUpdated > ARP_CACHE_TIMEOUT)
+		{
+			CacheStats.dwExpired++;
+			return p;
+		}
+
+		if(pOldest == NULL || dwNow - p->dwLastUsed > dwNow - pOldest->dwLastUsed)
+			pOldest = p;
+	}
+
+	if(!bEvict)
+		return NULL;
+
+	CacheStats.dwEvictions++;
+	return pOldest;
+}
+
+/*****************************************************************************
+  Function:
+	static void ARPUpdateEntry(NODE_INFO* Node, BOOL bCreate)
+
+  Description:
+	Records that Node->IPAddr is reachable at Node->MACAddr.  An existing
+	pending or resolved entry is filled in and its timeout restarted.
+	Otherwise a new entry is made only if bCreate is set and a slot can be
+	had without displacing a live entry, so unsolicited traffic never pushes
+	out translations the stack asked for.
+
+  Precondition:
+	None
+
+  Parameters:
+	Node - The IP and MAC address pair observed on the network
+	bCreate - TRUE to add the pair if it is not already cached
+
+  Returns:
+  	None
+  ***************************************************************************/
+static void ARPUpdateEntry(NODE_INFO* Node, BOOL bCreate)
+{
+	ARP_CACHE_ENTRY* p;
+	BOOL bLearned;
+
+	p = ARPFindEntry(Node->IPAddr.Val);
+	if(p == NULL)
+	{
+		if(!bCreate)
+			return;
+
+		p = ARPAllocEntry(FALSE);
+		if(p == NULL)
+			return;
+
+		p->Node.IPAddr = Node->IPAddr;
+		p->dwLastUsed = TickGet();
+		bLearned = TRUE;
+	}
+	else
+	{
+		// Refreshing a resolved entry teaches the cache nothing new
+		bLearned = (p->vState != ARP_ENTRY_RESOLVED);
+	}
+
+	p->Node.MACAddr = Node->MACAddr;
+	p->dwUpdated = TickGet();
+	p->vState = ARP_ENTRY_RESOLVED;
+	if(bLearned)
+		CacheStats.dwLearned++;
+}
+#endif
+
 
 
 /*****************************************************************************
@@ -139,7 +311,7 @@ static BOOL ARPPut(ARP_PACKET* packet)
 	
   Description:
   	Initializes the ARP module.  Call this function once at boot to 
-  	invalidate the cached lookup.
+  	empty the ARP cache and clear its counters.
 
   Precondition:
 	None
@@ -157,14 +329,8 @@ static BOOL ARPPut(ARP_PACKET* packet)
 #ifdef STACK_CLIENT_MODE
 void ARPInit(void)
 {
-    Cache.MACAddr.v[0] = 0xff;
-    Cache.MACAddr.v[1] = 0xff;
-    Cache.MACAddr.v[2] = 0xff;
-    Cache.MACAddr.v[3] = 0xff;
-    Cache.MACAddr.v[4] = 0xff;
-    Cache.MACAddr.v[5] = 0xff;
-
-	Cache.IPAddr.Val = 0x0;
+	memset((void*)Cache, 0x00, sizeof(Cache));
+	memset((void*)&CacheStats, 0x00, sizeof(CacheStats));
 }
 #endif
 
@@ -181,6 +347,11 @@ void ARPInit(void)
   	Retrieves an ARP packet from the MAC buffer and determines if it is a
   	response to our request (in which case the ARP is resolved) or if it
   	is a request requiring our response (in which case we transmit one.)
+  	
+  	In client mode the sender is also recorded in the ARP cache.  Responses
+  	and requests addressed to us may add a new entry; any other request,
+  	including gratuitous ARP announcements, only refreshes an entry that
+  	is already cached (the RFC 826 merge rule.)
 
   Precondition:
 	ARP packet is ready in the MAC buffer.
@@ -198,6 +369,9 @@ BOOL ARPProcess(void)
 {
 	ARP_PACKET packet;
 	static NODE_INFO Target;
+#ifdef STACK_CLIENT_MODE
+	NODE_INFO Sender;
+#endif
 	static enum
 	{
 	    SM_ARP_IDLE = 0,
@@ -220,16 +394,23 @@ BOOL ARPProcess(void)
 		         return TRUE;
 		    }
 
-			// Handle incoming ARP responses
 #ifdef STACK_CLIENT_MODE
+			// Learn the sender's address.  Probes (sender 0.0.0.0) and
+			// packets claiming our own address are not recorded.
+			if(packet.SenderIPAddr.Val != 0u && packet.SenderIPAddr.Val != AppConfig.MyIPAddr.Val)
+			{
+				Sender.IPAddr = packet.SenderIPAddr;
+				Sender.MACAddr = packet.SenderMACAddr;
+				ARPUpdateEntry(&Sender, packet.Operation == ARP_OPERATION_RESP || packet.TargetIPAddr.Val == AppConfig.MyIPAddr.Val);
+			}
+
+			// Handle incoming ARP responses
 			if(packet.Operation == ARP_OPERATION_RESP)
 			{
                 #if defined(STACK_USE_AUTO_IP)
                 if (AppConfig.Flags.bConfigureAutoIP)
                     AutoIPConflict();
                 #endif
-				Cache.MACAddr = packet.SenderMACAddr;
-				Cache.IPAddr = packet.SenderIPAddr;
 				return TRUE;
 			}
 #endif
@@ -285,7 +466,10 @@ BOOL ARPProcess(void)
 	
   Description:
   	This function transmits and ARP request to determine the hardware
-  	address of a given IP address.
+  	address of a given IP address.  The address (or the gateway's, if the
+  	address is off of our subnet) is entered in the ARP cache as pending,
+  	displacing the least recently used entry if the cache is full.  No
+  	request is sent if the cache already holds a resolved entry.
 
   Precondition:
 	ARP packet is ready in the MAC buffer.
@@ -304,6 +488,7 @@ BOOL ARPProcess(void)
 void ARPResolve(IP_ADDR* IPAddr)
 {
     ARP_PACKET packet;
+	ARP_CACHE_ENTRY* p;
 
 	packet.Operation            = ARP_OPERATION_REQ;
 	packet.TargetMACAddr.v[0]   = 0xff;
@@ -317,6 +502,22 @@ void ARPResolve(IP_ADDR* IPAddr)
     // ARP query either the IP address directly (on our subnet), or do an ARP query for our Gateway if off of our subnet
 	packet.TargetIPAddr			= ((AppConfig.MyIPAddr.Val ^ IPAddr->Val) & AppConfig.MyMask.Val) ? AppConfig.MyGateway : *IPAddr;
 
+	p = ARPFindEntry(packet.TargetIPAddr.Val);
+	if(p == NULL)
+	{
+		p = ARPAllocEntry(TRUE);
+		p->Node.IPAddr = packet.TargetIPAddr;
+		p->dwLastUsed = TickGet();
+		p->vState = ARP_ENTRY_PENDING;
+	}
+	else if(p->vState == ARP_ENTRY_RESOLVED)
+	{
+		// Already known, ARPIsResolved() will answer from the cache
+		return;
+	}
+	p->dwUpdated = TickGet();
+	CacheStats.dwRequests++;
+
     ARPPut(&packet);
 }
 #endif
@@ -332,7 +533,8 @@ void ARPResolve(IP_ADDR* IPAddr)
 	
   Description:
   	This function checks if an ARP request has been resolved yet, and if
-  	so, stores the resolved MAC address in the pointer provided.
+  	so, stores the resolved MAC address in the pointer provided.  Addresses
+  	off of our subnet resolve to the gateway's MAC address.
 
   Precondition:
 	ARP packet is ready in the MAC buffer.
@@ -353,18 +555,100 @@ void ARPResolve(IP_ADDR* IPAddr)
 #ifdef STACK_CLIENT_MODE
 BOOL ARPIsResolved(IP_ADDR* IPAddr, MAC_ADDR* MACAddr)
 {
-    if((Cache.IPAddr.Val == IPAddr->Val) || 
-	  ((Cache.IPAddr.Val == AppConfig.MyGateway.Val) && ((AppConfig.MyIPAddr.Val ^ IPAddr->Val) & AppConfig.MyMask.Val)))
+	ARP_CACHE_ENTRY* p;
+
+	p = ARPFindEntry(((AppConfig.MyIPAddr.Val ^ IPAddr->Val) & AppConfig.MyMask.Val) ? AppConfig.MyGateway.Val : IPAddr->Val);
+    if(p != NULL && p->vState == ARP_ENTRY_RESOLVED)
     {
-        *MACAddr = Cache.MACAddr;
+		p->dwLastUsed = TickGet();
+        *MACAddr = p->Node.MACAddr;
+		CacheStats.dwHits++;
         return TRUE;
     }
+	CacheStats.dwMisses++;
     return FALSE;
 }
 #endif
 
 
 
+/*****************************************************************************
+  Function:
+	void ARPLearn(NODE_INFO* Node)
+
+  Summary:
+	Records the sender of a received IP packet in the ARP cache.
+	
+  Description:
+  	Called for each incoming IP packet with the source IP address and the
+  	source MAC address from the Ethernet header.  Senders on our subnet
+  	refresh their cache entry, or take a free slot if they have none, so
+  	the stack can usually answer the peer without an ARP exchange.
+  	Packets from off of our subnet carry the router's MAC address and are
+  	ignored.
+
+  Precondition:
+	None
+
+  Parameters:
+	Node - The source IP and MAC address of the received packet
+
+  Returns:
+  	None
+
+  Remarks:
+  	This function is only required when the stack is a client, and therefore
+  	is only enabled when STACK_CLIENT_MODE is enabled.
+  ***************************************************************************/
+#ifdef STACK_CLIENT_MODE
+void ARPLearn(NODE_INFO* Node)
+{
+	if((AppConfig.MyIPAddr.Val ^ Node->IPAddr.Val) & AppConfig.MyMask.Val)
+		return;
+
+	// Skip unconfigured senders, ourselves and the subnet broadcast address
+	if(Node->IPAddr.Val == 0u || Node->IPAddr.Val == AppConfig.MyIPAddr.Val || (Node->IPAddr.Val | AppConfig.MyMask.Val) == 0xFFFFFFFFu)
+		return;
+
+	ARPUpdateEntry(Node, TRUE);
+}
+#endif
+
+
+
+/*****************************************************************************
+  Function:
+	void ARPGetStats(ARP_CACHE_STATS* Stats)
+
+  Summary:
+	Reads the ARP cache counters.
+	
+  Description:
+  	Copies the hit, miss, request, learning, eviction and expiry counters
+  	accumulated since ARPInit().
+
+  Precondition:
+	ARPInit() has been called.
+
+  Parameters:
+	Stats - Buffer to receive the counters
+
+  Returns:
+  	None
+
+  Remarks:
+  	This function is only required when the stack is a client, and therefore
+  	is only enabled when STACK_CLIENT_MODE is enabled.
+  ***************************************************************************/
+#ifdef STACK_CLIENT_MODE
+void ARPGetStats(ARP_CACHE_STATS* Stats)
+{
+	memcpy((void*)Stats, (void*)&CacheStats, sizeof(CacheStats));
+}
+#endif
+
+
+
 /*****************************************************************************
   Function:
 	void SwapARPPacket(ARP_PACKET* p)
@@ -54,6 +54,12 @@
 
 #include "TCPIP Stack/TCPIP.h"
 
+#if defined(BSD_USE_RTOS)
+	#include "FreeRTOS.h"
+	#include "task.h"
+	#include "queue.h"
+#endif
+
 static BOOL HandlePossibleTCPDisconnection(SOCKET s);
 
 
@@ -67,6 +73,55 @@ static struct BSDSocket  BSDSocketArray[BSD_SOCKET_COUNT];
 
 static WORD gAutoPortNumber = 1024;
 
+#if defined(BSD_USE_RTOS)
+// Most calls from other tasks that can wait in the queue to the stack 
+// task at once.  A task has at most one call outstanding, so this is the 
+// number of tasks that use the API.
+#if !defined(BSD_REQUEST_QUEUE_LENGTH)
+	#define BSD_REQUEST_QUEUE_LENGTH	(BSD_SOCKET_COUNT)
+#endif
+
+// Berkeley API calls passed to the stack task
+typedef enum
+{
+	BSD_OP_SOCKET,
+	BSD_OP_BIND,
+	BSD_OP_LISTEN,
+	BSD_OP_ACCEPT,
+	BSD_OP_CONNECT,
+	BSD_OP_SENDTO,
+	BSD_OP_RECVFROM,
+	BSD_OP_SETSOCKOPT,
+	BSD_OP_CLOSE
+} BSD_OP;
+
+// A call made from another task.  It is kept on the calling task's stack, 
+// which blocks until the stack task has completed it.
+typedef struct _BSD_REQUEST
+{
+	struct _BSD_REQUEST *pNext;	// Next call waiting in the stack task
+	BSD_OP			Op;			// The function called
+	SOCKET			s;			// Its socket
+	int				iArg[3];	// Its other integer arguments, in order
+	void			*pArg[3];	// Its pointer arguments, in order
+	int				iSent;		// Bytes BSD_OP_SENDTO has written so far
+	int				iResult;	// The function's return value
+	BOOL			bTimed;		// FALSE to wait for the socket forever
+	DWORD			dwDeadline;	// TickGet() value at which the call times out
+	xTaskHandle		hTask;		// The calling task
+	volatile BOOL	bDone;		// Set by the stack task once iResult is valid
+} BSD_REQUEST;
+
+static xQueueHandle hRequestQueue;			// Calls not yet seen by the stack task
+static xTaskHandle hStackTask;				// The task that runs StackTask()
+static BSD_REQUEST *pWaitingHead;			// Calls waiting for their socket, oldest first
+static BSD_REQUEST *pWaitingTail;
+
+static BOOL IsOtherTask(void);
+static int CallStackTask(BSD_REQUEST *pRequest, BSD_OP Op, SOCKET s);
+static BOOL ServiceRequest(BSD_REQUEST *pRequest);
+#endif
+
 
 /*****************************************************************************
   Function:
@@ -89,7 +144,9 @@ static WORD gAutoPortNumber = 1024;
 	None
 
   Remarks:
-	None.
+	With BSD_USE_RTOS this must be called from the task that runs 
+	StackTask(), which StackInit() does.  Calls made from any other task 
+	are then passed to this one.
   ***************************************************************************/
 void BerkeleySocketInit(void)
 {
@@ -101,6 +158,17 @@ void BerkeleySocketInit(void)
 		socket             = (struct BSDSocket *)&BSDSocketArray[s];
 		socket->bsdState   = SKT_CLOSED;
 	}
+
+#if defined(BSD_USE_RTOS)
+	pWaitingHead = NULL;
+	pWaitingTail = NULL;
+	if(hRequestQueue == NULL)
+		hRequestQueue = xQueueCreate(BSD_REQUEST_QUEUE_LENGTH, sizeof(BSD_REQUEST*));
+
+	// Without the queue every call is made directly, as without an RTOS
+	if(hRequestQueue != NULL)
+		hStackTask = xTaskGetCurrentTaskHandle();
+#endif
 }
 
 /*****************************************************************************
@@ -133,6 +201,17 @@ SOCKET socket( int af, int type, int protocol )
 {
 	struct BSDSocket *socket = BSDSocketArray;
 	SOCKET s;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.iArg[0] = af;
+		Request.iArg[1] = type;
+		Request.iArg[2] = protocol;
+		return (SOCKET)CallStackTask(&Request, BSD_OP_SOCKET, INVALID_SOCKET);
+	}
+#endif
 
 	if( af != AF_INET )
 		return INVALID_SOCKET;
@@ -143,6 +222,10 @@ SOCKET socket( int af, int type, int protocol )
 			continue;
 
 		socket->SocketType = type;
+#if defined(BSD_USE_RTOS)
+		socket->sendTimeout = 0;
+		socket->recvTimeout = 0;
+#endif
 
 		if( type == SOCK_DGRAM && protocol == IPPROTO_UDP )
 		{
@@ -196,6 +279,16 @@ int bind( SOCKET s, const struct sockaddr* name, int namelen )
 	struct BSDSocket *socket;
 	struct sockaddr_in *local_addr;
 	WORD lPort;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = (void*)name;
+		Request.iArg[0] = namelen;
+		return CallStackTask(&Request, BSD_OP_BIND, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -270,6 +363,15 @@ int listen( SOCKET s, int backlog )
 	SOCKET clientSockID;
 	unsigned int socketcount;
 	unsigned char assigned;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.iArg[0] = backlog;
+		return CallStackTask(&Request, BSD_OP_LISTEN, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -309,6 +411,10 @@ int listen( SOCKET s, int backlog )
 			BSDSocketArray[socketcount].isServer = TRUE;
 			BSDSocketArray[socketcount].localPort = ps->localPort;
 			BSDSocketArray[socketcount].SocketType = SOCK_STREAM;
+#if defined(BSD_USE_RTOS)
+			BSDSocketArray[socketcount].sendTimeout = ps->sendTimeout;
+			BSDSocketArray[socketcount].recvTimeout = ps->recvTimeout;
+#endif
 			break;
 		}
 		if(!assigned)
@@ -350,7 +456,8 @@ int listen( SOCKET s, int backlog )
 	Otherwise, the value INVALID_SOCKET is returned.
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's waits until 
+	a connection is accepted or the socket's SO_RCVTIMEO passes.
   ***************************************************************************/
 SOCKET accept(SOCKET s, struct sockaddr* addr, int* addrlen)
 {
@@ -359,6 +466,16 @@ SOCKET accept(SOCKET s, struct sockaddr* addr, int* addrlen)
 	struct sockaddr_in *addrRemote;
 	unsigned int sockCount;
 	TCP_SOCKET hTCP;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = addr;
+		Request.pArg[1] = addrlen;
+		return (SOCKET)CallStackTask(&Request, BSD_OP_ACCEPT, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return INVALID_SOCKET;
@@ -439,7 +556,10 @@ SOCKET accept(SOCKET s, struct sockaddr* addr, int* addrlen)
 	established yet, connect returns SOCKET_CNXN_IN_PROGRESS.
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's for a 
+	stream socket waits until the connection is established or fails, or 
+	returns SOCKET_TIMEOUT once the socket's SO_RCVTIMEO passes.  The 
+	connection attempt carries on and connect() may be called again.
   ***************************************************************************/
 int connect( SOCKET s, struct sockaddr* name, int namelen )
 {
@@ -448,6 +568,16 @@ int connect( SOCKET s, struct sockaddr* name, int namelen )
 	DWORD remoteIP;
 	WORD remotePort;
 	WORD localPort;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = name;
+		Request.iArg[0] = namelen;
+		return CallStackTask(&Request, BSD_OP_CONNECT, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -557,7 +687,8 @@ int connect( SOCKET s, struct sockaddr* name, int namelen )
 	error, returns SOCKET_ERROR. a zero indicates no data send.
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's waits as 
+	sendto() does.
   ***************************************************************************/
 int send( SOCKET s, const char* buf, int len, int flags )
 {
@@ -595,7 +726,10 @@ int send( SOCKET s, const char* buf, int len, int flags )
 	error returns SOCKET_ERROR
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's waits for 
+	TX FIFO space until all len bytes are written and flushed.  When the 
+	socket's SO_SNDTIMEO passes it returns the bytes written so far, or 
+	SOCKET_TIMEOUT if there are none.
   ***************************************************************************/
 int sendto( SOCKET s, const char* buf, int len, int flags, const struct sockaddr* to, int tolen )
 {
@@ -605,6 +739,19 @@ int sendto( SOCKET s, const char* buf, int len, int flags, const struct sockaddr
 	static DWORD startTick;		// NOTE: startTick really should be a per socket BSDSocket structure member since other BSD calls can interfere with the ARP cycles
 	WORD wRemotePort;
 	struct sockaddr_in local;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = (void*)buf;
+		Request.iArg[0] = len;
+		Request.iArg[1] = flags;
+		Request.pArg[1] = (void*)to;
+		Request.iArg[2] = tolen;
+		return CallStackTask(&Request, BSD_OP_SENDTO, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -724,11 +871,27 @@ int sendto( SOCKET s, const char* buf, int len, int flags, const struct sockaddr
 	indicates the connection no longer exists.
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's waits until 
+	at least one byte has arrived.  It returns SOCKET_DISCONNECTED once the 
+	remote node has closed a stream socket and all its data has been read, 
+	or SOCKET_TIMEOUT when the socket's SO_RCVTIMEO passes.
   ***************************************************************************/
 int recv( SOCKET s, char* buf, int len, int flags )
 {
 	struct BSDSocket *socket;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = buf;
+		Request.iArg[0] = len;
+		Request.iArg[1] = flags;
+		Request.pArg[1] = NULL;
+		Request.pArg[2] = NULL;
+		return CallStackTask(&Request, BSD_OP_RECVFROM, s);
+	}
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -794,13 +957,30 @@ int recv( SOCKET s, char* buf, int len, int flags )
 	indicates an error condition.
 
   Remarks:
-	None.
+	With BSD_USE_RTOS, a call from a task other than the stack's waits as 
+	recv() does.
   ***************************************************************************/
 int recvfrom( SOCKET s, char* buf, int len, int flags, struct sockaddr* from, int* fromlen )
 {
 	struct BSDSocket *socket;
 	struct sockaddr_in *rem_addr;
 	SOCKET_INFO *remoteSockInfo;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.pArg[0] = buf;
+		Request.iArg[0] = len;
+		Request.iArg[1] = flags;
+		Request.pArg[1] = from;
+		Request.pArg[2] = fromlen;
+		return CallStackTask(&Request, BSD_OP_RECVFROM, s);
+	}
+#endif
+
+	if( s >= BSD_SOCKET_COUNT )
+		return SOCKET_ERROR;
 
 	socket = &BSDSocketArray[s];
 	rem_addr = (struct sockaddr_in *)from;
@@ -928,6 +1108,13 @@ int gethostname(char* name, int namelen)
 int closesocket( SOCKET s )
 {	
 	struct BSDSocket *socket;
+	BYTE i;
+#if defined(BSD_USE_RTOS)
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+		return CallStackTask(&Request, BSD_OP_CLOSE, s);
+#endif
 
 	if( s >= BSD_SOCKET_COUNT )
 		return SOCKET_ERROR;
@@ -939,17 +1126,55 @@ int closesocket( SOCKET s )
 
 	if( socket->SocketType == SOCK_STREAM)
 	{
-		if(socket->bsdState >= SKT_LISTEN)
+		if(socket->bsdState == SKT_BSD_LISTEN)
+		{
+			// Close the backlog sockets that are still waiting for a 
+			// connection along with their listener
+			for(i = 0; i < BSD_SOCKET_COUNT; i++)
+			{
+				if(BSDSocketArray[i].bsdState != SKT_LISTEN)
+					continue;
+				if(BSDSocketArray[i].localPort != socket->localPort)
+					continue;
+
+				TCPClose(BSDSocketArray[i].SocketID);
+				BSDSocketArray[i].bsdState = SKT_CLOSED;
+			}
+		}
+		else if(socket->bsdState >= SKT_LISTEN)
 		{
 			HandlePossibleTCPDisconnection(s);
 			
 			if(socket->bsdState == SKT_LISTEN)
 				return 0;
+
+			// A disconnected socket has already been closed
+			if(socket->bsdState != SKT_DISCONNECTED)
+			{
+				// Return an accepted socket to its listener's backlog 
+				// while the listener is open
+				if(socket->isServer)
+				{
+					for(i = 0; i < BSD_SOCKET_COUNT; i++)
+					{
+						if(BSDSocketArray[i].bsdState != SKT_BSD_LISTEN)
+							continue;
+						if(BSDSocketArray[i].localPort != socket->localPort)
+							continue;
+
+						TCPDisconnect(socket->SocketID);
+						socket->bsdState = SKT_LISTEN;
+						return 0;
+					}
+				}
+
+				TCPClose(socket->SocketID);
+			}
 		}
 	}
 	else //udp sockets
 	{
-		if(socket->SocketID != INVALID_UDP_SOCKET)
+		if(socket->bsdState == SKT_BOUND && socket->SocketID != INVALID_UDP_SOCKET)
 			UDPClose(socket->SocketID);
 	}
 
@@ -958,6 +1183,438 @@ int closesocket( SOCKET s )
 }
 
 
+#if defined(BSD_USE_RTOS)
+/*****************************************************************************
+  Function:
+	int setsockopt( SOCKET s, int level, int optname, const char* optval, int optlen )
+	
+  Summary:
+	Sets a socket option.
+
+  Description:
+	Sets how long calls on the socket from tasks other than the stack's 
+	wait before they return SOCKET_TIMEOUT.  SO_RCVTIMEO applies to 
+	accept(), connect(), recv() and recvfrom(), and SO_SNDTIMEO to send() 
+	and sendto().  Both are zero, to wait forever, when the socket is 
+	created.  Sockets queued by listen() take the listening socket's 
+	timeouts.
+
+  Precondition:
+	socket function should be called.
+
+  Parameters:
+	s - Socket descriptor returned from a previous call to socket.
+	level - SOL_SOCKET.
+	optname - SO_RCVTIMEO or SO_SNDTIMEO.
+	optval - pointer to a DWORD holding the timeout in milliseconds, or 
+		zero to wait forever.
+	optlen - sizeof(DWORD).
+
+  Returns:
+	If setsockopt is successful, a value of 0 is returned. 
+	A return value of SOCKET_ERROR (-1) indicates an error.
+
+  Remarks:
+	Only available with BSD_USE_RTOS.
+  ***************************************************************************/
+int setsockopt( SOCKET s, int level, int optname, const char* optval, int optlen )
+{
+	struct BSDSocket *socket;
+	DWORD dwTimeout;
+	BSD_REQUEST Request;
+
+	if(IsOtherTask())
+	{
+		Request.iArg[0] = level;
+		Request.iArg[1] = optname;
+		Request.pArg[0] = (void*)optval;
+		Request.iArg[2] = optlen;
+		return CallStackTask(&Request, BSD_OP_SETSOCKOPT, s);
+	}
+
+	if( s >= BSD_SOCKET_COUNT )
+		return SOCKET_ERROR;
+
+	socket = &BSDSocketArray[s];
+
+	if(socket->bsdState == SKT_CLOSED)
+		return SOCKET_ERROR;
+
+	if(level != SOL_SOCKET || optval == NULL || (unsigned int)optlen < sizeof(DWORD))
+		return SOCKET_ERROR;
+
+	// Round up so that any timeout lasts at least a tick
+	memcpy((void*)&dwTimeout, (void*)optval, sizeof(dwTimeout));
+	dwTimeout = (DWORD)(((QWORD)dwTimeout * TICK_SECOND + 999u) / 1000u);
+
+	switch(optname)
+	{
+		case SO_SNDTIMEO:
+			socket->sendTimeout = dwTimeout;
+			return 0;
+
+		case SO_RCVTIMEO:
+			socket->recvTimeout = dwTimeout;
+			return 0;
+
+		default:
+			return SOCKET_ERROR;
+	}
+}
+
+/*****************************************************************************
+  Function:
+	void BerkeleySocketTask(void)
+	
+  Summary:
+	Carries out the Berkeley API calls made by other tasks.
+
+  Description:
+	Takes the calls other tasks have queued and makes each of them.  A 
+	call that would have to wait for its socket - accept() with no 
+	connection, connect() still in progress, recv() with no data, or send() 
+	with a full TX FIFO - is kept and made again on later passes, in the 
+	order the calls were made, until it completes or times out.  The 
+	calling task is then notified with the result.
+
+  Precondition:
+	BerkeleySocketInit function should be called.
+
+  Parameters:
+	None.
+
+  Returns:
+	None.
+
+  Remarks:
+	Called by StackApplications() from the stack task, which sleeps until 
+	the next packet or BerkeleyGetNextEvent().  Other tasks wake it as they 
+	queue a call.
+  ***************************************************************************/
+void BerkeleySocketTask(void)
+{
+	BSD_REQUEST *pRequest;
+	BSD_REQUEST *pPrevious;
+	BSD_REQUEST *pNext;
+	xTaskHandle hTask;
+	DWORD dwTimeout;
+
+	if(hRequestQueue == NULL)
+		return;
+
+	// Add the calls made since the last pass to the waiting list
+	while(xQueueReceive(hRequestQueue, &pRequest, 0) == pdTRUE)
+	{
+		pRequest->pNext = NULL;
+		pRequest->iSent = 0;
+		pRequest->bTimed = FALSE;
+		if(pRequest->s < BSD_SOCKET_COUNT)
+		{
+			if(pRequest->Op == BSD_OP_SENDTO)
+				dwTimeout = BSDSocketArray[pRequest->s].sendTimeout;
+			else
+				dwTimeout = BSDSocketArray[pRequest->s].recvTimeout;
+
+			if(dwTimeout != 0u)
+			{
+				pRequest->bTimed = TRUE;
+				pRequest->dwDeadline = TickGet() + dwTimeout;
+			}
+		}
+
+		if(pWaitingTail == NULL)
+			pWaitingHead = pRequest;
+		else
+			pWaitingTail->pNext = pRequest;
+		pWaitingTail = pRequest;
+	}
+
+	// Make each call again and release the callers of those that are done
+	pPrevious = NULL;
+	for(pRequest = pWaitingHead; pRequest != NULL; pRequest = pNext)
+	{
+		pNext = pRequest->pNext;
+		if(!ServiceRequest(pRequest))
+		{
+			pPrevious = pRequest;
+			continue;
+		}
+
+		if(pPrevious == NULL)
+			pWaitingHead = pNext;
+		else
+			pPrevious->pNext = pNext;
+		if(pWaitingTail == pRequest)
+			pWaitingTail = pPrevious;
+
+		// The caller may return as soon as bDone is set, taking the 
+		// request with it
+		hTask = pRequest->hTask;
+		pRequest->bDone = TRUE;
+		xTaskNotifyGive(hTask);
+	}
+}
+
+/*****************************************************************************
+  Function:
+	DWORD BerkeleyGetNextEvent(void)
+	
+  Summary:
+	Determines how long until BerkeleySocketTask() next has work to do.
+
+  Description:
+	Returns the time until the earliest timeout among the calls waiting 
+	for their sockets.  Everything else the waiting calls depend on 
+	arrives as a packet or is paced by TCPGetNextEvent(), so a task 
+	driving the stack can sleep until the earlier of the two.
+
+  Precondition:
+	BerkeleySocketInit function should be called.
+
+  Parameters:
+	None.
+
+  Returns:
+	Ticks until BerkeleySocketTask() should next be called, 0 if it has 
+	work to do now, or TCP_NO_EVENT if no call is waiting with a timeout.
+  ***************************************************************************/
+DWORD BerkeleyGetNextEvent(void)
+{
+	BSD_REQUEST *pRequest;
+	DWORD dwNext;
+	DWORD dwNow;
+	LONG lTicks;
+
+	if(hRequestQueue == NULL)
+		return TCP_NO_EVENT;
+
+	if(uxQueueMessagesWaiting(hRequestQueue) != 0u)
+		return 0;
+
+	dwNext = TCP_NO_EVENT;
+	dwNow = TickGet();
+	for(pRequest = pWaitingHead; pRequest != NULL; pRequest = pRequest->pNext)
+	{
+		if(!pRequest->bTimed)
+			continue;
+
+		lTicks = (LONG)(pRequest->dwDeadline - dwNow);
+		if(lTicks <= 0)
+			return 0;
+		if((DWORD)lTicks < dwNext)
+			dwNext = (DWORD)lTicks;
+	}
+
+	return dwNext;
+}
+
+/*****************************************************************************
+  Function:
+	static BOOL IsOtherTask(void)
+	
+  Summary:
+	Internal function that checks whether a call must be passed to the 
+	stack task.
+
+  Precondition:
+	None.
+
+  Parameters:
+	None.
+
+  Returns:
+	TRUE - The caller is not the stack task
+	FALSE - The caller is the stack task, or BerkeleySocketInit() has not 
+		set it up yet
+  ***************************************************************************/
+static BOOL IsOtherTask(void)
+{
+	return hStackTask != NULL && xTaskGetCurrentTaskHandle() != hStackTask;
+}
+
+/*****************************************************************************
+  Function:
+	static int CallStackTask(BSD_REQUEST *pRequest, BSD_OP Op, SOCKET s)
+	
+  Summary:
+	Internal function that passes a call to the stack task and waits for 
+	its result.
+
+  Precondition:
+	IsOtherTask() is TRUE and the call's arguments are in pRequest.
+
+  Parameters:
+	pRequest - The request, on the caller's stack
+	Op - The function called
+	s - Its socket
+
+  Returns:
+	The function's return value.
+
+  Remarks:
+	The stack task completes every call, timing it out itself, so the 
+	request is never abandoned while the stack task still holds it.
+  ***************************************************************************/
+static int CallStackTask(BSD_REQUEST *pRequest, BSD_OP Op, SOCKET s)
+{
+	pRequest->Op = Op;
+	pRequest->s = s;
+	pRequest->hTask = xTaskGetCurrentTaskHandle();
+	pRequest->bDone = FALSE;
+
+	xQueueSend(hRequestQueue, &pRequest, portMAX_DELAY);
+	xTaskNotifyGive(hStackTask);
+
+	// A notification left over from an earlier call only costs a pass 
+	// round the loop
+	while(!pRequest->bDone)
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	return pRequest->iResult;
+}
+
+/*****************************************************************************
+  Function:
+	static BOOL ServiceRequest(BSD_REQUEST *pRequest)
+	
+  Summary:
+	Internal function that makes a call for another task.
+
+  Precondition:
+	Called from the stack task.
+
+  Parameters:
+	pRequest - The call
+
+  Returns:
+	TRUE - The call is done and pRequest->iResult holds its return value
+	FALSE - The call is waiting for its socket
+  ***************************************************************************/
+static BOOL ServiceRequest(BSD_REQUEST *pRequest)
+{
+	struct BSDSocket *pSocket;
+	int iResult;
+
+	if(pRequest->Op == BSD_OP_SOCKET)
+	{
+		pRequest->iResult = socket(pRequest->iArg[0], pRequest->iArg[1], pRequest->iArg[2]);
+		return TRUE;
+	}
+
+	if(pRequest->s >= BSD_SOCKET_COUNT)
+	{
+		pRequest->iResult = (pRequest->Op == BSD_OP_ACCEPT) ? INVALID_SOCKET : SOCKET_ERROR;
+		return TRUE;
+	}
+	pSocket = &BSDSocketArray[pRequest->s];
+
+	switch(pRequest->Op)
+	{
+		case BSD_OP_BIND:
+			pRequest->iResult = bind(pRequest->s, (struct sockaddr*)pRequest->pArg[0], pRequest->iArg[0]);
+			return TRUE;
+
+		case BSD_OP_LISTEN:
+			pRequest->iResult = listen(pRequest->s, pRequest->iArg[0]);
+			return TRUE;
+
+		case BSD_OP_SETSOCKOPT:
+			pRequest->iResult = setsockopt(pRequest->s, pRequest->iArg[0], pRequest->iArg[1], 
+				(const char*)pRequest->pArg[0], pRequest->iArg[2]);
+			return TRUE;
+
+		case BSD_OP_CLOSE:
+			pRequest->iResult = closesocket(pRequest->s);
+			return TRUE;
+
+		case BSD_OP_ACCEPT:
+			pRequest->iResult = accept(pRequest->s, (struct sockaddr*)pRequest->pArg[0], (int*)pRequest->pArg[1]);
+			if(pRequest->iResult != INVALID_SOCKET || pSocket->bsdState != SKT_BSD_LISTEN)
+				return TRUE;
+			break;
+
+		case BSD_OP_CONNECT:
+			pRequest->iResult = connect(pRequest->s, (struct sockaddr*)pRequest->pArg[0], pRequest->iArg[0]);
+			if(pRequest->iResult != SOCKET_CNXN_IN_PROGRESS)
+				return TRUE;
+			break;
+
+		case BSD_OP_RECVFROM:
+			pRequest->iResult = recvfrom(pRequest->s, (char*)pRequest->pArg[0], pRequest->iArg[0], 
+				pRequest->iArg[1], (struct sockaddr*)pRequest->pArg[1], (int*)pRequest->pArg[2]);
+			if(pRequest->iResult != 0 || pRequest->iArg[0] == 0)
+				return TRUE;
+
+			// Nothing will arrive on a datagram socket that is not bound, or 
+			// on a connection the remote node has closed
+			if(pSocket->SocketType == SOCK_DGRAM)
+			{
+				if(pSocket->bsdState != SKT_BOUND)
+				{
+					pRequest->iResult = SOCKET_ERROR;
+					return TRUE;
+				}
+			}
+			else if(!TCPIsConnected(pSocket->SocketID))
+			{
+				pRequest->iResult = SOCKET_DISCONNECTED;
+				return TRUE;
+			}
+			break;
+
+		case BSD_OP_SENDTO:
+			iResult = sendto(pRequest->s, (const char*)pRequest->pArg[0] + pRequest->iSent, 
+				pRequest->iArg[0] - pRequest->iSent, pRequest->iArg[1], 
+				(const struct sockaddr*)pRequest->pArg[1], pRequest->iArg[2]);
+			if(pSocket->SocketType == SOCK_DGRAM)
+			{
+				// An error other than a closed socket or a bad address is 
+				// the ARP lookup or the MAC not being ready yet
+				pRequest->iResult = iResult;
+				if(iResult != SOCKET_ERROR || pSocket->bsdState == SKT_CLOSED)
+					return TRUE;
+				if(pRequest->pArg[1] && (unsigned int)pRequest->iArg[2] != sizeof(struct sockaddr_in))
+					return TRUE;
+				break;
+			}
+
+			if(iResult > 0)
+			{
+				// Send what there is now rather than when TCPTick() next 
+				// transmits, as the caller is waiting on a full FIFO or for 
+				// a reply
+				pRequest->iSent += iResult;
+				TCPFlush(pSocket->SocketID);
+			}
+			else if(iResult == SOCKET_ERROR && pSocket->bsdState != SKT_EST)
+			{
+				// The connection has gone
+				pRequest->iResult = pRequest->iSent ? pRequest->iSent : SOCKET_ERROR;
+				return TRUE;
+			}
+
+			pRequest->iResult = pRequest->iSent;
+			if(pRequest->iSent >= pRequest->iArg[0])
+				return TRUE;
+			break;
+
+		default:
+			pRequest->iResult = SOCKET_ERROR;
+			return TRUE;
+	}
+
+	// Still waiting for the socket
+	if(!pRequest->bTimed || (LONG)(TickGet() - pRequest->dwDeadline) < 0)
+		return FALSE;
+
+	if(pRequest->Op == BSD_OP_ACCEPT)
+		pRequest->iResult = INVALID_SOCKET;
+	else if(pRequest->Op != BSD_OP_SENDTO || pRequest->iSent == 0)
+		pRequest->iResult = SOCKET_TIMEOUT;
+	return TRUE;
+}
+#endif //BSD_USE_RTOS
+
 /*****************************************************************************
   Function:
 	static BOOL HandlePossibleTCPDisconnection(SOCKET s)
@@ -983,6 +983,129 @@ void BigIntCopyROM(BIGINT *a, BIGINT_ROM *b)
 }
 #endif	//#if defined(__18CXX)
 
+/*********************************************************************
+ * Function:        BIGINT_DATA_TYPE BigIntMontgomeryInverse(BIGINT *m)
+ *
+ * PreCondition:    m is odd
+ *
+ * Input:           *m: a pointer to the modulus
+ *
+ * Output:          -1/m modulo 2^BIGINT_DATA_SIZE, for
+ *					BigIntMontgomeryMultiply()
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Each Newton iteration doubles the number of correct
+ *					low bits of the inverse, starting from the 3 that
+ *					m's least significant word gives for itself.
+ *
+ * Note:            None
+ ********************************************************************/
+#if defined(BI_USE_MONTGOMERY)
+BIGINT_DATA_TYPE BigIntMontgomeryInverse(BIGINT *m)
+{
+	BIGINT_DATA_TYPE m0, x;
+	BYTE i;
+
+	m0 = *m->ptrLSB;
+	x = m0;
+	for(i = 0; i < 5u; i++)
+		x = x * (BIGINT_DATA_TYPE)(2u - m0 * x);
+
+	return (BIGINT_DATA_TYPE)(0u - x);
+}
+#endif
+
+/*********************************************************************
+ * Function:        void BigIntMontgomeryMultiply(BIGINT *a, BIGINT *b,
+ *						BIGINT *m, BIGINT_DATA_TYPE mInv, BIGINT *res)
+ *
+ * PreCondition:    a, b and res have as many words as m, which is odd;
+ *					a < m, b < m, &res != &[a|b|m]
+ *
+ * Input:           *a: a pointer to the first number
+ *					*b: a pointer to the second number
+ *					*m: a pointer to the modulus
+ *					mInv: BigIntMontgomeryInverse(m)
+ *					*res: a pointer to memory to store the result
+ *
+ * Output:          *res = a * b / R mod m, where R is 2 to the power of
+ *					the bits in m's words
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Multiplies in Montgomery form, where x is held as
+ *					xR mod m.  A product then needs no division: a
+ *					multiple of m that clears the low word is added as
+ *					each word of b is multiplied in, and the word is
+ *					shifted out.
+ *
+ * Note:            Interleaves the multiplication and reduction (CIOS),
+ *					so only two words are needed above res.  a may be
+ *					the same as b for squaring.
+ ********************************************************************/
+#if defined(BI_USE_MONTGOMERY)
+void BigIntMontgomeryMultiply(BIGINT *a, BIGINT *b, BIGINT *m, BIGINT_DATA_TYPE mInv, BIGINT *res)
+{
+	BIGINT_DATA_TYPE *pa, *pb, *pm, *pr;
+	BIGINT_DATA_TYPE u, bi, top, top2;
+	BIGINT_DATA_TYPE_2 t;
+	WORD i, j, n;
+
+	n = m->ptrMSBMax - m->ptrLSB + 1;
+	pa = a->ptrLSB;
+	pb = b->ptrLSB;
+	pm = m->ptrLSB;
+	pr = res->ptrLSB;
+
+	for(j = 0; j < n; j++)
+		pr[j] = 0;
+	top = 0;
+
+	for(i = 0; i < n; i++)
+	{
+		// res += a * b[i]
+		bi = pb[i];
+		t = 0;
+		for(j = 0; j < n; j++)
+		{
+			t = (BIGINT_DATA_TYPE_2)pa[j] * bi + pr[j] + (t >> BIGINT_DATA_SIZE);
+			pr[j] = (BIGINT_DATA_TYPE)t;
+		}
+		t = (BIGINT_DATA_TYPE_2)top + (t >> BIGINT_DATA_SIZE);
+		top = (BIGINT_DATA_TYPE)t;
+		top2 = (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE);
+
+		// res = (res + u * m) / 2^BIGINT_DATA_SIZE
+		u = pr[0] * mInv;
+		t = (BIGINT_DATA_TYPE_2)pm[0] * u + pr[0];
+		for(j = 1; j < n; j++)
+		{
+			t = (BIGINT_DATA_TYPE_2)pm[j] * u + pr[j] + (t >> BIGINT_DATA_SIZE);
+			pr[j - 1] = (BIGINT_DATA_TYPE)t;
+		}
+		t = (BIGINT_DATA_TYPE_2)top + (t >> BIGINT_DATA_SIZE);
+		pr[n - 1] = (BIGINT_DATA_TYPE)t;
+		top = top2 + (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE);
+	}
+
+	// The result is below 2m, so at most one m is taken off
+	res->bMSBValid = 0;
+	if(top != 0u || BigIntCompare(res, m) >= 0)
+	{
+		u = 0;
+		for(j = 0; j < n; j++)
+		{
+			// u is the borrow
+			t = (BIGINT_DATA_TYPE_2)pr[j] - pm[j] - u;
+			pr[j] = (BIGINT_DATA_TYPE)t;
+			u = (BIGINT_DATA_TYPE)(t >> BIGINT_DATA_SIZE) & 1u;
+		}
+		res->bMSBValid = 0;
+	}
+}
+#endif
+
 /*********************************************************************
  * Function:        void BigIntSwapEndianness(BIGINT *a)
  *
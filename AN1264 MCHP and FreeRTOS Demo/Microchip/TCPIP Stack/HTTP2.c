@@ -87,6 +87,7 @@
 	    "jpg",          // HTTP_JPG
 	    "cla",          // HTTP_JAVA
 	    "wav",          // HTTP_WAV
+	    "sse",          // HTTP_SSE
 		"\0\0\0"		// HTTP_UNKNOWN
 	};
 	
@@ -104,6 +105,7 @@
 	    "image/jpeg",            // HTTP_JPG
 	    "application/java-vm",   // HTTP_JAVA
 	    "audio/x-wave",          // HTTP_WAV
+	    "text/event-stream",     // HTTP_SSE
 		""						 // HTTP_UNKNOWN
 	};
 		
@@ -115,8 +117,8 @@
 	// Initial response strings (Corresponding to HTTP_STATUS)
 	static ROM char * ROM HTTPResponseHeaders[] =
 	{
-		"HTTP/1.1 200 OK\r\nConnection: close\r\n",
-		"HTTP/1.1 200 OK\r\nConnection: close\r\n",
+		"HTTP/1.1 200 OK\r\n",
+		"HTTP/1.1 200 OK\r\n",
 		"HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n400 Bad Request: can't handle Content-Length\r\n",
 		"HTTP/1.1 401 Unauthorized\r\nWWW-Authenticate: Basic realm=\"Protected\"\r\nConnection: close\r\n\r\n401 Unauthorized: Password required\r\n",
 		#if defined(HTTP_MPFS_UPLOAD)
@@ -134,7 +136,8 @@
 		"HTTP/1.1 500 Internal Server Error\r\nConnection: close\r\nContent-Type: text/html\r\n\r\n<html><body style=\"margin:100px\"><b>MPFS Image Corrupt or Wrong Version</b><p><a href=\"/" HTTP_MPFS_UPLOAD "\">Try again?</a></body></html>",
 		#endif
 		"HTTP/1.1 302 Found\r\nConnection: close\r\nLocation: ",
-		"HTTP/1.1 403 Forbidden\r\nConnection: close\r\n\r\n403 Forbidden: SSL Required - use HTTPS\r\n"
+		"HTTP/1.1 403 Forbidden\r\nConnection: close\r\n\r\n403 Forbidden: SSL Required - use HTTPS\r\n",
+		"HTTP/1.1 304 Not Modified\r\n"
 	};
 	
 /****************************************************************************
@@ -147,11 +150,14 @@
 	{
 		"Cookie:",
 		"Authorization:",
-		"Content-Length:"
+		"Content-Length:",
+		"Connection:",
+		"If-None-Match:",
+		"If-Modified-Since:"
 	};
 	
 	// Set to length of longest string above
-	#define HTTP_MAX_HEADER_LEN		(15u)
+	#define HTTP_MAX_HEADER_LEN		(18u)
 
 /****************************************************************************
   Section:
@@ -182,10 +188,18 @@
 	static void HTTPHeaderParseContentLength(void);
 	static HTTP_READ_STATUS HTTPReadTo(BYTE delim, BYTE* buf, WORD len);
 	#endif
+	static void HTTPHeaderParseConnection(void);
+	static void HTTPHeaderParseIfNoneMatch(void);
+	static void HTTPHeaderParseIfModifiedSince(void);
 	
 	static void HTTPProcess(void);
 	static BOOL HTTPSendFile(void);
 	static void HTTPLoadConn(BYTE hHTTP);
+	static BOOL HTTPGrowRxFIFO(void);
+	static BYTE HTTPFormatChunkHeader(BYTE* cHeader, WORD wLen);
+	static BYTE HTTPFormatETag(BYTE* cETag);
+	static BYTE HTTPFormatDate(DWORD dwTime, BYTE* cDate);
+	static void HTTPPutValidators(void);
 
 	#if defined(HTTP_MPFS_UPLOAD)
 	static HTTP_IO_RESULT HTTPMPFSUpload(void);
@@ -401,13 +415,23 @@ static void HTTPProcess(void)
 				curHTTP.callbackID = TickGet() + HTTP_TIMEOUT*TICK_SECOND;
 				curHTTP.callbackPos = 0xffffffff;
 				curHTTP.byteCount = 0;
+				curHTTP.flags.bKeepAlive = 1;
+				curHTTP.flags.bHTTP10 = 0;
+				curHTTP.flags.bChunked = 0;
+				curHTTP.flags.bChunkSent = 0;
+				curHTTP.flags.bNoneMatch = 0;
+				curHTTP.flags.bNotModified = 0;
 				#if defined(HTTP_USE_POST)
 				curHTTP.smPost = 0x00;
 				#endif
 				
 				// Adjust the TCP FIFOs for optimal reception of 
-				// the next HTTP request from the browser
-				TCPAdjustFIFOSize(sktHTTP, 1, 0, TCP_ADJUST_PRESERVE_RX | TCP_ADJUST_GIVE_REST_TO_RX);
+				// the next HTTP request from the browser.  Resizing 
+				// drops any TX data, so a request pipelined behind an
+				// unacknowledged response is read with the FIFOs as
+				// they are.
+				if(TCPGetTxFIFOFull(sktHTTP) == 0u)
+					TCPAdjustFIFOSize(sktHTTP, 1, HTTP_KEEPALIVE_FIFO, TCP_ADJUST_PRESERVE_RX | TCP_ADJUST_GIVE_REST_TO_RX);
  			}
  			else
  				// Don't break for new connections.  There may be 
@@ -419,7 +443,7 @@ static void HTTPProcess(void)
 			// Verify the entire first line is in the FIFO
 			if(TCPFind(sktHTTP, '\n', 0, FALSE) == 0xffff)
 			{// First line isn't here yet
-				if(TCPGetRxFIFOFree(sktHTTP) == 0u)
+				if(TCPGetRxFIFOFree(sktHTTP) == 0u && !HTTPGrowRxFIFO())
 				{// If the FIFO is full, we overflowed
 					curHTTP.httpStatus = HTTP_OVERFLOW;
 					smHTTP = SM_HTTP_SERVE_HEADERS;
@@ -428,6 +452,7 @@ static void HTTPProcess(void)
 				if((LONG)(TickGet() - curHTTP.callbackID) > (LONG)0)
 				{// A timeout has occurred
 					TCPDisconnect(sktHTTP);
+					curHTTP.flags.bKeepAlive = 0;
 					smHTTP = SM_HTTP_DISCONNECT;
 					isDone = FALSE;
 				}
@@ -572,8 +597,14 @@ static void HTTPProcess(void)
 
 			}
 
-			// Clear the rest of the line
+			// Clear the rest of the line.  HTTP/1.0 clients expect the
+			// connection to close unless they ask otherwise.
 			lenA = TCPFind(sktHTTP, '\n', 0, FALSE);
+			if(TCPFindROMArrayEx(sktHTTP, (ROM BYTE*)"HTTP/1.0", 8, 0, lenA, FALSE) != 0xffff)
+			{
+				curHTTP.flags.bHTTP10 = 1;
+				curHTTP.flags.bKeepAlive = 0;
+			}
 			TCPGetArray(sktHTTP, NULL, lenA + 1);
 
 			// Move to parsing the headers
@@ -590,7 +621,7 @@ static void HTTPProcess(void)
 				lenA = TCPFind(sktHTTP, '\n', 0, FALSE);
 				if(lenA == 0xffff)
 				{// If not, make sure we can receive more data
-					if(TCPGetRxFIFOFree(sktHTTP) == 0u)
+					if(TCPGetRxFIFOFree(sktHTTP) == 0u && !HTTPGrowRxFIFO())
 					{// Overflow
 						curHTTP.httpStatus = HTTP_OVERFLOW;
 						smHTTP = SM_HTTP_SERVE_HEADERS;
@@ -599,6 +630,7 @@ static void HTTPProcess(void)
 					if((LONG)(TickGet() - curHTTP.callbackID) > (LONG)0)
 					{// A timeout has occured
 						TCPDisconnect(sktHTTP);
+						curHTTP.flags.bKeepAlive = 0;
 						smHTTP = SM_HTTP_DISCONNECT;
 						isDone = FALSE;
 					}
@@ -716,6 +748,7 @@ static void HTTPProcess(void)
 				if((LONG)(TickGet() - curHTTP.callbackID) > (LONG)0)
 				{// If a timeout has occured, disconnect
 					TCPDisconnect(sktHTTP);
+					curHTTP.flags.bKeepAlive = 0;
 					smHTTP = SM_HTTP_DISCONNECT;
 					isDone = FALSE;
 					break;
@@ -768,7 +801,10 @@ static void HTTPProcess(void)
 			}
 			#endif
 
-			// We're done with POST
+			// We're done with POST.  Any of it left unread would be 
+			// taken for the next request, so then the connection closes.
+			if(curHTTP.byteCount != 0u)
+				curHTTP.flags.bKeepAlive = 0;
 			smHTTP = SM_HTTP_PROCESS_REQUEST;
 			// No break, continue to sending request
 
@@ -783,6 +819,13 @@ static void HTTPProcess(void)
                 break;
             }
 
+			// A static file the client already has is not read again
+			if(curHTTP.flags.bNotModified && curHTTP.httpStatus == HTTP_GET && 
+				curHTTP.offsets == MPFS_INVALID_HANDLE)
+			{
+				curHTTP.httpStatus = HTTP_NOT_MODIFIED;
+			}
+
 			// Set up the dynamic substitutions
 			curHTTP.byteCount = 0;
 			if(curHTTP.offsets == MPFS_INVALID_HANDLE)
@@ -799,10 +842,41 @@ static void HTTPProcess(void)
 
 		case SM_HTTP_SERVE_HEADERS:
 
+			// A response to a pipelined request waits for the one before
+			// it to be acknowledged, so that the FIFOs can be resized and
+			// the headers always fit
+			if(TCPGetTxFIFOFull(sktHTTP) != 0u)
+				break;
+
+			// Only GET, POST and 304 responses can be followed by another
+			// request.  A dynamic page's length is not known until it
+			// has been sent, so on a persistent connection it goes in 
+			// chunks, which HTTP/1.0 clients do not understand.
+			if(curHTTP.httpStatus != HTTP_GET && curHTTP.httpStatus != HTTP_POST &&
+				curHTTP.httpStatus != HTTP_NOT_MODIFIED)
+			{
+				curHTTP.flags.bKeepAlive = 0;
+			}
+			else if(curHTTP.nextCallback != 0xffffffff)
+			{
+				if(curHTTP.flags.bHTTP10)
+					curHTTP.flags.bKeepAlive = 0;
+				#if defined(STACK_USE_SSL_SERVER)
+				if(TCPIsSSL(sktHTTP))
+					curHTTP.flags.bKeepAlive = 0;
+				#endif
+				curHTTP.flags.bChunked = curHTTP.flags.bKeepAlive;
+			}
+
 			// We're in write mode now:
 			// Adjust the TCP FIFOs for optimal transmission of 
-			// the HTTP response to the browser
-			TCPAdjustFIFOSize(sktHTTP, 1, 0, TCP_ADJUST_GIVE_REST_TO_TX);
+			// the HTTP response to the browser.  A persistent connection
+			// keeps some RX FIFO for the next request and any pipelined
+			// request already received.
+			if(curHTTP.flags.bKeepAlive)
+				TCPAdjustFIFOSize(sktHTTP, HTTP_KEEPALIVE_FIFO, 0, TCP_ADJUST_GIVE_REST_TO_TX | TCP_ADJUST_PRESERVE_RX);
+			else
+				TCPAdjustFIFOSize(sktHTTP, 1, 0, TCP_ADJUST_GIVE_REST_TO_TX);
 				
 			// Send headers
 			TCPPutROMString(sktHTTP, (ROM BYTE*)HTTPResponseHeaders[curHTTP.httpStatus]);
@@ -816,13 +890,33 @@ static void HTTPProcess(void)
 				TCPPutROMString(sktHTTP, (ROM BYTE*)HTTP_CRLF);
 			}
 
-			// If not GET or POST, we're done
-			if(curHTTP.httpStatus != HTTP_GET && curHTTP.httpStatus != HTTP_POST)
+			// If not GET, POST or 304, we're done
+			if(curHTTP.httpStatus != HTTP_GET && curHTTP.httpStatus != HTTP_POST &&
+				curHTTP.httpStatus != HTTP_NOT_MODIFIED)
 			{// Disconnect
 				smHTTP = SM_HTTP_DISCONNECT;
 				break;
 			}
 
+			// Say when the connection differs from the client's default
+			if(!curHTTP.flags.bKeepAlive)
+				TCPPutROMString(sktHTTP, (ROM BYTE*)"Connection: close\r\n");
+			else if(curHTTP.flags.bHTTP10)
+				TCPPutROMString(sktHTTP, (ROM BYTE*)"Connection: keep-alive\r\n");
+
+			// A 304 repeats the validators and freshness, with no body
+			if(curHTTP.httpStatus == HTTP_NOT_MODIFIED)
+			{
+				HTTPPutValidators();
+				TCPPutROMString(sktHTTP, (ROM BYTE*)"Cache-Control: max-age=");
+				TCPPutROMString(sktHTTP, (ROM BYTE*)HTTP_CACHE_LEN);
+				TCPPutROMString(sktHTTP, HTTP_CRLF);
+				TCPPutROMString(sktHTTP, HTTP_CRLF);
+				smHTTP = SM_HTTP_DISCONNECT;
+				isDone = FALSE;
+				break;
+			}
+
 			// Output the content type, if known
 			if(curHTTP.fileType != HTTP_UNKNOWN)
 			{
@@ -836,6 +930,19 @@ static void HTTPProcess(void)
 			{
 				TCPPutROMString(sktHTTP, (ROM BYTE*)"Content-Encoding: gzip\r\n");
 			}
+
+			// Output the length of a static page, or chunk a dynamic one
+			if(curHTTP.flags.bChunked)
+			{
+				TCPPutROMString(sktHTTP, (ROM BYTE*)"Transfer-Encoding: chunked\r\n");
+			}
+			else if(curHTTP.nextCallback == 0xffffffff)
+			{
+				TCPPutROMString(sktHTTP, (ROM BYTE*)"Content-Length: ");
+				ultoa(MPFSGetSize(curHTTP.file), buffer);
+				TCPPutString(sktHTTP, buffer);
+				TCPPutROMString(sktHTTP, HTTP_CRLF);
+			}
 						
 			// Output the cache-control
 			TCPPutROMString(sktHTTP, (ROM BYTE*)"Cache-Control: ");
@@ -849,6 +956,10 @@ static void HTTPProcess(void)
 				TCPPutROMString(sktHTTP, (ROM BYTE*)HTTP_CACHE_LEN);
 			}
 			TCPPutROMString(sktHTTP, HTTP_CRLF);
+
+			// Let the client revalidate a static file once it expires
+			if(curHTTP.httpStatus == HTTP_GET && curHTTP.nextCallback == 0xffffffff)
+				HTTPPutValidators();
 			
 			// Check if we should output cookies
 			if(curHTTP.hasArgs)
@@ -924,10 +1035,20 @@ static void HTTPProcess(void)
 			// Try to send next packet
 			if(HTTPSendFile())
 			{// If EOF, then we're done so close and disconnect
+				if(curHTTP.flags.bChunked)
+				{// A chunked body ends with an empty chunk
+					if(TCPIsPutReady(sktHTTP) < 7u)
+					{
+						isDone = TRUE;
+						break;
+					}
+					if(curHTTP.flags.bChunkSent)
+						TCPPutROMString(sktHTTP, HTTP_CRLF);
+					TCPPutROMString(sktHTTP, (ROM BYTE*)"0\r\n\r\n");
+				}
 				MPFSClose(curHTTP.file);
 				curHTTP.file = MPFS_INVALID_HANDLE;
 				smHTTP = SM_HTTP_DISCONNECT;
-				isDone = TRUE;
 			}
 			
 			// If the TX FIFO is full, then return to main app loop
@@ -940,17 +1061,46 @@ static void HTTPProcess(void)
 			isDone = TRUE;
 
 			// Check that at least the minimum bytes are free
-			if(TCPIsPutReady(sktHTTP) < HTTP_MIN_CALLBACK_FREE)
+			if(TCPIsPutReady(sktHTTP) < HTTP_MIN_CALLBACK_FREE + (curHTTP.flags.bChunked ? 8u : 0u))
 				break;
 
-			// Fill TX FIFO from callback
-			HTTPPrint(curHTTP.callbackID);
+			// Fill TX FIFO from callback.  Its output is a chunk whose 
+			// length is only known afterwards, so the chunk header is
+			// reserved first and filled in, or dropped if nothing was
+			// written.
+			if(curHTTP.flags.bChunked)
+			{
+				lenB = HTTPFormatChunkHeader(buffer, 0);
+				TCPReserveHeader(sktHTTP, lenB);
+				lenA = TCPIsPutReady(sktHTTP);
+				HTTPPrint(curHTTP.callbackID);
+				lenA -= TCPIsPutReady(sktHTTP);
+				if(lenA == 0u)
+				{
+					TCPPutHeader(sktHTTP, NULL, lenB, 0);
+				}
+				else
+				{
+					HTTPFormatChunkHeader(buffer, lenA);
+					TCPPutHeader(sktHTTP, buffer, lenB, lenA);
+					curHTTP.flags.bChunkSent = 1;
+				}
+			}
+			else
+			{
+				HTTPPrint(curHTTP.callbackID);
+			}
 			
 			if(curHTTP.callbackPos == 0u)
 			{// Callback finished its output, so move on
 				isDone = FALSE;
 				smHTTP = SM_HTTP_SERVE_BODY;
 			}// Otherwise, callback needs more buffer space, so return and wait
+			else
+			{// Send what it has so far, as an event stream's callback
+			 // waits here for the next event
+				TCPFlush(sktHTTP);
+			}
 			
 			break;
 
@@ -967,9 +1117,35 @@ static void HTTPProcess(void)
 				curHTTP.offsets = MPFS_INVALID_HANDLE;
 			}
 
+			// A persistent connection waits for the next request, 
+			// which may already have arrived
+			if(curHTTP.flags.bKeepAlive)
+			{
+				TCPFlush(sktHTTP);
+				curHTTP.callbackID = TickGet() + HTTP_KEEPALIVE_TIMEOUT*TICK_SECOND;
+				smHTTP = SM_HTTP_KEEPALIVE;
+				isDone = FALSE;
+				break;
+			}
+
 			TCPDisconnect(sktHTTP);
             smHTTP = SM_HTTP_IDLE;
             break;
+
+		case SM_HTTP_KEEPALIVE:
+			// Begin the next request, or close the connection once it
+			// has been idle too long
+			if(TCPIsGetReady(sktHTTP))
+			{
+				smHTTP = SM_HTTP_IDLE;
+				isDone = FALSE;
+			}
+			else if((LONG)(TickGet() - curHTTP.callbackID) > (LONG)0)
+			{
+				TCPDisconnect(sktHTTP);
+				smHTTP = SM_HTTP_IDLE;
+			}
+			break;
 		}
 	} while(!isDone);
 
@@ -1003,6 +1179,23 @@ static BOOL HTTPSendFile(void)
 	len = TCPIsPutReady(sktHTTP);
 	numBytes = mMIN(len, curHTTP.nextCallback - curHTTP.byteCount);
 	
+	// A chunk's length goes before it, so it must stop at the end of
+	// the file and leave room for its header
+	if(curHTTP.flags.bChunked)
+	{
+		if(MPFSGetBytesRem(curHTTP.file) == 0u)
+			return TRUE;
+		numBytes = mMIN(numBytes, MPFSGetBytesRem(curHTTP.file));
+		c = HTTPFormatChunkHeader(data, 0);
+		if(len < numBytes + c)
+			numBytes = (len > c) ? len - c : 0;
+		if(numBytes != 0u)
+		{
+			TCPPutArray(sktHTTP, data, HTTPFormatChunkHeader(data, numBytes));
+			curHTTP.flags.bChunkSent = 1;
+		}
+	}
+	
 	// Get/put as many bytes as possible
 	curHTTP.byteCount += numBytes;
 	while(numBytes > 0u)
@@ -1046,6 +1239,250 @@ static BOOL HTTPSendFile(void)
     return FALSE;
 }
 
+/*****************************************************************************
+  Function:
+	static BYTE HTTPFormatChunkHeader(BYTE* cHeader, WORD wLen)
+
+  Summary:
+	Writes the header of a chunk in a chunked response.
+
+  Description:
+	Writes the length of the next chunk of a chunked response as four hex
+	digits and a CRLF, preceded by the CRLF that ends the previous chunk
+	if one has been sent.  The header is always the same length for a 
+	given connection state, so its space can be reserved before the length
+	of the chunk is known.
+
+  Precondition:
+	curHTTP is loaded.
+
+  Parameters:
+	cHeader - Buffer of at least 8 bytes for the header
+	wLen - Length of the chunk that follows
+
+  Returns:
+	The number of bytes written to cHeader.
+  ***************************************************************************/
+static BYTE HTTPFormatChunkHeader(BYTE* cHeader, WORD wLen)
+{
+	BYTE* ptr;
+
+	ptr = cHeader;
+	if(curHTTP.flags.bChunkSent)
+	{
+		*ptr++ = '\r';
+		*ptr++ = '\n';
+	}
+	*ptr++ = btohexa_high(((WORD_VAL*)&wLen)->v[1]);
+	*ptr++ = btohexa_low(((WORD_VAL*)&wLen)->v[1]);
+	*ptr++ = btohexa_high(((WORD_VAL*)&wLen)->v[0]);
+	*ptr++ = btohexa_low(((WORD_VAL*)&wLen)->v[0]);
+	*ptr++ = '\r';
+	*ptr++ = '\n';
+
+	return (BYTE)(ptr - cHeader);
+}
+
+/*****************************************************************************
+  Function:
+	static BYTE HTTPFormatETag(BYTE* cETag)
+
+  Summary:
+	Writes the entity tag of the file being served.
+
+  Description:
+	Writes the quoted entity tag for curHTTP.file, made of the timestamp
+	and microtime MPFS2 keeps for it in hex.  A new image gives each file
+	a new tag.
+
+  Precondition:
+	curHTTP.file is open.
+
+  Parameters:
+	cETag - Buffer of at least 19 bytes for the tag
+
+  Returns:
+	The length of the tag, not counting the null terminator.
+  ***************************************************************************/
+static BYTE HTTPFormatETag(BYTE* cETag)
+{
+	DWORD_VAL dwTime;
+	BYTE *ptr, i;
+
+	ptr = cETag;
+	*ptr++ = '"';
+	dwTime.Val = MPFSGetTimestamp(curHTTP.file);
+	for(i = 4; i != 0u; i--)
+	{
+		*ptr++ = btohexa_high(dwTime.v[i-1]);
+		*ptr++ = btohexa_low(dwTime.v[i-1]);
+	}
+	dwTime.Val = MPFSGetMicrotime(curHTTP.file);
+	for(i = 4; i != 0u; i--)
+	{
+		*ptr++ = btohexa_high(dwTime.v[i-1]);
+		*ptr++ = btohexa_low(dwTime.v[i-1]);
+	}
+	*ptr++ = '"';
+	*ptr = '\0';
+
+	return (BYTE)(ptr - cETag);
+}
+
+/*****************************************************************************
+  Function:
+	static BYTE HTTPFormatDate(DWORD dwTime, BYTE* cDate)
+
+  Summary:
+	Writes a time as an HTTP date.
+
+  Description:
+	Converts a time in seconds since 1970 to the fixed length form used
+	in HTTP headers, such as "Sun, 06 Nov 1994 08:49:37 GMT".
+
+  Precondition:
+	None
+
+  Parameters:
+	dwTime - Seconds since 00:00:00 UTC, January 1, 1970
+	cDate - Buffer of at least 30 bytes for the date
+
+  Returns:
+	The length of the date, not counting the null terminator.
+  ***************************************************************************/
+static BYTE HTTPFormatDate(DWORD dwTime, BYTE* cDate)
+{
+	static ROM char days[] = "ThuFriSatSunMonTueWed";
+	static ROM char months[] = "MarAprMayJunJulAugSepOctNovDecJanFeb";
+	DWORD dwDays, dwYear;
+	WORD wDay;
+	BYTE *ptr, month, i;
+
+	dwDays = dwTime / 86400ul;
+	dwTime -= dwDays * 86400ul;
+
+	ptr = cDate;
+	for(i = 0; i < 3u; i++)
+		*ptr++ = days[(BYTE)(dwDays % 7u)*3u + i];
+	*ptr++ = ',';
+	*ptr++ = ' ';
+
+	// Count years and days from March 1 of year 0, so that leap days fall
+	// at the end of each year and skipped ones at the end of a century
+	dwDays += 719468ul;
+	dwYear = (dwDays / 146097ul) * 400ul;
+	dwDays %= 146097ul;
+	i = (BYTE)(dwDays / 36524ul);
+	if(i == 4u)
+		i = 3;
+	dwYear += i*100u;
+	dwDays -= i*36524ul;
+	dwYear += (dwDays / 1461u) * 4u;
+	dwDays %= 1461u;
+	i = (BYTE)(dwDays / 365u);
+	if(i == 4u)
+		i = 3;
+	dwYear += i;
+	wDay = (WORD)(dwDays - i*365u);
+
+	// Months counted from March have a 153 day cycle every 5 months
+	month = (BYTE)((wDay*5u + 2u) / 153u);
+	wDay = wDay - (month*153u + 2u) / 5u + 1u;
+	if(month >= 10u)
+		dwYear++;
+
+	*ptr++ = '0' + (BYTE)(wDay / 10u);
+	*ptr++ = '0' + (BYTE)(wDay % 10u);
+	*ptr++ = ' ';
+	for(i = 0; i < 3u; i++)
+		*ptr++ = months[month*3u + i];
+	*ptr++ = ' ';
+	ultoa(dwYear, ptr);
+	ptr += 4;
+	*ptr++ = ' ';
+	i = (BYTE)(dwTime / 3600u);
+	*ptr++ = '0' + i / 10u;
+	*ptr++ = '0' + i % 10u;
+	*ptr++ = ':';
+	i = (BYTE)((dwTime / 60u) % 60u);
+	*ptr++ = '0' + i / 10u;
+	*ptr++ = '0' + i % 10u;
+	*ptr++ = ':';
+	i = (BYTE)(dwTime % 60u);
+	*ptr++ = '0' + i / 10u;
+	*ptr++ = '0' + i % 10u;
+	strcpypgm2ram((char*)ptr, (ROM char*)" GMT");
+
+	return (BYTE)(ptr + 4 - cDate);
+}
+
+/*****************************************************************************
+  Function:
+	static void HTTPPutValidators(void)
+
+  Summary:
+	Writes the ETag and Last-Modified headers for a static file.
+
+  Description:
+	Writes the headers a client needs to make a conditional request for
+	curHTTP.file once its cached copy expires.
+
+  Precondition:
+	curHTTP.file is open.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+  ***************************************************************************/
+static void HTTPPutValidators(void)
+{
+	BYTE cValue[30];
+
+	HTTPFormatETag(cValue);
+	TCPPutROMString(sktHTTP, (ROM BYTE*)"ETag: ");
+	TCPPutString(sktHTTP, cValue);
+	TCPPutROMString(sktHTTP, HTTP_CRLF);
+
+	HTTPFormatDate(MPFSGetTimestamp(curHTTP.file), cValue);
+	TCPPutROMString(sktHTTP, (ROM BYTE*)"Last-Modified: ");
+	TCPPutString(sktHTTP, cValue);
+	TCPPutROMString(sktHTTP, HTTP_CRLF);
+}
+
+/*****************************************************************************
+  Function:
+	static BOOL HTTPGrowRxFIFO(void)
+
+  Summary:
+	Makes room for a request when the RX FIFO is full.
+
+  Description:
+	A persistent connection keeps only a small RX FIFO while a response is
+	sent.  When a request does not fit in it, the FIFO is grown back once
+	the previous response has been acknowledged, since resizing drops any
+	data left to transmit.
+
+  Precondition:
+	curHTTP is loaded and the RX FIFO is full.
+
+  Parameters:
+	None
+
+  Returns:
+	TRUE - The request may still fit, so keep waiting for it
+	FALSE - The request is too long for the FIFO
+  ***************************************************************************/
+static BOOL HTTPGrowRxFIFO(void)
+{
+	if(TCPGetTxFIFOFull(sktHTTP) != 0u)
+		return TRUE;
+
+	TCPAdjustFIFOSize(sktHTTP, 1, 0, TCP_ADJUST_PRESERVE_RX | TCP_ADJUST_GIVE_REST_TO_RX);
+	return TCPGetRxFIFOFree(sktHTTP) != 0u;
+}
+
 /*****************************************************************************
   Function:
 	static void HTTPHeaderParseLookup(BYTE i)
@@ -1091,6 +1528,24 @@ static void HTTPHeaderParseLookup(BYTE i)
 		return;
 	}
 	#endif
+
+	if(i == 3u)
+	{
+		HTTPHeaderParseConnection();
+		return;
+	}
+
+	if(i == 4u)
+	{
+		HTTPHeaderParseIfNoneMatch();
+		return;
+	}
+
+	if(i == 5u)
+	{
+		HTTPHeaderParseIfModifiedSince();
+		return;
+	}
 }
 
 /*****************************************************************************
@@ -1280,6 +1735,135 @@ static void HTTPHeaderParseContentLength(void)
 }
 #endif
 
+/*****************************************************************************
+  Function:
+	static void HTTPHeaderParseConnection(void)
+
+  Summary:
+	Parses the "Connection:" header for a request.
+
+  Description:
+	Parses the "Connection:" header to learn whether the client wants the
+	connection kept open after this response.  "close" ends it, while
+	"keep-alive" lets an HTTP/1.0 client keep it.  The result is stored in
+	curHTTP.flags.bKeepAlive.
+
+  Precondition:
+	None
+
+  Parameters:
+	None
+
+  Returns:
+	None
+
+  Remarks:
+	The header value is left in the buffer to be cleared with the rest of
+	the line.
+  ***************************************************************************/
+static void HTTPHeaderParseConnection(void)
+{
+	WORD len;
+
+	len = TCPFindROMArray(sktHTTP, HTTP_CRLF, HTTP_CRLF_LEN, 0, FALSE);
+	if(len == 0xffff)
+		return;
+
+	if(TCPFindROMArrayEx(sktHTTP, (ROM BYTE*)"close", 5, 0, len, TRUE) != 0xffff)
+		curHTTP.flags.bKeepAlive = 0;
+	else if(TCPFindROMArrayEx(sktHTTP, (ROM BYTE*)"keep-alive", 10, 0, len, TRUE) != 0xffff)
+		curHTTP.flags.bKeepAlive = 1;
+}
+
+/*****************************************************************************
+  Function:
+	static void HTTPHeaderParseIfNoneMatch(void)
+
+  Summary:
+	Parses the "If-None-Match:" header for a request.
+
+  Description:
+	Compares the entity tags the client holds against the one for the
+	requested file.  If the file's tag, or "*", is among them, the file
+	has not changed and curHTTP.flags.bNotModified is set.  Once this 
+	header is seen, "If-Modified-Since:" is ignored.
+
+  Precondition:
+	The requested file has been opened.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+
+  Remarks:
+	Only static files have validators; dynamic ones are always sent.
+  ***************************************************************************/
+static void HTTPHeaderParseIfNoneMatch(void)
+{
+	WORD len;
+	BYTE cETag[19];
+
+	if(curHTTP.file == MPFS_INVALID_HANDLE || (MPFSGetFlags(curHTTP.file) & MPFS2_FLAG_HASINDEX))
+		return;
+	
+	len = TCPFindROMArray(sktHTTP, HTTP_CRLF, HTTP_CRLF_LEN, 0, FALSE);
+	if(len == 0xffff)
+		return;
+
+	curHTTP.flags.bNoneMatch = 1;
+	curHTTP.flags.bNotModified = 0;
+	if(TCPFindEx(sktHTTP, '*', 0, len, FALSE) != 0xffff ||
+		TCPFindArrayEx(sktHTTP, cETag, HTTPFormatETag(cETag), 0, len, FALSE) != 0xffff)
+	{
+		curHTTP.flags.bNotModified = 1;
+	}
+}
+
+/*****************************************************************************
+  Function:
+	static void HTTPHeaderParseIfModifiedSince(void)
+
+  Summary:
+	Parses the "If-Modified-Since:" header for a request.
+
+  Description:
+	Compares the date the client holds against the requested file's
+	Last-Modified date.  If they are the same, the file has not changed
+	and curHTTP.flags.bNotModified is set.
+
+  Precondition:
+	The requested file has been opened.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+
+  Remarks:
+	Browsers send back the Last-Modified value exactly as they received
+	it, so the date is compared as text rather than parsed.  Any other
+	date gets the whole file, which is always correct.
+  ***************************************************************************/
+static void HTTPHeaderParseIfModifiedSince(void)
+{
+	WORD len;
+	BYTE cDate[30];
+
+	if(curHTTP.flags.bNoneMatch || curHTTP.file == MPFS_INVALID_HANDLE || 
+		(MPFSGetFlags(curHTTP.file) & MPFS2_FLAG_HASINDEX))
+		return;
+	
+	len = TCPFindROMArray(sktHTTP, HTTP_CRLF, HTTP_CRLF_LEN, 0, FALSE);
+	if(len == 0xffff)
+		return;
+
+	if(TCPFindArrayEx(sktHTTP, cDate, HTTPFormatDate(MPFSGetTimestamp(curHTTP.file), cDate), 0, len, FALSE) != 0xffff)
+		curHTTP.flags.bNotModified = 1;
+}
+
 /*****************************************************************************
   Function:
 	BYTE* HTTPURLDecode(BYTE* cData)
@@ -172,6 +172,13 @@ DWORD GenerateRandomDWORD(void)
 	TMR0L = TMR0LSave;
 	T0CON = T0CONSave;
 }
+#elif defined(__linux__)
+{
+	// Host builds (Host\Makefile) have no A/D converter to sample, so the
+	// tick count seeds the generator instead
+	srand((unsigned int)TickGet());
+	dwRandomResult = rand() ^ (((DWORD)rand())<<15) ^ (((DWORD)rand())<<30);
+}
 #else
 {
 	WORD AD1CON1Save, AD1CON2Save, AD1CON3Save;
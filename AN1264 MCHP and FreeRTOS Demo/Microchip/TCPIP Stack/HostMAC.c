@@ -0,0 +1,942 @@
+/*********************************************************************
+ *
+ *	Medium Access Control (MAC) Layer for Linux host builds
+ *  Module for Microchip TCP/IP Stack
+ *	 -Provides a virtual Ethernet controller so the stack can run,
+ *	  and be measured, on a Linux host
+ *	 -Frames are exchanged with a TAP interface, an AF_UNIX socket
+ *	  or a pcap capture file, see HostMAC.h
+ *
+ *********************************************************************
+ * FileName:        HostMAC.c
+ * Dependencies:    HostMAC.h
+ *					MAC.h
+ *					string.h
+ * Processor:       Linux host
+ * Compiler:        GCC
+ *
+ * The controller is modelled on the ENCX24J600: one RAM array holds the
+ * TX buffer, the TCP socket buffers and a circular RX buffer, and the
+ * stack moves data in and out of it through a read and a write pointer.
+ * Checksums and MACMemCopyAsync() work directly on the array, as the
+ * ENCX24J600 DMA does, so NON_MCHP_MAC is not needed.
+ ********************************************************************/
+#define __HOSTMAC_C
+
+// the C library's sockets are used here, not the Berkeley API's
+#define HOST_LIBC_SOCKETS
+
+#include "HardwareProfile.h"
+
+// Make sure that this hardware profile has the host MAC in it
+#if defined(HOST_MAC)
+
+#include "TCPIP Stack/TCPIP.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+/** D E F I N I T I O N S ****************************************************/
+#define ETHER_IP		((WORD)0x00)
+#define ETHER_ARP		((WORD)0x06)
+
+// Largest frame accepted from a backend, FCS excluded
+#define HOST_MAX_FRAME	(1518u)
+
+// Backends
+#define HOST_NONE		(0u)
+#define HOST_TAP		(1u)
+#define HOST_FD			(2u)
+#define HOST_PCAP		(3u)
+
+// libpcap file format
+#define PCAP_MAGIC			(0xA1B2C3D4ul)
+#define PCAP_MAGIC_NSEC		(0xA1B23C4Dul)
+#define PCAP_LINKTYPE_ETHERNET	(1ul)
+
+// Written ahead of every frame in the RX buffer.  The Ethernet header is
+// included, as in the ENCX24J600 preamble, so MACGetHeader() can read
+// both with one copy.
+typedef struct  __attribute__((aligned(2), packed))
+{
+    WORD			NextPacketPointer;
+    WORD			ByteCount;		// Frame length, Ethernet header included
+
+    MAC_ADDR        DestMACAddr;
+    MAC_ADDR        SourceMACAddr;
+    WORD_VAL        Type;
+} HOST_PREAMBLE;
+
+// The part of the preamble written by the "hardware" rather than
+// received from the wire
+#define HOST_PREAMBLE_HEAD	(2u*sizeof(WORD))
+
+/** P R I V A T E   V A R I A B L E S ****************************************/
+static BYTE vRAM[RAMSIZE];
+
+static WORD wReadPtr;				// Equivalent of ERXRDPT
+static WORD wWritePtr;				// Equivalent of EGPWRPT
+static WORD wTxLength;				// Equivalent of ETXLEN
+static WORD wRxHead;				// Where the next received frame goes
+static WORD wNextPacketPointer;		// Oldest frame not yet returned by MACGetHeader()
+static WORD wCurrentPacketPointer;	// Frame being processed by the stack
+static BOOL bWasDiscarded;
+
+static BYTE vBackend = HOST_NONE;
+static int iFD = -1;
+static FILE *fpPcap = NULL;
+static BOOL bPcapSwapped;
+static BOOL bPcapDone;
+static BOOL bPeerClosed;
+
+static HOST_MAC_STATS Stats;
+
+/** P R I V A T E   P R O T O T Y P E S **************************************/
+static WORD RxFreeSpace(void);
+static void RxWrite(BYTE *vData, WORD wLength);
+static void ReadRAM(WORD *pwAddress, BYTE *vData, WORD wLength);
+static void WriteRAM(WORD *pwAddress, BYTE *vData, WORD wLength);
+static WORD ChecksumRAM(WORD wAddress, WORD wLength);
+static void PollBackend(void);
+static int ReadFrame(BYTE *vFrame);
+static BOOL ReadPcapFrame(BYTE *vFrame, WORD *pwLength);
+static DWORD PcapDWORD(DWORD dwValue);
+static void StoreFrame(BYTE *vFrame, WORD wLength);
+
+
+/******************************************************************************
+ * Function:        BOOL MACHostOpen(const char *szSpec)
+ *
+ * PreCondition:    None
+ *
+ * Input:           szSpec: "tap:NAME", "fd:N" or "pcap:FILE"
+ *
+ * Output:          TRUE if the backend was opened
+ *
+ * Side Effects:    Any backend already open is closed
+ *
+ * Overview:        Selects where frames are received from and sent to.
+ *
+ * Note:            Call before StackInit().  The frame counters are reset.
+ *****************************************************************************/
+BOOL MACHostOpen(const char *szSpec)
+{
+	struct ifreq ifr;
+	DWORD dwHeader[6];
+
+	MACHostClose();
+	memset((void*)&Stats, 0x00, sizeof(Stats));
+
+	if(strncmp(szSpec, "tap:", 4) == 0)
+	{
+		iFD = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+		if(iFD < 0)
+			return FALSE;
+
+		memset((void*)&ifr, 0x00, sizeof(ifr));
+		ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+		strncpy(ifr.ifr_name, szSpec + 4, IFNAMSIZ - 1);
+		if(ioctl(iFD, TUNSETIFF, (void*)&ifr) < 0)
+		{
+			MACHostClose();
+			return FALSE;
+		}
+		vBackend = HOST_TAP;
+	}
+	else if(strncmp(szSpec, "fd:", 3) == 0)
+	{
+		iFD = atoi(szSpec + 3);
+		if(fcntl(iFD, F_SETFL, fcntl(iFD, F_GETFL) | O_NONBLOCK) < 0)
+		{
+			iFD = -1;
+			return FALSE;
+		}
+		bPeerClosed = FALSE;
+		vBackend = HOST_FD;
+	}
+	else if(strncmp(szSpec, "pcap:", 5) == 0)
+	{
+		fpPcap = fopen(szSpec + 5, "rb");
+		if(fpPcap == NULL)
+			return FALSE;
+
+		// Global header: magic, version, zone, accuracy, snap length and
+		// link type.  Either byte order is accepted.
+		if(fread((void*)dwHeader, sizeof(dwHeader), 1, fpPcap) != 1)
+		{
+			MACHostClose();
+			return FALSE;
+		}
+		bPcapSwapped = (dwHeader[0] != PCAP_MAGIC) && (dwHeader[0] != PCAP_MAGIC_NSEC);
+		if((PcapDWORD(dwHeader[0]) != PCAP_MAGIC && PcapDWORD(dwHeader[0]) != PCAP_MAGIC_NSEC) ||
+			PcapDWORD(dwHeader[5]) != PCAP_LINKTYPE_ETHERNET)
+		{
+			MACHostClose();
+			return FALSE;
+		}
+		bPcapDone = FALSE;
+		vBackend = HOST_PCAP;
+	}
+	else
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/******************************************************************************
+ * Function:        void MACHostClose(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    The link goes down
+ *
+ * Overview:        Closes the backend opened by MACHostOpen().
+ *
+ * Note:            An inherited fd:N socket is closed too.
+ *****************************************************************************/
+void MACHostClose(void)
+{
+	if(iFD >= 0)
+		close(iFD);
+	if(fpPcap != NULL)
+		fclose(fpPcap);
+
+	iFD = -1;
+	fpPcap = NULL;
+	vBackend = HOST_NONE;
+}
+
+/******************************************************************************
+ * Function:        BOOL MACHostRxPending(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          TRUE if MACGetHeader() would return a new frame
+ *
+ * Side Effects:    Frames waiting at the backend are moved into the RX
+ *					buffer
+ *
+ * Overview:        Lets the task driving the stack sleep when there is
+ *					nothing to do.
+ *
+ * Note:            None
+ *****************************************************************************/
+BOOL MACHostRxPending(void)
+{
+	PollBackend();
+
+	return wNextPacketPointer != wRxHead;
+}
+
+/******************************************************************************
+ * Function:        BOOL MACHostIsDone(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          TRUE once a pcap replay has been read to the end, or
+ *					the peer of an fd:N SOCK_SEQPACKET socket has closed
+ *					its end, and every frame has been handed to the stack
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Tells a benchmark when the traffic has finished.
+ *
+ * Note:            Always FALSE for a TAP interface.
+ *****************************************************************************/
+BOOL MACHostIsDone(void)
+{
+	if(vBackend == HOST_PCAP)
+		return bPcapDone && !MACHostRxPending();
+	if(vBackend == HOST_FD)
+		return !MACHostRxPending() && bPeerClosed;
+
+	return FALSE;
+}
+
+/******************************************************************************
+ * Function:        BOOL MACHostEnableInterrupt(BOOL bEnable)
+ *
+ * PreCondition:    MACHostOpen() has succeeded
+ *
+ * Input:           bEnable - TRUE to raise SIGIO when frames arrive,
+ *					FALSE to stop
+ *
+ * Output:          TRUE on success, FALSE for a pcap replay, which has
+ *					no descriptor to signal
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The host counterpart of the controller's INT enable,
+ *					so the task driving the stack can sleep until a
+ *					frame arrives.
+ *
+ * Note:            A signal per frame costs more than the frame itself,
+ *					so only enable it while the task sleeps and check
+ *					MACHostRxPending() after enabling it.  SIGIO is also
+ *					raised for events other than a new frame, so the 
+ *					handler must tolerate spurious calls.
+ *****************************************************************************/
+BOOL MACHostEnableInterrupt(BOOL bEnable)
+{
+	int iFlags;
+
+	if(iFD < 0)
+		return FALSE;
+
+	iFlags = fcntl(iFD, F_GETFL);
+	if(bEnable)
+	{
+		if(fcntl(iFD, F_SETOWN, getpid()) < 0)
+			return FALSE;
+		iFlags |= O_ASYNC;
+	}
+	else
+	{
+		iFlags &= ~O_ASYNC;
+	}
+
+	return fcntl(iFD, F_SETFL, iFlags) == 0;
+}
+
+/******************************************************************************
+ * Function:        int MACHostGetFD(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          The descriptor frames arrive on, or -1 for a pcap
+ *					replay or when no backend is open
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Allows the harness to wait for frames with select().
+ *
+ * Note:            None
+ *****************************************************************************/
+int MACHostGetFD(void)
+{
+	return iFD;
+}
+
+/******************************************************************************
+ * Function:        void MACHostGetStats(HOST_MAC_STATS *pStats)
+ *
+ * PreCondition:    None
+ *
+ * Input:           pStats: where to copy the counters
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Returns the frame counters kept since MACHostOpen().
+ *
+ * Note:            None
+ *****************************************************************************/
+void MACHostGetStats(HOST_MAC_STATS *pStats)
+{
+	memcpy((void*)pStats, (void*)&Stats, sizeof(Stats));
+}
+
+
+/******************************************************************************
+ * Function:        void MACInit(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Empties the RX buffer.  The backend is left as
+ *					MACHostOpen() set it up.
+ *
+ * Note:            None
+ *****************************************************************************/
+void MACInit(void)
+{
+	wRxHead = RXSTART;
+	wNextPacketPointer = RXSTART;
+	wCurrentPacketPointer = RXSTART;
+	bWasDiscarded = TRUE;
+	wReadPtr = RXSTART;
+	wWritePtr = TXSTART;
+	wTxLength = 0;
+}
+
+BOOL MACIsLinked(void)
+{
+	return vBackend != HOST_NONE;
+}
+
+BOOL MACIsTxReady(void)
+{
+	// MACFlush() completes the transmission before returning
+	return TRUE;
+}
+
+void MACDiscardRx(void)
+{
+	// Frees the current frame; RxFreeSpace() measures from
+	// wNextPacketPointer from now on
+	bWasDiscarded = TRUE;
+}
+
+WORD MACGetFreeRxSize(void)
+{
+	PollBackend();
+
+	return RxFreeSpace();
+}
+
+/******************************************************************************
+ * Function:        BOOL MACGetHeader(MAC_ADDR *remote, BYTE* type)
+ *
+ * PreCondition:    None
+ *
+ * Input:           *remote: Location to store the Source MAC address of the
+ *							 received frame.
+ *					*type: Location of a BYTE to store the constant
+ *						   MAC_UNKNOWN, ETHER_IP, or ETHER_ARP, representing
+ *						   the contents of the Ethernet type field.
+ *
+ * Output:          TRUE: If a packet was waiting in the RX buffer.  The
+ *						  remote, and type values are updated.
+ *					FALSE: If a packet was not pending.  remote and type are
+ *						   not changed.
+ *
+ * Side Effects:    Last packet is discarded if MACDiscardRx() hasn't already
+ *					been called.
+ *
+ * Overview:        None
+ *
+ * Note:            None
+ *****************************************************************************/
+BOOL MACGetHeader(MAC_ADDR *remote, BYTE* type)
+{
+	HOST_PREAMBLE header;
+
+	// Free the previous frame first so that its space can be used by
+	// whatever is waiting at the backend
+	if(!bWasDiscarded)
+		MACDiscardRx();
+
+	if(!MACHostRxPending())
+		return FALSE;
+
+	wCurrentPacketPointer = wNextPacketPointer;
+	wReadPtr = wCurrentPacketPointer;
+	ReadRAM(&wReadPtr, (BYTE*)&header, sizeof(header));
+
+	wNextPacketPointer = header.NextPacketPointer;
+
+    memcpy((void*)remote->v, (void*)header.SourceMACAddr.v, sizeof(*remote));
+
+    *type = MAC_UNKNOWN;
+    if( (header.Type.v[0] == 0x08u) &&
+    	((header.Type.v[1] == (BYTE)ETHER_IP) || (header.Type.v[1] == (BYTE)ETHER_ARP)) )
+    {
+    	*type = header.Type.v[1];
+    }
+
+	bWasDiscarded = FALSE;
+	return TRUE;
+}
+
+/******************************************************************************
+ * Function:        void MACPutHeader(MAC_ADDR *remote, BYTE type, WORD dataLen)
+ *
+ * PreCondition:    MACIsTxReady() must return TRUE.
+ *
+ * Input:           *remote: Pointer to memory which contains the destination
+ * 							 MAC address (6 bytes)
+ *					type: The constant ETHER_ARP or ETHER_IP, defining which
+ *						  value to write into the Ethernet header's type field.
+ *					dataLen: Length of the Ethernet data payload
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The write pointer is left at the start of the payload.
+ *
+ * Note:            None
+ *****************************************************************************/
+void MACPutHeader(MAC_ADDR *remote, BYTE type, WORD dataLen)
+{
+	BYTE vEthernetType[2];
+
+	vEthernetType[0] = 0x08;
+	vEthernetType[1] = (type == MAC_IP) ? ETHER_IP : ETHER_ARP;
+
+	wWritePtr = TXSTART;
+	wTxLength = dataLen + sizeof(ETHER_HEADER);
+
+	WriteRAM(&wWritePtr, (BYTE*)remote, sizeof(*remote));
+	WriteRAM(&wWritePtr, (BYTE*)&AppConfig.MyMACAddr, 6);
+	WriteRAM(&wWritePtr, vEthernetType, 2);
+}
+
+/******************************************************************************
+ * Function:        void MACFlush(void)
+ *
+ * PreCondition:    A packet has been created by calling MACPutHeader() and
+ *					MACPut() or MACPutArray().
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Sends the frame in the TX buffer to the backend.  A pcap
+ *					replay has nowhere to send it, so it is only counted.
+ *
+ * Note:            Frames the backend will not take are lost, as they
+ *					would be on a congested wire.
+ *****************************************************************************/
+void MACFlush(void)
+{
+	ssize_t iSent;
+
+	if(wTxLength > HOST_MAX_FRAME)
+		return;
+
+	switch(vBackend)
+	{
+		case HOST_TAP:
+			iSent = write(iFD, (void*)&vRAM[TXSTART], wTxLength);
+			break;
+
+		case HOST_FD:
+			iSent = send(iFD, (void*)&vRAM[TXSTART], wTxLength, MSG_DONTWAIT);
+			break;
+
+		case HOST_PCAP:
+			iSent = wTxLength;
+			break;
+
+		default:
+			iSent = -1;
+			break;
+	}
+
+	if(iSent == (ssize_t)wTxLength)
+	{
+		Stats.dwTxFrames++;
+		Stats.dwTxBytes += wTxLength;
+	}
+}
+
+void MACSetReadPtrInRx(WORD offset)
+{
+	WORD wNewReadPtr;
+
+	wNewReadPtr = wCurrentPacketPointer + sizeof(HOST_PREAMBLE) + offset;
+	if(wNewReadPtr > RXSTOP)
+		wNewReadPtr -= RXSIZE;
+
+	wReadPtr = wNewReadPtr;
+}
+
+WORD MACSetWritePtr(WORD address)
+{
+	WORD wOldWritePtr;
+
+	wOldWritePtr = wWritePtr;
+	wWritePtr = address;
+
+	return wOldWritePtr;
+}
+
+WORD MACSetReadPtr(WORD address)
+{
+	WORD wOldReadPtr;
+
+	wOldReadPtr = wReadPtr;
+	wReadPtr = address;
+
+	return wOldReadPtr;
+}
+
+WORD MACCalcRxChecksum(WORD offset, WORD len)
+{
+	WORD wStartAddress;
+
+	wStartAddress = wCurrentPacketPointer + sizeof(HOST_PREAMBLE) + offset;
+	if(wStartAddress > RXSTOP)
+		wStartAddress -= RXSIZE;
+
+	return ChecksumRAM(wStartAddress, len);
+}
+
+WORD CalcIPBufferChecksum(WORD len)
+{
+	// As with the ENCX24J600 DMA, the read pointer is not moved
+	return ChecksumRAM(wReadPtr, len);
+}
+
+/******************************************************************************
+ * Function:        void MACMemCopyAsync(WORD destAddr, WORD sourceAddr, WORD len)
+ *
+ * PreCondition:    None
+ *
+ * Input:           destAddr:	Destination address in the RAM array.  If the
+ *								MSb is set, the current write pointer is used
+ *								and advanced by len.
+ *					sourceAddr:	Source address in the RAM array.  If the MSb
+ *								is set, the current read pointer is used and
+ *								advanced by len.
+ *					len:		Number of bytes to copy
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Copies forwards a byte at a time, like the ENCX24J600
+ *					DMA, so overlapping regions behave as on the hardware.
+ *					Addresses past RXSTOP wrap to RXSTART.
+ *
+ * Note:            The copy is finished on return, so MACIsMemCopyDone()
+ *					is always TRUE.
+ *****************************************************************************/
+void MACMemCopyAsync(WORD destAddr, WORD sourceAddr, WORD len)
+{
+	if(((WORD_VAL*)&destAddr)->bits.b15)
+	{
+		destAddr = wWritePtr;
+		wWritePtr += len;
+	}
+	if(((WORD_VAL*)&sourceAddr)->bits.b15)
+	{
+		sourceAddr = wReadPtr;
+		wReadPtr += len;
+		if(wReadPtr > RXSTOP)
+			wReadPtr -= RXSIZE;
+	}
+
+	while(len--)
+	{
+		vRAM[destAddr++] = vRAM[sourceAddr++];
+		if(destAddr > RXSTOP)
+			destAddr = RXSTART;
+		if(sourceAddr > RXSTOP)
+			sourceAddr = RXSTART;
+	}
+}
+
+BOOL MACIsMemCopyDone(void)
+{
+	return TRUE;
+}
+
+BYTE MACGet()
+{
+	BYTE i;
+
+	ReadRAM(&wReadPtr, &i, 1);
+	return i;
+}//end MACGet
+
+WORD MACGetArray(BYTE *val, WORD len)
+{
+	WORD wNewReadPtr;
+
+	if(val)
+	{
+		ReadRAM(&wReadPtr, val, len);
+	}
+	else
+	{
+		wNewReadPtr = wReadPtr + len;
+		if(wNewReadPtr > RXSTOP)
+			wNewReadPtr -= RXSIZE;
+		wReadPtr = wNewReadPtr;
+	}
+
+	return len;
+}//end MACGetArray
+
+void MACPut(BYTE val)
+{
+	WriteRAM(&wWritePtr, &val, 1);
+}//end MACPut
+
+void MACPutArray(BYTE *val, WORD len)
+{
+	WriteRAM(&wWritePtr, val, len);
+}//end MACPutArray
+
+void MACPowerDown(void)
+{
+}
+
+void MACEDPowerDown(void)
+{
+}
+
+void MACPowerUp(void)
+{
+}
+
+void WritePHYReg(BYTE Register, WORD Data)
+{
+}
+
+PHYREG ReadPHYReg(BYTE Register)
+{
+	return 0x0000;
+}
+
+void SetRXHashTableEntry(MAC_ADDR DestMACAddr)
+{
+	// Only unicast and broadcast frames are accepted, see StoreFrame()
+}
+
+
+/******************************************************************************
+ * RAM array and RX buffer helpers
+ *****************************************************************************/
+
+// Free bytes in the RX buffer.  Two bytes are always left unused so that a
+// full buffer can be told apart from an empty one.
+static WORD RxFreeSpace(void)
+{
+	WORD wTail;
+
+	wTail = bWasDiscarded ? wNextPacketPointer : wCurrentPacketPointer;
+	if(wRxHead >= wTail)
+		return RXSIZE - (wRxHead - wTail) - 2u;
+
+	return wTail - wRxHead - 2u;
+}
+
+// Appends to the RX buffer at wRxHead, wrapping at RXSTOP
+static void RxWrite(BYTE *vData, WORD wLength)
+{
+	WORD wChunk;
+
+	while(wLength)
+	{
+		wChunk = RXSTOP + 1u - wRxHead;
+		if(wChunk > wLength)
+			wChunk = wLength;
+
+		memcpy((void*)&vRAM[wRxHead], (void*)vData, wChunk);
+		vData += wChunk;
+		wLength -= wChunk;
+		wRxHead += wChunk;
+		if(wRxHead > RXSTOP)
+			wRxHead = RXSTART;
+	}
+}
+
+// Reads from the array, wrapping at RXSTOP as the ENCX24J600 RX window does
+static void ReadRAM(WORD *pwAddress, BYTE *vData, WORD wLength)
+{
+	WORD wChunk;
+
+	while(wLength)
+	{
+		wChunk = RXSTOP + 1u - *pwAddress;
+		if(wChunk > wLength)
+			wChunk = wLength;
+
+		memcpy((void*)vData, (void*)&vRAM[*pwAddress], wChunk);
+		vData += wChunk;
+		wLength -= wChunk;
+		*pwAddress += wChunk;
+		if(*pwAddress > RXSTOP)
+			*pwAddress = RXSTART;
+	}
+}
+
+// Writes to the array.  Writes never wrap on the ENCX24J600 either, so
+// anything past the end of RAM is dropped.
+static void WriteRAM(WORD *pwAddress, BYTE *vData, WORD wLength)
+{
+	if(*pwAddress >= RAMSIZE)
+		return;
+	if(wLength > RAMSIZE - *pwAddress)
+		wLength = RAMSIZE - *pwAddress;
+
+	memcpy((void*)&vRAM[*pwAddress], (void*)vData, wLength);
+	*pwAddress += wLength;
+}
+
+// One's complement checksum as CalcIPChecksum() would return it, wrapping
+// at RXSTOP
+static WORD ChecksumRAM(WORD wAddress, WORD wLength)
+{
+	DWORD_VAL Checksum = {0x00000000ul};
+	BOOL bOdd = FALSE;
+
+	while(wLength--)
+	{
+		if(bOdd)
+			Checksum.Val += ((DWORD)vRAM[wAddress]) << 8;
+		else
+			Checksum.Val += (DWORD)vRAM[wAddress];
+		bOdd = !bOdd;
+
+		if(++wAddress > RXSTOP)
+			wAddress = RXSTART;
+	}
+
+	// Do an end-around carry (one's complement arrithmatic)
+	Checksum.Val = (DWORD)Checksum.w[0] + (DWORD)Checksum.w[1];
+
+	// Do another end-around carry in case if the prior add
+	// caused a carry out
+	Checksum.w[0] += Checksum.w[1];
+
+	return ~Checksum.w[0];
+}
+
+
+/******************************************************************************
+ * Backend helpers
+ *****************************************************************************/
+
+// Moves frames from the backend into the RX buffer.  A frame that does not
+// fit is dropped, as the ENCX24J600 would drop it, except during a replay
+// which waits for room instead so no frame is lost.
+static void PollBackend(void)
+{
+	BYTE vFrame[HOST_MAX_FRAME];
+	WORD wLength;
+	int iLength;
+
+	if(vBackend == HOST_PCAP)
+	{
+		while(!bPcapDone && RxFreeSpace() >= HOST_PREAMBLE_HEAD + HOST_MAX_FRAME + 1u)
+		{
+			if(ReadPcapFrame(vFrame, &wLength))
+				StoreFrame(vFrame, wLength);
+		}
+		return;
+	}
+
+	while((iLength = ReadFrame(vFrame)) > 0)
+		StoreFrame(vFrame, (WORD)iLength);
+}
+
+// Returns the length of the next frame from a TAP or socket backend, or 0
+// when there is none
+static int ReadFrame(BYTE *vFrame)
+{
+	ssize_t iLength;
+
+	if(iFD < 0)
+		return 0;
+
+	do
+	{
+		if(vBackend == HOST_TAP)
+			iLength = read(iFD, (void*)vFrame, HOST_MAX_FRAME);
+		else
+			iLength = recv(iFD, (void*)vFrame, HOST_MAX_FRAME, MSG_DONTWAIT);
+	} while(iLength < 0 && errno == EINTR);
+
+	// A SOCK_SEQPACKET peer never sends empty frames, so a length of 0
+	// means it has closed its end
+	if(iLength == 0 && vBackend == HOST_FD)
+		bPeerClosed = TRUE;
+
+	return (iLength > 0) ? (int)iLength : 0;
+}
+
+// Reads the next record of the capture.  Sets bPcapDone at the end of the
+// file; records too long to be Ethernet frames are skipped.
+static BOOL ReadPcapFrame(BYTE *vFrame, WORD *pwLength)
+{
+	DWORD dwRecord[4];	// Seconds, fraction, captured length, original length
+	DWORD dwLength;
+
+	if(fread((void*)dwRecord, sizeof(dwRecord), 1, fpPcap) != 1)
+	{
+		bPcapDone = TRUE;
+		return FALSE;
+	}
+
+	dwLength = PcapDWORD(dwRecord[2]);
+	if(dwLength > HOST_MAX_FRAME)
+	{
+		Stats.dwRxFiltered++;
+		if(fseek(fpPcap, (long)dwLength, SEEK_CUR) != 0)
+			bPcapDone = TRUE;
+		return FALSE;
+	}
+
+	if(fread((void*)vFrame, 1, dwLength, fpPcap) != dwLength)
+	{
+		bPcapDone = TRUE;
+		return FALSE;
+	}
+
+	*pwLength = (WORD)dwLength;
+	return TRUE;
+}
+
+static DWORD PcapDWORD(DWORD dwValue)
+{
+	return bPcapSwapped ? swapl(dwValue) : dwValue;
+}
+
+// Applies the address filter and copies an accepted frame into the RX
+// buffer behind its preamble
+static void StoreFrame(BYTE *vFrame, WORD wLength)
+{
+	static ROM BYTE vBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	WORD wHead[2];
+	WORD wSpace;
+
+	if(wLength < sizeof(ETHER_HEADER) ||
+		(memcmp((void*)vFrame, (void*)&AppConfig.MyMACAddr, 6) != 0 &&
+		 memcmp((void*)vFrame, (void*)vBroadcast, 6) != 0))
+	{
+		Stats.dwRxFiltered++;
+		return;
+	}
+
+	// Frames start on even addresses, as on the ENCX24J600
+	wSpace = (HOST_PREAMBLE_HEAD + wLength + 1u) & 0xFFFE;
+	if(RxFreeSpace() < wSpace)
+	{
+		Stats.dwRxDropped++;
+		return;
+	}
+
+	wHead[0] = wRxHead + wSpace;
+	if(wHead[0] > RXSTOP)
+		wHead[0] -= RXSIZE;
+	wHead[1] = wLength;
+
+	RxWrite((BYTE*)wHead, HOST_PREAMBLE_HEAD);
+	RxWrite(vFrame, wLength);
+	wRxHead = wHead[0];
+
+	Stats.dwRxFrames++;
+	Stats.dwRxBytes += wLength;
+}
+
+#endif //#if defined(HOST_MAC)
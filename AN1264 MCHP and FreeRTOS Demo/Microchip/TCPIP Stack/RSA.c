@@ -63,10 +63,722 @@
 
 #if (defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)) && !defined(ENC100_INTERFACE_MODE)
 
-// To comply with US Export Control restrictions, the encryption 
-// portion of the SSL module must be obtained separately from 
-// Microchip. The library of Data Encryption Routines (SW300052) is 
-// available for a nominal fee from www.microchipdirect.com. 
-#error RSA encryption module requires SW300052 from www.microchipdirect.com
+#include "TCPIP Stack/TCPIP.h"
+
+/****************************************************************************
+  Section:
+	Configuration
+  ***************************************************************************/
+
+// Bits of the exponent taken at once.  2^(RSA_WINDOW_BITS-1) odd powers of
+// the base are kept, each the size of a prime; 4 bits suits 256 to 512 
+// bit primes.
+#if !defined(RSA_WINDOW_BITS)
+	#define RSA_WINDOW_BITS		(4u)
+#endif
+#define RSA_WINDOW_SIZE			(1u << (RSA_WINDOW_BITS - 1))
+
+// Largest modulus accepted for encryption, as SSL.c reads up to a 1024 bit
+// server key
+#define RSA_ENCRYPT_WORDS		(1024ul/BIGINT_DATA_SIZE)
+
+// Words in the largest modulus exponentiated: a prime of the private key, 
+// or the server's public key
+#if defined(STACK_USE_RSA_ENCRYPT) && (RSA_ENCRYPT_WORDS > RSA_PRIME_WORDS)
+	#define RSA_MOD_WORDS		RSA_ENCRYPT_WORDS
+#else
+	#define RSA_MOD_WORDS		RSA_PRIME_WORDS
+#endif
+
+/****************************************************************************
+  Section:
+	Global RSA Variables
+  ***************************************************************************/
+
+static SM_RSA smRSA;					// State machine variable
+static BYTE keyLength;					// Length of the modulus in bytes
+static RSA_DATA_FORMAT outputFormat;	// Byte order of the result
+
+static BIGINT X;						// Data in, and the decrypted result
+#if defined(STACK_USE_RSA_ENCRYPT)
+static BIGINT Y;						// Encrypted result
+static BIGINT N;						// Public modulus
+static BYTE *vData;						// Data to encrypt, before padding
+static BYTE dataLen;					// Length of vData
+#endif
+
+// Modular exponentiation state.  vTable holds the base's odd powers in 
+// Montgomery form and Acc the power so far; Acc and Tmp swap buffers 
+// after each multiplication.
+static BIGINT_DATA_TYPE vTable[RSA_WINDOW_SIZE][RSA_MOD_WORDS];
+static BIGINT_DATA_TYPE vAcc[RSA_MOD_WORDS];
+static BIGINT_DATA_TYPE vTmp[RSA_MOD_WORDS];
+static BIGINT_DATA_TYPE vExp[RSA_MOD_WORDS];		// Exponent, then qInv
+static BIGINT_DATA_TYPE vWide[2*RSA_MOD_WORDS+1];	// Reductions and products
+static BIGINT Mod, Acc, Tmp;
+static BIGINT_DATA_TYPE mInv;			// BigIntMontgomeryInverse(&Mod)
+static WORD wWords;						// Words in Mod
+static SHORT iBit;						// Next exponent bit, counting down
+static BYTE bTable;						// Entries of vTable calculated
+static BOOL bStarted;					// Acc holds the first window's power
+
+#if defined(STACK_USE_RSA_DECRYPT)
+// The private key's CRT values, as little-endian byte arrays in 
+// CustomSSLCert.c
+extern ROM BYTE SSL_P[SSL_RSA_KEY_SIZE/16], SSL_Q[SSL_RSA_KEY_SIZE/16];
+extern ROM BYTE SSL_dP[SSL_RSA_KEY_SIZE/16], SSL_dQ[SSL_RSA_KEY_SIZE/16];
+extern ROM BYTE SSL_qInv[SSL_RSA_KEY_SIZE/16];
+
+static BIGINT_DATA_TYPE vP[RSA_PRIME_WORDS], vQ[RSA_PRIME_WORDS];
+static BIGINT_DATA_TYPE vM1[RSA_PRIME_WORDS+1];	// c^dP mod p, then m1 - m2
+static BIGINT_DATA_TYPE vM2[RSA_PRIME_WORDS];	// c^dQ mod q
+#endif
+
+// Bit i of the exponent
+#define _RSAExpBit(i)	((vExp[(WORD)(i) / BIGINT_DATA_SIZE] >> ((WORD)(i) % BIGINT_DATA_SIZE)) & 1u)
+
+static void _RSAModExpStart(BIGINT* x);
+static BOOL _RSAModExpStep(void);
+static void _RSAModExpFinish(BIGINT* y);
+static void _RSASquare(void);
+
+/****************************************************************************
+  Section:
+	Function Implementations
+  ***************************************************************************/
+
+/*****************************************************************************
+  Function:
+	void RSAInit(void)
+
+  Summary:
+	Initializes the RSA engine
+
+  Description:
+	Call this function once at boot to configure the memories for RSA
+	key storage and temporary processing space.
+
+  Precondition:
+	None
+
+  Parameters:
+	None
+
+  Returns:
+	None
+  ***************************************************************************/
+void RSAInit(void)
+{
+	smRSA = SM_RSA_IDLE;
+}
+
+/*****************************************************************************
+  Function:
+	BOOL RSABeginUsage(RSA_OP op, BYTE vKeyByteLen)
+
+  Summary:
+	Requests control of the RSA engine.
+
+  Description:
+	This function acts as a semaphore to gain control of the RSA engine.
+	Call this function and ensure that it returns TRUE before using
+	any other RSA APIs.  When the RSA module is no longer needed, call
+	RSAEndUsage to release the module back to the application.
+
+  Precondition:
+	RSA has already been initialized.
+
+  Parameters:
+	op - one of the RSA_OP constants indicating encryption or decryption
+	vKeyByteLen - For encryption, the length of the RSA key in bytes.  This
+				  value is ignored otherwise.
+
+  Return Values:
+	TRUE - No RSA operation is in progress and the calling application has
+		   sucessfully taken ownership of the RSA module.
+	FALSE - The RSA module is currently being used, so the calling
+			application must wait.
+  ***************************************************************************/
+BOOL RSABeginUsage(RSA_OP op, BYTE vKeyByteLen)
+{
+	if(smRSA != SM_RSA_IDLE)
+		return FALSE;
+
+	// Set up the state machine
+	if(op == RSA_OP_ENCRYPT)
+	{
+		#if defined(STACK_USE_RSA_ENCRYPT)
+		// The modulus must be whole words and fit the exponentiation buffers
+		if(vKeyByteLen == 0u || vKeyByteLen > RSA_ENCRYPT_WORDS*sizeof(BIGINT_DATA_TYPE) ||
+			(vKeyByteLen % sizeof(BIGINT_DATA_TYPE)) != 0u)
+			return FALSE;
+		keyLength = vKeyByteLen;
+		smRSA = SM_RSA_ENCRYPT_START;
+		#else
+		return FALSE;
+		#endif
+	}
+	else if(op == RSA_OP_DECRYPT)
+	{
+		#if defined(STACK_USE_RSA_DECRYPT)
+		keyLength = SSL_RSA_KEY_SIZE/8;
+		smRSA = SM_RSA_DECRYPT_START;
+		#else
+		return FALSE;
+		#endif
+	}
+	else
+		return FALSE;
+
+	return TRUE;
+}
+
+/*****************************************************************************
+  Function:
+	void RSAEndUsage(void)
+
+  Summary:
+	Releases control of the RSA engine.
+
+  Description:
+	This function acts as a semaphore to release control of the RSA engine.
+	Call this function when your application is finished with the RSA
+	module so that other applications may use it.
+
+  Precondition:
+	RSABeginUsage has been called and returned TRUE.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+  ***************************************************************************/
+void RSAEndUsage(void)
+{
+	smRSA = SM_RSA_IDLE;
+}
+
+/*****************************************************************************
+  Function:
+	void RSASetData(BYTE* data, BYTE len, RSA_DATA_FORMAT format)
+
+  Summary:
+	Indicates the data to be encrypted or decrypted.
+
+  Description:
+	Call this function to indicate what data is to be encrypted or
+	decrypted.  This function ensures that the data is PKCS #1 padded
+	for encryption operations, and also normalizes the data to little-
+	endian format so that it will be compatible with the BigInt libraries.
+
+  Precondition:
+	RSA has already been initialized and RSABeginUsage has returned TRUE.
+
+  Parameters:
+	data - The data to be encrypted or decrypted
+	len - The length of data
+	format - One of the RSA_DATA_FORMAT constants indicating the endian-ness
+			 of the input data.
+
+  Return Values:
+	None
+
+  Remarks:
+	For decryption, the data buffer is overwritten with the result, in
+	the same byte order; it must have room for the whole key.  For
+	encryption, data must stay valid until RSAStep returns RSA_DONE.
+  ***************************************************************************/
+void RSASetData(BYTE* data, BYTE len, RSA_DATA_FORMAT format)
+{
+	#if defined(STACK_USE_RSA_ENCRYPT)
+	if(smRSA == SM_RSA_ENCRYPT_START)
+	{
+		// Padded into the result buffer when the operation starts
+		vData = data;
+		dataLen = len;
+		return;
+	}
+	#endif
+
+	// Decrypt operations happen in place, over the whole key length
+	if(len < keyLength)
+	{
+		if(format == RSA_BIG_ENDIAN)
+		{
+			memmove(data + keyLength - len, data, len);
+			memset(data, 0x00, keyLength - len);
+		}
+		else
+			memset(data + len, 0x00, keyLength - len);
+	}
+	BigInt(&X, (BIGINT_DATA_TYPE*)data, keyLength/sizeof(BIGINT_DATA_TYPE));
+	if(format == RSA_BIG_ENDIAN)
+		BigIntSwapEndianness(&X);
+	outputFormat = format;
+}
+
+/*****************************************************************************
+  Function:
+	void RSASetResult(BYTE* data, RSA_DATA_FORMAT format)
+
+  Summary:
+	Indicates where the result should be stored.
+
+  Description:
+	Call this function to indicate where the result of an encryption
+	operation should be stored, and in what format.
+
+  Precondition:
+	RSA has already been initialized and RSABeginUsage has returned TRUE.
+
+  Parameters:
+	data - Where to store the result
+	format - One of the RSA_DATA_FORMAT constants indicating the endian-ness
+			 of the output.
+
+  Returns:
+	None
+
+  Remarks:
+	The result is keyLength bytes.  Decryption writes over its input, so
+	only encryption needs this function.
+  ***************************************************************************/
+void RSASetResult(BYTE* data, RSA_DATA_FORMAT format)
+{
+	#if defined(STACK_USE_RSA_ENCRYPT)
+	BigInt(&Y, (BIGINT_DATA_TYPE*)data, keyLength/sizeof(BIGINT_DATA_TYPE));
+	outputFormat = format;
+	#endif
+}
+
+/*****************************************************************************
+  Function:
+	void RSASetE(BYTE* data, BYTE len, RSA_DATA_FORMAT format)
+
+  Summary:
+	Sets the exponent for an encryption operation.
+
+  Description:
+	This function sets the exponent, usually 65537 or 3, for an
+	encryption operation.
+
+  Precondition:
+	RSA has already been initialized and RSABeginUsage has returned TRUE.
+
+  Parameters:
+	data - The exponent to use
+	len - Length of exponent in bytes
+	format - One of the RSA_DATA_FORMAT constants indicating the endian-ness
+			 of the exponent data
+
+  Returns:
+	None
+  ***************************************************************************/
+#if defined(STACK_USE_RSA_ENCRYPT)
+void RSASetE(BYTE* data, BYTE len, RSA_DATA_FORMAT format)
+{
+	BYTE i, *p;
+
+	if(len > sizeof(vExp))
+		len = sizeof(vExp);
+
+	memset((void*)vExp, 0x00, sizeof(vExp));
+	p = (BYTE*)vExp;
+	for(i = 0; i < len; i++)
+		p[i] = (format == RSA_BIG_ENDIAN) ? data[len - 1 - i] : data[i];
+}
+#endif
+
+/*****************************************************************************
+  Function:
+	void RSASetN(BYTE* data, RSA_DATA_FORMAT format)
+
+  Summary:
+	Sets the modulus for an encryption operation.
+
+  Description:
+	This function sets the modulus for an encryption operation.
+
+  Precondition:
+	RSA has already been initialized and RSABeginUsage has returned TRUE.
+
+  Parameters:
+	data - The modulus to use
+	format - One of the RSA_DATA_FORMAT constants indicating the endian-ness
+			 of the modulus data
+
+  Returns:
+	None
+
+  Remarks:
+	The modulus length is the vKeyByteLen given to RSABeginUsage.  The
+	buffer is converted to little-endian in place and must stay valid
+	until RSAStep returns RSA_DONE.
+  ***************************************************************************/
+#if defined(STACK_USE_RSA_ENCRYPT)
+void RSASetN(BYTE* data, RSA_DATA_FORMAT format)
+{
+	BigInt(&N, (BIGINT_DATA_TYPE*)data, keyLength/sizeof(BIGINT_DATA_TYPE));
+	if(format == RSA_BIG_ENDIAN)
+		BigIntSwapEndianness(&N);
+}
+#endif
+
+/*****************************************************************************
+  Function:
+	RSA_STATUS RSAStep(void)
+
+  Summary:
+	Performs non-blocking RSA calculations.
+
+  Description:
+	Call this function to process a portion of the pending RSA operation
+	until RSA_DONE is returned.  This function performs small pieces of
+	work each time it is called, so that it may be called from a
+	cooperative multitasking loop.  A step is one table entry or one
+	window of the exponent: at most RSA_WINDOW_BITS+1 Montgomery
+	multiplications.
+
+  Precondition:
+	RSA has already been initialized and RSABeginUsage has returned TRUE.
+	The data, result, and for encryption the exponent and modulus, have
+	been set.
+
+  Parameters:
+	None
+
+  Return Values:
+	RSA_WORKING - Calculation is in progress; call this function again.
+	RSA_FINISHED_M1 - Decryption has found c^dP mod p.
+	RSA_FINISHED_M2 - Decryption has found c^dQ mod q.
+	RSA_DONE - The RSA operation is complete.
+
+  Remarks:
+	Decryption uses the Chinese Remainder Theorem: the two half size
+	exponentiations, each about an eighth of the work of one modulo n,
+	are combined with Garner's formula.
+  ***************************************************************************/
+RSA_STATUS RSAStep(void)
+{
+	BIGINT Wide, A, B;
+	#if defined(STACK_USE_RSA_ENCRYPT)
+	BYTE i, j, *p;
+	#endif
+
+	switch(smRSA)
+	{
+		#if defined(STACK_USE_RSA_ENCRYPT)
+		case SM_RSA_ENCRYPT_START:
+			// PKCS #1 v1.5 block type 2, big-endian in the result buffer:
+			// 00 02, non-zero random padding, 00, then the data
+			p = (BYTE*)Y.ptrLSB;
+			i = keyLength - dataLen - 1;
+			p[0] = 0x00;
+			p[1] = 0x02;
+			for(j = 2; j < i; j++)
+			{
+				do
+				{
+					p[j] = RandomGet();
+				} while(p[j] == 0x00u);
+			}
+			p[i] = 0x00;
+			memcpy((void*)&p[i+1], (void*)vData, dataLen);
+			BigIntSwapEndianness(&Y);
+			
+			// y = x^e mod n
+			Mod = N;
+			wWords = keyLength/sizeof(BIGINT_DATA_TYPE);
+			_RSAModExpStart(&Y);
+			smRSA = SM_RSA_ENCRYPT;
+			break;
+			
+		case SM_RSA_ENCRYPT:
+			if(!_RSAModExpStep())
+				break;
+				
+			_RSAModExpFinish(&Y);
+			if(outputFormat == RSA_BIG_ENDIAN)
+				BigIntSwapEndianness(&Y);
+			smRSA = SM_RSA_DONE;
+			return RSA_DONE;
+		#endif
+		
+		#if defined(STACK_USE_RSA_DECRYPT)
+		case SM_RSA_DECRYPT_START:
+			memcpypgm2ram((void*)vP, (ROM void*)SSL_P, sizeof(vP));
+			memcpypgm2ram((void*)vQ, (ROM void*)SSL_Q, sizeof(vQ));
+			
+			// m1 = c^dP mod p
+			wWords = RSA_PRIME_WORDS;
+			BigInt(&Mod, vP, RSA_PRIME_WORDS);
+			memcpypgm2ram((void*)vExp, (ROM void*)SSL_dP, sizeof(vP));
+			_RSAModExpStart(&X);
+			smRSA = SM_RSA_DECRYPT_FIND_M1;
+			break;
+		
+		case SM_RSA_DECRYPT_FIND_M1:
+			if(!_RSAModExpStep())
+				break;
+			
+			BigInt(&A, vM1, RSA_PRIME_WORDS);
+			_RSAModExpFinish(&A);
+			
+			// m2 = c^dQ mod q
+			BigInt(&Mod, vQ, RSA_PRIME_WORDS);
+			memcpypgm2ram((void*)vExp, (ROM void*)SSL_dQ, sizeof(vQ));
+			_RSAModExpStart(&X);
+			smRSA = SM_RSA_DECRYPT_FIND_M2;
+			return RSA_FINISHED_M1;
+		
+		case SM_RSA_DECRYPT_FIND_M2:
+			if(!_RSAModExpStep())
+				break;
+			
+			BigInt(&B, vM2, RSA_PRIME_WORDS);
+			_RSAModExpFinish(&B);
+			smRSA = SM_RSA_DECRYPT_FINISH;
+			return RSA_FINISHED_M2;
+			
+		case SM_RSA_DECRYPT_FINISH:
+			// h = qInv * (m1 - m2) mod p, adding p until m1 >= m2
+			vM1[RSA_PRIME_WORDS] = 0;
+			BigInt(&A, vM1, RSA_PRIME_WORDS+1);
+			BigInt(&B, vM2, RSA_PRIME_WORDS);
+			BigInt(&Mod, vP, RSA_PRIME_WORDS);
+			while(BigIntCompare(&A, &B) < 0)
+				BigIntAdd(&A, &Mod);
+			BigIntSubtract(&A, &B);
+			
+			memcpypgm2ram((void*)vExp, (ROM void*)SSL_qInv, sizeof(vP));
+			BigInt(&B, vExp, RSA_PRIME_WORDS);
+			BigInt(&Wide, vWide, 2*RSA_PRIME_WORDS+1);
+			BigIntMultiply(&A, &B, &Wide);
+			BigIntMod(&Wide, &Mod);
+			
+			// m = m2 + h * q
+			BigInt(&A, vWide, RSA_PRIME_WORDS);
+			BigInt(&B, vQ, RSA_PRIME_WORDS);
+			BigIntMultiply(&A, &B, &X);
+			BigInt(&B, vM2, RSA_PRIME_WORDS);
+			BigIntAdd(&X, &B);
+			
+			if(outputFormat == RSA_BIG_ENDIAN)
+				BigIntSwapEndianness(&X);
+			smRSA = SM_RSA_DONE;
+			return RSA_DONE;
+		#endif
+		
+		default:
+			// Unknown state
+			return RSA_DONE;
+	}
+	
+	// Indicate that we're still working
+	return RSA_WORKING;
+}
+
+/****************************************************************************
+  Section:
+	Fundamental RSA Operations
+  ***************************************************************************/
+
+/*****************************************************************************
+  Function:
+	static void _RSAModExpStart(BIGINT* x)
+
+  Summary:
+	Begins a modular exponentiation of x.
+
+  Description:
+	Puts x mod Mod in Montgomery form, as the first entry of the odd
+	powers table, and finds the exponent's top bit.
+
+  Precondition:
+	Mod, wWords and the exponent in vExp are set; the exponent is not 
+	zero.
+
+  Parameters:
+	x - the base, no longer than 2*wWords words
+
+  Returns:
+	None
+  ***************************************************************************/
+static void _RSAModExpStart(BIGINT* x)
+{
+	BIGINT Wide;
+	WORD i;
+
+	// x mod m
+	BigInt(&Wide, vWide, 2*wWords);
+	BigIntCopy(&Wide, x);
+	BigIntMod(&Wide, &Mod);
+
+	// xR mod m, from x mod m shifted up by the modulus' words
+	for(i = 0; i < wWords; i++)
+	{
+		vWide[wWords + i] = vWide[i];
+		vWide[i] = 0;
+	}
+	Wide.bMSBValid = 0;
+	BigIntMod(&Wide, &Mod);
+	memcpy((void*)vTable[0], (void*)vWide, wWords*sizeof(BIGINT_DATA_TYPE));
+
+	mInv = BigIntMontgomeryInverse(&Mod);
+	BigInt(&Acc, vAcc, wWords);
+	BigInt(&Tmp, vTmp, wWords);
+
+	for(iBit = wWords*BIGINT_DATA_SIZE - 1; iBit > 0; iBit--)
+	{
+		if(_RSAExpBit(iBit))
+			break;
+	}
+	bTable = 1;
+	bStarted = FALSE;
+}
+
+/*****************************************************************************
+  Function:
+	static BOOL _RSAModExpStep(void)
+
+  Summary:
+	Performs one step of a modular exponentiation.
+
+  Description:
+	Left to right sliding window exponentiation.  The first steps fill
+	vTable with x^1, x^3, ... x^(2*RSA_WINDOW_SIZE-1).  Each later step
+	takes a run of zero bits, squaring for each, or a window of up to
+	RSA_WINDOW_BITS bits ending in a one, squaring for each bit then
+	multiplying by the window's table entry.
+
+  Precondition:
+	_RSAModExpStart has been called.
+
+  Parameters:
+	None
+
+  Return Values:
+	TRUE - Acc holds the power, in Montgomery form
+	FALSE - More steps are needed
+  ***************************************************************************/
+static BOOL _RSAModExpStep(void)
+{
+	BIGINT A, B;
+	BYTE bLen, bWindow;
+	SHORT i;
+
+	if(bTable < RSA_WINDOW_SIZE)
+	{
+		// Acc holds x^2 while the table is built
+		if(bTable == 1u)
+		{
+			BigInt(&A, vTable[0], wWords);
+			BigIntMontgomeryMultiply(&A, &A, &Mod, mInv, &Acc);
+		}
+		BigInt(&A, vTable[bTable-1], wWords);
+		BigInt(&B, vTable[bTable], wWords);
+		BigIntMontgomeryMultiply(&A, &Acc, &Mod, mInv, &B);
+		bTable++;
+		return FALSE;
+	}
+
+	// A run of zero bits
+	if(!_RSAExpBit(iBit))
+	{
+		for(bLen = 0; bLen < RSA_WINDOW_BITS && iBit >= 0; bLen++, iBit--)
+		{
+			if(_RSAExpBit(iBit))
+				break;
+			_RSASquare();
+		}
+		return iBit < 0;
+	}
+
+	// The longest window from iBit that ends in a one
+	bLen = RSA_WINDOW_BITS;
+	if(bLen > iBit + 1)
+		bLen = iBit + 1;
+	while(!_RSAExpBit(iBit - bLen + 1))
+		bLen--;
+	bWindow = 0;
+	for(i = iBit; i > iBit - bLen; i--)
+		bWindow = (bWindow << 1) | _RSAExpBit(i);
+	iBit -= bLen;
+
+	BigInt(&A, vTable[bWindow >> 1], wWords);
+	if(!bStarted)
+	{
+		BigIntCopy(&Acc, &A);
+		bStarted = TRUE;
+	}
+	else
+	{
+		while(bLen--)
+			_RSASquare();
+		BigIntMontgomeryMultiply(&Acc, &A, &Mod, mInv, &Tmp);
+		B = Acc;
+		Acc = Tmp;
+		Tmp = B;
+	}
+	
+	return iBit < 0;
+}
+
+/*****************************************************************************
+  Function:
+	static void _RSASquare(void)
+
+  Summary:
+	Squares Acc.
+
+  Description:
+	Squares the Montgomery form power in Acc, swapping it with Tmp.
+
+  Precondition:
+	_RSAModExpStart has been called.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+  ***************************************************************************/
+static void _RSASquare(void)
+{
+	BIGINT B;
+
+	BigIntMontgomeryMultiply(&Acc, &Acc, &Mod, mInv, &Tmp);
+	B = Acc;
+	Acc = Tmp;
+	Tmp = B;
+}
+
+/*****************************************************************************
+  Function:
+	static void _RSAModExpFinish(BIGINT* y)
+
+  Summary:
+	Stores the result of a modular exponentiation.
+
+  Description:
+	Takes the power in Acc out of Montgomery form, by multiplying it by 
+	one.
+
+  Precondition:
+	_RSAModExpStep has returned TRUE.
+
+  Parameters:
+	y - where to store the power, at least wWords words
+
+  Returns:
+	None
+  ***************************************************************************/
+static void _RSAModExpFinish(BIGINT* y)
+{
+	BigIntZero(&Tmp);
+	*Tmp.ptrLSB = 1;
+	BigIntMontgomeryMultiply(&Acc, &Tmp, &Mod, mInv, y);
+}
 
 #endif// #if (defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)) && !defined(ENC100_INTERFACE_MODE)
@@ -9,6 +9,7 @@
  * FileName:        Random.c
  * Dependencies:    StackTsk.c
  *                  Tick.c
+ *                  Hashes.c
  * Processor:       PIC18, PIC24F, PIC24H, dsPIC30F, dsPIC33F, PIC32
  * Compiler:        Microchip C32 v1.05 or higher
  *					Microchip C30 v3.12 or higher
@@ -61,9 +62,28 @@
 
 #include "TCPIP Stack/TCPIP.h"
 
-static HASH_SUM randHash;
-static BYTE output[20];
-static BYTE bCount;
+// Bytes in the entropy pool, a power of two no more than 256
+#define RANDOM_POOL_SIZE	(32u)
+
+// Least time between mixes of the pool into the seed
+#define RANDOM_MIX_PERIOD	(TICK_SECOND)
+
+static BYTE vPool[RANDOM_POOL_SIZE];	// Packet samples, folded in with XOR
+static volatile BYTE bPoolHead;			// Bytes added to the pool, modulo 256
+static BYTE bPoolMixed;					// bPoolHead at the last mix
+static volatile DWORD dwLastAdd;		// TickGet() at the last RandomAdd()
+static DWORD dwLastMix;					// TickGet() at the last mix
+static BOOL bKeyed;						// Whether the key has been set
+static HASH_SUM randHash;				// The seed, holding every mix so far
+static HASH_SUM randBlock;				// Hashes the key for each block
+static BYTE randKey[20];				// The key, replaced after each read
+static DWORD randCounter;				// Blocks made since RandomInit()
+static BYTE randOutput[20];				// The current block of output
+static BYTE bOutputLeft;				// Bytes of randOutput not yet read
+
+static void RandomMix(void);
+static void RandomBlock(void);
+static void RandomRekey(void);
 
 /*********************************************************************
  * Function:        void RandomInit(void)
@@ -76,7 +96,8 @@ static BYTE bCount;
  *
  * Side Effects:    None
  *
- * Overview:        Sets up the random generator structure.
+ * Overview:        Sets up the seed and the generator.  Entropy
+ *					already in the pool is kept.
  *
  * Note:            Data is not secure until several packets have
  *					been received.
@@ -84,13 +105,15 @@ static BYTE bCount;
 void RandomInit(void)
 {
 	SHA1Initialize(&randHash);
-	bCount = 20;
+	bPoolMixed = bPoolHead;
+	bKeyed = FALSE;
+	bOutputLeft = 0;
 }
 
 /*********************************************************************
  * Function:        BYTE RandomGet(void)
  *
- * PreCondition:    None
+ * PreCondition:    RandomInit() has been called
  *
  * Input:           None
  *
@@ -104,17 +127,64 @@ void RandomInit(void)
  ********************************************************************/
 BYTE RandomGet(void)
 {
-	if(bCount >= 20u)
-	{//we need to get new random bytes
-		SHA1Calculate(&randHash, output);
-		RandomAdd(output[0]);
-		bCount = 0;
-	}
+	BYTE data;
 	
-	//return the random byte
-	return output[bCount++];
+	RandomGetArray(&data, 1);
+	return data;
 }
 
+/*********************************************************************
+ * Function:        void RandomGetArray(BYTE* data, WORD len)
+ *
+ * PreCondition:    RandomInit() has been called
+ *
+ * Input:           data - where to write the random bytes
+ *					len - how many to write
+ *
+ * Output:          len random bytes are generated
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Copies the bytes from blocks of output, keying
+ *					the generator from the pool first if no mix has
+ *					done so.  If any block was made the key is then
+ *					replaced, once for the whole read, as NIST's
+ *					Hash_DRBG does per request.
+ *
+ * Note:            Bytes are cleared from the block as they are
+ *					read, so none is handed out twice.  Bytes left
+ *					in the last block are kept for the next read.
+ ********************************************************************/
+void RandomGetArray(BYTE* data, WORD len)
+{
+	BYTE* block;
+	WORD w;
+	BOOL bMade;
+	
+	if(!bKeyed)
+		RandomMix();
+	
+	bMade = FALSE;
+	while(len)
+	{
+		if(bOutputLeft == 0u)
+		{
+			RandomBlock();
+			bMade = TRUE;
+		}
+		
+		w = (len < bOutputLeft) ? len : bOutputLeft;
+		block = &randOutput[sizeof(randOutput) - bOutputLeft];
+		memcpy((void*)data, (void*)block, w);
+		memset((void*)block, 0x00, w);
+		bOutputLeft -= w;
+		data += w;
+		len -= w;
+	}
+	
+	if(bMade)
+		RandomRekey();
+}
 
 /*********************************************************************
  * Function:        void RandomAdd(BYTE data)
@@ -127,19 +197,148 @@ BYTE RandomGet(void)
  *
  * Side Effects:    None
  *
- * Overview:        Hashes the byte and a timer value
+ * Overview:        Folds the byte and the low byte of a timer value
+ *					into the pool
  *
- * Note:            None
+ * Note:            Only the caller writes bPoolHead and dwLastAdd,
+ *					and the pool is only ever XORed into, so one
+ *					context, even an interrupt, may call this while
+ *					another mixes the pool.
  ********************************************************************/
 void RandomAdd(BYTE data)
 {
-	DWORD dTemp;
+	DWORD dwTime;
+	BYTE i;
+	
+	dwTime = TickGet();
+	i = bPoolHead;
+	vPool[i & (RANDOM_POOL_SIZE-1)] ^= data;
+	vPool[(i+1) & (RANDOM_POOL_SIZE-1)] ^= (BYTE)dwTime;
+	bPoolHead = i + 2;
+	dwLastAdd = dwTime;
+}
+
+/*********************************************************************
+ * Function:        void RandomTask(void)
+ *
+ * PreCondition:    RandomInit() has been called
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Mixes the pool into the seed and rekeys the
+ *					generator, when a packet has been added
+ *					RANDOM_MIX_PERIOD or more after the last mix.
+ *
+ * Note:            Called from StackApplications(), after the
+ *					packets have been handled.  The time is that
+ *					RandomAdd() read, so no timer is read here.
+ ********************************************************************/
+void RandomTask(void)
+{
+	if(bPoolHead == bPoolMixed)
+		return;
+	if(bKeyed && (dwLastAdd - dwLastMix < (DWORD)RANDOM_MIX_PERIOD))
+		return;
+	
+	RandomMix();
+}
+
+/*********************************************************************
+ * Function:        static void RandomMix(void)
+ *
+ * PreCondition:    RandomInit() has been called
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Hashes the pool and a timer value into the seed,
+ *					then replaces the key with the SHA-1 hash of the
+ *					old key and the seed's hash sum.  Output not yet
+ *					read is dropped.
+ *
+ * Note:            The seed is never reset, so each key depends on
+ *					every packet seen since RandomInit().
+ ********************************************************************/
+static void RandomMix(void)
+{
+	bPoolMixed = bPoolHead;
+	dwLastMix = TickGet();
+	
+	SHA1AddData(&randHash, vPool, RANDOM_POOL_SIZE);
+	SHA1AddData(&randHash, (BYTE*)&dwLastMix, sizeof(dwLastMix));
+	SHA1Calculate(&randHash, randOutput);
 	
-	SHA1AddData(&randHash, &data, 1);
-	dTemp = TickGet();
-	SHA1AddData(&randHash, (BYTE*)&dTemp, 1);
+	SHA1Initialize(&randBlock);
+	SHA1AddData(&randBlock, randKey, sizeof(randKey));
+	SHA1AddData(&randBlock, randOutput, sizeof(randOutput));
+	SHA1Calculate(&randBlock, randKey);
+	memset((void*)randOutput, 0x00, sizeof(randOutput));
+	bOutputLeft = 0;
+	
+	bKeyed = TRUE;
+}
+
+/*********************************************************************
+ * Function:        static void RandomBlock(void)
+ *
+ * PreCondition:    The key has been set by RandomMix()
+ *
+ * Input:           None
+ *
+ * Output:          randOutput holds 20 new random bytes
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Makes the block as the SHA-1 hash of the key and
+ *					the block counter, one SHA-1 block's work.
+ *
+ * Note:            None
+ ********************************************************************/
+static void RandomBlock(void)
+{
+	SHA1Initialize(&randBlock);
+	SHA1AddData(&randBlock, randKey, sizeof(randKey));
+	SHA1AddData(&randBlock, (BYTE*)&randCounter, sizeof(randCounter));
+	SHA1Calculate(&randBlock, randOutput);
+	
+	randCounter++;
+	bOutputLeft = sizeof(randOutput);
+}
+
+/*********************************************************************
+ * Function:        static void RandomRekey(void)
+ *
+ * PreCondition:    The key has been set by RandomMix()
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Replaces the key with the SHA-1 hash of the key,
+ *					the block counter and a marker byte, which no
+ *					block hashes.
+ *
+ * Note:            Reading the state after the key is replaced does
+ *					not give back the blocks already made.
+ ********************************************************************/
+static void RandomRekey(void)
+{
+	BYTE marker = 0x01;
 	
-	bCount = 20;
+	SHA1Initialize(&randBlock);
+	SHA1AddData(&randBlock, randKey, sizeof(randKey));
+	SHA1AddData(&randBlock, (BYTE*)&randCounter, sizeof(randCounter));
+	SHA1AddData(&randBlock, &marker, 1);
+	SHA1Calculate(&randBlock, randKey);
 }
 
 #endif	//#if defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)
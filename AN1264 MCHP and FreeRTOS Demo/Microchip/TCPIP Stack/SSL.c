@@ -61,6 +61,9 @@
 #if defined(STACK_USE_SSL_SERVER) || defined(STACK_USE_SSL_CLIENT)
 
 #include "TCPIP Stack/TCPIP.h"
+#if defined(SSL_SESSION_PERSIST)
+	#include "SST25VF016.h"
+#endif
 	
 /****************************************************************************
   Section:
@@ -94,13 +97,23 @@
 	#endif
 	SSL_SESSION sslSession;			// Current session data
 	
-	// 8 byte session stubs
+	// 12 byte session stubs
 	SSL_SESSION_STUB sslSessionStubs[MAX_SSL_SESSIONS];
+	static BYTE sslSessionHolds[MAX_SSL_SESSIONS];	// Handshakes in progress on each session
+	static DWORD dwSessionUseCount;		// Orders sslSessionStubs[].lastUsed
+	static SSL_SESSION_STATS sslSessionStats;
+	#if defined(SSL_SESSION_PERSIST)
+	static BOOL sslSessionsChanged;		// Whether a session was added since the last save
+	static DWORD dwSessionSaveTick;		// Tick count of the last save
+	#endif
 	
 	BYTE *ptrHS;					// Used in buffering handshake results
 
 	extern ROM WORD SSL_CERT_LEN;	// RSA public certificate length		?
 	extern ROM BYTE SSL_CERT[];		// RSA public certificate data			?
+	#if defined(SSL_SESSION_PERSIST)
+	extern ROM BYTE SSL_P[SSL_RSA_KEY_SIZE/16], SSL_Q[SSL_RSA_KEY_SIZE/16];
+	#endif
 
 	#if defined(__18CXX) && !defined(HI_TECH_C)	
 		#pragma udata						
@@ -129,7 +142,16 @@
 	static void SSLBufferFree(BYTE *id);
 	static BYTE SSLSessionNew(void);
 	static void SSLSessionSync(BYTE id);
+	static void SSLSessionRelease(BOOL bComplete);
 	#define SSLSessionUpdated()		sslSessionUpdated = TRUE;
+	#define SSLSessionExpired(id)	(TickGetDiv64K() - sslSessionStubs[id].created > (DWORD)(SSL_SESSION_LIFETIME >> 16))
+	#if defined(SSL_SESSION_PERSIST)
+	static void SSLSessionRestore(void);
+	static void SSLSessionKey(BYTE label, BYTE *nonce, BYTE *result);
+	static void SSLSessionMACStart(BYTE *key, BYTE pad);
+	static void SSLSessionMACEnd(BYTE *key, BYTE *result);
+	static void SSLSessionPutSealed(ARCFOUR_CTX *ctx, BYTE *data, BYTE len);
+	#endif
 	static void SaveOffChip(BYTE *ramAddr, WORD ethAddr, WORD len);
 	static void LoadOffChip(BYTE *ramAddr, WORD ethAddr, WORD len);
 	
@@ -181,6 +203,28 @@
 	#define SSL_RSA_EXPORT_WITH_ARCFOUR_40_MD5	0x0003u
 	#define SSL_RSA_WITH_ARCFOUR_128_MD5		0x0004u
 
+	#if defined(SSL_SESSION_PERSIST)
+	// Sessions saved in SPI Flash: this header, then for each server
+	// session an SSL_SAVED_STUB and its SSL_SESSION, sealed with ARCFOUR,
+	// then an HMAC-SHA1 of all of it.  The keys are hashed from the nonce
+	// and the RSA private key, so a board with another key ignores them.
+	#define SSL_SESSION_MAGIC		(0x314C5353ul)	// "SSL1"
+
+	typedef struct
+	{
+		DWORD magic;						// SSL_SESSION_MAGIC
+		DWORD count;						// Sessions that follow
+		BYTE nonce[16];						// Random, for the keys of this save
+	} SSL_SAVED_HEADER;
+
+	typedef struct
+	{
+		DWORD_VAL tag;						// The session's tag
+		DWORD age;							// TickGetDiv64K() counts since it was created
+		DWORD uses;							// Uses of any session since it was last used
+	} SSL_SAVED_STUB;
+	#endif
+
 /****************************************************************************
   Section:
 	Resource Management Variables
@@ -254,8 +298,70 @@ void SSLInit(void)
 	sslBufferID = SSL_INVALID_ID;
 	sslSessionUpdated = FALSE;
 	sslRSAStubID = SSL_INVALID_ID;
+
+	// Start the session cache empty, then fill it from SPI Flash.  The
+	// statistics carry on across a restart.
+	memset((void*)sslSessionHolds, 0x00, sizeof(sslSessionHolds));
+	dwSessionUseCount = 0;
+	#if defined(SSL_SESSION_PERSIST)
+	SSLSessionRestore();
+	sslSessionsChanged = FALSE;
+	dwSessionSaveTick = TickGet() - (DWORD)SSL_SESSION_SAVE_PERIOD;
+	#endif
 }	
 
+/*****************************************************************************
+  Function:
+	void SSLGetSessionStats(SSL_SESSION_STATS* pStats)
+
+  Summary:
+	Copies the session cache statistics.
+
+  Description:
+	Copies the counts of resumed and missed sessions, of full handshakes
+	and the cached sessions they overwrote, and of the sessions saved to
+	and restored from SPI Flash, since the application started.
+
+  Precondition:
+	SSL has already been initialized.
+
+  Parameters:
+	pStats - where to copy the statistics
+	
+  Returns:
+  	None
+  ***************************************************************************/
+void SSLGetSessionStats(SSL_SESSION_STATS* pStats)
+{
+	memcpy((void*)pStats, (void*)&sslSessionStats, sizeof(SSL_SESSION_STATS));
+}
+
+/*****************************************************************************
+  Function:
+	BOOL SSLRSAPending(void)
+
+  Summary:
+	Determines if an RSA operation is under way.
+
+  Description:
+	Returns whether a session holds the RSA engine.  Each call to 
+	SSLPeriodic() for that session advances the operation by one RSAStep(), 
+	so the stack has work to do until it completes.
+
+  Precondition:
+	SSL has already been initialized.
+
+  Parameters:
+	None
+	
+  Returns:
+  	TRUE if a session is part way through an RSA operation
+  ***************************************************************************/
+BOOL SSLRSAPending(void)
+{
+	return sslRSAStubID != SSL_INVALID_ID;
+}
+
 /*****************************************************************************
   Function:
 	void SSLPeriodic(TCP_SOCKET hTCP, BYTE id)
@@ -306,9 +412,10 @@ void SSLPeriodic(TCP_SOCKET hTCP, BYTE id)
 			#if defined(STACK_USE_SSL_SERVER)
 			if(sslStub.Flags.bIsServer)
 			{
-				// Copy over the pre-master secret
+				// Copy over the pre-master secret, the last 48 bytes of 
+				// the PKCS #1 block
 				SSLSessionSync(sslStub.idSession);
-				memcpy((void*)sslSession.masterSecret, (void*)&sslBuffer.full[16], 48);
+				memcpy((void*)sslSession.masterSecret, (void*)&sslBuffer.full[SSL_RSA_KEY_SIZE/8 - 48], 48);
 												
 				// Generate the Master Secret
 				SSLKeysSync(sslStubID);
@@ -402,8 +509,7 @@ BYTE SSLStartSession(TCP_SOCKET hTCP)
 	#else
 		i = 0;
 	#endif
-	while(i < 32u)
-		sslKeys.Local.random[i++] = RandomGet();
+	RandomGetArray(&sslKeys.Local.random[i], 32 - i);
 		
 	// Return the ID
 	return sslStubID;
@@ -440,6 +546,10 @@ void SSLTerminate(BYTE id)
 	//	sslSessionStubs[sslStub.idSession].tag.Val = 0;
 	//}	
 	
+	// Release a session whose handshake did not complete
+	if(!sslStub.Flags.bLocalFinished || !sslStub.Flags.bRemoteFinished)
+		SSLSessionRelease(FALSE);
+	
 	// Free up resources
 	SSLBufferFree(&sslStub.idRxBuffer);
 	SSLBufferFree(&sslStub.idTxBuffer);
@@ -1072,9 +1182,12 @@ static void SSLRxClientHello(TCP_SOCKET hTCP)
 	if(TCPIsGetReady(hTCP) < sslStub.wRxHsBytesRem)
 		return;
 		
-	// Verify handshake message sequence
+	// Verify handshake message sequence, without taking a second session
 	if(sslStub.Flags.bClientHello)
+	{
 		TCPRequestSSLMessage(hTCP, SSL_ALERT_HANDSHAKE_FAILURE);
+		return;
+	}
 	
 	// Indicate that we're the server
 	sslStub.Flags.bIsServer = 1;
@@ -1172,9 +1285,12 @@ static void SSLRxAntiqueClientHello(TCP_SOCKET hTCP)
 	if(TCPIsGetReady(hTCP) < sslStub.wRxHsBytesRem)
 		return;
 		
-	// Verify handshake message sequence
+	// Verify handshake message sequence, without taking a second session
 	if(sslStub.Flags.bClientHello)
+	{
 		TCPRequestSSLMessage(hTCP, SSL_ALERT_HANDSHAKE_FAILURE);
+		return;
+	}
 		
 	// Indicate that we're the server
 	sslStub.Flags.bIsServer = 1;
@@ -1359,11 +1475,12 @@ static void SSLTxServerHello(TCP_SOCKET hTCP)
 	// If this session is new, generate an ID
 	if(sslStub.Flags.bNewSession)
 	{
-		for(i = 0; i < 32u; i++)
-			sslSession.sessionID[i] = RandomGet();
+		RandomGetArray(sslSession.sessionID, 32);
 		SSLSessionUpdated();
 		
-		// Tag this session identifier
+		// Tag this session identifier, marked as not resumable until its
+		// handshake completes
+		sslSessionStubs[sslStub.idSession].tag.v[0] = 1;
 		memcpy((void*)&sslSessionStubs[sslStub.idSession].tag.v[1],
 			(void*)(sslSession.sessionID), 3);
 	}
@@ -1393,8 +1510,7 @@ static void SSLTxServerHello(TCP_SOCKET hTCP)
 	#else
 		i = 0;
 	#endif
-	while(i < 32u)
-		sslKeys.Local.random[i++] = RandomGet();
+	RandomGetArray(&sslKeys.Local.random[i], 32 - i);
 	HSPutArray(hTCP, sslKeys.Local.random, 32);
 	
 	// Put Session ID
@@ -1565,8 +1681,7 @@ static void SSLRxServerCertificate(TCP_SOCKET hTCP)
 			SSLSessionSync(sslStub.idSession);
 			sslSession.masterSecret[0] = SSL_VERSION_HI;
 			sslSession.masterSecret[1] = SSL_VERSION_LO;
-			for(i = 2; i < 48u; i++)
-				sslSession.masterSecret[i] = RandomGet();
+			RandomGetArray(&sslSession.masterSecret[2], 46);
 			SSLSessionUpdated();
 			
 			// Set RSA engine to use this data and key
@@ -1901,7 +2016,6 @@ static void SSLRxClientKeyExchange(TCP_SOCKET hTCP)
 	
 	// Kick off the RSA decryptor
 	sslStub.Flags.bRSAInProgress = 1;
-	sslSessionStubs[sslStub.idSession].lastUsed += SSL_RSA_LIFETIME_EXTENSION;
 	
 }
 #endif
@@ -1993,6 +2107,7 @@ static void SSLTxCCSFin(TCP_SOCKET hTCP)
 		TCPSSLHandshakeComplete(hTCP);
 		SSLHashFree(&sslStub.idMD5);
 		SSLHashFree(&sslStub.idSHA1);
+		SSLSessionRelease(TRUE);
 	}
 
 }
@@ -2120,6 +2235,7 @@ static void SSLRxFinished(TCP_SOCKET hTCP)
 		TCPSSLHandshakeComplete(hTCP);
 		SSLHashFree(&sslStub.idMD5);
 		SSLHashFree(&sslStub.idSHA1);
+		SSLSessionRelease(TRUE);
 	}
 	else
 		TCPRequestSSLMessage(hTCP, SSL_CHANGE_CIPHER_SPEC);
@@ -2812,33 +2928,42 @@ static void SSLBufferSync(BYTE id)
  *
  * Output:          Allocated Session ID, or SSL_INVALID_ID if none available
  *
- * Side Effects:    None
+ * Side Effects:    The session is held until SSLSessionRelease()
  *
  * Overview:        Finds space for a new SSL session
  *
- * Note:            None
+ * Note:            A free session is taken first, else the least
+ *					recently used one, or an expired one, that no
+ *					handshake holds.  Sessions are not kept for a
+ *					minimum time, so a burst of full handshakes 
+ *					cannot run out of them.
  ********************************************************************/
 static BYTE SSLSessionNew(void)
 {
 	BYTE id, oldestID;
-	DWORD now, age, oldest;
+	DWORD age, oldest;
 	
 	// Set up the search
 	oldestID = SSL_INVALID_ID;
-	oldest = SSL_MIN_SESSION_LIFETIME;
-	now = TickGet();
+	oldest = 0;
 		
 	// Search for a free session
 	for(id = 0; id != MAX_SSL_SESSIONS; id++)
 	{
+		// Skip sessions that handshakes are using
+		if(sslSessionHolds[id] != 0u)
+			continue;
+
 		if(sslSessionStubs[id].tag.Val == 0u)
 		{// Unused session, so claim immediately
 			break;
 		}
 		
-		// Check how old this session is
-		age = now - sslSessionStubs[id].lastUsed;
-		if(age > oldest)
+		// Check how long ago this session was used
+		age = dwSessionUseCount - sslSessionStubs[id].lastUsed;
+		if(SSLSessionExpired(id))
+			age = 0xFFFFFFFFul;
+		if(oldestID == SSL_INVALID_ID || age > oldest)
 		{// This is now the oldest one
 			oldest = age;
 			oldestID = id;
@@ -2846,26 +2971,75 @@ static BYTE SSLSessionNew(void)
 	}
 	
 	// Check if we can claim a session
-	if(id == MAX_SSL_SESSIONS && oldestID != SSL_INVALID_ID)
+	if(id == MAX_SSL_SESSIONS)
+	{
+		if(oldestID == SSL_INVALID_ID)
+		{
+			sslSessionStats.dwRefused++;
+			return SSL_INVALID_ID;
+		}
 		id = oldestID;
+		sslSessionStats.dwEvicted++;
+	}
+	
+	// Save old one if needed
+	if(sslSessionUpdated && sslSessionID != SSL_INVALID_ID)
+		SaveOffChip((BYTE*)&sslSession,
+			SSL_BASE_SESSION_ADDR+SSL_SESSION_SIZE*sslSessionID,
+			SSL_SESSION_SIZE);
+	
+	// Set up the new session, untagged so that it cannot be matched
+	// until the handshake tags it
+	sslSessionID = id;
+	sslSessionStubs[id].tag.Val = 0;
+	sslSessionStubs[id].lastUsed = ++dwSessionUseCount;
+	sslSessionStubs[id].created = TickGetDiv64K();
+	sslSessionHolds[id]++;
+	sslSessionStats.dwNew++;
+	SSLSessionUpdated();
+	return id;
+}
+
+/*********************************************************************
+ * Function:        static void SSLSessionRelease(BOOL bComplete)
+ *
+ * PreCondition:    sslStub is synchronized
+ *
+ * Input:           bComplete - TRUE if the handshake completed
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Releases the stub's hold on its session.  A new
+ *					session becomes resumable if its handshake
+ *					completed, and is freed if not.
+ *
+ * Note:            None
+ ********************************************************************/
+static void SSLSessionRelease(BOOL bComplete)
+{
+	BYTE id;
 	
-	// If a valid ID was found, claim it
-	if(id < MAX_SSL_SESSIONS)
+	id = sslStub.idSession;
+	if(id == SSL_INVALID_ID || sslSessionHolds[id] == 0u)
+		return;
+	sslSessionHolds[id]--;
+	
+	if(!sslStub.Flags.bNewSession)
+		return;
+	if(!bComplete)
 	{
-		// Save old one if needed
-		if(sslSessionUpdated)
-			SaveOffChip((BYTE*)&sslSession,
-				SSL_BASE_SESSION_ADDR+SSL_SESSION_SIZE*sslSessionID,
-				SSL_SESSION_SIZE);
-		
-		// Set up the new session
-		sslSessionID = id;
-		sslSessionStubs[id].lastUsed = now;
-		SSLSessionUpdated();
-		return id;
+		sslSessionStubs[id].tag.Val = 0;
+		return;
 	}
 	
-	return SSL_INVALID_ID;
+	// A server's session ID may be resumed from now on
+	if(sslStub.Flags.bIsServer)
+		sslSessionStubs[id].tag.v[0] = 0;
+	#if defined(SSL_SESSION_PERSIST)
+	sslSessionsChanged = TRUE;
+	#endif
 }
 
 /*********************************************************************
@@ -2877,12 +3051,12 @@ static BYTE SSLSessionNew(void)
  *
  * Output:          The matched session ID, or SSL_INVALID_ID if not found
  *
- * Side Effects:    None
+ * Side Effects:    The session is held until SSLSessionRelease()
  *
  * Overview:        Locates a cached SSL session for reuse.  Syncs 
  *                  found session into RAM.
  *
- * Note:            None
+ * Note:            Expired sessions are freed rather than resumed.
  ********************************************************************/
 #if defined(STACK_USE_SSL_SERVER)
 static BYTE SSLSessionMatchID(BYTE* SessionID)
@@ -2892,7 +3066,8 @@ static BYTE SSLSessionMatchID(BYTE* SessionID)
 	for(i = 0; i < MAX_SSL_SESSIONS; i++)
 	{
 		// Check if tag matches the ID
-		if(sslSessionStubs[i].tag.v[0] == 0u &&
+		if(sslSessionStubs[i].tag.Val != 0u &&
+			sslSessionStubs[i].tag.v[0] == 0u &&
 			!memcmp((void*)&sslSessionStubs[i].tag.v[1], (void*)SessionID, 3) )
 		{
 			// Found a partial match, so load it to memory
@@ -2902,14 +3077,25 @@ static BYTE SSLSessionMatchID(BYTE* SessionID)
 			if(memcmp((void*)sslSession.sessionID, (void*)SessionID, 32) != 0)
 				continue;
 			
+			// Too old to resume, so free it
+			if(SSLSessionExpired(i))
+			{
+				if(sslSessionHolds[i] == 0u)
+					sslSessionStubs[i].tag.Val = 0;
+				break;
+			}
+			
 			// Mark it as being used now
-			sslSessionStubs[i].lastUsed = TickGet();
+			sslSessionStubs[i].lastUsed = ++dwSessionUseCount;
+			sslSessionHolds[i]++;
+			sslSessionStats.dwHits++;
 			
 			// Return this session for use
 			return i;
 		}
 	}
 	
+	sslSessionStats.dwMisses++;
 	return SSL_INVALID_ID;
 
 }
@@ -2924,7 +3110,7 @@ static BYTE SSLSessionMatchID(BYTE* SessionID)
  *
  * Output:          The matched session ID, or SSL_INVALID_ID if not found
  *
- * Side Effects:    None
+ * Side Effects:    The session is held until SSLSessionRelease()
  *
  * Overview:        Locates a cached SSL session for reuse
  *
@@ -2938,13 +3124,17 @@ static BYTE SSLSessionMatchIP(IP_ADDR ip)
 	for(i = 0; i < MAX_SSL_SESSIONS; i++)
 	{
 		// Check if tag matches the IP
-		if(!memcmp((void*)&sslSessionStubs[i].tag.v[0], (void*)&ip, 4))
+		if(sslSessionStubs[i].tag.Val != 0u &&
+			!memcmp((void*)&sslSessionStubs[i].tag.v[0], (void*)&ip, 4) &&
+			!SSLSessionExpired(i))
 		{
 			// Found a match, so load it to memory
 			SSLSessionSync(i);
 			
 			// Mark it as being used now
-			sslSessionStubs[i].lastUsed = TickGet();
+			sslSessionStubs[i].lastUsed = ++dwSessionUseCount;
+			sslSessionHolds[i]++;
+			sslSessionStats.dwHits++;
 			
 			// Return this session for use
 			return i;
@@ -2952,6 +3142,7 @@ static BYTE SSLSessionMatchIP(IP_ADDR ip)
 	}
 	
 	// No match so return invalid
+	sslSessionStats.dwMisses++;
 	return SSL_INVALID_ID;
 }
 #endif
@@ -2993,6 +3184,221 @@ static void SSLSessionSync(BYTE id)
 	sslSessionUpdated = FALSE;
 }
 
+#if defined(SSL_SESSION_PERSIST)
+/*********************************************************************
+ * Function:        void SSLSessionSaveTask(void)
+ *
+ * PreCondition:    SSL has been initialized and the calling task 
+ *					owns the SPI Flash
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    Uses the SSL buffer and hash as temporary space
+ *
+ * Overview:        Writes the resumable server sessions to SPI Flash
+ *					if a new one has completed its handshake, at most
+ *					once every SSL_SESSION_SAVE_PERIOD, so that they
+ *					survive a reset.
+ *
+ * Note:            Called from StackApplications().  The sessions are
+ *					sealed with ARCFOUR and an HMAC-SHA1 under keys 
+ *					hashed from a fresh nonce and the RSA private key,
+ *					as the master secrets must stay as secret as it.
+ ********************************************************************/
+void SSLSessionSaveTask(void)
+{
+	SSL_SAVED_HEADER header;
+	SSL_SAVED_STUB saved;
+	ARCFOUR_CTX ctx;
+	BYTE i, encKey[20], macKey[20], data[20];
+	WORD w;
+	DWORD now;
+	
+	// Only save when something changed, and not too often
+	if(!sslSessionsChanged || TickGet() - dwSessionSaveTick < (DWORD)SSL_SESSION_SAVE_PERIOD)
+		return;
+	sslSessionsChanged = FALSE;
+	dwSessionSaveTick = TickGet();
+	
+	// Count the sessions a client could resume
+	header.magic = SSL_SESSION_MAGIC;
+	header.count = 0;
+	for(i = 0; i < MAX_SSL_SESSIONS; i++)
+	{
+		if(sslSessionStubs[i].tag.Val != 0u && sslSessionStubs[i].tag.v[0] == 0u)
+			header.count++;
+	}
+	RandomGetArray(header.nonce, sizeof(header.nonce));
+	
+	// Set up the cipher and MAC in the temporary buffer and hash
+	SSLBufferSync(SSL_INVALID_ID);
+	SSLHashSync(SSL_INVALID_ID);
+	SSLSessionKey('K', header.nonce, encKey);
+	SSLSessionKey('M', header.nonce, macKey);
+	ctx.Sbox = sslBuffer.full;
+	ARCFOURInitialize(&ctx, encKey, 16);
+	SSLSessionMACStart(macKey, 0x36);
+	SHA1AddData(&sslHash, (BYTE*)&header, sizeof(header));
+	
+	// Write the header, then each session, erasing the sector first
+	SST25BeginWrite(SSL_SESSION_FLASH_ADDR);
+	SST25WriteIncrementalArray((BYTE*)&header, sizeof(header));
+	now = TickGetDiv64K();
+	for(i = 0; i < MAX_SSL_SESSIONS; i++)
+	{
+		if(sslSessionStubs[i].tag.Val == 0u || sslSessionStubs[i].tag.v[0] != 0u)
+			continue;
+		
+		saved.tag = sslSessionStubs[i].tag;
+		saved.age = now - sslSessionStubs[i].created;
+		saved.uses = dwSessionUseCount - sslSessionStubs[i].lastUsed;
+		SSLSessionPutSealed(&ctx, (BYTE*)&saved, sizeof(saved));
+		
+		SSLSessionSync(i);
+		for(w = 0; w < SSL_SESSION_SIZE; w += 16)
+		{
+			memcpy((void*)data, (void*)((BYTE*)&sslSession + w), mMIN(16, SSL_SESSION_SIZE - w));
+			SSLSessionPutSealed(&ctx, data, mMIN(16, SSL_SESSION_SIZE - w));
+		}
+	}
+	
+	// Finish with the MAC
+	SSLSessionMACEnd(macKey, data);
+	SST25WriteIncrementalArray(data, 20);
+	SST25EndWrite();
+	sslSessionStats.dwSaved++;
+}
+
+/*********************************************************************
+ * Function:        static void SSLSessionRestore(void)
+ *
+ * PreCondition:    The session stubs are free
+ *
+ * Input:           None
+ *
+ * Output:          None
+ *
+ * Side Effects:    Uses the SSL buffer and hash as temporary space
+ *
+ * Overview:        Reads the sessions that SSLSessionSaveTask() wrote
+ *					back into the cache, if their MAC verifies.
+ *
+ * Note:            Their creation times and use order carry over, so
+ *					they expire and are replaced as if there had been
+ *					no reset.
+ ********************************************************************/
+static void SSLSessionRestore(void)
+{
+	SSL_SAVED_HEADER header;
+	SSL_SAVED_STUB saved;
+	ARCFOUR_CTX ctx;
+	BYTE i, encKey[20], macKey[20], mac[20];
+	WORD w;
+	DWORD addr, len, now;
+	
+	// Check the header
+	SST25ReadArray(SSL_SESSION_FLASH_ADDR, (BYTE*)&header, sizeof(header));
+	if(header.magic != SSL_SESSION_MAGIC || header.count > MAX_SSL_SESSIONS)
+		return;
+	
+	// Check the MAC before decrypting anything
+	SSLBufferSync(SSL_INVALID_ID);
+	SSLHashSync(SSL_INVALID_ID);
+	SSLSessionKey('M', header.nonce, macKey);
+	SSLSessionMACStart(macKey, 0x36);
+	SHA1AddData(&sslHash, (BYTE*)&header, sizeof(header));
+	addr = SSL_SESSION_FLASH_ADDR + sizeof(header);
+	len = header.count * (sizeof(SSL_SAVED_STUB) + SSL_SESSION_SIZE);
+	while(len)
+	{
+		w = mMIN(len, sizeof(sslBuffer.full));
+		SST25ReadArray(addr, sslBuffer.full, w);
+		SHA1AddData(&sslHash, sslBuffer.full, w);
+		addr += w;
+		len -= w;
+	}
+	SSLSessionMACEnd(macKey, mac);
+	SST25ReadArray(addr, macKey, 20);
+	if(memcmp((void*)mac, (void*)macKey, 20) != 0)
+		return;
+	
+	// Decrypt each session into the cache
+	SSLSessionKey('K', header.nonce, encKey);
+	ctx.Sbox = sslBuffer.full;
+	ARCFOURInitialize(&ctx, encKey, 16);
+	addr = SSL_SESSION_FLASH_ADDR + sizeof(header);
+	now = TickGetDiv64K();
+	for(i = 0; i < header.count; i++)
+	{
+		SST25ReadArray(addr, (BYTE*)&saved, sizeof(saved));
+		ARCFOURCrypt(&ctx, (BYTE*)&saved, sizeof(saved));
+		addr += sizeof(saved);
+		SST25ReadArray(addr, (BYTE*)&sslSession, SSL_SESSION_SIZE);
+		ARCFOURCrypt(&ctx, (BYTE*)&sslSession, SSL_SESSION_SIZE);
+		addr += SSL_SESSION_SIZE;
+		
+		sslSessionStubs[i].tag = saved.tag;
+		sslSessionStubs[i].lastUsed = dwSessionUseCount - saved.uses;
+		sslSessionStubs[i].created = now - saved.age;
+		SaveOffChip((BYTE*)&sslSession,
+			SSL_BASE_SESSION_ADDR+SSL_SESSION_SIZE*i,
+			SSL_SESSION_SIZE);
+		sslSessionStats.dwRestored++;
+	}
+	
+	// Nothing is loaded, as sslSession holds the last one decrypted
+	sslSessionID = SSL_INVALID_ID;
+	sslSessionUpdated = FALSE;
+}
+
+// Hashes a 20 byte key for the saved sessions from the label, the 
+// nonce and the RSA private key's primes, in the temporary hash
+static void SSLSessionKey(BYTE label, BYTE *nonce, BYTE *result)
+{
+	SHA1Initialize(&sslHash);
+	SHA1AddData(&sslHash, &label, 1);
+	SHA1AddData(&sslHash, nonce, 16);
+	SHA1AddROMData(&sslHash, SSL_P, sizeof(SSL_P));
+	SHA1AddROMData(&sslHash, SSL_Q, sizeof(SSL_Q));
+	SHA1Calculate(&sslHash, result);
+}
+
+// Starts an HMAC-SHA1 in the temporary hash with the 20 byte key, 
+// padded to the block with pad (0x36 inner, 0x5c outer)
+static void SSLSessionMACStart(BYTE *key, BYTE pad)
+{
+	BYTE i, b;
+	
+	SHA1Initialize(&sslHash);
+	for(i = 0; i < 64u; i++)
+	{
+		b = pad;
+		if(i < 20u)
+			b ^= key[i];
+		SHA1AddData(&sslHash, &b, 1);
+	}
+}
+
+// Finishes the HMAC-SHA1 started by SSLSessionMACStart(key, 0x36)
+static void SSLSessionMACEnd(BYTE *key, BYTE *result)
+{
+	SHA1Calculate(&sslHash, result);
+	SSLSessionMACStart(key, 0x5c);
+	SHA1AddData(&sslHash, result, 20);
+	SHA1Calculate(&sslHash, result);
+}
+
+// Encrypts data in place, adds it to the MAC and writes it to SPI Flash
+static void SSLSessionPutSealed(ARCFOUR_CTX *ctx, BYTE *data, BYTE len)
+{
+	ARCFOURCrypt(ctx, data, len);
+	SHA1AddData(&sslHash, data, len);
+	SST25WriteIncrementalArray(data, len);
+}
+#endif
+
 /*********************************************************************
  * Function:        static void SaveOffChip(BYTE *ramAddr,
  *											WORD ethAddr, WORD len)
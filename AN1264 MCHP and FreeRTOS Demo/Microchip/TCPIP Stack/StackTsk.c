@@ -296,6 +296,9 @@ void StackTask(void)
 				if(!IPGetHeader(&tempLocalIP, &remoteNode, &cIPFrameType, &dataCount))
 					break;
 
+				// Remember where on-link senders are so replies need no ARP
+				ARPLearn(&remoteNode);
+
 				#if defined(STACK_USE_ICMP_SERVER) || defined(STACK_USE_ICMP_CLIENT)
 				if(cIPFrameType == IP_PROT_ICMP)
 				{
@@ -421,4 +424,8 @@ void StackApplications(void)
 	#if defined(STACK_USE_UART2TCP_BRIDGE)
 	UART2TCPBridgeTask();
 	#endif
+	
+	#if defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	BerkeleySocketTask();
+	#endif
 }
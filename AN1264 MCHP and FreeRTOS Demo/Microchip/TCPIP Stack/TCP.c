@@ -114,6 +114,18 @@
 #define TCP_SYN_QUEUE_MAX_ENTRIES	(3u) 					// Number of TCP RX SYN packets to save if they cannot be serviced immediately
 #define TCP_SYN_QUEUE_TIMEOUT		((TICK)TICK_SECOND*3)	// Timeout for when SYN queue entries are deleted if unserviceable
 
+#define TCP_APP_POLL_TIMEOUT		((TICK)TICK_SECOND/100)	// Longest time TCPGetNextEvent() reports while an application may still have buffered work to do
+
+// Number of buckets in each of the socket lookup tables used by 
+// FindMatchingSocket().  Must be a power of two; one byte of RAM is used 
+// per bucket and table.  Around TCP_SOCKET_COUNT keeps the chains short.
+#if !defined(TCP_HASH_BUCKETS)
+	#define TCP_HASH_BUCKETS		(16u)
+#endif
+#if (TCP_HASH_BUCKETS == 0u) || ((TCP_HASH_BUCKETS & (TCP_HASH_BUCKETS-1u)) != 0u)
+	#error TCP_HASH_BUCKETS must be a power of two
+#endif
+
 /****************************************************************************
   Section:
 	TCP Header Data Types
@@ -231,6 +243,29 @@ static WORD NextPort __attribute__((persistent));	// Tracking variable for next
 
 static TCB MyTCB;									// Currently loaded TCB
 static TCP_SOCKET hCurrentTCP = INVALID_SOCKET;		// Current TCP socket
+
+// Socket lookup tables.  Every socket that is not closed is chained into 
+// one bucket according to the key FindMatchingSocket() compares: 
+// listening sockets by local port (remoteHash), all others by the 
+// remoteHash of their remote IP, remote port and local port.  The keys 
+// are kept here rather than read from TCBStubs[] so that a lookup touches 
+// no stub or TCB other than the one that matches.
+#define TCP_CHAIN_NONE			(0u)	// Socket is closed and in no chain
+#define TCP_CHAIN_CONNECTION	(1u)	// Chained in hConnectionHead[]
+#define TCP_CHAIN_LISTENER		(2u)	// Chained in hListenerHead[]
+#define TCP_HASH_BUCKET(w)		((BYTE)((w) ^ ((w)>>8)) & (TCP_HASH_BUCKETS-1u))
+
+static TCP_SOCKET hConnectionHead[TCP_HASH_BUCKETS];	// First socket of each connection chain
+static TCP_SOCKET hListenerHead[TCP_HASH_BUCKETS];		// First socket of each listener chain
+static TCP_SOCKET hNextInChain[TCP_SOCKET_COUNT];		// Next socket in the same chain
+static WORD wChainKey[TCP_SOCKET_COUNT];				// Key the socket is chained under
+static BYTE vChain[TCP_SOCKET_COUNT];					// TCP_CHAIN_* the socket is in
+#if defined(STACK_USE_SSL_SERVER)
+	static TCP_SOCKET hSSLListenerHead[TCP_HASH_BUCKETS];	// Listeners by SSL port
+	static TCP_SOCKET hNextSSLListener[TCP_SOCKET_COUNT];
+	static WORD wSSLListenerKey[TCP_SOCKET_COUNT];		// SSL port, or 0 if not chained
+#endif
+
 #if TCP_SYN_QUEUE_MAX_ENTRIES
 	#if defined(__18CXX) && !defined(HI_TECH_C)	
 		#pragma udata SYN_QUEUE_RAM_SECT
@@ -260,6 +295,10 @@ static BOOL FindMatchingSocket(TCP_HEADER* h, NODE_INFO* remote);
 static void SwapTCPHeader(TCP_HEADER* header);
 static void CloseSocket(void);
 static void SyncTCB(void);
+static void UpdateSocketLookup(void);
+static void ChainSocket(TCP_SOCKET* hHead, TCP_SOCKET* hNext, TCP_SOCKET hTCP, WORD wKey);
+static void UnchainSocket(TCP_SOCKET* hHead, TCP_SOCKET* hNext, TCP_SOCKET hTCP, WORD wKey);
+static DWORD EarlierEvent(DWORD dwNext, LONG lTicks);
 
 // Indicates if this packet is a retransmission (no reset) or a new packet (reset required)
 #define SENDTCP_RESET_TIMERS	0x01
@@ -384,6 +423,16 @@ void TCPInit(void)
 	#if TCP_SYN_QUEUE_MAX_ENTRIES
 		memset((void*)SYNQueue, 0x00, sizeof(SYNQueue));
 	#endif
+
+	// Empty the socket lookup tables.  CloseSocket() below files each 
+	// socket as closed.
+	memset((void*)hConnectionHead, INVALID_SOCKET, sizeof(hConnectionHead));
+	memset((void*)hListenerHead, INVALID_SOCKET, sizeof(hListenerHead));
+	memset((void*)vChain, TCP_CHAIN_NONE, sizeof(vChain));
+	#if defined(STACK_USE_SSL_SERVER)
+		memset((void*)hSSLListenerHead, INVALID_SOCKET, sizeof(hSSLListenerHead));
+		memset((void*)wSSLListenerKey, 0x00, sizeof(wSSLListenerKey));
+	#endif
 	
 	// Allocate all socket FIFO addresses
 	vSocketsAllocated = 0;
@@ -623,6 +672,7 @@ TCP_SOCKET TCPOpen(DWORD dwRemoteHost, BYTE vRemoteHostType, WORD wPort, BYTE vS
 			#endif
 		}
 		
+		UpdateSocketLookup();
 		return hTCP;		
 	}
 
@@ -840,6 +890,7 @@ void TCPDisconnect(TCP_SOCKET hTCP)
 
 		case TCP_CLOSED_BUT_RESERVED:
 			MyTCBStub.smState = TCP_CLOSED;
+			UpdateSocketLookup();
 			break;
 
 		// These states will close themselves after some delay, however, 
@@ -966,6 +1017,13 @@ void TCPFlush(TCP_SOCKET hTCP)
 	SyncTCBStub(hTCP);
 	SyncTCB();
 
+	// Data behind a reserved header waits for TCPPutHeader()
+	if(MyTCBStub.Flags.bTxHold)
+	{
+		MyTCBStub.Flags.bTxHoldFlush = 1;
+		return;
+	}
+
 	// NOTE: Pending SSL data will NOT be transferred here
 
 	if(MyTCBStub.txHead != MyTCB.txUnackedTail)
@@ -1406,6 +1464,122 @@ ROM BYTE* TCPPutROMString(TCP_SOCKET hTCP, ROM BYTE* data)
 }
 #endif
 
+/*****************************************************************************
+  Function:
+	BOOL TCPReserveHeader(TCP_SOCKET hTCP, WORD wLen)
+
+  Summary:
+	Reserves space in the TX FIFO for a header written later.
+
+  Description:
+	Reserves wLen bytes at the current write position for a header whose
+	contents depend on data written after it, such as a length.  The 
+	application writes the data as usual, then fills in the header with 
+	TCPPutHeader().  Until then nothing from the reserved bytes on is
+	transmitted, and any flush requested in between is deferred.
+
+  Precondition:
+	TCP is initialized.
+
+  Parameters:
+	hTCP - The socket to which data is to be written.
+	wLen - Number of bytes to reserve.
+
+  Return Values:
+	TRUE - The space was reserved.
+	FALSE - The TX FIFO has less than wLen bytes free, or the socket is
+			not connected or uses SSL.
+
+  Remarks:
+	TCPPutHeader() must be called before returning to the main stack 
+	loop.  Only one header may be reserved on a socket at a time.
+  ***************************************************************************/
+BOOL TCPReserveHeader(TCP_SOCKET hTCP, WORD wLen)
+{
+	SyncTCBStub(hTCP);
+
+	#if defined(STACK_USE_SSL)
+	if(MyTCBStub.sslStubID != SSL_INVALID_ID)
+		return FALSE;
+	#endif
+
+	if(MyTCBStub.Flags.bTxHold || TCPIsPutReady(hTCP) < wLen)
+		return FALSE;
+
+	MyTCBStub.Flags.bTxHold = 1;
+	MyTCBStub.Flags.bTxHoldFlush = 0;
+	MyTCBStub.txHead += wLen;
+	if(MyTCBStub.txHead >= MyTCBStub.bufferRxStart)
+		MyTCBStub.txHead -= MyTCBStub.bufferRxStart - MyTCBStub.bufferTxStart;
+
+	return TRUE;
+}
+
+/*****************************************************************************
+  Function:
+	void TCPPutHeader(TCP_SOCKET hTCP, BYTE* hdr, WORD wLen, WORD wDataLen)
+
+  Summary:
+	Fills in a header reserved with TCPReserveHeader().
+
+  Description:
+	Writes hdr into the wLen bytes reserved by TCPReserveHeader(), which
+	are followed by the wDataLen bytes written since.  If hdr is NULL 
+	and nothing was written since, the reserved bytes are removed 
+	instead.  Transmission then resumes, and a flush deferred while the 
+	header was reserved is carried out.
+
+  Precondition:
+	TCPReserveHeader() returned TRUE for this socket.
+
+  Parameters:
+	hTCP - The socket the header was reserved on.
+	hdr - The header, or NULL to remove it.
+	wLen - Length of the header, as reserved.
+	wDataLen - Number of bytes written after the header.
+
+  Returns:
+	None
+  ***************************************************************************/
+void TCPPutHeader(TCP_SOCKET hTCP, BYTE* hdr, WORD wLen, WORD wDataLen)
+{
+	PTR_BASE ptrHeader;
+	WORD w;
+
+	SyncTCBStub(hTCP);
+
+	if(!MyTCBStub.Flags.bTxHold)
+		return;
+	MyTCBStub.Flags.bTxHold = 0;
+
+	// Find the reserved bytes, allowing for the FIFO wrapping
+	ptrHeader = MyTCBStub.txHead - MyTCBStub.bufferTxStart;
+	if(ptrHeader < (PTR_BASE)(wLen + wDataLen))
+		ptrHeader += MyTCBStub.bufferRxStart - MyTCBStub.bufferTxStart;
+	ptrHeader += MyTCBStub.bufferTxStart - wLen - wDataLen;
+
+	if(hdr == NULL)
+	{// Nothing follows, so just move the write position back
+		if(wDataLen == 0u)
+			MyTCBStub.txHead = ptrHeader;
+	}
+	else
+	{
+		for(w = 0; w < wLen; w++)
+		{
+			TCPRAMCopy(ptrHeader, MyTCBStub.vMemoryMedium, (PTR_BASE)&hdr[w], TCP_PIC_RAM, sizeof(BYTE));
+			if(++ptrHeader >= MyTCBStub.bufferRxStart)
+				ptrHeader = MyTCBStub.bufferTxStart;
+		}
+	}
+
+	if(MyTCBStub.Flags.bTxHoldFlush)
+	{
+		MyTCBStub.Flags.bTxHoldFlush = 0;
+		TCPFlush(hTCP);
+	}
+}
+
 /*****************************************************************************
   Function:
 	WORD TCPGetTxFIFOFull(TCP_SOCKET hTCP)
@@ -2326,6 +2500,7 @@ void TCPTick(void)
 						MyTCBStub.remoteHash.Val = (MyTCB.remote.niRemoteMACIP.IPAddr.w[1] + MyTCB.remote.niRemoteMACIP.IPAddr.w[0] + MyTCB.remotePort.Val) ^ MyTCB.localPort.Val;
 						vFlags = SYN | ACK;
 						MyTCBStub.smState = TCP_SYN_RECEIVED;
+						UpdateSocketLookup();
 						
 						// Delete this SYN from the SYNQueue and compact the SYNQueue[] array
 						TCPRAMCopy((PTR_BASE)&SYNQueue[w], TCP_PIC_RAM, (PTR_BASE)&SYNQueue[w+1], TCP_PIC_RAM, (TCP_SYN_QUEUE_MAX_ENTRIES-1u-w)*sizeof(TCP_SYN_QUEUE));
@@ -2370,7 +2545,10 @@ void TCPTick(void)
 						// The application must call TCPDisconnect() with the handle to free this 
 						// socket (and the handle associated with it)
 						if(!vFlags)
+						{
 							MyTCBStub.smState = TCP_CLOSED_BUT_RESERVED;
+							UpdateSocketLookup();
+						}
 						
 						continue;
 					}
@@ -2426,6 +2604,7 @@ void TCPTick(void)
 						MyTCB.remote.niRemoteMACIP.IPAddr.Val = ipResolvedDNSIP.Val;
 						MyTCBStub.smState = TCP_GATEWAY_SEND_ARP;
 						MyTCBStub.remoteHash.Val = (MyTCB.remote.niRemoteMACIP.IPAddr.w[1]+MyTCB.remote.niRemoteMACIP.IPAddr.w[0] + MyTCB.remotePort.Val) ^ MyTCB.localPort.Val;
+						UpdateSocketLookup();
 						MyTCB.retryCount = 0;
 						MyTCB.retryInterval = (TICK_SECOND/4)/256;
 					}
@@ -2641,6 +2820,102 @@ void TCPTick(void)
 	#endif
 }
 
+/*****************************************************************************
+  Function:
+	DWORD TCPGetNextEvent(void)
+
+  Summary:
+  	Determines how long until TCPTick() next has work to do.
+
+  Description:
+	Checks the same timers that TCPTick() services on each socket 
+	(retransmission, keep-alive, delayed ACK, window update and automatic 
+	transmission, and CLOSE_WAIT) and returns the time until the earliest 
+	one expires.  A task driving the stack can sleep this long, or until a 
+	packet arrives, instead of calling TCPTick() at a fixed rate.
+	
+	Work that may progress without another packet arriving limits the 
+	result to TCP_APP_POLL_TIMEOUT.  This covers sockets holding RX data 
+	the application has not read yet, SSL sessions, and SYNs waiting in the 
+	SYN queue for a listening socket.  An SSL session part way through an 
+	RSA operation returns 0, as each call to TCPTick() advances it by one 
+	RSAStep() and nothing else will wake the stack for it.
+
+  Precondition:
+	TCP is initialized.
+
+  Parameters:
+	None
+
+  Returns:
+	Ticks until TCPTick() should next be called, 0 if it has work to do 
+	now, or TCP_NO_EVENT if no timer is running.
+  ***************************************************************************/
+DWORD TCPGetNextEvent(void)
+{
+	TCP_SOCKET hTCP;
+	DWORD dwNext;
+	DWORD dwNow;
+	WORD wNow;
+
+	#if defined(STACK_USE_SSL)
+	if(SSLRSAPending())
+		return 0;
+	#endif
+
+	dwNext = TCP_NO_EVENT;
+	dwNow = TickGet();
+	wNow = (WORD)TickGetDiv256();
+
+	for(hTCP = 0; hTCP < TCP_SOCKET_COUNT; hTCP++)
+	{
+		SyncTCBStub(hTCP);
+
+		// Transmissions that found the MAC busy are retried on every call
+		if(MyTCBStub.Flags.bTXASAP || MyTCBStub.Flags.bTXASAPWithoutTimerReset)
+			return 0;
+
+		// These timers count in units of 256 ticks
+		if(MyTCBStub.Flags.bTimer2Enabled)
+			dwNext = EarlierEvent(dwNext, (LONG)(SHORT)(MyTCBStub.eventTime2 - wNow) * 256);
+		if(MyTCBStub.Flags.bDelayedACKTimerEnabled)
+			dwNext = EarlierEvent(dwNext, (LONG)(SHORT)(MyTCBStub.OverlappedTimers.delayedACKTime - wNow) * 256);
+		if(MyTCBStub.smState == TCP_CLOSE_WAIT)
+			dwNext = EarlierEvent(dwNext, (LONG)(SHORT)(MyTCBStub.OverlappedTimers.closeWaitTime - wNow) * 256);
+
+		if(MyTCBStub.Flags.bTimerEnabled)
+			dwNext = EarlierEvent(dwNext, (LONG)(MyTCBStub.eventTime - dwNow));
+		#if defined(TCP_KEEP_ALIVE_TIMEOUT)
+		else if(MyTCBStub.smState == TCP_ESTABLISHED)
+			dwNext = EarlierEvent(dwNext, (LONG)(MyTCBStub.eventTime - dwNow));
+		#endif
+
+		if(MyTCBStub.rxHead != MyTCBStub.rxTail)
+			dwNext = EarlierEvent(dwNext, TCP_APP_POLL_TIMEOUT);
+		#if defined(STACK_USE_SSL)
+		if(MyTCBStub.sslStubID != SSL_INVALID_ID)
+			dwNext = EarlierEvent(dwNext, TCP_APP_POLL_TIMEOUT);
+		#endif
+	}
+
+	#if TCP_SYN_QUEUE_MAX_ENTRIES
+	if(SYNQueue[0].wDestPort != 0u)
+		dwNext = EarlierEvent(dwNext, TCP_APP_POLL_TIMEOUT);
+	#endif
+
+	return dwNext;
+}
+
+// Returns the sooner of dwNext and an event lTicks from now, treating an 
+// event that is already due as 0
+static DWORD EarlierEvent(DWORD dwNext, LONG lTicks)
+{
+	if(lTicks <= 0)
+		return 0;
+
+	return ((DWORD)lTicks < dwNext) ? (DWORD)lTicks : dwNext;
+}
+
 
 /*****************************************************************************
   Function:
@@ -3075,6 +3350,10 @@ static void SendTCP(BYTE vTCPFlags, BYTE vSendFlags)
 	a given TCP header and NODE_INFO structure.  If a socket is found, its 
 	index is saved in hCurrentTCP and the associated MyTCBStub and MyTCB are
 	loaded. Otherwise, INVALID_SOCKET is placed in hCurrentTCP.
+
+	The search goes through the socket lookup tables, so only the sockets 
+	chained under the segment's remoteHash or destination port are 
+	examined, and only a socket whose key matches has its TCB loaded.
 	
   Precondition:
 	TCP is initialized.
@@ -3100,35 +3379,14 @@ static BOOL FindMatchingSocket(TCP_HEADER* h, NODE_INFO* remote)
 	partialMatch = INVALID_SOCKET;
 	hash = (remote->IPAddr.w[1]+remote->IPAddr.w[0] + h->SourcePort) ^ h->DestPort;
 
-	// Loop through all sockets looking for a socket that is expecting this 
-	// packet or can handle it.
-	for(hTCP = 0; hTCP < TCP_SOCKET_COUNT; hTCP++ )
+	// Look for a connected socket that is expecting this packet.  Different 
+	// connections can share a hash, so the TCB of each candidate is checked.
+	for(hTCP = hConnectionHead[TCP_HASH_BUCKET(hash)]; hTCP != INVALID_SOCKET; hTCP = hNextInChain[hTCP])
 	{
-		SyncTCBStub(hTCP);
-
-		if(MyTCBStub.smState == TCP_CLOSED)
-		{
+		if(wChainKey[hTCP] != hash)
 			continue;
-		}
-		else if(MyTCBStub.smState == TCP_LISTEN)
-		{// For listening ports, check if this is the correct port
-			if(MyTCBStub.remoteHash.Val == h->DestPort)
-				partialMatch = hTCP;
-			
-			#if defined(STACK_USE_SSL_SERVER)
-			// Check the SSL port as well for SSL Servers
-			// 0 is defined as an invalid port number
-			if(MyTCBStub.sslTxHead == h->DestPort)
-				partialMatch = hTCP;
-			#endif
-			
-			continue;
-		}
-		else if(MyTCBStub.remoteHash.Val != hash)
-		{// Ignore if the hash doesn't match
-			continue;
-		}
 
+		SyncTCBStub(hTCP);
 		SyncTCB();
 		if(	h->DestPort == MyTCB.localPort.Val &&
 			h->SourcePort == MyTCB.remotePort.Val &&
@@ -3138,6 +3396,26 @@ static BOOL FindMatchingSocket(TCP_HEADER* h, NODE_INFO* remote)
 		}
 	}
 
+	// Otherwise look for a socket listening on the destination port
+	for(hTCP = hListenerHead[TCP_HASH_BUCKET(h->DestPort)]; hTCP != INVALID_SOCKET; hTCP = hNextInChain[hTCP])
+	{
+		if(wChainKey[hTCP] == h->DestPort)
+		{
+			partialMatch = hTCP;
+			break;
+		}
+	}
+
+	#if defined(STACK_USE_SSL_SERVER)
+	// Check the SSL port as well for SSL Servers
+	// 0 is defined as an invalid port number
+	for(hTCP = hSSLListenerHead[TCP_HASH_BUCKET(h->DestPort)]; partialMatch == INVALID_SOCKET && hTCP != INVALID_SOCKET; hTCP = hNextSSLListener[hTCP])
+	{
+		if(wSSLListenerKey[hTCP] == h->DestPort)
+			partialMatch = hTCP;
+	}
+	#endif
+
 
 	// If there is a partial match, then a listening socket is currently 
 	// available.  Set up the extended TCB with the info needed 
@@ -3165,6 +3443,7 @@ static BOOL FindMatchingSocket(TCP_HEADER* h, NODE_INFO* remote)
 		if(partialMatch != INVALID_SOCKET)
 		{
 			MyTCBStub.remoteHash.Val = hash;
+			UpdateSocketLookup();
 		
 			memcpy((void*)&MyTCB.remote, (void*)remote, sizeof(NODE_INFO));
 			MyTCB.remotePort.Val = h->SourcePort;
@@ -3248,6 +3527,101 @@ static BOOL FindMatchingSocket(TCP_HEADER* h, NODE_INFO* remote)
 }
 
 
+/*****************************************************************************
+  Function:
+	static void UpdateSocketLookup(void)
+
+  Summary:
+	Refiles the current socket in the socket lookup tables.
+
+  Description:
+	Moves the socket in hCurrentTCP to the lookup table chain that matches
+	its present state and remoteHash: none when closed, the listener 
+	table when listening, and the connection table otherwise.  For SSL 
+	servers a listening socket is also chained under its SSL port.  Does 
+	nothing if the socket is already filed correctly.
+
+  Precondition:
+	The TCPStub corresponding to the socket is synced.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+	
+  Remarks:
+	Must be called whenever smState moves into or out of TCP_CLOSED or 
+	TCP_LISTEN, and whenever remoteHash (or a listener's SSL port) is 
+	changed, or FindMatchingSocket() will not find the socket.
+  ***************************************************************************/
+static void UpdateSocketLookup(void)
+{
+	BYTE vNewChain;
+	WORD wNewKey;
+
+	if(MyTCBStub.smState == TCP_CLOSED)
+		vNewChain = TCP_CHAIN_NONE;
+	else if(MyTCBStub.smState == TCP_LISTEN)
+		vNewChain = TCP_CHAIN_LISTENER;
+	else
+		vNewChain = TCP_CHAIN_CONNECTION;
+	wNewKey = MyTCBStub.remoteHash.Val;
+
+	if(vChain[hCurrentTCP] != vNewChain || wChainKey[hCurrentTCP] != wNewKey)
+	{
+		if(vChain[hCurrentTCP] == TCP_CHAIN_CONNECTION)
+			UnchainSocket(hConnectionHead, hNextInChain, hCurrentTCP, wChainKey[hCurrentTCP]);
+		else if(vChain[hCurrentTCP] == TCP_CHAIN_LISTENER)
+			UnchainSocket(hListenerHead, hNextInChain, hCurrentTCP, wChainKey[hCurrentTCP]);
+
+		if(vNewChain == TCP_CHAIN_CONNECTION)
+			ChainSocket(hConnectionHead, hNextInChain, hCurrentTCP, wNewKey);
+		else if(vNewChain == TCP_CHAIN_LISTENER)
+			ChainSocket(hListenerHead, hNextInChain, hCurrentTCP, wNewKey);
+
+		vChain[hCurrentTCP] = vNewChain;
+		wChainKey[hCurrentTCP] = wNewKey;
+	}
+
+	#if defined(STACK_USE_SSL_SERVER)
+	// Listening sockets cache their SSL port in sslTxHead; 0 means none
+	wNewKey = (vNewChain == TCP_CHAIN_LISTENER) ? (WORD)MyTCBStub.sslTxHead : 0u;
+	if(wSSLListenerKey[hCurrentTCP] != wNewKey)
+	{
+		if(wSSLListenerKey[hCurrentTCP])
+			UnchainSocket(hSSLListenerHead, hNextSSLListener, hCurrentTCP, wSSLListenerKey[hCurrentTCP]);
+		if(wNewKey)
+			ChainSocket(hSSLListenerHead, hNextSSLListener, hCurrentTCP, wNewKey);
+		wSSLListenerKey[hCurrentTCP] = wNewKey;
+	}
+	#endif
+}
+
+// Adds a socket to the front of the chain for wKey
+static void ChainSocket(TCP_SOCKET* hHead, TCP_SOCKET* hNext, TCP_SOCKET hTCP, WORD wKey)
+{
+	BYTE vBucket = TCP_HASH_BUCKET(wKey);
+
+	hNext[hTCP] = hHead[vBucket];
+	hHead[vBucket] = hTCP;
+}
+
+// Removes a socket from the chain it was added to under wKey
+static void UnchainSocket(TCP_SOCKET* hHead, TCP_SOCKET* hNext, TCP_SOCKET hTCP, WORD wKey)
+{
+	TCP_SOCKET* phLink;
+
+	for(phLink = &hHead[TCP_HASH_BUCKET(wKey)]; *phLink != INVALID_SOCKET; phLink = &hNext[*phLink])
+	{
+		if(*phLink == hTCP)
+		{
+			*phLink = hNext[hTCP];
+			return;
+		}
+	}
+}
+
 
 /*****************************************************************************
   Function:
@@ -3321,6 +3695,7 @@ static void CloseSocket(void)
 	MyTCBStub.Flags.bTXASAP = 0;
 	MyTCBStub.Flags.bTXASAPWithoutTimerReset = 0;
 	MyTCBStub.Flags.bTXFIN = 0;
+	MyTCBStub.Flags.bTxHold = 0;
 	MyTCBStub.Flags.bSocketReset = 1;
 
 	#if defined(STACK_USE_SSL)
@@ -3350,10 +3725,16 @@ static void CloseSocket(void)
 	MyTCB.flags.bRXNoneACKed1 = 0;
 	MyTCB.flags.bRXNoneACKed2 = 0;
 	MyTCB.txUnackedTail = MyTCBStub.bufferTxStart;
+	#if defined(STACK_USE_RANDOM)
+	RandomGetArray((BYTE*)&MyTCB.MySEQ, sizeof(MyTCB.MySEQ));
+	#else
 	((DWORD_VAL*)(&MyTCB.MySEQ))->w[0] = rand();
 	((DWORD_VAL*)(&MyTCB.MySEQ))->w[1] = rand();
+	#endif
 	MyTCB.sHoleSize = -1;
 	MyTCB.remoteWindow = 1;
+
+	UpdateSocketLookup();
 }
 
 
@@ -3445,6 +3826,7 @@ static void HandleTCPSeg(TCP_HEADER* h, WORD len)
 				// Respond with SYN + ACK
 				SendTCP(SYN | ACK, SENDTCP_RESET_TIMERS);
 				MyTCBStub.smState = TCP_SYN_RECEIVED;
+				UpdateSocketLookup();
 			}
 			else
 			{
@@ -4637,6 +5019,7 @@ BOOL TCPAddSSLListener(TCP_SOCKET hTCP, WORD port)
 	
 	MyTCB.localSSLPort.Val = port;
 	MyTCBStub.sslTxHead = port;
+	UpdateSocketLookup();
 
 	return TRUE;
 }
@@ -74,7 +74,7 @@
 
 #define configUSE_PREEMPTION			1
 #define configUSE_IDLE_HOOK				0
-#define configUSE_TICK_HOOK				1
+#define configUSE_TICK_HOOK				0
 #define configTICK_RATE_HZ				( ( portTickType ) 200 )
 
 #if defined(__PIC24F__)
@@ -90,6 +90,25 @@
 #define configMINIMAL_STACK_SIZE		( 240 )
 #define configISR_STACK_SIZE			( 400 )
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY	0x04
+
+/* Stop the tick and put the processor to sleep whenever no task is due to
+run for at least two ticks.  Only the PIC32 port supports this. */
+#define configUSE_TICKLESS_IDLE			1
+
+/* Collect per task run time statistics for the RTOS screen and rtos.xml,
+timed by the core timer. */
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* Set to 1 to record kernel events into a RAM ring buffer that can be saved
+with the debugger and converted with TraceCon/tracedecode.  The timestamps
+come from the core timer, which counts at half the CPU clock.  The queue
+registry names the queues and semaphores in the trace. */
+#define configUSE_TRACE_RECORDER		0
+#define configTRACE_TIMESTAMP_HZ		( configCPU_CLOCK_HZ / 2UL )
+#define configTRACE_BUFFER_RECORDS		( 1024 )
+#if configUSE_TRACE_RECORDER == 1
+	#define configQUEUE_REGISTRY_SIZE	( 12 )
+#endif
 #endif
 
 #define configMAX_PRIORITIES			( ( unsigned portBASE_TYPE ) 6 )
@@ -98,8 +117,16 @@
 #define configUSE_TRACE_FACILITY		0
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
+#define configUSE_TASK_NOTIFICATIONS	1
 #define configCHECK_FOR_STACK_OVERFLOW	2
 
+/* Software timer definitions.  The timer callbacks only post to queues so
+the timer task needs no more stack than the idle task. */
+#define configUSE_TIMERS				1
+#define configTIMER_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH		( 5 )
+#define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE )
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
@@ -41,6 +41,8 @@ void HTTPPrint_config_gw(void);
 void HTTPPrint_config_subnet(void);
 void HTTPPrint_config_dns1(void);
 void HTTPPrint_config_dns2(void);
+void HTTPPrint_rtos_stats(void);
+void HTTPPrint_meter_events(void);
 
 void HTTPPrint(DWORD callbackID)
 {
@@ -112,6 +114,12 @@ void HTTPPrint(DWORD callbackID)
         case 0x00000015:
 			HTTPPrint_config_dns2();
 			break;
+        case 0x00000016:
+			HTTPPrint_rtos_stats();
+			break;
+        case 0x00000017:
+			HTTPPrint_meter_events();
+			break;
 		default:
 			// Output notification for undefined values
 			TCPPutROMArray(sktHTTP, (ROM BYTE*)"!DEF", 4);
@@ -234,13 +234,20 @@
 		#define UART_CONFIG2 (UART_TX_ENABLE | UART_INT_RX_CHAR)
 		#define CLOSEST_BRG ((GetPeripheralClock()+8ul*UART_BAUD_RATE)/16/UART_BAUD_RATE-1)
 		// because of bit alignment we have hardcoded the priority to be
-		// configKERNEL_INTERRUPT_PRIORITY + 1 = 2
-		#define UART_INT_CONFIG (UART_RX_INT_EN | UART_RX_INT_PR2)
+		// configKERNEL_INTERRUPT_PRIORITY + 1 = 2, the TX interrupt is
+		// left disabled until there is something to send
+		#define UART_INT_CONFIG (UART_RX_INT_EN | UART_RX_INT_PR2 | UART_TX_INT_DIS | UART_TX_INT_PR2)
+		// start and stop the TX interrupt, setting the flag forces the
+		// first interrupt when the transmitter is already idle
+		#define UARTTXIntStart()	{ IFS1bits.U2TXIF = 1; IEC1bits.U2TXIE = 1; }
+		#define UARTTXIntStop()		(IEC1bits.U2TXIE = 0)
 	#else					// PIC32
 		#define UART_CONFIG1 (UART_EN)
 		#define UART_CONFIG2 (UART_RX_ENABLE | UART_TX_ENABLE | UART_INT_RX_CHAR)
 		#define CLOSEST_BRG ((GetPeripheralClock()+8ul*UART_BAUD_RATE)/16/UART_BAUD_RATE-1)
 		#define UART_INT_CONFIG ((configKERNEL_INTERRUPT_PRIORITY + 1) | UART_RX_INT_EN)
+		#define UARTTXIntStart()	{ mU2TXSetIntFlag(); mU2TXIntEnable(1); }
+		#define UARTTXIntStop()		mU2TXIntEnable(0)
 	#endif
 
 	#define OpenUART(a,b,c)			OpenUART2(a,b,c)
@@ -272,6 +279,28 @@
 		#define ENC_SPIBRG			(SPI2BRG)
 	#endif
 
+	// Ethernet controller INT output (ENC28J60 or ENC624J600), active low
+	// on external interrupt 4.  By default the TCPIP task polls the
+	// controller every 50ms.  If the controller's INT pin is wired to RA15,
+	// uncomment the lines below to have the task sleep until it fires or a
+	// TCP timer expires instead.  On devices with peripheral pin select
+	// INT4 must also be mapped to this pin.
+	//#define MAC_INT_TRIS			(TRISAbits.TRISA15)
+	//#define MAC_INT_IO				(PORTAbits.RA15)
+	#if defined(__C30__)	// PIC24F
+		//#define MAC_ISR_ENABLE		(IEC3bits.INT4IE)
+		//#define MAC_ISR_FLAG		(IFS3bits.INT4IF)
+		//#define MAC_ISR_POLARITY	(INTCON2bits.INT4EP)
+		//#define MAC_ISR_PRIORITY	(IPC13bits.INT4IP)
+		//#define MAC_ISR_VECTOR		_INT4Interrupt
+	#else					// PIC32
+		//#define MAC_ISR_ENABLE		(IEC0bits.INT4IE)
+		//#define MAC_ISR_FLAG		(IFS0bits.INT4IF)
+		//#define MAC_ISR_POLARITY	(INTCONbits.INT4EP)
+		//#define MAC_ISR_PRIORITY	(IPC4bits.INT4IP)
+		//#define MAC_ISR_VECTOR		_EXTERNAL_4_VECTOR
+	#endif
+
 	// ENC624J600 Interface Configuration
 	// Comment out ENC100_INTERFACE_MODE if you don't have an ENC624J600 or 
 	// ENC424J600.  Otherwise, choose the correct setting for the interface you 
@@ -474,6 +503,10 @@
 	#define UART_CONFIG2 (UART_RX_ENABLE | UART_TX_ENABLE | UART_INT_RX_CHAR)
 	#define CLOSEST_BRG ((GetPeripheralClock()+8ul*UART_BAUD_RATE)/16/UART_BAUD_RATE-1)
 	#define UART_INT_CONFIG ((configKERNEL_INTERRUPT_PRIORITY + 1) | UART_RX_INT_EN)
+	// start and stop the TX interrupt, setting the flag forces the
+	// first interrupt when the transmitter is already idle
+	#define UARTTXIntStart()	{ mU2TXSetIntFlag(); mU2TXIntEnable(1); }
+	#define UARTTXIntStop()		mU2TXIntEnable(0)
 
 	#define OpenUART(a,b,c)			OpenUART2(a,b,c)
 	#define ConfigIntUART(a)		ConfigIntUART2(a)
@@ -494,6 +527,19 @@
 	#define ENC_SPICON1bits		(SPI2CONbits)	
 	#define ENC_SPIBRG			(SPI2BRG)
 
+	// Ethernet controller INT output (ENC28J60 or ENC624J600), active low
+	// on external interrupt 4.  By default the TCPIP task polls the
+	// controller every 50ms.  If the controller's INT pin is wired to RA15,
+	// uncomment the lines below to have the task sleep until it fires or a
+	// TCP timer expires instead.
+	//#define MAC_INT_TRIS			(TRISAbits.TRISA15)
+	//#define MAC_INT_IO				(PORTAbits.RA15)
+	//#define MAC_ISR_ENABLE			(IEC0bits.INT4IE)
+	//#define MAC_ISR_FLAG			(IFS0bits.INT4IF)
+	//#define MAC_ISR_POLARITY		(INTCONbits.INT4EP)
+	//#define MAC_ISR_PRIORITY		(IPC4bits.INT4IP)
+	//#define MAC_ISR_VECTOR			_EXTERNAL_4_VECTOR
+
 	// ENC624J600 Interface Configuration
 	// Comment out ENC100_INTERFACE_MODE if you don't have an ENC624J600 or 
 	// ENC424J600.  Otherwise, choose the correct setting for the interface you 
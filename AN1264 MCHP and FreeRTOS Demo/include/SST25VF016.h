@@ -43,7 +43,7 @@
 #ifndef _SST25VF016_H
 #define _SST25VF016_H
 
-#include "Graphics\Graphics.h"
+#include "GenericTypeDefs.h"
 
 /************************************************************************
 * SST25 Commands                                                       
@@ -56,10 +56,52 @@
 #define SST25_CMD_EWSR     (unsigned)0x50
 #define SST25_CMD_WRSR     (unsigned)0x01
 #define SST25_CMD_SER      (unsigned)0x20
+#define SST25_CMD_AAI      (unsigned)0xAD
+#define SST25_CMD_WRDI     (unsigned)0x04
 
 #define SST25_FLASH_SECTOR_SIZE 		(4096ul)
 #define SST25_FLASH_SECTOR_MASK			(SST25_FLASH_SECTOR_SIZE - 1)
 
+/************************************************************************
+* Read cache (SST25Cache.c)
+* Reads shorter than a line are served from SST25_CACHE_LINES lines of
+* SST25_CACHE_LINE_SIZE bytes read ahead from the flash; 0 lines reads
+* everything straight from the flash.
+************************************************************************/
+#if !defined(SST25_CACHE_LINES)
+	#define SST25_CACHE_LINES			(4u)
+#endif
+#if !defined(SST25_CACHE_LINE_SIZE)
+	#define SST25_CACHE_LINE_SIZE		(64u)
+#endif
+
+// SST25CacheInvalidate() drops every line for this address
+#define SST25_CACHE_ALL					(0xfffffffful)
+
+typedef struct
+{
+	DWORD	dwHits;			// reads, or parts of them, found in a line
+	DWORD	dwMisses;		// lines filled from the flash
+	DWORD	dwDirect;		// reads of a line or more, made past the cache
+} SST25_CACHE_STATS;
+
+/************************************************************************
+* Writes
+* Arrays are programmed a word at a time in auto address increment mode,
+* holding SPI2 for up to SST25_WRITE_BATCH bytes at once.
+************************************************************************/
+#if !defined(SST25_WRITE_BATCH)
+	#define SST25_WRITE_BATCH			(64u)
+#endif
+
+typedef struct
+{
+	DWORD	dwBytes;		// bytes programmed
+	DWORD	dwCommands;		// byte and word program commands
+	DWORD	dwErases;		// sector and chip erases
+	DWORD	dwBusyPolls;	// status reads waiting for a word to program
+} SST25_WRITE_STATS;
+
 
 /************************************************************************
 * Macro: SST25CSLow()                                                   
@@ -189,13 +231,56 @@ BYTE SST25WriteArray(DWORD address, BYTE* pData, WORD nCount);
 /************************************************************************
 * Function: void SST25ReadArray(DWORD address, BYTE* pData, nCount)
 *                                                                       
-* Overview: this function reads  data into buffer specified
+* Overview: this function reads  data into buffer specified, through
+*           the read cache
 *                                                                       
 * Input: flash memory address, pointer to the buffer, data number
 *                                                                       
 ************************************************************************/
 void SST25ReadArray(DWORD address, BYTE* pData, WORD nCount);
 
+/************************************************************************
+* Function: void SST25ReadBlock(DWORD address, BYTE* pData, nCount)
+*                                                                       
+* Overview: this function reads data into buffer specified with one
+*           read command, for the cache
+*                                                                       
+* Input: flash memory address, pointer to the buffer, data number
+*                                                                       
+************************************************************************/
+void SST25ReadBlock(DWORD address, BYTE* pData, WORD nCount);
+
+/************************************************************************
+* Function: void SST25CacheInit(void)
+*                                                                       
+* Overview: empty the read cache, called by SST25Init()
+*                                                                       
+* Input: none
+*                                                                       
+************************************************************************/
+void SST25CacheInit(void);
+
+/************************************************************************
+* Function: void SST25CacheInvalidate(DWORD address)
+*                                                                       
+* Overview: drop the cached data of the sector holding the address, or
+*           all of it for SST25_CACHE_ALL; called after writes and erases
+*                                                                       
+* Input: address written or erased
+*                                                                       
+************************************************************************/
+void SST25CacheInvalidate(DWORD address);
+
+/************************************************************************
+* Function: void SST25CacheGetStats(SST25_CACHE_STATS* pStats)
+*                                                                       
+* Overview: copy the read cache's hit and miss counters
+*                                                                       
+* Input: where to copy them
+*                                                                       
+************************************************************************/
+void SST25CacheGetStats(SST25_CACHE_STATS* pStats);
+
 /************************************************************************
 * Function: void SST25ChipErase(void)
 *                                                                       
@@ -241,5 +326,21 @@ void SST25BeginWrite(DWORD dwAddr);
  *****************************************************************/
 void SST25WriteIncrementalArray(BYTE* vData, WORD wLen);
 
+/******************************************************************
+ *  SST25EndWrite(void);
+ * finish the last word of an incremental write
+ *****************************************************************/
+void SST25EndWrite(void);
+
+/************************************************************************
+* Function: void SST25GetWriteStats(SST25_WRITE_STATS* pStats)
+*                                                                       
+* Overview: copy the write counters
+*                                                                       
+* Input: where to copy them
+*                                                                       
+************************************************************************/
+void SST25GetWriteStats(SST25_WRITE_STATS* pStats);
+
 #endif //_SST25VF016_H
 
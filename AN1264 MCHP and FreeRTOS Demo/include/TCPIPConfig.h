@@ -70,7 +70,11 @@
 #define STACK_USE_ICMP_CLIENT
 //#define STACK_USE_HTTP_SERVER			// Old HTTP server
 #define STACK_USE_HTTP2_SERVER			// New HTTP server with POST, Cookies, Authentication, etc.
+#if defined(__linux__) && defined(HOST_SSL)
+	#define STACK_USE_SSL_SERVER		// Host builds with "make SSL=1" serve HTTPS, with Host\HostARCFOUR.c in place of SW300052
+#else
 //#define STACK_USE_SSL_SERVER			// SSL server socket support (Requires SW300052)
+#endif
 //#define STACK_USE_SSL_CLIENT			// SSL client socket support (Requires SW300052)
 #define STACK_USE_DHCP_CLIENT
 //#define STACK_USE_DHCP_SERVER
@@ -89,7 +93,16 @@
 //#define STACK_USE_UDP_PERFORMANCE_TEST	// Module for testing UDP TX performance characteristics.  NOTE: Enabling this will cause a huge amount of UDP broadcast packets to flood your network on various ports.  Use care when enabling this on production networks, especially with VPNs (could tunnel broadcast traffic across a limited bandwidth connection).
 //#define STACK_USE_TCP_PERFORMANCE_TEST	// Module for testing TCP TX performance characteristics
 //#define STACK_USE_DYNAMICDNS_CLIENT		// Dynamic DNS client module
+#if defined(__linux__)
+	#define STACK_USE_BERKELEY_API		// Host builds (Host\Makefile) run Berkeley socket client tasks in HostBSD.c
+#else
 //#define STACK_USE_BERKELEY_API			// Berekely Sockets APIs are used
+#endif
+#if defined(__linux__)
+	#define STACK_USE_SHA256			// Host builds time SHA-256 beside MD5 and SHA-1 in Host\HostHash.c
+#else
+//#define STACK_USE_SHA256				// SHA-256 hashes for custom applications (~2.5kb ROM, 32b RAM per hash)
+#endif
 
 
 // =======================================================================
@@ -143,7 +156,22 @@
  *   Maximum number of simultaneously open MPFS2 files.
  *   For MPFS Classic, this has no effect.
  */
-#define MAX_MPFS_HANDLES				(7ul)
+#if defined(__linux__) && defined(HOST_TCP_SOCKETS)
+	#define MAX_MPFS_HANDLES			(2ul*HOST_TCP_SOCKETS + 3ul)
+#else
+	#define MAX_MPFS_HANDLES			(7ul)
+#endif
+
+/* MPFS Name Index
+ *   Most named files whose name hashes are kept sorted in RAM, 4 bytes
+ *   each, for MPFSOpen() to binary search.  An image with more files is
+ *   searched in the flash instead.  Comment out to save the RAM.
+ */
+#if defined(__linux__)
+	#define MPFS_INDEX_SIZE				(4096u)
+#else
+	#define MPFS_INDEX_SIZE				(32u)
+#endif
 
 // =======================================================================
 //   Network Addressing Options
@@ -330,6 +358,15 @@
  */
 //#define STACK_CLIENT_MODE
 
+/* ARP Cache Configuration
+ *   Number of IP to MAC address translations kept in CLIENT mode,
+ *   how long (in Ticks) a resolved one stays valid and how long
+ *   one waits for the reply to its request.
+ */
+#define ARP_CACHE_ENTRIES		(4u)
+#define ARP_CACHE_TIMEOUT		((DWORD)(5*60*TICK_SECOND))
+#define ARP_PENDING_TIMEOUT		((DWORD)(2*TICK_SECOND))
+
 /* TCP Socket Memory Allocation
  *   TCP needs memory to buffer incoming and outgoing data.  The 
  *   amount and medium of storage can be allocated on a per-socket
@@ -337,7 +374,17 @@
  */
 	// Allocate how much total RAM (in bytes) you want to allocate 
 	// for use by your TCP TCBs, RX FIFOs, and TX FIFOs.  
-	#define TCP_ETH_RAM_SIZE					(1338ul)
+	#if defined(__linux__) && defined(HOST_TCP_SOCKETS)
+		// Host builds with "make SOCKETS=n" (Host\Makefile): n HTTP server
+		// sockets, to measure how segment handling scales with the count
+		#define TCP_ETH_RAM_SIZE				(HOST_TCP_SOCKETS * (56ul + 201ul + 201ul))
+	#elif defined(__linux__)
+		// Host builds (Host\Makefile): the TCB is 56 bytes with 64-bit pointers, 
+		// and HOST_BSD_TASKS Berkeley client sockets follow the HTTP ones
+		#define TCP_ETH_RAM_SIZE				(1374ul + HOST_BSD_TASKS * (56ul + 513ul + 513ul))
+	#else
+		#define TCP_ETH_RAM_SIZE				(1338ul)
+	#endif
 	#define TCP_PIC_RAM_SIZE					(0ul)
 	#define TCP_SPI_RAM_SIZE					(0ul)
 	#define TCP_SPI_RAM_BASE_ADDRESS			(0x00)
@@ -388,9 +435,32 @@
 			//{TCP_PURPOSE_TCP_PERFORMANCE_TX, TCP_ETH_RAM, 256, 1},
 			//{TCP_PURPOSE_TCP_PERFORMANCE_RX, TCP_ETH_RAM, 40, 360},
 			//{TCP_PURPOSE_UART_2_TCP_BRIDGE, TCP_ETH_RAM, 256, 256},
+		#if defined(__linux__) && defined(HOST_TCP_SOCKETS)
+			#define HOST_HTTP_SOCKETS_4		{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200}, \
+											{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200}, \
+											{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200}, \
+											{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200},
+			HOST_HTTP_SOCKETS_4
+			#if HOST_TCP_SOCKETS >= 8
+			HOST_HTTP_SOCKETS_4
+			#endif
+			#if HOST_TCP_SOCKETS >= 16
+			HOST_HTTP_SOCKETS_4 HOST_HTTP_SOCKETS_4
+			#endif
+			#if HOST_TCP_SOCKETS >= 32
+			HOST_HTTP_SOCKETS_4 HOST_HTTP_SOCKETS_4 HOST_HTTP_SOCKETS_4 HOST_HTTP_SOCKETS_4
+			#endif
+		#else
 			{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200},
 			{TCP_PURPOSE_HTTP_SERVER, TCP_ETH_RAM, 200, 200},
 			{TCP_PURPOSE_DEFAULT, TCP_ETH_RAM, 200, 200},
+		#endif
+		#if defined(__linux__) && !defined(HOST_TCP_SOCKETS)
+			{TCP_PURPOSE_BERKELEY_CLIENT, TCP_ETH_RAM, 512, 512},
+			{TCP_PURPOSE_BERKELEY_CLIENT, TCP_ETH_RAM, 512, 512},
+			{TCP_PURPOSE_BERKELEY_CLIENT, TCP_ETH_RAM, 512, 512},
+			{TCP_PURPOSE_BERKELEY_CLIENT, TCP_ETH_RAM, 512, 512},
+		#endif
 			//{TCP_PURPOSE_BERKELEY_SERVER, TCP_ETH_RAM, 25, 20},
 			//{TCP_PURPOSE_BERKELEY_CLIENT, TCP_ETH_RAM, 125, 100},
 		};
@@ -417,6 +487,22 @@
  */
 #define BSD_SOCKET_COUNT (5u)
 
+/* Berkeley API RTOS Configuration
+ *   With BSD_USE_RTOS defined, FreeRTOS tasks other than the one running 
+ *   StackTask() may call the Berkeley API.  Their calls are queued to the 
+ *   stack task, and accept(), connect(), send() and recv() block until 
+ *   done or until the socket's SO_RCVTIMEO or SO_SNDTIMEO passes.  Up to 
+ *   BSD_REQUEST_QUEUE_LENGTH tasks (BSD_SOCKET_COUNT by default) may call 
+ *   at once.
+ */
+#define BSD_USE_RTOS
+
+// Berkeley client tasks run by the host build's "bsd:N" test, each with 
+// one of the TCP_PURPOSE_BERKELEY_CLIENT sockets above
+#if defined(__linux__)
+	#define HOST_BSD_TASKS		(4u)
+#endif
+
 
 // =======================================================================
 //   Application-Specific Options
@@ -426,7 +512,11 @@
 
 	// Maximum numbers of simultaneous HTTP connections allowed.
 	// Each connection consumes 2 bytes of RAM and a TCP socket
-	#define MAX_HTTP_CONNECTIONS	(2u)
+	#if defined(__linux__) && defined(HOST_TCP_SOCKETS)
+		#define MAX_HTTP_CONNECTIONS	(HOST_TCP_SOCKETS)
+	#else
+		#define MAX_HTTP_CONNECTIONS	(2u)
+	#endif
 	
 	// Indicate what file to serve when no specific one is requested
 	#define HTTP_DEFAULT_FILE		"index.htm"
@@ -463,7 +553,18 @@
 	#define MAX_SSL_BUFFERS			(4ul)	// Max # of SSL buffers (2 per socket)
 	#define MAX_SSL_HASHES			(5ul)	// Max # of SSL hashes  (2 per, plus 1 to avoid deadlock)
 	
-	#define SSL_RSA_KEY_SIZE		(512ul)	// bits in SSL RSA key
+	#define SSL_SESSION_PERSIST				// Keep the server's sessions in the last sector of the SST25VF016
+	#if defined(__linux__)
+		#define SSL_SESSION_SAVE_PERIOD	(1ull*TICK_SECOND)	// Host's "ssl:N" restarts SSL soon after its handshakes
+	#endif
+	
+	// Bits in SSL RSA key; the host build's "make RSA=1024" times a 
+	// 1024 bit key
+	#if defined(__linux__) && defined(HOST_RSA_KEY_SIZE)
+		#define SSL_RSA_KEY_SIZE	(HOST_RSA_KEY_SIZE)
+	#else
+		#define SSL_RSA_KEY_SIZE	(512ul)
+	#endif
 
 
 // -- Telnet Options -----------------------------------------------------
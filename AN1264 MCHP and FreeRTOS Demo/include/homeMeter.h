@@ -53,6 +53,7 @@ typedef struct {
 	WORD	gas_on;				// gas supply enabled
 	WORD	setpoint;			// thermometer setpoint
 	WORD	temperature;		// current temperature (0.1C)
+	WORD	version;			// changed by MeterChanged()
 } structMeter;
 
 // the one global meter object
@@ -90,6 +91,10 @@ extern xSemaphoreHandle METERSemaphore;
 // the meter task
 extern void taskMeter(void* pvParameter);
 
+// called with METERSemaphore held after changing gMeter, wakes the
+// TCPIP task to send the change to the status.sse listeners
+extern void MeterChanged(void);
+
 // size of the stack for this task
 #define STACK_SIZE_METER		(configMINIMAL_STACK_SIZE * 1)
 // handle for the meter task
@@ -46,9 +46,16 @@
 #include "queue.h"
 #include "semphr.h"
 #include "croutine.h"
+#include "pool.h"
+#include "stream_buffer.h"
 
 #define UART_QUEUE_SIZE	4	// number of messages queue can contain
 #define UART_ENTRY_SIZE 60	// size of each message
+#define UART_POOL_SIZE	(UART_QUEUE_SIZE + 1)	// message buffers, one more than
+							// the queue so one can be printed while the queue is full
+#define UART_TX_STREAM_SIZE	(UART_ENTRY_SIZE * 2)	// bytes waiting for the TX interrupt
+#define UART_RX_STREAM_SIZE	64	// bytes waiting to be read
+#define UART_RX_TRIGGER		8	// bytes that must arrive before a reader is woken
 
 // structure used to output messages via the uart
 // the application must ensure that messages are less than 60 characters
@@ -56,13 +63,22 @@ typedef struct {
 	char	buff[UART_ENTRY_SIZE];	
 } UARTMsg;
 
-// this queue is used to send messages to the UART
+// this queue is used to send messages to the UART, it holds pointers
+// to message buffers allocated from hUARTMsgPool rather than copies
 extern xQueueHandle hUARTTxQueue;
-// input queue for received characters
-extern xQueueHandle hUARTRxQueue;
+extern xPoolHandle hUARTMsgPool;
+// the UART task copies each message into this stream which is emptied
+// into the UART by the TX interrupt
+extern xStreamBufferHandle hUARTTxStream;
+// input stream for received characters
+extern xStreamBufferHandle hUARTRxStream;
 
 // function creates the UART task and queue
 extern xQueueHandle xStartUARTTask(void);
+// get an empty message buffer, NULL if none is free in time
+UARTMsg* UARTGetMsg(portTickType xTicksToWait);
+// pass a message buffer from UARTGetMsg() to the UART task
+BOOL UARTSendMsg(UARTMsg* pMsg, portTickType xTicksToWait);
 // print a BYTE in ASCII Hex to the UART
 void UARTPrintChar(BYTE c);
 // print a string to the UART
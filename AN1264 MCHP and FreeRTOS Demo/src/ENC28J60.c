@@ -349,6 +349,12 @@ void MACInit(void)
 
     BankSel(ERDPTL);        // Return to default Bank 0
 
+#if defined(MAC_ISR_ENABLE)
+    // Drive the INT pin low while received packets are waiting, so the
+    // TCPIP task can sleep until one arrives
+    WriteReg(EIE, EIE_INTIE | EIE_PKTIE);
+#endif
+
     // Enable packet reception
     BFSReg(ECON1, ECON1_RXEN);
 }//end MACInit
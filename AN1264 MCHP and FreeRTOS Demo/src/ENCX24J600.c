@@ -379,6 +379,13 @@ void MACInit(void)
 		WritePHYReg(PHCON1, PHCON1_SPD100 | PHCON1_PFULDPX);
 	#endif
 
+	#if defined(MAC_ISR_ENABLE)
+	// Drive the INT pin low while received packets are waiting, so the 
+	// TCPIP task can sleep until one arrives.  Only the packet pending 
+	// interrupt is wanted, replacing the reset default of LINKIE.
+	WriteReg(EIE, EIE_INTIE | EIE_PKTIE);
+	#endif
+
 	// Enable RX packet reception
 	BFSReg(ECON1, ECON1_RXEN);
 }//end MACInit
@@ -146,8 +146,33 @@ static WORD fatCacheID;
 // Number of files in this MPFS image
 static WORD numFiles;
 
+#if defined(MPFS_INDEX_SIZE)
+// An entry in the RAM index of the image's file names
+typedef struct
+{
+	WORD hash;				// _IndexHash of the file name
+	WORD fatID;				// ID of the file's FAT record
+} MPFS_INDEX_ENTRY;
+
+// The named files sorted by _BuildIndex, so MPFSOpen can binary search
+// them rather than read the whole hash table from the image
+static MPFS_INDEX_ENTRY nameIndex[MPFS_INDEX_SIZE];
+
+// Number of entries in nameIndex, 0 when the image has more files
+static WORD numIndexed;
+
+// The index hashes names with FNV-1a folded to 16 bits.  The image's own
+// hash sums the characters, so names differing only in a few digits or
+// letters mostly share a hash.
+#define MPFS_INDEX_HASH_INIT	(2166136261ul)
+#define _IndexHash(h, c)		(((h) ^ (BYTE)(c)) * 16777619ul)
+#define _IndexHashFold(h)		((WORD)((h) ^ ((h) >> 16)))
+
+static void _BuildIndex(void);
+#endif
 
 static void _LoadFATRecord(WORD fatID);
+static BOOL _MatchName(WORD fatID, BYTE* cFile);
 static void _Validate(void);
 
 /****************************************************************************
@@ -269,10 +294,11 @@ MPFS_HANDLE MPFSOpen(BYTE* cFile)
 	MPFS_HANDLE hMPFS;
 	WORD nameHash, i;
 	WORD hashCache[8];
-	BYTE *ptr, c;
-	
-	// Initialize c to avoid "may be used uninitialized" compiler warning
-	c = 0;
+	BYTE *ptr;
+	#if defined(MPFS_INDEX_SIZE)
+	DWORD indexHash;
+	WORD lo, hi, mid;
+	#endif
 	
 	// Make sure MPFS is unlocked and we got a filename
 	if(*cFile == '\0' || isMPFSLocked == TRUE)
@@ -289,9 +315,46 @@ MPFS_HANDLE MPFSOpen(BYTE* cFile)
 	for(hMPFS = 1; hMPFS <= MAX_MPFS_HANDLES; hMPFS++)
 		if(MPFSStubs[hMPFS].addr == MPFS_INVALID)
 			break;
-	if(hMPFS == MAX_MPFS_HANDLES)
+	if(hMPFS > MAX_MPFS_HANDLES)
 		return MPFS_INVALID_HANDLE;
+	
+	#if defined(MPFS_INDEX_SIZE)
+	if(numIndexed != 0u)
+	{
+		for(indexHash = MPFS_INDEX_HASH_INIT, ptr = cFile; *ptr != '\0'; ptr++)
+			indexHash = _IndexHash(indexHash, *ptr);
+		nameHash = _IndexHashFold(indexHash);
 		
+		// Binary search for the first file with this hash
+		lo = 0;
+		hi = numIndexed;
+		while(lo < hi)
+		{
+			mid = (lo + hi) >> 1;
+			if(nameIndex[mid].hash < nameHash)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		// Compare the full filename of each file with the hash
+		for(; lo < numIndexed && nameIndex[lo].hash == nameHash; lo++)
+		{
+			i = nameIndex[lo].fatID;
+			if(_MatchName(i, cFile))
+			{// Filename matches, so return true
+				MPFSStubs[hMPFS].addr = fatCache.data;
+				MPFSStubs[hMPFS].bytesRem = fatCache.len;
+				MPFSStubs[hMPFS].fatID = i;
+				return hMPFS;
+			}
+		}
+
+		// No file name matched, so return nothing
+		return MPFS_INVALID_HANDLE;
+	}
+	#endif
+
 	// Read in hashes, and check remainder on a match.  Store 8 in cache for performance
 	for(i = 0; i < numFiles; i++)
 	{
@@ -304,29 +367,12 @@ MPFS_HANDLE MPFSOpen(BYTE* cFile)
 		}
 		
 		// If the hash matches, compare the full filename
-		if(hashCache[i&0x07] == nameHash)
-		{
-			_LoadFATRecord(i);
-			MPFSStubs[0].addr = fatCache.string;
-			MPFSStubs[0].bytesRem = 255;
-			
-			// Loop over filename to perform comparison
-			for(ptr = cFile; *ptr != '\0'; ptr++)
-			{
-				MPFSGet(0, &c);
-				if(*ptr != c)
-					break;
-			}
-			
-			MPFSGet(0, &c);
-
-			if(c == '\0' && *ptr == '\0')
-			{// Filename matches, so return true
-				MPFSStubs[hMPFS].addr = fatCache.data;
-				MPFSStubs[hMPFS].bytesRem = fatCache.len;
-				MPFSStubs[hMPFS].fatID = i;
-				return hMPFS;
-			}
+		if(hashCache[i&0x07] == nameHash && _MatchName(i, cFile))
+		{// Filename matches, so return true
+			MPFSStubs[hMPFS].addr = fatCache.data;
+			MPFSStubs[hMPFS].bytesRem = fatCache.len;
+			MPFSStubs[hMPFS].fatID = i;
+			return hMPFS;
 		}
 	}
 	
@@ -352,75 +398,20 @@ MPFS_HANDLE MPFSOpen(BYTE* cFile)
 	if the file could not be found or no free handles exist.
 
   Remarks:
-	This function is aliased to MPFSOpen on non-PIC18 platforms.
+	This function is aliased to MPFSOpen on non-PIC18 platforms.  On 
+	PIC18 the name is copied to RAM and opened with MPFSOpen.
   ***************************************************************************/
 #if defined(__18CXX)
 MPFS_HANDLE MPFSOpenROM(ROM BYTE* cFile) 
 {
-	MPFS_HANDLE hMPFS;
-	WORD nameHash, i;
-	WORD hashCache[8];
-	ROM BYTE *ptr;
-	BYTE c;
-	
-	// Make sure MPFS is unlocked and we got a filename
-	if(*cFile == '\0' || isMPFSLocked == TRUE)
-		return MPFS_INVALID_HANDLE;
-
-	// Calculate the name hash to speed up searching
-	for(nameHash = 0, ptr = cFile; *ptr != '\0'; ptr++)
-	{
-		nameHash += *ptr;
-		nameHash <<= 1;
-	}
+	BYTE cName[MAX_FILE_NAME_LEN+1];
 	
-	// Find a free file handle to use
-	for(hMPFS = 1; hMPFS <= MAX_MPFS_HANDLES; hMPFS++)
-		if(MPFSStubs[hMPFS].addr == MPFS_INVALID)
-			break;
-	if(hMPFS == MAX_MPFS_HANDLES)
+	// Names longer than this are not in the image
+	if(strlenpgm((ROM char*)cFile) > MAX_FILE_NAME_LEN)
 		return MPFS_INVALID_HANDLE;
-		
-	// Read in hashes, and check remainder on a match.  Store 8 in cache for performance
-	for(i = 0; i < numFiles; i++)
-	{
-		// For new block of 8, read in data
-		if((i & 0x07) == 0u)
-		{
-			MPFSStubs[0].addr = 8 + i*2;
-			MPFSStubs[0].bytesRem = 16;
-			MPFSGetArray(0, (BYTE*)hashCache, 16);
-		}
-		
-		// If the hash matches, compare the full filename
-		if(hashCache[i&0x07] == nameHash)
-		{
-			_LoadFATRecord(i);
-			MPFSStubs[0].addr = fatCache.string;
-			MPFSStubs[0].bytesRem = 255;
-			
-			// Loop over filename to perform comparison
-			for(ptr = cFile; *ptr != '\0'; ptr++)
-			{
-				MPFSGet(0, &c);
-				if(*ptr != c)
-					break;
-			}
-			
-			MPFSGet(0, &c);
-
-			if(c == '\0' && *ptr == '\0')
-			{// Filename matches, so return true
-				MPFSStubs[hMPFS].addr = fatCache.data;
-				MPFSStubs[hMPFS].bytesRem = fatCache.len;
-				MPFSStubs[hMPFS].fatID = i;
-				return hMPFS;
-			}
-		}
-	}
+	strcpypgm2ram((char*)cName, (ROM char*)cFile);
 	
-	// No file name matched, so return nothing
-	return MPFS_INVALID_HANDLE;
+	return MPFSOpen(cName);
 }
 #endif
 
@@ -451,14 +442,14 @@ MPFS_HANDLE MPFSOpenID(WORD hFatID)
 	MPFS_HANDLE hMPFS;
 	
 	// Make sure MPFS is unlocked and we got a valid id
-	if(isMPFSLocked == TRUE || hFatID > numFiles)
+	if(isMPFSLocked == TRUE || hFatID >= numFiles)
 		return MPFS_INVALID_HANDLE;
 
 	// Find a free file handle to use
 	for(hMPFS = 1; hMPFS <= MAX_MPFS_HANDLES; hMPFS++)
 		if(MPFSStubs[hMPFS].addr == MPFS_INVALID)
 			break;
-	if(hMPFS == MAX_MPFS_HANDLES)
+	if(hMPFS > MAX_MPFS_HANDLES)
 		return MPFS_INVALID_HANDLE;
 	
 	// Load the FAT record
@@ -964,6 +955,8 @@ WORD MPFSPutArray(MPFS_HANDLE hMPFS, BYTE* cData, WORD wLen)
 			LCDPMPInit();
 			xSemaphoreGive(QVGASemaphore);
 		#endif
+		
+		return wLen;
 	#endif
 }
 #endif
@@ -993,6 +986,8 @@ void MPFSPutEnd(BOOL final)
 	#if defined(MPFS_USE_EEPROM)
 	    XEEEndWrite();
     	while(XEEIsBusy());
+    #elif (GRAPHICS_PICTAIL_VERSION == 3)
+    	SST25EndWrite();
     #endif
     
 	if(final)
@@ -1037,6 +1032,52 @@ static void _LoadFATRecord(WORD fatID)
 	fatCacheID = fatID;
 }
 
+/*****************************************************************************
+  Function:
+	static BOOL _MatchName(WORD fatID, BYTE* cFile)
+
+  Description:
+	Compares a file name with the name of a file in the image.
+	
+  Precondition:
+	None
+
+  Parameters:
+	fatID - the ID of the file whose name is compared
+	cFile - a null terminated file name
+
+  Return Values:
+	TRUE - the names match, and the file's FAT record is in fatCache
+	FALSE - the names differ
+
+  Remarks:
+	The name is read from the image in blocks, so most names need one 
+	read rather than one for each character.
+  ***************************************************************************/
+static BOOL _MatchName(WORD fatID, BYTE* cFile)
+{
+	BYTE cName[32];
+	WORD wLen, wRead;
+	
+	_LoadFATRecord(fatID);
+	MPFSStubs[0].addr = fatCache.string;
+	MPFSStubs[0].bytesRem = MAX_FILE_NAME_LEN + 1;
+	
+	// Compare up to and including the terminating null
+	wLen = strlen((char*)cFile) + 1;
+	while(wLen)
+	{
+		wRead = wLen < sizeof(cName) ? wLen : sizeof(cName);
+		if(MPFSGetArray(0, cName, wRead) != wRead)
+			return FALSE;
+		if(memcmp(cName, cFile, wRead) != 0)
+			return FALSE;
+		cFile += wRead;
+		wLen -= wRead;
+	}
+	return TRUE;
+}
+
 /*****************************************************************************
   Function:
 	DWORD MPFSGetTimestamp(MPFS_HANDLE hMPFS)
@@ -1376,5 +1417,79 @@ static void _Validate(void)
 	else
 		numFiles = 0;
 	fatCacheID = MPFS_INVALID_FAT;
+	
+	#if defined(MPFS_INDEX_SIZE)
+	_BuildIndex();
+	#endif
 }	
+
+/*****************************************************************************
+  Function:
+	static void _BuildIndex(void)
+
+  Summary:
+	Indexes the image's file names in RAM.
+
+  Description:
+	Reads the name of every file in the image and keeps its _IndexHash 
+	and FAT ID in nameIndex, sorted by hash, so MPFSOpen can find a name 
+	with a binary search and then read only one FAT record and name.
+
+  Precondition:
+	numFiles has been read by _Validate.
+
+  Parameters:
+	None
+
+  Returns:
+	None
+
+  Remarks:
+	Index files have no name and are left out.  An image with more than 
+	MPFS_INDEX_SIZE named files is not indexed, and MPFSOpen searches the 
+	hashes in the image instead.
+  ***************************************************************************/
+#if defined(MPFS_INDEX_SIZE)
+static void _BuildIndex(void)
+{
+	BYTE cName[32];
+	DWORD indexHash;
+	WORD i, j, num, len, wRead;
+	WORD nameHash;
+	
+	numIndexed = 0;
+	for(i = 0, num = 0; i < numFiles; i++)
+	{
+		_LoadFATRecord(i);
+		MPFSStubs[0].addr = fatCache.string;
+		MPFSStubs[0].bytesRem = MAX_FILE_NAME_LEN + 1;
+		
+		// Hash the name a block at a time
+		indexHash = MPFS_INDEX_HASH_INIT;
+		len = 0;
+		do
+		{
+			wRead = MPFSGetArray(0, cName, sizeof(cName));
+			for(j = 0; j < wRead && cName[j] != '\0'; j++)
+				indexHash = _IndexHash(indexHash, cName[j]);
+			len += j;
+		} while(j == wRead && wRead != 0u);
+		if(len == 0u)
+			continue;
+		
+		if(num == MPFS_INDEX_SIZE)
+			return;
+		
+		// Insert after any files with the same hash, so they are
+		// compared in image order
+		nameHash = _IndexHashFold(indexHash);
+		for(j = num; j > 0u && nameIndex[j-1].hash > nameHash; j--)
+			nameIndex[j] = nameIndex[j-1];
+		nameIndex[j].hash = nameHash;
+		nameIndex[j].fatID = i;
+		num++;
+	}
+	numIndexed = num;
+}
+#endif
 #endif //#if defined(STACK_USE_MPFS2)
@@ -57,12 +57,12 @@
 #include "SystemProfile.h"
 
 #include "FreeRTOS.h"
-#include "semphr.h"
+#include "task.h"
 
-// semaphore used to wake the MiWitask up because some activity
+// the MiWi task is notified to wake it up because some activity
 // has occured in the stack, this allows that task to spend longer
 // blocked whilst still responding quickly to arriving messages
-extern xSemaphoreHandle hMiWiSemaphore;
+extern xTaskHandle hMIWITask;
 
 #if defined(MRF24J40)
 
@@ -1658,9 +1658,8 @@ extern xSemaphoreHandle hMiWiSemaphore;
                             PHYSetShortRAMAddr(WRITE_RXFLUSH, 0x01);
                             
                             ///////////////////////////////////////////////////////////
-                            // data has been received so unblock any tasks
-                            // waiting on the miwi semaphore (i.e. the MiWi taskitself)
-		                    xSemaphoreGiveFromISR(hMiWiSemaphore, &taskWoken);	
+                            // data has been received so unblock the MiWi task
+		                    xTaskNotifyFromISR(hMIWITask, &taskWoken);	
                         }
                         else
                         {
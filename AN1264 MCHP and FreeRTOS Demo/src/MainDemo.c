@@ -50,6 +50,7 @@
 #include "queue.h"
 #include "semphr.h"
 #include "croutine.h"
+#include "timers.h"
 
 // local includes
 #include "LEDUtils.h"
@@ -83,11 +84,16 @@ structMeter gMeter;
 ///////////////////////////////////////////////////////////////////
 // Forward references in this module
 static void InitializeBoard(void);
+static void TemperatureTimerCallback(xTimerHandle xTimer);
 
 ///////////////////////////////////////////////////////////////////
 // local variables and constants
 const UARTMsg msgAppStart = {"\r\nApplication Started. Build: " __TIME__ "\r\n"};
 
+// period of the temperature and display update
+#define TEMPERATURE_UPDATE_RATE		(2000 / portTICK_RATE_MS)
+static xTimerHandle hTEMPTimer;
+
 /*********************************************************************
  * Function:        int main(void)
  *
@@ -127,18 +133,27 @@ int main(void)
 	// messages to update the display are sent via the QVGAQueue
 	hQVGAQueue = xQueueCreate(QVGA_QUEUE_SIZE, sizeof(GRAPHICS_MSG));
 	
+	// name the semaphores and queue for the debugger and the kernel trace,
+	// these compile away unless configQUEUE_REGISTRY_SIZE is set
+	vQueueAddToRegistry(SPI2Semaphore, (signed char*) "SPI2");
+	vQueueAddToRegistry(FLASHSemaphore, (signed char*) "FLASH");
+	vQueueAddToRegistry(QVGASemaphore, (signed char*) "QVGAMtx");
+	vQueueAddToRegistry(METERSemaphore, (signed char*) "METERSem");
+	vQueueAddToRegistry(hQVGAQueue, (signed char*) "QVGA");
+	
 	// configure the hardware resources on the board
 	InitializeBoard();	
 	
 	// create the UART task
 	xStartUARTTask();
 	// tell the world we have started
-	xQueueSendToBack(hUARTTxQueue, &msgAppStart, 0);
+	UARTprintf((char*) msgAppStart.buff);
 	
 	// create the meter task
 	xTaskCreate(taskMeter, (signed char*) "METER", STACK_SIZE_METER,
 		NULL, tskIDLE_PRIORITY + 1, &hMETERTask);
 	hMETERQueue = xQueueCreate(METER_QUEUE_SIZE, sizeof(METER_MSG));
+	vQueueAddToRegistry(hMETERQueue, (signed char*) "METER");
 		
 	// create the task that handles all MIWI functionality
 	xStartMIWITask();
@@ -157,6 +172,14 @@ int main(void)
 	xTaskCreate(taskTCPIP, (signed char*) "TCPIP", STACK_SIZE_TCPIP,
 		NULL, tskIDLE_PRIORITY + 2, &hTCPIPTask);
 		
+	// send a temperature update to the meter every 2 seconds, the
+	// timer starts running once the scheduler has been started
+	hTEMPTimer = xTimerCreate((signed char*) "TEMP", TEMPERATURE_UPDATE_RATE,
+		pdTRUE, NULL, TemperatureTimerCallback);
+	if (hTEMPTimer != NULL) {
+		xTimerStart(hTEMPTimer, 0);
+	}
+		
 	// start the RTOS running, this function should never return
 	vTaskStartScheduler();
 		
@@ -307,42 +330,34 @@ void vApplicationStackOverflowHook( void )
 }
 
 /*********************************************************************
- * Function:        void vApplicationTickHook(void)
+ * Function:        void TemperatureTimerCallback(xTimerHandle xTimer)
  *
- * PreCondition:    None
+ * PreCondition:    Scheduler started
  *
- * Input:           None
+ * Input:           Handle of the timer that expired
  *                  
  * Output:          None
  *
  * Side Effects:    None
  *
- * Overview:        This function is called at each tick interval
+ * Overview:        Called from the timer task every 2 seconds to send
+ *					the temperature reading to the meter task
  *
- * Note:            
+ * Note:            Runs in the timer task so must never block
  ********************************************************************/
-void vApplicationTickHook(void)
+static void TemperatureTimerCallback(xTimerHandle xTimer)
 {
-	static unsigned int tickCount = 0;
-	static METER_MSG mMsg;
-	static GRAPHICS_MSG gMsg;
-	portBASE_TYPE xTaskWoken;
+	METER_MSG mMsg;
+	GRAPHICS_MSG gMsg;
 	
-	// send a temperature update to the graphics task every 2 seconds
-	tickCount++;
-	if (tickCount >= (2 * configTICK_RATE_HZ)) {
-		tickCount = 0;
-		
-		// update the meters temperature reading
-		mMsg.cmd = MSG_METER_UPDATE_TEMPERATURE;
-		mMsg.data.wVal[0] = adcTemp;
-		xQueueSendToBackFromISR(hMETERQueue, &mMsg, &xTaskWoken);
-		
-		// also use this as an opportunity to update the display
-		// with periodic data updates if required
-		gMsg.cmd = MSG_UPDATE_DISPLAY;
-		xQueueSendToBackFromISR(hQVGAQueue, &gMsg, &xTaskWoken);
-	}	
+	// update the meters temperature reading
+	mMsg.cmd = MSG_METER_UPDATE_TEMPERATURE;
+	mMsg.data.wVal[0] = adcTemp;
+	xQueueSendToBack(hMETERQueue, &mMsg, 0);
 	
+	// also use this as an opportunity to update the display
+	// with periodic data updates if required
+	gMsg.cmd = MSG_UPDATE_DISPLAY;
+	xQueueSendToBack(hQVGAQueue, &gMsg, 0);
 }
 
@@ -42,9 +42,10 @@
  
 #include "TCPIP Stack/TCPIP.h"
 #include "FreeRTOS.h"
-#include "Task.h"
+#include "task.h"
 #include "semphr.h"
-#include "homeMeter.h"
+#include "homeMeter.h"
+#include "SST25VF016.h"
 
 ///////////////////////////////////////////////////////////////////
 // forward declarations and local functions 
@@ -58,6 +59,51 @@
 
 static HTTP_IO_RESULT HTTPPostBilling(void);
 
+// the fields status.sse streams, in the order of status.xml
+enum {
+	METER_EVENT_ELECTRIC_UNITS = 0u,
+	METER_EVENT_ELECTRIC_TOTAL,
+	METER_EVENT_ELECTRIC_COST,
+	METER_EVENT_ELECTRIC_ONOFF,
+	METER_EVENT_GAS_UNITS,
+	METER_EVENT_GAS_TOTAL,
+	METER_EVENT_GAS_COST,
+	METER_EVENT_GAS_ONOFF,
+	METER_EVENT_TEMPERATURE,
+	METER_EVENT_SETPOINT,
+	METER_EVENT_FIELDS
+};
+
+static ROM char * ROM meterEventNames[METER_EVENT_FIELDS] = {
+	"electric_units", "electric_total", "electric_cost", "electric_onoff",
+	"gas_units", "gas_total", "gas_cost", "gas_onoff",
+	"temperature", "setpoint"
+};
+
+#define METER_EVENT_ALL			((1u << METER_EVENT_FIELDS) - 1)
+// kept in callbackPos once a stream has started so it is never zero
+#define METER_EVENT_STARTED		(0x80000000ul)
+// room for the longest event, "data: electric_total $42949672.95\n\n"
+#define METER_EVENT_MAX_LEN		(40u)
+// each stream holds an HTTP connection for as long as its page is open,
+// so one is always left for other requests
+#define METER_EVENT_STREAMS		(MAX_HTTP_CONNECTIONS - 1u)
+// how long a browser turned away waits before asking for a stream again,
+// in milliseconds, polling status.xml meanwhile
+#define METER_EVENT_RETRY		"10000"
+
+// the HTTP connections streaming status.sse, by curHTTPID
+static BOOL meterEventStreams[MAX_HTTP_CONNECTIONS];
+
+static DWORD MeterEventValue(structMeter* pMeter, BYTE field);
+static void MeterEventFormat(BYTE field, DWORD value, BYTE* sBuff);
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+	// the most tasks reported by rtos.xml
+	#define HTTP_RTOS_MAX_TASKS		10
+	static void ulltoa(unsigned long long val, BYTE* sBuff);
+#endif
+
 ///////////////////////////////////////////////////////////////////
 // Check requested files for source path, if in the protect
 // directory then require password entry
@@ -140,6 +186,7 @@ HTTP_IO_RESULT HTTPExecuteGet(void)
 			// obtain access to the meter object
 			if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
 				gMeter.electric_on = !gMeter.electric_on;
+				MeterChanged();
 				xSemaphoreGive(METERSemaphore);
 			}
 		}
@@ -150,6 +197,7 @@ HTTP_IO_RESULT HTTPExecuteGet(void)
 			// obtain access to the meter object
 			if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
 				gMeter.gas_on = !gMeter.gas_on;
+				MeterChanged();
 				xSemaphoreGive(METERSemaphore);
 			}
 		}		
@@ -611,7 +659,7 @@ void HTTPPrint_electric_units(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "%ld", gMeter.electric_units);
+		sprintf((char*) sBuff, "%lu", (unsigned long) gMeter.electric_units);
 		TCPPutString(sktHTTP, sBuff);
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -625,8 +673,8 @@ void HTTPPrint_electric_total(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "$%ld.%02ld", gMeter.electric_total / 100,
-			gMeter.electric_total % 100);
+		sprintf((char*) sBuff, "$%lu.%02lu", (unsigned long) gMeter.electric_total / 100,
+			(unsigned long) gMeter.electric_total % 100);
 		TCPPutString(sktHTTP, sBuff);	
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -640,7 +688,7 @@ void HTTPPrint_electric_cost(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "%ld", gMeter.electric_cost);
+		sprintf((char*) sBuff, "%lu", (unsigned long) gMeter.electric_cost);
 		TCPPutString(sktHTTP, sBuff);	
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -668,7 +716,7 @@ void HTTPPrint_gas_units(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "%ld", gMeter.gas_units);
+		sprintf((char*) sBuff, "%lu", (unsigned long) gMeter.gas_units);
 		TCPPutString(sktHTTP, sBuff);	
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -682,8 +730,8 @@ void HTTPPrint_gas_total(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "$%ld.%02ld", gMeter.gas_total / 100,
-			gMeter.gas_total % 100);
+		sprintf((char*) sBuff, "$%lu.%02lu", (unsigned long) gMeter.gas_total / 100,
+			(unsigned long) gMeter.gas_total % 100);
 		TCPPutString(sktHTTP, sBuff);	
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -697,7 +745,7 @@ void HTTPPrint_gas_cost(void)
 	BYTE sBuff[20];
 	
 	if (xSemaphoreTake(METERSemaphore, 50 / portTICK_RATE_MS) == pdTRUE) {
-		sprintf((char*) sBuff, "%ld", gMeter.gas_cost);
+		sprintf((char*) sBuff, "%lu", (unsigned long) gMeter.gas_cost);
 		TCPPutString(sktHTTP, sBuff);	
 		xSemaphoreGive(METERSemaphore);	
 	} else {
@@ -763,3 +811,203 @@ void HTTPPrint_electric(void)
 	TCPPutROMString(sktHTTP, (ROM BYTE*)"Unused");
 	return;		
 }
+
+///////////////////////////////////////////////////////////////////
+// Stream the meter to status.sse as server-sent events, one field
+// per event as "data: name value". The callback never completes so
+// the server calls it on every pass for as long as the browser stays
+// connected. callbackPos holds the gMeter.version last looked at in
+// its low word and the fields still to be sent in the high word, and
+// curHTTP.data the values last sent, so an unchanged meter costs one
+// compare and a change sends only the fields that differ.  At most
+// METER_EVENT_STREAMS streams run at once; a page asking for another
+// is sent a retry: delay and the response ends, so the browser polls
+// status.xml until it is let back in
+void HTTPPrint_meter_events(void)
+{
+	structMeter meter;
+	DWORD value, sent;
+	WORD pending;
+	BYTE field, id, streams;
+	BYTE sBuff[20];
+	
+	// a new stream sends every field, if there is a connection to spare
+	if (curHTTP.callbackPos == 0u) {
+		// a stream ended once its connection left the callback, though
+		// one that has since moved on to another page's callback still
+		// counts until that finishes
+		streams = 0;
+		meterEventStreams[curHTTPID] = FALSE;
+		for (id = 0; id < MAX_HTTP_CONNECTIONS; id++) {
+			if (!meterEventStreams[id])
+				continue;
+			if (httpStubs[id].sm == SM_HTTP_SEND_FROM_CALLBACK)
+				streams++;
+			else
+				meterEventStreams[id] = FALSE;
+		}
+		
+		if (streams >= METER_EVENT_STREAMS) {
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "retry: " METER_EVENT_RETRY "\n\n");
+			return;
+		}
+		
+		meterEventStreams[curHTTPID] = TRUE;
+		curHTTP.callbackPos = METER_EVENT_STARTED | ((DWORD) METER_EVENT_ALL << 16);
+	}
+	
+	pending = (WORD) (curHTTP.callbackPos >> 16) & METER_EVENT_ALL;
+	if (pending == 0u && (WORD) curHTTP.callbackPos == gMeter.version)
+		return;
+	
+	// the TCPIP task must not wait here, so if the meter is busy try
+	// again on the next pass
+	if (xSemaphoreTake(METERSemaphore, 0) != pdTRUE)
+		return;
+	meter = gMeter;
+	xSemaphoreGive(METERSemaphore);
+	
+	// queue the fields that differ from those last sent
+	for (field = 0; field < METER_EVENT_FIELDS; field++) {
+		memcpy(&sent, &curHTTP.data[field * sizeof(DWORD)], sizeof(DWORD));
+		if (MeterEventValue(&meter, field) != sent)
+			pending |= 1u << field;
+	}
+	
+	// send as many as there is room for, the rest on later passes
+	for (field = 0; field < METER_EVENT_FIELDS; field++) {
+		if ((pending & (1u << field)) == 0u)
+			continue;
+		if (TCPIsPutReady(sktHTTP) < METER_EVENT_MAX_LEN)
+			break;
+		
+		value = MeterEventValue(&meter, field);
+		MeterEventFormat(field, value, sBuff);
+		TCPPutROMString(sktHTTP, (ROM BYTE*) "data: ");
+		TCPPutROMString(sktHTTP, (ROM BYTE*) meterEventNames[field]);
+		TCPPut(sktHTTP, ' ');
+		TCPPutString(sktHTTP, sBuff);
+		TCPPutROMString(sktHTTP, (ROM BYTE*) "\n\n");
+		
+		memcpy(&curHTTP.data[field * sizeof(DWORD)], &value, sizeof(DWORD));
+		pending &= ~(1u << field);
+	}
+	
+	curHTTP.callbackPos = METER_EVENT_STARTED | ((DWORD) pending << 16) | meter.version;
+	return;
+}
+
+///////////////////////////////////////////////////////////////////
+// The value of one of the fields status.sse streams
+static DWORD MeterEventValue(structMeter* pMeter, BYTE field)
+{
+	switch (field) {
+		case METER_EVENT_ELECTRIC_UNITS:	return pMeter->electric_units;
+		case METER_EVENT_ELECTRIC_TOTAL:	return pMeter->electric_total;
+		case METER_EVENT_ELECTRIC_COST:		return pMeter->electric_cost;
+		case METER_EVENT_ELECTRIC_ONOFF:	return pMeter->electric_on;
+		case METER_EVENT_GAS_UNITS:			return pMeter->gas_units;
+		case METER_EVENT_GAS_TOTAL:			return pMeter->gas_total;
+		case METER_EVENT_GAS_COST:			return pMeter->gas_cost;
+		case METER_EVENT_GAS_ONOFF:			return pMeter->gas_on;
+		case METER_EVENT_TEMPERATURE:		return pMeter->temperature;
+		default:							return pMeter->setpoint;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+// Format a field for status.sse as the matching HTTPPrint_ callback
+// formats it for status.xml
+static void MeterEventFormat(BYTE field, DWORD value, BYTE* sBuff)
+{
+	switch (field) {
+		case METER_EVENT_ELECTRIC_TOTAL:
+		case METER_EVENT_GAS_TOTAL:
+			sprintf((char*) sBuff, "$%lu.%02lu", (unsigned long) value / 100, (unsigned long) value % 100);
+			break;
+		case METER_EVENT_ELECTRIC_ONOFF:
+		case METER_EVENT_GAS_ONOFF:
+			strcpypgm2ram((char*) sBuff, value ? (ROM char*) "true" : (ROM char*) "false");
+			break;
+		case METER_EVENT_TEMPERATURE:
+		case METER_EVENT_SETPOINT:
+			sprintf((char*) sBuff, "%d.%01dC", (WORD) value / 10, (WORD) value % 10);
+			break;
+		default:
+			sprintf((char*) sBuff, "%lu", (unsigned long) value);
+			break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+// Write the run time statistics of every task as XML for rtos.xml.
+// The counters are totals since the scheduler started, the page
+// works out the CPU load of each task from the change between
+// two polls. callbackPos holds one more than the next item to be
+// written, item 0 being the total and item n being task n - 1
+void HTTPPrint_rtos_stats(void)
+{
+#if (configGENERATE_RUN_TIME_STATS == 1)
+	// only ever called from the TCPIP task so static is safe
+	static xTaskRunTimeStatus stats[HTTP_RTOS_MAX_TASKS];
+	unsigned long long total;
+	unsigned portBASE_TYPE count;
+	DWORD item;
+	BYTE sBuff[24];
+	
+	count = uxTaskGetRunTimeSnapshot(stats, HTTP_RTOS_MAX_TASKS, &total);
+	item = (curHTTP.callbackPos == 0) ? 0 : curHTTP.callbackPos - 1;
+	
+	for (; item <= count; item++) {
+		// a task entry is at most around 100 bytes
+		if (TCPIsPutReady(sktHTTP) < 128u) {
+			curHTTP.callbackPos = item + 1;
+			return;
+		}
+		
+		if (item == 0) {
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "<total>");
+			ulltoa(total, sBuff);
+			TCPPutString(sktHTTP, sBuff);
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "</total>\r\n");
+		} else {
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "<task><name>");
+			TCPPutString(sktHTTP, (BYTE*) stats[item - 1].pcTaskName);
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "</name><prio>");
+			sprintf((char*) sBuff, "%u", (unsigned int) stats[item - 1].uxCurrentPriority);
+			TCPPutString(sktHTTP, sBuff);
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "</prio><run>");
+			ulltoa(stats[item - 1].ullRunTimeCounter, sBuff);
+			TCPPutString(sktHTTP, sBuff);
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "</run><switches>");
+			sprintf((char*) sBuff, "%lu", (unsigned long) stats[item - 1].ulSwitchInCount);
+			TCPPutString(sktHTTP, sBuff);
+			TCPPutROMString(sktHTTP, (ROM BYTE*) "</switches></task>\r\n");
+		}
+	}
+#endif
+	
+	// indicate completion
+	curHTTP.callbackPos = 0x00;
+	return;
+}
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+///////////////////////////////////////////////////////////////////
+// Convert a 64 bit value to decimal, sBuff must hold 21 bytes. The
+// printf libraries do not all support long long
+static void ulltoa(unsigned long long val, BYTE* sBuff)
+{
+	BYTE digits[20];
+	BYTE i = 0;
+	
+	do {
+		digits[i++] = '0' + (BYTE) (val % 10);
+		val /= 10;
+	} while (val != 0);
+	
+	while (i > 0)
+		*sBuff++ = digits[--i];
+	*sBuff = 0;
+}
+#endif
@@ -0,0 +1,233 @@
+/*****************************************************************************
+ *
+ * Read cache in front of the SPI Flash SST25VF016
+ *
+ *****************************************************************************
+ * FileName:        SST25Cache.c
+ * Dependencies:    SST25VF016.h
+ * Processor:       PIC24, PIC32
+ * Compiler:       	MPLAB C30 V3.00, MPLAB C32
+ * Linker:          MPLAB LINK30, MPLAB LINK32
+ *
+ * Every read of the flash - MPFS2, the TCP/IP configuration, the touch
+ * screen calibration and external fonts and bitmaps - starts with a
+ * command and three address bytes on the SPI bus.  Reads shorter than
+ * SST25_CACHE_LINE_SIZE are served from SST25_CACHE_LINES lines, each
+ * filled by one read from the address requested onwards, so a file or
+ * a structure read in small pieces costs one command per line rather
+ * than per piece.  Longer reads go straight to the flash.  A line never
+ * crosses a sector, and writes and erases drop the lines of the sector
+ * they change.
+ *****************************************************************************/
+
+// Standard includes
+#include <string.h>
+
+#include "HardwareProfile.h"
+#include "SST25VF016.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#if (GRAPHICS_PICTAIL_VERSION == 3)
+
+#if (SST25_CACHE_LINES > 0)
+typedef struct
+{
+	DWORD	dwAddress;						// of the first byte held
+	DWORD	dwUsed;							// when last read, for LRU
+	WORD	wLength;						// bytes held, 0 when empty
+	BYTE	vData[SST25_CACHE_LINE_SIZE];
+} SST25_CACHE_LINE;
+
+static SST25_CACHE_LINE Lines[SST25_CACHE_LINES];
+
+// counts the reads from the lines
+static DWORD dwUseCount;
+
+// guards the lines, as the TCPIP, touch screen and graphics tasks all
+// read the flash
+static xSemaphoreHandle hCacheMutex = NULL;
+#endif
+
+static SST25_CACHE_STATS CacheStats;
+
+/************************************************************************
+* Function: void SST25CacheInit(void)
+*                                                                       
+* Overview: empty the cache, creating its mutex the first time
+*                                                                       
+* Input: none
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+void SST25CacheInit(void)
+{
+#if (SST25_CACHE_LINES > 0)
+	if (hCacheMutex == NULL)
+		hCacheMutex = xSemaphoreCreateMutex();
+	SST25CacheInvalidate(SST25_CACHE_ALL);
+#endif
+}
+
+/************************************************************************
+* Function: void SST25CacheInvalidate(DWORD address)
+*                                                                       
+* Overview: drop the lines of the sector holding the address, or all of
+*           them for SST25_CACHE_ALL
+*                                                                       
+* Input: an address that has been written or erased
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+void SST25CacheInvalidate(DWORD address)
+{
+#if (SST25_CACHE_LINES > 0)
+	BYTE i;
+
+	if (hCacheMutex == NULL)
+		return;
+
+	xSemaphoreTake(hCacheMutex, portMAX_DELAY);
+	address &= ~SST25_FLASH_SECTOR_MASK;
+	for (i = 0; i < SST25_CACHE_LINES; i++) {
+		if (address == (SST25_CACHE_ALL & ~SST25_FLASH_SECTOR_MASK) ||
+			(Lines[i].dwAddress & ~SST25_FLASH_SECTOR_MASK) == address)
+			Lines[i].wLength = 0;
+	}
+	xSemaphoreGive(hCacheMutex);
+#endif
+}
+
+/************************************************************************
+* Function: void SST25ReadArray(DWORD address, BYTE* pData, nCount)
+*                                                                       
+* Overview: this function reads data into buffer specified, from the
+*           cache where it holds the data
+*                                                                       
+* Input: flash memory address, pointer to the data buffer, data number
+*                                                                       
+************************************************************************/
+void SST25ReadArray(DWORD address, BYTE* pData, WORD nCount)
+{
+#if (SST25_CACHE_LINES > 0)
+	SST25_CACHE_LINE* pLine;
+	WORD wOffset, wCopy;
+	BYTE i;
+
+	if (hCacheMutex == NULL) {
+		CacheStats.dwDirect++;
+		SST25ReadBlock(address, pData, nCount);
+		return;
+	}
+
+	xSemaphoreTake(hCacheMutex, portMAX_DELAY);
+	while (nCount > 0) {
+		// a line holding the address, else the least recently used
+		pLine = NULL;
+		for (i = 0; i < SST25_CACHE_LINES; i++) {
+			if (Lines[i].wLength != 0 && address >= Lines[i].dwAddress &&
+				address - Lines[i].dwAddress < Lines[i].wLength) {
+				pLine = &Lines[i];
+				break;
+			}
+		}
+
+		if (pLine != NULL) {
+			CacheStats.dwHits++;
+		} else if (nCount >= SST25_CACHE_LINE_SIZE) {
+			// nothing would be left in the line to read later
+			CacheStats.dwDirect++;
+			SST25ReadBlock(address, pData, nCount);
+			break;
+		} else {
+			pLine = &Lines[0];
+			for (i = 1; i < SST25_CACHE_LINES; i++) {
+				if (Lines[i].wLength == 0 || Lines[i].dwUsed < pLine->dwUsed)
+					pLine = &Lines[i];
+				if (pLine->wLength == 0)
+					break;
+			}
+
+			// read ahead to the end of the line or of the sector
+			wCopy = (WORD)(SST25_FLASH_SECTOR_SIZE - (address & SST25_FLASH_SECTOR_MASK));
+			if (wCopy > SST25_CACHE_LINE_SIZE)
+				wCopy = SST25_CACHE_LINE_SIZE;
+			CacheStats.dwMisses++;
+			SST25ReadBlock(address, pLine->vData, wCopy);
+			pLine->dwAddress = address;
+			pLine->wLength = wCopy;
+		}
+
+		pLine->dwUsed = ++dwUseCount;
+		wOffset = (WORD)(address - pLine->dwAddress);
+		wCopy = pLine->wLength - wOffset;
+		if (wCopy > nCount)
+			wCopy = nCount;
+		memcpy(pData, &pLine->vData[wOffset], wCopy);
+		address += wCopy;
+		pData += wCopy;
+		nCount -= wCopy;
+	}
+	xSemaphoreGive(hCacheMutex);
+#else
+	CacheStats.dwDirect++;
+	SST25ReadBlock(address, pData, nCount);
+#endif
+}
+
+/************************************************************************
+* Function: BYTE SST25ReadByte(DWORD address)             
+*                                                                       
+* Overview: this function reads a byte from the address specified         
+*                                                                       
+* Input: address                                                     
+*                                                                       
+* Output: data read
+*                                                                       
+************************************************************************/
+BYTE SST25ReadByte(DWORD address)
+{
+	BYTE temp;
+
+	SST25ReadArray(address, &temp, 1);
+	return temp;
+}
+
+/************************************************************************
+* Function: WORD SST25ReadWord(DWORD address)             
+*                                                                       
+* Overview: this function reads a 16-bit word from the address specified         
+*                                                                       
+* Input: address                                                     
+*                                                                       
+* Output: data read
+*                                                                       
+************************************************************************/
+WORD SST25ReadWord(DWORD address)
+{
+	WORD_VAL temp;
+
+	SST25ReadArray(address, temp.v, 2);
+	return temp.Val;
+}
+
+/************************************************************************
+* Function: void SST25CacheGetStats(SST25_CACHE_STATS* pStats)
+*                                                                       
+* Overview: copy the cache counters
+*                                                                       
+* Input: where to copy them
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+void SST25CacheGetStats(SST25_CACHE_STATS* pStats)
+{
+	*pStats = CacheStats;
+}
+
+#endif
@@ -41,6 +41,7 @@
  *****************************************************************************/
 
 // Standard includes
+#include <string.h>
 #include "HardwareProfile.h"
 #include "Graphics\Graphics.h"
 #include "SST25VF016.h"
@@ -56,6 +57,14 @@
 // Internal pointer to address being written
 DWORD dwWriteAddr;
 
+// TRUE while the flash is in auto address increment mode, taking the
+// next word for dwAAIAddr; every other command must end it first
+static BOOL bAAI;
+static DWORD dwAAIAddr;
+
+// counters for SST25GetWriteStats()
+static SST25_WRITE_STATS WriteStats;
+
 ///////////////////////////////////////////////////////////////////
 // Semaphores used to control access to SPI2 and FLASH
 extern xSemaphoreHandle SPI2Semaphore;
@@ -73,6 +82,7 @@ extern xSemaphoreHandle SPI2Semaphore;
 void SST25Init()
 {	
     SST25ResetWriteProtection();
+    SST25CacheInit();
 }
 
 /************************************************************************
@@ -114,6 +124,56 @@ void SPI2Put(BYTE data)
 ************************************************************************/           
 #define SPI2Get() SPI2BUF
 
+/************************************************************************
+* Function: void SST25WaitBusy(void)
+*                                                                       
+* Overview: this function polls the status register until the write or
+*           erase in progress ends, SPI2Semaphore must be held
+*                                                                       
+* Input: none
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+static void SST25WaitBusy(void)
+{
+	BYTE temp;
+
+	do {
+		SST25CSLow();
+		SPI2Put(SST25_CMD_RDSR);
+		SPI2Get();
+		SPI2Put(0);
+		temp = SPI2Get();
+		SST25CSHigh();
+		WriteStats.dwBusyPolls++;
+	} while (temp & 0x01);
+}
+
+/************************************************************************
+* Function: void SST25EndAAI(void)
+*                                                                       
+* Overview: this function leaves auto address increment mode once the
+*           last word is programmed, SPI2Semaphore must be held
+*                                                                       
+* Input: none
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+static void SST25EndAAI(void)
+{
+	if (!bAAI)
+		return;
+
+	SST25WaitBusy();
+	SST25CSLow();
+	SPI2Put(SST25_CMD_WRDI);
+	SPI2Get();
+	SST25CSHigh();
+	bAAI = FALSE;
+}
+
 /************************************************************************
 * Function: void SST25WriteByte(DWORD address, BYTE data)                                           
 *                                                                       
@@ -146,53 +206,15 @@ void SST25WriteByte(DWORD address, BYTE data)
     SPI2Put(data);
     SPI2Get();
 
-	dwWriteAddr++;
-	
     SST25CSHigh();
+    WriteStats.dwBytes++;
+    WriteStats.dwCommands++;
     xSemaphoreGive(SPI2Semaphore);
 
     // Wait for write end
     while(SST25IsWriteBusy());
     
-}
-
-/************************************************************************
-* Function: BYTE SST25ReadByte(DWORD address)             
-*                                                                       
-* Overview: this function reads a byte from the address specified         
-*                                                                       
-* Input: address                                                     
-*                                                                       
-* Output: data read
-*                                                                       
-************************************************************************/
-BYTE SST25ReadByte(DWORD address)
-{
-	BYTE temp;
-
-	xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
-
-    SST25CSLow();
-
-    SPI2Put(SST25_CMD_READ);
-    SPI2Get();
-
-    SPI2Put(((DWORD_VAL)address).v[2]);
-    SPI2Get();
-
-    SPI2Put(((DWORD_VAL)address).v[1]);
-    SPI2Get();
-
-    SPI2Put(((DWORD_VAL)address).v[0]);
-    SPI2Get();
-
-    SPI2Put(0);
-    temp = SPI2Get();
-
-    SST25CSHigh();    
-    xSemaphoreGive(SPI2Semaphore);
-    
-    return temp;
+    SST25CacheInvalidate(address);
 }
 
 /************************************************************************
@@ -211,25 +233,6 @@ void SST25WriteWord(DWORD address, WORD data)
     SST25WriteByte(address + 1, ((WORD_VAL)data).v[1]);
 }
 
-/************************************************************************
-* Function: WORD SST25ReadWord(DWORD address)             
-*                                                                       
-* Overview: this function reads a 16-bit word from the address specified         
-*                                                                       
-* Input: address                                                     
-*                                                                       
-* Output: data read
-*                                                                       
-************************************************************************/
-WORD SST25ReadWord(DWORD address){
-	WORD_VAL temp;
-
-    temp.v[0] = SST25ReadByte(address);
-    temp.v[1] = SST25ReadByte(address+1);
-
-    return temp.Val;
-}
-
 /************************************************************************
 * Function: SST25WriteEnable()                                         
 *                                                                       
@@ -243,6 +246,7 @@ WORD SST25ReadWord(DWORD address){
 ************************************************************************/
 void SST25WriteEnable(){
 	xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
+	SST25EndAAI();
     SST25CSLow();
     SPI2Put(SST25_CMD_WREN);
     SPI2Get();
@@ -277,6 +281,83 @@ BYTE SST25IsWriteBusy(void)
     return (temp & 0x01);
 }
 
+/************************************************************************
+* Function: void SST25Program(DWORD address, BYTE* pData, WORD nCount)
+*                                                                       
+* Overview: this function programs erased flash a word at a time in
+*           auto address increment mode, with single byte writes for an
+*           odd address or length. A write that carries on from the last
+*           one's end stays in the mode without a new address. The last
+*           word is left programming, so the caller can fill its next
+*           chunk meanwhile; SST25EndWrite() or the next command waits
+*           for it. SPI2Semaphore is released every SST25_WRITE_BATCH
+*           bytes to let the Ethernet controller use the bus.
+*                                                                       
+* Input: flash memory address, pointer to the data array, data number
+*                                                                       
+* Output: none
+*                                                                       
+************************************************************************/
+static void SST25Program(DWORD address, BYTE* pData, WORD nCount)
+{
+	DWORD dwStart = address;
+	WORD wBatch;
+
+	while (nCount > 0) {
+		if ((address & 1) || nCount == 1) {
+			SST25WriteByte(address, *pData++);
+			address++;
+			nCount--;
+			continue;
+		}
+
+		xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
+		for (wBatch = 0; nCount >= 2 && wBatch < SST25_WRITE_BATCH; wBatch += 2) {
+			if (bAAI && dwAAIAddr == address) {
+				// the previous word may still be programming
+				SST25WaitBusy();
+				SST25CSLow();
+				SPI2Put(SST25_CMD_AAI);
+				SPI2Get();
+			} else {
+				SST25EndAAI();
+				SST25CSLow();
+				SPI2Put(SST25_CMD_WREN);
+				SPI2Get();
+				SST25CSHigh();
+
+				SST25CSLow();
+				SPI2Put(SST25_CMD_AAI);
+				SPI2Get();
+				SPI2Put(((DWORD_VAL)address).v[2]);
+				SPI2Get();
+				SPI2Put(((DWORD_VAL)address).v[1]);
+				SPI2Get();
+				SPI2Put(((DWORD_VAL)address).v[0]);
+				SPI2Get();
+				bAAI = TRUE;
+			}
+			SPI2Put(pData[0]);
+			SPI2Get();
+			SPI2Put(pData[1]);
+			SPI2Get();
+			SST25CSHigh();
+
+			WriteStats.dwBytes += 2;
+			WriteStats.dwCommands++;
+			address += 2;
+			pData += 2;
+			nCount -= 2;
+			dwAAIAddr = address;
+		}
+		xSemaphoreGive(SPI2Semaphore);
+	}
+
+	// drop the cached lines of every sector written
+	for (dwStart &= ~SST25_FLASH_SECTOR_MASK; dwStart < address; dwStart += SST25_FLASH_SECTOR_SIZE)
+		SST25CacheInvalidate(dwStart);
+}
+
 /************************************************************************
 * Function: BYTE SST25WriteArray(DWORD address, BYTE* pData, nCount)
 *                                                                       
@@ -289,43 +370,41 @@ BYTE SST25IsWriteBusy(void)
 ************************************************************************/
 BYTE SST25WriteArray(DWORD address, BYTE* pData, WORD nCount)
 {
-	DWORD     addr;
-	BYTE*     pD;
-	WORD      counter;
-
-
-    addr = address;
-    pD   = pData;
+	BYTE      vVerify[16];
+	WORD      wLen;
 
     // WRITE
-    for(counter=0; counter<nCount; counter++)
-    {
-        SST25WriteByte(*pD++, addr++);
-    }
+    SST25Program(address, pData, nCount);
+    SST25EndWrite();
 
     // VERIFY
-    for(counter=0; counter<nCount; counter++)
-    {              
-        if(*pData != SST25ReadByte(address))
+    while(nCount)
+    {
+        wLen = (nCount < sizeof(vVerify)) ? nCount : sizeof(vVerify);
+        SST25ReadArray(address, vVerify, wLen);
+        if(memcmp(vVerify, pData, wLen) != 0)
             return 0;
-        pData++;
-        address++;
+        pData += wLen;
+        address += wLen;
+        nCount -= wLen;
     }
 
     return 1;
 }
 
 /************************************************************************
-* Function: void SST25ReadArray(DWORD address, BYTE* pData, nCount)
+* Function: void SST25ReadBlock(DWORD address, BYTE* pData, nCount)
 *                                                                       
-* Overview: this function reads data into buffer specified
+* Overview: this function reads data into buffer specified with one
+*           read command; SST25ReadArray() in SST25Cache.c calls it
 *                                                                       
 * Input: flash memory address, pointer to the data buffer, data number
 *                                                                       
 ************************************************************************/
-void SST25ReadArray(DWORD address, BYTE* pData, WORD nCount)
+void SST25ReadBlock(DWORD address, BYTE* pData, WORD nCount)
 {
 	xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
+	SST25EndAAI();
     SST25CSLow();
 
     SPI2Put(SST25_CMD_READ);
@@ -373,6 +452,8 @@ void SST25ChipErase(void)
     // Wait for write end
     while(SST25IsWriteBusy());
     
+    WriteStats.dwErases++;
+    SST25CacheInvalidate(SST25_CACHE_ALL);
 }
 
 /************************************************************************
@@ -388,6 +469,7 @@ void SST25ChipErase(void)
 void SST25ResetWriteProtection()
 {
 	xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
+	SST25EndAAI();
 
     SST25CSLow();
 
@@ -443,6 +525,8 @@ void SST25SectorErase(DWORD address)
     // Wait for write end
     while(SST25IsWriteBusy());
     
+    WriteStats.dwErases++;
+    SST25CacheInvalidate(address);
  }
 
 /***************************************************************************
@@ -459,22 +543,47 @@ void SST25BeginWrite(DWORD dwAddr)
  *****************************************************************/
 void SST25WriteIncrementalArray(BYTE* vData, WORD wLen)
 {
+	WORD wChunk;
+
 	while (wLen > 0) {
-		// wait for any existing transaction to finish
-		while (SST25IsWriteBusy());
-		
 		// clear the sector if on a sector boundary
-		if ((dwWriteAddr & SST25_FLASH_SECTOR_MASK) == 0) {
+		if ((dwWriteAddr & SST25_FLASH_SECTOR_MASK) == 0)
 			SST25SectorErase(dwWriteAddr);
-			while (SST25IsWriteBusy());
-		}
-			
-		// write the byte of data
-		SST25WriteByte(dwWriteAddr, *vData);
-		// dwWriteAddr is incremented in WriteByte
-		vData++;
-		wLen--;
+
+		// program up to the end of the sector
+		wChunk = SST25_FLASH_SECTOR_SIZE - (dwWriteAddr & SST25_FLASH_SECTOR_MASK);
+		if (wChunk > wLen)
+			wChunk = wLen;
+		SST25Program(dwWriteAddr, vData, wChunk);
+
+		dwWriteAddr += wChunk;
+		vData += wChunk;
+		wLen -= wChunk;
 	}
 }
 
+/******************************************************************
+ *  SST25EndWrite(void);
+ * finish the last word of an incremental write
+ *****************************************************************/
+void SST25EndWrite(void)
+{
+	xSemaphoreTake(SPI2Semaphore, portMAX_DELAY);
+	SST25EndAAI();
+	xSemaphoreGive(SPI2Semaphore);
+}
+
+/************************************************************************
+* Function: void SST25GetWriteStats(SST25_WRITE_STATS* pStats)
+*                                                                       
+* Overview: copy the write counters
+*                                                                       
+* Input: where to copy them
+*                                                                       
+************************************************************************/
+void SST25GetWriteStats(SST25_WRITE_STATS* pStats)
+{
+	*pStats = WriteStats;
+}
+
 #endif
@@ -130,6 +130,11 @@ void StackInit(void)
 	srand(42);
 	//srand(GenerateRandomDWORD());
 
+#if defined(STACK_USE_RANDOM)
+	// TCPInit() already takes initial sequence numbers from here
+	RandomInit();
+#endif
+
     MACInit();
 #if defined( ZG_CS_TRIS )
     #if defined(ZG_CONFIG_LINKMGRII) 
@@ -274,11 +279,6 @@ void StackTask(void)
 	// Process as many incomming packets as we can
 	while(1)
 	{
-		//if using the random module, generate entropy
-		#if defined(STACK_USE_RANDOM)
-			RandomAdd(remoteNode.MACAddr.v[5]);
-		#endif
-
 		// We are about to fetch a new packet, make sure that the 
 		// UDP module knows that any old RX data it has laying 
 		// around will now be gone.
@@ -291,6 +291,11 @@ void StackTask(void)
 		if(!MACGetHeader(&remoteNode.MACAddr, &cFrameType))
 			break;
 
+		//if using the random module, generate entropy from this packet
+		#if defined(STACK_USE_RANDOM)
+			RandomAdd(remoteNode.MACAddr.v[5]);
+		#endif
+
 		// Dispatch the packet to the appropriate handler
 		switch(cFrameType)
 		{
@@ -302,6 +307,9 @@ void StackTask(void)
 				if(!IPGetHeader(&tempLocalIP, &remoteNode, &cIPFrameType, &dataCount))
 					break;
 
+				// Remember where on-link senders are so replies need no ARP
+				ARPLearn(&remoteNode);
+
 				#if defined(STACK_USE_ICMP_SERVER) || defined(STACK_USE_ICMP_CLIENT)
 				if(cIPFrameType == IP_PROT_ICMP)
 				{
@@ -427,4 +435,16 @@ void StackApplications(void)
 	#if defined(STACK_USE_UART2TCP_BRIDGE)
 	UART2TCPBridgeTask();
 	#endif
+	
+	#if defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	BerkeleySocketTask();
+	#endif
+	
+	#if defined(STACK_USE_SSL) && defined(SSL_SESSION_PERSIST)
+	SSLSessionSaveTask();
+	#endif
+	
+	#if defined(STACK_USE_RANDOM)
+	RandomTask();
+	#endif
 }
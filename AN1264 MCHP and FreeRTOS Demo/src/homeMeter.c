@@ -44,6 +44,7 @@
 #include "queue.h"
 #include "semphr.h"
 #include "taskUART.h"
+#include "taskTCPIP.h"
 #include "homeMeter.h"
 
 // queue for incoming data updates
@@ -89,6 +90,7 @@ void taskMeter(void* pvParameter)
 	gMeter.gas_total = 0;
 	gMeter.gas_on = 1;
 	gMeter.temperature = 0;	
+	MeterChanged();
 	xSemaphoreGive(METERSemaphore);
 	
 	while (1) {
@@ -101,6 +103,7 @@ void taskMeter(void* pvParameter)
 			case MSG_METER_UPDATE_TEMPERATURE:
 				// update the meter
 				gMeter.temperature = msg.data.wVal[0];
+				MeterChanged();
 				// send an update to the QVGA display
 				gMsg.cmd = MSG_UPDATE_TEMPERATURE;
 				gMsg.data.wVal[0] = gMeter.temperature;
@@ -112,6 +115,7 @@ void taskMeter(void* pvParameter)
 				if (gMeter.electric_on == 1) {
 					gMeter.electric_units++;
 					gMeter.electric_total += gMeter.electric_cost; 
+					MeterChanged();
 				
 					// send update to the QVGA display (Note preformatting)
 					gMsg.cmd = MSG_UPDATE_ELECTRIC_UNITS;
@@ -129,6 +133,7 @@ void taskMeter(void* pvParameter)
 				if (gMeter.gas_on == 1) {
 					gMeter.gas_units++;
 					gMeter.gas_total += gMeter.gas_cost;
+					MeterChanged();
 					
 					// send update to the display
 					gMsg.cmd = MSG_UPDATE_GAS_UNITS;
@@ -144,11 +149,13 @@ void taskMeter(void* pvParameter)
 			case MSG_METER_UPDATE_ELECTRIC_COST:
 				// update the unit cost
 				gMeter.electric_cost = msg.data.wVal[0];
+				MeterChanged();
 				break;
 				
 			case MSG_METER_UPDATE_GAS_COST:
 				// update the unit cost
 				gMeter.gas_cost = msg.data.wVal[0];
+				MeterChanged();
 				break;
 				
 			default:
@@ -160,3 +167,29 @@ void taskMeter(void* pvParameter)
 	}	
 }
 
+/*********************************************************************
+ * Function:        void MeterChanged(void)
+ *
+ * PreCondition:    METERSemaphore is held and gMeter has just been
+ *					changed
+ *
+ * Input:           None
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Give gMeter a new version and wake the TCPIP task,
+ *					whose status.sse callbacks compare the version
+ *					with the one they last looked at and stream the
+ *					fields that differ from what they sent
+ *
+ * Note:            The temperature the touchscreen ISR writes goes
+ *					out with the next change made here
+ ********************************************************************/
+void MeterChanged(void)
+{
+	gMeter.version++;
+	if (hTCPIPTask != NULL)
+		xTaskNotifyGive(hTCPIPTask);
+}
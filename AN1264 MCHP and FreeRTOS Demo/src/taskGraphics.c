@@ -143,7 +143,7 @@ void CreateElectricityScreen(void);
 void CreateRTOSScreen(void);
 void UpdateRTOSScreen(void);
 void UpdateUsageGraph(void);
-void DrawRTOSStack(XCHAR* sTitle, short ypos, short stack_used, short stack_size);
+void DrawRTOSStack(XCHAR* sTitle, short ypos, short stack_used, short stack_size, short cpu_load);
 WORD msgMain(WORD objMsg, OBJ_HEADER* pObj);
 WORD msgGas(WORD objMsg, OBJ_HEADER* pObj);
 WORD msgElectric(WORD objMsg, OBJ_HEADER* pObj);
@@ -168,6 +168,22 @@ xQueueHandle hQVGAQueue;
 WORD usage_xpos;
 WORD usage_last_value;
 
+// number of application tasks shown on the RTOS screen
+#define RTOS_DISPLAYED_TASKS	6
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+///////////////////////////////////////////////////////////////////
+// Run time statistics used to show the CPU load of each task on
+// the RTOS screen. The load is measured between screen updates so
+// the previous run time of each displayed task is kept
+#define RTOS_MAX_TASKS			10
+static xTaskRunTimeStatus rtosStats[RTOS_MAX_TASKS];
+static unsigned portBASE_TYPE rtosStatsCount;
+static unsigned long long rtosLastRunTime[RTOS_DISPLAYED_TASKS];
+static unsigned long long rtosLastTotalRunTime;
+static short GetTaskLoad(xTaskHandle hTask, BYTE index, unsigned long long elapsed);
+#endif
+
 /*********************************************************************
  * Function:        void taskGraphics(void* pvParameter)
  *
@@ -718,6 +734,7 @@ void CreateElectricityScreen(void)
  *					ypos, position on the display
  *					stack_used, current high water mark (bytes)
  *					stack_size, size of this stack (bytes)
+ *					cpu_load, share of the CPU used by the task (%)
  *
  * Output:          None
  *
@@ -725,9 +742,10 @@ void CreateElectricityScreen(void)
  *
  * Overview:        Draw an rtos bar
  *
- * Note:            
+ * Note:            The CPU load is drawn as a yellow strip along the
+ *					bottom of the bar, 100% being the full bar width
  ********************************************************************/
-void DrawRTOSStack(XCHAR* sTitle, short ypos, short stack_used, short stack_size)
+void DrawRTOSStack(XCHAR* sTitle, short ypos, short stack_used, short stack_size, short cpu_load)
 {
 	short textHeight;
 	short bar_length;
@@ -753,6 +771,12 @@ void DrawRTOSStack(XCHAR* sTitle, short ypos, short stack_used, short stack_size
 	bar_length = (2 * stack_used) / MAX_BAR_LENGTH;
 	SetColor(RED);
 	Bar(61, ypos + 2, 60 + bar_length, ypos + textHeight - 3);	
+
+	// overlay the CPU load, scaled so 100% fills the 200 pixel area
+	if (cpu_load > 0) {
+		SetColor(BRIGHTYELLOW);
+		Bar(61, ypos + textHeight - 4, 60 + (2 * cpu_load), ypos + textHeight - 3);
+	}
 	
 	// draw the usage summary at the end
 	SetColor(WHITE);
@@ -862,6 +886,7 @@ WORD msgMain(WORD objMsg, OBJ_HEADER* pObj)
 			// update the meter object
 			xSemaphoreTake(METERSemaphore, portMAX_DELAY);
 			gMeter.setpoint = dialVal;
+			MeterChanged();
 			xSemaphoreGive(METERSemaphore);
 			
 			// put limits on the rotation
@@ -925,6 +950,7 @@ WORD msgGas(WORD objMsg, OBJ_HEADER* pObj)
 					// update the meter
 					xSemaphoreTake(METERSemaphore, portMAX_DELAY);
 					gMeter.gas_on = 1;
+					MeterChanged();
 					xSemaphoreGive(METERSemaphore);
 				}
 			}
@@ -941,6 +967,7 @@ WORD msgGas(WORD objMsg, OBJ_HEADER* pObj)
 					// update the meter
 					xSemaphoreTake(METERSemaphore, portMAX_DELAY);
 					gMeter.gas_on = 0;
+					MeterChanged();
 					xSemaphoreGive(METERSemaphore);
 				}
 			}
@@ -988,6 +1015,7 @@ WORD msgElectric(WORD objMsg, OBJ_HEADER* pObj)
 					// update the meter
 					xSemaphoreTake(METERSemaphore, portMAX_DELAY);
 					gMeter.electric_on = 1;
+					MeterChanged();
 					xSemaphoreGive(METERSemaphore);
 				}
 			}
@@ -1004,6 +1032,7 @@ WORD msgElectric(WORD objMsg, OBJ_HEADER* pObj)
 					// update the meter
 					xSemaphoreTake(METERSemaphore, portMAX_DELAY);
 					gMeter.electric_on = 0;
+					MeterChanged();
 					xSemaphoreGive(METERSemaphore);
 				}
 			}
@@ -1058,9 +1087,10 @@ WORD msgRTOS(WORD objMsg, OBJ_HEADER* pObj)
  *
  * Side Effects:    None
  *
- * Overview:        Repaint the stack usage info
+ * Overview:        Repaint the stack usage and CPU load info
  *
- * Note:            
+ * Note:            The CPU load shown is that since the previous
+ *					update of the screen
  ********************************************************************/
 static const XCHAR uartStr[] = {'U','A','R','T',':',0};
 static const XCHAR meterStr[] = {'M','E','T','E','R',':',0};
@@ -1073,6 +1103,21 @@ void UpdateRTOSScreen(void)
 	unsigned portBASE_TYPE hw;
 	short textHeight;
 	short ypos;
+	short load[RTOS_DISPLAYED_TASKS] = {0, 0, 0, 0, 0, 0};
+#if (configGENERATE_RUN_TIME_STATS == 1)
+	unsigned long long total, elapsed;
+	
+	// work out how much of the CPU each task has used since the last update
+	rtosStatsCount = uxTaskGetRunTimeSnapshot(rtosStats, RTOS_MAX_TASKS, &total);
+	elapsed = total - rtosLastTotalRunTime;
+	rtosLastTotalRunTime = total;
+	load[0] = GetTaskLoad(hUARTTask, 0, elapsed);
+	load[1] = GetTaskLoad(hMETERTask, 1, elapsed);
+	load[2] = GetTaskLoad(hMIWITask, 2, elapsed);
+	load[3] = GetTaskLoad(hTOUCHTask, 3, elapsed);
+	load[4] = GetTaskLoad(hGRAPHICSTask, 4, elapsed);
+	load[5] = GetTaskLoad(hTCPIPTask, 5, elapsed);
+#endif
 	
 	// display the RTOS task usage bargraph
 	textHeight = GetTextHeight((void*) &GOLSmallFont);
@@ -1083,29 +1128,67 @@ void UpdateRTOSScreen(void)
 	// for each task display its stack usage as a bar graph and summary text
 	ypos = 48;	
 	hw = (STACK_SIZE_UART - uxTaskGetStackHighWaterMark(hUARTTask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) uartStr, ypos, hw, STACK_SIZE_UART * sizeof(portSTACK_TYPE));
+	DrawRTOSStack((XCHAR*) uartStr, ypos, hw, STACK_SIZE_UART * sizeof(portSTACK_TYPE), load[0]);
 	
 	ypos += textHeight;
 	hw = (STACK_SIZE_METER - uxTaskGetStackHighWaterMark(hMETERTask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) meterStr, ypos, hw, STACK_SIZE_METER * sizeof(portSTACK_TYPE));
+	DrawRTOSStack((XCHAR*) meterStr, ypos, hw, STACK_SIZE_METER * sizeof(portSTACK_TYPE), load[1]);
 				
 	ypos += textHeight;
 	hw = (STACK_SIZE_MIWI - uxTaskGetStackHighWaterMark(hMIWITask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) miwiStr, ypos, hw, STACK_SIZE_MIWI * sizeof(portSTACK_TYPE));
+	DrawRTOSStack((XCHAR*) miwiStr, ypos, hw, STACK_SIZE_MIWI * sizeof(portSTACK_TYPE), load[2]);
 
 	ypos += textHeight;
 	hw = (STACK_SIZE_TOUCHSCREEN - uxTaskGetStackHighWaterMark(hTOUCHTask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) touchStr, ypos, hw, STACK_SIZE_TOUCHSCREEN * sizeof(portSTACK_TYPE));
+	DrawRTOSStack((XCHAR*) touchStr, ypos, hw, STACK_SIZE_TOUCHSCREEN * sizeof(portSTACK_TYPE), load[3]);
 
 	ypos += textHeight;
 	hw = (STACK_SIZE_GRAPHICS - uxTaskGetStackHighWaterMark(hGRAPHICSTask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) graphicsStr, ypos, hw, STACK_SIZE_GRAPHICS * sizeof(portSTACK_TYPE));
+	DrawRTOSStack((XCHAR*) graphicsStr, ypos, hw, STACK_SIZE_GRAPHICS * sizeof(portSTACK_TYPE), load[4]);
 
 	ypos += textHeight;
 	hw = (STACK_SIZE_TCPIP - uxTaskGetStackHighWaterMark(hTCPIPTask)) * sizeof(portSTACK_TYPE);
-	DrawRTOSStack((XCHAR*) tcpipStr, ypos, hw, STACK_SIZE_TCPIP * sizeof(portSTACK_TYPE));	
+	DrawRTOSStack((XCHAR*) tcpipStr, ypos, hw, STACK_SIZE_TCPIP * sizeof(portSTACK_TYPE), load[5]);	
 }
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/*********************************************************************
+ * Function:        short GetTaskLoad(xTaskHandle hTask, BYTE index,
+ *									unsigned long long elapsed)
+ *
+ * PreCondition:    rtosStats holds a current run time snapshot
+ *
+ * Input:           hTask, the task to look up in the snapshot
+ *					index, slot holding the task's previous run time
+ *					elapsed, total run time since the previous snapshot
+ *
+ * Output:          CPU load of the task since the previous snapshot (%)
+ *
+ * Side Effects:    Records the task's run time for next time
+ *
+ * Overview:        Calculate the CPU load of a task
+ *
+ * Note:            
+ ********************************************************************/
+static short GetTaskLoad(xTaskHandle hTask, BYTE index, unsigned long long elapsed)
+{
+	unsigned portBASE_TYPE i;
+	unsigned long long used;
+	
+	for (i = 0; i < rtosStatsCount; i++) {
+		if (rtosStats[i].xHandle == hTask) {
+			used = rtosStats[i].ullRunTimeCounter - rtosLastRunTime[index];
+			rtosLastRunTime[index] = rtosStats[i].ullRunTimeCounter;
+			if (elapsed == 0)
+				return 0;
+			return (short) ((used * 100) / elapsed);
+		}
+	}
+	
+	return 0;
+}
+#endif
+
 /*********************************************************************
  * Function:        void UpdateUsageGraph(void)
  *
@@ -80,10 +80,9 @@ BYTE myChannel = 25;
 xQueueHandle hMIWITxQueue; // queue to send outgoing MIWI messages
 xQueueHandle hMIWIRxQueue; // queue to receive incoming MIWI messages
 
-// handle for the task
+// handle for the task, also used by the RF ISR to notify the task
+// that a message has been received by the MiWi stack
 xTaskHandle hMIWITask;
-// semaphore used to indicate received message in the MiWi stack
-xSemaphoreHandle hMiWiSemaphore;
 
 /*********************************************************************
  * Function:        xQueueHandle xStartMIWITask(void)
@@ -107,6 +106,8 @@ xQueueHandle xStartMIWITask(void)
 	hMIWITxQueue = xQueueCreate(MIWI_QUEUE_SIZE, MIWI_ENTRY_SIZE);
 	// create the queue to place received MIWI data
 	hMIWIRxQueue = xQueueCreate(MIWI_QUEUE_SIZE, MIWI_ENTRY_SIZE);
+	vQueueAddToRegistry(hMIWITxQueue, (signed char*) "MIWITx");
+	vQueueAddToRegistry(hMIWIRxQueue, (signed char*) "MIWIRx");
 
 	// create the MIWI task
 	xTaskCreate(taskMIWI, (signed char*) "MIWI", STACK_SIZE_MIWI, 
@@ -137,12 +138,8 @@ void taskMIWI(void* pvParameter)
     METER_MSG msg;
     DWORD	dwUnits;
 	
-	// create the miwi semaphore
-	vSemaphoreCreateBinary(hMiWiSemaphore);
-	xSemaphoreTake(hMiWiSemaphore, portMAX_DELAY);
-	
-	// allow interrupts from the RF transceiver after the MiWiSemaphore
-	// has been created (it is posted from the RF ISR so must exist first)
+	// allow interrupts from the RF transceiver now the task is running
+	// (the RF ISR notifies hMIWITask so it must exist first)
 	RFIE = 1;
 	
 	// initialize the Microchip MiWi P2P stack
@@ -161,16 +158,16 @@ void taskMIWI(void* pvParameter)
 	UARTprintf("MIWI: Bound to peer.\r\n");
 	
 	while (1) {
-    	// We use a sempahore to signal that this task should
+    	// We use a task notification to signal that this task should
     	// perform some processing. In the MiWi ISR handler
-    	// if any packet is received hMiWiSemaphore is set indicating
+    	// if any packet is received this task is notified indicating
     	// that processing needs to occur. This will unblock this task
     	// which will then complete the receive and process the packet
     	// To keep the network alive a timeout is used so that 
     	// stack processing can occur regardless but at a much slower
     	// rate. This technique allows taskMiWi to run at low
     	// priority without consuming too much processor time
-	    xSemaphoreTake(hMiWiSemaphore, 1000 / portTICK_RATE_MS);
+	    ulTaskNotifyTake(pdTRUE, 1000 / portTICK_RATE_MS);
 	        
 		// check for new received data. This function call also keeps
 		// the stack alive by allowing it to perform stack processing
@@ -52,6 +52,15 @@
 // appconfig version number
 #define APP_VERSION		0x60
 
+// longest the task sleeps when neither a packet nor a TCP timer wakes
+// it, so DHCP, NBNS and the other polled modules still run.  The
+// ENC28J60 PKTIF flag that drives the INT pin is not reliable (see the
+// silicon errata) so this also bounds the delay after a missed interrupt
+#define TCPIP_IDLE_PERIOD	(250 / portTICK_RATE_MS)
+
+// period of the polling loop used when the MAC interrupt is not wired
+#define TCPIP_POLL_PERIOD	(50 / portTICK_RATE_MS)
+
 // Declare AppConfig structure to store information on the tcpip configuration
 APP_CONFIG AppConfig;
 static DWORD dwLastIP = 0;
@@ -60,6 +69,9 @@ static DWORD dwLastIP = 0;
 // private helper functions
 static void InitAppConfig(void);
 static void DisplayIPValue(IP_ADDR IPVal);
+#if defined(MAC_ISR_ENABLE)
+static portTickType TCPIPGetSleepTime(void);
+#endif
 
 // semaphore to regulate access to the FLASH, the touchscreen
 // task will access it initially and then hand over control to
@@ -87,6 +99,10 @@ xTaskHandle hTCPIPTask;
  ********************************************************************/
 void taskTCPIP(void* pvParameter)
 {
+	#if defined(MAC_ISR_ENABLE)
+	portTickType xSleep;
+	#endif
+
 	// obtain the semaphore to access the SPI FLASH, once it has
 	// been obtained this task never releases it and assumes
 	// exclusive access to MPFS
@@ -102,9 +118,17 @@ void taskTCPIP(void* pvParameter)
 	// Initialize the core stack layers
 	StackInit();
 	
+	#if defined(MAC_ISR_ENABLE)
+	// StackInit() has set up the controller to assert INT when a 
+	// packet arrives, interrupt on its falling edge
+	MAC_INT_TRIS = 1;
+	MAC_ISR_POLARITY = 0;
+	MAC_ISR_PRIORITY = 2;
+	MAC_ISR_FLAG = 0;
+	MAC_ISR_ENABLE = 1;
+	#endif
+	
 	while (1) {
-		vTaskDelay(50 / portTICK_RATE_MS);	
-		
 		// perform normal stack tasks including checking for incoming
 		// packets and calling appropriate handlers
 		StackTask();
@@ -117,10 +141,106 @@ void taskTCPIP(void* pvParameter)
 		if (dwLastIP != AppConfig.MyIPAddr.Val) {
     		dwLastIP = AppConfig.MyIPAddr.Val;
 			DisplayIPValue(AppConfig.MyIPAddr);
-		}		
+		}
+		
+		#if defined(MAC_ISR_ENABLE)
+		// sleep until the MAC interrupt reports a packet, a task makes
+		// a Berkeley API call or the next TCP timer is due, or only
+		// yield while an SSL RSA operation has more steps to run
+		xSleep = TCPIPGetSleepTime();
+		if (xSleep == 0)
+			taskYIELD();
+		else
+			ulTaskNotifyTake(pdTRUE, xSleep);
+		#else
+		// a Berkeley API call from another task ends the wait early
+		ulTaskNotifyTake(pdTRUE, TCPIP_POLL_PERIOD);
+		#endif
 	}	
 }
 
+#if defined(MAC_ISR_ENABLE)
+/*********************************************************************
+ * Function:        static portTickType TCPIPGetSleepTime(void)
+ *
+ * PreCondition:    StackInit() has been called
+ *
+ * Input:           None
+ *                  
+ * Output:          Number of RTOS ticks the TCPIP task may sleep,
+ *					0 if the stack has work to do now
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Convert the time until the next TCP timer or
+ *					Berkeley API timeout expires into RTOS ticks,
+ *					rounding up so the timer has expired when the
+ *					task wakes, and limit it to TCPIP_IDLE_PERIOD
+ *
+ * Note:            The INT pin stays low while the controller holds
+ *					packets and only its falling edge interrupts, so
+ *					the task just yields while any are left unread
+ ********************************************************************/
+static portTickType TCPIPGetSleepTime(void)
+{
+	DWORD dwTicks;
+	QWORD qwSleep;
+	#if defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	DWORD dwBSDTicks;
+	#endif
+
+	if (MAC_INT_IO == 0)
+		return 0;
+
+	dwTicks = TCPGetNextEvent();
+	#if defined(STACK_USE_BERKELEY_API) && defined(BSD_USE_RTOS)
+	dwBSDTicks = BerkeleyGetNextEvent();
+	if (dwBSDTicks < dwTicks)
+		dwTicks = dwBSDTicks;
+	#endif
+	if (dwTicks == 0)
+		return 0;
+
+	qwSleep = ((QWORD)dwTicks * configTICK_RATE_HZ + TICK_SECOND - 1) / TICK_SECOND;
+	if (qwSleep > TCPIP_IDLE_PERIOD)
+		return TCPIP_IDLE_PERIOD;
+
+	return (portTickType)qwSleep;
+}
+
+/*********************************************************************
+ * Function:        void vMACInterruptHandler(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The Ethernet controller has received a packet,
+ *					wake the TCPIP task to process it
+ *
+ * Note:            The controller is not accessed here, the SPI bus
+ *					belongs to the TCPIP task
+ ********************************************************************/
+#if defined(__C30__)
+void __attribute__((__interrupt__, auto_psv)) MAC_ISR_VECTOR(void)
+#else
+void __attribute__( (interrupt(ipl2), vector(MAC_ISR_VECTOR))) vMACInterruptHandler(void)
+#endif
+{
+	portBASE_TYPE xTaskWoken = pdFALSE;
+
+	MAC_ISR_FLAG = 0;
+	xTaskNotifyFromISR(hTCPIPTask, &xTaskWoken);
+
+	if (xTaskWoken != pdFALSE)
+		taskYIELD();
+}
+#endif
+
 /*********************************************************************
  * Function:        void SaveAppConfig(void)
  *
@@ -145,26 +265,27 @@ void SaveAppConfig(void)
     p = (BYTE*)&AppConfig;
     d = MPFS_RESERVE_BASE;
     
-	// erase the FLASH sector
 	#if (GRAPHICS_PICTAIL_VERSION == 3)
-		SST25SectorErase(MPFS_RESERVE_BASE);
-		SST25WriteByte(d, APP_VERSION);
+		// the sector is erased as the write starts on it, then the
+		// configuration is programmed a word at a time
+		c = APP_VERSION;
+		SST25BeginWrite(d);
+		SST25WriteIncrementalArray(&c, 1);
+		SST25WriteIncrementalArray(p, sizeof(AppConfig));
+		SST25EndWrite();
 	#else
+		// erase the FLASH sector
 		SST39SectorErase(MPFS_RESERVE_BASE);
 		SST39WriteByte(d, APP_VERSION);
-	#endif    
-    d++;
-    
-    for(c = 0; c < sizeof(AppConfig); c++) {
-	    bVal = *p;
-		#if (GRAPHICS_PICTAIL_VERSION == 3)
-        	SST25WriteByte(d, bVal);
-        #else
+	    d++;
+	    
+	    for(c = 0; c < sizeof(AppConfig); c++) {
+		    bVal = *p;
 			SST39WriteByte(d, bVal);
-		#endif
-		p++;
-		d++;
-    }
+			p++;
+			d++;
+	    }
+	#endif    
 }
 
 /*********************************************************************
@@ -274,11 +395,12 @@ static void InitAppConfig(void)
  ********************************************************************/
 static void DisplayIPValue(IP_ADDR IPVal)
 {
-	UARTMsg sMsg;	
+	UARTMsg* pMsg;	
 
-	sprintf(sMsg.buff, "TCPIP: IP Changed %u.%u.%u.%u\r\n", 
+	pMsg = UARTGetMsg(portMAX_DELAY);
+	sprintf(pMsg->buff, "TCPIP: IP Changed %u.%u.%u.%u\r\n", 
 			IPVal.v[0], IPVal.v[1], IPVal.v[2], IPVal.v[3]);
 
 	// send the message to the UART task
-	xQueueSendToBack(hUARTTxQueue, &sMsg, portMAX_DELAY);		
+	UARTSendMsg(pMsg, portMAX_DELAY);		
 }
@@ -58,7 +58,9 @@ void taskUART(void* pvParameter);
 ///////////////////////////////////////////////////////////////////
 // Variables 
 xQueueHandle hUARTTxQueue;
-xQueueHandle hUARTRxQueue;
+xStreamBufferHandle hUARTTxStream;
+xStreamBufferHandle hUARTRxStream;
+xPoolHandle hUARTMsgPool;
 xTaskHandle hUARTTask;
 
 /*********************************************************************
@@ -78,10 +80,15 @@ xTaskHandle hUARTTask;
  ********************************************************************/
 xQueueHandle xStartUARTTask(void)
 {
-	// create the UART queue for transmitting data
-	hUARTTxQueue = xQueueCreate(UART_QUEUE_SIZE, sizeof(UARTMsg));
-	// and the queue for receiving characters
-	hUARTRxQueue = xQueueCreate(UART_QUEUE_SIZE, sizeof(char));
+	// create the UART queue for transmitting data, messages are passed
+	// by reference so only a pointer is copied in and out of the queue
+	hUARTTxQueue = xQueueCreateByReference(UART_QUEUE_SIZE);
+	hUARTMsgPool = xPoolCreate(UART_POOL_SIZE, sizeof(UARTMsg));
+	// the characters themselves go through byte streams that the
+	// interrupts can fill and empty a FIFO load at a time
+	hUARTTxStream = xStreamBufferCreate(UART_TX_STREAM_SIZE, 1);
+	hUARTRxStream = xStreamBufferCreate(UART_RX_STREAM_SIZE, UART_RX_TRIGGER);
+	vQueueAddToRegistry(hUARTTxQueue, (signed char*) "UARTTx");
 	
 	// set up the UART
 	UARTTX_TRIS = 0;
@@ -113,28 +120,96 @@ xQueueHandle xStartUARTTask(void)
  ********************************************************************/
 void taskUART(void* pvParameter)
 {
-	UARTMsg msg;
+	UARTMsg* pMsg;
 	char* pChar;
+	size_t xLength, xWritten;
 		
 	// in this task we wait for a string to be received and then
-	// print it out.
+	// pass it to the TX interrupt.
 	while (1) {
 		// wait until a message is received
-		xQueueReceive(hUARTTxQueue, &msg, portMAX_DELAY);
+		xQueueReceiveReference(hUARTTxQueue, &pMsg, portMAX_DELAY);
 		
-		// print out the string
-		pChar = msg.buff;
-		while (*pChar != '\0') {
-			// while there is space in the tx buffer
-			while ((!USTAbits.UTXBF) && (*pChar != '\0')) {
-				UTXREG = *pChar++;	
-			}			
+		// copy the string into the TX stream, blocking while the
+		// interrupt makes room rather than polling the UART
+		pChar = pMsg->buff;
+		xLength = strlen(pChar);
+		while (xLength > 0) {
+			xWritten = xStreamBufferSend(hUARTTxStream, pChar, xLength, portMAX_DELAY);
+			pChar += xWritten;
+			xLength -= xWritten;
+			UARTTXIntStart();
 		}
+		
+		// the message has been copied so the buffer can be reused
+		vPoolRelease(pMsg);
 	}	
 }
 
 /*********************************************************************
- * Function:        void UART ReceiveInterrupt(void)
+ * Function:        static void UARTReadFIFO(portBASE_TYPE* pxTaskWoken)
+ *
+ * PreCondition:    Called from the UART interrupt
+ *
+ * Input:           Set to pdTRUE if a higher priority task was woken
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Empty the RX FIFO into the RX stream a FIFO load at
+ *					a time rather than one character at a time
+ *
+ * Note:            If the stream is full the characters are lost
+ *					rather than blocking the ISR
+ ********************************************************************/
+static void UARTReadFIFO(portBASE_TYPE* pxTaskWoken)
+{
+	char cChars[8];
+	size_t xCount;
+	
+	while (USTAbits.URXDA) {
+		xCount = 0;
+		while ((USTAbits.URXDA) && (xCount < sizeof(cChars))) {
+			cChars[xCount++] = URXREG;
+		}
+		xStreamBufferSendFromISR(hUARTRxStream, cChars, xCount, pxTaskWoken);
+	}
+}
+
+/*********************************************************************
+ * Function:        static void UARTFillFIFO(portBASE_TYPE* pxTaskWoken)
+ *
+ * PreCondition:    Called from the UART interrupt
+ *
+ * Input:           Set to pdTRUE if a higher priority task was woken
+ *                  
+ * Output:          None
+ *
+ * Side Effects:    Disables the TX interrupt once the TX stream is empty
+ *
+ * Overview:        Move characters from the TX stream into the TX FIFO
+ *					until it is full
+ *
+ * Note:            
+ ********************************************************************/
+static void UARTFillFIFO(portBASE_TYPE* pxTaskWoken)
+{
+	char cChar;
+	
+	while (!USTAbits.UTXBF) {
+		if (xStreamBufferReceiveFromISR(hUARTTxStream, &cChar, 1, pxTaskWoken) == 0) {
+			// nothing more to send, the UART task restarts the
+			// interrupt when it next writes to the stream
+			UARTTXIntStop();
+			break;
+		}
+		UTXREG = cChar;
+	}
+}
+
+/*********************************************************************
+ * Function:        void UART Interrupts(void)
  *
  * PreCondition:    None
  *
@@ -153,18 +228,23 @@ void taskUART(void* pvParameter)
 #if defined(__C30__)
 void __attribute__((__interrupt__, auto_psv)) _U2RXInterrupt(void)
 {
-	char cChar;
 	portBASE_TYPE xTaskWoken = pdFALSE;
 	
-	// get the character and post it on the queue possibly starting a context
+	// pass the characters to the stream possibly starting a context
 	// switch if a higher priority task was woken
 	IFS1bits.U2RXIF = 0;
-	while (USTAbits.URXDA) {
-		cChar = URXREG;
-		// send the data to the queue, if the queue is full then we
-		// lose the data rather than blocking the ISR
-		xQueueSendFromISR(hUARTRxQueue, &cChar, &xTaskWoken);
-	}	
+	UARTReadFIFO(&xTaskWoken);
+	
+	if (xTaskWoken != pdFALSE)
+		taskYIELD();	
+}
+
+void __attribute__((__interrupt__, auto_psv)) _U2TXInterrupt(void)
+{
+	portBASE_TYPE xTaskWoken = pdFALSE;
+	
+	IFS1bits.U2TXIF = 0;
+	UARTFillFIFO(&xTaskWoken);
 	
 	if (xTaskWoken != pdFALSE)
 		taskYIELD();	
@@ -173,23 +253,21 @@ void __attribute__((__interrupt__, auto_psv)) _U2RXInterrupt(void)
 // the actual PIC32 handling routine 
 void __attribute__( (interrupt(ipl2), vector(_UART2_VECTOR))) vU2InterruptHandler(void)
 {
-	char cChar;
 	portBASE_TYPE xTaskWoken = pdFALSE;
 	
 	// check for RX interrupts
 	if (mU2RXGetIntFlag()) {
-		while (USTAbits.URXDA) {
-			/* Retrieve the received character and place it in the queue of
-			received characters. */
-			cChar = U2RXREG;
-			xQueueSendFromISR(hUARTRxQueue, &cChar, &xTaskWoken);
-		}
+		UARTReadFIFO(&xTaskWoken);
 		mU2RXClearIntFlag();
 	}
 
-	// if there are TX interrupts then just clear them as we don't handle them
-	if (mU2TXGetIntFlag())
+	// the TX flag is set whenever there is space in the FIFO so only
+	// act on it while the interrupt is enabled
+	if (mU2TXGetIntFlag()) {
 		mU2TXClearIntFlag();
+		if (mU2TXGetIntEnable())
+			UARTFillFIFO(&xTaskWoken);
+	}
 
 	// If sending or receiving necessitates a context switch, then switch now.
 	if (xTaskWoken != pdFALSE)
@@ -197,6 +275,52 @@ void __attribute__( (interrupt(ipl2), vector(_UART2_VECTOR))) vU2InterruptHandle
 }
 #endif
 
+/*********************************************************************
+ * Function:        UARTMsg* UARTGetMsg(portTickType xTicksToWait)
+ *
+ * PreCondition:    xStartUARTTask() has been called
+ *
+ * Input:           Time to wait for a buffer to become free
+ *                  
+ * Output:          Pointer to an empty message buffer, or NULL
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Take a message buffer from the UART message pool
+ *
+ * Note:            The buffer must be passed to UARTSendMsg()
+ ********************************************************************/
+UARTMsg* UARTGetMsg(portTickType xTicksToWait)
+{
+	return (UARTMsg*) pvPoolAllocate(hUARTMsgPool, xTicksToWait);
+}
+
+/*********************************************************************
+ * Function:        BOOL UARTSendMsg(UARTMsg* pMsg, portTickType xTicksToWait)
+ *
+ * PreCondition:    pMsg was returned by UARTGetMsg()
+ *
+ * Input:           Message to print and time to wait for queue space
+ *                  
+ * Output:          TRUE if the message was queued
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Pass the message buffer to the UART task which
+ *					prints it and then returns it to the pool
+ *
+ * Note:            The caller must not use pMsg after this call. If
+ *					the message could not be queued it is discarded
+ ********************************************************************/
+BOOL UARTSendMsg(UARTMsg* pMsg, portTickType xTicksToWait)
+{
+	if (xQueueSendReference(hUARTTxQueue, pMsg, xTicksToWait) != pdPASS) {
+		vPoolRelease(pMsg);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /*********************************************************************
  * Function:        void UARTprintf(char* msg)
  *
@@ -214,18 +338,22 @@ void __attribute__( (interrupt(ipl2), vector(_UART2_VECTOR))) vU2InterruptHandle
  ********************************************************************/
 void UARTprintf(char* msg)
 {
-	UARTMsg sMsg;
+	UARTMsg* pMsg;
 	
-	// copy the message and ensure it is NULL terminated
-	strncpy(sMsg.buff, msg, UART_ENTRY_SIZE);
-	sMsg.buff[UART_ENTRY_SIZE - 1] = '\0';
-	
-	// send the message to the UART task
 	// we use a zero wait time so as not to block any high priority tasks
 	// if the low priority UART task is currently printing and the queue
 	// is full then we just fail to print the message.
 	// This is okay since it is only used for diagnostic messages
-	xQueueSendToBack(hUARTTxQueue, &sMsg, 0);	
+	pMsg = UARTGetMsg(0);
+	if (pMsg == NULL)
+		return;
+	
+	// copy the message and ensure it is NULL terminated
+	strncpy(pMsg->buff, msg, UART_ENTRY_SIZE);
+	pMsg->buff[UART_ENTRY_SIZE - 1] = '\0';
+	
+	// send the message to the UART task
+	UARTSendMsg(pMsg, 0);	
 }
 
 /*********************************************************************
@@ -247,18 +375,20 @@ const unsigned char HexCharArray[]={'0','1','2','3','4','5','6','7','8','9','A',
 
 void UARTPrintChar(BYTE c)
 {
-	UARTMsg sMsg;
+	UARTMsg* pMsg;
 	BYTE toPrint;
 	
+	pMsg = UARTGetMsg(portMAX_DELAY);
+	
 	// convert the character and print it
 	toPrint = (c >> 4) & 0x0F;
-	sMsg.buff[0] = HexCharArray[toPrint];
+	pMsg->buff[0] = HexCharArray[toPrint];
 	toPrint = c & 0x0F;
-	sMsg.buff[1] = HexCharArray[toPrint];
-	sMsg.buff[2] = '\0';
+	pMsg->buff[1] = HexCharArray[toPrint];
+	pMsg->buff[2] = '\0';
 	
 	// send the message to the UART task
-	xQueueSendToBack(hUARTTxQueue, &sMsg, portMAX_DELAY);	
+	UARTSendMsg(pMsg, portMAX_DELAY);	
 }
 
 